@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -25,6 +26,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -162,6 +165,87 @@ int vtkAbstractCellLocator::IntersectWithLine(const double vtkNotUsed(p1)[3],
   return 0;
 }
 
+//------------------------------------------------------------------------------
+vtkIdType vtkAbstractCellLocator::IntersectWithLines(vtkPoints* p1s, vtkPoints* p2s, double tol,
+  vtkIdList* cellIds, vtkDoubleArray* ts, vtkPoints* points)
+{
+  if (!p1s || !p2s || p1s->GetNumberOfPoints() != p2s->GetNumberOfPoints())
+  {
+    vtkErrorMacro(<< "The start and end points of the lines must have the same size");
+    return 0;
+  }
+  const vtkIdType numLines = p1s->GetNumberOfPoints();
+  if (cellIds)
+  {
+    cellIds->SetNumberOfIds(numLines);
+  }
+  if (ts)
+  {
+    ts->SetNumberOfComponents(1);
+    ts->SetNumberOfTuples(numLines);
+  }
+  if (points)
+  {
+    points->SetNumberOfPoints(numLines);
+  }
+
+  // Build the locator up front, the queries only read it.
+  this->BuildLocator();
+
+  // make the dataset API threadsafe by calling it once in a single thread.
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  if (this->DataSet && this->DataSet->GetNumberOfCells() > 0)
+  {
+    this->DataSet->GetCellType(0);
+    this->DataSet->GetCell(0, tlCell.Local());
+  }
+  vtkSMPThreadLocal<vtkIdType> tlNumHits(0);
+  vtkSMPTools::For(0, numLines, [&](vtkIdType lineId, vtkIdType endLineId) {
+    vtkGenericCell* cell = tlCell.Local();
+    vtkIdType& numHits = tlNumHits.Local();
+    double p1[3], p2[3], x[3], pcoords[3], t;
+    int subId;
+    vtkIdType cellId;
+    for (; lineId < endLineId; ++lineId)
+    {
+      p1s->GetPoint(lineId, p1);
+      p2s->GetPoint(lineId, p2);
+      cellId = -1;
+      if (this->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId, cell) && cellId >= 0)
+      {
+        ++numHits;
+      }
+      else
+      {
+        cellId = -1;
+        t = 1.0;
+        x[0] = p2[0];
+        x[1] = p2[1];
+        x[2] = p2[2];
+      }
+      if (cellIds)
+      {
+        cellIds->SetId(lineId, cellId);
+      }
+      if (ts)
+      {
+        ts->SetValue(lineId, t);
+      }
+      if (points)
+      {
+        points->SetPoint(lineId, x);
+      }
+    }
+  });
+
+  vtkIdType numHits = 0;
+  for (vtkIdType threadHits : tlNumHits)
+  {
+    numHits += threadHits;
+  }
+  return numHits;
+}
+
 //------------------------------------------------------------------------------
 void vtkAbstractCellLocator::FindClosestPoint(
   const double x[3], double closestPoint[3], vtkIdType& cellId, int& subId, double& dist2)
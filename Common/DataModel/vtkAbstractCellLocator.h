@@ -46,6 +46,7 @@
 #include <vector> // For Weights
 
 class vtkCellArray;
+class vtkDoubleArray;
 class vtkGenericCell;
 class vtkIdList;
 class vtkPoints;
@@ -187,6 +188,22 @@ public:
   virtual int IntersectWithLine(const double p1[3], const double p2[3], const double tol,
     vtkPoints* points, vtkIdList* cellIds, vtkGenericCell* cell);
 
+  /**
+   * Intersect a batch of finite lines with the cells contained in the cell
+   * locator. Line i goes from p1s[i] to p2s[i]. The lines are processed
+   * concurrently with the thread safe IntersectWithLine() returning the
+   * intersection closest to the start of the line. On return, cellIds, ts
+   * and points (any of which may be nullptr) hold one entry per line: the
+   * intersected cell id (or -1 if the line hits nothing), the parametric
+   * coordinate t along the line and the intersection point. Lines that hit
+   * nothing get t = 1 and the end point p2. The number of lines that
+   * intersect a cell is returned.
+   *
+   * THIS FUNCTION IS THREAD SAFE as long as the locator is built.
+   */
+  virtual vtkIdType IntersectWithLines(vtkPoints* p1s, vtkPoints* p2s, double tol,
+    vtkIdList* cellIds, vtkDoubleArray* ts, vtkPoints* points);
+
   /**
    * Return the closest point and the cell which is closest to the point x.
    * The closest point is somewhere on a cell, it need not be one of the
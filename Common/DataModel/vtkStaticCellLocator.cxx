@@ -1023,6 +1023,7 @@ vtkIdType CellProcessor<T>::FindClosestPointWithinRadius(const double x[3], doub
   double distance2ToCellBounds, dist2, binDist2;
   int subId, stat, ijk[3];
   vtkIdType retVal = 0;
+  vtkIdType lastCellId = -1;
   T numIds, j, cellId;
 
   using node = std::pair<double, vtkIdType>;
@@ -1070,6 +1071,7 @@ vtkIdType CellProcessor<T>::FindClosestPointWithinRadius(const double x[3], doub
         if (distance2ToCellBounds < minDist2)
         {
           this->DataSet->GetCell(cellId, cell);
+          lastCellId = cellId;
 
           // evaluate the position to find the closest point
           // stat==(-1) is numerical error; stat==0 means outside;
@@ -1130,6 +1132,11 @@ vtkIdType CellProcessor<T>::FindClosestPointWithinRadius(const double x[3], doub
       }
     }
   }
+  // return the closest cell, not the last one evaluated
+  if (retVal && lastCellId != closestCellId)
+  {
+    this->DataSet->GetCell(closestCellId, cell);
+  }
   return retVal;
 }
 
@@ -22,8 +22,10 @@
 #include "vtkTestErrorObserver.h"
 
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 constexpr bool STATUS_SUCCESS = true;
@@ -86,6 +88,7 @@ static bool TestScalarLogic();
 static bool TestVectorLogic();
 static bool TestMiscFunctions();
 static bool TestErrors();
+static bool TestBatch();
 
 int UnitTestExprTkFunctionParser(int, char*[])
 {
@@ -120,6 +123,7 @@ int UnitTestExprTkFunctionParser(int, char*[])
 
   status &= TestMiscFunctions();
   status &= TestErrors();
+  status &= TestBatch();
   if (status == STATUS_FAILURE)
   {
     return EXIT_FAILURE;
@@ -1025,3 +1029,100 @@ bool TestErrors()
   }
   return status;
 }
+
+bool TestBatch()
+{
+  bool status = STATUS_SUCCESS;
+  auto rand = vtkSmartPointer<vtkMinimalStandardRandomSequence>::New();
+
+  std::cout << "Testing Batch"
+            << "...";
+  auto parser = vtkSmartPointer<vtkExprTkFunctionParser>::New();
+  auto errorObserver = vtkSmartPointer<vtkTest::ErrorObserver>::New();
+  parser->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  parser->SetScalarVariableValue("x", 0.0);
+  parser->SetScalarVariableValue("y", 0.0);
+  parser->SetScalarVariableValue("z", 0.5);
+  parser->SetVectorVariableValue("v", 0.0, 0.0, 0.0);
+  parser->SetVectorVariableValue("w", 0.0, 0.0, 0.0);
+
+  // Values of x, y, v and w for each evaluation; z keeps its value.
+  const int numValues = 1000;
+  std::vector<std::vector<double>> values(8, std::vector<double>(numValues));
+  for (auto& row : values)
+  {
+    for (auto& value : row)
+    {
+      value = rand->GetNextRangeValue(-2.0, 2.0);
+    }
+  }
+  const double* scalarValues[3] = { values[0].data(), values[1].data(), nullptr };
+  const double* vectorValues[6] = { values[2].data(), values[3].data(), values[4].data(),
+    values[5].data(), values[6].data(), values[7].data() };
+
+  // The batch evaluation matches the evaluation of each set of values,
+  // including the invalid values, which are replaced or not.
+  const std::pair<const char*, int> functions[] = { { "x * y + z", 1 },
+    { "sqrt(x) - ln(y)", 1 }, { "x / (y - y)", 1 }, { "asin(x) + acos(y)", 1 },
+    { "min(x, y) * max(x, z)", 1 }, { "if(x > y, x, y) + abs(x)^z", 1 },
+    { "mag(v) + dot(v, w)", 1 }, { "norm(v)", 3 }, { "cross(v, w)", 3 }, { "x * v - w / y", 3 },
+    { "-v + w * z", 3 } };
+  std::vector<double> result(3 * numValues);
+  double* resultRows[3] = { result.data(), result.data() + numValues,
+    result.data() + 2 * numValues };
+  for (int replace = 0; replace < 2; ++replace)
+  {
+    parser->SetReplaceInvalidValues(replace);
+    parser->SetReplacementValue(-1.0);
+    for (const auto& function : functions)
+    {
+      parser->SetFunction(function.first);
+      const int numComponents = function.second;
+      if (!parser->EvaluateBatch(numValues, scalarValues, vectorValues, resultRows))
+      {
+        std::cout << "\n" << function.first << " could not be evaluated" << std::endl;
+        status = STATUS_FAILURE;
+        continue;
+      }
+      for (int i = 0; i < numValues; ++i)
+      {
+        parser->SetScalarVariableValue("x", values[0][i]);
+        parser->SetScalarVariableValue("y", values[1][i]);
+        parser->SetVectorVariableValue("v", values[2][i], values[3][i], values[4][i]);
+        parser->SetVectorVariableValue("w", values[5][i], values[6][i], values[7][i]);
+        double scalar = 0.0;
+        const double* expected = &scalar;
+        if (numComponents == 1)
+        {
+          scalar = parser->GetScalarResult();
+        }
+        else
+        {
+          expected = parser->GetVectorResult();
+        }
+        for (int j = 0; j < numComponents; ++j)
+        {
+          const double actual = resultRows[j][i];
+          if (actual != expected[j] && !(std::isnan(actual) && std::isnan(expected[j])))
+          {
+            std::cout << "\n"
+                      << function.first << " Expected " << expected[j] << " but got " << actual
+                      << std::endl;
+            status = STATUS_FAILURE;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  if (status == STATUS_SUCCESS)
+  {
+    std::cout << "PASSED\n";
+  }
+  else
+  {
+    std::cout << "FAILED\n";
+  }
+  return status;
+}
@@ -19,6 +19,7 @@
 #include <cctype>
 #include <random>
 #include <regex>
+#include <utility>
 
 // exprtk macros
 #define exprtk_disable_string_capabilities
@@ -726,7 +727,7 @@ void vtkExprTkFunctionParser::InvalidateFunction()
 }
 
 //------------------------------------------------------------------------------
-bool vtkExprTkFunctionParser::Evaluate()
+bool vtkExprTkFunctionParser::ParseIfModified()
 {
   if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime())
   {
@@ -745,6 +746,16 @@ bool vtkExprTkFunctionParser::Evaluate()
       return false;
     }
   }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkExprTkFunctionParser::Evaluate()
+{
+  if (!this->ParseIfModified())
+  {
+    return false;
+  }
   // perform evaluation
   this->ExprTkTools->Expression.value();
 
@@ -831,6 +842,78 @@ double* vtkExprTkFunctionParser::GetVectorResult()
   return this->Result.GetData();
 }
 
+//------------------------------------------------------------------------------
+bool vtkExprTkFunctionParser::EvaluateBatch(vtkIdType numValues,
+  const double* const* scalarValues, const double* const* vectorValues, double* const* result)
+{
+  if (!this->ParseIfModified())
+  {
+    return false;
+  }
+  if (this->ResultType != ExprTkResultType::e_scalar &&
+    this->ResultType != ExprTkResultType::e_vector)
+  {
+    vtkErrorMacro("Not supported result type.");
+    return false;
+  }
+  const int numComponents = (this->ResultType == ExprTkResultType::e_scalar ? 1 : 3);
+
+  // The variables are bound to the expression, so setting them is enough.
+  std::vector<std::pair<double*, const double*>> scalars;
+  for (int i = 0; i < this->GetNumberOfScalarVariables(); i++)
+  {
+    if (scalarValues[i])
+    {
+      scalars.emplace_back(this->ScalarVariableValues[i], scalarValues[i]);
+    }
+  }
+  std::vector<std::pair<double*, const double*>> vectors;
+  for (int i = 0; i < this->GetNumberOfVectorVariables(); i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      if (vectorValues[3 * i + j])
+      {
+        vectors.emplace_back(this->VectorVariableValues[i]->GetData() + j, vectorValues[3 * i + j]);
+      }
+    }
+  }
+
+  bool invalid = false;
+  for (vtkIdType k = 0; k < numValues; k++)
+  {
+    for (const auto& scalar : scalars)
+    {
+      *scalar.first = scalar.second[k];
+    }
+    for (const auto& vector : vectors)
+    {
+      *vector.first = vector.second[k];
+    }
+    this->ExprTkTools->Expression.value();
+
+    bool valid = true;
+    for (int i = 0; i < numComponents; i++)
+    {
+      if (std::isnan(this->Result[i]) || std::isinf(this->Result[i]))
+      {
+        this->Result[i] = this->ReplacementValue;
+        valid = this->ReplaceInvalidValues != 0;
+      }
+    }
+    invalid |= !valid;
+    for (int i = 0; i < numComponents; i++)
+    {
+      result[i][k] = (valid ? this->Result[i] : vtkParserErrorResult);
+    }
+  }
+  if (invalid)
+  {
+    vtkErrorMacro("Invalid result because of mathematically wrong input.");
+  }
+  return true;
+}
+
 //------------------------------------------------------------------------------
 std::string vtkExprTkFunctionParser::GetScalarVariableName(int i)
 {
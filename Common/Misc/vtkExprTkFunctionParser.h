@@ -100,6 +100,20 @@ public:
   }
   ///@}
 
+  /**
+   * Evaluate the function for numValues sets of variable values at once,
+   * which is much faster than setting the variables and getting the result
+   * for each set in turn. scalarValues holds an array of numValues values
+   * for each scalar variable and vectorValues three arrays, one per
+   * component, for each vector variable. A variable whose array is null
+   * keeps its current value. The result is written to result[0], or to
+   * result[0], result[1] and result[2] for a vector result, each of which
+   * must hold numValues values. Values that cannot be computed are set to
+   * the error result. Returns false if the function cannot be evaluated.
+   */
+  bool EvaluateBatch(vtkIdType numValues, const double* const* scalarValues,
+    const double* const* vectorValues, double* const* result);
+
   ///@{
   /**
    * Set the value of a scalar variable.  If a variable with this name
@@ -321,6 +335,12 @@ protected:
    */
   bool Evaluate();
 
+  /**
+   * Parse the function if it changed since it was last parsed, returning
+   * true on success, false on failure.
+   */
+  bool ParseIfModified();
+
   /**
    * Collects meta-data about which variables are needed by the current
    * function. This is called only after a successful call to this->Parse().
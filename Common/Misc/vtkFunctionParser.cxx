@@ -886,6 +886,451 @@ double* vtkFunctionParser::GetVectorResult()
   return this->Stack;
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+// The batch evaluation runs the byte code on blocks of values, with a row of
+// the stack for each stack position, so that each operation is a simple loop.
+const int vtkParserBatchSize = 256;
+
+template <typename TOp>
+void vtkParserBatchUnary(double* x, int n, TOp op)
+{
+  for (int k = 0; k < n; k++)
+  {
+    x[k] = op(x[k]);
+  }
+}
+
+template <typename TOp>
+void vtkParserBatchBinary(double* x, const double* y, int n, TOp op)
+{
+  for (int k = 0; k < n; k++)
+  {
+    x[k] = op(x[k], y[k]);
+  }
+}
+
+// Applies op to the values for which valid is true, and replaces the other
+// ones, flagging them as failed if they are not to be replaced.
+template <typename TValid, typename TOp>
+bool vtkParserBatchCheckedUnary(double* x, unsigned char* failed, int n, vtkTypeBool replace,
+  double replacement, TValid valid, TOp op)
+{
+  bool invalid = false;
+  for (int k = 0; k < n; k++)
+  {
+    if (valid(x[k]))
+    {
+      x[k] = op(x[k]);
+    }
+    else
+    {
+      x[k] = replacement;
+      failed[k] = failed[k] || !replace;
+      invalid = true;
+    }
+  }
+  return invalid && !replace;
+}
+
+void vtkParserBatchFill(double* x, int n, double value)
+{
+  std::fill(x, x + n, value);
+}
+}
+
+//------------------------------------------------------------------------------
+bool vtkFunctionParser::EvaluateBatch(vtkIdType numValues, const double* const* scalarValues,
+  const double* const* vectorValues, double* const* result)
+{
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime())
+  {
+    if (this->Parse() == 0)
+    {
+      return false;
+    }
+  }
+
+  const int numScalars = this->GetNumberOfScalarVariables();
+  const int size = vtkParserBatchSize;
+  std::vector<double> stack(static_cast<size_t>(this->StackSize) * size);
+  std::vector<unsigned char> failed(size);
+  const char* error = nullptr;
+  const vtkTypeBool replace = this->ReplaceInvalidValues;
+  const double replacement = this->ReplacementValue;
+  int stackPosition = -1;
+  auto row = [&](int position) { return stack.data() + position * size; };
+
+  for (vtkIdType begin = 0; begin < numValues; begin += size)
+  {
+    const int n = static_cast<int>(std::min<vtkIdType>(size, numValues - begin));
+    std::fill(failed.begin(), failed.end(), 0);
+    int numImmediatesProcessed = 0;
+    stackPosition = -1;
+
+    for (int numBytesProcessed = 0; numBytesProcessed < this->ByteCodeSize; numBytesProcessed++)
+    {
+      // The rows of the top two stack positions.
+      double* x = (stackPosition >= 0 ? row(stackPosition) : nullptr);
+      double* y = (stackPosition >= 1 ? row(stackPosition - 1) : nullptr);
+      switch (this->ByteCode[numBytesProcessed])
+      {
+        case VTK_PARSER_IMMEDIATE:
+          vtkParserBatchFill(row(++stackPosition), n, this->Immediates[numImmediatesProcessed++]);
+          break;
+        case VTK_PARSER_UNARY_MINUS:
+          vtkParserBatchUnary(x, n, [](double a) { return -a; });
+          break;
+        case VTK_PARSER_UNARY_PLUS:
+          break;
+        case VTK_PARSER_ADD:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return a + b; });
+          stackPosition--;
+          break;
+        case VTK_PARSER_SUBTRACT:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return a - b; });
+          stackPosition--;
+          break;
+        case VTK_PARSER_MULTIPLY:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return a * b; });
+          stackPosition--;
+          break;
+        case VTK_PARSER_DIVIDE:
+          for (int k = 0; k < n; k++)
+          {
+            if (x[k] == 0)
+            {
+              y[k] = replacement;
+              if (!replace)
+              {
+                failed[k] = 1;
+                error = "Trying to divide by zero";
+              }
+            }
+            else
+            {
+              y[k] /= x[k];
+            }
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_POWER:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return pow(a, b); });
+          stackPosition--;
+          break;
+        case VTK_PARSER_ABSOLUTE_VALUE:
+          vtkParserBatchUnary(x, n, [](double a) { return fabs(a); });
+          break;
+        case VTK_PARSER_EXPONENT:
+          vtkParserBatchUnary(x, n, [](double a) { return exp(a); });
+          break;
+        case VTK_PARSER_CEILING:
+          vtkParserBatchUnary(x, n, [](double a) { return ceil(a); });
+          break;
+        case VTK_PARSER_FLOOR:
+          vtkParserBatchUnary(x, n, [](double a) { return floor(a); });
+          break;
+        case VTK_PARSER_LOGARITHM:
+        case VTK_PARSER_LOGARITHME:
+          if (vtkParserBatchCheckedUnary(
+                x, failed.data(), n, replace, replacement, [](double a) { return !(a <= 0); },
+                [](double a) { return log(a); }))
+          {
+            error = "Trying to take a log of a non-positive value";
+          }
+          break;
+        case VTK_PARSER_LOGARITHM10:
+          if (vtkParserBatchCheckedUnary(
+                x, failed.data(), n, replace, replacement, [](double a) { return !(a <= 0); },
+                [](double a) { return log10(a); }))
+          {
+            error = "Trying to take a log10 of a non-positive value";
+          }
+          break;
+        case VTK_PARSER_SQUARE_ROOT:
+          if (vtkParserBatchCheckedUnary(
+                x, failed.data(), n, replace, replacement, [](double a) { return !(a < 0); },
+                [](double a) { return sqrt(a); }))
+          {
+            error = "Trying to take a square root of a negative value";
+          }
+          break;
+        case VTK_PARSER_SINE:
+          vtkParserBatchUnary(x, n, [](double a) { return sin(a); });
+          break;
+        case VTK_PARSER_COSINE:
+          vtkParserBatchUnary(x, n, [](double a) { return cos(a); });
+          break;
+        case VTK_PARSER_TANGENT:
+          vtkParserBatchUnary(x, n, [](double a) { return tan(a); });
+          break;
+        case VTK_PARSER_ARCSINE:
+          if (vtkParserBatchCheckedUnary(
+                x, failed.data(), n, replace, replacement,
+                [](double a) { return !(a < -1 || a > 1); }, [](double a) { return asin(a); }))
+          {
+            error = "Trying to take asin of a value < -1 or > 1";
+          }
+          break;
+        case VTK_PARSER_ARCCOSINE:
+          if (vtkParserBatchCheckedUnary(
+                x, failed.data(), n, replace, replacement,
+                [](double a) { return !(a < -1 || a > 1); }, [](double a) { return acos(a); }))
+          {
+            error = "Trying to take acos of a value < -1 or > 1";
+          }
+          break;
+        case VTK_PARSER_ARCTANGENT:
+          vtkParserBatchUnary(x, n, [](double a) { return atan(a); });
+          break;
+        case VTK_PARSER_HYPERBOLIC_SINE:
+          vtkParserBatchUnary(x, n, [](double a) { return sinh(a); });
+          break;
+        case VTK_PARSER_HYPERBOLIC_COSINE:
+          vtkParserBatchUnary(x, n, [](double a) { return cosh(a); });
+          break;
+        case VTK_PARSER_HYPERBOLIC_TANGENT:
+          vtkParserBatchUnary(x, n, [](double a) { return tanh(a); });
+          break;
+        case VTK_PARSER_MIN:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return b < a ? b : a; });
+          stackPosition--;
+          break;
+        case VTK_PARSER_MAX:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return b > a ? b : a; });
+          stackPosition--;
+          break;
+        case VTK_PARSER_CROSS:
+        {
+          double* ux = row(stackPosition - 5);
+          double* uy = row(stackPosition - 4);
+          double* uz = row(stackPosition - 3);
+          const double* vx = row(stackPosition - 2);
+          const double* vy = y;
+          const double* vz = x;
+          for (int k = 0; k < n; k++)
+          {
+            const double cx = uy[k] * vz[k] - uz[k] * vy[k];
+            const double cy = uz[k] * vx[k] - ux[k] * vz[k];
+            const double cz = ux[k] * vy[k] - uy[k] * vx[k];
+            ux[k] = cx;
+            uy[k] = cy;
+            uz[k] = cz;
+          }
+          stackPosition -= 3;
+          break;
+        }
+        case VTK_PARSER_SIGN:
+          vtkParserBatchUnary(x, n, [](double a) { return a < 0 ? -1.0 : (a == 0 ? 0.0 : 1.0); });
+          break;
+        case VTK_PARSER_VECTOR_UNARY_MINUS:
+          for (int i = 0; i < 3; i++)
+          {
+            vtkParserBatchUnary(row(stackPosition - i), n, [](double a) { return -a; });
+          }
+          break;
+        case VTK_PARSER_VECTOR_UNARY_PLUS:
+          break;
+        case VTK_PARSER_DOT_PRODUCT:
+        {
+          double* ux = row(stackPosition - 5);
+          const double* uy = row(stackPosition - 4);
+          const double* uz = row(stackPosition - 3);
+          const double* vx = row(stackPosition - 2);
+          for (int k = 0; k < n; k++)
+          {
+            const double px = ux[k] * vx[k];
+            const double py = uy[k] * y[k];
+            const double pz = uz[k] * x[k];
+            ux[k] = px + py + pz;
+          }
+          stackPosition -= 5;
+          break;
+        }
+        case VTK_PARSER_VECTOR_ADD:
+          for (int i = 0; i < 3; i++)
+          {
+            vtkParserBatchBinary(row(stackPosition - 3 - i), row(stackPosition - i), n,
+              [](double a, double b) { return a + b; });
+          }
+          stackPosition -= 3;
+          break;
+        case VTK_PARSER_VECTOR_SUBTRACT:
+          for (int i = 0; i < 3; i++)
+          {
+            vtkParserBatchBinary(row(stackPosition - 3 - i), row(stackPosition - i), n,
+              [](double a, double b) { return a - b; });
+          }
+          stackPosition -= 3;
+          break;
+        case VTK_PARSER_SCALAR_TIMES_VECTOR:
+        {
+          // The scalar is below the vector, which moves down one position.
+          double* s = row(stackPosition - 3);
+          for (int k = 0; k < n; k++)
+          {
+            const double a = s[k];
+            s[k] = row(stackPosition - 2)[k] * a;
+            row(stackPosition - 2)[k] = y[k] * a;
+            y[k] = x[k] * a;
+          }
+          stackPosition--;
+          break;
+        }
+        case VTK_PARSER_VECTOR_TIMES_SCALAR:
+          for (int i = 1; i <= 3; i++)
+          {
+            vtkParserBatchBinary(
+              row(stackPosition - i), x, n, [](double a, double b) { return a * b; });
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_VECTOR_OVER_SCALAR:
+          for (int i = 1; i <= 3; i++)
+          {
+            vtkParserBatchBinary(row(stackPosition - i), x, n,
+              [](double a, double b) { return b != 0.0 ? a / b : a; });
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_MAGNITUDE:
+        {
+          double* vx = row(stackPosition - 2);
+          for (int k = 0; k < n; k++)
+          {
+            vx[k] = sqrt(pow(x[k], 2) + pow(y[k], 2) + pow(vx[k], 2));
+          }
+          stackPosition -= 2;
+          break;
+        }
+        case VTK_PARSER_NORMALIZE:
+        {
+          double* vx = row(stackPosition - 2);
+          for (int k = 0; k < n; k++)
+          {
+            const double magnitude = sqrt(pow(x[k], 2) + pow(y[k], 2) + pow(vx[k], 2));
+            if (magnitude != 0)
+            {
+              x[k] /= magnitude;
+              y[k] /= magnitude;
+              vx[k] /= magnitude;
+            }
+          }
+          break;
+        }
+        case VTK_PARSER_IHAT:
+        case VTK_PARSER_JHAT:
+        case VTK_PARSER_KHAT:
+        {
+          const unsigned int one = this->ByteCode[numBytesProcessed] - VTK_PARSER_IHAT;
+          for (unsigned int i = 0; i < 3; i++)
+          {
+            vtkParserBatchFill(row(++stackPosition), n, i == one ? 1.0 : 0.0);
+          }
+          break;
+        }
+        case VTK_PARSER_LESS_THAN:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return double(a < b); });
+          stackPosition--;
+          break;
+        case VTK_PARSER_GREATER_THAN:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return double(a > b); });
+          stackPosition--;
+          break;
+        case VTK_PARSER_EQUAL_TO:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return double(a == b); });
+          stackPosition--;
+          break;
+        case VTK_PARSER_AND:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return double(a && b); });
+          stackPosition--;
+          break;
+        case VTK_PARSER_OR:
+          vtkParserBatchBinary(y, x, n, [](double a, double b) { return double(a || b); });
+          stackPosition--;
+          break;
+        case VTK_PARSER_IF:
+        {
+          // if(bool,valtrue,valfalse) keeps valfalse, two positions below the
+          // bool, or replaces it with valtrue.
+          double* valFalse = row(stackPosition - 2);
+          for (int k = 0; k < n; k++)
+          {
+            valFalse[k] = (x[k] != 0.0 ? y[k] : valFalse[k]);
+          }
+          stackPosition -= 2;
+          break;
+        }
+        case VTK_PARSER_VECTOR_IF:
+          for (int i = 1; i <= 3; i++)
+          {
+            double* valFalse = row(stackPosition - 3 - i);
+            const double* valTrue = row(stackPosition - i);
+            for (int k = 0; k < n; k++)
+            {
+              valFalse[k] = (x[k] != 0.0 ? valTrue[k] : valFalse[k]);
+            }
+          }
+          stackPosition -= 4;
+          break;
+        default:
+        {
+          const int variable =
+            static_cast<int>(this->ByteCode[numBytesProcessed] - VTK_PARSER_BEGIN_VARIABLES);
+          if (variable < numScalars)
+          {
+            double* values = row(++stackPosition);
+            if (scalarValues[variable])
+            {
+              std::copy(scalarValues[variable] + begin, scalarValues[variable] + begin + n, values);
+            }
+            else
+            {
+              vtkParserBatchFill(values, n, this->ScalarVariableValues[variable]);
+            }
+          }
+          else
+          {
+            const int vectorNum = variable - numScalars;
+            for (int i = 0; i < 3; i++)
+            {
+              double* values = row(++stackPosition);
+              const double* given = vectorValues[3 * vectorNum + i];
+              if (given)
+              {
+                std::copy(given + begin, given + begin + n, values);
+              }
+              else
+              {
+                vtkParserBatchFill(values, n, this->VectorVariableValues[vectorNum][i]);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // The stack holds a scalar or a vector result.
+    for (int i = 0; i <= stackPosition; i++)
+    {
+      const double* values = row(i);
+      double* output = result[i] + begin;
+      for (int k = 0; k < n; k++)
+      {
+        output[k] = (failed[k] ? VTK_PARSER_ERROR_RESULT : values[k]);
+      }
+    }
+  }
+  this->StackPointer = stackPosition;
+
+  if (error)
+  {
+    vtkErrorMacro(<< error);
+  }
+  return true;
+}
+
 //------------------------------------------------------------------------------
 const char* vtkFunctionParser::GetScalarVariableName(int i)
 {
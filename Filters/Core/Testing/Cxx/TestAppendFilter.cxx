@@ -14,19 +14,25 @@
 =========================================================================*/
 
 #include <vtkAppendFilter.h>
+#include <vtkAppendPolyData.h>
+#include <vtkBitArray.h>
+#include <vtkCellArray.h>
 #include <vtkCellData.h>
 #include <vtkDataSet.h>
 #include <vtkDataSetAttributes.h>
 #include <vtkIdList.h>
 #include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
 #include <vtkIntArray.h>
 #include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
 
+#include <cmath>
 #include <numeric> // for iota
 
 //////////////////////////////////////////////////////////////////////////////
@@ -519,6 +525,231 @@ bool TestToleranceModes()
   return true;
 }
 
+// Appends an image, a polydata with verts and polys and an unstructured grid
+// with a polyhedron, and checks where the cells end up in the output.
+bool TestMixedInputTypes()
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(3, 3, 1);
+
+  vtkNew<vtkPoints> polyPoints;
+  polyPoints->InsertNextPoint(0.0, 0.0, 0.0);
+  polyPoints->InsertNextPoint(1.0, 0.0, 0.0);
+  polyPoints->InsertNextPoint(1.0, 1.0, 0.0);
+  vtkNew<vtkPolyData> polydata;
+  polydata->AllocateEstimate(2, 3);
+  polydata->SetPoints(polyPoints);
+  vtkIdType triangle[] = { 0, 1, 2 };
+  polydata->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+  polydata->InsertNextCell(VTK_VERTEX, 1, triangle);
+
+  vtkNew<vtkPoints> cubePoints;
+  for (int k = 0; k < 2; ++k)
+  {
+    cubePoints->InsertNextPoint(0.0, 0.0, k);
+    cubePoints->InsertNextPoint(1.0, 0.0, k);
+    cubePoints->InsertNextPoint(1.0, 1.0, k);
+    cubePoints->InsertNextPoint(0.0, 1.0, k);
+  }
+  vtkIdType cube[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  vtkIdType cubeFaces[] = { 4, 0, 3, 2, 1, 4, 4, 5, 6, 7, 4, 0, 1, 5, 4, 4, 1, 2, 6, 5, 4, 2, 3,
+    7, 6, 4, 3, 0, 4, 7 };
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(cubePoints);
+  grid->InsertNextCell(VTK_POLYHEDRON, 8, cube, 6, cubeFaces);
+
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputData(image);
+  append->AddInputData(polydata);
+  append->AddInputData(grid);
+  append->Update();
+  vtkUnstructuredGrid* output = append->GetOutput();
+
+  // Polydata cells keep the order in which they were inserted.
+  const int types[] = { VTK_PIXEL, VTK_PIXEL, VTK_PIXEL, VTK_PIXEL, VTK_TRIANGLE, VTK_VERTEX,
+    VTK_POLYHEDRON };
+  if (output->GetNumberOfPoints() != 20 || output->GetNumberOfCells() != 7)
+  {
+    std::cerr << "Appending mixed inputs yielded " << output->GetNumberOfPoints() << " points and "
+              << output->GetNumberOfCells() << " cells instead of 20 and 7.\n";
+    return false;
+  }
+  for (vtkIdType cellId = 0; cellId < 7; ++cellId)
+  {
+    if (output->GetCellType(cellId) != types[cellId])
+    {
+      std::cerr << "Wrong type for appended cell " << cellId << ".\n";
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> ptIds;
+  output->GetCellPoints(4, ptIds);
+  if (ptIds->GetNumberOfIds() != 3 || ptIds->GetId(0) != 9 || ptIds->GetId(2) != 11)
+  {
+    std::cerr << "Wrong point ids for the appended triangle.\n";
+    return false;
+  }
+  vtkIdType nfaces;
+  const vtkIdType* faces;
+  output->GetFaceStream(6, nfaces, faces);
+  if (nfaces != 6 || faces[0] != 4 || faces[1] != 12 || faces[2] != 15)
+  {
+    std::cerr << "Wrong face stream for the appended polyhedron.\n";
+    return false;
+  }
+
+  // All the points of the polydata and the bottom of the cube are image points.
+  append->MergePointsOn();
+  append->Update();
+  output = append->GetOutput();
+  output->GetCellPoints(4, ptIds);
+  if (output->GetNumberOfPoints() != 13 || ptIds->GetId(0) != 0 || ptIds->GetId(1) != 1 ||
+    ptIds->GetId(2) != 4)
+  {
+    std::cerr << "Merging mixed inputs yielded " << output->GetNumberOfPoints()
+              << " points instead of 13.\n";
+    return false;
+  }
+  output->GetFaceStream(6, nfaces, faces);
+  if (faces[1] != 0 || faces[2] != 3 || faces[3] != 4)
+  {
+    std::cerr << "Wrong face stream for the merged polyhedron.\n";
+    return false;
+  }
+
+  return true;
+}
+
+// Appends two sets of vertices where each vertex of the second set lies within
+// the tolerance of a vertex of the first set, the other vertices being far
+// apart. Many pairs straddle the bins of the point locator, whose bin order
+// may merge a point into a point of higher id. Each output vertex must stay
+// at its input position, up to the tolerance.
+bool TestMergeWithinTolerance()
+{
+  const int numPairs = 2000;
+  const double tolerance = 1.0e-2;
+  vtkNew<vtkPolyData> inputs[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToDouble();
+    vtkNew<vtkCellArray> verts;
+    for (vtkIdType ptId = 0; ptId < numPairs; ++ptId)
+    {
+      // points 0.1 apart on a jittered grid, moved by 0.3 tolerance in the
+      // second set
+      const double shift = i * 0.3 * tolerance;
+      points->InsertNextPoint(0.1 * (ptId % 20) + 0.01 * std::sin(3.0 * ptId) + shift,
+        0.1 * ((ptId / 20) % 10) + 0.01 * std::cos(5.0 * ptId) - shift,
+        0.1 * (ptId / 200) + 0.01 * std::sin(7.0 * ptId) + shift);
+      verts->InsertNextCell(1, &ptId);
+    }
+    inputs[i]->SetPoints(points);
+    inputs[i]->SetVerts(verts);
+  }
+
+  vtkNew<vtkAppendFilter> append;
+  append->MergePointsOn();
+  append->ToleranceIsAbsoluteOn();
+  append->SetTolerance(tolerance);
+  append->AddInputData(inputs[0]);
+  append->AddInputData(inputs[1]);
+  append->Update();
+  vtkUnstructuredGrid* output = append->GetOutput();
+
+  if (output->GetNumberOfPoints() != numPairs || output->GetNumberOfCells() != 2 * numPairs)
+  {
+    std::cerr << "Merging within tolerance yielded " << output->GetNumberOfPoints()
+              << " points and " << output->GetNumberOfCells() << " cells instead of "
+              << numPairs << " and " << 2 * numPairs << ".\n";
+    return false;
+  }
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    double inputPoint[3], outputPoint[3];
+    inputs[cellId / numPairs]->GetPoint(cellId % numPairs, inputPoint);
+    output->GetPoint(ptIds->GetId(0), outputPoint);
+    if (vtkMath::Distance2BetweenPoints(inputPoint, outputPoint) > tolerance * tolerance)
+    {
+      std::cerr << "Merged vertex " << cellId << " moved to point " << ptIds->GetId(0)
+                << ", farther than the tolerance.\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Appends inputs with point and cell bit arrays. Their sizes are not
+// multiples of 8 and span several copy chunks, so the tuples of different
+// inputs share bytes of the output arrays.
+bool TestBitArrays()
+{
+  const vtkIdType sizes[3] = { 70001, 13, 140003 };
+  vtkNew<vtkPolyData> inputs[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkCellArray> verts;
+    vtkNew<vtkBitArray> pointBits;
+    pointBits->SetName("Bits");
+    vtkNew<vtkBitArray> cellBits;
+    cellBits->SetName("Bits");
+    for (vtkIdType ptId = 0; ptId < sizes[i]; ++ptId)
+    {
+      points->InsertNextPoint(ptId, i, 0.0);
+      verts->InsertNextCell(1, &ptId);
+      pointBits->InsertNextValue((ptId * 7 + i) % 3 == 0);
+      cellBits->InsertNextValue((ptId * 5 + i) % 3 != 0);
+    }
+    inputs[i]->SetPoints(points);
+    inputs[i]->SetVerts(verts);
+    inputs[i]->GetPointData()->AddArray(pointBits);
+    inputs[i]->GetCellData()->AddArray(cellBits);
+  }
+
+  vtkNew<vtkAppendFilter> append;
+  vtkNew<vtkAppendPolyData> appendPolyData;
+  for (int i = 0; i < 3; ++i)
+  {
+    append->AddInputData(inputs[i]);
+    appendPolyData->AddInputData(inputs[i]);
+  }
+  append->Update();
+  appendPolyData->Update();
+  vtkDataSet* outputs[2] = { append->GetOutput(), appendPolyData->GetOutput() };
+  for (vtkDataSet* output : outputs)
+  {
+    vtkBitArray* pointBits = vtkBitArray::SafeDownCast(output->GetPointData()->GetArray("Bits"));
+    vtkBitArray* cellBits = vtkBitArray::SafeDownCast(output->GetCellData()->GetArray("Bits"));
+    if (!pointBits || !cellBits ||
+      pointBits->GetNumberOfTuples() != sizes[0] + sizes[1] + sizes[2] ||
+      cellBits->GetNumberOfTuples() != sizes[0] + sizes[1] + sizes[2])
+    {
+      std::cerr << output->GetClassName() << " output has no bit arrays of the right size.\n";
+      return false;
+    }
+    vtkIdType outputId = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      for (vtkIdType id = 0; id < sizes[i]; ++id, ++outputId)
+      {
+        if (pointBits->GetValue(outputId) != ((id * 7 + i) % 3 == 0) ||
+          cellBits->GetValue(outputId) != ((id * 5 + i) % 3 != 0))
+        {
+          std::cerr << output->GetClassName() << " output has wrong bits at " << outputId
+                    << ".\n";
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
 } // end anonymous namespace
 
 //////////////////////////////////////////////////////////////////////////////
@@ -815,5 +1046,29 @@ int TestAppendFilter(int, char*[])
     return EXIT_FAILURE;
   }
 
+  std::cout << "===========================================================\n";
+  std::cout << "Testing merging within tolerance.\n";
+  if (!TestMergeWithinTolerance())
+  {
+    std::cerr << "vtkAppendFilter failed merging within tolerance.\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "===========================================================\n";
+  std::cout << "Testing bit arrays.\n";
+  if (!TestBitArrays())
+  {
+    std::cerr << "vtkAppendFilter failed with bit arrays.\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "===========================================================\n";
+  std::cout << "Testing mixed input types.\n";
+  if (!TestMixedInputTypes())
+  {
+    std::cerr << "vtkAppendFilter failed with mixed input types.\n";
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
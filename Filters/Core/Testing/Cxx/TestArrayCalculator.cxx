@@ -14,20 +14,99 @@
 =========================================================================*/
 
 #include <vtkArrayCalculator.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkTestUtilities.h>
 #include <vtkXMLImageDataReader.h>
 #include <vtkXMLPolyDataReader.h>
 
+namespace
+{
+// Check the values computed from selected components of float and double
+// arrays and from the coordinates, over several blocks of tuples.
+bool TestSelectedComponents(vtkArrayCalculator::FunctionParserTypes parserType)
+{
+  const vtkIdType numPoints = 2000;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(4);
+  vectors->SetNumberOfTuples(numPoints);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+  {
+    points->InsertNextPoint(0.5 * i, 1.0, -0.25 * i);
+    vectors->SetTuple4(i, i, 2 * i, 3 * i, 4 * i);
+    scalars->SetValue(i, 1.0 / (i + 1));
+  }
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+  input->GetPointData()->AddArray(vectors);
+  input->GetPointData()->AddArray(scalars);
+
+  vtkNew<vtkArrayCalculator> calc;
+  calc->SetInputData(input);
+  calc->SetFunctionParserType(parserType);
+  calc->SetAttributeTypeToPointData();
+  calc->AddScalarVariable("s", "Scalars");
+  calc->AddScalarVariable("w", "Vectors", 3);
+  calc->AddVectorVariable("v", "Vectors", 2, 0, 1);
+  calc->AddCoordinateScalarVariable("z", 2);
+  calc->AddCoordinateVectorVariable("P");
+  calc->SetFunction("(w + z) * v + s * P");
+  calc->SetResultArrayName("Result");
+  for (int numThreads = 1; numThreads <= 2; ++numThreads)
+  {
+    vtkSMPTools::Initialize(numThreads);
+    calc->Modified();
+    calc->Update();
+    vtkDataArray* result =
+      vtkPolyData::SafeDownCast(calc->GetOutput())->GetPointData()->GetArray("Result");
+    if (!result || result->GetNumberOfComponents() != 3)
+    {
+      std::cerr << "Output has no vector array named 'Result'" << std::endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+      const double a = 4.0 * i - 0.25 * i;
+      const double s = 1.0 / (i + 1);
+      const double expected[3] = { a * (3.0 * i) + s * (0.5 * i), a * i + s,
+        a * (2.0 * i) + s * (-0.25 * i) };
+      for (int j = 0; j < 3; ++j)
+      {
+        if (result->GetComponent(i, j) != expected[j])
+        {
+          std::cerr << "Result of tuple " << i << " is " << result->GetComponent(i, j)
+                    << " instead of " << expected[j] << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+}
+
 int TestArrayCalculator(int argc, char* argv[])
 {
   for (int i = 0; i < vtkArrayCalculator::NumberOfFunctionParserTypes; ++i)
   {
     auto parserType = static_cast<vtkArrayCalculator::FunctionParserTypes>(i);
+    if (!TestSelectedComponents(parserType))
+    {
+      return EXIT_FAILURE;
+    }
+
     char* filename =
       vtkTestUtilities::ExpandDataFileName(argc, argv, "Data/disk_out_ref_surface.vtp");
 
@@ -14,10 +14,17 @@
 =========================================================================*/
 
 #include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkCleanPolyData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMath.h>
 #include <vtkMinimalStandardRandomSequence.h>
+#include <vtkPointLocator.h>
 #include <vtkSmartPointer.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace
 {
 void InitializePolyData(vtkPolyData* polyData, int dataType)
@@ -81,6 +88,120 @@ int CleanPolyData(int dataType, int outputPointsPrecision)
 
   return points->GetDataType();
 }
+
+// A 40x40 grid of triangles, each with its own points jittered by less than
+// `jitter` from the grid points. When (i + j) % 11 == 0 the triangle
+// collapses to a vertex, else when (i + j) % 7 == 0 it collapses to a line.
+const int GridDimension = 40;
+
+void GetTrianglePoints(vtkIdType cellId, std::vector<std::pair<int, int>>& gridPoints)
+{
+  const int i = static_cast<int>(cellId % GridDimension);
+  const int j = static_cast<int>(cellId / GridDimension);
+  gridPoints.clear();
+  gridPoints.emplace_back(i, j);
+  if ((i + j) % 11 != 0)
+  {
+    gridPoints.emplace_back(i + 1, j);
+    if ((i + j) % 7 != 0)
+    {
+      gridPoints.emplace_back(i + 1, j + 1);
+    }
+  }
+}
+
+void InitializeTriangles(vtkPolyData* polyData, double jitter)
+{
+  vtkSmartPointer<vtkMinimalStandardRandomSequence> randomSequence =
+    vtkSmartPointer<vtkMinimalStandardRandomSequence>::New();
+  randomSequence->SetSeed(1);
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> cellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  cellIds->SetName("CellIds");
+
+  std::vector<std::pair<int, int>> gridPoints;
+  for (vtkIdType cellId = 0; cellId < GridDimension * GridDimension; ++cellId)
+  {
+    GetTrianglePoints(cellId, gridPoints);
+    polys->InsertNextCell(3);
+    for (int k = 0; k < 3; ++k)
+    {
+      const std::pair<int, int>& gridPoint = gridPoints[std::min<size_t>(k, gridPoints.size() - 1)];
+      double point[3] = { static_cast<double>(gridPoint.first),
+        static_cast<double>(gridPoint.second), 0.0 };
+      for (unsigned int j = 0; j < 3; ++j)
+      {
+        randomSequence->Next();
+        point[j] += jitter * (randomSequence->GetValue() - 0.5);
+      }
+      polys->InsertCellPoint(points->InsertNextPoint(point));
+    }
+    cellIds->InsertNextValue(cellId);
+  }
+
+  polyData->SetPoints(points);
+  polyData->SetPolys(polys);
+  polyData->GetCellData()->AddArray(cellIds);
+}
+
+// Check that the points of each triangle are merged into one point per grid
+// point, and that degenerate triangles become vertices and lines.
+bool CleanTriangles(double jitter, double tolerance, vtkIncrementalPointLocator* locator)
+{
+  vtkSmartPointer<vtkPolyData> inputPolyData = vtkSmartPointer<vtkPolyData>::New();
+  InitializeTriangles(inputPolyData, jitter);
+
+  vtkSmartPointer<vtkCleanPolyData> cleanPolyData = vtkSmartPointer<vtkCleanPolyData>::New();
+  cleanPolyData->SetInputData(inputPolyData);
+  cleanPolyData->ToleranceIsAbsoluteOn();
+  cleanPolyData->SetAbsoluteTolerance(tolerance);
+  cleanPolyData->SetLocator(locator);
+  cleanPolyData->Update();
+  vtkPolyData* output = cleanPolyData->GetOutput();
+
+  if (output->GetNumberOfPoints() != 1671 || output->GetNumberOfVerts() != 144 ||
+    output->GetNumberOfLines() != 225 || output->GetNumberOfPolys() != 1231)
+  {
+    std::cerr << "Cleaned triangles into " << output->GetNumberOfPoints() << " points, "
+              << output->GetNumberOfVerts() << " vertices, " << output->GetNumberOfLines()
+              << " lines and " << output->GetNumberOfPolys()
+              << " polygons instead of 1671, 144, 225 and 1231" << std::endl;
+    return false;
+  }
+
+  vtkIdTypeArray* cellIds =
+    vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray("CellIds"));
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  std::vector<std::pair<int, int>> gridPoints;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    GetTrianglePoints(cellIds->GetValue(cellId), gridPoints);
+    output->GetCellPoints(cellId, ptIds);
+    if (ptIds->GetNumberOfIds() != static_cast<vtkIdType>(gridPoints.size()))
+    {
+      std::cerr << "Cell " << cellId << " has " << ptIds->GetNumberOfIds() << " points instead of "
+                << gridPoints.size() << std::endl;
+      return false;
+    }
+    for (vtkIdType k = 0; k < ptIds->GetNumberOfIds(); ++k)
+    {
+      double point[3];
+      output->GetPoint(ptIds->GetId(k), point);
+      const double gridPoint[3] = { static_cast<double>(gridPoints[k].first),
+        static_cast<double>(gridPoints[k].second), 0.0 };
+      if (vtkMath::Distance2BetweenPoints(point, gridPoint) > jitter * jitter)
+      {
+        std::cerr << "Point " << k << " of cell " << cellId << " was merged into a point of "
+                  << "another grid point" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
 }
 
 int TestCleanPolyData(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -127,5 +248,13 @@ int TestCleanPolyData(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
   }
 
+  // Exactly coincident points, then points merged within a tolerance, with
+  // and without a locator.
+  if (!CleanTriangles(0.0, 0.0, nullptr) || !CleanTriangles(0.01, 0.05, nullptr) ||
+    !CleanTriangles(0.01, 0.05, vtkSmartPointer<vtkPointLocator>::New()))
+  {
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
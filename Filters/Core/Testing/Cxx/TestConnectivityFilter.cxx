@@ -14,13 +14,18 @@
 =========================================================================*/
 
 #include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkConnectivityFilter.h>
 #include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
 
+#include <vector>
+
 namespace
 {
 void InitializeUnstructuredGrid(vtkUnstructuredGrid* unstructuredGrid, int dataType)
@@ -95,6 +100,108 @@ int FilterUnstructuredGridConnectivity(int dataType, int outputPointsPrecision)
 
   return points->GetDataType();
 }
+
+// Three chains of lines with interleaved cells: A (3 cells), C (5 cells) and
+// B (1 cell), in the order of their first cell.
+void InitializeChains(vtkUnstructuredGrid* unstructuredGrid)
+{
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < 12; ++i)
+  {
+    points->InsertNextPoint(i, 0.0, 0.0);
+  }
+  unstructuredGrid->SetPoints(points);
+  unstructuredGrid->Allocate(9);
+  const vtkIdType lines[9][2] = { { 0, 1 }, { 6, 7 }, { 4, 5 }, { 1, 2 }, { 7, 8 }, { 8, 9 },
+    { 2, 3 }, { 9, 10 }, { 10, 11 } };
+  for (int i = 0; i < 9; ++i)
+  {
+    unstructuredGrid->InsertNextCell(VTK_LINE, 2, lines[i]);
+  }
+}
+
+bool CheckRegions(vtkConnectivityFilter* filter, const std::vector<vtkIdType>& sizes,
+  const std::vector<vtkIdType>& cellRegionIds)
+{
+  vtkIdTypeArray* regionSizes = filter->GetRegionSizes();
+  if (filter->GetNumberOfExtractedRegions() != static_cast<int>(sizes.size()))
+  {
+    std::cerr << "Expected " << sizes.size() << " regions, got "
+              << filter->GetNumberOfExtractedRegions() << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < static_cast<vtkIdType>(sizes.size()); ++i)
+  {
+    if (regionSizes->GetValue(i) != sizes[i])
+    {
+      std::cerr << "Region " << i << " has " << regionSizes->GetValue(i) << " cells, expected "
+                << sizes[i] << std::endl;
+      return false;
+    }
+  }
+  vtkPointSet* output = vtkPointSet::SafeDownCast(filter->GetOutput());
+  vtkIdTypeArray* regionIds =
+    vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray("RegionId"));
+  if (!regionIds || regionIds->GetNumberOfValues() != output->GetNumberOfCells() ||
+    output->GetNumberOfCells() != static_cast<vtkIdType>(cellRegionIds.size()))
+  {
+    std::cerr << "Wrong cell RegionId array" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+  {
+    if (regionIds->GetValue(i) != cellRegionIds[i])
+    {
+      std::cerr << "Cell " << i << " has RegionId " << regionIds->GetValue(i) << ", expected "
+                << cellRegionIds[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int TestRegionLabelling()
+{
+  vtkNew<vtkUnstructuredGrid> chains;
+  InitializeChains(chains);
+
+  vtkNew<vtkConnectivityFilter> connectivityFilter;
+  connectivityFilter->SetInputData(chains);
+  connectivityFilter->ColorRegionsOn();
+  connectivityFilter->SetExtractionModeToAllRegions();
+  connectivityFilter->Update();
+  if (!CheckRegions(connectivityFilter, { 3, 5, 1 }, { 0, 1, 2, 0, 1, 1, 0, 1, 1 }))
+  {
+    return EXIT_FAILURE;
+  }
+
+  connectivityFilter->SetRegionIdAssignmentMode(vtkConnectivityFilter::CELL_COUNT_DESCENDING);
+  connectivityFilter->Update();
+  if (!CheckRegions(connectivityFilter, { 5, 3, 1 }, { 1, 0, 2, 1, 0, 0, 1, 0, 0 }))
+  {
+    return EXIT_FAILURE;
+  }
+
+  connectivityFilter->SetRegionIdAssignmentMode(vtkConnectivityFilter::UNSPECIFIED);
+  connectivityFilter->SetExtractionModeToLargestRegion();
+  connectivityFilter->Update();
+  if (!CheckRegions(connectivityFilter, { 3, 5, 1 }, { 1, 1, 1, 1, 1 }) ||
+    connectivityFilter->GetOutput()->GetNumberOfPoints() != 6)
+  {
+    return EXIT_FAILURE;
+  }
+
+  connectivityFilter->SetExtractionModeToPointSeededRegions();
+  connectivityFilter->AddSeed(5);
+  connectivityFilter->AddSeed(2);
+  connectivityFilter->Update();
+  if (!CheckRegions(connectivityFilter, { 4 }, { 0, 0, 0, 0 }))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
 }
 
 int TestConnectivityFilter(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -141,5 +248,5 @@ int TestConnectivityFilter(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
   }
 
-  return EXIT_SUCCESS;
+  return TestRegionLabelling();
 }
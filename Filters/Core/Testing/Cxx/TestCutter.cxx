@@ -12,16 +12,24 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkCellType.h"
 #include "vtkCutter.h"
 #include "vtkDataSetTriangleFilter.h"
+#include "vtkIdList.h"
 #include "vtkImageDataToPointSet.h"
+#include "vtkNew.h"
 #include "vtkPlane.h"
 #include "vtkPointDataToCellData.h"
+#include "vtkPointLocator.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolygonBuilder.h"
 #include "vtkRTAnalyticSource.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
 #include <cassert>
 
 bool TestStructured(int type)
@@ -105,6 +113,215 @@ bool TestUnstructured()
   return true;
 }
 
+bool TestUnstructuredMixedCells()
+{
+  // Three cubes along x: a hexahedron, two wedges and six tetrahedra.
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < 2; ++k)
+  {
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  grid->Allocate(9);
+  for (vtkIdType i = 0; i < 3; ++i)
+  {
+    const vtkIdType h[8] = { i, i + 1, i + 5, i + 4, i + 8, i + 9, i + 13, i + 12 };
+    if (i == 0)
+    {
+      grid->InsertNextCell(VTK_HEXAHEDRON, 8, h);
+    }
+    else if (i == 1)
+    {
+      const vtkIdType w0[6] = { h[0], h[1], h[3], h[4], h[5], h[7] };
+      const vtkIdType w1[6] = { h[1], h[2], h[3], h[5], h[6], h[7] };
+      grid->InsertNextCell(VTK_WEDGE, 6, w0);
+      grid->InsertNextCell(VTK_WEDGE, 6, w1);
+    }
+    else
+    {
+      const int tets[6][4] = { { 0, 1, 2, 6 }, { 0, 2, 3, 6 }, { 0, 3, 7, 6 }, { 0, 7, 4, 6 },
+        { 0, 4, 5, 6 }, { 0, 5, 1, 6 } };
+      for (int t = 0; t < 6; ++t)
+      {
+        const vtkIdType tet[4] = { h[tets[t][0]], h[tets[t][1]], h[tets[t][2]], h[tets[t][3]] };
+        grid->InsertNextCell(VTK_TETRA, 4, tet);
+      }
+    }
+  }
+
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(1.5, 0.5, 0.5);
+  plane->SetNormal(1, 1, 1);
+  vtkNew<vtkCutter> cutter;
+  cutter->SetCutFunction(plane);
+  cutter->SetInputData(grid);
+  cutter->SetValue(0, 0.0);
+  cutter->SetValue(1, 0.7);
+  cutter->SetGenerateTriangles(0);
+
+  // The serial path is used with a locator merging points within a tolerance.
+  vtkNew<vtkPointLocator> locator;
+  cutter->SetLocator(locator);
+  cutter->Update();
+  vtkNew<vtkPolyData> expected;
+  expected->DeepCopy(cutter->GetOutput());
+
+  cutter->SetLocator(nullptr);
+  vtkSMPTools::Initialize(2);
+  cutter->Update();
+  vtkNew<vtkPolyData> output;
+  output->DeepCopy(cutter->GetOutput());
+  if (output->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+    output->GetNumberOfCells() != expected->GetNumberOfCells() || output->CheckAttributes())
+  {
+    cerr << "Expected " << expected->GetNumberOfPoints() << " points and "
+         << expected->GetNumberOfCells() << " cells, got " << output->GetNumberOfPoints()
+         << " and " << output->GetNumberOfCells() << endl;
+    return false;
+  }
+
+  // The output does not depend on the number of threads.
+  vtkSMPTools::Initialize(1);
+  cutter->Modified();
+  cutter->Update();
+  vtkPolyData* serialOutput = cutter->GetOutput();
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    output->GetPoint(i, x);
+    serialOutput->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      cerr << "Point " << i << " depends on the number of threads" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestUnstructuredBatches()
+{
+  // A grid of hexahedra much larger than the batches of cells cut
+  // concurrently, so that many cut edges are shared by cells of different
+  // batches.
+  const int dim = 24;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= dim; ++k)
+  {
+    for (int j = 0; j <= dim; ++j)
+    {
+      for (int i = 0; i <= dim; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  auto pointId = [dim](int i, int j, int k) -> vtkIdType {
+    return i + (dim + 1) * (j + (dim + 1) * static_cast<vtkIdType>(k));
+  };
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  grid->Allocate(dim * dim * dim);
+  for (int k = 0; k < dim; ++k)
+  {
+    for (int j = 0; j < dim; ++j)
+    {
+      for (int i = 0; i < dim; ++i)
+      {
+        const vtkIdType hex[8] = { pointId(i, j, k), pointId(i + 1, j, k),
+          pointId(i + 1, j + 1, k), pointId(i, j + 1, k), pointId(i, j, k + 1),
+          pointId(i + 1, j, k + 1), pointId(i + 1, j + 1, k + 1), pointId(i, j + 1, k + 1) };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+
+  // The plane goes through no grid point, so each grid edge crossed by a
+  // cut yields one merged point, and each hexahedron crossed one polygon.
+  const double normal[3] = { 1.0, 1.3, 1.7 };
+  const double origin[3] = { 11.05, 12.15, 9.35 };
+  const double values[2] = { 0.0, 7.3 };
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(origin[0], origin[1], origin[2]);
+  plane->SetNormal(normal[0], normal[1], normal[2]);
+
+  vtkIdType expectedPoints = 0;
+  vtkIdType expectedCells = 0;
+  for (double value : values)
+  {
+    auto side = [&](int i, int j, int k) { return plane->EvaluateFunction(i, j, k) > value; };
+    for (int k = 0; k <= dim; ++k)
+    {
+      for (int j = 0; j <= dim; ++j)
+      {
+        for (int i = 0; i <= dim; ++i)
+        {
+          expectedPoints += (i < dim && side(i, j, k) != side(i + 1, j, k)) ? 1 : 0;
+          expectedPoints += (j < dim && side(i, j, k) != side(i, j + 1, k)) ? 1 : 0;
+          expectedPoints += (k < dim && side(i, j, k) != side(i, j, k + 1)) ? 1 : 0;
+          if (i < dim && j < dim && k < dim)
+          {
+            int numAbove = 0;
+            for (int corner = 0; corner < 8; ++corner)
+            {
+              numAbove += side(i + (corner & 1), j + ((corner >> 1) & 1), k + (corner >> 2));
+            }
+            expectedCells += (numAbove > 0 && numAbove < 8) ? 1 : 0;
+          }
+        }
+      }
+    }
+  }
+
+  vtkNew<vtkCutter> cutter;
+  cutter->SetCutFunction(plane);
+  cutter->SetInputData(grid);
+  cutter->SetValue(0, values[0]);
+  cutter->SetValue(1, values[1]);
+  cutter->SetGenerateTriangles(0);
+  cutter->Update();
+  vtkPolyData* output = cutter->GetOutput();
+  if (output->GetNumberOfPoints() != expectedPoints ||
+    output->GetNumberOfCells() != expectedCells || output->CheckAttributes())
+  {
+    cerr << "Expected " << expectedPoints << " points and " << expectedCells << " cells, got "
+         << output->GetNumberOfPoints() << " and " << output->GetNumberOfCells() << endl;
+    return false;
+  }
+
+  // The points are numbered in the order the cells, in input order, first
+  // use them, whatever the batch they are created in: the points a cell
+  // uses for the first time follow those of the previous cells.
+  vtkIdType nextPointId = 0;
+  vtkNew<vtkIdList> cellPointIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, cellPointIds);
+    vtkIdType numNewPoints = 0;
+    vtkIdType maxPointId = -1;
+    for (vtkIdType i = 0; i < cellPointIds->GetNumberOfIds(); ++i)
+    {
+      numNewPoints += cellPointIds->GetId(i) >= nextPointId ? 1 : 0;
+      maxPointId = std::max(maxPointId, cellPointIds->GetId(i));
+    }
+    if (numNewPoints > 0 && maxPointId != nextPointId + numNewPoints - 1)
+    {
+      cerr << "Cell " << cellId << " uses point " << maxPointId << " before point "
+           << nextPointId << endl;
+      return false;
+    }
+    nextPointId += numNewPoints;
+  }
+  return true;
+}
+
 int TestCutter(int, char*[])
 {
   for (int type = 0; type < 2; type++)
@@ -122,5 +339,17 @@ int TestCutter(int, char*[])
     return EXIT_FAILURE;
   }
 
+  if (!TestUnstructuredMixedCells())
+  {
+    cerr << "Cutting mixed cells failed" << endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!TestUnstructuredBatches())
+  {
+    cerr << "Cutting batches of cells failed" << endl;
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,216 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDelaunaySpatialPointInsertion.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkDelaunay2D.h"
+#include "vtkDelaunay3D.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTetra.h"
+#include "vtkTriangle.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+
+namespace
+{
+const vtkIdType NumberOfPoints = 5000;
+
+void RandomPoints(vtkPolyData* input, int dim)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(NumberOfPoints);
+  for (vtkIdType i = 0; i < NumberOfPoints; ++i)
+  {
+    double x[3] = { 0.0, 0.0, 0.0 };
+    for (int j = 0; j < dim; ++j)
+    {
+      x[j] = random->GetValue();
+      random->Next();
+    }
+    points->SetPoint(i, x);
+  }
+  input->SetPoints(points);
+}
+
+// Sum of the cell sizes, i.e. the area or volume of the convex hull.
+double CellSizes(vtkPointSet* output)
+{
+  double size = 0.0;
+  double x[4][3];
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      output->GetPoint(ptIds->GetId(i), x[i]);
+    }
+    size += (ptIds->GetNumberOfIds() == 3
+        ? vtkTriangle::TriangleArea(x[0], x[1], x[2])
+        : std::abs(vtkTetra::ComputeVolume(x[0], x[1], x[2], x[3])));
+  }
+  return size;
+}
+
+// Euler characteristic of the triangulation, 1 for a triangulated disk or
+// ball: the alternating sum of its numbers of points, edges, triangles and
+// tetrahedra.
+vtkIdType EulerCharacteristic(vtkPointSet* output)
+{
+  std::set<std::vector<vtkIdType>> faces[3];
+  std::vector<bool> used(output->GetNumberOfPoints(), false);
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    const int numIds = static_cast<int>(ptIds->GetNumberOfIds());
+    for (int i = 0; i < numIds; ++i)
+    {
+      used[ptIds->GetId(i)] = true;
+    }
+    // Every subset of two or more points of the cell is an edge, a triangle
+    // or the tetrahedron itself.
+    for (int mask = 1; mask < (1 << numIds); ++mask)
+    {
+      std::vector<vtkIdType> face;
+      for (int i = 0; i < numIds; ++i)
+      {
+        if (mask & (1 << i))
+        {
+          face.push_back(ptIds->GetId(i));
+        }
+      }
+      if (face.size() >= 2)
+      {
+        std::sort(face.begin(), face.end());
+        faces[face.size() - 2].insert(face);
+      }
+    }
+  }
+  vtkIdType euler = static_cast<vtkIdType>(std::count(used.begin(), used.end(), true));
+  euler -= static_cast<vtkIdType>(faces[0].size());
+  euler += static_cast<vtkIdType>(faces[1].size());
+  euler -= static_cast<vtkIdType>(faces[2].size());
+  return euler;
+}
+
+// Check that the circumcircle or circumsphere of each cell contains none of
+// the points of the triangulation.
+bool IsDelaunay(vtkPointSet* output)
+{
+  vtkNew<vtkPointLocator> locator;
+  locator->SetDataSet(output);
+  locator->BuildLocator();
+  std::vector<bool> used(output->GetNumberOfPoints(), false);
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      used[ptIds->GetId(i)] = true;
+    }
+  }
+
+  double x[4][3];
+  vtkNew<vtkIdList> inside;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      output->GetPoint(ptIds->GetId(i), x[i]);
+    }
+    double center[3] = { 0.0, 0.0, 0.0 };
+    double radius2 = (ptIds->GetNumberOfIds() == 3
+        ? vtkTriangle::Circumcircle(x[0], x[1], x[2], center)
+        : vtkTetra::Circumsphere(x[0], x[1], x[2], x[3], center));
+    locator->FindPointsWithinRadius((1.0 - 1.0e-6) * std::sqrt(radius2), center, inside);
+    for (vtkIdType i = 0; i < inside->GetNumberOfIds(); ++i)
+    {
+      vtkIdType ptId = inside->GetId(i);
+      if (used[ptId] && ptIds->IsId(ptId) < 0)
+      {
+        std::cerr << "Point " << ptId << " lies in the circumsphere of cell " << cellId
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename TDelaunay>
+bool TestSpatialPointInsertion(int dim)
+{
+  vtkNew<vtkPolyData> input;
+  RandomPoints(input, dim);
+
+  vtkNew<TDelaunay> given;
+  given->SetInputData(input);
+  given->Update();
+
+  vtkNew<TDelaunay> sorted;
+  sorted->SetInputData(input);
+  sorted->SpatialPointInsertionOn();
+  sorted->Update();
+
+  // Both insertion orders give a Delaunay triangulation covering the same
+  // region.
+  vtkPointSet* outputs[2] = { given->GetOutput(), sorted->GetOutput() };
+  double givenSize = CellSizes(outputs[0]);
+  for (vtkPointSet* output : outputs)
+  {
+    double size = CellSizes(output);
+    if (std::abs(givenSize - size) > 1e-6 * givenSize)
+    {
+      std::cerr << "Triangulations of dimension " << dim << " cover " << givenSize << " and "
+                << size << std::endl;
+      return false;
+    }
+    if (!IsDelaunay(output))
+    {
+      std::cerr << "Triangulation of dimension " << dim << " is not Delaunay" << std::endl;
+      return false;
+    }
+    if (EulerCharacteristic(output) != 1)
+    {
+      std::cerr << "Triangulation of dimension " << dim << " has Euler characteristic "
+                << EulerCharacteristic(output) << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int TestDelaunaySpatialPointInsertion(int, char*[])
+{
+  if (!TestSpatialPointInsertion<vtkDelaunay2D>(2) || !TestSpatialPointInsertion<vtkDelaunay3D>(3))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -21,6 +21,7 @@
 #include "vtkDoubleArray.h"
 #include "vtkFeatureEdges.h"
 #include "vtkGhostCellsGenerator.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkLogger.h"
 #include "vtkNew.h"
@@ -29,9 +30,12 @@
 #include "vtkPointDataToCellData.h"
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <string>
 
 //----------------------------------------------------------------------------
 double GetGridValue(double i, double j, double k)
@@ -464,10 +468,125 @@ int FeatureEdges(int dataType, int outputPointsPrecision)
   return points->GetDataType();
 }
 
+//----------------------------------------------------------------------------
+bool TestKnownEdges()
+{
+  // An 8x8 triangulated grid folded by 60 degrees along x = 4, with a fin
+  // triangle on the diagonal of its first quad and a polyline of 2 segments.
+  const int n = 8;
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j <= n; ++j)
+  {
+    for (int i = 0; i <= n; ++i)
+    {
+      const double d = std::max(i - n / 2, 0);
+      points->InsertNextPoint(i - d + d * std::cos(M_PI / 3), j, d * std::sin(M_PI / 3));
+    }
+  }
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      const vtkIdType p00 = j * (n + 1) + i;
+      const vtkIdType triangle0[3] = { p00, p00 + 1, p00 + n + 2 };
+      const vtkIdType triangle1[3] = { p00, p00 + n + 2, p00 + n + 1 };
+      polys->InsertNextCell(3, triangle0);
+      polys->InsertNextCell(3, triangle1);
+    }
+  }
+  const vtkIdType fin[3] = { 0, n + 2, points->InsertNextPoint(0.5, 0.5, 1.0) };
+  polys->InsertNextCell(3, fin);
+  vtkNew<vtkCellArray> lines;
+  const vtkIdType polyline[3] = { points->InsertNextPoint(0.0, 0.0, 5.0),
+    points->InsertNextPoint(1.0, 0.0, 5.0), points->InsertNextPoint(2.0, 0.0, 5.0) };
+  lines->InsertNextCell(3, polyline);
+
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+  input->SetPolys(polys);
+  input->SetLines(lines);
+  // Cell data of a numeric and of a non-numeric array, which must agree.
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  vtkNew<vtkStringArray> cellNames;
+  cellNames->SetName("CellNames");
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(cellId);
+    cellNames->InsertNextValue("cell " + std::to_string(cellId));
+  }
+  input->GetCellData()->AddArray(cellIds);
+  input->GetCellData()->AddArray(cellNames);
+
+  // The grid has n * (n + 1) horizontal, n * (n + 1) vertical and n * n
+  // diagonal edges. 4 * n are on its boundary, plus 2 on the fin, n are on
+  // the fold and 1 is shared by the fin. Manifold edges are only extracted
+  // without feature edges. The feature edges use all the points of the
+  // boundary and of the fold, the fin point and the inner point of the
+  // shared edge.
+  const vtkIdType numInterior = 2 * n * (n + 1) + n * n - 4 * n;
+  const vtkIdType expected[2][5] = { { 4 * n + 2, 1, n, 0, 2 },
+    { 4 * n + 2, 1, 0, numInterior - 1, 2 } };
+  const vtkIdType expectedPoints[2] = { 4 * n + 1 + (n - 1) + 1 + 3,
+    input->GetNumberOfPoints() };
+  const float scalars[5] = { 0.0f, 0.222222f, 0.444444f, 0.666667f, 0.888889f };
+  for (int manifold = 0; manifold < 2; ++manifold)
+  {
+    vtkNew<vtkFeatureEdges> edges;
+    edges->SetInputData(input);
+    edges->SetFeatureEdges(!manifold);
+    edges->SetManifoldEdges(manifold);
+    edges->PassLinesOn();
+    edges->SetFeatureAngle(30.0);
+    edges->Update();
+    vtkPolyData* output = edges->GetOutput();
+
+    const vtkIdType* expectedEdges = expected[manifold];
+    vtkDataArray* types = output->GetCellData()->GetScalars();
+    vtkIdTypeArray* outCellIds =
+      vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray("CellIds"));
+    vtkStringArray* outCellNames =
+      vtkStringArray::SafeDownCast(output->GetCellData()->GetAbstractArray("CellNames"));
+    if (!types || !outCellIds || !outCellNames ||
+      output->GetNumberOfPoints() != expectedPoints[manifold] ||
+      output->GetNumberOfLines() != std::accumulate(expectedEdges, expectedEdges + 5, vtkIdType(0)))
+    {
+      vtkLog(ERROR, "Extracted " << output->GetNumberOfLines() << " edges and "
+                                 << output->GetNumberOfPoints() << " points.");
+      return false;
+    }
+    vtkIdType numEdgesOfType[5] = { 0, 0, 0, 0, 0 };
+    for (vtkIdType id = 0; id < output->GetNumberOfCells(); ++id)
+    {
+      const float* type =
+        std::find(scalars, scalars + 5, static_cast<float>(types->GetTuple1(id)));
+      if (type == scalars + 5 ||
+        outCellNames->GetValue(id) != "cell " + std::to_string(outCellIds->GetValue(id)))
+      {
+        vtkLog(ERROR, "Edge " << id << " has type " << types->GetTuple1(id) << " and name "
+                              << outCellNames->GetValue(id) << ".");
+        return false;
+      }
+      ++numEdgesOfType[type - scalars];
+    }
+    for (int type = 0; type < 5; ++type)
+    {
+      if (numEdgesOfType[type] != expectedEdges[type])
+      {
+        vtkLog(ERROR, "Extracted " << numEdgesOfType[type] << " edges of type " << scalars[type]
+                                   << " instead of " << expectedEdges[type] << ".");
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int TestFeatureEdges(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
-  if (!TestMixedTypes())
+  if (!TestMixedTypes() || !TestKnownEdges())
   {
     return EXIT_FAILURE;
   }
@@ -20,6 +20,8 @@
 #include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
 #include "vtkGlyph3D.h"
+#include "vtkMath.h"
+#include "vtkMultiBlockDataSet.h"
 #include "vtkNew.h"
 #include "vtkPointData.h"
 #include "vtkPolyDataMapper.h"
@@ -30,6 +32,10 @@
 #include "vtkSmartPointer.h"
 #include "vtkTestErrorObserver.h"
 #include "vtkTestUtilities.h"
+#include "vtkTransform.h"
+
+#include <algorithm>
+#include <cmath>
 
 static bool TestGlyph3D_WithBadArray()
 {
@@ -80,6 +86,105 @@ static bool TestGlyph3D_WithoutSource()
   return true;
 }
 
+static bool TestGlyph3D_Instanced()
+{
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Normals");
+  vectors->SetNumberOfComponents(3);
+  vectors->InsertNextTuple3(1, 0, 0);
+  vectors->InsertNextTuple3(0, 2, 0);
+  vectors->InsertNextTuple3(-1, 0, 0);
+
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 1, 1);
+  points->InsertNextPoint(2, 2, 2);
+  vtkNew<vtkPolyData> polydata;
+  polydata->SetPoints(points);
+  polydata->GetPointData()->AddArray(vectors);
+
+  vtkNew<vtkConeSource> glyphSource;
+  vtkNew<vtkGlyph3D> glyph3D;
+  glyph3D->SetSourceConnection(glyphSource->GetOutputPort());
+  glyph3D->SetInputData(polydata);
+  glyph3D->SetInputArrayToProcess(1, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "Normals");
+  glyph3D->SetVectorModeToUseVector();
+  glyph3D->SetScaleModeToScaleByVector();
+  glyph3D->Update();
+  vtkNew<vtkPoints> replicated;
+  replicated->DeepCopy(glyph3D->GetOutput()->GetPoints());
+
+  glyph3D->SetOutputModeToInstancedGlyphs();
+  glyph3D->Update();
+  vtkPolyData* output = glyph3D->GetOutput();
+  vtkDataArray* orientation = output->GetPointData()->GetArray("GlyphOrientation");
+  vtkDataArray* scale = output->GetPointData()->GetArray("GlyphScaleFactors");
+  vtkMultiBlockDataSet* table = glyph3D->GetGlyphTable();
+  if (output->GetNumberOfPoints() != 3 || output->GetNumberOfCells() != 0 || !orientation ||
+    orientation->GetNumberOfComponents() != 4 || !scale || !table ||
+    table->GetNumberOfBlocks() != 1)
+  {
+    std::cerr << "Unexpected instanced output" << std::endl;
+    return false;
+  }
+
+  vtkPolyData* source = vtkPolyData::SafeDownCast(table->GetBlock(0));
+  vtkIdType numSourcePts = source->GetNumberOfPoints();
+  if (replicated->GetNumberOfPoints() != 3 * numSourcePts)
+  {
+    std::cerr << "Unexpected glyph table" << std::endl;
+    return false;
+  }
+
+  // The glyph along (0, 2, 0) is the cone, along x, turned by 180 degrees
+  // around (1, 1, 0) and scaled by 2: (x, y, z) becomes (y, x, -z).
+  for (vtkIdType i = 0; i < numSourcePts; ++i)
+  {
+    double p[3], x[3];
+    source->GetPoint(i, p);
+    replicated->GetPoint(numSourcePts + i, x);
+    double expected[3] = { 1.0 + 2.0 * p[1], 1.0 + 2.0 * p[0], 1.0 - 2.0 * p[2] };
+    if (vtkMath::Distance2BetweenPoints(x, expected) > 1e-8)
+    {
+      std::cerr << "Glyph point " << i << " along (0, 2, 0) is not rotated as expected"
+                << std::endl;
+      return false;
+    }
+  }
+
+  // Rebuild the points of the glyphs from the instancing arrays.
+  for (vtkIdType glyphId = 0; glyphId < 3; ++glyphId)
+  {
+    double q[4], s[3], x[3];
+    orientation->GetTuple(glyphId, q);
+    scale->GetTuple(glyphId, s);
+    output->GetPoint(glyphId, x);
+    vtkNew<vtkTransform> rebuilt;
+    rebuilt->Translate(x);
+    double angle =
+      vtkMath::DegreesFromRadians(2.0 * std::acos(std::max(-1.0, std::min(1.0, q[0]))));
+    if (angle != 0.0)
+    {
+      rebuilt->RotateWXYZ(angle, q[1], q[2], q[3]);
+    }
+    rebuilt->Scale(s);
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+    {
+      double p[3], r[3];
+      source->GetPoint(i, p);
+      rebuilt->TransformPoint(p, p);
+      replicated->GetPoint(glyphId * numSourcePts + i, r);
+      if (vtkMath::Distance2BetweenPoints(p, r) > 1e-8)
+      {
+        std::cerr << "Instanced glyph " << glyphId << " does not match the replicated glyph"
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 int TestGlyph3D(int argc, char* argv[])
 {
   if (!TestGlyph3D_WithBadArray())
@@ -92,6 +197,11 @@ int TestGlyph3D(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  if (!TestGlyph3D_Instanced())
+  {
+    return EXIT_FAILURE;
+  }
+
   vtkSmartPointer<vtkDoubleArray> vectors = vtkSmartPointer<vtkDoubleArray>::New();
   vectors->SetName("Normals");
   vectors->SetNumberOfComponents(2);
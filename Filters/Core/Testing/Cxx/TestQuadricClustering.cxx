@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricClustering.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the triangles output by vtkQuadricClustering against the bins of the
+// input triangles, for polygons and triangle strips.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStripper.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+
+namespace
+{
+// The bins span [-0.55, 0.55] along each axis, which holds the sphere of radius 0.5.
+const double Origin = -0.55;
+const double Spacing = 0.1;
+const int NumberOfDivisions = 11;
+
+using BinTriangle = std::array<vtkIdType, 3>;
+
+vtkIdType GetBin(vtkPoints* points, vtkIdType ptId)
+{
+  double x[3];
+  points->GetPoint(ptId, x);
+  vtkIdType bin = 0;
+  for (int i = 2; i >= 0; --i)
+  {
+    bin = bin * NumberOfDivisions +
+      static_cast<vtkIdType>(std::floor((x[i] - Origin) / Spacing));
+  }
+  return bin;
+}
+
+// The sorted bins of the points of a triangle.
+BinTriangle GetBinTriangle(vtkPoints* points, const vtkIdType* pts)
+{
+  BinTriangle triangle = { { GetBin(points, pts[0]), GetBin(points, pts[1]),
+    GetBin(points, pts[2]) } };
+  std::sort(triangle.begin(), triangle.end());
+  return triangle;
+}
+
+bool IsDegenerate(const BinTriangle& triangle)
+{
+  return triangle[0] == triangle[1] || triangle[1] == triangle[2];
+}
+
+bool TestDecimation(vtkPolyData* input, const char* name, const std::set<BinTriangle>& expected)
+{
+  std::set<std::array<double, 3>> inputPoints;
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    std::array<double, 3> x;
+    input->GetPoint(ptId, x.data());
+    inputPoints.insert(x);
+  }
+
+  for (int useInputPoints = 0; useInputPoints < 2; ++useInputPoints)
+  {
+    vtkNew<vtkQuadricClustering> decimate;
+    decimate->SetInputData(input);
+    decimate->SetDivisionOrigin(Origin, Origin, Origin);
+    decimate->SetDivisionSpacing(Spacing, Spacing, Spacing);
+    decimate->SetUseInputPoints(useInputPoints);
+    decimate->CopyCellDataOn();
+    decimate->Update();
+    vtkPolyData* output = decimate->GetOutput();
+
+    // One triangle for each distinct triple of bins.
+    if (output->GetNumberOfPolys() != static_cast<vtkIdType>(expected.size()))
+    {
+      std::cerr << "Decimating " << name << " output " << output->GetNumberOfPolys()
+                << " triangles instead of " << expected.size() << std::endl;
+      return false;
+    }
+    if (!useInputPoints)
+    {
+      continue;
+    }
+
+    // The points are input points, so they are in the bins they stand for.
+    for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+    {
+      std::array<double, 3> x;
+      output->GetPoint(ptId, x.data());
+      if (!inputPoints.count(x))
+      {
+        std::cerr << "Decimating " << name << " output point " << ptId
+                  << " that is not an input point" << std::endl;
+        return false;
+      }
+    }
+    std::set<BinTriangle> triangles;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    vtkCellArray* polys = output->GetPolys();
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+      triangles.insert(GetBinTriangle(output->GetPoints(), pts));
+    }
+    if (triangles != expected)
+    {
+      std::cerr << "Decimating " << name << " output triangles joining the wrong bins"
+                << std::endl;
+      return false;
+    }
+
+    // Each triangle gets the data of an input triangle joining the same bins.
+    if (input->GetNumberOfStrips() > 0)
+    {
+      continue;
+    }
+    vtkIdTypeArray* cellIds =
+      vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray("CellIds"));
+    for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+    {
+      output->GetCellPoints(cellId, npts, pts);
+      const BinTriangle triangle = GetBinTriangle(output->GetPoints(), pts);
+      input->GetCellPoints(cellIds->GetValue(cellId), npts, pts);
+      if (GetBinTriangle(input->GetPoints(), pts) != triangle)
+      {
+        std::cerr << "Decimating " << name << " output triangle " << cellId
+                  << " with the data of another cell" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int TestQuadricClustering(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(120);
+  sphere->SetPhiResolution(60);
+  sphere->Update();
+
+  vtkNew<vtkPolyData> polys;
+  polys->ShallowCopy(sphere->GetOutput());
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  std::set<BinTriangle> expected;
+  vtkIdType npts;
+  const vtkIdType* pts;
+  for (vtkIdType cellId = 0; cellId < polys->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(cellId);
+    polys->GetCellPoints(cellId, npts, pts);
+    const BinTriangle triangle = GetBinTriangle(polys->GetPoints(), pts);
+    if (!IsDegenerate(triangle))
+    {
+      expected.insert(triangle);
+    }
+  }
+  polys->GetCellData()->AddArray(cellIds);
+
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputData(polys);
+  stripper->Update();
+
+  int status = EXIT_SUCCESS;
+  if (!TestDecimation(polys, "polygons", expected))
+  {
+    status = EXIT_FAILURE;
+  }
+  if (!TestDecimation(stripper->GetOutput(), "triangle strips", expected))
+  {
+    status = EXIT_FAILURE;
+  }
+  return status;
+}
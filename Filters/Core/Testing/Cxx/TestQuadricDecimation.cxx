@@ -0,0 +1,133 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkSphereSource.h"
+
+#include <cmath>
+#include <map>
+#include <utility>
+
+namespace
+{
+const double TargetReduction = 0.8;
+
+// The sphere has 7936 triangles and each collapse removes two of them. The
+// output stays a closed surface, with 2 + numberOfTriangles / 2 points.
+const vtkIdType ExpectedNumberOfTriangles = 1586;
+const vtkIdType ExpectedNumberOfPoints = 795;
+
+// Decimate a sphere of radius 0.5 and check the output triangles and their
+// distance to the sphere.
+bool Decimate(vtkPolyData* input, bool batch, bool attributes)
+{
+  vtkNew<vtkQuadricDecimation> decimate;
+  decimate->SetInputData(input);
+  decimate->SetTargetReduction(TargetReduction);
+  decimate->SetBatchCollapses(batch);
+  decimate->SetAttributeErrorMetric(attributes);
+  decimate->SetVolumePreservation(attributes);
+  decimate->Update();
+  vtkPolyData* output = decimate->GetOutput();
+
+  if (decimate->GetActualReduction() < TargetReduction ||
+    decimate->GetActualReduction() > TargetReduction + 0.05)
+  {
+    cerr << "Unexpected reduction " << decimate->GetActualReduction() << endl;
+    return false;
+  }
+  if (output->GetNumberOfPolys() != ExpectedNumberOfTriangles ||
+    output->GetNumberOfPoints() != ExpectedNumberOfPoints)
+  {
+    cerr << "Unexpected output: " << output->GetNumberOfPoints() << " points and "
+         << output->GetNumberOfPolys() << " triangles instead of " << ExpectedNumberOfPoints
+         << " and " << ExpectedNumberOfTriangles << endl;
+    return false;
+  }
+
+  vtkIdType npts;
+  const vtkIdType* pts;
+  double x[3];
+  std::map<std::pair<vtkIdType, vtkIdType>, int> edgeUses;
+  auto polys = output->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    if (npts != 3 || pts[0] == pts[1] || pts[1] == pts[2] || pts[2] == pts[0])
+    {
+      cerr << "Degenerate output triangle" << endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < 3; ++i)
+    {
+      output->GetPoint(pts[i], x);
+      if (std::abs(std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]) - 0.5) > 0.005)
+      {
+        cerr << "Output point " << pts[i] << " is too far from the sphere" << endl;
+        return false;
+      }
+      vtkIdType p0 = pts[i], p1 = pts[(i + 1) % 3];
+      ++edgeUses[p0 < p1 ? std::make_pair(p0, p1) : std::make_pair(p1, p0)];
+    }
+  }
+  for (const auto& edge : edgeUses)
+  {
+    if (edge.second != 2)
+    {
+      cerr << "Edge (" << edge.first.first << ", " << edge.first.second << ") is used by "
+           << edge.second << " triangles" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestQuadricDecimation(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  sphere->Update();
+  vtkNew<vtkPolyData> input;
+  input->DeepCopy(sphere->GetOutput());
+
+  vtkNew<vtkDoubleArray> elevation;
+  elevation->SetName("Elevation");
+  elevation->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+  {
+    elevation->SetValue(i, input->GetPoint(i)[2]);
+  }
+  input->GetPointData()->SetScalars(elevation);
+
+  for (int attributes = 0; attributes < 2; ++attributes)
+  {
+    for (int batch = 0; batch < 2; ++batch)
+    {
+      if (!Decimate(input, batch != 0, attributes != 0))
+      {
+        cerr << "Decimation failed with BatchCollapses " << batch << " and AttributeErrorMetric "
+             << attributes << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -12,6 +12,7 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkDataObject.h"
 #include "vtkDataSetAttributes.h"
@@ -25,6 +26,8 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+
 int TestThreshold(int, char*[])
 {
   //---------------------------------------------------
@@ -127,5 +130,40 @@ int TestThreshold(int, char*[])
     return EXIT_FAILURE;
   }
 
+  // Keep all the input points: same cells, no point renumbering
+  vtkNew<vtkUnstructuredGrid> compacted;
+  compacted->DeepCopy(filter->GetOutput());
+  filter->RemoveUnusedPointsOff();
+  filter->Update();
+  vtkUnstructuredGrid* output = filter->GetOutput();
+  if (output->GetNumberOfCells() != 780 ||
+    output->GetNumberOfPoints() != ghostedWavelet->GetNumberOfPoints() ||
+    output->GetPointData()->GetNumberOfArrays() !=
+      ghostedWavelet->GetPointData()->GetNumberOfArrays())
+  {
+    std::cerr << "Unexpected output when keeping all the points" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (compacted->GetNumberOfPoints() >= output->GetNumberOfPoints())
+  {
+    std::cerr << "Unused points were not removed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    double bounds[6], compactedBounds[6];
+    output->GetCellBounds(cellId, bounds);
+    compacted->GetCellBounds(cellId, compactedBounds);
+    vtkIdType ptId = output->GetCell(cellId)->GetPointId(0);
+    vtkIdType compactedPtId = compacted->GetCell(cellId)->GetPointId(0);
+    if (!std::equal(bounds, bounds + 6, compactedBounds) ||
+      output->GetPointData()->GetScalars()->GetTuple1(ptId) !=
+        compacted->GetPointData()->GetScalars()->GetTuple1(compactedPtId))
+    {
+      std::cerr << "Cell " << cellId << " differs when keeping all the points" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   return EXIT_SUCCESS;
 }
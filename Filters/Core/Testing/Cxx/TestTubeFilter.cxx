@@ -163,6 +163,103 @@ int TubeFilter(int dataType, int outputPointsPrecision)
   return points->GetDataType();
 }
 
+// Tube many polylines sharing points, a few of them with duplicate points,
+// and check the number of points and strips of the tubes, and that the points
+// of each tube are at the tube radius of their polyline point.
+bool TubeFilterCounts(int numberOfSides, int onRatio, bool capping, bool sidesShareVertices)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> randomSequence;
+  randomSequence->SetSeed(1);
+  const int numPts = 1000;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double point[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      randomSequence->Next();
+      point[j] = randomSequence->GetValue();
+    }
+    points->SetPoint(i, point);
+  }
+  // The polylines going through points 10 and 11 have 19 distinct points.
+  points->SetPoint(11, points->GetPoint(10));
+  vtkNew<vtkCellArray> lines;
+  for (vtkIdType i = 0; i + 20 <= numPts; i += 5)
+  {
+    lines->InsertNextCell(20);
+    for (vtkIdType j = 0; j < 20; ++j)
+    {
+      lines->InsertCellPoint(i + j);
+    }
+  }
+  vtkNew<vtkPolyData> inputPolyData;
+  inputPolyData->SetPoints(points);
+  inputPolyData->SetLines(lines);
+
+  const double radius = 0.01;
+  vtkNew<vtkTubeFilter> tubeFilter;
+  tubeFilter->SetInputData(inputPolyData);
+  tubeFilter->SetRadius(radius);
+  tubeFilter->SetNumberOfSides(numberOfSides);
+  tubeFilter->SetOnRatio(onRatio);
+  tubeFilter->SetCapping(capping);
+  tubeFilter->SetSidesShareVertices(sidesShareVertices);
+  tubeFilter->SetGenerateTCoords(VTK_TCOORDS_FROM_LENGTH);
+  tubeFilter->Update();
+  vtkPolyData* output = tubeFilter->GetOutput();
+
+  const vtkIdType numSidePts = numberOfSides * (sidesShareVertices ? 1 : 2);
+  const vtkIdType numCapPts = capping ? 2 * numberOfSides : 0;
+  const vtkIdType numStrips = (numberOfSides + onRatio - 1) / onRatio + (capping ? 2 : 0);
+  vtkIdType expectedPts = 0;
+  for (vtkIdType i = 0; i < lines->GetNumberOfCells(); ++i)
+  {
+    expectedPts += numSidePts * (i <= 2 ? 19 : 20) + numCapPts;
+  }
+  if (output->GetNumberOfPoints() != expectedPts ||
+    output->GetNumberOfStrips() != lines->GetNumberOfCells() * numStrips ||
+    output->GetPointData()->GetTCoords()->GetNumberOfTuples() != expectedPts)
+  {
+    std::cerr << "Unexpected tubes: " << output->GetNumberOfPoints() << " points and "
+              << output->GetNumberOfStrips() << " strips instead of " << expectedPts
+              << " points and " << lines->GetNumberOfCells() * numStrips << " strips"
+              << std::endl;
+    return false;
+  }
+
+  // The tubes are output in the order of the polylines.
+  vtkIdType ptId = 0;
+  for (vtkIdType i = 0; i < lines->GetNumberOfCells(); ++i)
+  {
+    for (vtkIdType j = 0; j < 20; ++j)
+    {
+      if (i <= 2 && 5 * i + j == 11)
+      {
+        continue; // duplicate point
+      }
+      double x[3];
+      points->GetPoint(5 * i + j, x);
+      for (vtkIdType k = 0; k < numSidePts; ++k, ++ptId)
+      {
+        double p[3];
+        output->GetPoint(ptId, p);
+        if (!vtkMathUtilities::FuzzyCompare(
+              sqrt(vtkMath::Distance2BetweenPoints(x, p)), radius, 1.0e-9))
+        {
+          std::cerr << "Tube point " << ptId << " is not around polyline " << i << " point " << j
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+    ptId += numCapPts;
+  }
+  return true;
+}
+
 void TubeFilterGenerateTCoords(int generateTCoordsOption, vtkActor* tubeActor)
 {
   // Define a polyline
@@ -287,6 +384,11 @@ int TestTubeFilter(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  if (!TubeFilterCounts(6, 2, true, true) || !TubeFilterCounts(5, 1, false, false))
+  {
+    return EXIT_FAILURE;
+  }
+
   // Test GenerateTCoords
   char* textureFileName = vtkTestUtilities::ExpandDataFileName(argc, argv, "Data/beach.jpg");
   vtkSmartPointer<vtkJPEGReader> JPEGReader = vtkSmartPointer<vtkJPEGReader>::New();
@@ -0,0 +1,200 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAppendDataInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkAppendDataInternal
+ * @brief   concurrent copies of appended arrays and cells
+ *
+ * The append filters compute where each input goes in the output first, then
+ * queue the copies of points, attributes and cells of all inputs and run
+ * them with vtkSMPTools. Arrays of the same type and memory layout are copied
+ * with memcpy, others tuple by tuple. Bit arrays are copied serially, since
+ * their tuples share bytes.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkAppendFilter vtkAppendPolyData
+ */
+
+#ifndef vtkAppendDataInternal_h
+#define vtkAppendDataInternal_h
+
+#include "vtkAbstractArray.h"
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+//========================= ARRAY COPIES =======================================
+// Queues copies of tuple ranges between arrays and runs them concurrently.
+// The destination arrays must already have their final number of tuples.
+class ArrayAppender
+{
+public:
+  void Add(vtkAbstractArray* source, vtkIdType sourceStart, vtkIdType numTuples,
+    vtkAbstractArray* destination, vtkIdType destinationStart)
+  {
+    // Concurrent copies into a bit array would write the same bytes at the
+    // chunk boundaries.
+    if (source->GetDataType() == VTK_BIT || destination->GetDataType() == VTK_BIT)
+    {
+      const Copy copy = { source, destination, sourceStart, destinationStart, numTuples };
+      this->SerialCopies.push_back(copy);
+      return;
+    }
+    // Copies are split so that large inputs are copied by several threads.
+    const vtkIdType chunkSize = 65536;
+    for (vtkIdType i = 0; i < numTuples; i += chunkSize)
+    {
+      const Copy copy = { source, destination, sourceStart + i, destinationStart + i,
+        std::min(chunkSize, numTuples - i) };
+      this->Copies.push_back(copy);
+    }
+  }
+
+  // Queues the copy of the arrays common to all inputs, as listed in `list`.
+  void Add(const vtkDataSetAttributes::FieldList& list, int inputIndex, vtkDataSetAttributes* input,
+    vtkIdType inputStart, vtkIdType numTuples, vtkDataSetAttributes* output, vtkIdType outputStart)
+  {
+    if (numTuples <= 0)
+    {
+      return;
+    }
+    list.TransformData(
+      inputIndex, input, output, [&](vtkAbstractArray* source, vtkAbstractArray* destination) {
+        this->Add(source, inputStart, numTuples, destination, outputStart);
+      });
+  }
+
+  void Execute()
+  {
+    vtkSMPTools::For(0, static_cast<vtkIdType>(this->Copies.size()),
+      [this](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          this->Copies[i].Execute();
+        }
+      });
+    for (const Copy& copy : this->SerialCopies)
+    {
+      copy.Destination->InsertTuples(
+        copy.DestinationStart, copy.NumberOfTuples, copy.SourceStart, copy.Source);
+    }
+    std::set<vtkAbstractArray*> destinations;
+    for (const Copy& copy : this->Copies)
+    {
+      destinations.insert(copy.Destination);
+    }
+    for (const Copy& copy : this->SerialCopies)
+    {
+      destinations.insert(copy.Destination);
+    }
+    for (vtkAbstractArray* destination : destinations)
+    {
+      destination->DataChanged();
+      destination->Modified();
+    }
+    this->Copies.clear();
+    this->SerialCopies.clear();
+  }
+
+  // Gives the arrays allocated by CopyAllocate their final number of tuples.
+  static void SetNumberOfTuples(vtkDataSetAttributes* attributes, vtkIdType numTuples)
+  {
+    for (int i = 0; i < attributes->GetNumberOfArrays(); ++i)
+    {
+      attributes->GetAbstractArray(i)->SetNumberOfTuples(numTuples);
+    }
+  }
+
+private:
+  struct Copy
+  {
+    vtkAbstractArray* Source;
+    vtkAbstractArray* Destination;
+    vtkIdType SourceStart;
+    vtkIdType DestinationStart;
+    vtkIdType NumberOfTuples;
+
+    void Execute() const
+    {
+      const int numComps = this->Source->GetNumberOfComponents();
+      if (this->Source->GetDataType() == this->Destination->GetDataType() &&
+        numComps == this->Destination->GetNumberOfComponents() &&
+        this->Source->HasStandardMemoryLayout() && this->Destination->HasStandardMemoryLayout() &&
+        this->Source->GetDataTypeSize() > 0 && vtkDataArray::SafeDownCast(this->Source))
+      {
+        std::memcpy(this->Destination->GetVoidPointer(this->DestinationStart * numComps),
+          this->Source->GetVoidPointer(this->SourceStart * numComps),
+          this->NumberOfTuples * numComps * this->Source->GetDataTypeSize());
+        return;
+      }
+      for (vtkIdType i = 0; i < this->NumberOfTuples; ++i)
+      {
+        this->Destination->SetTuple(
+          this->DestinationStart + i, this->SourceStart + i, this->Source);
+      }
+    }
+  };
+
+  std::vector<Copy> Copies;
+  std::vector<Copy> SerialCopies;
+};
+
+//========================= CELL COPIES ========================================
+// Copies the cells of a vtkCellArray into a slice of preallocated output
+// offsets and connectivity, shifting the offsets and the point ids.
+struct AppendCellsWorker
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, vtkIdType* offsets, vtkIdType* connectivity,
+    vtkIdType connectivityStart, vtkIdType pointOffset)
+  {
+    const vtkIdType numCells = state.GetNumberOfCells();
+    const auto* inOffsets = state.GetOffsets()->GetPointer(0);
+    const auto* inConnectivity = state.GetConnectivity()->GetPointer(0);
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        offsets[cellId] = static_cast<vtkIdType>(inOffsets[cellId]) + connectivityStart;
+      }
+    });
+    vtkSMPTools::For(0, static_cast<vtkIdType>(inOffsets[numCells]),
+      [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          connectivity[connectivityStart + i] =
+            static_cast<vtkIdType>(inConnectivity[i]) + pointOffset;
+        }
+      });
+  }
+};
+
+} // anonymous namespace
+
+#endif
+// VTK-HeaderTest-Exclude: vtkAppendDataInternal.h
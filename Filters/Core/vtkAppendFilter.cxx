@@ -14,23 +14,32 @@
 =========================================================================*/
 #include "vtkAppendFilter.h"
 
+#include "vtkAppendDataInternal.h"
 #include "vtkBoundingBox.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDataSetCollection.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
-#include "vtkIncrementalOctreePointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendFilter);
 
@@ -125,12 +134,12 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType totalNumCells = 0;
   // If we only have a single dataset and it's an unstructured grid
   // we can just shallow copy that and exit quickly.
-  int numDataSets = 0;
   vtkUnstructuredGrid* inputUG = nullptr;
 
   vtkSmartPointer<vtkDataSetCollection> inputs;
   inputs.TakeReference(this->GetNonEmptyInputs(inputVector));
 
+  std::vector<vtkDataSet*> dataSets;
   vtkCollectionSimpleIterator iter;
   inputs->InitTraversal(iter);
   vtkDataSet* dataSet = nullptr;
@@ -138,9 +147,10 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
   {
     totalNumPts += dataSet->GetNumberOfPoints();
     totalNumCells += dataSet->GetNumberOfCells();
-    numDataSets++;
+    dataSets.push_back(dataSet);
     inputUG = vtkUnstructuredGrid::SafeDownCast(dataSet);
   }
+  const vtkIdType numDataSets = static_cast<vtkIdType>(dataSets.size());
 
   if (totalNumPts < 1)
   {
@@ -156,9 +166,6 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
-  // Now we can allocate memory
-  output->Allocate(totalNumCells);
-
   vtkSmartPointer<vtkPoints> newPts = vtkSmartPointer<vtkPoints>::New();
 
   // set precision for the points in the output
@@ -196,10 +203,8 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
   // Additionally to having this->MergePoints set to true,
   // points can be merge if there are not input cells cells OR if global point ids are
   // available in the inputs.
-  inputs->InitTraversal(iter);
-  dataSet = inputs->GetNextDataSet(iter);
   vtkIdTypeArray* globalIdsArray =
-    vtkIdTypeArray::SafeDownCast(dataSet->GetPointData()->GetGlobalIds());
+    vtkIdTypeArray::SafeDownCast(dataSets[0]->GetPointData()->GetGlobalIds());
 
   bool reallyMergePoints = false;
   if (this->MergePoints == 1 && inputVector[0]->GetNumberOfInformationObjects() > 0)
@@ -225,156 +230,360 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
-  // If we aren't merging points, we need to allocate the points here.
-  if (!reallyMergePoints)
+  // Make sure the inputs are ready to be accessed concurrently (e.g. polydata
+  // build their cells on first access).
+  vtkNew<vtkIdList> ptIds;
+  for (vtkDataSet* ds : dataSets)
   {
-    newPts->SetNumberOfPoints(totalNumPts);
+    if (ds->GetNumberOfCells() > 0)
+    {
+      ds->GetCellType(0);
+      ds->GetCellPoints(0, ptIds);
+    }
   }
 
-  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
-  ptIds->Allocate(VTK_CELL_SIZE);
-  vtkSmartPointer<vtkIdList> newPtIds = vtkSmartPointer<vtkIdList>::New();
-  newPtIds->Allocate(VTK_CELL_SIZE);
-
-  vtkIdType twentieth = (totalNumPts + totalNumCells) / 20 + 1;
-
-  // For optionally merging duplicate points
-  vtkIdType* globalIndices = new vtkIdType[totalNumPts];
-
-  vtkSmartPointer<vtkIncrementalOctreePointLocator> ptInserter;
-  if (reallyMergePoints)
-  {
-    vtkBoundingBox outputBB;
-    inputs->InitTraversal(iter);
-    while ((dataSet = inputs->GetNextDataSet(iter)))
+  // Compute the size of the connectivity and of the polyhedron face streams
+  // of each input, then where each input goes in the output.
+  std::vector<vtkIdType> ptOffsets(numDataSets + 1, 0);
+  std::vector<vtkIdType> cellOffsets(numDataSets + 1, 0);
+  std::vector<vtkIdType> connectivityOffsets(numDataSets + 1, 0);
+  std::vector<vtkIdType> faceOffsets(numDataSets + 1, 0);
+  vtkSMPThreadLocalObject<vtkIdList> tlPtIds;
+  vtkSMPTools::For(0, numDataSets, 1, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPtIds = tlPtIds.Local();
+    for (vtkIdType i = begin; i < end; ++i)
     {
-      // Union of bounding boxes
-      double localBox[6];
-      dataSet->GetBounds(localBox);
-      outputBB.AddBounds(localBox);
+      vtkDataSet* ds = dataSets[i];
+      const vtkIdType numCells = ds->GetNumberOfCells();
+      vtkIdType connectivitySize = 0;
+      vtkIdType facesSize = 0;
+      if (auto ug = vtkUnstructuredGrid::SafeDownCast(ds))
+      {
+        connectivitySize = ug->GetCells()->GetNumberOfConnectivityIds();
+        if (ug->GetFaces() != nullptr)
+        {
+          for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+          {
+            if (ug->GetCellType(cellId) == VTK_POLYHEDRON)
+            {
+              vtkIdType nfaces;
+              const vtkIdType* facePtIds;
+              ug->GetFaceStream(cellId, nfaces, facePtIds);
+              facesSize += 1;
+              for (vtkIdType face = 0; face < nfaces; ++face)
+              {
+                facesSize += facePtIds[0] + 1;
+                facePtIds += facePtIds[0] + 1;
+              }
+            }
+          }
+        }
+      }
+      else if (auto pd = vtkPolyData::SafeDownCast(ds))
+      {
+        connectivitySize = pd->GetVerts()->GetNumberOfConnectivityIds() +
+          pd->GetLines()->GetNumberOfConnectivityIds() +
+          pd->GetPolys()->GetNumberOfConnectivityIds() +
+          pd->GetStrips()->GetNumberOfConnectivityIds();
+      }
+      else
+      {
+        for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+        {
+          ds->GetCellPoints(cellId, cellPtIds);
+          connectivitySize += cellPtIds->GetNumberOfIds();
+        }
+      }
+      ptOffsets[i + 1] = ds->GetNumberOfPoints();
+      cellOffsets[i + 1] = numCells;
+      connectivityOffsets[i + 1] = connectivitySize;
+      faceOffsets[i + 1] = facesSize;
     }
+  });
+  for (vtkIdType i = 0; i < numDataSets; ++i)
+  {
+    ptOffsets[i + 1] += ptOffsets[i];
+    cellOffsets[i + 1] += cellOffsets[i];
+    connectivityOffsets[i + 1] += connectivityOffsets[i];
+    faceOffsets[i + 1] += faceOffsets[i];
+  }
+  const vtkIdType totalConnectivitySize = connectivityOffsets[numDataSets];
+  const vtkIdType totalFacesSize = faceOffsets[numDataSets];
+  this->UpdateProgress(0.10);
+
+  // Now we can allocate memory. Points are appended first, and merged
+  // afterwards if requested.
+  vtkNew<vtkPoints> appendedPts;
+  appendedPts->SetDataType(newPts->GetDataType());
+  appendedPts->SetNumberOfPoints(totalNumPts);
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(totalNumCells + 1);
+  offsets->SetValue(totalNumCells, totalConnectivitySize);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(totalConnectivitySize);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(totalNumCells);
+  vtkSmartPointer<vtkIdTypeArray> faceLocations;
+  vtkSmartPointer<vtkIdTypeArray> faces;
+  if (totalFacesSize > 0)
+  {
+    faceLocations = vtkSmartPointer<vtkIdTypeArray>::New();
+    faceLocations->SetNumberOfValues(totalNumCells);
+    faces = vtkSmartPointer<vtkIdTypeArray>::New();
+    faces->SetNumberOfValues(totalFacesSize);
+  }
 
-    double outputBounds[6];
-    outputBB.GetBounds(outputBounds);
-
-    ptInserter = vtkSmartPointer<vtkIncrementalOctreePointLocator>::New();
-    if (this->ToleranceIsAbsolute)
+  // append the blocks / pieces in terms of the geometry and topology
+  ArrayAppender appender;
+  for (vtkIdType i = 0; i < numDataSets; ++i)
+  {
+    if (auto ps = vtkPointSet::SafeDownCast(dataSets[i]))
     {
-      ptInserter->SetTolerance(this->Tolerance);
+      appender.Add(ps->GetPoints()->GetData(), 0, ps->GetNumberOfPoints(), appendedPts->GetData(),
+        ptOffsets[i]);
     }
-    else
+    if (auto ug = vtkUnstructuredGrid::SafeDownCast(dataSets[i]))
     {
-      ptInserter->SetTolerance(this->Tolerance * outputBB.GetDiagonalLength());
+      appender.Add(ug->GetCellTypesArray(), 0, ug->GetNumberOfCells(), types, cellOffsets[i]);
     }
-
-    ptInserter->InitPointInsertion(newPts, outputBounds);
   }
+  appender.Execute();
 
-  // append the blocks / pieces in terms of the geometry and topology
-  std::unordered_map<vtkIdType, vtkIdType> addedPointsMap;
-  vtkIdType count = 0;
-  vtkIdType ptOffset = 0;
-  float decimal = 0.0;
-  inputs->InitTraversal(iter);
-  int abort = 0;
-  double p[3];
-  while (!abort && (dataSet = inputs->GetNextDataSet(iter)))
-  {
-    vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
-    vtkIdType dataSetNumCells = dataSet->GetNumberOfCells();
-    vtkIdTypeArray* dataSetGlobalIdsArray = globalIdsArray
-      ? vtkIdTypeArray::SafeDownCast(dataSet->GetPointData()->GetGlobalIds())
-      : nullptr;
-
-    // copy points
-    for (vtkIdType ptId = 0; ptId < dataSetNumPts && !abort; ++ptId)
+  vtkSMPTools::For(0, numDataSets, 1, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPtIds = tlPtIds.Local();
+    for (vtkIdType i = begin; i < end; ++i)
     {
-      if (reallyMergePoints)
+      vtkDataSet* ds = dataSets[i];
+      const vtkIdType numCells = ds->GetNumberOfCells();
+      const vtkIdType ptOffset = ptOffsets[i];
+      const vtkIdType cellOffset = cellOffsets[i];
+      const vtkIdType connectivityOffset = connectivityOffsets[i];
+      vtkIdType* outOffsets = offsets->GetPointer(cellOffset);
+      vtkIdType* outConnectivity = connectivity->GetPointer(0);
+      if (!vtkPointSet::SafeDownCast(ds))
       {
-        if (dataSetGlobalIdsArray)
+        double p[3];
+        for (vtkIdType ptId = 0; ptId < ds->GetNumberOfPoints(); ++ptId)
         {
-          vtkIdType globalId = dataSetGlobalIdsArray->GetValue(ptId);
-          auto it = addedPointsMap.find(globalId);
-          if (it == addedPointsMap.end())
-          {
-            globalIndices[ptId + ptOffset] = newPts->GetNumberOfPoints();
-            dataSet->GetPoint(ptId, p);
-            vtkIdType newPtId = newPts->InsertNextPoint(p);
-            addedPointsMap.emplace(globalId, newPtId);
-          }
-          else
+          ds->GetPoint(ptId, p);
+          appendedPts->SetPoint(ptId + ptOffset, p);
+        }
+      }
+
+      if (auto ug = vtkUnstructuredGrid::SafeDownCast(ds))
+      {
+        ug->GetCells()->Visit(
+          AppendCellsWorker{}, outOffsets, outConnectivity, connectivityOffset, ptOffset);
+        if (faces)
+        {
+          vtkIdType* outFaces = faces->GetPointer(0);
+          vtkIdType faceLocation = faceOffsets[i];
+          for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
           {
-            globalIndices[ptId + ptOffset] = it->second;
+            if (ug->GetFaces() == nullptr || ug->GetCellType(cellId) != VTK_POLYHEDRON)
+            {
+              faceLocations->SetValue(cellOffset + cellId, -1);
+              continue;
+            }
+            faceLocations->SetValue(cellOffset + cellId, faceLocation);
+            vtkIdType nfaces;
+            const vtkIdType* facePtIds;
+            ug->GetFaceStream(cellId, nfaces, facePtIds);
+            outFaces[faceLocation++] = nfaces;
+            for (vtkIdType face = 0; face < nfaces; ++face)
+            {
+              const vtkIdType nPoints = facePtIds[0];
+              outFaces[faceLocation++] = nPoints;
+              for (vtkIdType j = 1; j <= nPoints; ++j)
+              {
+                outFaces[faceLocation++] = facePtIds[j] + ptOffset;
+              }
+              facePtIds += nPoints + 1;
+            }
           }
         }
-        else
+        continue;
+      }
+
+      if (faces)
+      {
+        std::fill_n(faceLocations->GetPointer(cellOffset), numCells, -1);
+      }
+      // Cells of polydata built with InsertNextCell are not ordered by type, so
+      // the cell array is copied directly only if it holds all the cells.
+      vtkCellArray* polyDataCells = nullptr;
+      if (auto pd = vtkPolyData::SafeDownCast(ds))
+      {
+        vtkCellArray* inCells[4] = { pd->GetVerts(), pd->GetLines(), pd->GetPolys(),
+          pd->GetStrips() };
+        for (int type = 0; type < 4; ++type)
         {
-          vtkIdType globalPtId = 0;
-          dataSet->GetPoint(ptId, p);
-          ptInserter->InsertUniquePoint(p, globalPtId);
-          globalIndices[ptId + ptOffset] = globalPtId;
-          // The point inserter puts the point into newPts, so we don't have to do that here.
+          if (inCells[type]->GetNumberOfCells() == numCells)
+          {
+            polyDataCells = inCells[type];
+          }
         }
       }
+      if (polyDataCells)
+      {
+        polyDataCells->Visit(
+          AppendCellsWorker{}, outOffsets, outConnectivity, connectivityOffset, ptOffset);
+      }
       else
       {
-        globalIndices[ptId + ptOffset] = ptId + ptOffset;
-        dataSet->GetPoint(ptId, p);
-        newPts->SetPoint(ptId + ptOffset, p);
+        vtkIdType connectivityId = connectivityOffset;
+        for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+        {
+          ds->GetCellPoints(cellId, cellPtIds);
+          outOffsets[cellId] = connectivityId;
+          for (vtkIdType id = 0; id < cellPtIds->GetNumberOfIds(); ++id)
+          {
+            outConnectivity[connectivityId++] = cellPtIds->GetId(id) + ptOffset;
+          }
+        }
       }
-
-      // Update progress
-      count++;
-      if (!(count % twentieth))
+      for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
       {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
+        types->SetValue(cellOffset + cellId, static_cast<unsigned char>(ds->GetCellType(cellId)));
       }
     }
+  });
+  this->UpdateProgress(0.50);
 
-    // copy cell
-    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
-    for (vtkIdType cellId = 0; cellId < dataSetNumCells && !abort; ++cellId)
+  // For optionally merging duplicate points
+  std::vector<vtkIdType> globalIndices;
+  if (!reallyMergePoints)
+  {
+    newPts = appendedPts;
+  }
+  else if (globalIdsArray)
+  {
+    // Points sharing the same global id are merged, keeping the first one.
+    globalIndices.resize(totalNumPts);
+    std::unordered_map<vtkIdType, vtkIdType> addedPointsMap;
+    double p[3];
+    for (vtkIdType i = 0; i < numDataSets; ++i)
     {
-      newPtIds->Reset();
-      if (ug && dataSet->GetCellType(cellId) == VTK_POLYHEDRON)
+      vtkIdTypeArray* dataSetGlobalIdsArray =
+        vtkIdTypeArray::SafeDownCast(dataSets[i]->GetPointData()->GetGlobalIds());
+      for (vtkIdType ptId = ptOffsets[i]; ptId < ptOffsets[i + 1]; ++ptId)
       {
-        vtkIdType nfaces;
-        const vtkIdType* facePtIds;
-        ug->GetFaceStream(cellId, nfaces, facePtIds);
-        for (vtkIdType id = 0; id < nfaces; ++id)
+        if (dataSetGlobalIdsArray)
         {
-          vtkIdType nPoints = facePtIds[0];
-          newPtIds->InsertNextId(nPoints);
-          for (vtkIdType j = 1; j <= nPoints; ++j)
+          vtkIdType globalId = dataSetGlobalIdsArray->GetValue(ptId - ptOffsets[i]);
+          auto it = addedPointsMap.find(globalId);
+          if (it != addedPointsMap.end())
           {
-            newPtIds->InsertNextId(globalIndices[facePtIds[j] + ptOffset]);
+            globalIndices[ptId] = it->second;
+            continue;
           }
-          facePtIds += nPoints + 1;
+          addedPointsMap.emplace(globalId, newPts->GetNumberOfPoints());
         }
-        output->InsertNextCell(VTK_POLYHEDRON, nfaces, newPtIds->GetPointer(0));
+        globalIndices[ptId] = newPts->GetNumberOfPoints();
+        appendedPts->GetPoint(ptId, p);
+        newPts->InsertNextPoint(p);
       }
-      else
+    }
+  }
+  else
+  {
+    // Coincident points are merged with the threaded static point locator.
+    // Each point is merged into a point kept within the tolerance.
+    vtkNew<vtkPolyData> mergeInput;
+    mergeInput->SetPoints(appendedPts);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(mergeInput);
+    locator->BuildLocator();
+    double tol = this->Tolerance;
+    if (!this->ToleranceIsAbsolute)
+    {
+      double bounds[6];
+      appendedPts->GetBounds(bounds);
+      tol *= vtkBoundingBox(bounds).GetDiagonalLength();
+    }
+    std::vector<vtkIdType> mergeMap(totalNumPts);
+    locator->MergePoints(tol, mergeMap.data());
+
+    // With the default bin traversal, a point may be merged into a point of
+    // higher id, so the kept points are numbered before the merged ones are
+    // resolved.
+    globalIndices.resize(totalNumPts);
+    vtkIdType numNewPts = 0;
+    for (vtkIdType ptId = 0; ptId < totalNumPts; ++ptId)
+    {
+      if (mergeMap[ptId] == ptId)
+      {
+        globalIndices[ptId] = numNewPts++;
+      }
+    }
+    newPts->SetNumberOfPoints(numNewPts);
+    vtkSMPTools::For(0, totalNumPts, [&](vtkIdType begin, vtkIdType end) {
+      double p[3];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
       {
-        dataSet->GetCellPoints(cellId, ptIds);
-        for (vtkIdType id = 0; id < ptIds->GetNumberOfIds(); ++id)
+        if (mergeMap[ptId] == ptId)
+        {
+          appendedPts->GetPoint(ptId, p);
+          newPts->SetPoint(globalIndices[ptId], p);
+        }
+        else
         {
-          newPtIds->InsertId(id, globalIndices[ptIds->GetId(id) + ptOffset]);
+          vtkIdType keptId = mergeMap[ptId];
+          while (mergeMap[keptId] != keptId)
+          {
+            keptId = mergeMap[keptId];
+          }
+          globalIndices[ptId] = globalIndices[keptId];
         }
-        output->InsertNextCell(dataSet->GetCellType(cellId), newPtIds);
       }
+    });
+  }
 
-      // Update progress
-      count++;
-      if (!(count % twentieth))
+  if (!globalIndices.empty())
+  {
+    // Renumber the points of the cells and of the polyhedron faces.
+    vtkIdType* connectivityIds = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, totalConnectivitySize, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
       {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
+        connectivityIds[i] = globalIndices[connectivityIds[i]];
       }
+    });
+    if (faces)
+    {
+      vtkSMPTools::For(0, totalNumCells, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+          vtkIdType location = faceLocations->GetValue(cellId);
+          if (location < 0)
+          {
+            continue;
+          }
+          vtkIdType* facePtIds = faces->GetPointer(location);
+          const vtkIdType nfaces = *facePtIds++;
+          for (vtkIdType face = 0; face < nfaces; ++face)
+          {
+            const vtkIdType nPoints = *facePtIds++;
+            for (vtkIdType j = 0; j < nPoints; ++j, ++facePtIds)
+            {
+              *facePtIds = globalIndices[*facePtIds];
+            }
+          }
+        }
+      });
     }
-    ptOffset += dataSetNumPts;
+  }
+  this->UpdateProgress(0.60);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, connectivity);
+  if (faces)
+  {
+    output->SetCells(types, cells, faceLocations, faces);
+  }
+  else
+  {
+    output->SetCells(types, cells);
   }
 
   // this filter can copy global ids except for global point ids when merging
@@ -389,8 +598,8 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
   output->GetCellData()->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
 
   // Now copy the array data
-  this->AppendArrays(
-    vtkDataObject::POINT, inputVector, globalIndices, output, newPts->GetNumberOfPoints());
+  this->AppendArrays(vtkDataObject::POINT, inputVector,
+    globalIndices.empty() ? nullptr : globalIndices.data(), output, newPts->GetNumberOfPoints());
   this->UpdateProgress(0.75);
   this->AppendArrays(vtkDataObject::CELL, inputVector, nullptr, output, output->GetNumberOfCells());
   this->UpdateProgress(1.0);
@@ -399,8 +608,6 @@ int vtkAppendFilter::RequestData(vtkInformation* vtkNotUsed(request),
   output->SetPoints(newPts);
   output->Squeeze();
 
-  delete[] globalIndices;
-
   return 1;
 }
 
@@ -456,8 +663,14 @@ void vtkAppendFilter::AppendArrays(int attributesType, vtkInformationVector** in
 
   vtkDataSetAttributes* outputData = output->GetAttributes(attributesType);
   outputData->CopyAllocate(fieldList, totalNumberOfElements);
+  if (globalIds == nullptr)
+  {
+    // Without merged points, the arrays of all inputs are copied concurrently.
+    ArrayAppender::SetNumberOfTuples(outputData, totalNumberOfElements);
+  }
 
   // copy arrays.
+  ArrayAppender appender;
   int inputIndex;
   vtkIdType offset = 0;
   for (inputIndex = 0, dataSet = nullptr, inputs->InitTraversal(iter);
@@ -475,12 +688,13 @@ void vtkAppendFilter::AppendArrays(int attributesType, vtkInformationVector** in
       }
       else
       {
-        fieldList.CopyData(inputIndex, inputData, 0, numberOfInputTuples, outputData, offset);
+        appender.Add(fieldList, inputIndex, inputData, 0, numberOfInputTuples, outputData, offset);
       }
       offset += numberOfInputTuples;
       ++inputIndex;
     }
   }
+  appender.Execute();
 }
 
 //------------------------------------------------------------------------------
@@ -27,7 +27,12 @@
  * `MergePoints`. If this flag is set, points are merged if they are within
  * `Tolerance` radius. If a point global id array is available (point data named
  * "GlobalPointIds"), then two points are merged if they share the same point global id,
- * without checking for coincident point.
+ * without checking for coincident point. Coincident points are merged with a
+ * vtkStaticPointLocator, each point being merged into a point kept within
+ * `Tolerance`, which may have a higher id.
+ *
+ * The output offsets of each input are computed first, then the points, cells
+ * and attributes of all inputs are copied concurrently with vtkSMPTools.
  *
  * @sa
  * vtkAppendPolyData
@@ -73,8 +78,9 @@ public:
    * Get/Set the tolerance to use to find coincident points when `MergePoints`
    * is `true`. Default is 0.0.
    *
-   * This is simply passed on to the internal vtkLocator used to merge points.
-   * @sa `vtkLocator::SetTolerance`.
+   * This is simply passed on to the internal vtkStaticPointLocator used to
+   * merge points.
+   * @sa `vtkStaticPointLocator::MergePoints`.
    */
   vtkSetClampMacro(Tolerance, double, 0.0, VTK_DOUBLE_MAX);
   vtkGetMacro(Tolerance, double);
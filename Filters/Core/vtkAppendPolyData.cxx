@@ -15,6 +15,7 @@
 #include "vtkAppendPolyData.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkAppendDataInternal.h"
 #include "vtkArrayDispatch.h"
 #include "vtkAssume.h"
 #include "vtkCellArray.h"
@@ -22,15 +23,20 @@
 #include "vtkDataArrayRange.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkInformation.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTrivialProducer.h"
 
+#include <array>
 #include <cassert>
 #include <cstdlib>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendPolyData);
 
@@ -124,13 +130,7 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output, vtkPolyData* inputs[],
 {
   int idx;
   vtkPolyData* ds;
-  vtkPoints* inPts;
-  vtkPoints* newPts;
-  vtkCellArray *inVerts, *newVerts;
-  vtkCellArray *inLines, *newLines;
-  vtkCellArray *inPolys, *newPolys;
   vtkIdType sizePolys, numPolys;
-  vtkCellArray *inStrips, *newStrips;
   vtkIdType numPts, numCells;
   vtkPointData* inPD = nullptr;
   vtkCellData* inCD = nullptr;
@@ -269,7 +269,7 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output, vtkPolyData* inputs[],
   }
 
   // Allocate geometry/topology
-  newPts = vtkPoints::New();
+  vtkNew<vtkPoints> newPts;
 
   // Set the desired precision for the points in the output.
   if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
@@ -287,40 +287,22 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output, vtkPolyData* inputs[],
 
   newPts->SetNumberOfPoints(numPts);
 
-  newVerts = vtkCellArray::New();
-  bool allocated = newVerts->AllocateExact(numVerts, sizeVerts);
-
-  if (sizeVerts > 0 && !allocated)
-  {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
-  }
-
-  newLines = vtkCellArray::New();
-  allocated = newLines->AllocateExact(numLines, sizeLines);
-
-  if (sizeLines > 0 && !allocated)
+  // Verts, lines, polys and strips are appended separately.
+  const vtkIdType numCellsOfType[4] = { numVerts, numLines, numPolys, numStrips };
+  const vtkIdType sizeOfType[4] = { sizeVerts, sizeLines, sizePolys, sizeStrips };
+  vtkNew<vtkIdTypeArray> newOffsets[4];
+  vtkNew<vtkIdTypeArray> newConnectivity[4];
+  for (int type = 0; type < 4; ++type)
   {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
-  }
-
-  newPolys = vtkCellArray::New();
-  allocated = newPolys->AllocateExact(numPolys, sizePolys);
-
-  if (sizePolys > 0 && !allocated)
-  {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
-  }
-
-  newStrips = vtkCellArray::New();
-  allocated = newStrips->AllocateExact(numStrips, sizeStrips);
-
-  if (sizeStrips > 0 && !allocated)
-  {
-    vtkErrorMacro(<< "Memory allocation failed in append filter");
-    return 0;
+    if (!newOffsets[type]->Resize(numCellsOfType[type] + 1) ||
+      !newConnectivity[type]->Resize(sizeOfType[type]))
+    {
+      vtkErrorMacro(<< "Memory allocation failed in append filter");
+      return 0;
+    }
+    newOffsets[type]->SetNumberOfValues(numCellsOfType[type] + 1);
+    newOffsets[type]->SetValue(numCellsOfType[type], sizeOfType[type]);
+    newConnectivity[type]->SetNumberOfValues(sizeOfType[type]);
   }
 
   // Since points are cells are not merged,
@@ -331,109 +313,111 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output, vtkPolyData* inputs[],
   // Allocate the point and cell data
   outputPD->CopyAllocate(ptList, numPts);
   outputCD->CopyAllocate(cellList, numCells);
-
-  // loop over all input sets
+  ArrayAppender::SetNumberOfTuples(outputPD, numPts);
+  ArrayAppender::SetNumberOfTuples(outputCD, numCells);
+
+  // Compute where each input goes in the output, and queue the copies of the
+  // points and of the point and cell data.
+  std::vector<vtkIdType> ptOffsets(numInputs, 0);
+  std::vector<std::array<vtkIdType, 4>> cellOffsets(numInputs);
+  std::vector<std::array<vtkIdType, 4>> connectivityOffsets(numInputs);
+  ArrayAppender appender;
   vtkIdType ptOffset = 0;
-  vtkIdType vertOffset = 0;
-  vtkIdType linesOffset = numVerts;
-  vtkIdType polysOffset = numVerts + numLines;
-  vtkIdType stripsOffset = numVerts + numLines + numPolys;
+  std::array<vtkIdType, 4> cellOffset = { { 0, 0, 0, 0 } };
+  std::array<vtkIdType, 4> connectivityOffset = { { 0, 0, 0, 0 } };
   countPD = countCD = 0;
   for (idx = 0; idx < numInputs; ++idx)
   {
-    this->UpdateProgress(0.2 + 0.8 * idx / numInputs);
+    ptOffsets[idx] = ptOffset;
+    cellOffsets[idx] = cellOffset;
+    connectivityOffsets[idx] = connectivityOffset;
+
     ds = inputs[idx];
     // this check is not necessary, but I'll put it in anyway
-    if (ds != nullptr)
+    if (ds == nullptr || (ds->GetNumberOfPoints() <= 0 && ds->GetNumberOfCells() <= 0))
     {
-      numPts = ds->GetNumberOfPoints();
-      numCells = ds->GetNumberOfCells();
-      if (numPts <= 0 && numCells <= 0)
-      {
-        continue; // no input, just skip
-      }
-
-      inPD = ds->GetPointData();
-      inCD = ds->GetCellData();
+      continue; // no input, just skip
+    }
 
-      inPts = ds->GetPoints();
-      inVerts = ds->GetVerts();
-      inLines = ds->GetLines();
-      inPolys = ds->GetPolys();
-      inStrips = ds->GetStrips();
+    if (ds->GetNumberOfPoints() > 0)
+    {
+      appender.Add(
+        ds->GetPoints()->GetData(), 0, ds->GetNumberOfPoints(), newPts->GetData(), ptOffset);
+      appender.Add(ptList, countPD, ds->GetPointData(), 0, ds->GetNumberOfPoints(), outputPD,
+        ptOffset);
+      ++countPD;
+    }
 
-      if (ds->GetNumberOfPoints() > 0)
+    if (ds->GetNumberOfCells() > 0)
+    {
+      vtkCellArray* inCells[4] = { ds->GetVerts(), ds->GetLines(), ds->GetPolys(),
+        ds->GetStrips() };
+      // These are the cellIDs at which each of the cell types start, in the
+      // input and in the output cell data.
+      vtkIdType inputIndex = 0;
+      vtkIdType outputIndex = 0;
+      for (int type = 0; type < 4; ++type)
       {
-        // copy points directly
-        this->AppendData(newPts->GetData(), inPts->GetData(), ptOffset);
-        outputPD->CopyData(ptList, inPD, countPD, ptOffset, numPts, 0);
-        ++countPD;
+        const vtkIdType n = inCells[type]->GetNumberOfCells();
+        appender.Add(cellList, countCD, ds->GetCellData(), inputIndex, n, outputCD,
+          outputIndex + cellOffset[type]);
+        inputIndex += n;
+        outputIndex += numCellsOfType[type];
+        cellOffset[type] += n;
+        connectivityOffset[type] += inCells[type]->GetNumberOfConnectivityIds();
       }
+      ++countCD;
+    }
+    ptOffset += ds->GetNumberOfPoints();
+  }
+  this->UpdateProgress(0.20);
 
-      if (ds->GetNumberOfCells() > 0)
+  // Copy everything concurrently.
+  appender.Execute();
+  this->UpdateProgress(0.60);
+  vtkSMPTools::For(0, numInputs, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (inputs[i] == nullptr || inputs[i]->GetNumberOfCells() <= 0)
       {
-        // These are the cellIDs at which each of the cell types start.
-        vtkIdType vertsIndex = 0;
-        vtkIdType linesIndex = ds->GetNumberOfVerts();
-        vtkIdType polysIndex = linesIndex + ds->GetNumberOfLines();
-        vtkIdType stripsIndex = polysIndex + ds->GetNumberOfPolys();
-
-        // copy the cells
-        this->AppendCells(newVerts, inVerts, ptOffset);
-        this->AppendCells(newLines, inLines, ptOffset);
-        this->AppendCells(newPolys, inPolys, ptOffset);
-        this->AppendCells(newStrips, inStrips, ptOffset);
-
-        // copy cell data
-        outputCD->CopyData(cellList, inCD, countCD, vertOffset, ds->GetNumberOfVerts(), vertsIndex);
-        vertOffset += ds->GetNumberOfVerts();
-        outputCD->CopyData(
-          cellList, inCD, countCD, linesOffset, ds->GetNumberOfLines(), linesIndex);
-        linesOffset += ds->GetNumberOfLines();
-        outputCD->CopyData(
-          cellList, inCD, countCD, polysOffset, ds->GetNumberOfPolys(), polysIndex);
-        polysOffset += ds->GetNumberOfPolys();
-        outputCD->CopyData(
-          cellList, inCD, countCD, stripsOffset, ds->GetNumberOfStrips(), stripsIndex);
-        stripsOffset += ds->GetNumberOfStrips();
-        ++countCD;
+        continue;
+      }
+      vtkCellArray* inCells[4] = { inputs[i]->GetVerts(), inputs[i]->GetLines(),
+        inputs[i]->GetPolys(), inputs[i]->GetStrips() };
+      for (int type = 0; type < 4; ++type)
+      {
+        inCells[type]->Visit(AppendCellsWorker{},
+          newOffsets[type]->GetPointer(cellOffsets[i][type]), newConnectivity[type]->GetPointer(0),
+          connectivityOffsets[i][type], ptOffsets[i]);
       }
-      ptOffset += numPts;
     }
-  }
+  });
 
   // Update ourselves and release memory
   //
   output->SetPoints(newPts);
-  newPts->Delete();
 
-  if (newVerts->GetNumberOfCells() > 0)
+  vtkNew<vtkCellArray> newCells[4];
+  for (int type = 0; type < 4; ++type)
   {
-    output->SetVerts(newVerts);
+    newCells[type]->SetData(newOffsets[type], newConnectivity[type]);
   }
-  newVerts->Delete();
-
-  if (newLines->GetNumberOfCells() > 0)
+  if (numVerts > 0)
   {
-    output->SetLines(newLines);
+    output->SetVerts(newCells[0]);
   }
-  newLines->Delete();
-
-  if (newPolys->GetNumberOfCells() > 0)
+  if (numLines > 0)
   {
-    output->SetPolys(newPolys);
+    output->SetLines(newCells[1]);
   }
-  newPolys->Delete();
-
-  if (newStrips->GetNumberOfCells() > 0)
+  if (numPolys > 0)
   {
-    output->SetStrips(newStrips);
+    output->SetPolys(newCells[2]);
+  }
+  if (numStrips > 0)
+  {
+    output->SetStrips(newCells[3]);
   }
-  newStrips->Delete();
-
-  // When all optimizations are complete, this squeeze will be unnecessary.
-  // (But it does not seem to cost much.)
-  output->Squeeze();
 
   return 1;
 }
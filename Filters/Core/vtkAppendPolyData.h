@@ -24,6 +24,9 @@
  * attributes available.  (For example, if one dataset has point scalars but
  * another does not, point scalars will not be appended.)
  *
+ * The output offsets of each input are computed first, then the points, cells
+ * and attributes of all inputs are copied concurrently with vtkSMPTools.
+ *
  * @warning
  * The related filter vtkRemovePolyData enables the subtraction, or removal
  * of the cells of a vtkPolyData. Hence vtkRemovePolyData functions like the
@@ -18,6 +18,7 @@
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkExprTkFunctionParser.h"
@@ -35,6 +36,8 @@
 #include "vtkTable.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkArrayCalculator);
 
@@ -104,6 +107,55 @@ enum ResultType
   VECTOR_RESULT
 } resultType = SCALAR_RESULT;
 
+//------------------------------------------------------------------------------
+// The functor evaluates the function on blocks of tuples: the selected
+// components of the input arrays are gathered into one row of values per
+// component, and the whole block is evaluated with a single call to the
+// parser.
+namespace
+{
+const vtkIdType vtkArrayCalculatorBlockSize = 512;
+
+// Copy the given components of the tuples [begin, end) of an array into rows.
+template <typename TArray>
+void vtkArrayCalculatorGather(vtkDataArray* array, const int* components, int numComponents,
+  vtkIdType begin, vtkIdType end, double* const* rows)
+{
+  const auto tuples = vtk::DataArrayTupleRange(static_cast<TArray*>(array), begin, end);
+  vtkIdType k = 0;
+  for (const auto tuple : tuples)
+  {
+    for (int c = 0; c < numComponents; c++)
+    {
+      rows[c][k] = static_cast<double>(tuple[components[c]]);
+    }
+    k++;
+  }
+}
+
+using vtkArrayCalculatorGatherFunction = void (*)(
+  vtkDataArray*, const int*, int, vtkIdType, vtkIdType, double* const*);
+
+// Select the gather function of the actual type of an array.
+struct vtkArrayCalculatorGatherSelector
+{
+  vtkArrayCalculatorGatherFunction Function = &vtkArrayCalculatorGather<vtkDataArray>;
+
+  template <typename TArray>
+  void operator()(TArray*)
+  {
+    this->Function = &vtkArrayCalculatorGather<TArray>;
+  }
+};
+
+vtkArrayCalculatorGatherFunction vtkArrayCalculatorGetGatherFunction(vtkDataArray* array)
+{
+  vtkArrayCalculatorGatherSelector selector;
+  vtkArrayDispatch::Dispatch::Execute(array, selector);
+  return selector.Function;
+}
+}
+
 //------------------------------------------------------------------------------
 template <typename TFunctionParser, typename TResultArray>
 class vtkArrayCalculatorFunctor
@@ -142,9 +194,29 @@ private:
 
   TResultArray* ResultArray;
 
+  std::vector<vtkArrayCalculatorGatherFunction> ScalarGathers;
+  std::vector<vtkArrayCalculatorGatherFunction> VectorGathers;
+  vtkDataArray* Coordinates;
+  vtkArrayCalculatorGatherFunction CoordinatesGather;
+
+  // Rows of values of a block of tuples: a row for each selected component
+  // of the arrays, the coordinates and the result, and the rows of the
+  // parser variables.
+  struct Block
+  {
+    std::vector<double> Values;
+    std::vector<double*> ScalarArrayRows;
+    std::vector<double*> VectorArrayRows;
+    double* PointRows[3];
+    double* ResultRows[3];
+    std::vector<const double*> ScalarRows;
+    std::vector<const double*> VectorRows;
+  };
+
   // // thread local
   vtkSMPThreadLocal<vtkSmartPointer<TFunctionParser>> FunctionParser;
   vtkSMPThreadLocal<std::vector<double>> Tuple;
+  vtkSMPThreadLocal<Block> Blocks;
   int MaxTupleSize;
 
 public:
@@ -191,7 +263,41 @@ public:
     , ScalarArrayIndices(scalarArrayIndices)
     , VectorArrayIndices(vectorArrayIndices)
     , ResultArray(resultArray)
+    , Coordinates(nullptr)
+    , CoordinatesGather(nullptr)
   {
+    // bind the input arrays to the gather functions of their types
+    this->ScalarGathers.resize(this->ScalarArrays.size());
+    for (size_t i = 0; i < this->ScalarArrays.size(); i++)
+    {
+      if (this->ScalarArrays[i])
+      {
+        this->ScalarGathers[i] = vtkArrayCalculatorGetGatherFunction(this->ScalarArrays[i]);
+      }
+    }
+    this->VectorGathers.resize(this->VectorArrays.size());
+    for (size_t i = 0; i < this->VectorArrays.size(); i++)
+    {
+      if (this->VectorArrays[i])
+      {
+        this->VectorGathers[i] = vtkArrayCalculatorGetGatherFunction(this->VectorArrays[i]);
+      }
+    }
+    vtkPoints* points = nullptr;
+    if (auto psInput = vtkPointSet::SafeDownCast(this->DsInput))
+    {
+      points = psInput->GetPoints();
+    }
+    else if (this->GraphInput)
+    {
+      points = this->GraphInput->GetPoints();
+    }
+    if (points)
+    {
+      this->Coordinates = points->GetData();
+      this->CoordinatesGather = vtkArrayCalculatorGetGatherFunction(this->Coordinates);
+    }
+
     // find the maximum tuple size
     this->MaxTupleSize = 3;
     for (int i = 0; i < this->ScalarArrayNamesSize; i++)
@@ -224,7 +330,6 @@ public:
     functionParser->SetFunction(this->Function);
     functionParser->SetReplaceInvalidValues(this->ReplaceInvalidValues);
     functionParser->SetReplacementValue(this->ReplacementValue);
-
     // Tell the parser about scalar arrays
     vtkDataArray* currentArray;
     for (i = 0; i < this->ScalarArrayNamesSize; i++)
@@ -326,71 +431,143 @@ public:
     }
   }
 
+  /**
+   * Bind the rows of the block to the variables of the thread-function-parser.
+   */
+  void InitializeBlock(TFunctionParser* functionParser, Block& block)
+  {
+    const int numScalarVariables = functionParser->GetNumberOfScalarVariables();
+    const int numVectorVariables = functionParser->GetNumberOfVectorVariables();
+    int j;
+
+    block.Values.resize(static_cast<size_t>(this->ScalarArrayNamesSize +
+                          3 * this->VectorArrayNamesSize + 6) *
+      vtkArrayCalculatorBlockSize);
+    double* row = block.Values.data();
+    auto nextRow = [&row]() {
+      double* current = row;
+      row += vtkArrayCalculatorBlockSize;
+      return current;
+    };
+
+    // Variables without rows keep the values set by Initialize().
+    block.ScalarRows.assign(numScalarVariables, nullptr);
+    block.VectorRows.assign(3 * numVectorVariables, nullptr);
+    block.ScalarArrayRows.resize(this->ScalarArrayNamesSize);
+    for (j = 0; j < this->ScalarArrayNamesSize; j++)
+    {
+      block.ScalarArrayRows[j] = nextRow();
+      if (this->ScalarArrays[j] && this->ScalarArrayIndices[j] < numScalarVariables)
+      {
+        block.ScalarRows[this->ScalarArrayIndices[j]] = block.ScalarArrayRows[j];
+      }
+    }
+    block.VectorArrayRows.resize(3 * this->VectorArrayNamesSize);
+    for (j = 0; j < 3 * this->VectorArrayNamesSize; j++)
+    {
+      block.VectorArrayRows[j] = nextRow();
+      if (this->VectorArrays[j / 3] && this->VectorArrayIndices[j / 3] < numVectorVariables)
+      {
+        block.VectorRows[3 * this->VectorArrayIndices[j / 3] + j % 3] = block.VectorArrayRows[j];
+      }
+    }
+    for (int c = 0; c < 3; c++)
+    {
+      block.PointRows[c] = nextRow();
+      block.ResultRows[c] = nextRow();
+    }
+    if (this->AttributeType == vtkDataObject::POINT || this->AttributeType == vtkDataObject::VERTEX)
+    {
+      for (j = 0; j < this->CoordinateScalarVariableNamesSize &&
+           j + this->ScalarArrayNamesSize < numScalarVariables;
+           j++)
+      {
+        block.ScalarRows[j + this->ScalarArrayNamesSize] =
+          block.PointRows[this->SelectedCoordinateScalarComponents[j]];
+      }
+      for (j = 0; j < this->CoordinateVectorVariableNamesSize &&
+           j + this->VectorArrayNamesSize < numVectorVariables;
+           j++)
+      {
+        for (int c = 0; c < 3; c++)
+        {
+          block.VectorRows[3 * (j + this->VectorArrayNamesSize) + c] =
+            block.PointRows[this->SelectedCoordinateVectorComponents[j][c]];
+        }
+      }
+    }
+  }
+
   void operator()(vtkIdType begin, vtkIdType end)
   {
-    auto resultArrayItr = vtk::DataArrayTupleRange(this->ResultArray, begin, end).begin();
     auto& functionParser = this->FunctionParser.Local();
-    auto tuple = this->Tuple.Local().data();
-    vtkDataArray* currentArray;
-    int j = 0;
-
-    for (vtkIdType i = begin; i < end; i++, resultArrayItr++)
+    auto& block = this->Blocks.Local();
+    if (block.Values.empty())
+    {
+      this->InitializeBlock(functionParser, block);
+    }
+    const bool coordinates = (this->AttributeType == vtkDataObject::POINT ||
+                               this->AttributeType == vtkDataObject::VERTEX) &&
+      (this->CoordinateScalarVariableNamesSize > 0 || this->CoordinateVectorVariableNamesSize > 0);
+    const int numComponents = (resultType == SCALAR_RESULT ? 1 : 3);
+    const int xyz[3] = { 0, 1, 2 };
+    int j;
+
+    for (vtkIdType blockBegin = begin; blockBegin < end;
+         blockBegin += vtkArrayCalculatorBlockSize)
     {
+      const vtkIdType blockEnd = std::min(blockBegin + vtkArrayCalculatorBlockSize, end);
       for (j = 0; j < this->ScalarArrayNamesSize; j++)
       {
-        if ((currentArray = this->ScalarArrays[j]))
+        if (this->ScalarArrays[j])
         {
-          currentArray->GetTuple(i, tuple);
-          functionParser->SetScalarVariableValue(
-            this->ScalarArrayIndices[j], tuple[this->SelectedScalarComponents[j]]);
+          this->ScalarGathers[j](this->ScalarArrays[j], &this->SelectedScalarComponents[j], 1,
+            blockBegin, blockEnd, &block.ScalarArrayRows[j]);
         }
       }
       for (j = 0; j < this->VectorArrayNamesSize; j++)
       {
-        if ((currentArray = this->VectorArrays[j]))
+        if (this->VectorArrays[j])
         {
-          currentArray->GetTuple(i, tuple);
-          functionParser->SetVectorVariableValue(this->VectorArrayIndices[j],
-            tuple[this->SelectedVectorComponents[j][0]],
-            tuple[this->SelectedVectorComponents[j][1]],
-            tuple[this->SelectedVectorComponents[j][2]]);
+          this->VectorGathers[j](this->VectorArrays[j], this->SelectedVectorComponents[j].GetData(),
+            3, blockBegin, blockEnd, &block.VectorArrayRows[3 * j]);
         }
       }
-      if (this->AttributeType == vtkDataObject::POINT ||
-        this->AttributeType == vtkDataObject::VERTEX)
+      if (coordinates && this->Coordinates)
+      {
+        this->CoordinatesGather(this->Coordinates, xyz, 3, blockBegin, blockEnd, block.PointRows);
+      }
+      else if (coordinates)
       {
         double pt[3];
-        if (this->DsInput)
-        {
-          this->DsInput->GetPoint(i, pt);
-        }
-        else
-        {
-          this->GraphInput->GetPoint(i, pt);
-        }
-        for (j = 0; j < this->CoordinateScalarVariableNamesSize; j++)
-        {
-          functionParser->SetScalarVariableValue(
-            j + this->ScalarArrayNamesSize, pt[this->SelectedCoordinateScalarComponents[j]]);
-        }
-        for (j = 0; j < this->CoordinateVectorVariableNamesSize; j++)
+        for (vtkIdType i = blockBegin; i < blockEnd; i++)
         {
-          functionParser->SetVectorVariableValue(j + this->VectorArrayNamesSize,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
+          if (this->DsInput)
+          {
+            this->DsInput->GetPoint(i, pt);
+          }
+          else
+          {
+            this->GraphInput->GetPoint(i, pt);
+          }
+          for (int c = 0; c < 3; c++)
+          {
+            block.PointRows[c][i - blockBegin] = pt[c];
+          }
         }
       }
-      if (resultType == SCALAR_RESULT)
-      {
-        (*resultArrayItr)[0] = functionParser->GetScalarResult();
-      }
-      else
+
+      functionParser->EvaluateBatch(blockEnd - blockBegin, block.ScalarRows.data(),
+        block.VectorRows.data(), block.ResultRows);
+
+      vtkIdType k = 0;
+      for (auto tuple : vtk::DataArrayTupleRange(this->ResultArray, blockBegin, blockEnd))
       {
-        auto result = functionParser->GetVectorResult();
-        (*resultArrayItr)[0] = result[0];
-        (*resultArrayItr)[1] = result[1];
-        (*resultArrayItr)[2] = result[2];
+        for (int c = 0; c < numComponents; c++)
+        {
+          tuple[c] = block.ResultRows[c][k];
+        }
+        k++;
       }
     }
   }
@@ -15,19 +15,32 @@
 #include "vtkCleanPolyData.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkCleanPolyData);
 
@@ -47,6 +60,347 @@ bool InsertPointUsingGlobalId(vtkIdType globalId, vtkPoints* newPts,
   ptId = it->second;
   return false;
 }
+
+// Kinds of cells, in the order of the cell arrays of a polydata.
+enum CellKind
+{
+  VERT_CELLS = 0,
+  LINE_CELLS,
+  POLY_CELLS,
+  STRIP_CELLS,
+  NUMBER_OF_CELL_KINDS
+};
+const signed char REMOVED_CELL = -1;
+
+struct CellConversions
+{
+  bool LinesToPoints;
+  bool PolysToLines;
+  bool StripsToPolys;
+};
+
+// Map the points of a cell of the given kind to output points, remove the
+// repeated consecutive points, and return the kind of the cleaned cell or
+// REMOVED_CELL. pointMap is nullptr if the cell already uses output points.
+signed char CleanCell(int kind, vtkIdType npts, const vtkIdType* pts, const vtkIdType* pointMap,
+  const CellConversions& convert, vtkIdType* updatedPts, vtkIdType& numNewPts)
+{
+  numNewPts = 0;
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    const vtkIdType ptId = pointMap ? pointMap[pts[i]] : pts[i];
+    if (kind == VERT_CELLS || i == 0 || ptId != updatedPts[numNewPts - 1])
+    {
+      updatedPts[numNewPts++] = ptId;
+    }
+  }
+  if ((kind == POLY_CELLS && numNewPts > 2 && updatedPts[0] == updatedPts[numNewPts - 1]) ||
+    (kind == STRIP_CELLS && numNewPts > 1 && updatedPts[0] == updatedPts[numNewPts - 1]))
+  {
+    numNewPts--;
+  }
+
+  // Cells that keep their kind, then degenerate cells converted to a
+  // lower kind if the user asked for it, unless they were of this kind to
+  // begin with.
+  if ((kind == VERT_CELLS && numNewPts > 0) || (kind == LINE_CELLS && numNewPts >= 2) ||
+    (kind == POLY_CELLS && numNewPts > 2) || (kind == STRIP_CELLS && numNewPts > 3))
+  {
+    return static_cast<signed char>(kind);
+  }
+  if (kind == STRIP_CELLS && numNewPts == 3 && (npts == numNewPts || convert.StripsToPolys))
+  {
+    return POLY_CELLS;
+  }
+  if (kind >= POLY_CELLS && numNewPts == 2 && (npts == numNewPts || convert.PolysToLines))
+  {
+    return LINE_CELLS;
+  }
+  if (kind >= LINE_CELLS && numNewPts == 1 && (npts == numNewPts || convert.LinesToPoints))
+  {
+    return VERT_CELLS;
+  }
+  return REMOVED_CELL;
+}
+
+// Clean the cells of the input cell arrays and set them in the output with
+// their cell data. The cleaned cells of each kind are in the order of the
+// input cells, whatever their input kind, like the cells output by a serial
+// traversal of the input cells. The cells are cleaned and rewritten with
+// vtkSMPTools.
+void CleanCells(const vtkSmartPointer<vtkCellArray> inCells[NUMBER_OF_CELL_KINDS],
+  const vtkIdType* pointMap, const CellConversions& convert, vtkCellData* inputCD,
+  vtkPolyData* output)
+{
+  // Kind and size of the cleaned cells.
+  std::vector<signed char> kinds[NUMBER_OF_CELL_KINDS];
+  std::vector<vtkIdType> sizes[NUMBER_OF_CELL_KINDS];
+  for (int kind = 0; kind < NUMBER_OF_CELL_KINDS; ++kind)
+  {
+    vtkCellArray* cells = inCells[kind];
+    const vtkIdType numCells = cells->GetNumberOfCells();
+    kinds[kind].resize(numCells);
+    sizes[kind].resize(numCells);
+    vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+      auto iter = vtk::TakeSmartPointer(cells->NewIterator());
+      std::vector<vtkIdType> updatedPts;
+      vtkIdType npts;
+      const vtkIdType* pts;
+      for (; cellId < endCellId; ++cellId)
+      {
+        iter->GetCellAtId(cellId, npts, pts);
+        updatedPts.resize(std::max<size_t>(updatedPts.size(), npts));
+        kinds[kind][cellId] =
+          CleanCell(kind, npts, pts, pointMap, convert, updatedPts.data(), sizes[kind][cellId]);
+      }
+    });
+  }
+
+  // Number the cleaned cells of each kind in the order of the input cells,
+  // and compute their offsets.
+  std::vector<vtkIdType> newCellIds[NUMBER_OF_CELL_KINDS];
+  std::vector<vtkIdType> offsets[NUMBER_OF_CELL_KINDS];
+  for (int kind = 0; kind < NUMBER_OF_CELL_KINDS; ++kind)
+  {
+    offsets[kind].push_back(0);
+  }
+  for (int kind = 0; kind < NUMBER_OF_CELL_KINDS; ++kind)
+  {
+    const vtkIdType numCells = static_cast<vtkIdType>(kinds[kind].size());
+    newCellIds[kind].resize(numCells);
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      const signed char newKind = kinds[kind][cellId];
+      if (newKind != REMOVED_CELL)
+      {
+        newCellIds[kind][cellId] = static_cast<vtkIdType>(offsets[newKind].size()) - 1;
+        offsets[newKind].push_back(offsets[newKind].back() + sizes[kind][cellId]);
+      }
+    }
+  }
+
+  // Write the cleaned cells.
+  vtkSmartPointer<vtkIdTypeArray> newOffsets[NUMBER_OF_CELL_KINDS];
+  vtkSmartPointer<vtkIdTypeArray> newConnectivity[NUMBER_OF_CELL_KINDS];
+  vtkIdType newCellIdOffsets[NUMBER_OF_CELL_KINDS + 1] = { 0 };
+  for (int kind = 0; kind < NUMBER_OF_CELL_KINDS; ++kind)
+  {
+    newOffsets[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    newOffsets[kind]->SetNumberOfValues(static_cast<vtkIdType>(offsets[kind].size()));
+    std::copy(offsets[kind].begin(), offsets[kind].end(), newOffsets[kind]->GetPointer(0));
+    newConnectivity[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    newConnectivity[kind]->SetNumberOfValues(offsets[kind].back());
+    newCellIdOffsets[kind + 1] =
+      newCellIdOffsets[kind] + static_cast<vtkIdType>(offsets[kind].size()) - 1;
+  }
+  vtkIdType inCellIdOffset = 0;
+  vtkNew<vtkIdList> inCellIds;
+  inCellIds->SetNumberOfIds(newCellIdOffsets[NUMBER_OF_CELL_KINDS]);
+  for (int kind = 0; kind < NUMBER_OF_CELL_KINDS; ++kind)
+  {
+    vtkCellArray* cells = inCells[kind];
+    vtkSMPTools::For(0, cells->GetNumberOfCells(), [&](vtkIdType cellId, vtkIdType endCellId) {
+      auto iter = vtk::TakeSmartPointer(cells->NewIterator());
+      std::vector<vtkIdType> updatedPts;
+      vtkIdType npts, numNewPts;
+      const vtkIdType* pts;
+      for (; cellId < endCellId; ++cellId)
+      {
+        const signed char newKind = kinds[kind][cellId];
+        if (newKind == REMOVED_CELL)
+        {
+          continue;
+        }
+        const vtkIdType newCellId = newCellIds[kind][cellId];
+        iter->GetCellAtId(cellId, npts, pts);
+        updatedPts.resize(std::max<size_t>(updatedPts.size(), npts));
+        CleanCell(kind, npts, pts, pointMap, convert, updatedPts.data(), numNewPts);
+        std::copy(updatedPts.begin(), updatedPts.begin() + numNewPts,
+          newConnectivity[newKind]->GetPointer(offsets[newKind][newCellId]));
+        // The cell data of the output cells is in the order of their kinds.
+        inCellIds->SetId(newCellIdOffsets[newKind] + newCellId, inCellIdOffset + cellId);
+      }
+    });
+    inCellIdOffset += cells->GetNumberOfCells();
+  }
+
+  for (int kind = 0; kind < NUMBER_OF_CELL_KINDS; ++kind)
+  {
+    if (inCells[kind]->GetNumberOfCells() == 0 && newOffsets[kind]->GetNumberOfValues() == 1)
+    {
+      continue;
+    }
+    vtkNew<vtkCellArray> newCells;
+    newCells->SetData(newOffsets[kind], newConnectivity[kind]);
+    switch (kind)
+    {
+      case VERT_CELLS:
+        output->SetVerts(newCells);
+        break;
+      case LINE_CELLS:
+        output->SetLines(newCells);
+        break;
+      case POLY_CELLS:
+        output->SetPolys(newCells);
+        break;
+      default:
+        output->SetStrips(newCells);
+        break;
+    }
+  }
+
+  vtkCellData* outputCD = output->GetCellData();
+  outputCD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
+  outputCD->CopyAllocate(inputCD, newCellIdOffsets[NUMBER_OF_CELL_KINDS]);
+  outputCD->CopyData(inputCD, inCellIds);
+}
+
+// Key ordering points by their exact coordinates, then by their first use.
+// The coordinates are mapped to integers that sort like them, with -0.0 and
+// 0.0 mapped to the same integer.
+struct CoincidentPointKey
+{
+  uint64_t Coords[3];
+  vtkIdType Order;
+
+  bool operator<(const CoincidentPointKey& other) const
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      if (this->Coords[i] != other.Coords[i])
+      {
+        return this->Coords[i] < other.Coords[i];
+      }
+    }
+    return this->Order < other.Order;
+  }
+  bool IsCoincident(const CoincidentPointKey& other) const
+  {
+    return this->Coords[0] == other.Coords[0] && this->Coords[1] == other.Coords[1] &&
+      this->Coords[2] == other.Coords[2];
+  }
+};
+
+uint64_t SortableCoordinate(double x)
+{
+  x += 0.0;
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return (bits >> 63) ? ~bits : (bits | (static_cast<uint64_t>(1) << 63));
+}
+
+// Merge each used point, given in the order of first use, to the first used
+// point with the same coordinates. The points are sorted with vtkSMPTools.
+void MergeCoincidentPoints(
+  vtkPoints* points, const std::vector<vtkIdType>& usedPts, std::vector<vtkIdType>& mergedOrder)
+{
+  const vtkIdType numUsedPts = static_cast<vtkIdType>(usedPts.size());
+  std::vector<CoincidentPointKey> keys(numUsedPts);
+  vtkSMPTools::For(0, numUsedPts, [&](vtkIdType order, vtkIdType endOrder) {
+    double x[3];
+    for (; order < endOrder; ++order)
+    {
+      points->GetPoint(usedPts[order], x);
+      for (int i = 0; i < 3; ++i)
+      {
+        keys[order].Coords[i] = SortableCoordinate(x[i]);
+      }
+      keys[order].Order = order;
+    }
+  });
+  vtkSMPTools::Sort(keys.begin(), keys.end());
+
+  mergedOrder.resize(numUsedPts);
+  vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdType first = begin;
+    while (first > 0 && keys[first - 1].IsCoincident(keys[begin]))
+    {
+      --first;
+    }
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (!keys[i].IsCoincident(keys[first]))
+      {
+        first = i;
+      }
+      mergedOrder[keys[i].Order] = keys[first].Order;
+    }
+  });
+}
+
+// Merge each used point, given in the order of first use, to the closest
+// point within the tolerance that is used before it and not merged itself,
+// the first used one in case of ties. The used points are binned with a
+// vtkStaticPointLocator and their earlier neighbors within the tolerance are
+// gathered with vtkSMPTools, one block of points at a time; the merge itself
+// is then resolved in the order of first use.
+void MergePointsWithinTolerance(vtkPoints* points, const std::vector<vtkIdType>& usedPts,
+  double tol, std::vector<vtkIdType>& mergedOrder)
+{
+  const vtkIdType numUsedPts = static_cast<vtkIdType>(usedPts.size());
+  vtkNew<vtkPoints> orderedPts;
+  orderedPts->SetDataTypeToDouble();
+  orderedPts->SetNumberOfPoints(numUsedPts);
+  vtkSMPTools::For(0, numUsedPts, [&](vtkIdType order, vtkIdType endOrder) {
+    double x[3];
+    for (; order < endOrder; ++order)
+    {
+      points->GetPoint(usedPts[order], x);
+      orderedPts->SetPoint(order, x);
+    }
+  });
+  vtkNew<vtkPolyData> orderedData;
+  orderedData->SetPoints(orderedPts);
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(orderedData);
+  locator->BuildLocator();
+
+  // Earlier neighbors of a point within the tolerance, closest first.
+  using Neighbor = std::pair<double, vtkIdType>;
+  const vtkIdType blockSize = 65536;
+  std::vector<std::vector<Neighbor>> neighbors(std::min(blockSize, numUsedPts));
+  vtkSMPThreadLocalObject<vtkIdList> tlIds;
+
+  mergedOrder.resize(numUsedPts);
+  for (vtkIdType blockBegin = 0; blockBegin < numUsedPts; blockBegin += blockSize)
+  {
+    const vtkIdType blockEnd = std::min(blockBegin + blockSize, numUsedPts);
+    vtkSMPTools::For(blockBegin, blockEnd, [&](vtkIdType order, vtkIdType endOrder) {
+      vtkIdList* ids = tlIds.Local();
+      double x[3], y[3];
+      for (; order < endOrder; ++order)
+      {
+        std::vector<Neighbor>& near = neighbors[order - blockBegin];
+        near.clear();
+        orderedPts->GetPoint(order, x);
+        locator->FindPointsWithinRadius(tol, x, ids);
+        for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+        {
+          const vtkIdType other = ids->GetId(i);
+          if (other < order)
+          {
+            orderedPts->GetPoint(other, y);
+            near.emplace_back(vtkMath::Distance2BetweenPoints(x, y), other);
+          }
+        }
+        std::sort(near.begin(), near.end());
+      }
+    });
+
+    for (vtkIdType order = blockBegin; order < blockEnd; ++order)
+    {
+      mergedOrder[order] = order;
+      for (const Neighbor& neighbor : neighbors[order - blockBegin])
+      {
+        if (mergedOrder[neighbor.second] == neighbor.second)
+        {
+          mergedOrder[order] = neighbor.second;
+          break;
+        }
+      }
+    }
+  }
+}
 } // anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -151,10 +505,7 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
     vtkDebugMacro(<< "No data to Operate On!");
     return 1;
   }
-  vtkIdType* updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
-  vtkIdType numNewPts;
-  vtkIdType numUsedPts = 0;
   vtkPoints* newPts = inPts->NewInstance();
 
   // Set the desired precision for the points in the output.
@@ -171,480 +522,196 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
     newPts->SetDataType(VTK_DOUBLE);
   }
 
-  newPts->Allocate(numPts);
-
   // we'll be needing these
-  vtkIdType inCellID, newId;
-  vtkIdType i;
   vtkIdType ptId = 0;
   vtkIdType npts = 0;
   const vtkIdType* pts = nullptr;
   double x[3];
   double newx[3];
-  vtkIdType* pointMap = nullptr; // used if no merging
-
-  vtkCellArray *inVerts = input->GetVerts(), *newVerts = nullptr;
-  vtkCellArray *inLines = input->GetLines(), *newLines = nullptr;
-  vtkCellArray *inPolys = input->GetPolys(), *newPolys = nullptr;
-  vtkCellArray *inStrips = input->GetStrips(), *newStrips = nullptr;
 
+  vtkCellArray* inCells[NUMBER_OF_CELL_KINDS] = { input->GetVerts(), input->GetLines(),
+    input->GetPolys(), input->GetStrips() };
   vtkPointData* inputPD = input->GetPointData();
   vtkCellData* inputCD = input->GetCellData();
 
-  // We must be careful to 'operate' on the bounds of the locator so
-  // that all inserted points lie inside it
-  if (this->PointMerging)
-  {
-    this->CreateDefaultLocator(input);
-    if (this->ToleranceIsAbsolute)
-    {
-      this->Locator->SetTolerance(this->AbsoluteTolerance);
-    }
-    else
-    {
-      this->Locator->SetTolerance(this->Tolerance * input->GetLength());
-    }
-    double originalbounds[6], mappedbounds[6];
-    input->GetBounds(originalbounds);
-    this->OperateOnBounds(originalbounds, mappedbounds);
-    this->Locator->InitPointInsertion(newPts, mappedbounds);
-  }
-  else
-  {
-    pointMap = new vtkIdType[numPts];
-    for (i = 0; i < numPts; ++i)
-    {
-      pointMap[i] = -1; // initialize unused
-    }
-  }
-
-  std::unordered_map<vtkIdType, vtkIdType> addedGlobalIdsMap;
   vtkIdTypeArray* globalIdsArray = vtkIdTypeArray::SafeDownCast(inputPD->GetGlobalIds());
 
   vtkPointData* outputPD = output->GetPointData();
-  vtkCellData* outputCD = output->GetCellData();
   // Since paraview/paraview#19961, global point ids can be used for the merging
   // decision. In this case, they can be merged.
   if (!this->PointMerging || (this->PointMerging && globalIdsArray))
   {
     outputPD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
   }
-  outputPD->CopyAllocate(inputPD);
-  outputCD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
-  outputCD->CopyAllocate(inputCD);
-
-  // Celldata needs to be copied correctly. If a poly is converted to
-  // a line, or a line to a point, then using a CellCounter will not
-  // do, as the cells should be ordered verts, lines, polys,
-  // strips. We need to maintain separate cell data lists so we can
-  // copy them all correctly. Tedious but easy to implement. We can
-  // use outputCD for vertex cell data, then add the rest at the end.
-  vtkCellData* outLineData = nullptr;
-  vtkCellData* outPolyData = nullptr;
-  vtkCellData* outStrpData = nullptr;
-  vtkIdType vertIDcounter = 0, lineIDcounter = 0;
-  vtkIdType polyIDcounter = 0, strpIDcounter = 0;
-
-  // Begin to adjust topology.
-  //
-  // Vertices are renumbered and we remove duplicates
-  inCellID = 0;
-  if (!this->GetAbortExecute() && inVerts->GetNumberOfCells() > 0)
-  {
-    newVerts = vtkCellArray::New();
-    newVerts->AllocateEstimate(inVerts->GetNumberOfCells(), 1);
-
-    vtkDebugMacro(<< "Starting Verts " << inCellID);
-    for (inVerts->InitTraversal(); inVerts->GetNextCell(npts, pts); inCellID++)
-    {
-      for (numNewPts = 0, i = 0; i < npts; ++i)
-      {
-        inPts->GetPoint(pts[i], x);
-        this->OperateOnPoint(x, newx);
-        if (!this->PointMerging)
-        {
-          if ((ptId = pointMap[pts[i]]) == -1)
-          {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId, newx);
-            outputPD->CopyData(inputPD, pts[i], ptId);
-          }
-        }
-        else if ((globalIdsArray &&
-                   InsertPointUsingGlobalId(
-                     globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
-        {
-          outputPD->CopyData(inputPD, pts[i], ptId);
-        }
-        updatedPts[numNewPts++] = ptId;
-      } // for all points of vertex cell
 
-      if (numNewPts > 0)
-      {
-        newId = newVerts->InsertNextCell(numNewPts, updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if (vertIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Vertex ID fault in vertex test");
-        }
-        vertIDcounter++;
-      }
-    }
-  }
-  this->UpdateProgress(0.25);
+  // The cells with their points mapped to the output points, either through
+  // pointMap or directly in their connectivity.
+  vtkSmartPointer<vtkCellArray> mappedCells[NUMBER_OF_CELL_KINDS];
+  std::vector<vtkIdType> pointMap;
 
-  // lines reduced to one point are eliminated or made into verts
-  if (!this->GetAbortExecute() && inLines->GetNumberOfCells() > 0)
+  if (this->PointMerging && (this->Locator != nullptr || globalIdsArray))
   {
-    newLines = vtkCellArray::New();
-    newLines->AllocateEstimate(inLines->GetNumberOfCells(), 2);
-    outLineData = vtkCellData::New();
-    outLineData->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
-    outLineData->CopyAllocate(inputCD);
+    // The points are inserted one at a time, in the order of the cells, in
+    // the locator given by the user or by global id.
     //
-    vtkDebugMacro(<< "Starting Lines " << inCellID);
-    for (inLines->InitTraversal(); inLines->GetNextCell(npts, pts); inCellID++)
+    // We must be careful to 'operate' on the bounds of the locator so
+    // that all inserted points lie inside it
+    if (!globalIdsArray)
     {
-      for (numNewPts = 0, i = 0; i < npts; i++)
+      this->CreateDefaultLocator(input);
+      if (this->ToleranceIsAbsolute)
       {
-        inPts->GetPoint(pts[i], x);
-        this->OperateOnPoint(x, newx);
-        if (!this->PointMerging)
-        {
-          if ((ptId = pointMap[pts[i]]) == -1)
-          {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId, newx);
-            outputPD->CopyData(inputPD, pts[i], ptId);
-          }
-        }
-        else if ((globalIdsArray &&
-                   InsertPointUsingGlobalId(
-                     globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
-        {
-          outputPD->CopyData(inputPD, pts[i], ptId);
-        }
-        if (i == 0 || ptId != updatedPts[numNewPts - 1])
-        {
-          updatedPts[numNewPts++] = ptId;
-        }
-      } // for all cell points
-
-      if (numNewPts >= 2)
-      {
-        // Cell is a proper line or polyline, always add
-        newId = newLines->InsertNextCell(numNewPts, updatedPts);
-        outLineData->CopyData(inputCD, inCellID, newId);
-        if (lineIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Line ID fault in line test");
-        }
-        lineIDcounter++;
+        this->Locator->SetTolerance(this->AbsoluteTolerance);
       }
-      else if (numNewPts == 1 && (npts == numNewPts || this->ConvertLinesToPoints))
+      else
       {
-        // Cell was either a vertex to begin with and we didn't modify it or a degenerated line and
-        // the user wanted it included as a vertex
-        if (!newVerts)
-        {
-          newVerts = vtkCellArray::New();
-          newVerts->AllocateEstimate(5, 1);
-        }
-        newId = newVerts->InsertNextCell(numNewPts, updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if (vertIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Vertex ID fault in line test");
-        }
-        vertIDcounter++;
+        this->Locator->SetTolerance(this->Tolerance * input->GetLength());
       }
+      double originalbounds[6], mappedbounds[6];
+      input->GetBounds(originalbounds);
+      this->OperateOnBounds(originalbounds, mappedbounds);
+      newPts->Allocate(numPts);
+      this->Locator->InitPointInsertion(newPts, mappedbounds);
     }
-    vtkDebugMacro(<< "Removed " << inLines->GetNumberOfCells() - newLines->GetNumberOfCells()
-                  << " lines");
-  }
-  this->UpdateProgress(0.50);
-
-  // polygons reduced to two points or less are either eliminated
-  // or converted to lines or points if enabled
-  if (!this->GetAbortExecute() && inPolys->GetNumberOfCells() > 0)
-  {
-    newPolys = vtkCellArray::New();
-    newPolys->AllocateExact(inPolys->GetNumberOfCells(), inPolys->GetNumberOfConnectivityIds());
-    outPolyData = vtkCellData::New();
-    outPolyData->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
-    outPolyData->CopyAllocate(inputCD);
+    outputPD->CopyAllocate(inputPD);
 
-    vtkDebugMacro(<< "Starting Polys " << inCellID);
-    for (inPolys->InitTraversal(); inPolys->GetNextCell(npts, pts); inCellID++)
+    std::unordered_map<vtkIdType, vtkIdType> addedGlobalIdsMap;
+    std::vector<vtkIdType> updatedPts;
+    for (int kind = 0; kind < NUMBER_OF_CELL_KINDS && !this->GetAbortExecute(); ++kind)
     {
-      for (numNewPts = 0, i = 0; i < npts; i++)
+      mappedCells[kind] = vtkSmartPointer<vtkCellArray>::New();
+      mappedCells[kind]->AllocateExact(
+        inCells[kind]->GetNumberOfCells(), inCells[kind]->GetNumberOfConnectivityIds());
+      auto iter = vtk::TakeSmartPointer(inCells[kind]->NewIterator());
+      for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
       {
-        inPts->GetPoint(pts[i], x);
-        this->OperateOnPoint(x, newx);
-        if (!this->PointMerging)
+        iter->GetCurrentCell(npts, pts);
+        updatedPts.resize(std::max<size_t>(updatedPts.size(), npts));
+        for (vtkIdType i = 0; i < npts; ++i)
         {
-          if ((ptId = pointMap[pts[i]]) == -1)
+          inPts->GetPoint(pts[i], x);
+          this->OperateOnPoint(x, newx);
+          if ((globalIdsArray &&
+                InsertPointUsingGlobalId(
+                  globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
+            (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
           {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId, newx);
             outputPD->CopyData(inputPD, pts[i], ptId);
           }
+          updatedPts[i] = ptId;
         }
-        else if ((globalIdsArray &&
-                   InsertPointUsingGlobalId(
-                     globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
-        {
-          outputPD->CopyData(inputPD, pts[i], ptId);
-        }
-        if (i == 0 || ptId != updatedPts[numNewPts - 1])
-        {
-          updatedPts[numNewPts++] = ptId;
-        }
-      } // for points in cell
-      if (numNewPts > 2 && updatedPts[0] == updatedPts[numNewPts - 1])
-      {
-        numNewPts--;
-      }
-      if (numNewPts > 2)
-      {
-        // Cell is a proper polygon, always add
-        newId = newPolys->InsertNextCell(numNewPts, updatedPts);
-        outPolyData->CopyData(inputCD, inCellID, newId);
-        if (polyIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Poly ID fault in poly test");
-        }
-        polyIDcounter++;
-      }
-      else if (numNewPts == 2 && (npts == numNewPts || this->ConvertPolysToLines))
-      {
-        // Cell was either a line to begin with and we didn't modify it or a degenerated poly and
-        // the user wanted it included as a line
-        if (!newLines)
-        {
-          newLines = vtkCellArray::New();
-          newLines->AllocateEstimate(5, 2);
-          outLineData = vtkCellData::New();
-          outLineData->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
-          outLineData->CopyAllocate(inputCD);
-        }
-        newId = newLines->InsertNextCell(numNewPts, updatedPts);
-        outLineData->CopyData(inputCD, inCellID, newId);
-        if (lineIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Line ID fault in poly test");
-        }
-        lineIDcounter++;
-      }
-      else if (numNewPts == 1 && (npts == numNewPts || this->ConvertLinesToPoints))
-      {
-        // Cell was either a vertex to begin with and we didn't modify it or a degenerated line and
-        // the user wanted it included as a vertex
-        if (!newVerts)
-        {
-          newVerts = vtkCellArray::New();
-          newVerts->AllocateEstimate(5, 1);
-        }
-        newId = newVerts->InsertNextCell(numNewPts, updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if (vertIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Vertex ID fault in poly test");
-        }
-        vertIDcounter++;
+        mappedCells[kind]->InsertNextCell(npts, updatedPts.data());
       }
+      this->UpdateProgress(0.125 * (kind + 1));
+    }
+    if (!globalIdsArray)
+    {
+      this->Locator->Initialize(); // release memory.
     }
-    vtkDebugMacro(<< "Removed " << inPolys->GetNumberOfCells() - newPolys->GetNumberOfCells()
-                  << " polys");
   }
-  this->UpdateProgress(0.75);
-
-  // triangle strips can reduced to polys/lines/points etc
-  if (!this->GetAbortExecute() && inStrips->GetNumberOfCells() > 0)
+  else
   {
-    newStrips = vtkCellArray::New();
-    newStrips->AllocateExact(inStrips->GetNumberOfCells(), inStrips->GetNumberOfConnectivityIds());
-    outStrpData = vtkCellData::New();
-    outStrpData->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
-    outStrpData->CopyAllocate(inputCD);
+    // The points are numbered in the order of their first use by the cells,
+    // as if they were inserted one at a time in a locator.
+    std::copy(inCells, inCells + NUMBER_OF_CELL_KINDS, mappedCells);
+
+    vtkNew<vtkPoints> operatedPts;
+    operatedPts->SetDataType(newPts->GetDataType());
+    operatedPts->SetNumberOfPoints(numPts);
+    for (ptId = 0; ptId < numPts; ++ptId)
+    {
+      inPts->GetPoint(ptId, x);
+      this->OperateOnPoint(x, newx);
+      operatedPts->SetPoint(ptId, newx);
+    }
 
-    for (inStrips->InitTraversal(); inStrips->GetNextCell(npts, pts); inCellID++)
+    // Points used by the cells, in the order of their first use.
+    std::vector<bool> isUsed(numPts, false);
+    std::vector<vtkIdType> usedPts;
+    for (int kind = 0; kind < NUMBER_OF_CELL_KINDS; ++kind)
     {
-      for (numNewPts = 0, i = 0; i < npts; i++)
+      auto iter = vtk::TakeSmartPointer(inCells[kind]->NewIterator());
+      for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
       {
-        inPts->GetPoint(pts[i], x);
-        this->OperateOnPoint(x, newx);
-        if (!this->PointMerging)
+        iter->GetCurrentCell(npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i)
         {
-          if ((ptId = pointMap[pts[i]]) == -1)
+          if (!isUsed[pts[i]])
           {
-            pointMap[pts[i]] = ptId = numUsedPts++;
-            newPts->SetPoint(ptId, newx);
-            outputPD->CopyData(inputPD, pts[i], ptId);
+            isUsed[pts[i]] = true;
+            usedPts.push_back(pts[i]);
           }
         }
-        else if ((globalIdsArray &&
-                   InsertPointUsingGlobalId(
-                     globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
-        {
-          outputPD->CopyData(inputPD, pts[i], ptId);
-        }
-        if (i == 0 || ptId != updatedPts[numNewPts - 1])
-        {
-          updatedPts[numNewPts++] = ptId;
-        }
       }
-      if (numNewPts > 1 && updatedPts[0] == updatedPts[numNewPts - 1])
+    }
+    const vtkIdType numUsedPts = static_cast<vtkIdType>(usedPts.size());
+    this->UpdateProgress(0.25);
+
+    // First use of the point each used point is merged to, the point itself
+    // if it is not merged.
+    std::vector<vtkIdType> mergedOrder;
+    if (this->PointMerging && !this->GetAbortExecute())
+    {
+      const double tol = this->ToleranceIsAbsolute ? this->AbsoluteTolerance
+                                                   : this->Tolerance * input->GetLength();
+      if (tol == 0.0)
       {
-        numNewPts--;
+        MergeCoincidentPoints(operatedPts, usedPts, mergedOrder);
       }
-      if (numNewPts > 3)
+      else
       {
-        // Cell is a proper triangle strip, always add
-        newId = newStrips->InsertNextCell(numNewPts, updatedPts);
-        outStrpData->CopyData(inputCD, inCellID, newId);
-        if (strpIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Strip ID fault in strip test");
-        }
-        strpIDcounter++;
+        MergePointsWithinTolerance(operatedPts, usedPts, tol, mergedOrder);
       }
-      else if (numNewPts == 3 && (npts == numNewPts || this->ConvertStripsToPolys))
+    }
+
+    // Number the output points in the order of the first use of the points
+    // they merge, and copy the point and its data from this first point.
+    std::vector<vtkIdType> newPtIds(numUsedPts);
+    vtkNew<vtkIdList> sourceIds;
+    for (vtkIdType order = 0; order < numUsedPts; ++order)
+    {
+      const vtkIdType mergedTo = mergedOrder.empty() ? order : mergedOrder[order];
+      if (mergedTo == order)
       {
-        // Cell was either a triangle to begin with and we didn't modify it or a degenerated
-        // triangle strip and the user wanted it included as a polygon
-        if (!newPolys)
-        {
-          newPolys = vtkCellArray::New();
-          newPolys->AllocateEstimate(5, 3);
-          outPolyData = vtkCellData::New();
-          outPolyData->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
-          outPolyData->CopyAllocate(inputCD);
-        }
-        newId = newPolys->InsertNextCell(numNewPts, updatedPts);
-        outPolyData->CopyData(inputCD, inCellID, newId);
-        if (polyIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Poly ID fault in strip test");
-        }
-        polyIDcounter++;
+        newPtIds[order] = sourceIds->GetNumberOfIds();
+        sourceIds->InsertNextId(usedPts[order]);
       }
-      else if (numNewPts == 2 && (npts == numNewPts || this->ConvertPolysToLines))
+      else
       {
-        // Cell was either a line to begin with and we didn't modify it or a degenerated triangle
-        // strip and the user wanted it included as a line
-        if (!newLines)
-        {
-          newLines = vtkCellArray::New();
-          newLines->AllocateEstimate(5, 2);
-          outLineData = vtkCellData::New();
-          outLineData->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
-          outLineData->CopyAllocate(inputCD);
-        }
-        newId = newLines->InsertNextCell(numNewPts, updatedPts);
-        outLineData->CopyData(inputCD, inCellID, newId);
-        if (lineIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Line ID fault in strip test");
-        }
-        lineIDcounter++;
+        newPtIds[order] = newPtIds[mergedTo];
       }
-      else if (numNewPts == 1 && (npts == numNewPts || this->ConvertLinesToPoints))
+    }
+    pointMap.resize(numPts, -1);
+    vtkSMPTools::For(0, numUsedPts, [&](vtkIdType order, vtkIdType endOrder) {
+      for (; order < endOrder; ++order)
       {
-        // Cell was either a vertex to begin with and we didn't modify it or a degenerated triangle
-        // strip and the user wanted it included as a vertex
-        if (!newVerts)
-        {
-          newVerts = vtkCellArray::New();
-          newVerts->AllocateEstimate(5, 1);
-        }
-        newId = newVerts->InsertNextCell(numNewPts, updatedPts);
-        outputCD->CopyData(inputCD, inCellID, newId);
-        if (vertIDcounter != newId)
-        {
-          vtkErrorMacro(<< "Vertex ID fault in strip test");
-        }
-        vertIDcounter++;
+        pointMap[usedPts[order]] = newPtIds[order];
       }
-    }
-    vtkDebugMacro(<< "Removed " << inStrips->GetNumberOfCells() - newStrips->GetNumberOfCells()
-                  << " strips");
-  }
-
-  vtkDebugMacro(<< "Removed " << numPts - newPts->GetNumberOfPoints() << " points");
+    });
 
-  // Update ourselves and release memory
-  //
-  delete[] updatedPts;
-  if (this->PointMerging)
-  {
-    this->Locator->Initialize(); // release memory.
-  }
-  else
-  {
-    newPts->SetNumberOfPoints(numUsedPts);
-    delete[] pointMap;
+    newPts->SetNumberOfPoints(sourceIds->GetNumberOfIds());
+    newPts->GetData()->InsertTuplesStartingAt(0, sourceIds, operatedPts->GetData());
+    outputPD->CopyAllocate(inputPD, sourceIds->GetNumberOfIds());
+    outputPD->CopyData(inputPD, sourceIds);
   }
+  this->UpdateProgress(0.5);
 
-  // Now transfer all CellData from Lines/Polys/Strips into final
-  // Cell data output
-  vtkIdType combinedCellID = vertIDcounter;
-  if (newLines)
+  // Begin to adjust topology: renumber the cells, remove the duplicate
+  // points, and eliminate or convert the degenerate cells.
+  if (!this->GetAbortExecute())
   {
-    for (i = 0; i < lineIDcounter; ++i, ++combinedCellID)
-    {
-      outputCD->CopyData(outLineData, i, combinedCellID);
-    }
-    outLineData->Delete();
-  }
-  if (newPolys)
-  {
-    for (i = 0; i < polyIDcounter; ++i, ++combinedCellID)
-    {
-      outputCD->CopyData(outPolyData, i, combinedCellID);
-    }
-    outPolyData->Delete();
-  }
-  if (newStrips)
-  {
-    for (i = 0; i < strpIDcounter; ++i, ++combinedCellID)
-    {
-      outputCD->CopyData(outStrpData, i, combinedCellID);
-    }
-    outStrpData->Delete();
+    CellConversions convert;
+    convert.LinesToPoints = this->ConvertLinesToPoints != 0;
+    convert.PolysToLines = this->ConvertPolysToLines != 0;
+    convert.StripsToPolys = this->ConvertStripsToPolys != 0;
+    CleanCells(mappedCells, pointMap.empty() ? nullptr : pointMap.data(), convert, inputCD, output);
   }
 
+  vtkDebugMacro(<< "Removed " << numPts - newPts->GetNumberOfPoints() << " points");
+
   output->SetPoints(newPts);
   newPts->Squeeze();
   newPts->Delete();
-  if (newVerts)
-  {
-    newVerts->Squeeze();
-    output->SetVerts(newVerts);
-    newVerts->Delete();
-  }
-  if (newLines)
-  {
-    newLines->Squeeze();
-    output->SetLines(newLines);
-    newLines->Delete();
-  }
-  if (newPolys)
-  {
-    newPolys->Squeeze();
-    output->SetPolys(newPolys);
-    newPolys->Delete();
-  }
-  if (newStrips)
-  {
-    newStrips->Squeeze();
-    output->SetStrips(newStrips);
-    newStrips->Delete();
-  }
 
   return 1;
 }
@@ -39,10 +39,16 @@
  * ConvertLinesToPoints is on and all points are merged into one. Degenerate line
  * segments (with two identical end points) will be removed.
  *
- * If tolerance is specified precisely=0.0, then vtkCleanPolyData will use
- * the vtkMergePoints object to merge points (which is faster). Otherwise the
- * slower vtkIncrementalPointLocator is used.  Before inserting points into the point
- * locator, this class calls a function OperateOnPoint which can be used (in
+ * Unless a locator is specified, points are merged with vtkSMPTools. If
+ * tolerance is specified precisely=0.0, exactly coincident points are merged
+ * by sorting them (which is faster). Otherwise the points are binned with a
+ * vtkStaticPointLocator, and each point is merged to the closest point within
+ * the tolerance that is used before it by the cells and not merged itself.
+ * The output points are numbered in the order of their first use, as if they
+ * were inserted one at a time in a locator, so the output does not depend on
+ * the number of threads. If a vtkIncrementalPointLocator is specified, the
+ * points are inserted in it one at a time instead. Before merging points,
+ * this class calls a function OperateOnPoint which can be used (in
  * subclasses) to further refine the cleaning process. See
  * vtkQuantizePolyDataPoints.
  *
@@ -163,7 +169,8 @@ public:
   ///@{
   /**
    * Set/Get a spatial locator for speeding the search process. By
-   * default an instance of vtkMergePoints is used.
+   * default no locator is used and points are merged in parallel; if a
+   * locator is set, points are inserted in it one at a time.
    */
   virtual void SetLocator(vtkIncrementalPointLocator* locator);
   vtkGetObjectMacro(Locator, vtkIncrementalPointLocator);
@@ -0,0 +1,695 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegionsInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConnectedRegionsInternal
+ * @brief   parallel labelling and extraction of connected cell regions
+ *
+ * vtkConnectedRegionsInternal labels the regions of cells connected through
+ * shared points with a lock-free union-find run by vtkSMPTools, and extracts
+ * selected cells with their points and attributes. It reproduces the regions
+ * of the wave propagation the connectivity filters used to perform: regions
+ * are numbered in the order of their first cell, and a cell that does not
+ * satisfy the connectivity criterion only joins a region as its seed.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter
+ */
+
+#ifndef vtkConnectedRegionsInternal_h
+#define vtkConnectedRegionsInternal_h
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+inline void AtomicMin(std::atomic<vtkIdType>& target, vtkIdType value)
+{
+  vtkIdType current = target.load();
+  while (value < current && !target.compare_exchange_weak(current, value))
+  {
+  }
+}
+
+//========================= REGION LABELLING ==================================
+class ConnectedRegions
+{
+public:
+  ConnectedRegions(vtkDataSet* input)
+    : Input(input)
+    , NumberOfCells(input->GetNumberOfCells())
+    , NumberOfPoints(input->GetNumberOfPoints())
+  {
+    if (this->NumberOfCells > 0)
+    {
+      // Make the input API thread safe by calling it once in a single thread.
+      vtkIdType npts;
+      const vtkIdType* pts;
+      input->GetCellType(0);
+      input->GetCellPoints(0, npts, pts, this->CellPointIds.Local());
+    }
+  }
+
+  // Calls functor(cellId, npts, pts) for the cells in [begin, end). Thread safe.
+  template <typename FunctorT>
+  void ForEachCell(vtkIdType begin, vtkIdType end, FunctorT& functor)
+  {
+    vtkIdList* ids = this->CellPointIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Input->GetCellPoints(cellId, npts, pts, ids);
+      functor(cellId, npts, pts);
+    }
+  }
+
+  // Builds the components of the cells satisfying the connectivity criterion
+  // `isConnected(npts, pts)` that share points. Each component is identified
+  // by its smallest cell id.
+  template <typename PredicateT>
+  void Build(PredicateT isConnected)
+  {
+    const vtkIdType numCells = this->NumberOfCells;
+    this->Connected.assign(numCells, 1);
+    this->Parent.reset(new std::atomic<vtkIdType>[numCells]);
+    this->PointOwners.reset(new std::atomic<vtkIdType>[this->NumberOfPoints]);
+    vtkSMPTools::For(0, numCells, [this](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->Parent[cellId].store(cellId);
+      }
+    });
+    vtkSMPTools::For(0, this->NumberOfPoints, [this](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->PointOwners[ptId].store(-1);
+      }
+    });
+
+    // Connected cells sharing a point are merged with the first connected cell
+    // that claimed the point.
+    vtkSMPTools::For(0, numCells, [this, &isConnected](vtkIdType begin, vtkIdType end) {
+      auto merge = [this, &isConnected](vtkIdType cellId, vtkIdType npts, const vtkIdType* pts) {
+        if (!isConnected(npts, pts))
+        {
+          this->Connected[cellId] = 0;
+          return;
+        }
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          vtkIdType owner = -1;
+          if (!this->PointOwners[pts[i]].compare_exchange_strong(owner, cellId))
+          {
+            this->Union(cellId, owner);
+          }
+        }
+      };
+      this->ForEachCell(begin, end, merge);
+    });
+
+    this->Roots.resize(numCells);
+    vtkSMPTools::For(0, numCells, [this](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->Roots[cellId] = this->Find(cellId);
+      }
+    });
+    this->Parent.reset();
+  }
+
+  // Labels every cell with the id of its region and computes the number of
+  // cells of each region. Returns the number of regions.
+  vtkIdType LabelAllRegions(
+    std::vector<vtkIdType>& cellRegionIds, std::vector<vtkIdType>& regionSizes)
+  {
+    const vtkIdType numCells = this->NumberOfCells;
+
+    // A cell that does not satisfy the criterion always seeds its own region,
+    // which grows into the adjacent components that no earlier cell reached.
+    // claims[root] is the seed of the region of the component.
+    std::unique_ptr<std::atomic<vtkIdType>[]> claims(new std::atomic<vtkIdType>[numCells]);
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        claims[cellId].store(cellId);
+      }
+    });
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      auto claim = [&](vtkIdType cellId, vtkIdType npts, const vtkIdType* pts) {
+        if (this->Connected[cellId])
+        {
+          return;
+        }
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          const vtkIdType owner = this->PointOwners[pts[i]].load();
+          if (owner >= 0 && this->Roots[owner] > cellId)
+          {
+            AtomicMin(claims[this->Roots[owner]], cellId);
+          }
+        }
+      };
+      this->ForEachCell(begin, end, claim);
+    });
+
+    // Regions are numbered in the order of their seed.
+    std::vector<vtkIdType> seedRegionIds(numCells, -1);
+    vtkIdType numRegions = 0;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      if (!this->Connected[cellId] ||
+        (this->Roots[cellId] == cellId && claims[cellId].load() == cellId))
+      {
+        seedRegionIds[cellId] = numRegions++;
+      }
+    }
+
+    // Label the cells and count them per region. Neighboring cells mostly
+    // belong to the same region, so counts are accumulated in runs.
+    cellRegionIds.resize(numCells);
+    std::unique_ptr<std::atomic<vtkIdType>[]> sizes(new std::atomic<vtkIdType>[numRegions]);
+    for (vtkIdType regionId = 0; regionId < numRegions; ++regionId)
+    {
+      sizes[regionId].store(0);
+    }
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdType runRegionId = -1, runLength = 0;
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const vtkIdType seed =
+          this->Connected[cellId] ? claims[this->Roots[cellId]].load() : cellId;
+        const vtkIdType regionId = seedRegionIds[seed];
+        cellRegionIds[cellId] = regionId;
+        if (regionId != runRegionId)
+        {
+          if (runLength > 0)
+          {
+            sizes[runRegionId] += runLength;
+          }
+          runRegionId = regionId;
+          runLength = 0;
+        }
+        ++runLength;
+      }
+      if (runLength > 0)
+      {
+        sizes[runRegionId] += runLength;
+      }
+    });
+
+    regionSizes.resize(numRegions);
+    for (vtkIdType regionId = 0; regionId < numRegions; ++regionId)
+    {
+      regionSizes[regionId] = sizes[regionId].load();
+    }
+    return numRegions;
+  }
+
+  // Labels with 0 the cells of the region grown from the seed cells, and
+  // with -1 all other cells. Returns the number of cells of the region.
+  vtkIdType LabelSeededRegion(
+    const std::vector<vtkIdType>& seeds, std::vector<vtkIdType>& cellRegionIds)
+  {
+    const vtkIdType numCells = this->NumberOfCells;
+    cellRegionIds.assign(numCells, -1);
+    std::vector<unsigned char> selectedRoots(numCells, 0);
+    vtkIdList* ids = this->CellPointIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType seed : seeds)
+    {
+      if (seed < 0 || seed >= numCells)
+      {
+        continue;
+      }
+      cellRegionIds[seed] = 0;
+      if (this->Connected[seed])
+      {
+        selectedRoots[this->Roots[seed]] = 1;
+        continue;
+      }
+      this->Input->GetCellPoints(seed, npts, pts, ids);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        const vtkIdType owner = this->PointOwners[pts[i]].load();
+        if (owner >= 0)
+        {
+          selectedRoots[this->Roots[owner]] = 1;
+        }
+      }
+    }
+
+    vtkSMPThreadLocal<vtkIdType> counts(0);
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdType& count = counts.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (this->Connected[cellId] && selectedRoots[this->Roots[cellId]])
+        {
+          cellRegionIds[cellId] = 0;
+        }
+        count += cellRegionIds[cellId] == 0 ? 1 : 0;
+      }
+    });
+    return std::accumulate(counts.begin(), counts.end(), static_cast<vtkIdType>(0));
+  }
+
+  // Labels each point with the smallest region id of the labelled cells
+  // using it, or -1.
+  void LabelPoints(
+    const std::vector<vtkIdType>& cellRegionIds, std::vector<vtkIdType>& pointRegionIds)
+  {
+    std::unique_ptr<std::atomic<vtkIdType>[]> labels(
+      new std::atomic<vtkIdType>[this->NumberOfPoints]);
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        labels[ptId].store(VTK_ID_MAX);
+      }
+    });
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      auto label = [&](vtkIdType cellId, vtkIdType npts, const vtkIdType* pts) {
+        if (cellRegionIds[cellId] >= 0)
+        {
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            AtomicMin(labels[pts[i]], cellRegionIds[cellId]);
+          }
+        }
+      };
+      this->ForEachCell(begin, end, label);
+    });
+    pointRegionIds.resize(this->NumberOfPoints);
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        const vtkIdType regionId = labels[ptId].load();
+        pointRegionIds[ptId] = regionId == VTK_ID_MAX ? -1 : regionId;
+      }
+    });
+  }
+
+  // Returns the cells using any of the given points.
+  std::vector<vtkIdType> GetCellsUsingPoints(vtkIdList* ptIds)
+  {
+    std::vector<unsigned char> selected(this->NumberOfPoints, 0);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      const vtkIdType ptId = ptIds->GetId(i);
+      if (ptId >= 0 && ptId < this->NumberOfPoints)
+      {
+        selected[ptId] = 1;
+      }
+    }
+    std::vector<unsigned char> flags(this->NumberOfCells, 0);
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      auto flag = [&](vtkIdType cellId, vtkIdType npts, const vtkIdType* pts) {
+        for (vtkIdType i = 0; i < npts && !flags[cellId]; ++i)
+        {
+          flags[cellId] = selected[pts[i]];
+        }
+      };
+      this->ForEachCell(begin, end, flag);
+    });
+    std::vector<vtkIdType> cellIds;
+    for (vtkIdType cellId = 0; cellId < this->NumberOfCells; ++cellId)
+    {
+      if (flags[cellId])
+      {
+        cellIds.push_back(cellId);
+      }
+    }
+    return cellIds;
+  }
+
+  // Returns the smallest id of the points closest to x.
+  vtkIdType FindClosestPoint(const double x[3])
+  {
+    using Candidate = std::pair<double, vtkIdType>;
+    vtkSMPThreadLocal<Candidate> closest(Candidate(VTK_DOUBLE_MAX, 0));
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      Candidate& local = closest.Local();
+      double p[3];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Input->GetPoint(ptId, p);
+        local = std::min(local, Candidate(vtkMath::Distance2BetweenPoints(p, x), ptId));
+      }
+    });
+    Candidate result(VTK_DOUBLE_MAX, 0);
+    for (const Candidate& candidate : closest)
+    {
+      result = std::min(result, candidate);
+    }
+    return result.second;
+  }
+
+private:
+  vtkIdType Find(vtkIdType cellId)
+  {
+    while (true)
+    {
+      vtkIdType parent = this->Parent[cellId].load();
+      if (parent == cellId)
+      {
+        return cellId;
+      }
+      const vtkIdType grandParent = this->Parent[parent].load();
+      if (grandParent != parent)
+      {
+        // Path halving.
+        this->Parent[cellId].compare_exchange_weak(parent, grandParent);
+      }
+      cellId = grandParent;
+    }
+  }
+
+  // Links the larger root under the smaller one, so roots are the smallest
+  // cell id of their component.
+  void Union(vtkIdType a, vtkIdType b)
+  {
+    while (true)
+    {
+      a = this->Find(a);
+      b = this->Find(b);
+      if (a == b)
+      {
+        return;
+      }
+      if (a < b)
+      {
+        std::swap(a, b);
+      }
+      vtkIdType expected = a;
+      if (this->Parent[a].compare_exchange_strong(expected, b))
+      {
+        return;
+      }
+    }
+  }
+
+  vtkDataSet* Input;
+  vtkIdType NumberOfCells;
+  vtkIdType NumberOfPoints;
+  vtkSMPThreadLocalObject<vtkIdList> CellPointIds;
+  std::vector<unsigned char> Connected;
+  std::vector<vtkIdType> Roots;
+  std::unique_ptr<std::atomic<vtkIdType>[]> Parent;
+  std::unique_ptr<std::atomic<vtkIdType>[]> PointOwners;
+};
+
+//========================= EXTRACTION ========================================
+// Copies the extracted cells of [begin, end) into `cells` (and `types` when
+// given). cellMap holds the output id of the extracted cells.
+inline void ExtractCellRange(vtkDataSet* input, vtkIdType begin, vtkIdType end,
+  const std::vector<vtkIdType>& cellMap, const std::vector<vtkIdType>& pointMap,
+  vtkCellArray* cells, vtkUnsignedCharArray* types)
+{
+  vtkIdType outBegin = -1, outEnd = -1;
+  for (vtkIdType cellId = begin; cellId < end && outBegin < 0; ++cellId)
+  {
+    outBegin = cellMap[cellId];
+  }
+  for (vtkIdType cellId = end - 1; cellId >= begin && outEnd < 0; --cellId)
+  {
+    outEnd = cellMap[cellId] >= 0 ? cellMap[cellId] + 1 : -1;
+  }
+  const vtkIdType numCells = outBegin < 0 ? 0 : outEnd - outBegin;
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numCells + 1);
+  offsets->SetValue(0, 0);
+  vtkSMPThreadLocalObject<vtkIdList> cellPointIds;
+  vtkSMPTools::For(begin, end, [&](vtkIdType first, vtkIdType last) {
+    vtkIdList* ids = cellPointIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType cellId = first; cellId < last; ++cellId)
+    {
+      if (cellMap[cellId] >= 0)
+      {
+        input->GetCellPoints(cellId, npts, pts, ids);
+        offsets->SetValue(cellMap[cellId] - outBegin + 1, npts);
+      }
+    }
+  });
+  vtkIdType* offsetsPtr = offsets->GetPointer(0);
+  std::partial_sum(offsetsPtr, offsetsPtr + numCells + 1, offsetsPtr);
+
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(offsets->GetValue(numCells));
+  if (types)
+  {
+    types->SetNumberOfValues(numCells);
+  }
+  vtkSMPTools::For(begin, end, [&](vtkIdType first, vtkIdType last) {
+    vtkIdList* ids = cellPointIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType cellId = first; cellId < last; ++cellId)
+    {
+      const vtkIdType newCellId = cellMap[cellId] - outBegin;
+      if (cellMap[cellId] < 0)
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, npts, pts, ids);
+      vtkIdType* newPts = connectivity->GetPointer(offsets->GetValue(newCellId));
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        newPts[i] = pointMap[pts[i]];
+      }
+      if (types)
+      {
+        types->SetValue(newCellId, static_cast<unsigned char>(input->GetCellType(cellId)));
+      }
+    }
+  });
+  cells->SetData(offsets, connectivity);
+}
+
+// Copies the polyhedron face streams of the extracted cells.
+inline void ExtractFaces(vtkUnstructuredGrid* input, vtkIdList* cellIds,
+  const std::vector<vtkIdType>& pointMap, vtkIdTypeArray* faceLocations, vtkIdTypeArray* faces)
+{
+  vtkIdTypeArray* inFaces = input->GetFaces();
+  vtkIdTypeArray* inFaceLocations = input->GetFaceLocations();
+  const vtkIdType numCells = cellIds->GetNumberOfIds();
+
+  // Face streams are [numFaces, (numFacePts, ptIds...)...].
+  faceLocations->SetNumberOfValues(numCells);
+  vtkIdType size = 0;
+  for (vtkIdType newCellId = 0; newCellId < numCells; ++newCellId)
+  {
+    const vtkIdType location = inFaceLocations->GetValue(cellIds->GetId(newCellId));
+    if (location < 0)
+    {
+      faceLocations->SetValue(newCellId, -1);
+      continue;
+    }
+    faceLocations->SetValue(newCellId, size);
+    const vtkIdType* stream = inFaces->GetPointer(location);
+    const vtkIdType* face = stream + 1;
+    for (vtkIdType j = 0; j < stream[0]; ++j)
+    {
+      face += *face + 1;
+    }
+    size += face - stream;
+  }
+
+  faces->SetNumberOfValues(size);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType newCellId = begin; newCellId < end; ++newCellId)
+    {
+      const vtkIdType location = inFaceLocations->GetValue(cellIds->GetId(newCellId));
+      if (location < 0)
+      {
+        continue;
+      }
+      const vtkIdType* stream = inFaces->GetPointer(location);
+      vtkIdType* newStream = faces->GetPointer(faceLocations->GetValue(newCellId));
+      const vtkIdType numFaces = *stream++;
+      *newStream++ = numFaces;
+      for (vtkIdType j = 0; j < numFaces; ++j)
+      {
+        const vtkIdType numFacePts = *stream++;
+        *newStream++ = numFacePts;
+        for (vtkIdType k = 0; k < numFacePts; ++k)
+        {
+          *newStream++ = pointMap[*stream++];
+        }
+      }
+    }
+  });
+}
+
+// Copies the flagged cells, the points they use (in input order) and their
+// attributes to `output`, a vtkPolyData when the input is one or a
+// vtkUnstructuredGrid otherwise. `pointIds` and `cellIds` receive the input
+// ids of the output points and cells.
+inline void ExtractFlaggedCells(vtkDataSet* input, const std::vector<unsigned char>& extract,
+  int pointsDataType, vtkPointSet* output, vtkIdList* pointIds, vtkIdList* cellIds)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+
+  std::vector<vtkIdType> cellMap(numCells, -1);
+  cellIds->Reset();
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (extract[cellId])
+    {
+      cellMap[cellId] = cellIds->InsertNextId(cellId);
+    }
+  }
+  const vtkIdType numOutCells = cellIds->GetNumberOfIds();
+
+  // Flag the used points, then number them.
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  vtkSMPThreadLocalObject<vtkIdList> cellPointIds;
+  if (numCells > 0)
+  {
+    input->GetCellType(0);
+    input->GetCellPoints(0, cellPointIds.Local());
+  }
+  vtkSMPTools::For(0, numOutCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ids = cellPointIds.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType newCellId = begin; newCellId < end; ++newCellId)
+    {
+      input->GetCellPoints(cellIds->GetId(newCellId), npts, pts, ids);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        pointMap[pts[i]] = 0;
+      }
+    }
+  });
+  pointIds->Reset();
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    if (pointMap[ptId] == 0)
+    {
+      pointMap[ptId] = pointIds->InsertNextId(ptId);
+    }
+  }
+  const vtkIdType numOutPts = pointIds->GetNumberOfIds();
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(pointsDataType);
+  newPts->SetNumberOfPoints(numOutPts);
+  vtkSMPTools::For(0, numOutPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType newPtId = begin; newPtId < end; ++newPtId)
+    {
+      input->GetPoint(pointIds->GetId(newPtId), x);
+      newPts->SetPoint(newPtId, x);
+    }
+  });
+  output->SetPoints(newPts);
+
+  vtkPointData* outPD = output->GetPointData();
+  outPD->CopyAllocate(input->GetPointData(), numOutPts);
+  outPD->CopyData(input->GetPointData(), pointIds);
+
+  vtkPolyData* pdOutput = vtkPolyData::SafeDownCast(output);
+  vtkPolyData* pdInput = vtkPolyData::SafeDownCast(input);
+  if (pdOutput && pdInput)
+  {
+    // Input cells are ordered verts, lines, polys and strips, so are the
+    // extracted cells.
+    vtkCellArray* inCells[4] = { pdInput->GetVerts(), pdInput->GetLines(), pdInput->GetPolys(),
+      pdInput->GetStrips() };
+    vtkIdType begin = 0;
+    for (int type = 0; type < 4; ++type)
+    {
+      const vtkIdType end = begin + inCells[type]->GetNumberOfCells();
+      if (end > begin)
+      {
+        vtkNew<vtkCellArray> cells;
+        ExtractCellRange(input, begin, end, cellMap, pointMap, cells, nullptr);
+        switch (type)
+        {
+          case 0:
+            pdOutput->SetVerts(cells);
+            break;
+          case 1:
+            pdOutput->SetLines(cells);
+            break;
+          case 2:
+            pdOutput->SetPolys(cells);
+            break;
+          default:
+            pdOutput->SetStrips(cells);
+        }
+      }
+      begin = end;
+    }
+  }
+  else if (vtkUnstructuredGrid* ugOutput = vtkUnstructuredGrid::SafeDownCast(output))
+  {
+    vtkNew<vtkCellArray> cells;
+    vtkNew<vtkUnsignedCharArray> types;
+    ExtractCellRange(input, 0, numCells, cellMap, pointMap, cells, types);
+    vtkUnstructuredGrid* ugInput = vtkUnstructuredGrid::SafeDownCast(input);
+    if (ugInput && ugInput->GetFaces() && ugInput->GetFaceLocations())
+    {
+      vtkNew<vtkIdTypeArray> faceLocations;
+      vtkNew<vtkIdTypeArray> faces;
+      ExtractFaces(ugInput, cellIds, pointMap, faceLocations, faces);
+      ugOutput->SetCells(types, cells, faceLocations, faces);
+    }
+    else
+    {
+      ugOutput->SetCells(types, cells);
+    }
+  }
+
+  vtkCellData* outCD = output->GetCellData();
+  outCD->CopyAllocate(input->GetCellData(), numOutCells);
+  outCD->CopyData(input->GetCellData(), cellIds);
+}
+
+} // anonymous namespace
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectedRegionsInternal.h
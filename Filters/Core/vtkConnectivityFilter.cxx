@@ -14,23 +14,25 @@
 =========================================================================*/
 #include "vtkConnectivityFilter.h"
 
-#include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectedRegionsInternal.h"
 #include "vtkDataSet.h"
 #include "vtkDemandDrivenPipeline.h"
-#include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
-#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 vtkObjectFactoryNewMacro(vtkConnectivityFilter);
 
@@ -48,26 +50,15 @@ vtkConnectivityFilter::vtkConnectivityFilter()
 
   this->ClosestPoint[0] = this->ClosestPoint[1] = this->ClosestPoint[2] = 0.0;
 
-  this->CellScalars = vtkFloatArray::New();
-  this->CellScalars->Allocate(8);
-
-  this->NeighborCellPointIds = vtkIdList::New();
-  this->NeighborCellPointIds->Allocate(8);
-
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
-  this->NewScalars = nullptr;
-  this->NewCellScalars = nullptr;
-
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 }
 
 vtkConnectivityFilter::~vtkConnectivityFilter()
 {
   this->RegionSizes->Delete();
-  this->CellScalars->Delete();
-  this->NeighborCellPointIds->Delete();
   this->Seeds->Delete();
   this->SpecifiedRegionIds->Delete();
 }
@@ -125,43 +116,24 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkDataSet* input = vtkDataSet::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
   vtkPointSet* output = vtkPointSet::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkPolyData* pdOutput = vtkPolyData::SafeDownCast(output);
-  vtkUnstructuredGrid* ugOutput = vtkUnstructuredGrid::SafeDownCast(output);
-
-  vtkIdType numPts, numCells, cellId, i, j, pt;
-  vtkPoints* newPts;
-  vtkIdType id;
-  vtkIdType maxCellsInRegion;
-  vtkIdType largestRegionId = 0;
-  vtkPointData *pd = input->GetPointData(), *outputPD = output->GetPointData();
-  vtkCellData *cd = input->GetCellData(), *outputCD = output->GetCellData();
-
   vtkDebugMacro(<< "Executing connectivity filter.");
 
-  //  Check input/allocate storage
+  //  Check input
   //
-  numCells = input->GetNumberOfCells();
-  if ((numPts = input->GetNumberOfPoints()) < 1 || numCells < 1)
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  if (numPts < 1 || numCells < 1)
   {
     vtkDebugMacro(<< "No data to connect!");
     return 1;
   }
 
-  if (pdOutput)
-  {
-    pdOutput->AllocateExact(numCells, 3);
-  }
-  if (ugOutput)
-  {
-    ugOutput->Allocate(numCells, numCells);
-  }
-
   // See whether to consider scalar connectivity
   //
-  this->InScalars = input->GetPointData()->GetScalars();
+  vtkDataArray* inScalars = input->GetPointData()->GetScalars();
   if (!this->ScalarConnectivity)
   {
-    this->InScalars = nullptr;
+    inScalars = nullptr;
   }
   else
   {
@@ -171,432 +143,165 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
-  // Initialize.  Keep track of points and cells visited.
+  // Build the components of the cells sharing points. With scalar
+  // connectivity, a cell is connected to its neighbors only if the range of
+  // its point scalars intersects the scalar range.
   //
-  this->RegionSizes->Reset();
-  this->Visited = new vtkIdType[numCells];
-  for (i = 0; i < numCells; i++)
-  {
-    this->Visited[i] = -1;
-  }
-  this->PointMap = new vtkIdType[numPts];
-  for (i = 0; i < numPts; i++)
+  ConnectedRegions regions(input);
+  if (inScalars)
   {
-    this->PointMap[i] = -1;
-  }
-
-  this->NewScalars = vtkIdTypeArray::New();
-  this->NewScalars->SetName("RegionId");
-  this->NewScalars->SetNumberOfTuples(numPts);
-
-  this->NewCellScalars = vtkIdTypeArray::New();
-  this->NewCellScalars->SetName("RegionId");
-  this->NewCellScalars->SetNumberOfTuples(numCells);
-
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
-    if (inputPointSet)
-    {
-      newPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      newPts->SetDataType(VTK_FLOAT);
-    }
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
+    const double scalarRange[2] = { this->ScalarRange[0], this->ScalarRange[1] };
+    regions.Build([inScalars, &scalarRange](vtkIdType npts, const vtkIdType* pts) {
+      // Scalars are compared in single precision.
+      double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        const double s = static_cast<float>(inScalars->GetComponent(pts[i], 0));
+        range[0] = std::min(range[0], s);
+        range[1] = std::max(range[1], s);
+      }
+      return range[1] >= scalarRange[0] && range[0] <= scalarRange[1];
+    });
   }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  else
   {
-    newPts->SetDataType(VTK_DOUBLE);
+    regions.Build([](vtkIdType, const vtkIdType*) { return true; });
   }
+  this->UpdateProgress(0.4);
 
-  newPts->Allocate(numPts);
-
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
+  // Label the cells with their region. Regions are numbered in the order of
+  // their first cell.
   //
-  this->Wave = vtkIdList::New();
-  this->Wave->Allocate(numPts / 4 + 1, numPts);
-  this->Wave2 = vtkIdList::New();
-  this->Wave2->Allocate(numPts / 4 + 1, numPts);
-
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
-
-  this->CellIds = vtkIdList::New();
-  this->CellIds->Allocate(8, VTK_CELL_SIZE);
-  this->PointIds = vtkIdList::New();
-  this->PointIds->Allocate(8, VTK_CELL_SIZE);
-
+  std::vector<vtkIdType> cellRegionIds;
+  vtkIdType largestRegionId = 0;
+  this->RegionSizes->Reset();
   if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
-  { // visit all cells marking with region number
-    for (cellId = 0; cellId < numCells; cellId++)
-    {
-      if (cellId && !(cellId % 5000))
-      {
-        this->UpdateProgress(0.1 + 0.8 * cellId / numCells);
-      }
-
-      if (this->Visited[cellId] < 0)
-      {
-        this->NumCellsInRegion = 0;
-        this->Wave->InsertNextId(cellId);
-        this->TraverseAndMark(input);
-
-        if (this->NumCellsInRegion > maxCellsInRegion)
-        {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-        }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++, this->NumCellsInRegion);
-        this->Wave->Reset();
-        this->Wave2->Reset();
-      }
-    }
+  {
+    std::vector<vtkIdType> sizes;
+    const vtkIdType numRegions = regions.LabelAllRegions(cellRegionIds, sizes);
+    this->RegionSizes->SetNumberOfValues(numRegions);
+    std::copy(sizes.begin(), sizes.end(), this->RegionSizes->GetPointer(0));
+    largestRegionId = std::max_element(sizes.begin(), sizes.end()) - sizes.begin();
   }
   else // regions have been seeded, everything considered in same region
   {
-    this->NumCellsInRegion = 0;
-
+    std::vector<vtkIdType> seeds;
     if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS)
     {
-      for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        pt = this->Seeds->GetId(i);
-        if (pt >= 0)
-        {
-          input->GetPointCells(pt, this->CellIds);
-          for (j = 0; j < this->CellIds->GetNumberOfIds(); j++)
-          {
-            this->Wave->InsertNextId(this->CellIds->GetId(j));
-          }
-        }
-      }
+      seeds = regions.GetCellsUsingPoints(this->Seeds);
     }
     else if (this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS)
     {
-      for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        cellId = this->Seeds->GetId(i);
-        if (cellId >= 0)
-        {
-          this->Wave->InsertNextId(cellId);
-        }
-      }
+      seeds.assign(this->Seeds->begin(), this->Seeds->end());
     }
     else if (this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION)
-    { // loop over points, find closest one
-      double minDist2, dist2, x[3];
-      vtkIdType minId = 0;
-      for (minDist2 = VTK_DOUBLE_MAX, i = 0; i < numPts; i++)
-      {
-        input->GetPoint(i, x);
-        dist2 = vtkMath::Distance2BetweenPoints(x, this->ClosestPoint);
-        if (dist2 < minDist2)
-        {
-          minId = i;
-          minDist2 = dist2;
-        }
-      }
-      input->GetPointCells(minId, this->CellIds);
-      for (j = 0; j < this->CellIds->GetNumberOfIds(); j++)
-      {
-        this->Wave->InsertNextId(this->CellIds->GetId(j));
-      }
-    }
-    this->UpdateProgress(0.5);
-
-    // mark all seeded regions
-    this->TraverseAndMark(input);
-    this->RegionSizes->InsertValue(this->RegionNumber, this->NumCellsInRegion);
-    this->UpdateProgress(0.9);
-  }
-
-  vtkDebugMacro(<< "Extracted " << this->RegionNumber << " region(s)");
-  this->Wave->Delete();
-  this->Wave2->Delete();
-
-  // Now that points and cells have been marked, traverse these lists pulling
-  // everything that has been visited.
-  //
-  // Pass through point data that has been visited
-  outputPD->CopyAllocate(pd);
-  outputCD->CopyAllocate(cd);
-
-  for (i = 0; i < numPts; i++)
-  {
-    if (this->PointMap[i] > -1)
     {
-      newPts->InsertPoint(this->PointMap[i], input->GetPoint(i));
-      outputPD->CopyData(pd, i, this->PointMap[i]);
+      vtkNew<vtkIdList> closestPoint;
+      closestPoint->InsertNextId(regions.FindClosestPoint(this->ClosestPoint));
+      seeds = regions.GetCellsUsingPoints(closestPoint);
     }
+    this->RegionSizes->InsertValue(0, regions.LabelSeededRegion(seeds, cellRegionIds));
   }
+  vtkDebugMacro(<< "Extracted " << this->RegionSizes->GetNumberOfValues() << " region(s)");
+  this->UpdateProgress(0.7);
 
-  // if coloring regions; send down new scalar data
-  if (this->ColorRegions)
-  {
-    this->OrderRegionIds(this->NewScalars, this->NewCellScalars);
-
-    int idx = outputPD->AddArray(this->NewScalars);
-    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
-    idx = outputCD->AddArray(this->NewCellScalars);
-    outputCD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
-  }
-  this->NewScalars->Delete();
-  this->NewCellScalars->Delete();
-
-  output->SetPoints(newPts);
-  newPts->Delete();
-
-  // Create output cells
+  // Select the cells to extract.
   //
-  if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
-    this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS ||
-    this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION ||
-    this->ExtractionMode == VTK_EXTRACT_ALL_REGIONS)
-  { // extract any cell that's been visited
-    for (cellId = 0; cellId < numCells; cellId++)
+  std::vector<unsigned char> extract(numCells, 0);
+  std::vector<unsigned char> specifiedRegions;
+  if (this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS)
+  {
+    specifiedRegions.assign(this->RegionSizes->GetNumberOfValues(), 0);
+    for (vtkIdType regionId : *this->SpecifiedRegionIds)
     {
-      if (this->Visited[cellId] >= 0)
+      if (regionId >= 0 && regionId < static_cast<vtkIdType>(specifiedRegions.size()))
       {
-        // special handling for polyhedron cells
-        if (vtkUnstructuredGrid::SafeDownCast(input) &&
-          input->GetCellType(cellId) == VTK_POLYHEDRON)
-        {
-          vtkUnstructuredGrid::SafeDownCast(input)->GetFaceStream(cellId, this->PointIds);
-          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, this->PointMap);
-        }
-        else
-        {
-          input->GetCellPoints(cellId, this->PointIds);
-          for (i = 0; i < this->PointIds->GetNumberOfIds(); i++)
-          {
-            id = this->PointMap[this->PointIds->GetId(i)];
-            this->PointIds->InsertId(i, id);
-          }
-        }
-        vtkIdType newCellId = -1;
-        if (pdOutput)
-        {
-          newCellId = pdOutput->InsertNextCell(input->GetCellType(cellId), this->PointIds);
-        }
-        else if (ugOutput)
-        {
-          newCellId = ugOutput->InsertNextCell(input->GetCellType(cellId), this->PointIds);
-        }
-        if (newCellId >= 0)
-        {
-          outputCD->CopyData(cd, cellId, newCellId);
-        }
+        specifiedRegions[regionId] = 1;
       }
     }
   }
-  else if (this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS)
-  {
-    for (cellId = 0; cellId < numCells; cellId++)
+  const int extractionMode = this->ExtractionMode;
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
     {
-      int inReg, regionId;
-      if ((regionId = this->Visited[cellId]) >= 0)
+      const vtkIdType regionId = cellRegionIds[cellId];
+      if (extractionMode == VTK_EXTRACT_SPECIFIED_REGIONS)
       {
-        for (inReg = 0, i = 0; i < this->SpecifiedRegionIds->GetNumberOfIds(); i++)
-        {
-          if (regionId == this->SpecifiedRegionIds->GetId(i))
-          {
-            inReg = 1;
-            break;
-          }
-        }
-        if (inReg)
-        {
-          // special handling for polyhedron cells
-          if (vtkUnstructuredGrid::SafeDownCast(input) &&
-            input->GetCellType(cellId) == VTK_POLYHEDRON)
-          {
-            vtkUnstructuredGrid::SafeDownCast(input)->GetFaceStream(cellId, this->PointIds);
-            vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, this->PointMap);
-          }
-          else
-          {
-            input->GetCellPoints(cellId, this->PointIds);
-            for (i = 0; i < this->PointIds->GetNumberOfIds(); i++)
-            {
-              id = this->PointMap[this->PointIds->GetId(i)];
-              this->PointIds->InsertId(i, id);
-            }
-          }
-          vtkIdType newCellId = -1;
-          if (pdOutput)
-          {
-            newCellId = pdOutput->InsertNextCell(input->GetCellType(cellId), this->PointIds);
-          }
-          else if (ugOutput)
-          {
-            newCellId = ugOutput->InsertNextCell(input->GetCellType(cellId), this->PointIds);
-          }
-          if (newCellId >= 0)
-          {
-            outputCD->CopyData(cd, cellId, newCellId);
-          }
-        }
+        extract[cellId] = regionId >= 0 && specifiedRegions[regionId];
+      }
+      else if (extractionMode == VTK_EXTRACT_LARGEST_REGION)
+      {
+        extract[cellId] = regionId == largestRegionId;
+      }
+      else
+      {
+        extract[cellId] = regionId >= 0;
       }
     }
-  }
-  else // extract largest region
+  });
+
+  // Set the desired precision for the points in the output.
+  int pointsDataType = VTK_FLOAT;
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
   {
-    for (cellId = 0; cellId < numCells; cellId++)
+    vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
+    if (inputPointSet)
     {
-      if (this->Visited[cellId] == largestRegionId)
-      {
-        // special handling for polyhedron cells
-        if (vtkUnstructuredGrid::SafeDownCast(input) &&
-          input->GetCellType(cellId) == VTK_POLYHEDRON)
-        {
-          vtkUnstructuredGrid::SafeDownCast(input)->GetFaceStream(cellId, this->PointIds);
-          vtkUnstructuredGrid::ConvertFaceStreamPointIds(this->PointIds, this->PointMap);
-        }
-        else
-        {
-          input->GetCellPoints(cellId, this->PointIds);
-          for (i = 0; i < this->PointIds->GetNumberOfIds(); i++)
-          {
-            id = this->PointMap[this->PointIds->GetId(i)];
-            this->PointIds->InsertId(i, id);
-          }
-        }
-        vtkIdType newCellId = -1;
-        if (pdOutput)
-        {
-          newCellId = pdOutput->InsertNextCell(input->GetCellType(cellId), this->PointIds);
-        }
-        else if (ugOutput)
-        {
-          newCellId = ugOutput->InsertNextCell(input->GetCellType(cellId), this->PointIds);
-        }
-        if (newCellId >= 0)
-        {
-          outputCD->CopyData(cd, cellId, newCellId);
-        }
-      }
+      pointsDataType = inputPointSet->GetPoints()->GetDataType();
     }
   }
-
-  delete[] this->Visited;
-  delete[] this->PointMap;
-  this->PointIds->Delete();
-  this->CellIds->Delete();
-  output->Squeeze();
-  vtkDataArray* outScalars = nullptr;
-  if (this->ColorRegions && (outScalars = output->GetPointData()->GetScalars()))
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
   {
-    outScalars->Resize(output->GetNumberOfPoints());
+    pointsDataType = VTK_DOUBLE;
   }
 
-  int num = this->GetNumberOfExtractedRegions();
-  int count = 0;
+  // Pull the extracted cells, the points they use and their data.
+  //
+  vtkNew<vtkIdList> pointIds;
+  vtkNew<vtkIdList> cellIds;
+  ExtractFlaggedCells(input, extract, pointsDataType, output, pointIds, cellIds);
+  this->UpdateProgress(0.9);
 
-  for (int ii = 0; ii < num; ii++)
+  // if coloring regions; send down new scalar data. Points take the smallest
+  // region id of the cells using them.
+  if (this->ColorRegions)
   {
-    count += this->RegionSizes->GetValue(ii);
+    std::vector<vtkIdType> pointRegionIds;
+    regions.LabelPoints(cellRegionIds, pointRegionIds);
+
+    vtkNew<vtkIdTypeArray> newScalars;
+    newScalars->SetName("RegionId");
+    newScalars->SetNumberOfValues(pointIds->GetNumberOfIds());
+    vtkNew<vtkIdTypeArray> newCellScalars;
+    newCellScalars->SetName("RegionId");
+    newCellScalars->SetNumberOfValues(cellIds->GetNumberOfIds());
+    vtkSMPTools::For(0, pointIds->GetNumberOfIds(), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        newScalars->SetValue(ptId, pointRegionIds[pointIds->GetId(ptId)]);
+      }
+    });
+    vtkSMPTools::For(0, cellIds->GetNumberOfIds(), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        newCellScalars->SetValue(cellId, cellRegionIds[cellIds->GetId(cellId)]);
+      }
+    });
+    this->OrderRegionIds(newScalars, newCellScalars);
+
+    int idx = output->GetPointData()->AddArray(newScalars);
+    output->GetPointData()->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    idx = output->GetCellData()->AddArray(newCellScalars);
+    output->GetCellData()->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
   }
-  vtkDebugMacro(<< "Total # of cells accounted for: " << count);
+
   vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() << " cells");
 
   return 1;
 }
 
-// Mark current cell as visited and assign region number.  Note:
-// traversal occurs across shared vertices.
-//
-void vtkConnectivityFilter::TraverseAndMark(vtkDataSet* input)
-{
-  vtkIdType i, j, k, cellId, numIds, ptId, numPts, numCells;
-  vtkIdList* tmpWave;
-
-  while ((numIds = this->Wave->GetNumberOfIds()) > 0)
-  {
-    for (i = 0; i < numIds; i++)
-    {
-      cellId = this->Wave->GetId(i);
-      if (this->Visited[cellId] < 0)
-      {
-        this->NewCellScalars->SetValue(cellId, this->RegionNumber);
-        this->Visited[cellId] = this->RegionNumber;
-        this->NumCellsInRegion++;
-        input->GetCellPoints(cellId, this->PointIds);
-
-        numPts = this->PointIds->GetNumberOfIds();
-        for (j = 0; j < numPts; j++)
-        {
-          if (this->PointMap[ptId = this->PointIds->GetId(j)] < 0)
-          {
-            this->PointMap[ptId] = this->PointNumber++;
-            this->NewScalars->SetValue(this->PointMap[ptId], this->RegionNumber);
-          }
-
-          input->GetPointCells(ptId, this->CellIds);
-
-          // check connectivity criterion (geometric + scalar)
-          numCells = this->CellIds->GetNumberOfIds();
-          for (k = 0; k < numCells; k++)
-          {
-            cellId = this->CellIds->GetId(k);
-            if (this->InScalars)
-            {
-              int numScalars, ii;
-              double s, range[2];
-
-              input->GetCellPoints(cellId, this->NeighborCellPointIds);
-              numScalars = this->NeighborCellPointIds->GetNumberOfIds();
-              this->CellScalars->SetNumberOfComponents(this->InScalars->GetNumberOfComponents());
-              this->CellScalars->SetNumberOfTuples(numScalars);
-              this->InScalars->GetTuples(this->NeighborCellPointIds, this->CellScalars);
-              range[0] = VTK_DOUBLE_MAX;
-              range[1] = -VTK_DOUBLE_MAX;
-              for (ii = 0; ii < numScalars; ii++)
-              {
-                s = this->CellScalars->GetComponent(ii, 0);
-                if (s < range[0])
-                {
-                  range[0] = s;
-                }
-                if (s > range[1])
-                {
-                  range[1] = s;
-                }
-              }
-              if (range[1] >= this->ScalarRange[0] && range[0] <= this->ScalarRange[1])
-              {
-                this->Wave2->InsertNextId(cellId);
-              }
-            }
-            else
-            {
-              this->Wave2->InsertNextId(cellId);
-            }
-          } // for all cells using this point
-        }   // for all points of this cell
-      }     // if cell not yet visited
-    }       // for all cells in this wave
-
-    tmpWave = this->Wave;
-    this->Wave = this->Wave2;
-    this->Wave2 = tmpWave;
-    tmpWave->Reset();
-  } // while wave is not empty
-}
-
 void vtkConnectivityFilter::OrderRegionIds(
   vtkIdTypeArray* pointRegionIds, vtkIdTypeArray* cellRegionIds)
 {
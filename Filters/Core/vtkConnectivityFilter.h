@@ -50,6 +50,10 @@
  * was processed and has no other significance with respect to the size of
  * or number of cells.
  *
+ * The regions are labelled in parallel with a union-find over the cells
+ * sharing points, and the number of cells of each region is computed in the
+ * same pass. The output points keep the order of the input points.
+ *
  * @sa
  * vtkPolyDataConnectivityFilter
  */
@@ -67,9 +71,7 @@
 #define VTK_EXTRACT_ALL_REGIONS 5
 #define VTK_EXTRACT_CLOSEST_POINT_REGION 6
 
-class vtkDataArray;
 class vtkDataSet;
-class vtkFloatArray;
 class vtkIdList;
 class vtkIdTypeArray;
 class vtkIntArray;
@@ -177,6 +179,14 @@ public:
    */
   int GetNumberOfExtractedRegions();
 
+  ///@{
+  /**
+   * Obtain the array containing the number of cells of each extracted
+   * region. In the seeded extraction modes, it holds a single value.
+   */
+  vtkGetObjectMacro(RegionSizes, vtkIdTypeArray);
+  ///@}
+
   ///@{
   /**
    * Turn on/off the coloring of connected regions.
@@ -243,27 +253,8 @@ protected:
 
   int RegionIdAssignmentMode;
 
-  void TraverseAndMark(vtkDataSet* input);
-
   void OrderRegionIds(vtkIdTypeArray* pointRegionIds, vtkIdTypeArray* cellRegionIds);
 
-private:
-  // used to support algorithm execution
-  vtkFloatArray* CellScalars;
-  vtkIdList* NeighborCellPointIds;
-  vtkIdType* Visited;
-  vtkIdType* PointMap;
-  vtkIdTypeArray* NewScalars;
-  vtkIdTypeArray* NewCellScalars;
-  vtkIdType RegionNumber;
-  vtkIdType PointNumber;
-  vtkIdType NumCellsInRegion;
-  vtkDataArray* InScalars;
-  vtkIdList* Wave;
-  vtkIdList* Wave2;
-  vtkIdList* PointIds;
-  vtkIdList* CellIds;
-
 private:
   vtkConnectivityFilter(const vtkConnectivityFilter&) = delete;
   void operator=(const vtkConnectivityFilter&) = delete;
@@ -0,0 +1,622 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkContourCellsInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkContourCellsInternal
+ * @brief   concurrent and deterministic contouring of unstructured grid cells
+ *
+ * The cells of the input are split into batches of a fixed number of cells
+ * that are contoured concurrently with vtkCell::Contour(), so that any cell
+ * type (linear, higher order, polyhedra) is supported. Each batch has its own
+ * locator and output. The batches are then merged in order: points lying on
+ * the same input edge for the same contour value are merged with
+ * vtkStaticEdgeLocatorTemplate, and the remaining points (e.g. those created
+ * inside higher-order cells) are merged when they have the same coordinates.
+ * The output does not depend on the number of threads.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkContourGrid vtkCutter
+ */
+
+#ifndef vtkContourCellsInternal_h
+#define vtkContourCellsInternal_h
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkContourHelper.h"
+#include "vtkCutter.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkNonMergingPointLocator.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticEdgeLocatorTemplate.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+//========================= EDGE KEYS ==========================================
+// Point data array recording the input edge each contour point lies on. An
+// input point holds (id, id) and a point interpolated between two input
+// points holds both ids. Any other point, such as the points interpolated
+// inside higher-order cells, holds (-1, -1).
+class vtkContourEdgeKeys : public vtkIdTypeArray
+{
+public:
+  static vtkContourEdgeKeys* New();
+  vtkTypeMacro(vtkContourEdgeKeys, vtkIdTypeArray);
+
+  void InterpolateTuple(vtkIdType dstTupleIdx, vtkIdList* ptIndices, vtkAbstractArray* source,
+    double* weights) override
+  {
+    // Only a point coinciding with one of the source points keeps a key.
+    vtkIdType srcTupleIdx = -1;
+    for (vtkIdType i = 0; i < ptIndices->GetNumberOfIds(); ++i)
+    {
+      if (weights[i] == 0.0)
+      {
+        continue;
+      }
+      if (weights[i] != 1.0 || srcTupleIdx >= 0)
+      {
+        srcTupleIdx = -1;
+        break;
+      }
+      srcTupleIdx = ptIndices->GetId(i);
+    }
+    const vtkIdType invalid[2] = { -1, -1 };
+    this->InsertTypedTuple(dstTupleIdx,
+      srcTupleIdx >= 0 ? static_cast<vtkIdTypeArray*>(source)->GetPointer(2 * srcTupleIdx)
+                       : invalid);
+  }
+
+  void InterpolateTuple(vtkIdType dstTupleIdx, vtkIdType srcTupleIdx1, vtkAbstractArray* source1,
+    vtkIdType srcTupleIdx2, vtkAbstractArray* source2, double t) override
+  {
+    const vtkIdType* key1 = static_cast<vtkIdTypeArray*>(source1)->GetPointer(2 * srcTupleIdx1);
+    const vtkIdType* key2 = static_cast<vtkIdTypeArray*>(source2)->GetPointer(2 * srcTupleIdx2);
+    if (t == 0.0 || t == 1.0)
+    {
+      this->InsertTypedTuple(dstTupleIdx, t == 0.0 ? key1 : key2);
+      return;
+    }
+    vtkIdType key[2] = { -1, -1 };
+    if (key1[0] >= 0 && key1[0] == key1[1] && key2[0] >= 0 && key2[0] == key2[1])
+    {
+      key[0] = std::min(key1[0], key2[0]);
+      key[1] = std::max(key1[0], key2[0]);
+    }
+    this->InsertTypedTuple(dstTupleIdx, key);
+  }
+
+protected:
+  vtkContourEdgeKeys() = default;
+  ~vtkContourEdgeKeys() override = default;
+
+private:
+  vtkContourEdgeKeys(const vtkContourEdgeKeys&) = delete;
+  void operator=(const vtkContourEdgeKeys&) = delete;
+};
+vtkStandardNewMacro(vtkContourEdgeKeys);
+
+//========================= CELL COPIES ========================================
+// Copies the cells of a batch into a slice of preallocated output offsets and
+// connectivity, renumbering the point ids.
+struct RenumberCellsWorker
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, vtkIdType* offsets, vtkIdType* connectivity,
+    vtkIdType connectivityStart, const vtkIdType* pointMap)
+  {
+    const vtkIdType numCells = state.GetNumberOfCells();
+    const auto* inOffsets = state.GetOffsets()->GetPointer(0);
+    const auto* inConnectivity = state.GetConnectivity()->GetPointer(0);
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      offsets[cellId] = static_cast<vtkIdType>(inOffsets[cellId]) + connectivityStart;
+    }
+    for (vtkIdType i = 0; i < static_cast<vtkIdType>(inOffsets[numCells]); ++i)
+    {
+      connectivity[connectivityStart + i] = pointMap[inConnectivity[i]];
+    }
+  }
+};
+
+//========================= CONTOURING =========================================
+class UnstructuredGridContourer
+{
+public:
+  // Number of cells of a batch. It does not depend on the number of threads
+  // so that the output does not either.
+  static const vtkIdType BatchSize = 2048;
+
+  vtkUnstructuredGrid* Input = nullptr;
+  vtkDataArray* Scalars = nullptr; // scalars that are contoured
+  vtkPointData* InPd = nullptr;    // point data interpolated on the output
+  vtkCellData* InCd = nullptr;
+  const double* Values = nullptr;
+  vtkIdType NumberOfValues = 0;
+  bool MergePoints = true;
+  bool GenerateTriangles = true;
+
+  // Contours the input into output, whose points are newPts. The point data
+  // of the output must be empty; its copy flags are used.
+  void Execute(vtkPoints* newPts, vtkPolyData* output)
+  {
+    const vtkIdType numCells = this->Input->GetNumberOfCells();
+    const vtkIdType numPts = this->Input->GetNumberOfPoints();
+    vtkCutter::GetCellTypeDimensions(this->CellTypeDimensions);
+    this->PointsDataType = newPts->GetDataType();
+
+    // Make the input API thread safe by calling it once in a single thread.
+    vtkSMPThreadLocalObject<vtkGenericCell> cells;
+    vtkSMPThreadLocalObject<vtkIdList> cellPointIds;
+    vtkSMPThreadLocalObject<vtkDoubleArray> cellScalars;
+    if (numCells > 0)
+    {
+      this->Input->GetCellType(0);
+      this->Input->GetCell(0, cells.Local());
+    }
+
+    // The point data interpolated by the batches also holds the edge keys.
+    vtkNew<vtkContourEdgeKeys> keys;
+    keys->SetName("vtkContourEdgeKeys");
+    keys->SetNumberOfComponents(2);
+    keys->SetNumberOfTuples(numPts);
+    vtkSMPTools::For(0, numPts, [&keys](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        keys->SetValue(2 * ptId, ptId);
+        keys->SetValue(2 * ptId + 1, ptId);
+      }
+    });
+    this->KeyedPd = vtkSmartPointer<vtkPointData>::New();
+    this->KeyedPd->ShallowCopy(this->InPd);
+    this->KeyedPd->AddArray(keys);
+    this->PdFlags = vtkSmartPointer<vtkPointData>::New();
+    this->PdFlags->ShallowCopy(output->GetPointData());
+
+    const vtkIdType numBatches = (numCells + BatchSize - 1) / BatchSize;
+    this->Batches.clear();
+    this->Batches.resize(numBatches);
+    vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType batchId = begin; batchId < end; ++batchId)
+      {
+        this->ContourBatch(batchId, cells.Local(), cellPointIds.Local(), cellScalars.Local());
+      }
+    });
+
+    // Number the points of all batches, then map each point onto the first
+    // point it is merged with and renumber the remaining points.
+    std::vector<vtkIdType> pointOffsets(numBatches + 1, 0);
+    for (vtkIdType batchId = 0; batchId < numBatches; ++batchId)
+    {
+      vtkPoints* points = this->Batches[batchId].Points;
+      pointOffsets[batchId + 1] =
+        pointOffsets[batchId] + (points ? points->GetNumberOfPoints() : 0);
+    }
+    const vtkIdType numBatchPts = pointOffsets[numBatches];
+    std::vector<vtkIdType> mergeMap(numBatchPts);
+    vtkSMPTools::For(0, numBatchPts, [&mergeMap](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        mergeMap[ptId] = ptId;
+      }
+    });
+    if (this->MergePoints)
+    {
+      this->MergeBatchPoints(pointOffsets, mergeMap);
+    }
+    std::vector<vtkIdType> pointMap(numBatchPts);
+    vtkIdType numOutPts = 0;
+    for (vtkIdType ptId = 0; ptId < numBatchPts; ++ptId)
+    {
+      pointMap[ptId] = mergeMap[ptId] == ptId ? numOutPts++ : pointMap[mergeMap[ptId]];
+    }
+
+    // Copy the points and their data.
+    vtkPointData* outPd = output->GetPointData();
+    outPd->InterpolateAllocate(this->InPd, numOutPts);
+    const int numArrays = outPd->GetNumberOfArrays();
+    for (int i = 0; i < numArrays; ++i)
+    {
+      outPd->GetAbstractArray(i)->SetNumberOfTuples(numOutPts);
+    }
+    newPts->SetNumberOfPoints(numOutPts);
+    vtkSMPTools::For(0, numBatches, [&](vtkIdType begin, vtkIdType end) {
+      double x[3];
+      for (vtkIdType batchId = begin; batchId < end; ++batchId)
+      {
+        const Batch& batch = this->Batches[batchId];
+        for (vtkIdType i = pointOffsets[batchId]; i < pointOffsets[batchId + 1]; ++i)
+        {
+          if (mergeMap[i] != i)
+          {
+            continue;
+          }
+          const vtkIdType localId = i - pointOffsets[batchId];
+          batch.Points->GetPoint(localId, x);
+          newPts->SetPoint(pointMap[i], x);
+          // The arrays of the batches are those of the output, then the keys.
+          for (int j = 0; j < numArrays; ++j)
+          {
+            outPd->GetAbstractArray(j)->SetTuple(
+              pointMap[i], localId, batch.PointData->GetAbstractArray(j));
+          }
+        }
+      }
+    });
+    for (int i = 0; i < numArrays; ++i)
+    {
+      outPd->GetAbstractArray(i)->DataChanged();
+    }
+    output->SetPoints(newPts);
+
+    // Copy the verts, lines and polys of all batches, in batch order.
+    std::vector<vtkIdType> cellOrigins;
+    for (int type = 0; type < 3; ++type)
+    {
+      std::vector<vtkIdType> cellOffsets(numBatches + 1, 0);
+      std::vector<vtkIdType> connectivityOffsets(numBatches + 1, 0);
+      for (vtkIdType batchId = 0; batchId < numBatches; ++batchId)
+      {
+        vtkCellArray* batchCells = this->Batches[batchId].Cells[type];
+        cellOffsets[batchId + 1] =
+          cellOffsets[batchId] + (batchCells ? batchCells->GetNumberOfCells() : 0);
+        connectivityOffsets[batchId + 1] = connectivityOffsets[batchId] +
+          (batchCells ? batchCells->GetNumberOfConnectivityIds() : 0);
+      }
+      const vtkIdType numTypeCells = cellOffsets[numBatches];
+      if (numTypeCells == 0)
+      {
+        continue;
+      }
+      const vtkIdType originStart = static_cast<vtkIdType>(cellOrigins.size());
+      cellOrigins.resize(originStart + numTypeCells);
+      vtkNew<vtkIdTypeArray> offsets;
+      offsets->SetNumberOfValues(numTypeCells + 1);
+      vtkNew<vtkIdTypeArray> connectivity;
+      connectivity->SetNumberOfValues(connectivityOffsets[numBatches]);
+      vtkSMPTools::For(0, numBatches, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType batchId = begin; batchId < end; ++batchId)
+        {
+          const Batch& batch = this->Batches[batchId];
+          if (cellOffsets[batchId + 1] == cellOffsets[batchId])
+          {
+            continue;
+          }
+          batch.Cells[type]->Visit(RenumberCellsWorker(),
+            offsets->GetPointer(cellOffsets[batchId]), connectivity->GetPointer(0),
+            connectivityOffsets[batchId], pointMap.data() + pointOffsets[batchId]);
+          std::copy(batch.CellOrigins[type].begin(), batch.CellOrigins[type].end(),
+            cellOrigins.begin() + originStart + cellOffsets[batchId]);
+        }
+      });
+      offsets->SetValue(numTypeCells, connectivityOffsets[numBatches]);
+      vtkNew<vtkCellArray> outCells;
+      outCells->SetData(offsets, connectivity);
+      if (type == 0)
+      {
+        output->SetVerts(outCells);
+      }
+      else if (type == 1)
+      {
+        output->SetLines(outCells);
+      }
+      else
+      {
+        output->SetPolys(outCells);
+      }
+    }
+
+    // Cell data is copied from the input cell each output cell comes from.
+    const vtkIdType numOutCells = static_cast<vtkIdType>(cellOrigins.size());
+    vtkCellData* outCd = output->GetCellData();
+    outCd->CopyAllocate(this->InCd, numOutCells);
+    if (numOutCells > 0)
+    {
+      vtkNew<vtkIdList> cellIds;
+      cellIds->SetNumberOfIds(numOutCells);
+      std::copy(cellOrigins.begin(), cellOrigins.end(), cellIds->GetPointer(0));
+      outCd->CopyData(this->InCd, cellIds);
+    }
+
+    this->Batches.clear();
+    this->KeyedPd = nullptr;
+    this->PdFlags = nullptr;
+  }
+
+private:
+  struct Batch
+  {
+    vtkSmartPointer<vtkPoints> Points;
+    vtkSmartPointer<vtkPointData> PointData;
+    // Verts, lines and polys, and the input cell each one comes from.
+    vtkSmartPointer<vtkCellArray> Cells[3];
+    std::vector<vtkIdType> CellOrigins[3];
+    // Index of the contour value of each point.
+    std::vector<vtkIdType> PointValues;
+  };
+
+  struct CellRange
+  {
+    vtkIdType CellId;
+    double Range[2];
+  };
+
+  bool IsCrossed(const double range[2]) const
+  {
+    for (vtkIdType i = 0; i < this->NumberOfValues; ++i)
+    {
+      if (this->Values[i] >= range[0] && this->Values[i] <= range[1])
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void ComputeRange(vtkDataArray* cellScalars, double range[2]) const
+  {
+    const double* values = static_cast<vtkDoubleArray*>(cellScalars)->GetPointer(0);
+    const vtkIdType numValues =
+      cellScalars->GetNumberOfTuples() * cellScalars->GetNumberOfComponents();
+    range[0] = range[1] = values[0];
+    for (vtkIdType i = 1; i < numValues; ++i)
+    {
+      range[0] = std::min(range[0], values[i]);
+      range[1] = std::max(range[1], values[i]);
+    }
+  }
+
+  void ContourBatch(
+    vtkIdType batchId, vtkGenericCell* cell, vtkIdList* ptIds, vtkDoubleArray* cellScalars)
+  {
+    const vtkIdType begin = batchId * BatchSize;
+    const vtkIdType end = std::min(begin + BatchSize, this->Input->GetNumberOfCells());
+    cellScalars->SetNumberOfComponents(this->Scalars->GetNumberOfComponents());
+
+    // Find the cells crossed by a contour value, and their bounds.
+    std::vector<CellRange> crossedCells;
+    double bounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN,
+      VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    double x[3];
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      const int cellType = this->Input->GetCellType(cellId);
+      if (cellType >= VTK_NUMBER_OF_CELL_TYPES || this->CellTypeDimensions[cellType] == 0)
+      {
+        continue;
+      }
+      this->Input->GetCellPoints(cellId, ptIds);
+      const vtkIdType numCellPts = ptIds->GetNumberOfIds();
+      if (numCellPts == 0)
+      {
+        continue;
+      }
+      cellScalars->SetNumberOfTuples(numCellPts);
+      this->Scalars->GetTuples(ptIds, cellScalars);
+      CellRange crossed;
+      crossed.CellId = cellId;
+      this->ComputeRange(cellScalars, crossed.Range);
+      if (!this->IsCrossed(crossed.Range))
+      {
+        continue;
+      }
+      crossedCells.push_back(crossed);
+      for (vtkIdType i = 0; i < numCellPts; ++i)
+      {
+        this->Input->GetPoint(ptIds->GetId(i), x);
+        for (int j = 0; j < 3; ++j)
+        {
+          bounds[2 * j] = std::min(bounds[2 * j], x[j]);
+          bounds[2 * j + 1] = std::max(bounds[2 * j + 1], x[j]);
+        }
+      }
+    }
+    if (crossedCells.empty())
+    {
+      return;
+    }
+
+    const vtkIdType estimatedSize = static_cast<vtkIdType>(crossedCells.size());
+    Batch& batch = this->Batches[batchId];
+    batch.Points = vtkSmartPointer<vtkPoints>::New();
+    batch.Points->SetDataType(this->PointsDataType);
+    batch.PointData = vtkSmartPointer<vtkPointData>::New();
+    batch.PointData->ShallowCopy(this->PdFlags);
+    batch.PointData->InterpolateAllocate(this->KeyedPd, estimatedSize);
+    for (int type = 0; type < 3; ++type)
+    {
+      batch.Cells[type] = vtkSmartPointer<vtkCellArray>::New();
+    }
+    vtkSmartPointer<vtkIncrementalPointLocator> locator;
+    if (this->MergePoints)
+    {
+      locator = vtkSmartPointer<vtkMergePoints>::New();
+    }
+    else
+    {
+      locator = vtkSmartPointer<vtkNonMergingPointLocator>::New();
+    }
+    locator->InitPointInsertion(batch.Points, bounds, estimatedSize);
+
+    // Cell data is copied once all batches are done, from CellOrigins.
+    vtkNew<vtkCellData> noCellData;
+    vtkContourHelper helper(locator, batch.Cells[0], batch.Cells[1], batch.Cells[2],
+      this->KeyedPd, noCellData, batch.PointData, noCellData, estimatedSize,
+      this->GenerateTriangles);
+    for (const CellRange& crossed : crossedCells)
+    {
+      this->Input->GetCell(crossed.CellId, cell);
+      this->Input->SetCellOrderAndRationalWeights(crossed.CellId, cell);
+      cellScalars->SetNumberOfTuples(cell->GetNumberOfPoints());
+      this->Scalars->GetTuples(cell->GetPointIds(), cellScalars);
+      for (vtkIdType i = 0; i < this->NumberOfValues; ++i)
+      {
+        if (this->Values[i] < crossed.Range[0] || this->Values[i] > crossed.Range[1])
+        {
+          continue;
+        }
+        helper.Contour(cell, this->Values[i], cellScalars, crossed.CellId);
+        batch.PointValues.resize(batch.Points->GetNumberOfPoints(), i);
+        for (int type = 0; type < 3; ++type)
+        {
+          batch.CellOrigins[type].resize(batch.Cells[type]->GetNumberOfCells(), crossed.CellId);
+        }
+      }
+    }
+  }
+
+  // Maps each point of the batches onto the first point lying on the same
+  // input edge for the same contour value or, for points without an edge, onto
+  // the first point without an edge with the same coordinates.
+  void MergeBatchPoints(
+    const std::vector<vtkIdType>& pointOffsets, std::vector<vtkIdType>& mergeMap) const
+  {
+    typedef vtkStaticEdgeLocatorTemplate<vtkIdType, vtkIdType> EdgeLocatorType;
+    typedef EdgeLocatorType::EdgeTupleType EdgeTupleType;
+    struct LoosePoint
+    {
+      double X[3];
+      vtkIdType Id;
+      bool operator<(const LoosePoint& other) const
+      {
+        return std::lexicographical_compare(this->X, this->X + 3, other.X, other.X + 3) ||
+          (std::equal(this->X, this->X + 3, other.X) && this->Id < other.Id);
+      }
+    };
+
+    // Count the points with and without an edge in each batch.
+    const vtkIdType numBatches = static_cast<vtkIdType>(this->Batches.size());
+    std::vector<vtkIdType> edgeOffsets(numBatches + 1, 0);
+    std::vector<vtkIdType> looseOffsets(numBatches + 1, 0);
+    vtkSMPTools::For(0, numBatches, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType batchId = begin; batchId < end; ++batchId)
+      {
+        vtkIdTypeArray* keys = this->GetKeys(batchId);
+        const vtkIdType numBatchPts = pointOffsets[batchId + 1] - pointOffsets[batchId];
+        for (vtkIdType i = 0; i < numBatchPts; ++i)
+        {
+          ++(keys && keys->GetValue(2 * i) >= 0 ? edgeOffsets : looseOffsets)[batchId + 1];
+        }
+      }
+    });
+    for (vtkIdType batchId = 0; batchId < numBatches; ++batchId)
+    {
+      edgeOffsets[batchId + 1] += edgeOffsets[batchId];
+      looseOffsets[batchId + 1] += looseOffsets[batchId];
+    }
+
+    // The contour value is folded into the edge so that the points of
+    // different values on the same edge are not merged.
+    std::vector<EdgeTupleType> edges(edgeOffsets[numBatches]);
+    std::vector<LoosePoint> loosePoints(looseOffsets[numBatches]);
+    const vtkIdType numValues = this->NumberOfValues;
+    vtkSMPTools::For(0, numBatches, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType batchId = begin; batchId < end; ++batchId)
+      {
+        const Batch& batch = this->Batches[batchId];
+        vtkIdTypeArray* keys = this->GetKeys(batchId);
+        vtkIdType edgeId = edgeOffsets[batchId];
+        vtkIdType looseId = looseOffsets[batchId];
+        const vtkIdType numBatchPts = pointOffsets[batchId + 1] - pointOffsets[batchId];
+        for (vtkIdType i = 0; i < numBatchPts; ++i)
+        {
+          const vtkIdType* key = keys ? keys->GetPointer(2 * i) : nullptr;
+          const vtkIdType value = batch.PointValues[i];
+          if (key && key[0] >= 0)
+          {
+            edges[edgeId++] = EdgeTupleType(
+              key[0] * numValues + value, key[1] * numValues + value, pointOffsets[batchId] + i);
+          }
+          else
+          {
+            LoosePoint& point = loosePoints[looseId++];
+            batch.Points->GetPoint(i, point.X);
+            point.Id = pointOffsets[batchId] + i;
+          }
+        }
+      }
+    });
+
+    // Groups of points on the same edge are merged onto their lowest id.
+    EdgeLocatorType locator;
+    vtkIdType numUniqueEdges;
+    const vtkIdType* groups =
+      locator.MergeEdges(static_cast<vtkIdType>(edges.size()), edges.data(), numUniqueEdges);
+    vtkSMPTools::For(0, numUniqueEdges, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType group = begin; group < end; ++group)
+      {
+        vtkIdType first = edges[groups[group]].Data;
+        for (vtkIdType i = groups[group] + 1; i < groups[group + 1]; ++i)
+        {
+          first = std::min(first, edges[i].Data);
+        }
+        for (vtkIdType i = groups[group]; i < groups[group + 1]; ++i)
+        {
+          mergeMap[edges[i].Data] = first;
+        }
+      }
+    });
+
+    vtkSMPTools::Sort(loosePoints.begin(), loosePoints.end());
+    for (size_t i = 1; i < loosePoints.size(); ++i)
+    {
+      const LoosePoint& previous = loosePoints[i - 1];
+      if (std::equal(previous.X, previous.X + 3, loosePoints[i].X))
+      {
+        mergeMap[loosePoints[i].Id] = mergeMap[previous.Id];
+      }
+    }
+  }
+
+  vtkIdTypeArray* GetKeys(vtkIdType batchId) const
+  {
+    vtkPointData* pd = this->Batches[batchId].PointData;
+    return pd ? vtkIdTypeArray::SafeDownCast(pd->GetAbstractArray("vtkContourEdgeKeys"))
+              : nullptr;
+  }
+
+  unsigned char CellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  int PointsDataType = VTK_FLOAT;
+  vtkSmartPointer<vtkPointData> KeyedPd;
+  vtkSmartPointer<vtkPointData> PdFlags;
+  std::vector<Batch> Batches;
+};
+
+} // anonymous namespace
+
+#endif
+// VTK-HeaderTest-Exclude: vtkContourCellsInternal.h
@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkContourCellsInternal.h"
 #include "vtkContourHelper.h"
 #include "vtkContourValues.h"
 #include "vtkCutter.h"
@@ -38,6 +39,7 @@
 #include "vtkSimpleScalarTree.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
 
 #include <algorithm>
@@ -182,6 +184,31 @@ void vtkContourGridExecute(vtkContourGrid* self, vtkDataSet* input, vtkPolyData*
     newPts->SetDataType(VTK_DOUBLE);
   }
 
+  // Unstructured grids are contoured concurrently unless a scalar tree or a
+  // locator merging points within a tolerance is used.
+  vtkUnstructuredGrid* ugrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (ugrid && !useScalarTree &&
+    (locator->IsA("vtkMergePoints") || locator->IsA("vtkNonMergingPointLocator")))
+  {
+    if (!computeScalars)
+    {
+      outPd->CopyScalarsOff();
+    }
+    UnstructuredGridContourer contourer;
+    contourer.Input = ugrid;
+    contourer.Scalars = inScalars;
+    contourer.InPd = inPd;
+    contourer.InCd = inCd;
+    contourer.Values = values;
+    contourer.NumberOfValues = numContours;
+    contourer.MergePoints = !locator->IsA("vtkNonMergingPointLocator");
+    contourer.GenerateTriangles = generateTriangles;
+    contourer.Execute(newPts, output);
+    newPts->Delete();
+    self->UpdateProgress(1.0);
+    return;
+  }
+
   newPts->Allocate(estimatedSize, estimatedSize);
   newVerts = vtkCellArray::New();
   newVerts->AllocateEstimate(estimatedSize, 1);
@@ -34,6 +34,15 @@
  * contours are being extracted. If you want to use a scalar tree,
  * invoke the method UseScalarTreeOn().
  *
+ * When the input is a vtkUnstructuredGrid and no scalar tree is used, the
+ * cells are contoured concurrently with vtkSMPTools, for any cell type
+ * (including higher-order cells and polyhedra). Points on the same edge are
+ * merged regardless of the number of threads, so the output is
+ * deterministic. The output points and cells are ordered like the input
+ * cells, verts first, then lines and polys. A locator merging points within
+ * a tolerance, such as vtkPointLocator, makes the filter fall back to serial
+ * execution.
+ *
  * @warning
  * If the input vtkUnstructuredGrid contains 3D linear cells, the class
  * vtkContour3DLinearGrid is much faster and may be preferred in certain
@@ -18,6 +18,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkContourCellsInternal.h"
 #include "vtkContourHelper.h"
 #include "vtkContourValues.h"
 #include "vtkDataSet.h"
@@ -45,6 +46,7 @@
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
 
 #include <algorithm>
@@ -779,13 +781,6 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet* input, vtkPolyData* output)
   {
     newPoints->SetDataType(VTK_DOUBLE);
   }
-  newPoints->Allocate(estimatedSize, estimatedSize / 2);
-  newVerts = vtkCellArray::New();
-  newVerts->AllocateEstimate(estimatedSize, 1);
-  newLines = vtkCellArray::New();
-  newLines->AllocateEstimate(estimatedSize, 2);
-  newPolys = vtkCellArray::New();
-  newPolys->AllocateEstimate(estimatedSize, 4);
   cutScalars = vtkDoubleArray::New();
   cutScalars->SetNumberOfTuples(numPts);
 
@@ -801,15 +796,12 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet* input, vtkPolyData* output)
     inPD = input->GetPointData();
   }
   outPD = output->GetPointData();
-  outPD->InterpolateAllocate(inPD, estimatedSize, estimatedSize / 2);
-  outCD->CopyAllocate(inCD, estimatedSize, estimatedSize / 2);
 
   // locator used to merge potentially duplicate points
   if (this->Locator == nullptr)
   {
     this->CreateDefaultLocator();
   }
-  this->Locator->InitPointInsertion(newPoints, input->GetBounds());
 
   // Loop over all points evaluating scalar function at each point
   if (inputPointSet)
@@ -818,6 +810,43 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet* input, vtkPolyData* output)
     this->CutFunction->FunctionValue(dataArrayInput, cutScalars);
   }
 
+  // Unstructured grids are cut concurrently when sorting by value, unless a
+  // locator merging points within a tolerance is used.
+  vtkUnstructuredGrid* ugrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (ugrid && this->SortBy == VTK_SORT_BY_VALUE &&
+    (this->Locator->IsA("vtkMergePoints") || this->Locator->IsA("vtkNonMergingPointLocator")))
+  {
+    UnstructuredGridContourer contourer;
+    contourer.Input = ugrid;
+    contourer.Scalars = cutScalars;
+    contourer.InPd = inPD;
+    contourer.InCd = inCD;
+    contourer.Values = contourValues;
+    contourer.NumberOfValues = numContours;
+    contourer.MergePoints = !this->Locator->IsA("vtkNonMergingPointLocator");
+    contourer.GenerateTriangles = this->GenerateTriangles != 0;
+    contourer.Execute(newPoints, output);
+    newPoints->Delete();
+    cutScalars->Delete();
+    if (this->GenerateCutScalars)
+    {
+      inPD->Delete();
+    }
+    this->UpdateProgress(1.0);
+    return;
+  }
+
+  newPoints->Allocate(estimatedSize, estimatedSize / 2);
+  newVerts = vtkCellArray::New();
+  newVerts->AllocateEstimate(estimatedSize, 1);
+  newLines = vtkCellArray::New();
+  newLines->AllocateEstimate(estimatedSize, 2);
+  newPolys = vtkCellArray::New();
+  newPolys->AllocateEstimate(estimatedSize, 4);
+  outPD->InterpolateAllocate(inPD, estimatedSize, estimatedSize / 2);
+  outCD->CopyAllocate(inCD, estimatedSize, estimatedSize / 2);
+  this->Locator->InitPointInsertion(newPoints, input->GetBounds());
+
   vtkSmartPointer<vtkCellIterator> cellIter =
     vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
   vtkNew<vtkGenericCell> cell;
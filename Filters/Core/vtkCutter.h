@@ -42,6 +42,12 @@
  * it's specialized for planes and it's faster because it's multithreaded, and in some
  * cases also algorithmically faster.
  *
+ * Unstructured grids that cannot be handled by vtkPlaneCutter are cut
+ * concurrently with vtkSMPTools when sorting by value, for any cell type.
+ * Points on the same edge are merged regardless of the number of threads, so
+ * the output is deterministic. A locator merging points within a tolerance,
+ * such as vtkPointLocator, makes the filter fall back to serial execution.
+ *
  * @sa
  * vtkImplicitFunction vtkClipPolyData vtkPlaneCutter
  */
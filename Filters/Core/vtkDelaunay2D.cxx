@@ -13,6 +13,7 @@
 
 =========================================================================*/
 #include "vtkDelaunay2D.h"
+#include "vtkDelaunayInsertionOrder.h"
 
 #include "vtkAbstractTransform.h"
 #include "vtkCellArray.h"
@@ -44,6 +45,7 @@ vtkDelaunay2D::vtkDelaunay2D()
   this->BoundingTriangulation = 0;
   this->Offset = 1.0;
   this->RandomPointInsertion = 0;
+  this->SpatialPointInsertion = 0;
   this->Transform = nullptr;
   this->ProjectionPlaneMode = VTK_DELAUNAY_XY_PLANE;
 
@@ -474,6 +476,13 @@ int vtkDelaunay2D::RequestData(vtkInformation* vtkNotUsed(request),
   this->BoundingRadius2 = 4 * radius * radius; // use (2*r)**2
   tol *= this->Tolerance;
 
+  // Sort the points spatially before the bounding points are added.
+  std::vector<vtkIdType> insertionOrder;
+  if (this->SpatialPointInsertion)
+  {
+    ComputeInsertionOrder(points, numPoints, 2, bounds, insertionOrder);
+  }
+
   // Add the eight bounding points to the end of the points list.
   for (ptId = 0; ptId < 8; ptId++)
   {
@@ -523,12 +532,19 @@ int vtkDelaunay2D::RequestData(vtkInformation* vtkNotUsed(request),
   // neighboring triangles for Delaunay criterion. Triangles that do not
   // satisfy criterion have their edges swapped. This continues recursively
   // until all triangles have been shown to be Delaunay. The points may be
-  // traversed in given order, or pseudo-random order.
+  // traversed in given order, pseudo-random order, or spatially sorted order.
   //
   GCDTraversal gcdIter(numPoints);
-  for (auto idx = 0; idx < numPoints; idx++)
+  for (vtkIdType idx = 0; idx < numPoints; idx++)
   {
-    ptId = (this->RandomPointInsertion ? gcdIter.GetPointId(idx) : idx);
+    if (this->SpatialPointInsertion)
+    {
+      ptId = insertionOrder[idx];
+    }
+    else
+    {
+      ptId = (this->RandomPointInsertion ? gcdIter.GetPointId(idx) : idx);
+    }
     this->GetPoint(ptId, x);
     nei[0] = (-1); // where we are coming from...nowhere initially
 
@@ -623,10 +639,10 @@ int vtkDelaunay2D::RequestData(vtkInformation* vtkNotUsed(request),
       tri[0] = 0; // no triangle found
     }
 
-    if (!(ptId % 1000))
+    if (!(idx % 1000))
     {
       vtkDebugMacro(<< "point #" << ptId);
-      this->UpdateProgress(static_cast<double>(ptId) / numPoints);
+      this->UpdateProgress(static_cast<double>(idx) / numPoints);
       if (this->GetAbortExecute())
       {
         break;
@@ -1650,5 +1666,7 @@ void vtkDelaunay2D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Tolerance: " << this->Tolerance << "\n";
   os << indent << "Offset: " << this->Offset << "\n";
   os << indent << "Random Point Insertion: " << (this->RandomPointInsertion ? "On" : "Off") << "\n";
+  os << indent << "Spatial Point Insertion: " << (this->SpatialPointInsertion ? "On" : "Off")
+     << "\n";
   os << indent << "Bounding Triangulation: " << (this->BoundingTriangulation ? "On\n" : "Off\n");
 }
@@ -266,6 +266,21 @@ public:
   vtkBooleanMacro(RandomPointInsertion, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Indicate whether to insert the points in a spatially sorted order. The
+   * points are then inserted in rounds of doubling size, each round sorted
+   * along a Hilbert curve, so that the search for the triangle containing
+   * each point stays short. This is much faster for large, unorganized point
+   * sets. The order is computed with vtkSMPTools. When on, this option takes
+   * precedence over RandomPointInsertion. Degenerate point sets may be
+   * triangulated differently than in given order.
+   */
+  vtkSetMacro(SpatialPointInsertion, vtkTypeBool);
+  vtkGetMacro(SpatialPointInsertion, vtkTypeBool);
+  vtkBooleanMacro(SpatialPointInsertion, vtkTypeBool);
+  ///@}
+
 protected:
   vtkDelaunay2D();
 
@@ -276,6 +291,7 @@ protected:
   vtkTypeBool BoundingTriangulation;
   double Offset;
   vtkTypeBool RandomPointInsertion;
+  vtkTypeBool SpatialPointInsertion;
 
   // Transform input points (if necessary)
   vtkSmartPointer<vtkAbstractTransform> Transform;
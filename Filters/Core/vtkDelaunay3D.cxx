@@ -15,6 +15,7 @@
 
 #include "vtkDelaunay3D.h"
 
+#include "vtkDelaunayInsertionOrder.h"
 #include "vtkEdgeTable.h"
 #include "vtkExecutive.h"
 #include "vtkIncrementalPointLocator.h"
@@ -29,17 +30,43 @@
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkDelaunay3D);
 
 //------------------------------------------------------------------------------
-// Structure used to represent sphere around tetrahedron
+// Structure used to represent sphere around tetrahedron, and its face
+// neighbors. Neighbor i lies across face i as ordered in FindEnclosingFaces():
+// (0,1,2), (1,3,2), (2,3,0) and (3,1,0), so that it is the face opposite to
+// point (i+3)%4. A negative id means there is no neighbor.
 //
 typedef struct
 {
   double r2;
   double center[3];
+  vtkIdType neighbors[4];
 } vtkDelaunayTetra;
 
+// Edge of a face of the insertion polyhedron, used to pair the faces of the
+// new tetras that share it.
+struct vtkDelaunayFaceEdge
+{
+  vtkIdType p1;
+  vtkIdType p2;
+  vtkIdType tetraId;
+  int face;
+
+  bool operator<(const vtkDelaunayFaceEdge& other) const
+  {
+    return this->p1 < other.p1 || (this->p1 == other.p1 && this->p2 < other.p2);
+  }
+  bool operator==(const vtkDelaunayFaceEdge& other) const
+  {
+    return this->p1 == other.p1 && this->p2 == other.p2;
+  }
+};
+
 // Special classes for manipulating tetra array
 //
 class vtkTetraArray
@@ -51,6 +78,8 @@ public:
   void InsertTetra(vtkIdType tetraId, double r2, double center[3]);
   vtkDelaunayTetra* Resize(vtkIdType sz); // reallocates data
 
+  std::vector<vtkDelaunayFaceEdge> Edges; // work space used in InsertPoint
+
 protected:
   vtkDelaunayTetra* Array; // pointer to data
   vtkIdType MaxId;         // maximum index inserted thus far
@@ -138,6 +167,7 @@ vtkDelaunay3D::vtkDelaunay3D()
   this->BoundingTriangulation = 0;
   this->Offset = 2.5;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->SpatialPointInsertion = 0;
   this->Locator = nullptr;
   this->TetraArray = nullptr;
 
@@ -148,6 +178,8 @@ vtkDelaunay3D::vtkDelaunay3D()
   this->Faces->Allocate(15);
   this->CheckedTetras = vtkIdList::New();
   this->CheckedTetras->Allocate(25);
+  this->FaceNeighbors = vtkIdList::New();
+  this->FaceNeighbors->Allocate(5);
 }
 
 //------------------------------------------------------------------------------
@@ -163,6 +195,7 @@ vtkDelaunay3D::~vtkDelaunay3D()
   this->Tetras->Delete();
   this->Faces->Delete();
   this->CheckedTetras->Delete();
+  this->FaceNeighbors->Delete();
 }
 
 //------------------------------------------------------------------------------
@@ -170,6 +203,23 @@ vtkDelaunay3D::~vtkDelaunay3D()
 static int GetTetraFaceNeighbor(vtkUnstructuredGrid* Mesh, vtkIdType tetraId, vtkIdType p1,
   vtkIdType p2, vtkIdType p3, vtkIdType& nei);
 
+// Faces of a tetra, ordered like the neighbors of vtkDelaunayTetra.
+static const int TetraFaces[4][3] = { { 0, 1, 2 }, { 1, 3, 2 }, { 2, 3, 0 }, { 3, 1, 0 } };
+
+// Find the neighbor across a face of a tetra from the cell links.
+static vtkIdType FindTetraFaceNeighbor(vtkUnstructuredGrid* Mesh, vtkIdType tetraId, int face)
+{
+  vtkIdType npts, nei;
+  const vtkIdType* pts;
+  Mesh->GetCellPoints(tetraId, npts, pts);
+  if (GetTetraFaceNeighbor(Mesh, tetraId, pts[TetraFaces[face][0]], pts[TetraFaces[face][1]],
+        pts[TetraFaces[face][2]], nei))
+  {
+    return nei;
+  }
+  return -1;
+}
+
 //------------------------------------------------------------------------------
 // Find all faces that enclose a point. (Enclosure means not satisfying
 // Delaunay criterion.) This method works in two distinct parts. First, the
@@ -274,7 +324,8 @@ vtkIdType vtkDelaunay3D::FindEnclosingFaces(double x[3], vtkUnstructuredGrid* Me
           break;
       }
 
-      hasNei = GetTetraFaceNeighbor(Mesh, tetraId, p1, p2, p3, nei);
+      nei = this->TetraArray->GetTetra(tetraId)->neighbors[j];
+      hasNei = (nei >= 0);
 
       // if a boundary face or an enclosing face
       if (!hasNei) // a boundary face
@@ -310,6 +361,7 @@ vtkIdType vtkDelaunay3D::FindEnclosingFaces(double x[3], vtkUnstructuredGrid* Me
         faces->InsertNextId(p1);
         faces->InsertNextId(p2);
         faces->InsertNextId(p3);
+        this->FaceNeighbors->InsertNextId(hasNei ? nei : -1);
       }
 
     } // for each tetra face
@@ -335,7 +387,8 @@ int vtkDelaunay3D::FindTetra(vtkUnstructuredGrid* Mesh, double x[3], vtkIdType t
 {
   double p[4][3];
   double b[4];
-  vtkTetra* tetra;
+  vtkIdType npts;
+  const vtkIdType* tetraPts;
   int neg = 0;
   int j, numNeg;
   double negValue;
@@ -346,10 +399,11 @@ int vtkDelaunay3D::FindTetra(vtkUnstructuredGrid* Mesh, double x[3], vtkIdType t
     return -1;
   }
 
-  tetra = static_cast<vtkTetra*>(Mesh->GetCell(tetraId));
+  Mesh->GetCellPoints(tetraId, npts, tetraPts);
+  vtkPoints* points = Mesh->GetPoints();
   for (j = 0; j < 4; j++) // load the points
   {
-    tetra->Points->GetPoint(j, p[j]);
+    points->GetPoint(tetraPts[j], p[j]);
   }
 
   vtkTetra::BarycentricCoords(x, p[0], p[1], p[2], p[3], b);
@@ -374,33 +428,10 @@ int vtkDelaunay3D::FindTetra(vtkUnstructuredGrid* Mesh, double x[3], vtkIdType t
     return tetraId;
   }
 
-  // okay, march towards the most negative direction
-  int p1 = 0, p2 = 0, p3 = 0;
-  switch (neg)
-  {
-    case 0:
-      p1 = tetra->PointIds->GetId(1);
-      p2 = tetra->PointIds->GetId(2);
-      p3 = tetra->PointIds->GetId(3);
-      break;
-    case 1:
-      p1 = tetra->PointIds->GetId(0);
-      p2 = tetra->PointIds->GetId(2);
-      p3 = tetra->PointIds->GetId(3);
-      break;
-    case 2:
-      p1 = tetra->PointIds->GetId(0);
-      p2 = tetra->PointIds->GetId(1);
-      p3 = tetra->PointIds->GetId(3);
-      break;
-    case 3:
-      p1 = tetra->PointIds->GetId(0);
-      p2 = tetra->PointIds->GetId(1);
-      p3 = tetra->PointIds->GetId(2);
-      break;
-  }
-  vtkIdType nei;
-  if (GetTetraFaceNeighbor(Mesh, tetraId, p1, p2, p3, nei))
+  // okay, march towards the most negative direction, through the face
+  // opposite to the point
+  vtkIdType nei = this->TetraArray->GetTetra(tetraId)->neighbors[(neg + 1) % 4];
+  if (nei >= 0)
   {
     return this->FindTetra(Mesh, x, nei, ++depth);
   }
@@ -484,22 +515,31 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 
   points->Allocate(numPoints + 6);
 
-  Mesh = this->InitPointInsertion(center, this->Offset * tol, numPoints, points);
+  Mesh =
+    this->InitPointInsertion(center, this->Offset * tol, numPoints, points, input->GetBounds());
+
+  // The points are inserted in given order, or spatially sorted order.
+  std::vector<vtkIdType> insertionOrder;
+  if (this->SpatialPointInsertion)
+  {
+    ComputeInsertionOrder(inPoints, numPoints, 3, input->GetBounds(), insertionOrder);
+  }
 
   // Insert each point into triangulation. Points laying "inside"
   // of tetra cause tetra to be deleted, leaving a void with bounding
   // faces. Combination of point and each face is used to form new
   // tetrahedra.
-  for (ptId = 0; ptId < numPoints; ptId++)
+  for (vtkIdType idx = 0; idx < numPoints; idx++)
   {
+    ptId = (this->SpatialPointInsertion ? insertionOrder[idx] : idx);
     inPoints->GetPoint(ptId, x);
 
     this->InsertPoint(Mesh, points, ptId, x, holeTetras);
 
-    if (!(ptId % 250))
+    if (!(idx % 250))
     {
       vtkDebugMacro(<< "point #" << ptId);
-      this->UpdateProgress(static_cast<double>(ptId) / numPoints);
+      this->UpdateProgress(static_cast<double>(idx) / numPoints);
       if (this->GetAbortExecute())
       {
         break;
@@ -776,8 +816,8 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 // Note: This initialization method places points forming bounding octahedron
 // at the end of the Mesh's point list. That is, InsertPoint() assumes that
 // you will be inserting points between (0,numPtsToInsert-1).
-vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(
-  double center[3], double length, vtkIdType numPtsToInsert, vtkPoints*& points)
+vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(double center[3], double length,
+  vtkIdType numPtsToInsert, vtkPoints*& points, const double pointBounds[6])
 {
   double x[3], bounds[6];
   vtkIdType tetraId;
@@ -803,7 +843,17 @@ vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(
   {
     this->CreateDefaultLocator();
   }
-  this->Locator->InitPointInsertion(points, bounds);
+  if (pointBounds)
+  {
+    // The bounding octahedron is far larger than the points to insert. Fit
+    // the locator to the points instead: the octahedron points then fall in
+    // its boundary buckets.
+    this->Locator->InitPointInsertion(points, pointBounds, numPtsToInsert);
+  }
+  else
+  {
+    this->Locator->InitPointInsertion(points, bounds);
+  }
 
   // create bounding octahedron: 6 points & 4 tetra
   x[0] = center[0] - length;
@@ -875,6 +925,15 @@ vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(
   points->Delete();
   Mesh->BuildLinks();
 
+  for (tetraId = 0; tetraId < 4; tetraId++)
+  {
+    vtkDelaunayTetra* tetra = this->TetraArray->GetTetra(tetraId);
+    for (int i = 0; i < 4; i++)
+    {
+      tetra->neighbors[i] = FindTetraFaceNeighbor(Mesh, tetraId, i);
+    }
+  }
+
   // Keep track of change in references to points
   this->References = new int[numPtsToInsert + 6];
   memset(this->References, 0, (numPtsToInsert + 6) * sizeof(int));
@@ -901,6 +960,7 @@ void vtkDelaunay3D::InsertPoint(
 
   this->Tetras->Reset();
   this->Faces->Reset();
+  this->FaceNeighbors->Reset();
 
   // Find faces containing point. (Faces are found by deleting
   // one or more tetrahedra "containing" point.) Tetrahedron contain point
@@ -937,6 +997,7 @@ void vtkDelaunay3D::InsertPoint(
       else
       {
         tetraId = Mesh->InsertNextCell(VTK_TETRA, 4, nodes);
+        this->Tetras->InsertNextId(tetraId);
       }
 
       // Update data structures
@@ -955,6 +1016,8 @@ void vtkDelaunay3D::InsertPoint(
 
     } // for each face
 
+    this->UpdateFaceNeighbors(Mesh, numFaces);
+
     // Sometimes there are more tetras deleted than created. These
     // have to be accounted for because they leave a "hole" in the
     // data structure. Keep track of them here...mark them deleted later.
@@ -965,6 +1028,82 @@ void vtkDelaunay3D::InsertPoint(
   } // if enclosing faces found
 }
 
+//------------------------------------------------------------------------------
+// Connect the tetras created by InsertPoint() to their face neighbors. Face 0
+// of a new tetra is a face of the insertion polyhedron, across which lies the
+// tetra found by FindEnclosingFaces(). The other faces use the inserted point
+// and pair up through the edges of the polyhedron.
+void vtkDelaunay3D::UpdateFaceNeighbors(vtkUnstructuredGrid* Mesh, vtkIdType numFaces)
+{
+  std::vector<vtkDelaunayFaceEdge>& edges = this->TetraArray->Edges;
+  edges.clear();
+  vtkIdType npts, tetraId, nei;
+  const vtkIdType *tetraPts, *neiPts;
+  int i, j;
+
+  for (vtkIdType tetraNum = 0; tetraNum < numFaces; tetraNum++)
+  {
+    tetraId = this->Tetras->GetId(tetraNum);
+    Mesh->GetCellPoints(tetraId, npts, tetraPts);
+
+    nei = this->FaceNeighbors->GetId(tetraNum);
+    this->TetraArray->GetTetra(tetraId)->neighbors[0] = nei;
+    if (nei >= 0)
+    {
+      // The shared face is opposite to the neighbor point not on it.
+      Mesh->GetCellPoints(nei, npts, neiPts);
+      for (i = 0; i < 4; i++)
+      {
+        if (neiPts[i] != tetraPts[0] && neiPts[i] != tetraPts[1] && neiPts[i] != tetraPts[2])
+        {
+          this->TetraArray->GetTetra(nei)->neighbors[(i + 1) % 4] = tetraId;
+          break;
+        }
+      }
+    }
+
+    // Faces 1, 2 and 3 contain the inserted point and the polyhedron edges
+    // (1,2), (2,0) and (0,1).
+    for (j = 1; j < 4; j++)
+    {
+      vtkDelaunayFaceEdge edge;
+      edge.p1 = std::min(tetraPts[j % 3], tetraPts[(j + 1) % 3]);
+      edge.p2 = std::max(tetraPts[j % 3], tetraPts[(j + 1) % 3]);
+      edge.tetraId = tetraId;
+      edge.face = j;
+      edges.push_back(edge);
+    }
+  }
+
+  std::sort(edges.begin(), edges.end());
+  size_t numEdges = edges.size();
+  for (size_t e = 0; e < numEdges;)
+  {
+    size_t end = e + 1;
+    while (end < numEdges && edges[end] == edges[e])
+    {
+      end++;
+    }
+    if (end - e == 2)
+    {
+      this->TetraArray->GetTetra(edges[e].tetraId)->neighbors[edges[e].face] =
+        edges[e + 1].tetraId;
+      this->TetraArray->GetTetra(edges[e + 1].tetraId)->neighbors[edges[e + 1].face] =
+        edges[e].tetraId;
+    }
+    else
+    {
+      // The insertion polyhedron is degenerate, use the cell links.
+      for (; e < end; e++)
+      {
+        this->TetraArray->GetTetra(edges[e].tetraId)->neighbors[edges[e].face] =
+          FindTetraFaceNeighbor(Mesh, edges[e].tetraId, edges[e].face);
+      }
+    }
+    e = end;
+  }
+}
+
 //------------------------------------------------------------------------------
 // Specify a spatial locator for merging points. By default,
 // an instance of vtkMergePoints is used.
@@ -1051,6 +1190,7 @@ void vtkDelaunay3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Tolerance: " << this->Tolerance << "\n";
   os << indent << "Offset: " << this->Offset << "\n";
   os << indent << "Bounding Triangulation: " << (this->BoundingTriangulation ? "On\n" : "Off\n");
+  os << indent << "Spatial Point Insertion: " << (this->SpatialPointInsertion ? "On\n" : "Off\n");
 
   if (this->Locator)
   {
@@ -197,6 +197,19 @@ public:
   vtkBooleanMacro(BoundingTriangulation, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Indicate whether to insert the points in given order, or in a spatially
+   * sorted order. The points are then inserted in rounds of doubling size,
+   * each round sorted along a Hilbert curve, which improves memory locality
+   * for large point sets. The order is computed with vtkSMPTools. Degenerate
+   * point sets may be triangulated differently than in given order.
+   */
+  vtkSetMacro(SpatialPointInsertion, vtkTypeBool);
+  vtkGetMacro(SpatialPointInsertion, vtkTypeBool);
+  vtkBooleanMacro(SpatialPointInsertion, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Set / get a spatial locator for merging points. By default,
@@ -222,10 +235,12 @@ public:
    * necessary. You must delete (with Delete()) the mesh when done.
    * Note: This initialization method places points forming bounding octahedron
    * at the end of the Mesh's point list. That is, InsertPoint() assumes that
-   * you will be inserting points between (0,numPtsToInsert-1).
+   * you will be inserting points between (0,numPtsToInsert-1). If the bounds
+   * of the points to insert are given, the locator is fitted to them, which
+   * speeds up the search of inserted points.
    */
-  vtkUnstructuredGrid* InitPointInsertion(
-    double center[3], double length, vtkIdType numPts, vtkPoints*& points);
+  vtkUnstructuredGrid* InitPointInsertion(double center[3], double length, vtkIdType numPts,
+    vtkPoints*& points, const double pointBounds[6] = nullptr);
 
   /**
    * This is a helper method used with InitPointInsertion() to create
@@ -277,6 +292,7 @@ protected:
   double Tolerance;
   vtkTypeBool BoundingTriangulation;
   double Offset;
+  vtkTypeBool SpatialPointInsertion;
   int OutputPointsPrecision;
 
   vtkIncrementalPointLocator* Locator; // help locate points faster
@@ -294,6 +310,7 @@ protected:
 
   vtkIdType FindEnclosingFaces(double x[3], vtkUnstructuredGrid* Mesh, vtkIdList* tetras,
     vtkIdList* faces, vtkIncrementalPointLocator* Locator);
+  void UpdateFaceNeighbors(vtkUnstructuredGrid* Mesh, vtkIdType numFaces);
 
   int FillInputPortInformation(int, vtkInformation*) override;
 
@@ -301,6 +318,7 @@ private:                    // members added for performance
   vtkIdList* Tetras;        // used in InsertPoint
   vtkIdList* Faces;         // used in InsertPoint
   vtkIdList* CheckedTetras; // used by InsertPoint
+  vtkIdList* FaceNeighbors; // used in InsertPoint
 
 private:
   vtkDelaunay3D(const vtkDelaunay3D&) = delete;
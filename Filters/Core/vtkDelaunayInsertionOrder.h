@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDelaunayInsertionOrder.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkDelaunayInsertionOrder
+ * @brief   spatially coherent point insertion order for Delaunay filters
+ *
+ * vtkDelaunayInsertionOrder computes a biased randomized insertion order
+ * (BRIO) of points: the points are spread over rounds of doubling size
+ * with a deterministic hash of their ids, and the points of each round are
+ * sorted along a Hilbert curve. Consecutive points are then close to each
+ * other, which keeps the walks through the triangulation short, while the
+ * rounds keep the triangulation well shaped as it grows. The keys are
+ * computed and sorted with vtkSMPTools, and the order does not depend on the
+ * number of threads.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkDelaunay2D vtkDelaunay3D
+ */
+
+#ifndef vtkDelaunayInsertionOrder_h
+#define vtkDelaunayInsertionOrder_h
+
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+// Hilbert index of integer coordinates of the given number of bits, using
+// Skilling's transposition ("Programming the Hilbert curve", 2004).
+inline uint64_t HilbertIndex(uint32_t X[3], int dim, int bits)
+{
+  const uint32_t M = 1u << (bits - 1);
+  uint32_t t;
+  for (uint32_t Q = M; Q > 1; Q >>= 1)
+  {
+    const uint32_t P = Q - 1;
+    for (int i = 0; i < dim; ++i)
+    {
+      if (X[i] & Q)
+      {
+        X[0] ^= P;
+      }
+      else
+      {
+        t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+  for (int i = 1; i < dim; ++i)
+  {
+    X[i] ^= X[i - 1];
+  }
+  t = 0;
+  for (uint32_t Q = M; Q > 1; Q >>= 1)
+  {
+    if (X[dim - 1] & Q)
+    {
+      t ^= Q - 1;
+    }
+  }
+  uint64_t index = 0;
+  for (int b = bits - 1; b >= 0; --b)
+  {
+    for (int i = 0; i < dim; ++i)
+    {
+      index = (index << 1) | (((X[i] ^ t) >> b) & 1u);
+    }
+  }
+  return index;
+}
+
+// Round of a point id in the biased randomized insertion order: the last
+// round holds about half the points, the one before a quarter, and so on.
+inline uint64_t InsertionRound(vtkIdType ptId, uint64_t numRounds)
+{
+  uint64_t h = static_cast<uint64_t>(ptId) + 0x9e3779b97f4a7c15ull;
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  uint64_t zeros = 0;
+  while (zeros < numRounds && !(h & 1))
+  {
+    h >>= 1;
+    ++zeros;
+  }
+  return numRounds - zeros;
+}
+
+// Compute the insertion order of the first numPts points. Only the first dim
+// coordinates are used; bounds are the bounds of the points.
+void ComputeInsertionOrder(vtkPoints* points, vtkIdType numPts, int dim, const double bounds[6],
+  std::vector<vtkIdType>& order)
+{
+  const int bits = 48 / dim;
+  const double maxCoord = static_cast<double>((1u << bits) - 1);
+  double scale[3];
+  for (int i = 0; i < dim; ++i)
+  {
+    const double length = bounds[2 * i + 1] - bounds[2 * i];
+    scale[i] = (length > 0.0 ? maxCoord / length : 0.0);
+  }
+  uint64_t numRounds = 0;
+  while (numRounds < 15 && (static_cast<vtkIdType>(2) << numRounds) < numPts)
+  {
+    ++numRounds;
+  }
+
+  std::vector<std::pair<uint64_t, vtkIdType>> keys(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    uint32_t X[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      for (int i = 0; i < dim; ++i)
+      {
+        const double c = (x[i] - bounds[2 * i]) * scale[i];
+        X[i] = static_cast<uint32_t>(c < 0.0 ? 0.0 : (c > maxCoord ? maxCoord : c));
+      }
+      keys[ptId].first = (InsertionRound(ptId, numRounds) << 48) | HilbertIndex(X, dim, bits);
+      keys[ptId].second = ptId;
+    }
+  });
+  vtkSMPTools::Sort(keys.begin(), keys.end());
+
+  order.resize(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      order[i] = keys[i].second;
+    }
+  });
+}
+
+} // anonymous namespace
+
+#endif
+// VTK-HeaderTest-Exclude: vtkDelaunayInsertionOrder.h
@@ -15,8 +15,11 @@
 #include "vtkFeatureEdges.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -27,11 +30,15 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticEdgeLocatorTemplate.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleStrip.h"
 #include "vtkUnsignedCharArray.h"
 
-#include <map>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkFeatureEdges);
 
@@ -68,6 +75,194 @@ vtkFeatureEdges::~vtkFeatureEdges()
   }
 }
 
+//------------------------------------------------------------------------------
+// The polygon edges are classified in parallel. Each edge of each polygon is
+// an edge tuple whose data is its position in the connectivity of the
+// polygons, so that sorting the tuples with vtkStaticEdgeLocatorTemplate
+// gathers the polygons using an edge, and each group of polygons is then
+// classified independently. The selected edges are output in the order of
+// the polygons and of their edges, as the serial algorithm did.
+namespace
+{
+// Values of the Edge Types scalars, indexed by EdgeType.
+const float EdgeTypeScalars[6] = { 0.0f, 0.0f, 0.222222f, 0.444444f, 0.666667f, 0.888889f };
+
+enum EdgeType : unsigned char
+{
+  NO_EDGE = 0,
+  BOUNDARY_EDGE,
+  NON_MANIFOLD_EDGE,
+  FEATURE_EDGE,
+  MANIFOLD_EDGE,
+  LINE_EDGE
+};
+
+// Polygon of the edge at a position of the connectivity.
+vtkIdType GetPolygonOfEdge(const std::vector<vtkIdType>& cellOffsets, vtkIdType position)
+{
+  return static_cast<vtkIdType>(
+           std::upper_bound(cellOffsets.begin(), cellOffsets.end(), position) -
+           cellOffsets.begin()) -
+    1;
+}
+
+// Classify the edges of the polygons. TId is int when the number of points
+// and of polygon edges allow it, which speeds up the sort.
+template <typename TId>
+struct ClassifyEdges
+{
+  using EdgeTupleType = EdgeTuple<TId, TId>;
+
+  vtkCellArray* Polys;
+  vtkPoints* Points;
+  const std::vector<vtkIdType>& CellOffsets;
+  const unsigned char* HiddenCells;
+  double CosAngle;
+  vtkFeatureEdges* Self;
+  unsigned char* Types;
+  std::vector<EdgeTupleType> Edges;
+  std::vector<TId> EdgeCells;
+  std::vector<float> Normals;
+  const TId* EdgeOffsets;
+
+  ClassifyEdges(vtkCellArray* polys, vtkPoints* points, const std::vector<vtkIdType>& cellOffsets,
+    const unsigned char* hiddenCells, vtkFeatureEdges* self, unsigned char* types)
+    : Polys(polys)
+    , Points(points)
+    , CellOffsets(cellOffsets)
+    , HiddenCells(hiddenCells)
+    , CosAngle(cos(vtkMath::RadiansFromDegrees(self->GetFeatureAngle())))
+    , Self(self)
+    , Types(types)
+    , EdgeOffsets(nullptr)
+  {
+  }
+
+  // Gather the edges of the polygons, and compute their normals for the
+  // feature angle.
+  void GatherEdges(vtkIdType polyId, vtkIdType endPolyId)
+  {
+    auto iter = vtk::TakeSmartPointer(this->Polys->NewIterator());
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double n[3];
+    for (; polyId < endPolyId; ++polyId)
+    {
+      iter->GetCellAtId(polyId, npts, pts);
+      if (!this->Normals.empty())
+      {
+        vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+        for (int k = 0; k < 3; ++k)
+        {
+          this->Normals[3 * polyId + k] = static_cast<float>(n[k]);
+        }
+      }
+      const vtkIdType offset = this->CellOffsets[polyId];
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        EdgeTupleType& edge = this->Edges[offset + i];
+        edge.Define(static_cast<TId>(pts[i]), static_cast<TId>(pts[(i + 1) % npts]));
+        edge.Data = static_cast<TId>(offset + i);
+        this->EdgeCells[offset + i] = static_cast<TId>(polyId);
+      }
+    }
+  }
+
+  // Classify the uses of the edges of a range of groups of identical edges.
+  void Classify(vtkIdType group, vtkIdType endGroup) const
+  {
+    std::vector<TId> cellIds;
+    for (; group < endGroup; ++group)
+    {
+      const TId begin = this->EdgeOffsets[group];
+      const TId numUses = this->EdgeOffsets[group + 1] - begin;
+      cellIds.resize(numUses);
+      for (TId i = 0; i < numUses; ++i)
+      {
+        cellIds[i] = this->EdgeCells[this->Edges[begin + i].Data];
+      }
+
+      for (TId i = 0; i < numUses; ++i)
+      {
+        const TId cellId = cellIds[i];
+        unsigned char& type = this->Types[this->Edges[begin + i].Data];
+        type = NO_EDGE;
+        if (this->HiddenCells && this->HiddenCells[cellId])
+        {
+          continue;
+        }
+
+        // The neighbors are the other polygons using the edge.
+        TId numNei = 0, numNeiWithoutGhosts = 0;
+        TId minNei = std::numeric_limits<TId>::max();
+        for (TId j = 0; j < numUses; ++j)
+        {
+          if (cellIds[j] != cellId)
+          {
+            ++numNei;
+            if (!this->HiddenCells || !this->HiddenCells[cellIds[j]])
+            {
+              ++numNeiWithoutGhosts;
+              minNei = std::min(minNei, cellIds[j]);
+            }
+          }
+        }
+
+        // Ignoring edges that are not visible
+        if (numNeiWithoutGhosts != numNei && this->Self->GetRemoveGhostInterfaces())
+        {
+          continue;
+        }
+        if (this->Self->GetBoundaryEdges() && numNeiWithoutGhosts < 1)
+        {
+          type = BOUNDARY_EDGE;
+        }
+        else if (this->Self->GetNonManifoldEdges() && numNeiWithoutGhosts > 1)
+        {
+          // only the first of the polygons outputs the edge
+          type = (minNei > cellId ? NON_MANIFOLD_EDGE : NO_EDGE);
+        }
+        else if (this->Self->GetFeatureEdges() && numNeiWithoutGhosts == 1 && minNei > cellId)
+        {
+          double neiTuple[3], cellTuple[3];
+          for (int k = 0; k < 3; ++k)
+          {
+            neiTuple[k] = this->Normals[3 * minNei + k];
+            cellTuple[k] = this->Normals[3 * cellId + k];
+          }
+          type = (vtkMath::Dot(neiTuple, cellTuple) <= this->CosAngle ? FEATURE_EDGE : NO_EDGE);
+        }
+        else if (this->Self->GetManifoldEdges() && numNeiWithoutGhosts == 1 && minNei > cellId)
+        {
+          type = MANIFOLD_EDGE;
+        }
+      }
+    }
+  }
+
+  void Execute()
+  {
+    const vtkIdType numPolys = this->Polys->GetNumberOfCells();
+    const vtkIdType numEdgeUses = this->CellOffsets[numPolys];
+    this->Edges.resize(numEdgeUses);
+    this->EdgeCells.resize(numEdgeUses);
+    if (this->Self->GetFeatureEdges())
+    {
+      this->Normals.resize(3 * numPolys);
+    }
+    vtkSMPTools::For(0, numPolys,
+      [this](vtkIdType polyId, vtkIdType endPolyId) { this->GatherEdges(polyId, endPolyId); });
+    this->Self->UpdateProgress(0.3);
+
+    vtkStaticEdgeLocatorTemplate<TId, TId> edgeLocator;
+    vtkIdType numUniqueEdges = 0;
+    this->EdgeOffsets = edgeLocator.MergeEdges(numEdgeUses, this->Edges.data(), numUniqueEdges);
+    vtkSMPTools::For(0, numUniqueEdges,
+      [this](vtkIdType group, vtkIdType endGroup) { this->Classify(group, endGroup); });
+  }
+};
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 // Generate feature edges for mesh
 int vtkFeatureEdges::RequestData(vtkInformation* vtkNotUsed(request),
@@ -83,22 +278,10 @@ int vtkFeatureEdges::RequestData(vtkInformation* vtkNotUsed(request),
 
   vtkPoints* inPts;
   vtkPoints* newPts;
-  vtkFloatArray* newScalars = nullptr;
-  vtkCellArray* newLines;
-  vtkPolyData* Mesh;
-  int i;
-  vtkIdType j, numNei;
-  vtkIdType numBEdges, numNonManifoldEdges, numFedges, numManifoldEdges;
-  double scalar, n[3], x1[3], x2[3];
-  double cosAngle = 0;
-  vtkIdType lineIds[2];
   vtkIdType npts = 0;
   const vtkIdType* pts = nullptr;
   vtkCellArray *inPolys, *inStrips, *newPolys;
-  vtkFloatArray* polyNormals = nullptr;
-  vtkIdType numPts, numCells, numPolys, numStrips, numLines, nei;
-  vtkIdList* neighbors;
-  vtkIdType p1, p2, newId;
+  vtkIdType numPts, numCells, numPolys, numStrips, numLines;
   vtkPointData *pd = input->GetPointData(), *outPD = output->GetPointData();
   vtkCellData *cd = input->GetCellData(), *outCD = output->GetCellData();
 
@@ -143,15 +326,11 @@ int vtkFeatureEdges::RequestData(vtkInformation* vtkNotUsed(request),
   }
 
   // Build cell structure.  Might have to triangulate the strips.
-  Mesh = vtkPolyData::New();
-  Mesh->SetPoints(inPts);
   inPolys = input->GetPolys();
-  vtkIdType numberOfNewPolys = numPolys;
 
   vtkNew<vtkIdList> polyIdToCellIdMap;
   vtkNew<vtkIdList> stripIdToCellIdMap;
   vtkNew<vtkIdList> lineIdToCellIdMap;
-  std::map<vtkIdType, vtkIdType> decomposedStripIdToStripIdMap;
 
   // We need to remap cells if there are other cell arrays than polys
   if (numPolys != numCells)
@@ -189,6 +368,14 @@ int vtkFeatureEdges::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
+  // Input cell ids of the polygons, when they are not the identity.
+  std::vector<vtkIdType> polyCellIds;
+  if (numPolys != numCells)
+  {
+    polyCellIds.assign(polyIdToCellIdMap->GetPointer(0),
+      polyIdToCellIdMap->GetPointer(0) + polyIdToCellIdMap->GetNumberOfIds());
+  }
+
   if (numStrips > 0)
   {
     newPolys = vtkCellArray::New();
@@ -201,93 +388,77 @@ int vtkFeatureEdges::RequestData(vtkInformation* vtkNotUsed(request),
       newPolys->AllocateEstimate(numStrips, 5);
     }
     inStrips = input->GetStrips();
-    vtkIdType stripId = -1;
-    for (inStrips->InitTraversal(); inStrips->GetNextCell(npts, pts);)
+    vtkIdType stripId = 0;
+    for (inStrips->InitTraversal(); inStrips->GetNextCell(npts, pts); ++stripId)
     {
-      numberOfNewPolys += npts - 2;
-      decomposedStripIdToStripIdMap.insert({ numberOfNewPolys, ++stripId });
+      polyCellIds.insert(polyCellIds.end(), npts - 2, stripIdToCellIdMap->GetId(stripId));
       vtkTriangleStrip::DecomposeStrip(npts, pts, newPolys);
     }
-
-    Mesh->SetPolys(newPolys);
-    newPolys->Delete();
   }
   else
   {
     newPolys = inPolys;
-    Mesh->SetPolys(newPolys);
-  }
-  Mesh->BuildLinks();
-
-  // Allocate storage for lines/points (arbitrary allocation sizes)
-  //
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    newPts->SetDataType(inPts->GetDataType());
+    newPolys->Register(this);
   }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  const vtkIdType numNewPolys = newPolys->GetNumberOfCells();
+  auto getCellId = [&polyCellIds](vtkIdType polyId) {
+    return polyCellIds.empty() ? polyId : polyCellIds[polyId];
+  };
+
+  // Flag the polygons that are not visible.
+  std::vector<unsigned char> hiddenCells;
+  if (ghosts)
   {
-    newPts->SetDataType(VTK_FLOAT);
+    hiddenCells.resize(numNewPolys);
+    vtkSMPTools::For(0, numNewPolys, [&](vtkIdType polyId, vtkIdType endPolyId) {
+      for (; polyId < endPolyId; ++polyId)
+      {
+        hiddenCells[polyId] = (ghosts[getCellId(polyId)] & CELL_NOT_VISIBLE) != 0;
+      }
+    });
   }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+
+  // Offsets of the polygons in the connectivity, i.e., of their edges.
+  std::vector<vtkIdType> cellOffsets(numNewPolys + 1);
+  vtkSMPTools::For(0, numNewPolys, [&](vtkIdType polyId, vtkIdType endPolyId) {
+    for (; polyId < endPolyId; ++polyId)
+    {
+      cellOffsets[polyId + 1] = newPolys->GetCellSize(polyId);
+    }
+  });
+  for (vtkIdType polyId = 0; polyId < numNewPolys; ++polyId)
   {
-    newPts->SetDataType(VTK_DOUBLE);
+    cellOffsets[polyId + 1] += cellOffsets[polyId];
   }
+  const vtkIdType numEdgeUses = cellOffsets[numNewPolys];
+  this->UpdateProgress(0.1);
 
-  newPts->Allocate(numPts / 10, numPts);
-  newLines = vtkCellArray::New();
-  newLines->AllocateEstimate(numPts / 20, 2);
-  if (this->Coloring)
+  // Group the uses of each edge, and classify them.
+  std::vector<unsigned char> edgeTypes(numEdgeUses);
+  const unsigned char* hidden = hiddenCells.empty() ? nullptr : hiddenCells.data();
+  if (numPts < VTK_INT_MAX && numEdgeUses < VTK_INT_MAX)
   {
-    newScalars = vtkFloatArray::New();
-    newScalars->SetName("Edge Types");
-    newScalars->Allocate(numCells / 10, numCells);
+    ClassifyEdges<int> classify(newPolys, inPts, cellOffsets, hidden, this, edgeTypes.data());
+    classify.Execute();
   }
-
-  outPD->CopyAllocate(pd, numPts);
-  outCD->CopyAllocate(cd, numCells);
-
-  // Get our locator for merging points
-  //
-  if (this->Locator == nullptr)
+  else
   {
-    this->CreateDefaultLocator();
+    ClassifyEdges<vtkIdType> classify(
+      newPolys, inPts, cellOffsets, hidden, this, edgeTypes.data());
+    classify.Execute();
   }
-  this->Locator->InitPointInsertion(newPts, input->GetBounds());
-
-  // Loop over all polygons generating boundary, non-manifold,
-  // and feature edges
-  //
-  if (this->FeatureEdges)
+  this->UpdateProgress(0.6);
+  if (this->GetAbortExecute())
   {
-    polyNormals = vtkFloatArray::New();
-    polyNormals->SetNumberOfComponents(3);
-    polyNormals->Allocate(3 * newPolys->GetNumberOfCells());
-
-    vtkIdType cellId;
-    for (cellId = 0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts); cellId++)
-    {
-      vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-      polyNormals->InsertTuple(cellId, n);
-    }
-
-    cosAngle = cos(vtkMath::RadiansFromDegrees(this->FeatureAngle));
+    newPolys->UnRegister(this);
+    return 1;
   }
 
-  neighbors = vtkIdList::New();
-  neighbors->Allocate(VTK_CELL_SIZE);
-
-  int abort = 0;
-  vtkIdType progressInterval = newPolys->GetNumberOfCells() / 20 + 1;
-
-  numBEdges = numNonManifoldEdges = numFedges = numManifoldEdges = 0;
-  vtkIdType newCellId, cellId;
-
-  // When filling output cells, to respect the same order as in vtkPolyData,
-  // we need to fill lines, then polys, then strips.
+  // Collect the output edges: the line segments first, to respect the same
+  // order as in vtkPolyData, then the polygon edges in order.
+  std::vector<vtkIdType> edgePts;
+  std::vector<vtkIdType> edgeCellIds;
+  std::vector<unsigned char> outEdgeTypes;
   vtkIdType numOutLines = 0;
   if (numLines)
   {
@@ -295,218 +466,153 @@ int vtkFeatureEdges::RequestData(vtkInformation* vtkNotUsed(request),
     vtkIdType lineId = 0;
     for (lines->InitTraversal(); lines->GetNextCell(npts, pts); ++lineId)
     {
-      cellId = lineIdToCellIdMap->GetId(lineId);
+      vtkIdType cellId = numPolys == numCells ? lineId : lineIdToCellIdMap->GetId(lineId);
       if (ghosts && ghosts[cellId] & CELL_NOT_VISIBLE)
       {
         continue;
       }
-
       for (vtkIdType pointId = 0; pointId < npts - 1; ++pointId)
       {
-        p1 = pts[pointId];
-        p2 = pts[pointId + 1];
-
-        Mesh->GetPoint(p1, x1);
-        Mesh->GetPoint(p2, x2);
-
-        if (this->Locator->InsertUniquePoint(x1, lineIds[0]))
-        {
-          outPD->CopyData(pd, p1, lineIds[0]);
-        }
-
-        if (this->Locator->InsertUniquePoint(x2, lineIds[1]))
-        {
-          outPD->CopyData(pd, p2, lineIds[1]);
-        }
-
-        newId = newLines->InsertNextCell(2, lineIds);
-        outCD->CopyData(cd, cellId, newId);
-        if (this->Coloring)
-        {
-          newScalars->InsertTuple1(newId, 0.888889);
-        }
+        edgePts.push_back(pts[pointId]);
+        edgePts.push_back(pts[pointId + 1]);
+        edgeCellIds.push_back(cellId);
+        outEdgeTypes.push_back(LINE_EDGE);
         ++numOutLines;
       }
     }
   }
-
-  for (newCellId = 0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts) && !abort;
-       newCellId++)
+  vtkIdType numEdgesOfType[5] = { 0, 0, 0, 0, 0 };
+  std::vector<vtkIdType> selectedEdges;
+  for (vtkIdType edgeId = 0; edgeId < numEdgeUses; ++edgeId)
   {
-    if (!(newCellId % progressInterval)) // manage progress / early abort
-    {
-      this->UpdateProgress(static_cast<double>(newCellId) / numCells);
-      abort = this->GetAbortExecute();
-    }
-
-    if (numPolys == numCells) // Input only has Polys
-    {
-      cellId = newCellId;
-    }
-    else if (newCellId < numPolys) // Input has mixed types, and we currently are on a Poly
-    {
-      cellId = polyIdToCellIdMap->GetId(newCellId);
-    }
-    else // Input has mixed types and we are dealing with triangle strips
+    if (edgeTypes[edgeId] != NO_EDGE)
     {
-      auto it = decomposedStripIdToStripIdMap.lower_bound(newCellId + 1);
-      cellId = stripIdToCellIdMap->GetId(it->second);
+      selectedEdges.push_back(edgeId);
+      ++numEdgesOfType[edgeTypes[edgeId]];
     }
-
-    if (ghosts && ghosts[cellId] & CELL_NOT_VISIBLE)
-    {
-      continue;
-    }
-
-    // Used with non manifold edges when there are ghost cells in the input
-    vtkNew<vtkIdList> edgesRemapping;
-
-    for (i = 0; i < npts; i++)
-    {
-      p1 = pts[i];
-      p2 = pts[(i + 1) % npts];
-
-      Mesh->GetCellEdgeNeighbors(newCellId, p1, p2, neighbors);
-      numNei = neighbors->GetNumberOfIds();
-
-      vtkIdType numNeiWithoutGhosts = numNei;
-      vtkIdType firstNeighbor = 0;
-      if (ghosts)
-      {
-        for (j = 0; j < numNei; ++j)
-        {
-          vtkIdType neiId = neighbors->GetId(j);
-          vtkIdType neighborCellIdInInput;
-          if (numPolys == numCells)
-          {
-            neighborCellIdInInput = neiId;
-          }
-          else if (neiId < numPolys)
-          {
-            neighborCellIdInInput = polyIdToCellIdMap->GetId(neiId);
-          }
-          else
-          {
-            auto it = decomposedStripIdToStripIdMap.lower_bound(neiId + 1);
-            neighborCellIdInInput = stripIdToCellIdMap->GetId(it->second);
-          }
-          if (ghosts[neighborCellIdInInput] & CELL_NOT_VISIBLE)
-          {
-            if (this->NonManifoldEdges)
-            {
-              edgesRemapping->InsertNextId(j);
-            }
-            if (j == firstNeighbor)
-            {
-              ++firstNeighbor;
-            }
-            --numNeiWithoutGhosts;
-          }
-        }
-      }
-      // Ignoring edges that are not visible
-      if (numNeiWithoutGhosts != numNei && this->RemoveGhostInterfaces)
+  }
+  const vtkIdType numNewLines = numOutLines + static_cast<vtkIdType>(selectedEdges.size());
+  edgePts.resize(2 * numNewLines);
+  edgeCellIds.resize(numNewLines);
+  outEdgeTypes.resize(numNewLines);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(selectedEdges.size()),
+    [&](vtkIdType selectedId, vtkIdType endSelectedId) {
+      auto iter = vtk::TakeSmartPointer(newPolys->NewIterator());
+      vtkIdType numCellPts;
+      const vtkIdType* cellPts;
+      for (; selectedId < endSelectedId; ++selectedId)
       {
-        continue;
+        const vtkIdType edgeId = selectedEdges[selectedId];
+        const vtkIdType polyId = GetPolygonOfEdge(cellOffsets, edgeId);
+        const vtkIdType i = edgeId - cellOffsets[polyId];
+        const vtkIdType outId = numOutLines + selectedId;
+        iter->GetCellAtId(polyId, numCellPts, cellPts);
+        edgePts[2 * outId] = cellPts[i];
+        edgePts[2 * outId + 1] = cellPts[(i + 1) % numCellPts];
+        edgeCellIds[outId] = getCellId(polyId);
+        outEdgeTypes[outId] = edgeTypes[edgeId];
       }
+    });
+  newPolys->UnRegister(this);
+  this->UpdateProgress(0.7);
 
-      if (this->BoundaryEdges && numNeiWithoutGhosts < 1)
-      {
-        numBEdges++;
-        scalar = 0.0;
-      }
+  // Allocate storage for the points
+  //
+  newPts = vtkPoints::New();
 
-      else if (this->NonManifoldEdges && numNeiWithoutGhosts > 1)
-      {
-        // check to make sure that this edge hasn't been created before
-        for (j = 0; j < (ghosts ? edgesRemapping->GetNumberOfIds() : numNei); j++)
-        {
-          if (neighbors->GetId(ghosts ? edgesRemapping->GetId(j) : j) < newCellId)
-          {
-            break;
-          }
-        }
-        edgesRemapping->Reset();
-        if (j >= numNeiWithoutGhosts)
-        {
-          numNonManifoldEdges++;
-          scalar = 0.222222;
-        }
-        else
-        {
-          continue;
-        }
-      }
-      else if (this->FeatureEdges && numNeiWithoutGhosts == 1 &&
-        (nei = neighbors->GetId(firstNeighbor)) > newCellId)
-      {
-        double neiTuple[3];
-        double cellTuple[3];
-        polyNormals->GetTuple(nei, neiTuple);
-        polyNormals->GetTuple(newCellId, cellTuple);
-        if (vtkMath::Dot(neiTuple, cellTuple) <= cosAngle)
-        {
-          numFedges++;
-          scalar = 0.444444;
-        }
-        else
-        {
-          continue;
-        }
-      }
-      else if (this->ManifoldEdges && numNeiWithoutGhosts == 1 &&
-        neighbors->GetId(firstNeighbor) > newCellId)
-      {
-        numManifoldEdges++;
-        scalar = 0.666667;
-      }
-      else
-      {
-        continue;
-      }
+  // Set the desired precision for the points in the output.
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
 
-      // Add edge to output
-      Mesh->GetPoint(p1, x1);
-      Mesh->GetPoint(p2, x2);
+  newPts->Allocate(numPts / 10, numPts);
+  outPD->CopyAllocate(pd, numPts);
 
-      if (this->Locator->InsertUniquePoint(x1, lineIds[0]))
-      {
-        outPD->CopyData(pd, p1, lineIds[0]);
-      }
+  // Get our locator for merging points
+  //
+  if (this->Locator == nullptr)
+  {
+    this->CreateDefaultLocator();
+  }
+  this->Locator->InitPointInsertion(newPts, input->GetBounds());
 
-      if (this->Locator->InsertUniquePoint(x2, lineIds[1]))
+  // Merge the points in the order of the output edges. Each input point is
+  // only given once to the locator.
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  double x[3];
+  for (vtkIdType& ptId : edgePts)
+  {
+    vtkIdType& newId = pointMap[ptId];
+    if (newId < 0)
+    {
+      inPts->GetPoint(ptId, x);
+      if (this->Locator->InsertUniquePoint(x, newId))
       {
-        outPD->CopyData(pd, p2, lineIds[1]);
+        outPD->CopyData(pd, ptId, newId);
       }
+    }
+  }
 
-      newId = newLines->InsertNextCell(2, lineIds);
-      outCD->CopyData(cd, cellId, newId);
-      if (this->Coloring)
+  // Build the output lines and their cell data.
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfTuples(numNewLines + 1);
+  vtkIdType* offsetsPtr = offsets->GetPointer(0);
+  vtkNew<vtkIdTypeArray> conn;
+  conn->SetNumberOfTuples(2 * numNewLines);
+  vtkIdType* connPtr = conn->GetPointer(0);
+  outCD->CopyAllocate(cd, numNewLines);
+  vtkFloatArray* newScalars = nullptr;
+  float* scalars = nullptr;
+  if (this->Coloring)
+  {
+    newScalars = vtkFloatArray::New();
+    newScalars->SetName("Edge Types");
+    newScalars->SetNumberOfTuples(numNewLines);
+    scalars = newScalars->GetPointer(0);
+  }
+  vtkSMPTools::For(0, numNewLines, [&](vtkIdType lineId, vtkIdType endLineId) {
+    for (; lineId < endLineId; ++lineId)
+    {
+      offsetsPtr[lineId] = 2 * lineId;
+      connPtr[2 * lineId] = pointMap[edgePts[2 * lineId]];
+      connPtr[2 * lineId + 1] = pointMap[edgePts[2 * lineId + 1]];
+      if (scalars)
       {
-        newScalars->InsertTuple(newId, &scalar);
+        scalars[lineId] = EdgeTypeScalars[outEdgeTypes[lineId]];
       }
     }
-  }
+  });
+  offsetsPtr[numNewLines] = 2 * numNewLines;
+
+  // Each line gets the data of its cell, for all the kinds of arrays.
+  vtkNew<vtkIdList> lineCellIds;
+  lineCellIds->SetNumberOfIds(numNewLines);
+  std::copy(edgeCellIds.begin(), edgeCellIds.end(), lineCellIds->GetPointer(0));
+  outCD->CopyData(cd, lineCellIds);
 
-  vtkDebugMacro(<< "Created " << numBEdges << " boundary edges, " << numNonManifoldEdges
-                << " non-manifold edges, " << numFedges << " feature edges, " << numManifoldEdges
-                << " manifold edges," << numOutLines << " lines.");
+  vtkDebugMacro(<< "Created " << numEdgesOfType[BOUNDARY_EDGE] << " boundary edges, "
+                << numEdgesOfType[NON_MANIFOLD_EDGE] << " non-manifold edges, "
+                << numEdgesOfType[FEATURE_EDGE] << " feature edges, "
+                << numEdgesOfType[MANIFOLD_EDGE] << " manifold edges," << numOutLines
+                << " lines.");
 
   //  Update ourselves.
   //
-  if (this->FeatureEdges)
-  {
-    polyNormals->Delete();
-  }
-
-  Mesh->Delete();
-
   output->SetPoints(newPts);
   newPts->Delete();
-  neighbors->Delete();
 
+  vtkNew<vtkCellArray> newLines;
+  newLines->SetData(offsets, conn);
   output->SetLines(newLines);
-  newLines->Delete();
   this->Locator->Initialize(); // release any extra memory
   if (this->Coloring)
   {
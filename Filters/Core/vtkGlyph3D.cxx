@@ -15,17 +15,24 @@
 #include "vtkGlyph3D.h"
 
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkMultiBlockDataSet.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +40,9 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -65,6 +75,8 @@ vtkGlyph3D::vtkGlyph3D()
   this->FillCellData = 0;
   this->SourceTransform = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->OutputMode = REPLICATED_GLYPHS;
+  this->SetNumberOfOutputPorts(2);
 
   // by default process active point scalars
   this->SetInputArrayToProcess(
@@ -100,6 +112,396 @@ vtkMTimeType vtkGlyph3D::GetMTime()
   return mTime;
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+
+// Everything needed to glyph one input point. Several Evaluate() calls may
+// run concurrently; vtkGlyph3D::IsPointVisible() must then be thread safe.
+struct GlyphEvaluator
+{
+  vtkGlyph3D* Self;
+  vtkDataSet* Input;
+  vtkUniformGrid* InputUG;
+  unsigned char* GhostLevels;
+  vtkDataArray* ScaleScalars;
+  vtkDataArray* Array3D;
+  std::vector<vtkPolyData*> Sources;
+  bool HaveVectors;
+  double Den;
+  // The filter parameters.
+  bool Scaling;
+  int ScaleMode;
+  double ScaleFactor;
+  double Range[2];
+  bool Orient;
+  int VectorMode;
+  double FollowedCameraPosition[3];
+  double FollowedCameraViewUp[3];
+  bool Clamping;
+  int IndexMode;
+
+  // The values computed for an input point.
+  struct Values
+  {
+    double X[3];
+    double V[3];
+    double VMag;
+    double S;
+    // The glyph scale before the scale factor is applied, used for coloring.
+    double ColorScale;
+    double Scale[3];
+  };
+
+  // Returns the index of the source glyphing the point, -1 if the point is
+  // not glyphed.
+  int Evaluate(vtkIdType ptId, Values& values) const
+  {
+    double scalex = 1.0, scaley = 1.0, scalez = 1.0;
+    values.S = 0.0;
+    values.VMag = 0.0;
+    values.V[0] = values.V[1] = values.V[2] = 0.0;
+    this->Input->GetPoint(ptId, values.X);
+
+    // Get the scalar and vector data
+    if (this->ScaleScalars)
+    {
+      values.S = this->ScaleScalars->GetComponent(ptId, 0);
+      if (this->ScaleMode == VTK_SCALE_BY_SCALAR || this->ScaleMode == VTK_DATA_SCALING_OFF)
+      {
+        scalex = scaley = scalez = values.S;
+      }
+    }
+
+    if (this->HaveVectors)
+    {
+      if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+      {
+        // v = glyphNormal_World (glyph normal direction in World coordinate system)
+        const double* position = this->FollowedCameraPosition;
+        values.V[0] = position[0] - values.X[0];
+        values.V[1] = position[1] - values.X[1];
+        values.V[2] = position[2] - values.X[2];
+        vtkMath::Normalize(values.V);
+        values.VMag = 1.0;
+      }
+      else
+      {
+        this->Array3D->GetTuple(ptId, values.V);
+        values.VMag = vtkMath::Norm(values.V);
+        if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+        {
+          scalex = values.V[0];
+          scaley = values.V[1];
+          scalez = values.V[2];
+        }
+        else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+        {
+          scalex = scaley = scalez = values.VMag;
+        }
+      }
+    }
+
+    // Clamp data scale if enabled
+    if (this->Clamping)
+    {
+      const double* range = this->Range;
+      scalex = (scalex < range[0] ? range[0] : (scalex > range[1] ? range[1] : scalex));
+      scalex = (scalex - range[0]) / this->Den;
+      scaley = (scaley < range[0] ? range[0] : (scaley > range[1] ? range[1] : scaley));
+      scaley = (scaley - range[0]) / this->Den;
+      scalez = (scalez < range[0] ? range[0] : (scalez > range[1] ? range[1] : scalez));
+      scalez = (scalez - range[0]) / this->Den;
+    }
+    values.ColorScale = scalex;
+
+    // scale data if appropriate
+    values.Scale[0] = values.Scale[1] = values.Scale[2] = 1.0;
+    if (this->Scaling)
+    {
+      if (this->ScaleMode == VTK_DATA_SCALING_OFF)
+      {
+        scalex = scaley = scalez = this->ScaleFactor;
+      }
+      else
+      {
+        scalex *= this->ScaleFactor;
+        scaley *= this->ScaleFactor;
+        scalez *= this->ScaleFactor;
+      }
+      values.Scale[0] = scalex == 0.0 ? 1.0e-10 : scalex;
+      values.Scale[1] = scaley == 0.0 ? 1.0e-10 : scaley;
+      values.Scale[2] = scalez == 0.0 ? 1.0e-10 : scalez;
+    }
+
+    // Compute index into table of glyphs
+    int index = 0;
+    if (this->IndexMode != VTK_INDEXING_OFF)
+    {
+      const int numberOfSources = static_cast<int>(this->Sources.size());
+      const double value = this->IndexMode == VTK_INDEXING_BY_SCALAR ? values.S : values.VMag;
+      index = static_cast<int>((value - this->Range[0]) * numberOfSources / this->Den);
+      index = (index < 0 ? 0 : (index >= numberOfSources ? (numberOfSources - 1) : index));
+    }
+
+    // Make sure we're not indexing into empty glyph
+    if (index < 0 || this->Sources[index] == nullptr)
+    {
+      return -1;
+    }
+
+    // Check ghost points.
+    // If we are processing a piece, we do not want to duplicate glyphs on the borders.
+    if (this->GhostLevels &&
+      this->GhostLevels[ptId] &
+        (vtkDataSetAttributes::DUPLICATEPOINT | vtkDataSetAttributes::HIDDENPOINT))
+    {
+      return -1;
+    }
+
+    if (this->InputUG && !this->InputUG->IsPointVisible(ptId))
+    {
+      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
+      // it.
+      return -1;
+    }
+
+    if (!this->Self->IsPointVisible(this->Input, ptId))
+    {
+      return -1;
+    }
+
+    return index;
+  }
+
+  // Builds the transform of the glyph of a point.
+  void BuildTransform(const Values& values, vtkTransform* trans) const
+  {
+    trans->Identity();
+    // translate Source to Input point
+    trans->Translate(values.X[0], values.X[1], values.X[2]);
+
+    if (this->HaveVectors && this->Orient)
+    {
+      const double* v = values.V;
+      if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+      {
+        double glyphRight_World[3]; // glyph right direction in World coordinate system
+        vtkMath::Cross(this->FollowedCameraViewUp, v, glyphRight_World);
+        // glyph up direction in World coordinate system
+        // (approximately the same as FollowedCameraViewUp, but slightly adjusted to be
+        // orthogonal to the normal direction)
+        double glyphUp_World[3];
+        vtkMath::Cross(v, glyphRight_World, glyphUp_World);
+        double glyphToWorld[16] = { glyphRight_World[0], glyphUp_World[0], v[0], 0.0,
+          glyphRight_World[1], glyphUp_World[1], v[1], 0.0, glyphRight_World[2], glyphUp_World[2],
+          v[2], 0.0, 0.0, 0.0, 0.0, 1.0 };
+        trans->Concatenate(glyphToWorld);
+      }
+      else if (values.VMag > 0.0)
+      {
+        // if there is no y or z component
+        if (v[1] == 0.0 && v[2] == 0.0)
+        {
+          if (v[0] < 0) // just flip x if we need to
+          {
+            trans->RotateWXYZ(180.0, 0, 1, 0);
+          }
+        }
+        else
+        {
+          trans->RotateWXYZ(180.0, (v[0] + values.VMag) / 2.0, v[1] / 2.0, v[2] / 2.0);
+        }
+      }
+    }
+
+    if (this->Scaling)
+    {
+      trans->Scale(values.Scale[0], values.Scale[1], values.Scale[2]);
+    }
+  }
+
+  // Computes the rotation of BuildTransform() as a unit quaternion (w, x, y, z).
+  void GetOrientation(const Values& values, double quat[4]) const
+  {
+    quat[0] = 1.0;
+    quat[1] = quat[2] = quat[3] = 0.0;
+    if (!this->HaveVectors || !this->Orient)
+    {
+      return;
+    }
+    const double* v = values.V;
+    if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+    {
+      // The columns of the rotation are the glyph right, up and normal
+      // directions, which are orthogonal by construction.
+      double right[3], up[3], rotation[3][3];
+      vtkMath::Cross(this->FollowedCameraViewUp, v, right);
+      vtkMath::Cross(v, right, up);
+      vtkMath::Normalize(right);
+      vtkMath::Normalize(up);
+      for (int i = 0; i < 3; ++i)
+      {
+        rotation[i][0] = right[i];
+        rotation[i][1] = up[i];
+        rotation[i][2] = v[i];
+      }
+      vtkMath::Matrix3x3ToQuaternion(rotation, quat);
+    }
+    else if (values.VMag > 0.0)
+    {
+      // A half turn around an axis is the quaternion (0, axis).
+      double axis[3] = { 0.0, 1.0, 0.0 };
+      if (v[1] == 0.0 && v[2] == 0.0)
+      {
+        if (v[0] >= 0)
+        {
+          return;
+        }
+      }
+      else
+      {
+        axis[0] = v[0] + values.VMag;
+        axis[1] = v[1];
+        axis[2] = v[2];
+        vtkMath::Normalize(axis);
+      }
+      quat[0] = 0.0;
+      std::copy_n(axis, 3, quat + 1);
+    }
+  }
+};
+
+// The geometry of a source, flattened for fast copies. Cells are sorted by
+// type like the cell arrays of vtkPolyData.
+struct GlyphSource
+{
+  std::vector<double> Points;
+  std::vector<double> Normals;
+  std::vector<double> TCoords;
+  int NumberOfTCoordComponents = 0;
+  vtkIdType NumberOfPoints = 0;
+  std::vector<vtkIdType> Offsets[4];
+  std::vector<vtkIdType> Connectivity[4];
+
+  void Initialize(vtkPolyData* source, vtkTransform* sourceTransform, bool haveNormals,
+    bool haveTCoords)
+  {
+    this->NumberOfPoints = source->GetNumberOfPoints();
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToDouble();
+    if (sourceTransform)
+    {
+      sourceTransform->TransformPoints(source->GetPoints(), points);
+    }
+    else
+    {
+      points->DeepCopy(source->GetPoints());
+    }
+    this->Points.resize(3 * this->NumberOfPoints);
+    for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+    {
+      points->GetPoint(i, &this->Points[3 * i]);
+    }
+    if (haveNormals)
+    {
+      vtkDataArray* normals = source->GetPointData()->GetNormals();
+      this->Normals.resize(3 * this->NumberOfPoints);
+      for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+      {
+        normals->GetTuple(i, &this->Normals[3 * i]);
+      }
+    }
+    if (haveTCoords)
+    {
+      vtkDataArray* tcoords = source->GetPointData()->GetTCoords();
+      this->NumberOfTCoordComponents = tcoords->GetNumberOfComponents();
+      this->TCoords.resize(this->NumberOfTCoordComponents * this->NumberOfPoints);
+      for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+      {
+        tcoords->GetTuple(i, &this->TCoords[this->NumberOfTCoordComponents * i]);
+      }
+    }
+    vtkCellArray* cells[4] = { source->GetVerts(), source->GetLines(), source->GetPolys(),
+      source->GetStrips() };
+    for (int type = 0; type < 4; ++type)
+    {
+      this->Offsets[type].clear();
+      this->Connectivity[type].clear();
+      this->Offsets[type].push_back(0);
+      vtkIdType npts;
+      const vtkIdType* pts;
+      for (cells[type]->InitTraversal(); cells[type]->GetNextCell(npts, pts);)
+      {
+        this->Connectivity[type].insert(this->Connectivity[type].end(), pts, pts + npts);
+        this->Offsets[type].push_back(static_cast<vtkIdType>(this->Connectivity[type].size()));
+      }
+    }
+  }
+
+  vtkIdType GetNumberOfCells(int type) const
+  {
+    return static_cast<vtkIdType>(this->Offsets[type].size()) - 1;
+  }
+  vtkIdType GetConnectivitySize(int type) const
+  {
+    return static_cast<vtkIdType>(this->Connectivity[type].size());
+  }
+};
+
+// Output sizes, accumulated over the glyphs of a chunk of input points.
+struct GlyphCounts
+{
+  vtkIdType Points = 0;
+  vtkIdType Cells[4] = { 0, 0, 0, 0 };
+  vtkIdType Connectivity[4] = { 0, 0, 0, 0 };
+
+  void Add(const GlyphSource& source)
+  {
+    this->Points += source.NumberOfPoints;
+    for (int type = 0; type < 4; ++type)
+    {
+      this->Cells[type] += source.GetNumberOfCells(type);
+      this->Connectivity[type] += source.GetConnectivitySize(type);
+    }
+  }
+
+  void Add(const GlyphCounts& counts)
+  {
+    this->Points += counts.Points;
+    for (int type = 0; type < 4; ++type)
+    {
+      this->Cells[type] += counts.Cells[type];
+      this->Connectivity[type] += counts.Connectivity[type];
+    }
+  }
+};
+
+// The glyph used when no source is defined: a line along x.
+vtkSmartPointer<vtkPolyData> NewDefaultSource()
+{
+  vtkNew<vtkPolyData> defaultSource;
+  defaultSource->AllocateExact(0, 0, 1, 2, 0, 0, 0, 0);
+  vtkNew<vtkPoints> defaultPoints;
+  defaultPoints->Allocate(6);
+  defaultPoints->InsertNextPoint(0, 0, 0);
+  defaultPoints->InsertNextPoint(1, 0, 0);
+  vtkIdType defaultPointIds[2];
+  defaultPointIds[0] = 0;
+  defaultPointIds[1] = 1;
+  defaultSource->SetPoints(defaultPoints);
+  defaultSource->InsertNextCell(VTK_LINE, 2, defaultPointIds);
+  return defaultSource;
+}
+
+template <typename T>
+T* GetPointer(vtkDataArray* array)
+{
+  return array ? static_cast<T*>(array->GetVoidPointer(0)) : nullptr;
+}
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 int vtkGlyph3D::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
@@ -108,7 +510,55 @@ int vtkGlyph3D::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationV
   vtkDataSet* input = vtkDataSet::GetData(inputVector[0], 0);
   vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
 
-  return this->Execute(input, inputVector[1], output) ? 1 : 0;
+  if (!this->Execute(input, inputVector[1], output))
+  {
+    return 0;
+  }
+
+  // With instanced glyphs, pass the sources to instance to the second output.
+  vtkMultiBlockDataSet* glyphTable = vtkMultiBlockDataSet::GetData(outputVector, 1);
+  if (glyphTable && this->OutputMode == INSTANCED_GLYPHS)
+  {
+    int numberOfSources = this->GetNumberOfInputConnections(1);
+    if (numberOfSources == 0 || this->IndexMode == VTK_INDEXING_OFF)
+    {
+      numberOfSources = 1;
+    }
+    glyphTable->SetNumberOfBlocks(numberOfSources);
+    for (int i = 0; i < numberOfSources; ++i)
+    {
+      vtkSmartPointer<vtkPolyData> source = this->GetSource(i, inputVector[1]);
+      if (source == nullptr && i == 0)
+      {
+        source = NewDefaultSource();
+      }
+      if (source == nullptr)
+      {
+        continue;
+      }
+      vtkNew<vtkPolyData> glyph;
+      glyph->ShallowCopy(source);
+      if (this->SourceTransform)
+      {
+        vtkNew<vtkPoints> points;
+        this->SourceTransform->TransformPoints(source->GetPoints(), points);
+        glyph->SetPoints(points);
+        if (vtkDataArray* normals = source->GetPointData()->GetNormals())
+        {
+          vtkSmartPointer<vtkDataArray> newNormals = vtkSmartPointer<vtkDataArray>::Take(
+            normals->NewInstance());
+          newNormals->SetName(normals->GetName());
+          newNormals->SetNumberOfComponents(3);
+          newNormals->Allocate(normals->GetNumberOfValues());
+          this->SourceTransform->TransformNormals(normals, newNormals);
+          glyph->GetPointData()->SetNormals(newNormals);
+        }
+      }
+      glyphTable->SetBlock(i, glyph);
+    }
+  }
+
+  return 1;
 }
 
 //------------------------------------------------------------------------------
@@ -130,46 +580,26 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     return true;
   }
 
-  // this is used to respect blanking specified on uniform grids.
-  vtkUniformGrid* inputUG = vtkUniformGrid::SafeDownCast(input);
-
   vtkPointData* pd;
   vtkDataArray* inCScalars; // Scalars for Coloring
   unsigned char* inGhostLevels = nullptr;
-  vtkDataArray *inNormals, *sourceNormals = nullptr;
-  vtkDataArray* sourceTCoords = nullptr;
-  vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
-  vtkPoints* sourcePts = nullptr;
-  vtkSmartPointer<vtkPoints> transformedSourcePts = vtkSmartPointer<vtkPoints>::New();
-  vtkPoints* newPts;
+  vtkDataArray* inNormals;
+  vtkIdType numPts;
   vtkDataArray* newScalars = nullptr;
   vtkDataArray* newVectors = nullptr;
   vtkDataArray* newNormals = nullptr;
   vtkDataArray* newTCoords = nullptr;
-  double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0, value, tc[3];
-  vtkTransform* trans = vtkTransform::New();
-  vtkNew<vtkIdList> pointIdList;
-  vtkIdList* cellPts;
-  int npts;
-  vtkIdList* pts;
-  vtkIdType ptIncr, cellIncr, cellId;
-  int haveVectors, haveNormals, haveTCoords = 0;
-  double scalex, scaley, scalez, den;
+  int haveVectors, haveNormals = 0, haveTCoords = 0;
+  double den;
   vtkPointData* outputPD = output->GetPointData();
   vtkCellData* outputCD = output->GetCellData();
   int numberOfSources = this->GetNumberOfInputConnections(1);
   vtkIdTypeArray* pointIds = nullptr;
   vtkSmartPointer<vtkPolyData> source = this->GetSource(0, sourceVector);
-  vtkNew<vtkIdList> srcPointIdList;
-  vtkNew<vtkIdList> dstPointIdList;
-  vtkNew<vtkIdList> srcCellIdList;
-  vtkNew<vtkIdList> dstCellIdList;
+  const bool instanced = this->OutputMode == INSTANCED_GLYPHS;
 
   vtkDebugMacro(<< "Generating glyphs");
 
-  pts = vtkIdList::New();
-  pts->Allocate(VTK_CELL_SIZE);
-
   pd = input->GetPointData();
   inNormals = this->GetInputArrayToProcess(2, input);
   inCScalars = this->GetInputArrayToProcess(3, input);
@@ -196,8 +626,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   if (numPts < 1)
   {
     vtkDebugMacro(<< "No points to glyph!");
-    pts->Delete();
-    trans->Delete();
     return true;
   }
 
@@ -219,6 +647,14 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     haveVectors = 0;
   }
 
+  vtkDataArray* array3D = this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
+  if (haveVectors && this->VectorMode != VTK_FOLLOW_CAMERA_DIRECTION &&
+    array3D->GetNumberOfComponents() > 3)
+  {
+    vtkErrorMacro(<< "vtkDataArray " << array3D->GetName() << " has more than 3 components.\n");
+    return false;
+  }
+
   if ((this->IndexMode == VTK_INDEXING_BY_SCALAR && !inSScalars) ||
     (this->IndexMode == VTK_INDEXING_BY_VECTOR &&
       ((!inVectors && this->VectorMode == VTK_USE_VECTOR) ||
@@ -227,8 +663,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     if (source == nullptr)
     {
       vtkErrorMacro(<< "Indexing on but don't have data to index with");
-      pts->Delete();
-      trans->Delete();
       return true;
     }
     else
@@ -246,86 +680,129 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
 
   if (source == nullptr)
   {
-    vtkNew<vtkPolyData> defaultSource;
-    defaultSource->AllocateExact(0, 0, 1, 2, 0, 0, 0, 0);
-    vtkNew<vtkPoints> defaultPoints;
-    defaultPoints->Allocate(6);
-    defaultPoints->InsertNextPoint(0, 0, 0);
-    defaultPoints->InsertNextPoint(1, 0, 0);
-    vtkIdType defaultPointIds[2];
-    defaultPointIds[0] = 0;
-    defaultPointIds[1] = 1;
-    defaultSource->SetPoints(defaultPoints);
-    defaultSource->InsertNextCell(VTK_LINE, 2, defaultPointIds);
-    source = defaultSource;
+    source = NewDefaultSource();
   }
 
+  GlyphEvaluator evaluator;
+  evaluator.Self = this;
+  evaluator.Input = input;
+  // this is used to respect blanking specified on uniform grids.
+  evaluator.InputUG = vtkUniformGrid::SafeDownCast(input);
+  evaluator.GhostLevels = inGhostLevels;
+  evaluator.ScaleScalars = inSScalars;
+  evaluator.Array3D = array3D;
+  evaluator.HaveVectors = haveVectors != 0;
+  evaluator.Den = den;
+  evaluator.Scaling = this->Scaling != 0;
+  evaluator.ScaleMode = this->ScaleMode;
+  evaluator.ScaleFactor = this->ScaleFactor;
+  evaluator.Range[0] = this->Range[0];
+  evaluator.Range[1] = this->Range[1];
+  evaluator.Orient = this->Orient != 0;
+  evaluator.VectorMode = this->VectorMode;
+  std::copy_n(this->FollowedCameraPosition, 3, evaluator.FollowedCameraPosition);
+  std::copy_n(this->FollowedCameraViewUp, 3, evaluator.FollowedCameraViewUp);
+  evaluator.Clamping = this->Clamping != 0;
+  evaluator.IndexMode = this->IndexMode;
+
   if (this->IndexMode != VTK_INDEXING_OFF)
   {
     pd = nullptr;
     haveNormals = 1;
-    for (numSourcePts = numSourceCells = i = 0; i < numberOfSources; i++)
+    for (int i = 0; i < numberOfSources; i++)
     {
-      source = this->GetSource(i, sourceVector);
-      if (source != nullptr)
+      evaluator.Sources.push_back(this->GetSource(i, sourceVector));
+      if (evaluator.Sources.back() != nullptr &&
+        !evaluator.Sources.back()->GetPointData()->GetNormals())
       {
-        if (source->GetNumberOfPoints() > numSourcePts)
-        {
-          numSourcePts = source->GetNumberOfPoints();
-        }
-        if (source->GetNumberOfCells() > numSourceCells)
-        {
-          numSourceCells = source->GetNumberOfCells();
-        }
-        if (!(sourceNormals = source->GetPointData()->GetNormals()))
-        {
-          haveNormals = 0;
-        }
+        haveNormals = 0;
       }
     }
   }
   else
   {
-    sourcePts = source->GetPoints();
-    numSourcePts = sourcePts->GetNumberOfPoints();
-    numSourceCells = source->GetNumberOfCells();
+    evaluator.Sources.push_back(source);
+    haveNormals = source->GetPointData()->GetNormals() != nullptr;
+    haveTCoords = source->GetPointData()->GetTCoords() != nullptr;
+  }
 
-    sourceNormals = source->GetPointData()->GetNormals();
-    if (sourceNormals)
-    {
-      haveNormals = 1;
-    }
-    else
+  // Flatten the sources, applying the source transform once and for all.
+  std::vector<GlyphSource> glyphSources(evaluator.Sources.size());
+  if (!instanced)
+  {
+    for (size_t i = 0; i < evaluator.Sources.size(); ++i)
     {
-      haveNormals = 0;
+      if (evaluator.Sources[i] != nullptr)
+      {
+        glyphSources[i].Initialize(evaluator.Sources[i], this->SourceTransform, haveNormals != 0,
+          haveTCoords != 0);
+      }
     }
+  }
 
-    sourceTCoords = source->GetPointData()->GetTCoords();
-    if (sourceTCoords)
-    {
-      haveTCoords = 1;
-    }
-    else
+  // Make sure the input can be accessed concurrently.
+  double x[3];
+  input->GetPoint(0, x);
+
+  // First pass: find the glyph of each input point, and count the output
+  // points and cells for each chunk of input points.
+  const vtkIdType chunkSize = 1024;
+  const vtkIdType numChunks = (numPts + chunkSize - 1) / chunkSize;
+  std::vector<int> glyphIndices(numPts);
+  std::vector<GlyphCounts> chunkOffsets(numChunks + 1);
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType beginChunk, vtkIdType endChunk) {
+    GlyphEvaluator::Values values;
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
     {
-      haveTCoords = 0;
+      GlyphCounts& counts = chunkOffsets[chunk + 1];
+      const vtkIdType end = std::min(numPts, (chunk + 1) * chunkSize);
+      for (vtkIdType ptId = chunk * chunkSize; ptId < end; ++ptId)
+      {
+        glyphIndices[ptId] = evaluator.Evaluate(ptId, values);
+        if (glyphIndices[ptId] < 0)
+        {
+          continue;
+        }
+        if (instanced)
+        {
+          ++counts.Points;
+        }
+        else
+        {
+          counts.Add(glyphSources[glyphIndices[ptId]]);
+        }
+      }
     }
+  });
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    chunkOffsets[chunk + 1].Add(chunkOffsets[chunk]);
+  }
+  const GlyphCounts& totals = chunkOffsets[numChunks];
+  const vtkIdType numOutPts = totals.Points;
+  vtkIdType numOutCells = 0;
+  for (int type = 0; type < 4; ++type)
+  {
+    numOutCells += totals.Cells[type];
+  }
+  this->UpdateProgress(0.2);
+  if (this->GetAbortExecute())
+  {
+    return true;
+  }
 
-    // Prepare to copy output.
-    pd = input->GetPointData();
-    outputPD->CopyAllocate(pd, numPts * numSourcePts);
-    if (this->FillCellData)
+  // Prepare to copy output.
+  if (pd)
+  {
+    outputPD->CopyAllocate(pd, numOutPts);
+    if (this->FillCellData && !instanced)
     {
       outputCD->CopyGlobalIdsOn();
-      outputCD->CopyAllocate(pd, numPts * numSourceCells);
+      outputCD->CopyAllocate(pd, numOutCells);
     }
   }
 
-  srcPointIdList->SetNumberOfIds(numSourcePts);
-  dstPointIdList->SetNumberOfIds(numSourcePts);
-  srcCellIdList->SetNumberOfIds(numSourceCells);
-  dstCellIdList->SetNumberOfIds(numSourceCells);
-
-  newPts = vtkPoints::New();
+  vtkNew<vtkPoints> newPts;
 
   // Set the desired precision for the points in the output.
   if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
@@ -341,12 +818,12 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     newPts->SetDataType(VTK_DOUBLE);
   }
 
-  newPts->Allocate(numPts * numSourcePts);
+  newPts->SetNumberOfPoints(numOutPts);
   if (this->GeneratePointIds)
   {
     pointIds = vtkIdTypeArray::New();
     pointIds->SetName(this->PointIdsName);
-    pointIds->Allocate(numPts * numSourcePts);
+    pointIds->SetNumberOfValues(numOutPts);
     outputPD->AddArray(pointIds);
     pointIds->Delete();
   }
@@ -354,13 +831,12 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   {
     newScalars = inCScalars->NewInstance();
     newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
-    newScalars->Allocate(inCScalars->GetNumberOfComponents() * numPts * numSourcePts);
     newScalars->SetName(inCScalars->GetName());
   }
   else if ((this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
   {
     newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts * numSourcePts);
+    newScalars->SetNumberOfTuples(numOutPts);
     newScalars->SetName("GlyphScale");
     if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
     {
@@ -370,361 +846,253 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   else if ((this->ColorMode == VTK_COLOR_BY_VECTOR) && haveVectors)
   {
     newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts * numSourcePts);
+    newScalars->SetNumberOfTuples(numOutPts);
     newScalars->SetName("VectorMagnitude");
   }
-  if (haveVectors)
+  vtkNew<vtkDoubleArray> orientations;
+  vtkNew<vtkDoubleArray> scales;
+  vtkNew<vtkIntArray> sourceIndices;
+  if (instanced)
   {
-    newVectors = vtkFloatArray::New();
-    newVectors->SetNumberOfComponents(3);
-    newVectors->Allocate(3 * numPts * numSourcePts);
-    newVectors->SetName("GlyphVector");
+    orientations->SetName("GlyphOrientation");
+    orientations->SetNumberOfComponents(4);
+    orientations->SetNumberOfTuples(numOutPts);
+    scales->SetName("GlyphScaleFactors");
+    scales->SetNumberOfComponents(3);
+    scales->SetNumberOfTuples(numOutPts);
+    if (this->IndexMode != VTK_INDEXING_OFF)
+    {
+      sourceIndices->SetName("GlyphSourceIndex");
+      sourceIndices->SetNumberOfTuples(numOutPts);
+    }
   }
-  if (haveNormals)
+  else
   {
-    newNormals = vtkFloatArray::New();
-    newNormals->SetNumberOfComponents(3);
-    newNormals->Allocate(3 * numPts * numSourcePts);
-    newNormals->SetName("Normals");
+    if (haveVectors)
+    {
+      newVectors = vtkFloatArray::New();
+      newVectors->SetNumberOfComponents(3);
+      newVectors->SetNumberOfTuples(numOutPts);
+      newVectors->SetName("GlyphVector");
+    }
+    if (haveNormals)
+    {
+      newNormals = vtkFloatArray::New();
+      newNormals->SetNumberOfComponents(3);
+      newNormals->SetNumberOfTuples(numOutPts);
+      newNormals->SetName("Normals");
+    }
+    if (haveTCoords)
+    {
+      newTCoords = vtkFloatArray::New();
+      newTCoords->SetNumberOfComponents(glyphSources[0].NumberOfTCoordComponents);
+      newTCoords->SetNumberOfTuples(numOutPts);
+      newTCoords->SetName("TCoords");
+    }
   }
-  if (haveTCoords)
+
+  // The verts, lines, polys and strips of all the glyphs.
+  vtkNew<vtkIdTypeArray> newOffsets[4];
+  vtkNew<vtkIdTypeArray> newConnectivity[4];
+  for (int type = 0; type < 4; ++type)
   {
-    newTCoords = vtkFloatArray::New();
-    int numComps = sourceTCoords->GetNumberOfComponents();
-    newTCoords->SetNumberOfComponents(numComps);
-    newTCoords->Allocate(numComps * numPts * numSourcePts);
-    newTCoords->SetName("TCoords");
+    newOffsets[type]->SetNumberOfValues(totals.Cells[type] + 1);
+    newOffsets[type]->SetValue(totals.Cells[type], totals.Connectivity[type]);
+    newConnectivity[type]->SetNumberOfValues(totals.Connectivity[type]);
   }
 
-  // Setting up for calls to PolyData::InsertNextCell()
-  output->AllocateEstimate(numPts * numSourceCells, 3);
-
-  transformedSourcePts->SetDataTypeToDouble();
-  transformedSourcePts->Allocate(numSourcePts);
+  // The input point of each output point and cell, to copy the point data.
+  vtkNew<vtkIdList> srcPointIdList;
+  srcPointIdList->SetNumberOfIds(numOutPts);
+  vtkNew<vtkIdList> srcCellIdList;
+  srcCellIdList->SetNumberOfIds(numOutCells);
 
-  // Traverse all Input points, transforming Source points and copying
-  // point attributes.
-  //
-  ptIncr = 0;
-  cellIncr = 0;
-  for (inPtId = 0; inPtId < numPts; inPtId++)
+  // Second pass: transform and copy the glyph of each input point.
+  vtkSMPThreadLocalObject<vtkTransform> localTransforms;
+  // Scalars colored by scalar are copied from the input afterwards.
+  float* scalarsPtr = nullptr;
+  if (newScalars && !(this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars))
   {
-    scalex = scaley = scalez = 1.0;
-    if (!(inPtId % 10000))
+    scalarsPtr = GetPointer<float>(newScalars);
+  }
+  float* vectorsPtr = GetPointer<float>(newVectors);
+  float* normalsPtr = GetPointer<float>(newNormals);
+  float* tcoordsPtr = GetPointer<float>(newTCoords);
+  vtkIdType* pointIdsPtr = pointIds ? pointIds->GetPointer(0) : nullptr;
+  vtkIdType* srcPointIds = srcPointIdList->GetPointer(0);
+  vtkIdType* srcCellIds = srcCellIdList->GetPointer(0);
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType beginChunk, vtkIdType endChunk) {
+    vtkTransform* trans = localTransforms.Local();
+    GlyphEvaluator::Values values;
+    double matrix[4][4], normalMatrix[4][4], p[3];
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
     {
-      this->UpdateProgress(static_cast<double>(inPtId) / numPts);
-      if (this->GetAbortExecute())
+      GlyphCounts offsets = chunkOffsets[chunk];
+      const vtkIdType end = std::min(numPts, (chunk + 1) * chunkSize);
+      for (vtkIdType inPtId = chunk * chunkSize; inPtId < end; ++inPtId)
       {
-        break;
-      }
-    }
-
-    // Get the scalar and vector data
-    if (inSScalars)
-    {
-      s = inSScalars->GetComponent(inPtId, 0);
-      if (this->ScaleMode == VTK_SCALE_BY_SCALAR || this->ScaleMode == VTK_DATA_SCALING_OFF)
-      {
-        scalex = scaley = scalez = s;
-      }
-    }
+        const int index = glyphIndices[inPtId];
+        if (index < 0)
+        {
+          continue;
+        }
+        evaluator.Evaluate(inPtId, values);
+        const vtkIdType ptIncr = offsets.Points;
 
-    if (haveVectors)
-    {
-      if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
-      {
-        vMag = 1.0; // v will be set later
-      }
-      else
-      {
-        vtkDataArray* array3D = this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
-        if (array3D->GetNumberOfComponents() > 3)
+        if (instanced)
         {
-          vtkErrorMacro(<< "vtkDataArray " << array3D->GetName()
-                        << " has more than 3 components.\n");
-          pts->Delete();
-          trans->Delete();
-          if (newPts)
+          // One output point per glyph, oriented and scaled by its arrays.
+          newPts->SetPoint(ptIncr, values.X);
+          evaluator.GetOrientation(values, orientations->GetPointer(4 * ptIncr));
+          scales->SetTypedTuple(ptIncr, values.Scale);
+          if (this->IndexMode != VTK_INDEXING_OFF)
           {
-            newPts->Delete();
+            sourceIndices->SetValue(ptIncr, index);
           }
-          if (newVectors)
+          if (scalarsPtr)
           {
-            newVectors->Delete();
+            scalarsPtr[ptIncr] = static_cast<float>(
+              this->ColorMode == VTK_COLOR_BY_SCALE ? values.ColorScale : values.VMag);
           }
-          return false;
+          if (pointIdsPtr)
+          {
+            pointIdsPtr[ptIncr] = inPtId;
+          }
+          srcPointIds[ptIncr] = inPtId;
+          ++offsets.Points;
+          continue;
         }
 
-        v[0] = 0;
-        v[1] = 0;
-        v[2] = 0;
-        array3D->GetTuple(inPtId, v);
-        vMag = vtkMath::Norm(v);
-        if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+        const GlyphSource& glyph = glyphSources[index];
+        const vtkIdType numSourcePts = glyph.NumberOfPoints;
+
+        // Copy all topology (transformation independent)
+        vtkIdType cellIncr = 0;
+        for (int type = 0; type < 4; ++type)
         {
-          scalex = v[0];
-          scaley = v[1];
-          scalez = v[2];
+          vtkIdType* outOffsets = newOffsets[type]->GetPointer(offsets.Cells[type]);
+          const vtkIdType numCells = glyph.GetNumberOfCells(type);
+          for (vtkIdType i = 0; i < numCells; ++i)
+          {
+            outOffsets[i] = glyph.Offsets[type][i] + offsets.Connectivity[type];
+            srcCellIds[cellIncr + offsets.Cells[type] + i] = inPtId;
+          }
+          vtkIdType* outConnectivity =
+            newConnectivity[type]->GetPointer(offsets.Connectivity[type]);
+          const vtkIdType connectivitySize = glyph.GetConnectivitySize(type);
+          for (vtkIdType i = 0; i < connectivitySize; ++i)
+          {
+            outConnectivity[i] = glyph.Connectivity[type][i] + ptIncr;
+          }
+          cellIncr += totals.Cells[type];
         }
-        else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+
+        // multiply points and normals by resulting matrix
+        evaluator.BuildTransform(values, trans);
+        vtkMatrix4x4::DeepCopy(*matrix, trans->GetMatrix());
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
         {
-          scalex = scaley = scalez = vMag;
+          const double* x0 = &glyph.Points[3 * i];
+          p[0] = matrix[0][0] * x0[0] + matrix[0][1] * x0[1] + matrix[0][2] * x0[2] + matrix[0][3];
+          p[1] = matrix[1][0] * x0[0] + matrix[1][1] * x0[1] + matrix[1][2] * x0[2] + matrix[1][3];
+          p[2] = matrix[2][0] * x0[0] + matrix[2][1] * x0[1] + matrix[2][2] * x0[2] + matrix[2][3];
+          newPts->SetPoint(ptIncr + i, p);
         }
-      }
-    }
-
-    // Clamp data scale if enabled
-    if (this->Clamping)
-    {
-      scalex = (scalex < this->Range[0] ? this->Range[0]
-                                        : (scalex > this->Range[1] ? this->Range[1] : scalex));
-      scalex = (scalex - this->Range[0]) / den;
-      scaley = (scaley < this->Range[0] ? this->Range[0]
-                                        : (scaley > this->Range[1] ? this->Range[1] : scaley));
-      scaley = (scaley - this->Range[0]) / den;
-      scalez = (scalez < this->Range[0] ? this->Range[0]
-                                        : (scalez > this->Range[1] ? this->Range[1] : scalez));
-      scalez = (scalez - this->Range[0]) / den;
-    }
-
-    // Compute index into table of glyphs
-    if (this->IndexMode != VTK_INDEXING_OFF)
-    {
-      if (this->IndexMode == VTK_INDEXING_BY_SCALAR)
-      {
-        value = s;
-      }
-      else
-      {
-        value = vMag;
-      }
-
-      int index = static_cast<int>((value - this->Range[0]) * numberOfSources / den);
-      index = (index < 0 ? 0 : (index >= numberOfSources ? (numberOfSources - 1) : index));
-
-      source = this->GetSource(index, sourceVector);
-      if (source != nullptr)
-      {
-        sourcePts = source->GetPoints();
-        sourceNormals = source->GetPointData()->GetNormals();
-        numSourcePts = sourcePts->GetNumberOfPoints();
-        numSourceCells = source->GetNumberOfCells();
-      }
-    }
-
-    // Make sure we're not indexing into empty glyph
-    if (source == nullptr)
-    {
-      continue;
-    }
-
-    // Check ghost points.
-    // If we are processing a piece, we do not want to duplicate glyphs on the borders.
-    if (inGhostLevels &&
-      inGhostLevels[inPtId] &
-        (vtkDataSetAttributes::DUPLICATEPOINT | vtkDataSetAttributes::HIDDENPOINT))
-    {
-      continue;
-    }
-
-    if (inputUG && !inputUG->IsPointVisible(inPtId))
-    {
-      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
-      // it.
-      continue;
-    }
-
-    if (!this->IsPointVisible(input, inPtId))
-    {
-      continue;
-    }
-
-    // Now begin copying/transforming glyph
-    trans->Identity();
-
-    // Copy all topology (transformation independent)
-    for (cellId = 0; cellId < numSourceCells; cellId++)
-    {
-      source->GetCellPoints(cellId, pointIdList);
-      cellPts = pointIdList;
-      npts = cellPts->GetNumberOfIds();
-      for (pts->Reset(), i = 0; i < npts; i++)
-      {
-        pts->InsertId(i, cellPts->GetId(i) + ptIncr);
-      }
-      output->InsertNextCell(source->GetCellType(cellId), pts);
-    }
-
-    // translate Source to Input point
-    input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
-
-    if (haveVectors)
-    {
-      // Copy Input vector
-      for (i = 0; i < numSourcePts; i++)
-      {
-        newVectors->InsertTuple(i + ptIncr, v);
-      }
-      if (this->Orient)
-      {
-        if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
+        if (normalsPtr)
         {
-          // v = glyphNormal_World (glyph normal direction in World coordinate system)
-          v[0] = this->FollowedCameraPosition[0] - x[0];
-          v[1] = this->FollowedCameraPosition[1] - x[1];
-          v[2] = this->FollowedCameraPosition[2] - x[2];
-          vtkMath::Normalize(v);
-          double glyphRight_World[3]; // glyph right direction in World coordinate system
-          vtkMath::Cross(this->FollowedCameraViewUp, v, glyphRight_World);
-          // glyph up direction in World coordinate system
-          // (approximately the same as this->FollowedCameraViewUp, but slightly adjusted to be
-          // orthogonal to the normal direction)
-          double glyphUp_World[3];
-          vtkMath::Cross(v, glyphRight_World, glyphUp_World);
-          double glyphToWorld[16] = { glyphRight_World[0], glyphUp_World[0], v[0], 0.0,
-            glyphRight_World[1], glyphUp_World[1], v[1], 0.0, glyphRight_World[2], glyphUp_World[2],
-            v[2], 0.0, 0.0, 0.0, 0.0, 1.0 };
-          trans->Concatenate(glyphToWorld);
+          vtkMatrix4x4::Invert(*matrix, *normalMatrix);
+          vtkMatrix4x4::Transpose(*normalMatrix, *normalMatrix);
+          for (vtkIdType i = 0; i < numSourcePts; ++i)
+          {
+            const double* n0 = &glyph.Normals[3 * i];
+            float* n = normalsPtr + 3 * (ptIncr + i);
+            for (int j = 0; j < 3; ++j)
+            {
+              n[j] = static_cast<float>(normalMatrix[j][0] * n0[0] + normalMatrix[j][1] * n0[1] +
+                normalMatrix[j][2] * n0[2]);
+            }
+            vtkMath::Normalize(n);
+          }
         }
-        else if (vMag > 0.0)
+
+        for (vtkIdType i = 0; i < numSourcePts; ++i)
         {
-          // if there is no y or z component
-          if (v[1] == 0.0 && v[2] == 0.0)
+          if (vectorsPtr)
+          {
+            // Copy Input vector
+            for (int j = 0; j < 3; ++j)
+            {
+              vectorsPtr[3 * (ptIncr + i) + j] = static_cast<float>(values.V[j]);
+            }
+          }
+          if (tcoordsPtr)
           {
-            if (v[0] < 0) // just flip x if we need to
+            const int numComps = glyph.NumberOfTCoordComponents;
+            for (int j = 0; j < numComps; ++j)
             {
-              trans->RotateWXYZ(180.0, 0, 1, 0);
+              tcoordsPtr[numComps * (ptIncr + i) + j] =
+                static_cast<float>(glyph.TCoords[numComps * i + j]);
             }
           }
-          else
+          // determine scale factor from scalars if appropriate
+          if (scalarsPtr)
           {
-            vNew[0] = (v[0] + vMag) / 2.0;
-            vNew[1] = v[1] / 2.0;
-            vNew[2] = v[2] / 2.0;
-            trans->RotateWXYZ(180.0, vNew[0], vNew[1], vNew[2]);
+            scalarsPtr[ptIncr + i] = static_cast<float>(
+              this->ColorMode == VTK_COLOR_BY_SCALE ? values.ColorScale : values.VMag);
           }
+          // If point ids are to be generated, do it here
+          if (pointIdsPtr)
+          {
+            pointIdsPtr[ptIncr + i] = inPtId;
+          }
+          srcPointIds[ptIncr + i] = inPtId;
         }
-      }
-    }
-
-    if (haveTCoords)
-    {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        sourceTCoords->GetTuple(i, tc);
-        newTCoords->InsertTuple(i + ptIncr, tc);
-      }
-    }
 
-    // determine scale factor from scalars if appropriate
-    // Copy scalar value
-    if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
-    {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        newScalars->InsertTuple(i + ptIncr, &scalex); // = scaley = scalez
-      }
-    }
-    else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
-    {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr + i);
-      }
-    }
-    if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
-    {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        newScalars->InsertTuple(i + ptIncr, &vMag);
+        offsets.Add(glyph);
       }
     }
+  });
+  this->UpdateProgress(0.8);
 
-    // scale data if appropriate
-    if (this->Scaling)
-    {
-      if (this->ScaleMode == VTK_DATA_SCALING_OFF)
-      {
-        scalex = scaley = scalez = this->ScaleFactor;
-      }
-      else
-      {
-        scalex *= this->ScaleFactor;
-        scaley *= this->ScaleFactor;
-        scalez *= this->ScaleFactor;
-      }
-
-      if (scalex == 0.0)
-      {
-        scalex = 1.0e-10;
-      }
-      if (scaley == 0.0)
-      {
-        scaley = 1.0e-10;
-      }
-      if (scalez == 0.0)
-      {
-        scalez = 1.0e-10;
-      }
-      trans->Scale(scalex, scaley, scalez);
-    }
-
-    // multiply points and normals by resulting matrix
-    if (this->SourceTransform)
-    {
-      transformedSourcePts->Reset();
-      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
-      trans->TransformPoints(transformedSourcePts, newPts);
-    }
-    else
+  // Copy the scalars and the point data of the input points.
+  if (this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars && numOutPts > 0)
+  {
+    newScalars->InsertTuplesStartingAt(0, srcPointIdList, inCScalars);
+  }
+  if (pd && numOutPts > 0)
+  {
+    outputPD->CopyData(pd, srcPointIdList);
+    if (this->FillCellData && !instanced)
     {
-      trans->TransformPoints(sourcePts, newPts);
+      outputCD->CopyData(pd, srcCellIdList);
     }
+  }
 
-    if (haveNormals)
+  // Update ourselves and release memory
+  //
+  output->SetPoints(newPts);
+  if (!instanced)
+  {
+    vtkNew<vtkCellArray> newCells[4];
+    for (int type = 0; type < 4; ++type)
     {
-      trans->TransformNormals(sourceNormals, newNormals);
+      newCells[type]->SetData(newOffsets[type], newConnectivity[type]);
     }
-
-    // Copy point data from source (if possible)
-    if (pd)
-    {
-      for (i = 0; i < numSourcePts; ++i)
-      {
-        srcPointIdList->SetId(i, inPtId);
-        dstPointIdList->SetId(i, ptIncr + i);
-      }
-      outputPD->CopyData(pd, srcPointIdList, dstPointIdList);
-      if (this->FillCellData)
-      {
-        for (i = 0; i < numSourceCells; ++i)
-        {
-          srcCellIdList->SetId(i, inPtId);
-          dstCellIdList->SetId(i, cellIncr + i);
-        }
-        outputCD->CopyData(pd, srcCellIdList, dstCellIdList);
-      }
-    }
-
-    // If point ids are to be generated, do it here
-    if (this->GeneratePointIds)
+    output->SetVerts(newCells[0]);
+    output->SetLines(newCells[1]);
+    output->SetPolys(newCells[2]);
+    output->SetStrips(newCells[3]);
+  }
+  else
+  {
+    outputPD->AddArray(orientations);
+    outputPD->AddArray(scales);
+    if (this->IndexMode != VTK_INDEXING_OFF)
     {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        pointIds->InsertNextValue(inPtId);
-      }
+      outputPD->AddArray(sourceIndices);
     }
-
-    ptIncr += numSourcePts;
-    cellIncr += numSourceCells;
   }
 
-  // Update ourselves and release memory
-  //
-  output->SetPoints(newPts);
-  newPts->Delete();
-
   if (newScalars)
   {
     int idx = outputPD->AddArray(newScalars);
@@ -751,8 +1119,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   }
 
   output->Squeeze();
-  trans->Delete();
-  pts->Delete();
 
   return true;
 }
@@ -904,6 +1270,7 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Output Mode: " << this->GetOutputModeAsString() << "\n";
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
@@ -953,6 +1320,23 @@ vtkPolyData* vtkGlyph3D::GetSource(int idx, vtkInformationVector* sourceInfo)
   return vtkPolyData::SafeDownCast(info->Get(vtkDataObject::DATA_OBJECT()));
 }
 
+//------------------------------------------------------------------------------
+vtkMultiBlockDataSet* vtkGlyph3D::GetGlyphTable()
+{
+  return vtkMultiBlockDataSet::SafeDownCast(this->GetOutputDataObject(1));
+}
+
+//------------------------------------------------------------------------------
+int vtkGlyph3D::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 1)
+  {
+    info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkMultiBlockDataSet");
+    return 1;
+  }
+  return this->Superclass::FillOutputPortInformation(port, info);
+}
+
 //------------------------------------------------------------------------------
 int vtkGlyph3D::FillInputPortInformation(int port, vtkInformation* info)
 {
@@ -73,6 +73,19 @@
  * vtkAlgorithm. The first array is scalars, the next vectors, the next
  * normals and finally color scalars.
  *
+ * @warning
+ * The glyphs are computed concurrently with vtkSMPTools, so subclasses
+ * overriding IsPointVisible() must make it thread safe. The output cells are
+ * ordered by type (verts, lines, polys then strips) like the cell arrays of
+ * vtkPolyData.
+ *
+ * @warning
+ * Replicating the glyph geometry for millions of points produces very large
+ * outputs. With SetOutputModeToInstancedGlyphs(), the output only holds one
+ * point per glyph with its orientation, scale and color arrays, and the
+ * glyph sources are passed to the second output port (see GetGlyphTable()),
+ * so that a consumer such as vtkGlyph3DMapper can instance them.
+ *
  * @sa
  * vtkTensorGlyph
  */
@@ -101,6 +114,7 @@
 #define VTK_INDEXING_BY_SCALAR 1
 #define VTK_INDEXING_BY_VECTOR 2
 
+class vtkMultiBlockDataSet;
 class vtkTransform;
 
 class VTKFILTERSCORE_EXPORT vtkGlyph3D : public vtkPolyDataAlgorithm
@@ -332,6 +346,47 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  enum OutputModes
+  {
+    REPLICATED_GLYPHS = 0,
+    INSTANCED_GLYPHS = 1
+  };
+
+  ///@{
+  /**
+   * Specify how the glyphs are output. By default (REPLICATED_GLYPHS), the
+   * geometry of the source is transformed and copied for every glyphed
+   * point. With INSTANCED_GLYPHS, the output has one point per glyphed point
+   * and no cells, and the glyph geometry is left to the consumer. The output
+   * point data then holds:
+   * - "GlyphOrientation", the rotation of the glyph as a unit quaternion
+   *   (w, x, y, z),
+   * - "GlyphScaleFactors", the scale of the glyph along x, y and z, including
+   *   the ScaleFactor,
+   * - "GlyphSourceIndex", the index of the source in the glyph table, when
+   *   indexing is on,
+   * - the color scalars and the input point data, as for replicated glyphs.
+   * Scaling the glyph sources of GetGlyphTable() by the scale factors, rotating
+   * them by the orientation and translating them to the output point gives the
+   * replicated glyphs. For
+   * example, set up a vtkGlyph3DMapper with quaternion orientation and scaling
+   * by vector components using these arrays. Normals, texture coordinates and
+   * glyph vectors are not output, and FillCellData is ignored.
+   */
+  vtkSetClampMacro(OutputMode, int, REPLICATED_GLYPHS, INSTANCED_GLYPHS);
+  vtkGetMacro(OutputMode, int);
+  void SetOutputModeToReplicatedGlyphs() { this->SetOutputMode(REPLICATED_GLYPHS); }
+  void SetOutputModeToInstancedGlyphs() { this->SetOutputMode(INSTANCED_GLYPHS); }
+  const char* GetOutputModeAsString();
+  ///@}
+
+  /**
+   * Get the second output, which holds one block per glyph source when
+   * OutputMode is INSTANCED_GLYPHS. The sources are transformed by the
+   * SourceTransform, if any. It is empty with replicated glyphs.
+   */
+  vtkMultiBlockDataSet* GetGlyphTable();
+
 protected:
   vtkGlyph3D();
   ~vtkGlyph3D() override;
@@ -339,6 +394,7 @@ protected:
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
   int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
   int FillInputPortInformation(int, vtkInformation*) override;
+  int FillOutputPortInformation(int, vtkInformation*) override;
 
   vtkPolyData* GetSource(int idx, vtkInformationVector* sourceInfo);
 
@@ -371,6 +427,7 @@ protected:
   char* PointIdsName;
   vtkTransform* SourceTransform;
   int OutputPointsPrecision;
+  int OutputMode;
 
 private:
   vtkGlyph3D(const vtkGlyph3D&) = delete;
@@ -438,6 +495,21 @@ inline const char* vtkGlyph3D::GetVectorModeAsString()
   }
 }
 
+/**
+ * Return the output mode as a character string.
+ */
+inline const char* vtkGlyph3D::GetOutputModeAsString()
+{
+  if (this->OutputMode == INSTANCED_GLYPHS)
+  {
+    return "InstancedGlyphs";
+  }
+  else
+  {
+    return "ReplicatedGlyphs";
+  }
+}
+
 /**
  * Return the index mode as a character string.
  */
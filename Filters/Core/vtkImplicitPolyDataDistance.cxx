@@ -15,13 +15,15 @@
 #include "vtkImplicitPolyDataDistance.h"
 
 #include "vtkCellData.h"
-#include "vtkCellLocator.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
 #include "vtkTriangleFilter.h"
 
 vtkStandardNewMacro(vtkImplicitPolyDataDistance);
@@ -67,7 +69,7 @@ void vtkImplicitPolyDataDistance::SetInput(vtkPolyData* input)
     this->CreateDefaultLocator();
     this->Locator->SetDataSet(this->Input);
     this->Locator->SetTolerance(this->Tolerance);
-    this->Locator->SetNumberOfCellsPerBucket(10);
+    this->Locator->SetNumberOfCellsPerNode(10);
     this->Locator->CacheCellBoundsOn();
     this->Locator->AutomaticOn();
     this->Locator->BuildLocator();
@@ -104,7 +106,7 @@ void vtkImplicitPolyDataDistance::CreateDefaultLocator()
 {
   if (this->Locator == nullptr)
   {
-    this->Locator = vtkCellLocator::New();
+    this->Locator = vtkStaticCellLocator::New();
   }
 }
 
@@ -126,6 +128,14 @@ double vtkImplicitPolyDataDistance::EvaluateFunctionAndGetClosestPoint(
                                                    // vtkPolyData stored in p (normal not used).
 }
 
+//------------------------------------------------------------------------------
+double vtkImplicitPolyDataDistance::EvaluateFunctionAndGetClosestPoint(
+  double x[3], double closestPoint[3], vtkGenericCell* cell, vtkIdList* cellIds)
+{
+  double g[3];
+  return this->SharedEvaluate(x, g, closestPoint, cell, cellIds);
+}
+
 //------------------------------------------------------------------------------
 void vtkImplicitPolyDataDistance::EvaluateGradient(double x[3], double g[3])
 {
@@ -136,6 +146,15 @@ void vtkImplicitPolyDataDistance::EvaluateGradient(double x[3], double g[3])
 
 //------------------------------------------------------------------------------
 double vtkImplicitPolyDataDistance::SharedEvaluate(double x[3], double g[3], double closestPoint[3])
+{
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> cellIds;
+  return this->SharedEvaluate(x, g, closestPoint, cell, cellIds);
+}
+
+//------------------------------------------------------------------------------
+double vtkImplicitPolyDataDistance::SharedEvaluate(
+  double x[3], double g[3], double closestPoint[3], vtkGenericCell* cell, vtkIdList* idList)
 {
   // Set defaults
   double ret = this->NoValue;
@@ -169,7 +188,6 @@ double vtkImplicitPolyDataDistance::SharedEvaluate(double x[3], double g[3], dou
   }
 
   // Get point id of closest point in data set.
-  vtkSmartPointer<vtkGenericCell> cell = vtkSmartPointer<vtkGenericCell>::New();
   this->Locator->FindClosestPoint(x, p, cell, cellId, subId, vlen2);
 
   if (cellId != -1) // point located
@@ -185,7 +203,6 @@ double vtkImplicitPolyDataDistance::SharedEvaluate(double x[3], double g[3], dou
     double dist2, weights[3], pcoords[3], awnorm[3] = { 0, 0, 0 };
     cell->EvaluatePosition(p, closestPoint, subId, pcoords, dist2, weights);
 
-    vtkIdList* idList = vtkIdList::New();
     int count = 0;
     for (int i = 0; i < 3; i++)
     {
@@ -238,7 +255,8 @@ double vtkImplicitPolyDataDistance::SharedEvaluate(double x[3], double g[3], dou
         }
         else
         {
-          vtkPolygon::ComputeNormal(this->Input->GetCell(idList->GetId(i))->GetPoints(), norm);
+          this->Input->GetCell(idList->GetId(i), cell);
+          vtkPolygon::ComputeNormal(cell->Points, norm);
         }
         awnorm[0] += norm[0];
         awnorm[1] += norm[1];
@@ -273,25 +291,26 @@ double vtkImplicitPolyDataDistance::SharedEvaluate(double x[3], double g[3], dou
       for (int i = 0; i < idList->GetNumberOfIds(); i++)
       {
         double norm[3];
+        this->Input->GetCell(idList->GetId(i), cell);
         if (cnorms)
         {
           cnorms->GetTuple(idList->GetId(i), norm);
         }
         else
         {
-          vtkPolygon::ComputeNormal(this->Input->GetCell(idList->GetId(i))->GetPoints(), norm);
+          vtkPolygon::ComputeNormal(cell->Points, norm);
         }
 
         // Compute angle at point a
-        int b = this->Input->GetCell(idList->GetId(i))->GetPointId(0);
-        int c = this->Input->GetCell(idList->GetId(i))->GetPointId(1);
+        int b = cell->GetPointId(0);
+        int c = cell->GetPointId(1);
         if (a == b)
         {
-          b = this->Input->GetCell(idList->GetId(i))->GetPointId(2);
+          b = cell->GetPointId(2);
         }
         else if (a == c)
         {
-          c = this->Input->GetCell(idList->GetId(i))->GetPointId(2);
+          c = cell->GetPointId(2);
         }
         double pa[3], pb[3], pc[3];
         this->Input->GetPoint(a, pa);
@@ -311,7 +330,6 @@ double vtkImplicitPolyDataDistance::SharedEvaluate(double x[3], double g[3], dou
       }
       vtkMath::Normalize(awnorm);
     }
-    idList->Delete();
 
     // sign(dist) = dot(grad, cell normal)
     if (ret == 0)
@@ -26,6 +26,9 @@
  * vtkPolyData have a distance of zero. The gradient of the function
  * is the angle-weighted pseudonormal at the nearest point.
  *
+ * The nearest cell is found with a vtkStaticCellLocator. Once SetInput() has
+ * been called, the function can be evaluated from several threads.
+ *
  * Baerentzen, J. A. and Aanaes, H. (2005). Signed distance
  * computation using the angle weighted pseudonormal. IEEE
  * Transactions on Visualization and Computer Graphics, 11:243-253.
@@ -43,8 +46,10 @@
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkImplicitFunction.h"
 
-class vtkCellLocator;
+class vtkGenericCell;
+class vtkIdList;
 class vtkPolyData;
+class vtkStaticCellLocator;
 
 class VTKFILTERSCORE_EXPORT vtkImplicitPolyDataDistance : public vtkImplicitFunction
 {
@@ -75,6 +80,15 @@ public:
    */
   double EvaluateFunctionAndGetClosestPoint(double x[3], double closestPoint[3]);
 
+  /**
+   * Same as EvaluateFunctionAndGetClosestPoint(), but the cell and the list of
+   * cell ids used during the evaluation are passed in. This method is thread
+   * safe as long as each thread passes its own cell and cell ids, and
+   * SetInput() has been called from a single thread first.
+   */
+  double EvaluateFunctionAndGetClosestPoint(
+    double x[3], double closestPoint[3], vtkGenericCell* cell, vtkIdList* cellIds);
+
   /**
    * Set the input vtkPolyData used for the implicit function
    * evaluation.  Passes input through an internal instance of
@@ -128,6 +142,8 @@ protected:
   void CreateDefaultLocator();
 
   double SharedEvaluate(double x[3], double g[3], double closestPoint[3]);
+  double SharedEvaluate(double x[3], double g[3], double closestPoint[3], vtkGenericCell* cell,
+    vtkIdList* cellIds);
 
   double NoGradient[3];
   double NoClosestPoint[3];
@@ -135,7 +151,7 @@ protected:
   double Tolerance;
 
   vtkPolyData* Input;
-  vtkCellLocator* Locator;
+  vtkStaticCellLocator* Locator;
 
 private:
   vtkImplicitPolyDataDistance(const vtkImplicitPolyDataDistance&) = delete;
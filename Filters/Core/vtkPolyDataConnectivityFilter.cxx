@@ -12,25 +12,46 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkPolyDataConnectivityFilter.h"
 
-#include "vtkCell.h"
-#include "vtkCellArray.h"
-#include "vtkCellData.h"
+#include "vtkConnectedRegionsInternal.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
-#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 
-#include <algorithm> // for fill_n
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
+namespace
+{
+// Checks whether the range of the scalars of a cell qualifies it as being
+// connected.
+bool IsInScalarRange(const double range[2], const double scalarRange[2], bool full)
+{
+  if (full)
+  {
+    // All points in this cell must lie in the user supplied scalar range
+    // for this cell to qualify as being connected.
+    return range[0] >= scalarRange[0] && range[1] <= scalarRange[1];
+  }
+  // Any point from this cell must lie is the user supplied scalar range
+  // for this cell to qualify as being connected
+  return range[1] >= scalarRange[0] && range[0] <= scalarRange[1];
+}
+}
+
 // Construct with default extraction mode to extract largest regions.
 vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 {
@@ -51,6 +72,17 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->NeighborCellPointIds = vtkIdList::New();
   this->NeighborCellPointIds->Allocate(8);
 
+  this->Visited = nullptr;
+  this->PointMap = nullptr;
+  this->NewScalars = nullptr;
+  this->RegionNumber = 0;
+  this->PointNumber = 0;
+  this->NumCellsInRegion = 0;
+  this->InScalars = nullptr;
+  this->Mesh = nullptr;
+  this->PointIds = nullptr;
+  this->CellIds = nullptr;
+
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
@@ -81,23 +113,11 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
   vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, newCellId, i, pt;
-  vtkPoints* inPts;
-  vtkPoints* newPts;
-  vtkIdType *cells, id, n;
-  vtkIdType npts;
-  const vtkIdType* pts;
-  vtkIdType ncells;
-  vtkIdType maxCellsInRegion;
-  vtkIdType largestRegionId = 0;
-  vtkPointData *pd = input->GetPointData(), *outputPD = output->GetPointData();
-  vtkCellData *cd = input->GetCellData(), *outputCD = output->GetCellData();
-
   vtkDebugMacro(<< "Executing polygon connectivity filter.");
 
-  //  Check input/allocate storage
+  //  Check input
   //
-  inPts = input->GetPoints();
+  vtkPoints* inPts = input->GetPoints();
 
   if (inPts == nullptr)
   {
@@ -116,10 +136,10 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
 
   // See whether to consider scalar connectivity
   //
-  this->InScalars = input->GetPointData()->GetScalars();
+  vtkDataArray* inScalars = input->GetPointData()->GetScalars();
   if (!this->ScalarConnectivity)
   {
-    this->InScalars = nullptr;
+    inScalars = nullptr;
   }
   else
   {
@@ -129,316 +149,161 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
     }
   }
 
-  // Build cell structure
-  //
-  this->Mesh = vtkPolyData::New();
-  this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
-  this->UpdateProgress(0.10);
-
   // Remove all visited point ids
   this->VisitedPointIds->Reset();
 
-  // Initialize.  Keep track of points and cells visited.
+  // Build the components of the cells sharing points. With scalar
+  // connectivity, a cell is connected to its neighbors only if it is scalar
+  // connected.
   //
-  this->RegionSizes->Reset();
-  this->Visited = new vtkIdType[numCells];
-  std::fill_n(this->Visited, numCells, -1);
-  this->PointMap = new vtkIdType[numPts];
-  std::fill_n(this->PointMap, numPts, -1);
-
-  this->NewScalars = vtkIdTypeArray::New();
-  this->NewScalars->SetName("RegionId");
-  this->NewScalars->SetNumberOfTuples(numPts);
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    newPts->SetDataType(inPts->GetDataType());
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  ConnectedRegions regions(input);
+  if (inScalars)
   {
-    newPts->SetDataType(VTK_FLOAT);
+    const double scalarRange[2] = { this->ScalarRange[0], this->ScalarRange[1] };
+    const bool fullScalarConnectivity = this->FullScalarConnectivity != 0;
+    regions.Build([=](vtkIdType npts, const vtkIdType* pts) {
+      // Scalars are compared in single precision.
+      double range[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        const double s = static_cast<float>(inScalars->GetComponent(pts[i], 0));
+        range[0] = std::min(range[0], s);
+        range[1] = std::max(range[1], s);
+      }
+      return IsInScalarRange(range, scalarRange, fullScalarConnectivity);
+    });
   }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  else
   {
-    newPts->SetDataType(VTK_DOUBLE);
+    regions.Build([](vtkIdType, const vtkIdType*) { return true; });
   }
+  this->UpdateProgress(0.4);
 
-  newPts->Allocate(numPts);
-
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
+  // Label the cells with their region. Regions are numbered in the order of
+  // their first cell.
   //
-  this->Wave.reserve(numPts);
-  this->Wave2.reserve(numPts);
-
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
-
-  this->CellIds = vtkIdList::New();
-  this->CellIds->Allocate(8, VTK_CELL_SIZE);
-  this->PointIds = vtkIdList::New();
-  this->PointIds->Allocate(8, VTK_CELL_SIZE);
-
+  std::vector<vtkIdType> cellRegionIds;
+  vtkIdType largestRegionId = 0;
+  this->RegionSizes->Reset();
   if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
-  { // visit all cells marking with region number
-    for (cellId = 0; cellId < numCells; cellId++)
-    {
-      if (cellId && !(cellId % 5000))
-      {
-        this->UpdateProgress(0.1 + 0.8 * cellId / numCells);
-      }
-
-      if (this->Visited[cellId] < 0)
-      {
-        this->NumCellsInRegion = 0;
-        this->Wave.push_back(cellId);
-        this->TraverseAndMark();
-
-        if (this->NumCellsInRegion > maxCellsInRegion)
-        {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-        }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++, this->NumCellsInRegion);
-        this->Wave.clear();
-        this->Wave2.clear();
-      }
-    }
+  {
+    std::vector<vtkIdType> sizes;
+    const vtkIdType numRegions = regions.LabelAllRegions(cellRegionIds, sizes);
+    this->RegionSizes->SetNumberOfValues(numRegions);
+    std::copy(sizes.begin(), sizes.end(), this->RegionSizes->GetPointer(0));
+    largestRegionId = std::max_element(sizes.begin(), sizes.end()) - sizes.begin();
   }
   else // regions have been seeded, everything considered in same region
   {
-    this->NumCellsInRegion = 0;
-
+    std::vector<vtkIdType> seeds;
     if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS)
     {
-      for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        pt = this->Seeds->GetId(i);
-        if (pt >= 0)
-        {
-          this->Mesh->GetPointCells(pt, ncells, cells);
-          for (vtkIdType j = 0; j < ncells; ++j)
-          {
-            this->Wave.push_back(cells[j]);
-          }
-        }
-      }
+      seeds = regions.GetCellsUsingPoints(this->Seeds);
     }
     else if (this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS)
     {
-      for (i = 0; i < this->Seeds->GetNumberOfIds(); i++)
-      {
-        cellId = this->Seeds->GetId(i);
-        if (cellId >= 0)
-        {
-          this->Wave.push_back(cellId);
-        }
-      }
+      seeds.assign(this->Seeds->begin(), this->Seeds->end());
     }
     else if (this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION)
-    { // loop over points, find closest one
-      double minDist2, dist2, x[3];
-      int minId = 0;
-      for (minDist2 = VTK_DOUBLE_MAX, i = 0; i < numPts; i++)
-      {
-        inPts->GetPoint(i, x);
-        dist2 = vtkMath::Distance2BetweenPoints(x, this->ClosestPoint);
-        if (dist2 < minDist2)
-        {
-          minId = i;
-          minDist2 = dist2;
-        }
-      }
-      this->Mesh->GetPointCells(minId, ncells, cells);
-      for (vtkIdType j = 0; j < ncells; ++j)
-      {
-        this->Wave.push_back(cells[j]);
-      }
-    }
-    this->UpdateProgress(0.5);
-
-    // mark all seeded regions
-    this->TraverseAndMark();
-    this->RegionSizes->InsertValue(this->RegionNumber, this->NumCellsInRegion);
-    this->UpdateProgress(0.9);
-  } // else extracted seeded cells
-
-  vtkDebugMacro(<< "Extracted " << this->RegionNumber << " region(s)");
-
-  // Now that points and cells have been marked, traverse these lists pulling
-  // everything that has been visited.
-  //
-  // Pass through point data that has been visited
-  outputPD->CopyAllocate(pd);
-  outputCD->CopyAllocate(cd);
-
-  for (i = 0; i < numPts; i++)
-  {
-    if (this->PointMap[i] > -1)
     {
-      newPts->InsertPoint(this->PointMap[i], inPts->GetPoint(i));
-      outputPD->CopyData(pd, i, this->PointMap[i]);
+      vtkNew<vtkIdList> closestPoint;
+      closestPoint->InsertNextId(regions.FindClosestPoint(this->ClosestPoint));
+      seeds = regions.GetCellsUsingPoints(closestPoint);
     }
-  }
-
-  // if coloring regions; send down new scalar data
-  if (this->ColorRegions)
-  {
-    int idx = outputPD->AddArray(this->NewScalars);
-    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
-  }
-  this->NewScalars->Delete();
+    this->RegionSizes->InsertValue(0, regions.LabelSeededRegion(seeds, cellRegionIds));
+  } // else extracted seeded cells
 
-  output->SetPoints(newPts);
-  newPts->Delete();
+  vtkDebugMacro(<< "Extracted " << this->RegionSizes->GetNumberOfValues() << " region(s)");
+  this->UpdateProgress(0.7);
 
-  // Create output cells. Have to allocate storage first.
+  // Select the cells to extract.
   //
-  if ((n = input->GetVerts()->GetNumberOfCells()) > 0)
-  {
-    vtkCellArray* newVerts = vtkCellArray::New();
-    newVerts->AllocateEstimate(n, 1);
-    output->SetVerts(newVerts);
-    newVerts->Delete();
-  }
-  if ((n = input->GetLines()->GetNumberOfCells()) > 0)
+  std::vector<unsigned char> extract(numCells, 0);
+  std::vector<unsigned char> specifiedRegions;
+  if (this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS)
   {
-    vtkCellArray* newLines = vtkCellArray::New();
-    newLines->AllocateEstimate(n, 2);
-    output->SetLines(newLines);
-    newLines->Delete();
-  }
-  if ((n = input->GetPolys()->GetNumberOfCells()) > 0)
-  {
-    vtkCellArray* newPolys = vtkCellArray::New();
-    newPolys->AllocateEstimate(n, 3);
-    output->SetPolys(newPolys);
-    newPolys->Delete();
-  }
-  if ((n = input->GetStrips()->GetNumberOfCells()) > 0)
-  {
-    vtkCellArray* newStrips = vtkCellArray::New();
-    newStrips->AllocateEstimate(n, 5);
-    output->SetStrips(newStrips);
-    newStrips->Delete();
-  }
-
-  if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
-    this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS ||
-    this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION ||
-    this->ExtractionMode == VTK_EXTRACT_ALL_REGIONS)
-  { // extract any cell that's been visited
-    for (cellId = 0; cellId < numCells; cellId++)
+    specifiedRegions.assign(this->RegionSizes->GetNumberOfValues(), 0);
+    for (vtkIdType regionId : *this->SpecifiedRegionIds)
     {
-      if (this->Visited[cellId] >= 0)
+      if (regionId >= 0 && regionId < static_cast<vtkIdType>(specifiedRegions.size()))
       {
-        this->Mesh->GetCellPoints(cellId, npts, pts);
-        this->PointIds->Reset();
-        for (i = 0; i < npts; i++)
-        {
-          id = this->PointMap[pts[i]];
-          this->PointIds->InsertId(i, id);
-
-          // If we asked to mark the visited point ids, mark them.
-          if (this->MarkVisitedPointIds)
-          {
-            this->VisitedPointIds->InsertUniqueId(pts[i]);
-          }
-        }
-        newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId), this->PointIds);
-        outputCD->CopyData(cd, cellId, newCellId);
+        specifiedRegions[regionId] = 1;
       }
     }
   }
-  else if (this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS)
-  {
-    for (cellId = 0; cellId < numCells; cellId++)
+  const int extractionMode = this->ExtractionMode;
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
     {
-      int inReg, regionId;
-      if ((regionId = this->Visited[cellId]) >= 0)
+      const vtkIdType regionId = cellRegionIds[cellId];
+      if (extractionMode == VTK_EXTRACT_SPECIFIED_REGIONS)
       {
-        for (inReg = 0, i = 0; i < this->SpecifiedRegionIds->GetNumberOfIds(); i++)
-        {
-          if (regionId == this->SpecifiedRegionIds->GetId(i))
-          {
-            inReg = 1;
-            break;
-          }
-        }
-        if (inReg)
-        {
-          this->Mesh->GetCellPoints(cellId, npts, pts);
-          this->PointIds->Reset();
-          for (i = 0; i < npts; i++)
-          {
-            id = this->PointMap[pts[i]];
-            this->PointIds->InsertId(i, id);
-
-            // If we asked to mark the visited point ids, mark them.
-            if (this->MarkVisitedPointIds)
-            {
-              this->VisitedPointIds->InsertUniqueId(pts[i]);
-            }
-          }
-          newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId), this->PointIds);
-          outputCD->CopyData(cd, cellId, newCellId);
-        }
+        extract[cellId] = regionId >= 0 && specifiedRegions[regionId];
       }
-    }
-  }
-  else // extract largest region
-  {
-    for (cellId = 0; cellId < numCells; cellId++)
-    {
-      if (this->Visited[cellId] == largestRegionId)
+      else if (extractionMode == VTK_EXTRACT_LARGEST_REGION)
       {
-        this->Mesh->GetCellPoints(cellId, npts, pts);
-        this->PointIds->Reset();
-        for (i = 0; i < npts; i++)
-        {
-          id = this->PointMap[pts[i]];
-          this->PointIds->InsertId(i, id);
-
-          // If we asked to mark the visited point ids, mark them.
-          if (this->MarkVisitedPointIds)
-          {
-            this->VisitedPointIds->InsertUniqueId(pts[i]);
-          }
-        }
-        newCellId = output->InsertNextCell(this->Mesh->GetCellType(cellId), this->PointIds);
-        outputCD->CopyData(cd, cellId, newCellId);
+        extract[cellId] = regionId == largestRegionId;
+      }
+      else
+      {
+        extract[cellId] = regionId >= 0;
       }
     }
+  });
+
+  // Set the desired precision for the points in the output.
+  int pointsDataType = inPts->GetDataType();
+  if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    pointsDataType = VTK_FLOAT;
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsDataType = VTK_DOUBLE;
   }
 
-  delete[] this->Visited;
-  delete[] this->PointMap;
-  this->Mesh->Delete();
-  output->Squeeze();
-  this->CellIds->Delete();
-  this->PointIds->Delete();
+  // Pull the extracted cells, the points they use and their data.
+  //
+  vtkNew<vtkIdList> pointIds;
+  vtkNew<vtkIdList> cellIds;
+  ExtractFlaggedCells(input, extract, pointsDataType, output, pointIds, cellIds);
+  this->UpdateProgress(0.9);
 
-  int num = this->GetNumberOfExtractedRegions();
-  vtkIdType count = 0;
+  // If we asked to mark the visited point ids, mark them.
+  if (this->MarkVisitedPointIds)
+  {
+    this->VisitedPointIds->DeepCopy(pointIds);
+  }
 
-  for (int ii = 0; ii < num; ii++)
+  // if coloring regions; send down new scalar data. Points take the smallest
+  // region id of the cells using them.
+  if (this->ColorRegions)
   {
-    count += this->RegionSizes->GetValue(ii);
+    std::vector<vtkIdType> pointRegionIds;
+    regions.LabelPoints(cellRegionIds, pointRegionIds);
+
+    vtkNew<vtkIdTypeArray> newScalars;
+    newScalars->SetName("RegionId");
+    newScalars->SetNumberOfValues(pointIds->GetNumberOfIds());
+    vtkSMPTools::For(0, pointIds->GetNumberOfIds(), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        newScalars->SetValue(ptId, pointRegionIds[pointIds->GetId(ptId)]);
+      }
+    });
+
+    int idx = output->GetPointData()->AddArray(newScalars);
+    output->GetPointData()->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
   }
-  vtkDebugMacro(<< "Total # of cells accounted for: " << count);
+
   vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() << " cells");
 
   return 1;
 }
 
+//------------------------------------------------------------------------------
 // Mark current cell as visited and assign region number.  Note:
 // traversal occurs across shared vertices.
 //
@@ -529,28 +394,7 @@ int vtkPolyDataConnectivityFilter::IsScalarConnected(vtkIdType cellId)
     }
   }
 
-  // Check if the scalars lie within the user supplied scalar range.
-
-  if (this->FullScalarConnectivity)
-  {
-    // All points in this cell must lie in the user supplied scalar range
-    // for this cell to qualify as being connected.
-    if (range[0] >= this->ScalarRange[0] && range[1] <= this->ScalarRange[1])
-    {
-      return 1;
-    }
-  }
-  else
-  {
-    // Any point from this cell must lie is the user supplied scalar range
-    // for this cell to qualify as being connected
-    if (range[1] >= this->ScalarRange[0] && range[0] <= this->ScalarRange[1])
-    {
-      return 1;
-    }
-  }
-
-  return 0;
+  return IsInScalarRange(range, this->ScalarRange, this->FullScalarConnectivity != 0) ? 1 : 0;
 }
 
 //------------------------------------------------------------------------------
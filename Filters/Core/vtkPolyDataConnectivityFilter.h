@@ -43,6 +43,10 @@
  * This use of ScalarConnectivity is particularly useful for selecting cells
  * for later processing.
  *
+ * The regions are labelled in parallel with a union-find over the cells
+ * sharing points, and the number of cells of each region is computed in the
+ * same pass. The output points keep the order of the input points.
+ *
  * @sa
  * vtkConnectivityFilter
  */
@@ -50,9 +54,12 @@
 #ifndef vtkPolyDataConnectivityFilter_h
 #define vtkPolyDataConnectivityFilter_h
 
+#include "vtkDeprecation.h"      // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
+#include <vector> // For Wave
+
 #define VTK_EXTRACT_POINT_SEEDED_REGIONS 1
 #define VTK_EXTRACT_CELL_SEEDED_REGIONS 2
 #define VTK_EXTRACT_SPECIFIED_REGIONS 3
@@ -246,13 +253,16 @@ protected:
   vtkTypeBool FullScalarConnectivity;
 
   // Does this cell qualify as being scalar connected ?
+  VTK_DEPRECATED_IN_9_3_0("Regions are labelled in parallel by RequestData()")
   int IsScalarConnected(vtkIdType cellId);
 
   double ScalarRange[2];
 
+  VTK_DEPRECATED_IN_9_3_0("Regions are labelled in parallel by RequestData()")
   void TraverseAndMark();
 
-  // used to support algorithm execution
+  // used by the deprecated serial traversal above; RequestData() no longer
+  // sets them
   vtkDataArray* CellScalars;
   vtkIdList* NeighborCellPointIds;
   vtkIdType* Visited;
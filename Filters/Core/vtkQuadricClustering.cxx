@@ -15,33 +15,121 @@
 #include "vtkQuadricClustering.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkExecutive.h"
 #include "vtkFeatureEdges.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <numeric>
 #include <unordered_set> // keep track of inserted triangles
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkQuadricClustering);
 
 //------------------------------------------------------------------------------
-// PIMPLd STL set for keeping track of inserted cells
-struct vtkQuadricClusteringIdTypeHash
+// A triangle identified by the sorted bins of its points.
+struct vtkQuadricClusteringTriangleKey
 {
-  size_t operator()(vtkIdType val) const { return static_cast<size_t>(val); }
+  vtkIdType Bins[3];
+
+  vtkQuadricClusteringTriangleKey() = default;
+  vtkQuadricClusteringTriangleKey(const vtkIdType binIds[3])
+  {
+    this->Bins[0] = std::min(std::min(binIds[0], binIds[1]), binIds[2]);
+    this->Bins[2] = std::max(std::max(binIds[0], binIds[1]), binIds[2]);
+    this->Bins[1] = binIds[0] + binIds[1] + binIds[2] - this->Bins[0] - this->Bins[2];
+  }
+
+  bool operator==(const vtkQuadricClusteringTriangleKey& other) const
+  {
+    return this->Bins[0] == other.Bins[0] && this->Bins[1] == other.Bins[1] &&
+      this->Bins[2] == other.Bins[2];
+  }
+  bool operator<(const vtkQuadricClusteringTriangleKey& other) const
+  {
+    return std::lexicographical_compare(this->Bins, this->Bins + 3, other.Bins, other.Bins + 3);
+  }
 };
+
+struct vtkQuadricClusteringTriangleKeyHash
+{
+  size_t operator()(const vtkQuadricClusteringTriangleKey& key) const
+  {
+    size_t hash = static_cast<size_t>(key.Bins[0]);
+    hash = hash * 31 + static_cast<size_t>(key.Bins[1]);
+    return hash * 31 + static_cast<size_t>(key.Bins[2]);
+  }
+};
+
+// PIMPLd STL set for keeping track of inserted cells
 class vtkQuadricClusteringCellSet
-  : public std::unordered_set<vtkIdType, vtkQuadricClusteringIdTypeHash>
+  : public std::unordered_set<vtkQuadricClusteringTriangleKey, vtkQuadricClusteringTriangleKeyHash>
 {
 };
-typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
+
+namespace
+{
+// Call func(cellId, triId, triPtIds) for each triangle of the polygons (fans) or
+// triangle strips in [cellId, endCellId), in the order AddTriangle() is
+// called for them. triOffsets are the offsets of the triangles of the cells.
+template <typename Functor>
+void ForEachTriangle(vtkCellArray* cells, bool strips, const std::vector<vtkIdType>& triOffsets,
+  vtkIdType cellId, vtkIdType endCellId, Functor&& func)
+{
+  auto iter = vtk::TakeSmartPointer(cells->NewIterator());
+  vtkIdType numPts;
+  const vtkIdType* ptIds;
+  vtkIdType triPtIds[3];
+  for (; cellId < endCellId; ++cellId)
+  {
+    vtkIdType triId = triOffsets[cellId];
+    if (triId == triOffsets[cellId + 1])
+    {
+      continue;
+    }
+    iter->GetCellAtId(cellId, numPts, ptIds);
+    if (!strips)
+    {
+      triPtIds[0] = ptIds[0];
+      for (vtkIdType j = 0; j < numPts - 2; ++j, ++triId)
+      {
+        triPtIds[1] = ptIds[j + 1];
+        triPtIds[2] = ptIds[j + 2];
+        func(cellId, triId, triPtIds);
+      }
+    }
+    else
+    {
+      // Flip the order of every other triangle in the strip.
+      triPtIds[0] = ptIds[0];
+      triPtIds[1] = ptIds[1];
+      int odd = 0;
+      for (vtkIdType j = 2; j < numPts; ++j, ++triId)
+      {
+        triPtIds[2] = ptIds[j];
+        func(cellId, triId, triPtIds);
+        triPtIds[odd] = triPtIds[2];
+        odd = odd ? 0 : 1;
+      }
+    }
+  }
+}
+}
 
 //------------------------------------------------------------------------------
 // Construct with default NumberOfDivisions to 50, DivisionSpacing to 1
@@ -360,74 +448,226 @@ void vtkQuadricClustering::Append(vtkPolyData* pd)
 void vtkQuadricClustering::AddPolygons(
   vtkCellArray* polys, vtkPoints* points, int geometryFlag, vtkPolyData* input, vtkPolyData* output)
 {
-  const vtkIdType* ptIds = nullptr;
-  vtkIdType numPts = 0;
-  double pts0[3], pts1[3], pts2[3];
-  vtkIdType binIds[3];
-
-  double total = polys->GetNumberOfCells();
-  double curr = 0;
-  double step = total / 10;
-  if (step < 1000.0)
-  {
-    step = 1000.0;
-  }
-  double cstep = step;
-
-  for (polys->InitTraversal(); polys->GetNextCell(numPts, ptIds);)
-  {
-    points->GetPoint(ptIds[0], pts0);
-    binIds[0] = this->HashPoint(pts0);
-    for (vtkIdType j = 0; j < numPts - 2; j++) // creates triangles; assumes poly is convex
-    {
-      points->GetPoint(ptIds[j + 1], pts1);
-      binIds[1] = this->HashPoint(pts1);
-      points->GetPoint(ptIds[j + 2], pts2);
-      binIds[2] = this->HashPoint(pts2);
-      this->AddTriangle(binIds, pts0, pts1, pts2, geometryFlag, input, output);
-    }
-    ++this->InCellCount;
-    if (curr > cstep)
-    {
-      this->UpdateProgress(.6 + .2 * curr / total);
-      cstep += step;
-    }
-    curr += 1;
-  } // for all polygons
+  // Polygons are triangulated with a fan; assumes poly is convex.
+  this->AddTriangles(polys, false, points, geometryFlag, input, output);
 }
 
 //------------------------------------------------------------------------------
 void vtkQuadricClustering::AddStrips(vtkCellArray* strips, vtkPoints* points, int geometryFlag,
   vtkPolyData* input, vtkPolyData* output)
 {
-  const vtkIdType* ptIds = nullptr;
-  vtkIdType numPts = 0;
-  double pts[3][3];
-  vtkIdType binIds[3];
-  int odd; // Used to flip order of every other triangle in a strip.
-
-  for (strips->InitTraversal(); strips->GetNextCell(numPts, ptIds);)
-  {
-    points->GetPoint(ptIds[0], pts[0]);
-    binIds[0] = this->HashPoint(pts[0]);
-    points->GetPoint(ptIds[1], pts[1]);
-    binIds[1] = this->HashPoint(pts[1]);
-    // This internal loop handles triangle strips.
-    odd = 0;
-    for (vtkIdType j = 2; j < numPts; ++j)
+  this->AddTriangles(strips, true, points, geometryFlag, input, output);
+}
+
+//------------------------------------------------------------------------------
+// The bins of the points are computed with vtkSMPTools. The bins are then
+// split in ranges, one per thread, and each range visits all the
+// triangles in order, adding the quadrics of the corners in its bins and
+// checking the triangles whose lowest bin is in it for duplicates. Each bin
+// thus sums its quadrics in the order of the triangles, and the quadrics, the
+// vertex ids and the output triangles do not depend on the number of threads.
+void vtkQuadricClustering::AddTriangles(vtkCellArray* cells, bool strips, vtkPoints* points,
+  int geometryFlag, vtkPolyData* input, vtkPolyData* output)
+{
+  const vtkIdType numCells = cells->GetNumberOfCells();
+
+  // Offsets of the triangles of each cell.
+  std::vector<vtkIdType> triOffsets(numCells + 1, 0);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    for (; cellId < endCellId; ++cellId)
     {
-      points->GetPoint(ptIds[j], pts[2]);
-      binIds[2] = this->HashPoint(pts[2]);
-      this->AddTriangle(binIds, pts[0], pts[1], pts[2], geometryFlag, input, output);
-      pts[odd][0] = pts[2][0];
-      pts[odd][1] = pts[2][1];
-      pts[odd][2] = pts[2][2];
-      binIds[odd] = binIds[2];
-      // Toggle odd.
-      odd = odd ? 0 : 1;
+      triOffsets[cellId + 1] = std::max<vtkIdType>(cells->GetCellSize(cellId) - 2, 0);
     }
-    ++this->InCellCount;
+  });
+  std::partial_sum(triOffsets.begin(), triOffsets.end(), triOffsets.begin());
+  const vtkIdType numTris = triOffsets[numCells];
+
+  // Bins of the points.
+  const vtkIdType numPts = points->GetNumberOfPoints();
+  std::vector<vtkIdType> pointBins(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    double pt[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      points->GetPoint(ptId, pt);
+      pointBins[ptId] = this->HashPoint(pt);
+    }
+  });
+
+  // Add the quadrics to the bins of each range, and keep the triangles with
+  // three different bins that are, if duplicates are prevented, the first
+  // with their bins. The first use of the bins without a vertex is gathered,
+  // these bins are marked with a vertex id of -2 meanwhile.
+  const vtkIdType numBins =
+    this->NumberOfDivisions[0] * this->NumberOfDivisions[1] * this->NumberOfDivisions[2];
+  const vtkIdType numRanges =
+    std::min<vtkIdType>(vtkSMPTools::GetEstimatedNumberOfThreads(), numBins);
+  std::vector<unsigned char> keep(numTris, 0);
+  std::vector<std::vector<std::pair<vtkIdType, vtkIdType>>> rangeNewBins(numRanges);
+  std::vector<std::vector<vtkQuadricClusteringTriangleKey>> rangeKeptKeys(numRanges);
+  vtkSMPTools::For(0, numRanges, 1, [&](vtkIdType range, vtkIdType endRange) {
+    for (; range < endRange; ++range)
+    {
+      const vtkIdType firstBin = numBins * range / numRanges;
+      const vtkIdType endBin = numBins * (range + 1) / numRanges;
+      std::vector<std::pair<vtkIdType, vtkIdType>>& newBins = rangeNewBins[range];
+      vtkQuadricClusteringCellSet rangeCellSet;
+      std::vector<vtkQuadricClusteringTriangleKey>& keptKeys = rangeKeptKeys[range];
+      double pts[3][3], quadric[9], quadric4x4[4][4];
+      ForEachTriangle(cells, strips, triOffsets, 0, numCells,
+        [&](vtkIdType vtkNotUsed(cellId), vtkIdType triId, const vtkIdType* triPtIds) {
+          const vtkIdType binIds[3] = { pointBins[triPtIds[0]], pointBins[triPtIds[1]],
+            pointBins[triPtIds[2]] };
+          const bool distinctBins =
+            binIds[0] != binIds[1] && binIds[0] != binIds[2] && binIds[1] != binIds[2];
+          // Special condition for fast execution.
+          // Only add triangles that traverse three bins to quadrics.
+          if (this->UseInternalTriangles == 0 && !distinctBins)
+          {
+            return;
+          }
+
+          bool hasQuadric = false;
+          for (int i = 0; i < 3; ++i)
+          {
+            if (binIds[i] < firstBin || binIds[i] >= endBin)
+            {
+              continue;
+            }
+            PointQuadric& binQuadric = this->QuadricArray[binIds[i]];
+            // If the current quadric is not initialized, then clear it out.
+            if (binQuadric.Dimension > 2)
+            {
+              binQuadric.Dimension = 2;
+              this->InitializeQuadric(binQuadric.Quadric);
+            }
+            if (binQuadric.Dimension == 2)
+            { // Points and segments supersede triangles.
+              if (!hasQuadric)
+              {
+                for (int j = 0; j < 3; ++j)
+                {
+                  points->GetPoint(triPtIds[j], pts[j]);
+                }
+                vtkTriangle::ComputeQuadric(pts[0], pts[1], pts[2], quadric4x4);
+                quadric[0] = quadric4x4[0][0];
+                quadric[1] = quadric4x4[0][1];
+                quadric[2] = quadric4x4[0][2];
+                quadric[3] = quadric4x4[0][3];
+                quadric[4] = quadric4x4[1][1];
+                quadric[5] = quadric4x4[1][2];
+                quadric[6] = quadric4x4[1][3];
+                quadric[7] = quadric4x4[2][2];
+                quadric[8] = quadric4x4[2][3];
+                hasQuadric = true;
+              }
+              this->AddQuadric(binIds[i], quadric);
+            }
+            if (geometryFlag && binQuadric.VertexId == -1)
+            {
+              binQuadric.VertexId = -2;
+              newBins.emplace_back(3 * triId + i, binIds[i]);
+            }
+          }
+
+          if (!geometryFlag || !distinctBins)
+          {
+            return;
+          }
+          vtkQuadricClusteringTriangleKey key(binIds);
+          if (key.Bins[0] < firstBin || key.Bins[0] >= endBin)
+          {
+            return;
+          }
+          if (!this->PreventDuplicateCells)
+          {
+            keep[triId] = 1;
+          }
+          else if (this->CellSet->find(key) == this->CellSet->end() &&
+            rangeCellSet.insert(key).second)
+          {
+            keep[triId] = 1;
+            keptKeys.push_back(key);
+          }
+        });
+    }
+  });
+
+  if (!geometryFlag)
+  {
+    this->InCellCount += numCells;
+    return;
+  }
+
+  // Get the vertex from each new bin, in the order of the first use.
+  std::vector<std::pair<vtkIdType, vtkIdType>> newBins;
+  for (const auto& rangeBins : rangeNewBins)
+  {
+    newBins.insert(newBins.end(), rangeBins.begin(), rangeBins.end());
   }
+  std::sort(newBins.begin(), newBins.end());
+  for (const auto& newBin : newBins)
+  {
+    this->QuadricArray[newBin.second].VertexId = this->NumberOfBinsUsed++;
+  }
+
+  for (const auto& keptKeys : rangeKeptKeys)
+  {
+    this->CellSet->insert(keptKeys.begin(), keptKeys.end());
+  }
+
+  // Output ids of the kept triangles.
+  std::vector<vtkIdType> outTriIds(numTris + 1, 0);
+  for (vtkIdType triId = 0; triId < numTris; ++triId)
+  {
+    outTriIds[triId + 1] = outTriIds[triId] + keep[triId];
+  }
+  const vtkIdType numOutTris = outTriIds[numTris];
+
+  // Now add the triangles to the geometry.
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numOutTris + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numOutTris);
+  const bool copyCellData = this->CopyCellData && input;
+  vtkNew<vtkIdList> inCellIds, outCellIds;
+  if (copyCellData)
+  {
+    inCellIds->SetNumberOfIds(numOutTris);
+    outCellIds->SetNumberOfIds(numOutTris);
+  }
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    ForEachTriangle(cells, strips, triOffsets, cellId, endCellId,
+      [&](vtkIdType triCellId, vtkIdType triId, const vtkIdType* triPtIds) {
+        if (!keep[triId])
+        {
+          return;
+        }
+        const vtkIdType outTriId = outTriIds[triId];
+        offsets->SetValue(outTriId, 3 * outTriId);
+        for (int i = 0; i < 3; ++i)
+        {
+          connectivity->SetValue(
+            3 * outTriId + i, this->QuadricArray[pointBins[triPtIds[i]]].VertexId);
+        }
+        if (copyCellData)
+        {
+          inCellIds->SetId(outTriId, this->InCellCount + triCellId);
+          outCellIds->SetId(outTriId, this->OutCellCount + outTriId);
+        }
+      });
+  });
+  offsets->SetValue(numOutTris, 3 * numOutTris);
+  vtkNew<vtkCellArray> triangles;
+  triangles->SetData(offsets, connectivity);
+  this->OutputTriangleArray->Append(triangles);
+  if (copyCellData)
+  {
+    output->GetCellData()->CopyData(input->GetCellData(), inCellIds, outCellIds);
+  }
+
+  this->InCellCount += numCells;
+  this->OutCellCount += numOutTris;
 }
 
 //------------------------------------------------------------------------------
@@ -511,55 +751,9 @@ void vtkQuadricClustering::AddTriangle(vtkIdType* binIds, double* pt0, double* p
     {
       if (this->PreventDuplicateCells)
       {
-        vtkIdType minIdx = (binIds[0] < binIds[1] ? (binIds[0] < binIds[2] ? 0 : 2)
-                                                  : (binIds[1] < binIds[2] ? 1 : 2));
-        vtkIdType midIdx = 0;
-        vtkIdType maxIdx = 0;
-        switch (minIdx)
-        {
-          case 0:
-            if (binIds[1] > binIds[2])
-            {
-              maxIdx = 1;
-              midIdx = 2;
-            }
-            else
-            {
-              maxIdx = 2;
-              midIdx = 1;
-            }
-            break;
-          case 1:
-            if (binIds[0] > binIds[2])
-            {
-              maxIdx = 0;
-              midIdx = 2;
-            }
-            else
-            {
-              maxIdx = 2;
-              midIdx = 0;
-            }
-            break;
-          case 2:
-            if (binIds[0] > binIds[1])
-            {
-              maxIdx = 0;
-              midIdx = 1;
-            }
-            else
-            {
-              maxIdx = 1;
-              midIdx = 0;
-            }
-            break;
-        }
-        // TODO: this arithmetic overflows with the TestQuadricLODActor test.
-        vtkIdType idx = binIds[minIdx] + this->NumberOfBins * binIds[midIdx] +
-          this->NumberOfBins * this->NumberOfBins * binIds[maxIdx];
-        if (this->CellSet->find(idx) == this->CellSet->end())
+        vtkQuadricClusteringTriangleKey key(binIds);
+        if (this->CellSet->insert(key).second)
         {
-          this->CellSet->insert(idx);
           this->OutputTriangleArray->InsertNextCell(3, triPtIds);
           if (this->CopyCellData && input)
           {
@@ -891,16 +1085,8 @@ void vtkQuadricClustering::EndAppend()
   vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
   vtkIdType numBuckets;
-  int abortExecute = 0;
   vtkPoints* outputPoints;
-  double newPt[3];
   numBuckets = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] * this->NumberOfDivisions[2];
-  double step = (double)numBuckets / 10.0;
-  if (step < 1000.0)
-  {
-    step = 1000.0;
-  }
-  double cstep = 0;
 
   // Check for mis use of the Append methods.
   if (this->OutputTriangleArray == nullptr || this->OutputLines == nullptr)
@@ -918,23 +1104,22 @@ void vtkQuadricClustering::EndAppend()
 
   // Compute the representative points for each bin
   outputPoints = vtkPoints::New();
-  for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++)
+  outputPoints->SetNumberOfPoints(this->NumberOfBinsUsed);
+  if (!this->GetAbortExecute())
   {
-    if (cstep > step)
-    {
-      cstep = 0;
-      vtkDebugMacro(<< "Finding point in bin #" << i);
-      this->UpdateProgress(0.8 + 0.2 * i / numBuckets);
-      abortExecute = this->GetAbortExecute();
-    }
-    ++cstep;
-
-    if (this->QuadricArray[i].VertexId != -1)
-    {
-      this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
-      outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
-    }
+    vtkSMPTools::For(0, numBuckets, [&](vtkIdType binId, vtkIdType endBinId) {
+      double newPt[3];
+      for (; binId < endBinId; ++binId)
+      {
+        if (this->QuadricArray[binId].VertexId != -1)
+        {
+          this->ComputeRepresentativePoint(this->QuadricArray[binId].Quadric, binId, newPt);
+          outputPoints->SetPoint(this->QuadricArray[binId].VertexId, newPt);
+        }
+      }
+    });
   }
+  this->UpdateProgress(1.0);
 
   // Set up the output data object.
   output->SetPoints(outputPoints);
@@ -1199,13 +1384,9 @@ void vtkQuadricClustering::SetDivisionSpacing(double x, double y, double z)
 //------------------------------------------------------------------------------
 void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData* input, vtkPolyData* output)
 {
-  vtkIdType outPtId;
   vtkPoints* inputPoints;
   vtkPoints* outputPoints;
-  vtkIdType numPoints, numBins;
-  vtkIdType binId;
-  double *minError, e, pt[3];
-  double* q;
+  vtkIdType numPoints;
 
   inputPoints = input->GetPoints();
   if (inputPoints == nullptr)
@@ -1227,51 +1408,72 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData* input, vtkPolyData*
     this->CellSet = nullptr;
   }
 
-  outputPoints = vtkPoints::New();
-
-  // Prepare to copy point data to output
-  output->GetPointData()->CopyAllocate(input->GetPointData(), this->NumberOfBinsUsed);
+  // Compute the error of each input point for the quadric of its bin, in
+  // parallel. Points in bins without an output vertex get no error.
+  // This condition happens when there are points in the input that are
+  // not used in any triangles, and therefore are never added to the
+  // 3D hash structure.
+  numPoints = inputPoints->GetNumberOfPoints();
+  std::vector<vtkIdType> outPtIds(numPoints);
+  std::vector<double> errors(numPoints);
+  vtkSMPTools::For(0, numPoints, [&](vtkIdType ptId, vtkIdType endPtId) {
+    double pt[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      inputPoints->GetPoint(ptId, pt);
+      const vtkIdType binId = this->HashPoint(pt);
+      outPtIds[ptId] = this->QuadricArray[binId].VertexId;
+      if (outPtIds[ptId] == -1)
+      {
+        continue;
+      }
 
-  // Allocate and initialize an array to hold errors for each bin.
-  numBins = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] * this->NumberOfDivisions[2];
-  minError = new double[numBins];
-  for (vtkIdType i = 0; i < numBins; ++i)
-  {
-    minError[i] = VTK_DOUBLE_MAX;
-  }
+      // Compute the error for this point.  Note: the constant term is ignored.
+      // It will be the same for every point in this bin, and it
+      // is not stored in the quadric array anyway.
+      const double* q = this->QuadricArray[binId].Quadric;
+      errors[ptId] = q[0] * pt[0] * pt[0] + 2.0 * q[1] * pt[0] * pt[1] +
+        2.0 * q[2] * pt[0] * pt[2] + 2.0 * q[3] * pt[0] + q[4] * pt[1] * pt[1] +
+        2.0 * q[5] * pt[1] * pt[2] + 2.0 * q[6] * pt[1] + q[7] * pt[2] * pt[2] +
+        2.0 * q[8] * pt[2];
+    }
+  });
 
-  // Loop through the input points.
-  numPoints = inputPoints->GetNumberOfPoints();
+  // Keep the first input point with the lowest error in each bin.
+  std::vector<double> minError(this->NumberOfBinsUsed, VTK_DOUBLE_MAX);
+  std::vector<vtkIdType> bestPtIds(this->NumberOfBinsUsed, -1);
   for (vtkIdType i = 0; i < numPoints; ++i)
   {
-    inputPoints->GetPoint(i, pt);
-    binId = this->HashPoint(pt);
-    outPtId = this->QuadricArray[binId].VertexId;
-    // Sanity check.
-    if (outPtId == -1)
+    const vtkIdType outPtId = outPtIds[i];
+    if (outPtId != -1 && errors[i] < minError[outPtId])
     {
-      // This condition happens when there are points in the input that are
-      // not used in any triangles, and therefore are never added to the
-      // 3D hash structure.
-      continue;
+      minError[outPtId] = errors[i];
+      bestPtIds[outPtId] = i;
     }
+  }
 
-    // Compute the error for this point.  Note: the constant term is ignored.
-    // It will be the same for every point in this bin, and it
-    // is not stored in the quadric array anyway.
-    q = this->QuadricArray[binId].Quadric;
-    e = q[0] * pt[0] * pt[0] + 2.0 * q[1] * pt[0] * pt[1] + 2.0 * q[2] * pt[0] * pt[2] +
-      2.0 * q[3] * pt[0] + q[4] * pt[1] * pt[1] + 2.0 * q[5] * pt[1] * pt[2] + 2.0 * q[6] * pt[1] +
-      q[7] * pt[2] * pt[2] + 2.0 * q[8] * pt[2];
-    if (e < minError[binId])
+  // Since the output points are input points, copy point data here too.
+  outputPoints = vtkPoints::New();
+  outputPoints->SetNumberOfPoints(this->NumberOfBinsUsed);
+  vtkNew<vtkIdList> inPtIds, outPtIdList;
+  for (vtkIdType outPtId = 0; outPtId < this->NumberOfBinsUsed; ++outPtId)
+  {
+    if (bestPtIds[outPtId] != -1)
     {
-      minError[binId] = e;
-      outputPoints->InsertPoint(outPtId, pt);
-
-      // Since this is the same point as the input point, copy point data here too.
-      output->GetPointData()->CopyData(input->GetPointData(), i, outPtId);
+      inPtIds->InsertNextId(bestPtIds[outPtId]);
+      outPtIdList->InsertNextId(outPtId);
     }
   }
+  vtkSMPTools::For(0, inPtIds->GetNumberOfIds(), [&](vtkIdType i, vtkIdType end) {
+    double pt[3];
+    for (; i < end; ++i)
+    {
+      inputPoints->GetPoint(inPtIds->GetId(i), pt);
+      outputPoints->SetPoint(outPtIdList->GetId(i), pt);
+    }
+  });
+  output->GetPointData()->CopyAllocate(input->GetPointData(), this->NumberOfBinsUsed);
+  output->GetPointData()->CopyData(input->GetPointData(), inPtIds, outPtIdList);
 
   output->SetPolys(this->OutputTriangleArray);
   output->SetPoints(outputPoints);
@@ -1290,8 +1492,6 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData* input, vtkPolyData*
 
   delete[] this->QuadricArray;
   this->QuadricArray = nullptr;
-
-  delete[] minError;
 }
 
 //------------------------------------------------------------------------------
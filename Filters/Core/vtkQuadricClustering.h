@@ -294,6 +294,15 @@ protected:
     vtkPolyData* input, vtkPolyData* output);
   ///@}
 
+  /**
+   * Add the triangles of polygons (triangulated as fans) or of triangle
+   * strips to the quadric array with vtkSMPTools. The quadrics, the vertex
+   * ids of the bins and the output triangles are the same as if AddTriangle()
+   * was called on each triangle in order.
+   */
+  void AddTriangles(vtkCellArray* cells, bool strips, vtkPoints* points, int geometryFlag,
+    vtkPolyData* input, vtkPolyData* output);
+
   ///@{
   /**
    * Add edges to the quadric array.  If geometry flag is on then
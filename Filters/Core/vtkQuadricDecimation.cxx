@@ -53,10 +53,104 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+namespace
+{
+// Temporaries of ComputeCost and ComputeCost2, one set per thread.
+struct CostWorkspace
+{
+  std::vector<double> Quad;
+  std::vector<double> B;
+  std::vector<double> Data;
+  std::vector<double*> A;
+
+  void Initialize(int dim, int quadSize)
+  {
+    if (!this->A.empty())
+    {
+      return;
+    }
+    this->Quad.resize(quadSize);
+    this->B.resize(dim);
+    this->Data.resize(dim * dim);
+    this->A.resize(dim);
+    for (int i = 0; i < dim; i++)
+    {
+      this->A[i] = this->Data.data() + i * dim;
+    }
+  }
+};
+
+// Compute the geometric quadric of the plane orthogonal to the boundary edge
+// (t1, t2) of triangle (t0, t1, t2) and return its weight (the edge length).
+double ComputeBoundaryQuadric(const double t0[3], const double t1[3], const double t2[3], double* QEM)
+{
+  double e0[3], e1[3], n[3], c;
+  int j;
+
+  // computing a plane which is orthogonal to line t1, t2 and incident
+  // with it
+  for (j = 0; j < 3; j++)
+  {
+    e0[j] = t2[j] - t1[j];
+  }
+  for (j = 0; j < 3; j++)
+  {
+    e1[j] = t0[j] - t1[j];
+  }
+
+  // compute n so that it is orthogonal to e0 and parallel to the
+  // triangle
+  c = vtkMath::Dot(e0, e1) / (e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2]);
+  for (j = 0; j < 3; j++)
+  {
+    n[j] = e1[j] - c * e0[j];
+  }
+  vtkMath::Normalize(n);
+
+#if defined(_MSC_VER) && _MSC_VER >= 1929
+  // Visual Studio toolset starting at toolset 14.29.30133, when building in Release mode
+  // incorrectly optimizes away the line
+  //    QEM[9] = d * d;
+  // By making volatile, we are telling the compiler not to optimize out
+  // or reorder operations regarding this variable.
+  volatile
+#endif
+    double d = -vtkMath::Dot(n, t1);
+
+  // area issue ??
+  // could possible add in angle weights??
+  QEM[0] = n[0] * n[0];
+  QEM[1] = n[0] * n[1];
+  QEM[2] = n[0] * n[2];
+  QEM[3] = d * n[0];
+
+  QEM[4] = n[1] * n[1];
+  QEM[5] = n[1] * n[2];
+  QEM[6] = d * n[1];
+
+  QEM[7] = n[2] * n[2];
+  QEM[8] = d * n[2];
+
+  QEM[9] = d * d;
+
+  QEM[10] = 1;
+
+  // w *= w;
+  return vtkMath::Norm(e0);
+}
+}
+
 //------------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
 {
@@ -74,6 +168,7 @@ vtkQuadricDecimation::vtkQuadricDecimation()
 
   this->AttributeErrorMetric = 0;
   this->VolumePreservation = 0;
+  this->BatchCollapses = 0;
   this->ScalarsAttribute = 1;
   this->VectorsAttribute = 1;
   this->NormalsAttribute = 1;
@@ -226,6 +321,8 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
   this->Mesh->SetPoints(points);
   points->Delete();
   polys->DeepCopy(input->GetPolys());
+  // Direct pointers to the connectivity keep GetCellPoints thread safe.
+  polys->ConvertToDefaultStorage();
   this->Mesh->SetPolys(polys);
   polys->Delete();
   if (this->AttributeErrorMetric)
@@ -300,25 +397,28 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
 
   vtkDebugMacro(<< "Computing Costs");
   // Compute the cost of and target point for collapsing each edge.
-  for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
+  vtkIdType numEdges = this->Edges->GetNumberOfEdges();
+  this->TargetPoints->SetNumberOfTuples(numEdges);
+  std::vector<double> costs(numEdges);
+  this->ComputeEdgeCosts(numEdges, nullptr, costs.data());
+  for (i = 0; i < numEdges; i++)
   {
-    if (this->AttributeErrorMetric)
-    {
-      cost = this->ComputeCost2(i, x);
-    }
-    else
-    {
-      cost = this->ComputeCost(i, x);
-    }
-    this->EdgeCosts->Insert(cost, i);
-    this->TargetPoints->InsertTuple(i, x);
+    this->EdgeCosts->Insert(costs[i], i);
   }
   this->UpdateProgress(0.20);
 
   // Okay collapse edges until desired reduction is reached
   this->ActualReduction = 0.0;
   this->NumberOfEdgeCollapses = 0;
-  edgeId = this->EdgeCosts->Pop(0, cost);
+  if (this->BatchCollapses)
+  {
+    this->CollapseEdgesInBatches(numPts, numTris);
+    edgeId = -1;
+  }
+  else
+  {
+    edgeId = this->EdgeCosts->Pop(0, cost);
+  }
 
   while (edgeId >= 0 && cost < VTK_DOUBLE_MAX && this->ActualReduction < this->TargetReduction)
   {
@@ -365,8 +465,7 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
     edgeId = this->EdgeCosts->Pop(0, cost);
   }
 
-  vtkDebugMacro(<< "Number Of Edge Collapses: " << this->NumberOfEdgeCollapses
-                << " Cost: " << cost);
+  vtkDebugMacro(<< "Number Of Edge Collapses: " << this->NumberOfEdgeCollapses);
 
   // clean up working data
   for (i = 0; i < numPts; i++)
@@ -421,17 +520,72 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
 
 //------------------------------------------------------------------------------
 void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
+{
+  const int quadSize = 11 + 4 * this->NumberOfComponents;
+  std::atomic<bool> factorFailed(false);
+
+  // Each point gathers the quadrics of its triangles, in the order of the
+  // triangles, so that the sums do not depend on the number of threads.
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<double> QEM(quadSize);
+    double n[3], d, triArea2;
+    vtkIdType ncells;
+    vtkIdType* cells;
+    int j;
+
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+    {
+      // clear and allocate the QEM of the point
+      double* quadric = this->ErrorQuadrics[ptId].Quadric = new double[quadSize];
+      std::fill(quadric, quadric + quadSize, 0.0);
+
+      this->Mesh->GetPointCells(ptId, ncells, cells);
+      for (vtkIdType i = 0; i < ncells; i++)
+      {
+        if (!this->ComputeTriangleQuadric(cells[i], QEM.data(), n, d, triArea2))
+        {
+          factorFailed = true;
+        }
+
+        // add the QEM of the face to the point
+        for (j = 0; j < quadSize; j++)
+        {
+          quadric[j] += QEM[j] * triArea2;
+        }
+
+        // Set volume constraint values g_vol and d_vol
+        if (this->VolumePreservation)
+        {
+          // Vector g_vol
+          for (j = 0; j < 3; j++)
+          {
+            this->VolumeConstraints[ptId * 4 + j] +=
+              n[j] * triArea2 * 2.0; // triangle normal with length triArea * 2
+          }
+          // Scalar d_vol
+          this->VolumeConstraints[ptId * 4 + 3] +=
+            -d * triArea2 * 2.0; // (triangle normal with length triArea * 2) * (pts[0] position)
+        }
+      }
+    }
+  });
+
+  if (factorFailed)
+  {
+    vtkErrorMacro(<< "Unable to factor attribute matrix!");
+  }
+}
+
+//------------------------------------------------------------------------------
+int vtkQuadricDecimation::ComputeTriangleQuadric(
+  vtkIdType cellId, double* QEM, double n[3], double& d, double& triArea2)
 {
   vtkPolyData* input = this->Mesh;
-  double* QEM;
-  vtkIdType ptId;
-  int i, j;
-  vtkCellArray* polys;
+  int i;
   vtkIdType npts;
   const vtkIdType* pts = nullptr;
   double point0[3], point1[3], point2[3];
-  double n[3];
-  double tempP1[3], tempP2[3], d, triArea2;
+  double tempP1[3], tempP2[3];
   double data[16];
   double *A[4], x[4];
   int index[4];
@@ -440,278 +594,208 @@ void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
   A[2] = data + 8;
   A[3] = data + 12;
 
-  // allocate local QEM sparse matrix
-  QEM = new double[11 + 4 * this->NumberOfComponents];
+  input->GetCellPoints(cellId, npts, pts);
+  input->GetPoint(pts[0], point0);
+  input->GetPoint(pts[1], point1);
+  input->GetPoint(pts[2], point2);
+  for (i = 0; i < 3; i++)
+  {
+    tempP1[i] = point1[i] - point0[i];
+    tempP2[i] = point2[i] - point0[i];
+  }
+  vtkMath::Cross(tempP1, tempP2, n);
+  triArea2 = vtkMath::Normalize(n);
+  // triArea2 = (triArea2 * triArea2 * 0.25);
+  triArea2 = triArea2 * 0.5;
+  // I am unsure whether this should be squared or not??
+  d = -vtkMath::Dot(n, point0);
+  // could possible add in angle weights??
+
+  // set the geometric part of the QEM
+  QEM[0] = n[0] * n[0];
+  QEM[1] = n[0] * n[1];
+  QEM[2] = n[0] * n[2];
+  QEM[3] = d * n[0];
+
+  QEM[4] = n[1] * n[1];
+  QEM[5] = n[1] * n[2];
+  QEM[6] = d * n[1];
+
+  QEM[7] = n[2] * n[2];
+  QEM[8] = d * n[2];
+
+  QEM[9] = d * d;
+  QEM[10] = 1;
+
+  if (!this->AttributeErrorMetric)
+  {
+    return 1;
+  }
 
-  // clear and allocate global QEM array
-  for (ptId = 0; ptId < numPts; ptId++)
+  for (i = 0; i < 3; i++)
   {
-    this->ErrorQuadrics[ptId].Quadric = new double[11 + 4 * this->NumberOfComponents];
-    for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
-    {
-      this->ErrorQuadrics[ptId].Quadric[i] = 0.0;
-    }
+    A[0][i] = point0[i];
+    A[1][i] = point1[i];
+    A[2][i] = point2[i];
+    A[3][i] = n[i];
   }
+  A[0][3] = A[1][3] = A[2][3] = 1;
+  A[3][3] = 0;
 
-  polys = input->GetPolys();
-  // compute the QEM for each face
-  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  // should handle poorly condition matrix better
+  if (!vtkMath::LUFactorLinearSystem(A, index, 4))
   {
-    input->GetPoint(pts[0], point0);
-    input->GetPoint(pts[1], point1);
-    input->GetPoint(pts[2], point2);
-    for (i = 0; i < 3; i++)
-    {
-      tempP1[i] = point1[i] - point0[i];
-      tempP2[i] = point2[i] - point0[i];
-    }
-    vtkMath::Cross(tempP1, tempP2, n);
-    triArea2 = vtkMath::Normalize(n);
-    // triArea2 = (triArea2 * triArea2 * 0.25);
-    triArea2 = triArea2 * 0.5;
-    // I am unsure whether this should be squared or not??
-    d = -vtkMath::Dot(n, point0);
-    // could possible add in angle weights??
-
-    // set the geometric part of the QEM
-    QEM[0] = n[0] * n[0];
-    QEM[1] = n[0] * n[1];
-    QEM[2] = n[0] * n[2];
-    QEM[3] = d * n[0];
-
-    QEM[4] = n[1] * n[1];
-    QEM[5] = n[1] * n[2];
-    QEM[6] = d * n[1];
-
-    QEM[7] = n[2] * n[2];
-    QEM[8] = d * n[2];
-
-    QEM[9] = d * d;
-    QEM[10] = 1;
+    std::fill(QEM + 11, QEM + 11 + 4 * this->NumberOfComponents, 0.0);
+    return 0;
+  }
 
-    if (this->AttributeErrorMetric)
+  for (i = 0; i < this->NumberOfComponents; i++)
+  {
+    x[3] = 0;
+    if (i < this->AttributeComponents[0])
     {
-      for (i = 0; i < 3; i++)
-      {
-        A[0][i] = point0[i];
-        A[1][i] = point1[i];
-        A[2][i] = point2[i];
-        A[3][i] = n[i];
-      }
-      A[0][3] = A[1][3] = A[2][3] = 1;
-      A[3][3] = 0;
-
-      // should handle poorly condition matrix better
-      if (vtkMath::LUFactorLinearSystem(A, index, 4))
-      {
-        for (i = 0; i < this->NumberOfComponents; i++)
-        {
-          x[3] = 0;
-          if (i < this->AttributeComponents[0])
-          {
-            x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *
-              this->AttributeScale[0];
-            x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *
-              this->AttributeScale[0];
-            x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *
-              this->AttributeScale[0];
-          }
-          else if (i < this->AttributeComponents[1])
-          {
-            x[0] = input->GetPointData()->GetVectors()->GetComponent(
-                     pts[0], i - this->AttributeComponents[0]) *
-              this->AttributeScale[1];
-            x[1] = input->GetPointData()->GetVectors()->GetComponent(
-                     pts[1], i - this->AttributeComponents[0]) *
-              this->AttributeScale[1];
-            x[2] = input->GetPointData()->GetVectors()->GetComponent(
-                     pts[2], i - this->AttributeComponents[0]) *
-              this->AttributeScale[1];
-          }
-          else if (i < this->AttributeComponents[2])
-          {
-            x[0] = input->GetPointData()->GetNormals()->GetComponent(
-                     pts[0], i - this->AttributeComponents[1]) *
-              this->AttributeScale[2];
-            x[1] = input->GetPointData()->GetNormals()->GetComponent(
-                     pts[1], i - this->AttributeComponents[1]) *
-              this->AttributeScale[2];
-            x[2] = input->GetPointData()->GetNormals()->GetComponent(
-                     pts[2], i - this->AttributeComponents[1]) *
-              this->AttributeScale[2];
-          }
-          else if (i < this->AttributeComponents[3])
-          {
-            x[0] = input->GetPointData()->GetTCoords()->GetComponent(
-                     pts[0], i - this->AttributeComponents[2]) *
-              this->AttributeScale[3];
-            x[1] = input->GetPointData()->GetTCoords()->GetComponent(
-                     pts[1], i - this->AttributeComponents[2]) *
-              this->AttributeScale[3];
-            x[2] = input->GetPointData()->GetTCoords()->GetComponent(
-                     pts[2], i - this->AttributeComponents[2]) *
-              this->AttributeScale[3];
-          }
-          else if (i < this->AttributeComponents[4])
-          {
-            x[0] = input->GetPointData()->GetTensors()->GetComponent(
-                     pts[0], i - this->AttributeComponents[3]) *
-              this->AttributeScale[4];
-            x[1] = input->GetPointData()->GetTensors()->GetComponent(
-                     pts[1], i - this->AttributeComponents[3]) *
-              this->AttributeScale[4];
-            x[2] = input->GetPointData()->GetTensors()->GetComponent(
-                     pts[2], i - this->AttributeComponents[3]) *
-              this->AttributeScale[4];
-          }
-          vtkMath::LUSolveLinearSystem(A, index, x, 4);
-
-          // add in the contribution of this element into the QEM
-          QEM[0] += x[0] * x[0];
-          QEM[1] += x[0] * x[1];
-          QEM[2] += x[0] * x[2];
-          QEM[3] += x[3] * x[0];
-
-          QEM[4] += x[1] * x[1];
-          QEM[5] += x[1] * x[2];
-          QEM[6] += x[3] * x[1];
+      x[0] =
+        input->GetPointData()->GetScalars()->GetComponent(pts[0], i) * this->AttributeScale[0];
+      x[1] =
+        input->GetPointData()->GetScalars()->GetComponent(pts[1], i) * this->AttributeScale[0];
+      x[2] =
+        input->GetPointData()->GetScalars()->GetComponent(pts[2], i) * this->AttributeScale[0];
+    }
+    else if (i < this->AttributeComponents[1])
+    {
+      x[0] = input->GetPointData()->GetVectors()->GetComponent(
+               pts[0], i - this->AttributeComponents[0]) *
+        this->AttributeScale[1];
+      x[1] = input->GetPointData()->GetVectors()->GetComponent(
+               pts[1], i - this->AttributeComponents[0]) *
+        this->AttributeScale[1];
+      x[2] = input->GetPointData()->GetVectors()->GetComponent(
+               pts[2], i - this->AttributeComponents[0]) *
+        this->AttributeScale[1];
+    }
+    else if (i < this->AttributeComponents[2])
+    {
+      x[0] = input->GetPointData()->GetNormals()->GetComponent(
+               pts[0], i - this->AttributeComponents[1]) *
+        this->AttributeScale[2];
+      x[1] = input->GetPointData()->GetNormals()->GetComponent(
+               pts[1], i - this->AttributeComponents[1]) *
+        this->AttributeScale[2];
+      x[2] = input->GetPointData()->GetNormals()->GetComponent(
+               pts[2], i - this->AttributeComponents[1]) *
+        this->AttributeScale[2];
+    }
+    else if (i < this->AttributeComponents[3])
+    {
+      x[0] = input->GetPointData()->GetTCoords()->GetComponent(
+               pts[0], i - this->AttributeComponents[2]) *
+        this->AttributeScale[3];
+      x[1] = input->GetPointData()->GetTCoords()->GetComponent(
+               pts[1], i - this->AttributeComponents[2]) *
+        this->AttributeScale[3];
+      x[2] = input->GetPointData()->GetTCoords()->GetComponent(
+               pts[2], i - this->AttributeComponents[2]) *
+        this->AttributeScale[3];
+    }
+    else if (i < this->AttributeComponents[4])
+    {
+      x[0] = input->GetPointData()->GetTensors()->GetComponent(
+               pts[0], i - this->AttributeComponents[3]) *
+        this->AttributeScale[4];
+      x[1] = input->GetPointData()->GetTensors()->GetComponent(
+               pts[1], i - this->AttributeComponents[3]) *
+        this->AttributeScale[4];
+      x[2] = input->GetPointData()->GetTensors()->GetComponent(
+               pts[2], i - this->AttributeComponents[3]) *
+        this->AttributeScale[4];
+    }
+    vtkMath::LUSolveLinearSystem(A, index, x, 4);
 
-          QEM[7] += x[2] * x[2];
-          QEM[8] += x[3] * x[2];
+    // add in the contribution of this element into the QEM
+    QEM[0] += x[0] * x[0];
+    QEM[1] += x[0] * x[1];
+    QEM[2] += x[0] * x[2];
+    QEM[3] += x[3] * x[0];
 
-          QEM[9] += x[3] * x[3];
+    QEM[4] += x[1] * x[1];
+    QEM[5] += x[1] * x[2];
+    QEM[6] += x[3] * x[1];
 
-          QEM[11 + i * 4] = -x[0];
-          QEM[12 + i * 4] = -x[1];
-          QEM[13 + i * 4] = -x[2];
-          QEM[14 + i * 4] = -x[3];
-        }
-      }
-      else
-      {
-        vtkErrorMacro(<< "Unable to factor attribute matrix!");
-      }
-    }
+    QEM[7] += x[2] * x[2];
+    QEM[8] += x[3] * x[2];
 
-    // add the QEM to all points of the face
-    for (i = 0; i < 3; i++)
-    {
-      for (j = 0; j < 11 + 4 * this->NumberOfComponents; j++)
-      {
-        this->ErrorQuadrics[pts[i]].Quadric[j] += QEM[j] * triArea2;
-      }
+    QEM[9] += x[3] * x[3];
 
-      // Set volume constraint values g_vol and d_vol
-      if (this->VolumePreservation)
-      {
-        // Vector g_vol
-        for (j = 0; j < 3; j++)
-        {
-          this->VolumeConstraints[pts[i] * 4 + j] +=
-            n[j] * triArea2 * 2.0; // triangle normal with length triArea * 2
-        }
-        // Scalar d_vol
-        this->VolumeConstraints[pts[i] * 4 + 3] +=
-          -d * triArea2 * 2.0; // (triangle normal with length triArea * 2) * (pts[0] position)
-      }
-    }
-  } // for all triangles
+    QEM[11 + i * 4] = -x[0];
+    QEM[12 + i * 4] = -x[1];
+    QEM[13 + i * 4] = -x[2];
+    QEM[14 + i * 4] = -x[3];
+  }
 
-  delete[] QEM;
+  return 1;
 }
 
+//------------------------------------------------------------------------------
 void vtkQuadricDecimation::AddBoundaryConstraints()
 {
   vtkPolyData* input = this->Mesh;
-  double* QEM;
-  vtkIdType cellId;
-  int i, j;
-  vtkIdType npts;
-  const vtkIdType* pts;
-  double t0[3], t1[3], t2[3];
-  double e0[3], e1[3], n[3], c, w;
-  vtkIdList* cellIds = vtkIdList::New();
-
-  // allocate local QEM space matrix
-  QEM = new double[11 + 4 * this->NumberOfComponents];
-
-  for (cellId = 0; cellId < input->GetNumberOfCells(); cellId++)
-  {
-    input->GetCellPoints(cellId, npts, pts);
-
-    for (i = 0; i < 3; i++)
+  vtkSMPThreadLocalObject<vtkIdList> cellIds;
+
+  // As for the face quadrics, each point gathers the quadrics of its free
+  // boundary edges in the order of the triangles.
+  vtkSMPTools::For(0, input->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* neighbors = cellIds.Local();
+    double QEM[11];
+    double t0[3], t1[3], t2[3], w;
+    vtkIdType ncells, npts;
+    vtkIdType* cells;
+    const vtkIdType* pts;
+    int i, j;
+
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
     {
-      input->GetCellEdgeNeighbors(cellId, pts[i], pts[(i + 1) % 3], cellIds);
-      if (cellIds->GetNumberOfIds() == 0)
+      double* quadric = this->ErrorQuadrics[ptId].Quadric;
+      input->GetPointCells(ptId, ncells, cells);
+      for (vtkIdType c = 0; c < ncells; c++)
       {
-        // this is a boundary
-        input->GetPoint(pts[(i + 2) % 3], t0);
-        input->GetPoint(pts[i], t1);
-        input->GetPoint(pts[(i + 1) % 3], t2);
-
-        // computing a plane which is orthogonal to line t1, t2 and incident
-        // with it
-        for (j = 0; j < 3; j++)
+        // degenerate triangles are listed once per use of the point
+        if (c > 0 && cells[c] == cells[c - 1])
         {
-          e0[j] = t2[j] - t1[j];
+          continue;
         }
-        for (j = 0; j < 3; j++)
-        {
-          e1[j] = t0[j] - t1[j];
-        }
-
-        // compute n so that it is orthogonal to e0 and parallel to the
-        // triangle
-        c = vtkMath::Dot(e0, e1) / (e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2]);
-        for (j = 0; j < 3; j++)
-        {
-          n[j] = e1[j] - c * e0[j];
-        }
-        vtkMath::Normalize(n);
-
-#if defined(_MSC_VER) && _MSC_VER >= 1929
-        // Visual Studio toolset starting at toolset 14.29.30133, when building in Release mode
-        // incorrectly optimizes away the line
-        //    QEM[9] = d * d;
-        // By making volatile, we are telling the compiler not to optimize out
-        // or reorder operations regarding this variable.
-        volatile
-#endif
-          double d = -vtkMath::Dot(n, t1);
-        w = vtkMath::Norm(e0);
-
-        // w *= w;
-        // area issue ??
-        // could possible add in angle weights??
-        QEM[0] = n[0] * n[0];
-        QEM[1] = n[0] * n[1];
-        QEM[2] = n[0] * n[2];
-        QEM[3] = d * n[0];
-
-        QEM[4] = n[1] * n[1];
-        QEM[5] = n[1] * n[2];
-        QEM[6] = d * n[1];
-
-        QEM[7] = n[2] * n[2];
-        QEM[8] = d * n[2];
-
-        QEM[9] = d * d;
+        input->GetCellPoints(cells[c], npts, pts);
 
-        QEM[10] = 1;
-
-        // need to add orthogonal plane with the other Attributes, but this
-        // is not clear??
-        // check to interaction with attribute data
-        for (j = 0; j < 11; j++)
+        for (i = 0; i < 3; i++)
         {
-          this->ErrorQuadrics[pts[i]].Quadric[j] += QEM[j] * w;
-          this->ErrorQuadrics[pts[(i + 1) % 3]].Quadric[j] += QEM[j] * w;
+          const int uses = (pts[i] == ptId ? 1 : 0) + (pts[(i + 1) % 3] == ptId ? 1 : 0);
+          if (uses == 0)
+          {
+            continue;
+          }
+          input->GetCellEdgeNeighbors(cells[c], pts[i], pts[(i + 1) % 3], neighbors);
+          if (neighbors->GetNumberOfIds() == 0)
+          {
+            // this is a boundary
+            input->GetPoint(pts[(i + 2) % 3], t0);
+            input->GetPoint(pts[i], t1);
+            input->GetPoint(pts[(i + 1) % 3], t2);
+            w = ComputeBoundaryQuadric(t0, t1, t2, QEM);
+
+            // need to add orthogonal plane with the other Attributes, but this
+            // is not clear??
+            // check to interaction with attribute data
+            for (int use = 0; use < uses; use++)
+            {
+              for (j = 0; j < 11; j++)
+              {
+                quadric[j] += QEM[j] * w;
+              }
+            }
+          }
         }
       }
     }
-  }
-  cellIds->Delete();
-  delete[] QEM;
+  });
 }
 
 //------------------------------------------------------------------------------
@@ -774,6 +858,13 @@ void vtkQuadricDecimation::FindAffectedEdges(vtkIdType p1Id, vtkIdType p2Id, vtk
 
 // FIXME: memory allocation clean up
 void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
+{
+  this->UpdateEdgeData(pt0Id, pt1Id, nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkQuadricDecimation::UpdateEdgeData(
+  vtkIdType pt0Id, vtkIdType pt1Id, vtkIdList* updatedEdges)
 {
   vtkIdList* changedEdges = vtkIdList::New();
   vtkIdType i, edgeId, edge[2];
@@ -796,6 +887,7 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
     this->EdgeCosts->DeleteId(changedEdges->GetId(i));
 
     // Determine the new set of edges
+    edgeId = -1;
     if (edge[0] == pt1Id)
     {
       if (this->Edges->IsEdge(edge[1], pt0Id) == -1)
@@ -804,17 +896,6 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->Edges->InsertEdge(edge[1], pt0Id, edgeId);
         this->EndPoint1List->InsertId(edgeId, edge[1]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
-        // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric)
-        {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-        }
-        else
-        {
-          cost = this->ComputeCost(edgeId, this->TempX);
-        }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
       }
     }
     else if (edge[1] == pt1Id)
@@ -825,39 +906,262 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         this->Edges->InsertEdge(edge[0], pt0Id, edgeId);
         this->EndPoint1List->InsertId(edgeId, edge[0]);
         this->EndPoint2List->InsertId(edgeId, pt0Id);
-        // Compute cost (target point/data) and add to priority cue.
-        if (this->AttributeErrorMetric)
-        {
-          cost = this->ComputeCost2(edgeId, this->TempX);
-        }
-        else
-        {
-          cost = this->ComputeCost(edgeId, this->TempX);
-        }
-        this->EdgeCosts->Insert(cost, edgeId);
-        this->TargetPoints->InsertTuple(edgeId, this->TempX);
       }
     }
     else
     { // This edge already has one point as the merged point.
+      edgeId = changedEdges->GetId(i);
+    }
+
+    if (edgeId < 0)
+    {
+      continue;
+    }
+    if (updatedEdges)
+    {
+      updatedEdges->InsertNextId(edgeId);
+      continue;
+    }
+
+    // Compute cost (target point/data) and add to priority cue.
+    if (this->AttributeErrorMetric)
+    {
+      cost = this->ComputeCost2(edgeId, this->TempX);
+    }
+    else
+    {
+      cost = this->ComputeCost(edgeId, this->TempX);
+    }
+    this->EdgeCosts->Insert(cost, edgeId);
+    this->TargetPoints->InsertTuple(edgeId, this->TempX);
+  }
+
+  changedEdges->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkQuadricDecimation::ComputeEdgeCosts(
+  vtkIdType numEdges, const vtkIdType* edgeIds, double* costs)
+{
+  const int dim = 3 + this->NumberOfComponents + this->VolumePreservation;
+  const int quadSize = 11 + 4 * this->NumberOfComponents + this->VolumePreservation;
+  double* targets = this->TargetPoints->GetPointer(0);
+  vtkSMPThreadLocal<CostWorkspace> workspaces;
+
+  vtkSMPTools::For(0, numEdges, [&](vtkIdType begin, vtkIdType end) {
+    CostWorkspace& ws = workspaces.Local();
+    ws.Initialize(dim, quadSize);
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      const vtkIdType edgeId = edgeIds ? edgeIds[i] : i;
+      double* x = targets + edgeId * dim;
       if (this->AttributeErrorMetric)
       {
-        cost = this->ComputeCost2(changedEdges->GetId(i), this->TempX);
+        costs[i] = this->ComputeCost2(edgeId, x, ws.Quad.data(), ws.A.data(), ws.B.data());
       }
       else
       {
-        cost = this->ComputeCost(changedEdges->GetId(i), this->TempX);
+        costs[i] = this->ComputeCost(edgeId, x, ws.Quad.data());
       }
-      this->EdgeCosts->Insert(cost, changedEdges->GetId(i));
-      this->TargetPoints->InsertTuple(changedEdges->GetId(i), this->TempX);
     }
-  }
+  });
+}
 
-  changedEdges->Delete();
+//------------------------------------------------------------------------------
+void vtkQuadricDecimation::CollapseEdgesInBatches(vtkIdType numPts, vtkIdType numTris)
+{
+  const int dim = 3 + this->NumberOfComponents + this->VolumePreservation;
+  vtkIdType numDeletedTris = 0;
+  vtkIdType edgeId, endPtIds[2], ncells, npts, i, j, k;
+  vtkIdType* cells;
+  const vtkIdType* pts;
+  double cost;
+
+  // The points of the triangles around the edges of the current batch are
+  // stamped with 3 * batch, the end points of these edges with 3 * batch + 1
+  // and the end points of the edges actually collapsed with 3 * batch + 2.
+  std::vector<vtkIdType> stamps(numPts, -1);
+  std::vector<vtkIdType> batchEdges;
+  std::vector<std::pair<vtkIdType, double>> skippedEdges;
+  std::vector<unsigned char> goodPlacements;
+  std::vector<double> costs;
+  vtkNew<vtkIdList> updatedEdges;
+
+  for (vtkIdType batch = 0; this->ActualReduction < this->TargetReduction; batch++)
+  {
+    // Select the cheapest edges whose end points are not used by the triangles
+    // around the other edges of the batch, so that the collapses do not
+    // interact. The number of edges examined is bounded so that a batch does
+    // not collapse edges much more expensive than the ones skipped because
+    // of a conflict.
+    const vtkIdType maxPops = std::max<vtkIdType>(1024, (numTris - numDeletedTris) / 64);
+    const vtkIdType stamp = 3 * batch;
+    vtkIdType numExpectedDeletions = 0;
+    batchEdges.clear();
+    skippedEdges.clear();
+    for (vtkIdType pops = 0; pops < maxPops &&
+         static_cast<double>(numDeletedTris + numExpectedDeletions) / numTris <
+           this->TargetReduction;
+         pops++)
+    {
+      edgeId = this->EdgeCosts->Pop(0, cost);
+      if (edgeId < 0)
+      {
+        break;
+      }
+      if (cost >= VTK_DOUBLE_MAX)
+      {
+        this->EdgeCosts->Insert(cost, edgeId);
+        break;
+      }
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+
+      bool independent = stamps[endPtIds[0]] < stamp && stamps[endPtIds[1]] < stamp;
+      for (k = 0; k < 2 && independent; k++)
+      {
+        this->Mesh->GetPointCells(endPtIds[k], ncells, cells);
+        for (i = 0; i < ncells && independent; i++)
+        {
+          this->Mesh->GetCellPoints(cells[i], npts, pts);
+          for (j = 0; j < npts; j++)
+          {
+            if (stamps[pts[j]] > stamp)
+            {
+              independent = false;
+              break;
+            }
+          }
+        }
+      }
+      if (!independent)
+      {
+        skippedEdges.emplace_back(edgeId, cost);
+        continue;
+      }
+
+      // Stamp the neighborhood and count the triangles using the edge.
+      for (k = 0; k < 2; k++)
+      {
+        this->Mesh->GetPointCells(endPtIds[k], ncells, cells);
+        for (i = 0; i < ncells; i++)
+        {
+          this->Mesh->GetCellPoints(cells[i], npts, pts);
+          for (j = 0; j < npts; j++)
+          {
+            stamps[pts[j]] = std::max(stamps[pts[j]], stamp);
+            if (k == 0 && pts[j] == endPtIds[1])
+            {
+              numExpectedDeletions++;
+            }
+          }
+        }
+      }
+      stamps[endPtIds[0]] = stamps[endPtIds[1]] = stamp + 1;
+      batchEdges.push_back(edgeId);
+    }
+
+    if (batchEdges.empty())
+    {
+      break;
+    }
+
+    // Check the placement of the collapse points concurrently.
+    const vtkIdType numBatchEdges = static_cast<vtkIdType>(batchEdges.size());
+    goodPlacements.resize(numBatchEdges);
+    double* targets = this->TargetPoints->GetPointer(0);
+    vtkSMPTools::For(0, numBatchEdges, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType e = begin; e < end; e++)
+      {
+        const vtkIdType id = batchEdges[e];
+        goodPlacements[e] = static_cast<unsigned char>(this->IsGoodPlacement(
+          this->EndPoint1List->GetId(id), this->EndPoint2List->GetId(id), targets + id * dim));
+      }
+    });
+
+    // Skipped edges go back to the queue, except the ones using an end point
+    // of a collapsed edge which are updated by the collapse anyway.
+    for (k = 0; k < numBatchEdges; k++)
+    {
+      if (goodPlacements[k])
+      {
+        stamps[this->EndPoint1List->GetId(batchEdges[k])] = stamp + 2;
+        stamps[this->EndPoint2List->GetId(batchEdges[k])] = stamp + 2;
+      }
+    }
+    for (const auto& skipped : skippedEdges)
+    {
+      if (stamps[this->EndPoint1List->GetId(skipped.first)] != stamp + 2 &&
+        stamps[this->EndPoint2List->GetId(skipped.first)] != stamp + 2)
+      {
+        this->EdgeCosts->Insert(skipped.second, skipped.first);
+      }
+    }
+
+    // Collapse the edges. The collapses do not interact, so the edges they
+    // modify can be priced once the whole batch is collapsed.
+    updatedEdges->Reset();
+    for (k = 0; k < numBatchEdges; k++)
+    {
+      edgeId = batchEdges[k];
+      if (!goodPlacements[k])
+      {
+        // return the point to the queue but with the max cost so that
+        // when it is recomputed it will be reconsidered
+        this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
+        continue;
+      }
+
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+      this->NumberOfEdgeCollapses++;
+      this->SetPointAttributeArray(endPtIds[0], this->TargetPoints->GetPointer(edgeId * dim));
+      this->AddQuadric(endPtIds[1], endPtIds[0]);
+      this->UpdateEdgeData(endPtIds[0], endPtIds[1], updatedEdges);
+      numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
+    }
+
+    // Price the new and modified edges concurrently.
+    const vtkIdType numUpdatedEdges = updatedEdges->GetNumberOfIds();
+    const vtkIdType numEdges = this->Edges->GetNumberOfEdges();
+    if (numEdges * dim > this->TargetPoints->GetSize())
+    {
+      // Unlike SetNumberOfTuples, Resize keeps the existing target points.
+      this->TargetPoints->Resize(numEdges);
+    }
+    this->TargetPoints->SetNumberOfTuples(numEdges);
+    costs.resize(numUpdatedEdges);
+    this->ComputeEdgeCosts(numUpdatedEdges, updatedEdges->GetPointer(0), costs.data());
+    for (k = 0; k < numUpdatedEdges; k++)
+    {
+      this->EdgeCosts->Insert(costs[k], updatedEdges->GetId(k));
+    }
+
+    this->ActualReduction = static_cast<double>(numDeletedTris) / numTris;
+    vtkDebugMacro(<< "Batch " << batch << ": " << numBatchEdges << " edges, "
+                  << this->NumberOfEdgeCollapses << " collapses");
+    this->UpdateProgress(0.20 + 0.80 * this->NumberOfEdgeCollapses / numPts);
+    if (this->GetAbortExecute())
+    {
+      break;
+    }
+  }
 }
 
 //------------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
+{
+  return this->ComputeCost(edgeId, x, this->TempQuad);
+}
+
+//------------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
+{
+  return this->ComputeCost2(edgeId, x, this->TempQuad, this->TempA, this->TempB);
+}
+
+//------------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x, double* quad)
 {
   static const double errorNumber = 1e-10;
   double temp[3], A[3][3], b[3];
@@ -874,20 +1178,20 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
   {
-    this->TempQuad[i] =
+    quad[i] =
       this->ErrorQuadrics[pointIds[0]].Quadric[i] + this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
 
   norm = vtkMath::Norm(A[0]);
   normTemp = vtkMath::Norm(A[1]);
@@ -941,7 +1245,7 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
 
   // Compute the cost
   // x'*quad*x
-  index = this->TempQuad;
+  index = quad;
   for (i = 0; i < 4; i++)
   {
     cost += (*index++) * newPoint[i] * newPoint[i];
@@ -955,7 +1259,8 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
 }
 
 //------------------------------------------------------------------------------
-double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
+double vtkQuadricDecimation::ComputeCost2(
+  vtkIdType edgeId, double* x, double* quad, double** A, double* b)
 {
   // this function is so ugly because the functionality of converting an QEM
   // into a dense matrix was not extracted into a separate function and
@@ -971,29 +1276,29 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
   {
-    this->TempQuad[i] =
+    quad[i] =
       this->ErrorQuadrics[pointIds[0]].Quadric[i] + this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
   // copy the temp quad into TempA
   // converting from the sparse matrix format into a dense
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
-  this->TempB[0] = -this->TempQuad[3];
-  this->TempB[1] = -this->TempQuad[6];
-  this->TempB[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
 
   for (i = 3; i < 3 + this->NumberOfComponents; i++)
   {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11 + 4 * (i - 3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11 + 4 * (i - 3) + 1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11 + 4 * (i - 3) + 2];
-    this->TempB[i] = -this->TempQuad[11 + 4 * (i - 3) + 3];
+    A[0][i] = A[i][0] = quad[11 + 4 * (i - 3)];
+    A[1][i] = A[i][1] = quad[11 + 4 * (i - 3) + 1];
+    A[2][i] = A[i][2] = quad[11 + 4 * (i - 3) + 2];
+    b[i] = -quad[11 + 4 * (i - 3) + 3];
   }
 
   // Set zero to all components of the submatrix a[3:n;3:n] and al to its diagonal
@@ -1003,11 +1308,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i == j)
       {
-        this->TempA[i][j] = this->TempQuad[10];
+        A[i][j] = quad[10];
       }
       else
       {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
       }
     }
   }
@@ -1018,48 +1323,48 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i >= 3)
       {
-        this->TempA[i][3 + this->NumberOfComponents] = 0;
-        this->TempA[3 + this->NumberOfComponents][i] = 0;
+        A[i][3 + this->NumberOfComponents] = 0;
+        A[3 + this->NumberOfComponents][i] = 0;
       }
       else
       {
-        this->TempA[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[i][3 + this->NumberOfComponents] +=
+        A[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[i][3 + this->NumberOfComponents] +=
           this->VolumeConstraints[pointIds[1] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] +=
+        A[3 + this->NumberOfComponents][i] +=
           this->VolumeConstraints[pointIds[1] * 4 + i];
       }
     }
     // Add constraint to b
-    this->TempB[3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + 3];
-    this->TempB[3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + 3];
+    b[3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + 3];
+    b[3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + 3];
   }
 
   for (i = 0; i < 3 + this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    x[i] = this->TempB[i];
+    x[i] = b[i];
   }
 
   // solve A*x = b
   // this clobers A
   // need to develop a quality of the solution test??
   solveOk = vtkMath::SolveLinearSystem(
-    this->TempA, x, 3 + this->NumberOfComponents + this->VolumePreservation);
+    A, x, 3 + this->NumberOfComponents + this->VolumePreservation);
 
   // need to copy back into A
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
   for (i = 3; i < 3 + this->NumberOfComponents; i++)
   {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11 + 4 * (i - 3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11 + 4 * (i - 3) + 1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11 + 4 * (i - 3) + 2];
+    A[0][i] = A[i][0] = quad[11 + 4 * (i - 3)];
+    A[1][i] = A[i][1] = quad[11 + 4 * (i - 3) + 1];
+    A[2][i] = A[i][2] = quad[11 + 4 * (i - 3) + 2];
   }
 
   for (i = 3; i < 3 + this->NumberOfComponents; i++)
@@ -1068,11 +1373,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i == j)
       {
-        this->TempA[i][j] = this->TempQuad[10];
+        A[i][j] = quad[10];
       }
       else
       {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
       }
     }
   }
@@ -1083,16 +1388,16 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i >= 3)
       {
-        this->TempA[i][3 + this->NumberOfComponents] = 0;
-        this->TempA[3 + this->NumberOfComponents][i] = 0;
+        A[i][3 + this->NumberOfComponents] = 0;
+        A[3 + this->NumberOfComponents][i] = 0;
       }
       else
       {
-        this->TempA[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[i][3 + this->NumberOfComponents] +=
+        A[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[i][3 + this->NumberOfComponents] +=
           this->VolumeConstraints[pointIds[1] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] +=
+        A[3 + this->NumberOfComponents][i] +=
           this->VolumeConstraints[pointIds[1] * 4 + i];
       }
     }
@@ -1126,7 +1431,7 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
       temp2[i] = 0;
       for (j = 0; j < 3 + this->NumberOfComponents; ++j)
       {
-        temp2[i] += this->TempA[i][j] * v[j];
+        temp2[i] += A[i][j] * v[j];
       }
     }
 
@@ -1144,13 +1449,13 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
         temp[i] = 0;
         for (j = 0; j < 3 + this->NumberOfComponents; ++j)
         {
-          temp[i] += this->TempA[i][j] * pt1[j];
+          temp[i] += A[i][j] * pt1[j];
         }
       }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
       {
-        temp[i] = this->TempB[i] - temp[i];
+        temp[i] = b[i] - temp[i];
       }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
@@ -1184,18 +1489,18 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
   // x'*A*x - 2*b*x + d
   for (i = 0; i < 3 + this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    cost += this->TempA[i][i] * x[i] * x[i];
+    cost += A[i][i] * x[i] * x[i];
     for (j = i + 1; j < 3 + this->NumberOfComponents + this->VolumePreservation; j++)
     {
-      cost += 2.0 * this->TempA[i][j] * x[i] * x[j];
+      cost += 2.0 * A[i][j] * x[i] * x[j];
     }
   }
   for (i = 0; i < 3 + this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    cost -= 2.0 * this->TempB[i] * x[i];
+    cost -= 2.0 * b[i] * x[i];
   }
 
-  cost += this->TempQuad[9];
+  cost += quad[9];
 
   return cost;
 }
@@ -1465,6 +1770,7 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Attribute Error Metric: " << (this->AttributeErrorMetric ? "On\n" : "Off\n");
   os << indent << "Volume Preservation: " << (this->VolumePreservation ? "On\n" : "Off\n");
+  os << indent << "Batch Collapses: " << (this->BatchCollapses ? "On\n" : "Off\n");
   os << indent << "Scalars Attribute: " << (this->ScalarsAttribute ? "On\n" : "Off\n");
   os << indent << "Vectors Attribute: " << (this->VectorsAttribute ? "On\n" : "Off\n");
   os << indent << "Normals Attribute: " << (this->NormalsAttribute ? "On\n" : "Off\n");
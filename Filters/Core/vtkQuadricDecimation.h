@@ -40,6 +40,16 @@
  * taking into account variation in attributes (i.e., scalars, vectors, and
  * so on).
  *
+ * The quadrics and the initial edge costs are computed with vtkSMPTools.
+ * By default the edges are then collapsed one at a time in order of
+ * increasing cost. With BatchCollapses on, the filter instead repeatedly
+ * takes a batch of cheap edges whose end points do not touch each other's
+ * triangles (an independent set), then checks their placement and recomputes
+ * the costs of the edges they modify concurrently. This lets most of the work
+ * run in parallel on large meshes, at the cost of a slightly different (and
+ * usually marginally less accurate) result. In both modes the result does
+ * not depend on the number of threads.
+ *
  * This paper is based on the work of Garland and Heckbert who first
  * presented the quadric error measure at Siggraph '97 "Surface
  * Simplification Using Quadric Error Metrics". For details of the algorithm
@@ -148,6 +158,20 @@ public:
   vtkGetMacro(TensorsWeight, double);
   ///@}
 
+  ///@{
+  /**
+   * Collapse independent edges in batches instead of one edge at a time.
+   * The end points of an edge of a batch are not used by the triangles
+   * around the other edges of the batch, so their placement checks and the
+   * costs of the edges they modify are computed concurrently. TargetReduction,
+   * VolumePreservation and the attribute error metric are honored. By
+   * default BatchCollapses is off.
+   */
+  vtkSetMacro(BatchCollapses, vtkTypeBool);
+  vtkGetMacro(BatchCollapses, vtkTypeBool);
+  vtkBooleanMacro(BatchCollapses, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Get the actual reduction. This value is only valid after the
@@ -173,6 +197,14 @@ protected:
    */
   void InitializeQuadrics(vtkIdType numPts);
 
+  /**
+   * Compute the quadric of a triangle (without its area weight), its unit
+   * normal n and plane offset d, and return twice its area in triArea2.
+   * Return 0 if the attribute part of the quadric could not be computed.
+   */
+  int ComputeTriangleQuadric(
+    vtkIdType cellId, double* QEM, double n[3], double& d, double& triArea2);
+
   /**
    * Free boundary edges are weighted
    */
@@ -198,6 +230,28 @@ protected:
   double ComputeCost2(vtkIdType edgeId, double* x);
   ///@}
 
+  ///@{
+  /**
+   * Same as above, using the given temporaries instead of TempQuad, TempA
+   * and TempB so that costs can be computed concurrently.
+   */
+  double ComputeCost(vtkIdType edgeId, double* x, double* quad);
+  double ComputeCost2(vtkIdType edgeId, double* x, double* quad, double** A, double* b);
+  ///@}
+
+  /**
+   * Concurrently compute the cost and the target point of numEdges edges.
+   * If edgeIds is nullptr, the edges 0 to numEdges-1 are used. TargetPoints
+   * must already hold a tuple for each edge.
+   */
+  void ComputeEdgeCosts(vtkIdType numEdges, const vtkIdType* edgeIds, double* costs);
+
+  /**
+   * Collapse edges in batches of independent edges until the target
+   * reduction is reached (see BatchCollapses).
+   */
+  void CollapseEdgesInBatches(vtkIdType numPts, vtkIdType numTris);
+
   /**
    * Find all edges that will have an endpoint change ids because of an edge
    * collapse.  p1Id and p2Id are the endpoints of the edge.  p2Id is the
@@ -216,6 +270,13 @@ protected:
   void ComputeNumberOfComponents();
   void UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id);
 
+  /**
+   * Same as above, but when updatedEdges is given the ids of the new and
+   * modified edges are appended to it instead of being added to the
+   * priority queue with their new cost.
+   */
+  void UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id, vtkIdList* updatedEdges);
+
   ///@{
   /**
    * Helper function to set and get the point and it's attributes as an array
@@ -234,6 +295,7 @@ protected:
   double ActualReduction;
   vtkTypeBool AttributeErrorMetric;
   vtkTypeBool VolumePreservation;
+  vtkTypeBool BatchCollapses;
 
   vtkTypeBool ScalarsAttribute;
   vtkTypeBool VectorsAttribute;
@@ -16,21 +16,66 @@
 #include "vtkThreshold.h"
 
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
-#include "vtkCellIterator.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+// Parallel exclusive prefix sum, in place. Returns the total.
+vtkIdType ExclusiveScan(std::vector<vtkIdType>& values)
+{
+  const vtkIdType size = static_cast<vtkIdType>(values.size());
+  const vtkIdType blockSize = 65536;
+  const vtkIdType numBlocks = (size + blockSize - 1) / blockSize;
+  std::vector<vtkIdType> blockOffsets(numBlocks + 1, 0);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      const vtkIdType last = std::min(size, (block + 1) * blockSize);
+      blockOffsets[block + 1] = std::accumulate(
+        values.begin() + block * blockSize, values.begin() + last, static_cast<vtkIdType>(0));
+    }
+  });
+  std::partial_sum(blockOffsets.begin(), blockOffsets.end(), blockOffsets.begin());
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      vtkIdType offset = blockOffsets[block];
+      const vtkIdType last = std::min(size, (block + 1) * blockSize);
+      for (vtkIdType cc = block * blockSize; cc < last; ++cc)
+      {
+        const vtkIdType value = values[cc];
+        values[cc] = offset;
+        offset += value;
+      }
+    }
+  });
+  return blockOffsets[numBlocks];
+}
+}
 
 vtkStandardNewMacro(vtkThreshold);
 
@@ -140,49 +185,8 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
-  outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
-  outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
-
-  vtkIdType numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
-
-  vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::Take(vtkPoints::New());
-
-  // set precision for the points in the output
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
-    if (inputPointSet && inputPointSet->GetPoints())
-    {
-      newPoints->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      newPoints->SetDataType(VTK_FLOAT);
-    }
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPoints->SetDataType(VTK_FLOAT);
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPoints->SetDataType(VTK_DOUBLE);
-  }
-
-  newPoints->Allocate(numPts);
-
-  vtkSmartPointer<vtkIdList> pointMap =
-    vtkSmartPointer<vtkIdList>::Take(vtkIdList::New()); // maps old point ids into new
-  pointMap->SetNumberOfIds(numPts);
-  for (vtkIdType i = 0; i < numPts; i++)
-  {
-    pointMap->SetId(i, -1);
-  }
-
-  vtkSmartPointer<vtkIdList> newCellPts = vtkSmartPointer<vtkIdList>::Take(vtkIdList::New());
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
 
   // are we using pointScalars?
   int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
@@ -190,51 +194,42 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
 
   vtkUnsignedCharArray* ghosts = input->GetCellData()->GetGhostArray();
 
-  // Check that the scalars of each cell satisfy the threshold criterion
-  vtkSmartPointer<vtkCellIterator> it =
-    vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
-  vtkIdType numberOfCells = input->GetNumberOfCells();
-  vtkIdType index = 0;
-  const vtkIdType tenth = numberOfCells / 10 + 1;
-  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextCell())
+  // Make the input API thread safe by calling it once in a single thread.
+  vtkSMPThreadLocalObject<vtkIdList> cellPointIds;
+  if (numCells > 0)
   {
-    if (index % tenth == 0)
-    {
-      this->UpdateProgress(index * 1.0 / numberOfCells);
-    }
-    if (ghosts && ghosts->GetValue(index++) & vtkDataSetAttributes::HIDDENCELL)
-    {
-      continue;
-    }
-
-    int cellType = it->GetCellType();
-    if (cellType == VTK_EMPTY_CELL)
-    {
-      continue;
-    }
-
-    vtkIdType cellId = it->GetCellId();
-    vtkIdList* cellPts = it->GetPointIds();
-    int numCellPts = it->GetNumberOfPoints();
+    input->GetCellType(0);
+    input->GetCellPoints(0, cellPointIds.Local());
+  }
 
-    int keepCell(0);
-    if (usePointScalars)
+  // First pass: check that the scalars of each cell satisfy the threshold
+  // criterion. cellMap flags the extracted cells and cellOffsets holds their
+  // number of points; both are turned into output offsets by a prefix sum.
+  std::vector<vtkIdType> cellMap(numCells, 0);
+  std::vector<vtkIdType> cellOffsets(numCells, 0);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPts = cellPointIds.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
     {
-      if (this->AllScalars)
+      if (ghosts && ghosts->GetValue(cellId) & vtkDataSetAttributes::HIDDENCELL)
       {
-        keepCell = 1;
-        for (int i = 0; keepCell && (i < numCellPts); i++)
-        {
-          vtkIdType ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents(inScalars, ptId);
-        }
+        continue;
+      }
+      if (input->GetCellType(cellId) == VTK_EMPTY_CELL)
+      {
+        continue;
       }
-      else
+
+      input->GetCellPoints(cellId, cellPts);
+      int numCellPts = static_cast<int>(cellPts->GetNumberOfIds());
+
+      int keepCell(0);
+      if (usePointScalars)
       {
-        if (!this->UseContinuousCellRange)
+        if (this->AllScalars)
         {
-          keepCell = 0;
-          for (int i = 0; (!keepCell) && (i < numCellPts); i++)
+          keepCell = 1;
+          for (int i = 0; keepCell && (i < numCellPts); i++)
           {
             vtkIdType ptId = cellPts->GetId(i);
             keepCell = this->EvaluateComponents(inScalars, ptId);
@@ -242,57 +237,248 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
         }
         else
         {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+          if (!this->UseContinuousCellRange)
+          {
+            keepCell = 0;
+            for (int i = 0; (!keepCell) && (i < numCellPts); i++)
+            {
+              vtkIdType ptId = cellPts->GetId(i);
+              keepCell = this->EvaluateComponents(inScalars, ptId);
+            }
+          }
+          else
+          {
+            keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+          }
         }
       }
+      else // use cell scalars
+      {
+        keepCell = this->EvaluateComponents(inScalars, cellId);
+      }
+
+      // Invert the keep flag if the Invert option is enabled.
+      keepCell = this->Invert ? (1 - keepCell) : keepCell;
+
+      if (numCellPts > 0 && keepCell)
+      {
+        // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
+        cellMap[cellId] = 1;
+        cellOffsets[cellId] = numCellPts;
+      }
     }
-    else // use cell scalars
-    {
-      keepCell = this->EvaluateComponents(inScalars, cellId);
-    }
+  });
+  this->UpdateProgress(0.4);
 
-    // Invert the keep flag if the Invert option is enabled.
-    keepCell = this->Invert ? (1 - keepCell) : keepCell;
+  const vtkIdType numOutCells = ::ExclusiveScan(cellMap);
+  const vtkIdType connectivitySize = ::ExclusiveScan(cellOffsets);
+  auto isExtracted = [&cellMap, numCells, numOutCells](vtkIdType cellId) {
+    return (cellId + 1 < numCells ? cellMap[cellId + 1] : numOutCells) > cellMap[cellId];
+  };
 
-    if (numCellPts > 0 && keepCell)
-    {
-      // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
-      for (vtkIdType i = 0; i < numCellPts; i++)
+  // set precision for the points in the output
+  vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
+  vtkPoints* inPts = inputPointSet ? inputPointSet->GetPoints() : nullptr;
+  int pointsDataType = VTK_FLOAT;
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION && inPts)
+  {
+    pointsDataType = inPts->GetDataType();
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsDataType = VTK_DOUBLE;
+  }
+
+  // Second pass: number the points used by the extracted cells, in input
+  // order. pointMap is left empty when all the points are passed.
+  std::vector<vtkIdType> pointMap;
+  vtkIdType numOutPts = numPts;
+  if (this->RemoveUnusedPoints)
+  {
+    // Cells sharing a point mark it concurrently.
+    std::unique_ptr<std::atomic<unsigned char>[]> ptUses(new std::atomic<unsigned char>[numPts]());
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* cellPts = cellPointIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (isExtracted(cellId))
+        {
+          input->GetCellPoints(cellId, cellPts);
+          for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+          {
+            ptUses[cellPts->GetId(i)].store(1, std::memory_order_relaxed);
+          }
+        }
+      }
+    });
+    pointMap.resize(numPts);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
       {
-        vtkIdType ptId = cellPts->GetId(i);
-        vtkIdType newId = pointMap->GetId(ptId);
-        if (newId < 0)
+        pointMap[ptId] = ptUses[ptId].load(std::memory_order_relaxed);
+      }
+    });
+    numOutPts = ::ExclusiveScan(pointMap);
+  }
+  auto isUsed = [&pointMap, numPts, numOutPts](vtkIdType ptId) {
+    return pointMap.empty() ||
+      (ptId + 1 < numPts ? pointMap[ptId + 1] : numOutPts) > pointMap[ptId];
+  };
+  auto mapPoint = [&pointMap](vtkIdType ptId) {
+    return pointMap.empty() ? ptId : pointMap[ptId];
+  };
+  this->UpdateProgress(0.6);
+
+  vtkSmartPointer<vtkPoints> newPoints;
+  if (!this->RemoveUnusedPoints && inPts && inPts->GetDataType() == pointsDataType)
+  {
+    newPoints = inPts;
+  }
+  else
+  {
+    newPoints = vtkSmartPointer<vtkPoints>::New();
+    newPoints->SetDataType(pointsDataType);
+    newPoints->SetNumberOfPoints(numOutPts);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      double x[3];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        if (isUsed(ptId))
         {
-          double x[3];
           input->GetPoint(ptId, x);
-          newId = newPoints->InsertNextPoint(x);
-          pointMap->SetId(ptId, newId);
-          outPD->CopyData(pd, ptId, newId);
+          newPoints->SetPoint(mapPoint(ptId), x);
         }
-        newCellPts->InsertId(i, newId);
       }
-      // special handling for polyhedron cells
-      if (cellType == VTK_POLYHEDRON)
+    });
+  }
+
+  outPD->CopyGlobalIdsOn();
+  if (pointMap.empty())
+  {
+    outPD->PassData(pd);
+  }
+  else
+  {
+    vtkNew<vtkIdList> pointIds;
+    pointIds->SetNumberOfIds(numOutPts);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
       {
-        newCellPts->Reset();
-        vtkIdList* faces = it->GetFaces();
-        for (vtkIdType j = 0; j < faces->GetNumberOfIds(); ++j)
+        if (isUsed(ptId))
         {
-          newCellPts->InsertNextId(faces->GetId(j));
+          pointIds->SetId(pointMap[ptId], ptId);
         }
-        vtkUnstructuredGrid::ConvertFaceStreamPointIds(newCellPts, pointMap->GetPointer(0));
       }
-      vtkIdType newCellId = output->InsertNextCell(it->GetCellType(), newCellPts);
-      outCD->CopyData(cd, cellId, newCellId);
-      newCellPts->Reset();
-    } // satisfied thresholding
-  }   // for all cells
+    });
+    outPD->CopyAllocate(pd, numOutPts);
+    outPD->CopyData(pd, pointIds);
+  }
+  this->UpdateProgress(0.8);
+
+  // Last pass: copy the extracted cells.
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numOutCells + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connectivitySize);
+  vtkNew<vtkUnsignedCharArray> cellTypes;
+  cellTypes->SetNumberOfValues(numOutCells);
+  vtkNew<vtkIdList> cellIds;
+  cellIds->SetNumberOfIds(numOutCells);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPts = cellPointIds.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (!isExtracted(cellId))
+      {
+        continue;
+      }
+      const vtkIdType newCellId = cellMap[cellId];
+      const vtkIdType offset = cellOffsets[cellId];
+      input->GetCellPoints(cellId, cellPts);
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        connectivity->SetValue(offset + i, mapPoint(cellPts->GetId(i)));
+      }
+      offsets->SetValue(newCellId, offset);
+      cellTypes->SetValue(newCellId, static_cast<unsigned char>(input->GetCellType(cellId)));
+      cellIds->SetId(newCellId, cellId);
+    }
+  });
+  offsets->SetValue(numOutCells, connectivitySize);
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, connectivity);
+
+  // special handling for polyhedron cells
+  vtkUnstructuredGrid* inputGrid = vtkUnstructuredGrid::SafeDownCast(input);
+  vtkIdTypeArray* inFaces = inputGrid ? inputGrid->GetFaces() : nullptr;
+  vtkIdTypeArray* inFaceLocations = inputGrid ? inputGrid->GetFaceLocations() : nullptr;
+  vtkNew<vtkIdTypeArray> faces;
+  vtkNew<vtkIdTypeArray> faceLocations;
+  if (inFaces && inFaceLocations)
+  {
+    // Face streams are [numFaces, (numFacePts, ptIds...)...].
+    std::vector<vtkIdType> faceOffsets(numOutCells, 0);
+    vtkSMPTools::For(0, numOutCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType newCellId = begin; newCellId < end; ++newCellId)
+      {
+        const vtkIdType location = inFaceLocations->GetValue(cellIds->GetId(newCellId));
+        if (location >= 0)
+        {
+          const vtkIdType* stream = inFaces->GetPointer(location);
+          const vtkIdType* face = stream + 1;
+          for (vtkIdType j = 0; j < stream[0]; ++j)
+          {
+            face += *face + 1;
+          }
+          faceOffsets[newCellId] = face - stream;
+        }
+      }
+    });
+    faces->SetNumberOfValues(::ExclusiveScan(faceOffsets));
+    faceLocations->SetNumberOfValues(numOutCells);
+    vtkSMPTools::For(0, numOutCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType newCellId = begin; newCellId < end; ++newCellId)
+      {
+        const vtkIdType location = inFaceLocations->GetValue(cellIds->GetId(newCellId));
+        if (location < 0)
+        {
+          faceLocations->SetValue(newCellId, -1);
+          continue;
+        }
+        faceLocations->SetValue(newCellId, faceOffsets[newCellId]);
+        const vtkIdType* stream = inFaces->GetPointer(location);
+        vtkIdType* newStream = faces->GetPointer(faceOffsets[newCellId]);
+        const vtkIdType numFaces = *stream++;
+        *newStream++ = numFaces;
+        for (vtkIdType j = 0; j < numFaces; ++j)
+        {
+          const vtkIdType numFacePts = *stream++;
+          *newStream++ = numFacePts;
+          for (vtkIdType k = 0; k < numFacePts; ++k)
+          {
+            *newStream++ = mapPoint(*stream++);
+          }
+        }
+      }
+    });
+  }
+  if (faces->GetNumberOfValues() > 0)
+  {
+    output->SetCells(cellTypes, cells, faceLocations, faces);
+  }
+  else
+  {
+    output->SetCells(cellTypes, cells);
+  }
+
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(cd, numOutCells);
+  outCD->CopyData(cd, cellIds);
 
   vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() << " number of cells.");
 
   // now  update ourselves
   output->SetPoints(newPoints);
-  output->Squeeze();
 
   return 1;
 }
@@ -479,4 +665,5 @@ void vtkThreshold::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Upper Threshold: " << this->UpperThreshold << "\n";
   os << indent << "Precision of the output points: " << this->OutputPointsPrecision << "\n";
   os << indent << "Use Continuous Cell Range: " << this->UseContinuousCellRange << endl;
+  os << indent << "Remove Unused Points: " << this->RemoveUnusedPoints << endl;
 }
@@ -30,6 +30,10 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * The cells are classified and copied to the output in parallel using
+ * vtkSMPTools. The output points are the input points used by the extracted
+ * cells, in input order, unless RemoveUnusedPoints is off.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
  */
@@ -188,6 +192,19 @@ public:
   vtkBooleanMacro(Invert, bool);
   ///@}
 
+  ///@{
+  /**
+   * Indicate whether to eliminate the points that are not used by the output
+   * cells. When off, all the input points and point data are passed to the
+   * output without renumbering: the points are shallow copied when the input
+   * is a vtkPointSet and the output precision matches, which is much faster
+   * for large grids. Default is on.
+   */
+  vtkSetMacro(RemoveUnusedPoints, bool);
+  vtkGetMacro(RemoveUnusedPoints, bool);
+  vtkBooleanMacro(RemoveUnusedPoints, bool);
+  ///@}
+
   ///@{
   /**
    * Set/get the desired precision for the output types. See the documentation
@@ -230,6 +247,7 @@ protected:
   vtkTypeBool AllScalars = 1;
   vtkTypeBool UseContinuousCellRange = 0;
   bool Invert = false;
+  bool RemoveUnusedPoints = true;
   int AttributeMode = -1;
   int ComponentMode = VTK_COMPONENT_MODE_USE_SELECTED;
   int SelectedComponent = 0;
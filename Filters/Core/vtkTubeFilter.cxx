@@ -12,11 +12,17 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkTubeFilter.h"
 
+#include "vtkArrayListTemplate.h" // For processing attribute data
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -24,8 +30,13 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLine.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkTubeFilter);
 
@@ -82,6 +93,645 @@ struct IdPointsEqual
   vtkPoints* Points;
 };
 
+// Reasons for which a polyline is not tubed. They are reported once all the
+// polylines are processed.
+enum LineStatus : unsigned char
+{
+  LINE_TUBED = 0,
+  LINE_COINCIDENT_POINTS,
+  LINE_BAD_NORMAL,
+  LINE_NEGATIVE_SCALAR
+};
+
+// Generate the tubes around a range of polylines. The points, strips and
+// texture coordinates of each polyline are written at offsets computed
+// beforehand from the number of points of the polylines, so that the
+// polylines are tubed concurrently, in the same order as one at a time.
+struct GenerateTubes
+{
+  // Tube parameters
+  double Radius;
+  int VaryRadius;
+  double RadiusFactor;
+  int NumberOfSides;
+  bool SidesShareVertices;
+  bool Capping;
+  int OnRatio;
+  int SideOffset;
+  int GenerateTCoords;
+  double TextureLength;
+  double Theta;
+
+  // Input
+  vtkPoints* InPts;
+  vtkCellArray* InLines;
+  vtkIdType FirstCellId;
+  vtkDataArray* InNormals; // nullptr when normals are generated or the default one
+  bool GenerateNormals;
+  float DefaultNormal[3];
+  vtkDataArray* InScalars;
+  double Range[2];
+  vtkDataArray* InVectors;
+  double MaxSpeed;
+
+  // Layout of the output: number of points of each polyline once duplicate
+  // points are removed (0 if it is not tubed), and offsets of the points,
+  // cells and connectivity of the tube of each polyline.
+  std::vector<vtkIdType> NumberOfLinePoints;
+  std::vector<vtkIdType> PointOffsets;
+  std::vector<vtkIdType> CellOffsets;
+  std::vector<vtkIdType> ConnOffsets;
+  std::vector<unsigned char> Status;
+
+  // Output
+  vtkPoints* NewPts;
+  float* NewNormals;
+  float* NewTCoords;
+  ArrayList* PointArrays;
+  ArrayList* CellArrays;
+  vtkIdType* StripOffsets;
+  vtkIdType* StripConn;
+
+  struct LocalData
+  {
+    vtkSmartPointer<vtkCellArrayIterator> Iter;
+    std::vector<vtkIdType> Ids;
+    // Sliding normals of the polyline: the polyline is copied with local
+    // ids, a point used several times sharing the same id.
+    std::vector<std::pair<vtkIdType, vtkIdType>> SortedIds;
+    std::vector<vtkIdType> LocalIds;
+    vtkSmartPointer<vtkPoints> LinePts;
+    vtkSmartPointer<vtkCellArray> Line;
+    vtkSmartPointer<vtkFloatArray> LineNormals;
+  };
+  vtkSMPThreadLocal<LocalData> Local;
+
+  // Number of points of a tube, and of cells and connectivity of its strips.
+  vtkIdType GetNumberOfTubePoints(vtkIdType npts) const
+  {
+    return this->NumberOfSides * npts * (this->SidesShareVertices ? 1 : 2) +
+      (this->Capping ? 2 * this->NumberOfSides : 0);
+  }
+  vtkIdType GetNumberOfSideStrips() const
+  {
+    return (this->NumberOfSides + this->OnRatio - 1) / this->OnRatio;
+  }
+  vtkIdType GetNumberOfTubeCells() const
+  {
+    return this->GetNumberOfSideStrips() + (this->Capping ? 2 : 0);
+  }
+  vtkIdType GetTubeConnectivitySize(vtkIdType npts) const
+  {
+    return this->GetNumberOfSideStrips() * 2 * npts +
+      (this->Capping ? 2 * this->NumberOfSides : 0);
+  }
+
+  void Initialize()
+  {
+    LocalData& local = this->Local.Local();
+    local.Iter.TakeReference(this->InLines->NewIterator());
+    if (this->GenerateNormals)
+    {
+      local.LinePts = vtkSmartPointer<vtkPoints>::New();
+      local.LinePts->SetDataTypeToDouble();
+      local.Line = vtkSmartPointer<vtkCellArray>::New();
+      local.LineNormals = vtkSmartPointer<vtkFloatArray>::New();
+      local.LineNormals->SetNumberOfComponents(3);
+    }
+  }
+
+  // Gather the points of a polyline without consecutive duplicate points.
+  vtkIdType GetLinePoints(LocalData& local, vtkIdType lineId) const
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    local.Iter->GetCellAtId(lineId, npts, pts);
+    local.Ids.assign(pts, pts + npts);
+    return static_cast<vtkIdType>(
+      std::unique(local.Ids.begin(), local.Ids.end(), IdPointsEqual(this->InPts)) -
+      local.Ids.begin());
+  }
+
+  void CountPoints(vtkIdType lineId, vtkIdType endLineId)
+  {
+    LocalData& local = this->Local.Local();
+    if (!local.Iter)
+    {
+      this->Initialize();
+    }
+    for (; lineId < endLineId; ++lineId)
+    {
+      const vtkIdType npts = this->GetLinePoints(local, lineId);
+      this->NumberOfLinePoints[lineId] = (npts < 2 ? 0 : npts);
+    }
+  }
+
+  // Compute the sliding normals of a polyline independently of the other
+  // polylines.
+  void GenerateLineNormals(LocalData& local, vtkIdType npts, const vtkIdType* pts) const
+  {
+    local.SortedIds.resize(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      local.SortedIds[j] = std::make_pair(pts[j], j);
+    }
+    std::sort(local.SortedIds.begin(), local.SortedIds.end());
+    local.LocalIds.resize(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      local.LocalIds[local.SortedIds[j].second] =
+        (j > 0 && local.SortedIds[j].first == local.SortedIds[j - 1].first)
+        ? local.LocalIds[local.SortedIds[j - 1].second]
+        : local.SortedIds[j].second;
+    }
+
+    double x[3];
+    local.LinePts->SetNumberOfPoints(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      this->InPts->GetPoint(pts[j], x);
+      local.LinePts->SetPoint(j, x);
+    }
+    local.Line->Reset();
+    local.Line->InsertNextCell(npts, local.LocalIds.data());
+    local.LineNormals->Reset();
+    vtkPolyLine::GenerateSlidingNormals(local.LinePts, local.Line, local.LineNormals);
+  }
+
+  unsigned char GeneratePoints(
+    LocalData& local, vtkIdType offset, vtkIdType npts, const vtkIdType* pts) const
+  {
+    vtkIdType j;
+    int i, k;
+    double p[3];
+    double pNext[3];
+    double sNext[3] = { 0.0, 0.0, 0.0 };
+    double sPrev[3];
+    double startCapNorm[3], endCapNorm[3];
+    double n[3];
+    double s[3];
+    double w[3];
+    double nP[3];
+    double sFactor = 1.0;
+    double normal[3];
+    vtkIdType ptId = offset;
+
+    // Use "averaged" segment to create beveled effect.
+    // Watch out for first and last points.
+    //
+    for (j = 0; j < npts; j++)
+    {
+      if (j == 0) // first point
+      {
+        this->InPts->GetPoint(pts[0], p);
+        this->InPts->GetPoint(pts[1], pNext);
+        for (i = 0; i < 3; i++)
+        {
+          sNext[i] = pNext[i] - p[i];
+          sPrev[i] = sNext[i];
+          startCapNorm[i] = -sPrev[i];
+        }
+        vtkMath::Normalize(startCapNorm);
+      }
+      else if (j == (npts - 1)) // last point
+      {
+        for (i = 0; i < 3; i++)
+        {
+          sPrev[i] = sNext[i];
+          p[i] = pNext[i];
+          endCapNorm[i] = sNext[i];
+        }
+        vtkMath::Normalize(endCapNorm);
+      }
+      else
+      {
+        for (i = 0; i < 3; i++)
+        {
+          p[i] = pNext[i];
+        }
+        this->InPts->GetPoint(pts[j + 1], pNext);
+        for (i = 0; i < 3; i++)
+        {
+          sPrev[i] = sNext[i];
+          sNext[i] = pNext[i] - p[i];
+        }
+      }
+
+      if (this->GenerateNormals)
+      {
+        local.LineNormals->GetTuple(local.LocalIds[j], n);
+      }
+      else if (this->InNormals)
+      {
+        this->InNormals->GetTuple(pts[j], n);
+      }
+      else
+      {
+        for (i = 0; i < 3; i++)
+        {
+          n[i] = this->DefaultNormal[i];
+        }
+      }
+
+      if (vtkMath::Normalize(sNext) == 0.0)
+      {
+        return LINE_COINCIDENT_POINTS;
+      }
+
+      for (i = 0; i < 3; i++)
+      {
+        s[i] = (sPrev[i] + sNext[i]) / 2.0; // average vector
+      }
+      // if s is zero then just use sPrev cross n
+      if (vtkMath::Normalize(s) == 0.0)
+      {
+        vtkMath::Cross(sPrev, n, s);
+        vtkMath::Normalize(s);
+      }
+
+      vtkMath::Cross(s, n, w);
+      if (vtkMath::Normalize(w) == 0.0)
+      {
+        return LINE_BAD_NORMAL;
+      }
+
+      vtkMath::Cross(w, s, nP); // create orthogonal coordinate system
+      vtkMath::Normalize(nP);
+
+      // Compute a scale factor based on scalars or vectors
+      if (this->InScalars && this->VaryRadius == VTK_VARY_RADIUS_BY_SCALAR)
+      {
+        const double scalar = this->InScalars->GetComponent(pts[j], 0);
+        sFactor = 1.0 +
+          (this->RadiusFactor - 1.0) * (scalar - this->Range[0]) /
+            (this->Range[1] - this->Range[0]);
+      }
+      else if (this->InVectors && this->VaryRadius == VTK_VARY_RADIUS_BY_VECTOR)
+      {
+        double v[3];
+        this->InVectors->GetTuple(pts[j], v);
+        sFactor = sqrt(this->MaxSpeed / vtkMath::Norm(v));
+        if (sFactor > this->RadiusFactor)
+        {
+          sFactor = this->RadiusFactor;
+        }
+      }
+      else if (this->InVectors && this->VaryRadius == VTK_VARY_RADIUS_BY_VECTOR_NORM)
+      {
+        double v[3];
+        this->InVectors->GetTuple(pts[j], v);
+        sFactor = 1.0 + (this->RadiusFactor - 1.0) * vtkMath::Norm(v) / this->MaxSpeed;
+      }
+      else if (this->InScalars && this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
+      {
+        sFactor = this->InScalars->GetComponent(pts[j], 0);
+        if (sFactor < 0.0)
+        {
+          return LINE_NEGATIVE_SCALAR;
+        }
+      }
+
+      // create points around line
+      if (this->SidesShareVertices)
+      {
+        for (k = 0; k < this->NumberOfSides; k++)
+        {
+          for (i = 0; i < 3; i++)
+          {
+            normal[i] = w[i] * cos((double)k * this->Theta) + nP[i] * sin((double)k * this->Theta);
+            s[i] = p[i] + this->Radius * sFactor * normal[i];
+          }
+          this->SetPoint(ptId, s, normal, pts[j]);
+          ptId++;
+        } // for each side
+      }
+      else
+      {
+        double n_left[3], n_right[3];
+        for (k = 0; k < this->NumberOfSides; k++)
+        {
+          for (i = 0; i < 3; i++)
+          {
+            // Create duplicate vertices at each point
+            // and adjust the associated normals so that they are
+            // oriented with the facets. This preserves the tube's
+            // polygonal appearance, as if by flat-shading around the tube,
+            // while still allowing smooth (gouraud) shading along the
+            // tube as it bends.
+            normal[i] = w[i] * cos((double)(k + 0.0) * this->Theta) +
+              nP[i] * sin((double)(k + 0.0) * this->Theta);
+            n_right[i] = w[i] * cos((double)(k - 0.5) * this->Theta) +
+              nP[i] * sin((double)(k - 0.5) * this->Theta);
+            n_left[i] = w[i] * cos((double)(k + 0.5) * this->Theta) +
+              nP[i] * sin((double)(k + 0.5) * this->Theta);
+            s[i] = p[i] + this->Radius * sFactor * normal[i];
+          }
+          this->SetPoint(ptId, s, n_right, pts[j]);
+          this->SetPoint(ptId + 1, s, n_left, pts[j]);
+          ptId += 2;
+        } // for each side
+      }   // else separate vertices
+    }     // for all points in polyline
+
+    // Produce end points for cap. They are placed at tail end of points.
+    if (this->Capping)
+    {
+      int numCapSides = this->NumberOfSides;
+      int capIncr = 1;
+      if (!this->SidesShareVertices)
+      {
+        numCapSides = 2 * this->NumberOfSides;
+        capIncr = 2;
+      }
+
+      // the start cap
+      for (k = 0; k < numCapSides; k += capIncr)
+      {
+        this->NewPts->GetPoint(offset + k, s);
+        this->SetPoint(ptId, s, startCapNorm, pts[0]);
+        ptId++;
+      }
+      // the end cap
+      vtkIdType endOffset = offset + (npts - 1) * this->NumberOfSides;
+      if (!this->SidesShareVertices)
+      {
+        endOffset = offset + 2 * (npts - 1) * this->NumberOfSides;
+      }
+      for (k = 0; k < numCapSides; k += capIncr)
+      {
+        this->NewPts->GetPoint(endOffset + k, s);
+        this->SetPoint(ptId, s, endCapNorm, pts[npts - 1]);
+        ptId++;
+      }
+    } // if capping
+
+    return LINE_TUBED;
+  }
+
+  void SetPoint(vtkIdType ptId, const double x[3], const double normal[3], vtkIdType inPtId) const
+  {
+    this->NewPts->SetPoint(ptId, x);
+    for (int i = 0; i < 3; ++i)
+    {
+      this->NewNormals[3 * ptId + i] = static_cast<float>(normal[i]);
+    }
+    this->PointArrays->Copy(inPtId, ptId);
+  }
+
+  void GenerateStrips(vtkIdType offset, vtkIdType npts, vtkIdType cellId, vtkIdType connId,
+    vtkIdType inCellId) const
+  {
+    vtkIdType i;
+    int k;
+    int i1, i2, i3;
+
+    if (this->SidesShareVertices)
+    {
+      for (k = this->SideOffset; k < (this->NumberOfSides + this->SideOffset); k += this->OnRatio)
+      {
+        i1 = k % this->NumberOfSides;
+        i2 = (k + 1) % this->NumberOfSides;
+        this->StripOffsets[cellId] = connId;
+        this->CellArrays->Copy(inCellId, cellId++);
+        for (i = 0; i < npts; i++)
+        {
+          i3 = i * this->NumberOfSides;
+          this->StripConn[connId++] = offset + i2 + i3;
+          this->StripConn[connId++] = offset + i1 + i3;
+        }
+      } // for each side of the tube
+    }
+    else
+    {
+      for (k = this->SideOffset; k < (this->NumberOfSides + this->SideOffset); k += this->OnRatio)
+      {
+        i1 = 2 * (k % this->NumberOfSides) + 1;
+        i2 = 2 * ((k + 1) % this->NumberOfSides);
+        this->StripOffsets[cellId] = connId;
+        this->CellArrays->Copy(inCellId, cellId++);
+        for (i = 0; i < npts; i++)
+        {
+          i3 = i * 2 * this->NumberOfSides;
+          this->StripConn[connId++] = offset + i2 + i3;
+          this->StripConn[connId++] = offset + i1 + i3;
+        }
+      } // for each side of the tube
+    }
+
+    // Take care of capping. The caps are n-sided polygons that can be
+    // easily triangle stripped.
+    if (this->Capping)
+    {
+      vtkIdType startIdx = offset + npts * this->NumberOfSides;
+
+      if (!this->SidesShareVertices)
+      {
+        startIdx = offset + 2 * npts * this->NumberOfSides;
+      }
+
+      // The start cap
+      this->StripOffsets[cellId] = connId;
+      this->CellArrays->Copy(inCellId, cellId++);
+      this->StripConn[connId++] = startIdx;
+      this->StripConn[connId++] = startIdx + 1;
+      for (i1 = this->NumberOfSides - 1, i2 = 2, k = 0; k < (this->NumberOfSides - 2); k++)
+      {
+        if ((k % 2))
+        {
+          this->StripConn[connId++] = startIdx + i2;
+          i2++;
+        }
+        else
+        {
+          this->StripConn[connId++] = startIdx + i1;
+          i1--;
+        }
+      }
+
+      // The end cap - reversed order to be consistent with normal
+      startIdx += this->NumberOfSides;
+      this->StripOffsets[cellId] = connId;
+      this->CellArrays->Copy(inCellId, cellId);
+      this->StripConn[connId++] = startIdx;
+      this->StripConn[connId++] = startIdx + this->NumberOfSides - 1;
+      for (i1 = this->NumberOfSides - 2, i2 = 1, k = 0; k < (this->NumberOfSides - 2); k++)
+      {
+        if ((k % 2))
+        {
+          this->StripConn[connId++] = startIdx + i1;
+          i1--;
+        }
+        else
+        {
+          this->StripConn[connId++] = startIdx + i2;
+          i2++;
+        }
+      }
+    }
+  }
+
+  void SetTCoords(vtkIdType ptId, double tc, double tcy) const
+  {
+    this->NewTCoords[2 * ptId] = static_cast<float>(tc);
+    this->NewTCoords[2 * ptId + 1] = static_cast<float>(tcy);
+  }
+
+  void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts) const
+  {
+    vtkIdType i;
+    int k;
+    double tc = 0.0;
+
+    int numSides = this->NumberOfSides;
+    if (!this->SidesShareVertices)
+    {
+      numSides = 2 * this->NumberOfSides;
+    }
+
+    double s0, s;
+    if (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS)
+    {
+      s0 = this->InScalars->GetTuple1(pts[0]);
+      for (i = 0; i < npts; i++)
+      {
+        s = this->InScalars->GetTuple1(pts[i]);
+        tc = (s - s0) / this->TextureLength;
+        for (k = 0; k < numSides; k++)
+        {
+          double tcy = static_cast<double>(k) / (numSides - 1);
+          this->SetTCoords(offset + i * numSides + k, tc, tcy);
+        }
+      }
+    }
+    else if (this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH)
+    {
+      double xPrev[3], x[3], len = 0.0;
+      this->InPts->GetPoint(pts[0], xPrev);
+      for (i = 0; i < npts; i++)
+      {
+        this->InPts->GetPoint(pts[i], x);
+        len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
+        tc = len / this->TextureLength;
+        for (k = 0; k < numSides; k++)
+        {
+          double tcy = static_cast<double>(k) / (numSides - 1);
+          this->SetTCoords(offset + i * numSides + k, tc, tcy);
+        }
+
+        xPrev[0] = x[0];
+        xPrev[1] = x[1];
+        xPrev[2] = x[2];
+      }
+    }
+    else if (this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
+    {
+      double xPrev[3], x[3], length = 0.0, len = 0.0;
+      this->InPts->GetPoint(pts[0], xPrev);
+      for (i = 0; i < npts; i++)
+      {
+        this->InPts->GetPoint(pts[i], x);
+        length += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
+        xPrev[0] = x[0];
+        xPrev[1] = x[1];
+        xPrev[2] = x[2];
+      }
+
+      this->InPts->GetPoint(pts[0], xPrev);
+      for (i = 0; i < npts; i++)
+      {
+        this->InPts->GetPoint(pts[i], x);
+        len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
+        tc = len / length;
+        for (k = 0; k < numSides; k++)
+        {
+          double tcy = static_cast<double>(k) / (numSides - 1);
+          this->SetTCoords(offset + i * numSides + k, tc, tcy);
+        }
+        xPrev[0] = x[0];
+        xPrev[1] = x[1];
+        xPrev[2] = x[2];
+      }
+    }
+
+    // Capping, set the endpoints as appropriate
+    if (this->Capping)
+    {
+      int ik;
+      vtkIdType startIdx = offset + npts * numSides;
+
+      // start cap
+      for (ik = 0; ik < this->NumberOfSides; ik++)
+      {
+        this->SetTCoords(startIdx + ik, 0.0, 0.0);
+      }
+
+      // end cap
+      for (ik = 0; ik < this->NumberOfSides; ik++)
+      {
+        this->SetTCoords(startIdx + this->NumberOfSides + ik, tc, 0.0);
+      }
+    }
+  }
+
+  void operator()(vtkIdType lineId, vtkIdType endLineId)
+  {
+    LocalData& local = this->Local.Local();
+    for (; lineId < endLineId; ++lineId)
+    {
+      if (!this->NumberOfLinePoints[lineId])
+      {
+        continue; // skip tubing this polyline
+      }
+      const vtkIdType npts = this->GetLinePoints(local, lineId);
+      const vtkIdType* pts = local.Ids.data();
+
+      // If necessary calculate normals, each polyline calculates its
+      // normals independently, avoiding conflicts at shared vertices.
+      if (this->GenerateNormals)
+      {
+        this->GenerateLineNormals(local, npts, pts);
+      }
+
+      // Generate the points around the polyline. The tube is not stripped
+      // if the polyline is bad.
+      const vtkIdType offset = this->PointOffsets[lineId];
+      this->Status[lineId] = this->GeneratePoints(local, offset, npts, pts);
+      if (this->Status[lineId] != LINE_TUBED)
+      {
+        continue; // skip tubing this polyline
+      }
+
+      // Generate the strips for this polyline (including caps)
+      this->GenerateStrips(offset, npts, this->CellOffsets[lineId], this->ConnOffsets[lineId],
+        this->FirstCellId + lineId);
+
+      // Generate the texture coordinates for this polyline
+      if (this->NewTCoords)
+      {
+        this->GenerateTextureCoords(offset, npts, pts);
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+// Set the tube parameters from the filter.
+void SetTubeParameters(GenerateTubes& tubes, vtkTubeFilter* self)
+{
+  tubes.Radius = self->GetRadius();
+  tubes.VaryRadius = self->GetVaryRadius();
+  tubes.RadiusFactor = self->GetRadiusFactor();
+  tubes.NumberOfSides = self->GetNumberOfSides();
+  tubes.SidesShareVertices = self->GetSidesShareVertices() != 0;
+  tubes.Capping = self->GetCapping() != 0;
+  tubes.OnRatio = self->GetOnRatio();
+  tubes.SideOffset = self->GetOffset();
+  tubes.GenerateTCoords = self->GetGenerateTCoords();
+  tubes.TextureLength = self->GetTextureLength();
+  tubes.Theta = 2.0 * vtkMath::Pi() / tubes.NumberOfSides;
+}
+
 }
 
 int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
@@ -100,26 +750,16 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkCellData* cd = input->GetCellData();
   vtkCellData* outCD = output->GetCellData();
   vtkCellArray* inLines;
-  vtkDataArray* inNormals;
   vtkDataArray* inScalars = this->GetInputArrayToProcess(0, inputVector);
   vtkDataArray* inVectors = this->GetInputArrayToProcess(1, inputVector);
 
   vtkPoints* inPts;
   vtkIdType numPts;
   vtkIdType numLines;
-  vtkIdType numNewPts, numNewCells;
   vtkPoints* newPts;
-  int deleteNormals = 0;
   vtkFloatArray* newNormals;
-  vtkIdType i;
-  double range[2], maxSpeed = 0;
-  vtkCellArray* newStrips;
-  vtkIdType npts = 0;
-  const vtkIdType* ptsOrig = nullptr;
-  vtkIdType offset = 0;
+  double range[2] = { 0.0, 1.0 }, maxSpeed = 0;
   vtkFloatArray* newTCoords = nullptr;
-  int abort = 0;
-  vtkIdType inCellId;
   double oldRadius = 1.0;
 
   // Check input and initialize
@@ -133,7 +773,6 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
   }
 
   // Create the geometry and topology
-  numNewPts = numPts * this->NumberOfSides;
   newPts = vtkPoints::New();
 
   // Set the desired precision for the points in the output.
@@ -150,14 +789,9 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
     newPts->SetDataType(VTK_DOUBLE);
   }
 
-  newPts->Allocate(numNewPts);
   newNormals = vtkFloatArray::New();
   newNormals->SetName("TubeNormals");
   newNormals->SetNumberOfComponents(3);
-  newNormals->Allocate(3 * numNewPts);
-  newStrips = vtkCellArray::New();
-  newStrips->AllocateEstimate(1, numNewPts);
-  vtkCellArray* singlePolyline = vtkCellArray::New();
 
   // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
   outPD->CopyNormalsOff();
@@ -167,32 +801,28 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
   {
     newTCoords = vtkFloatArray::New();
     newTCoords->SetNumberOfComponents(2);
-    newTCoords->Allocate(numNewPts);
     outPD->CopyTCoordsOff();
   }
-  outPD->CopyAllocate(pd, numNewPts);
 
-  int generateNormals = 0;
-  if (!(inNormals = pd->GetNormals()) || this->UseDefaultNormal)
+  GenerateTubes tubes;
+  tubes.InNormals = pd->GetNormals();
+  tubes.GenerateNormals = false;
+  if (!tubes.InNormals || this->UseDefaultNormal)
   {
-    deleteNormals = 1;
-    inNormals = vtkFloatArray::New();
-    inNormals->SetNumberOfComponents(3);
-    inNormals->SetNumberOfTuples(numPts);
-
+    tubes.InNormals = nullptr;
     if (this->UseDefaultNormal)
     {
-      for (i = 0; i < numPts; i++)
+      for (int i = 0; i < 3; i++)
       {
-        inNormals->SetTuple(i, this->DefaultNormal);
+        tubes.DefaultNormal[i] = static_cast<float>(this->DefaultNormal[i]);
       }
     }
     else
     {
-      // Normal generation has been moved to lower in the function.
-      // This allows each different polylines to share vertices, but have
-      // their normals (and hence their tubes) calculated independently
-      generateNormals = 1;
+      // Normal generation is done per polyline. This allows each different
+      // polylines to share vertices, but have their normals (and hence their
+      // tubes) calculated independently
+      tubes.GenerateNormals = true;
     }
   }
 
@@ -225,90 +855,145 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
     maxSpeed = inVectors->GetMaxNorm();
   }
 
-  // Copy selected parts of cell data; certainly don't want normals
-  //
-  numNewCells = inLines->GetNumberOfCells() * this->NumberOfSides + 2;
-  outCD->CopyNormalsOff();
-  outCD->CopyAllocate(cd, numNewCells);
-
   //  Create points along each polyline that are connected into NumberOfSides
   //  triangle strips. Texture coordinates are optionally generated.
   //
   this->Theta = 2.0 * vtkMath::Pi() / this->NumberOfSides;
-  vtkPolyLine* lineNormalGenerator = vtkPolyLine::New();
+  SetTubeParameters(tubes, this);
+  tubes.InPts = inPts;
+  tubes.InLines = inLines;
   // the line cellIds start after the last vert cellId
-  inCellId = input->GetNumberOfVerts();
-  for (inLines->InitTraversal(); inLines->GetNextCell(npts, ptsOrig) && !abort; inCellId++)
+  tubes.FirstCellId = input->GetNumberOfVerts();
+  tubes.InScalars = inScalars;
+  tubes.Range[0] = range[0];
+  tubes.Range[1] = range[1];
+  tubes.InVectors = inVectors;
+  tubes.MaxSpeed = maxSpeed;
+
+  // reset the radius to ite original value if necessary
+  if (this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
   {
-    this->UpdateProgress((double)inCellId / numLines);
-    abort = this->GetAbortExecute();
+    this->Radius = oldRadius;
+  }
 
-    // Make a copy of point indices to avoid modifying input polydata cells
-    // while removing degenerate lines.
-    if (npts < 2)
+  // Count the points of each polyline once degenerate segments are removed,
+  // to compute where the tube of each polyline is output.
+  tubes.NumberOfLinePoints.resize(numLines);
+  tubes.Status.assign(numLines, LINE_TUBED);
+  vtkSMPTools::For(0, numLines, [&tubes](vtkIdType lineId, vtkIdType endLineId) {
+    tubes.CountPoints(lineId, endLineId);
+  });
+  this->UpdateProgress(0.2);
+
+  // The output is first allocated assuming that all the polylines can be
+  // tubed. The polylines that cannot be tubed are discarded, and the tubes
+  // generated again where they belong.
+  ArrayList pointArrays;
+  ArrayList cellArrays;
+  vtkNew<vtkIdTypeArray> stripOffsets;
+  vtkNew<vtkIdTypeArray> stripConn;
+  tubes.PointOffsets.resize(numLines + 1);
+  tubes.CellOffsets.resize(numLines + 1);
+  tubes.ConnOffsets.resize(numLines + 1);
+  for (bool allocated = false;; allocated = true)
+  {
+    tubes.PointOffsets[0] = tubes.CellOffsets[0] = tubes.ConnOffsets[0] = 0;
+    for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
     {
-      continue; // skip tubing this polyline
+      const vtkIdType npts = tubes.NumberOfLinePoints[lineId];
+      tubes.PointOffsets[lineId + 1] =
+        tubes.PointOffsets[lineId] + (npts ? tubes.GetNumberOfTubePoints(npts) : 0);
+      tubes.CellOffsets[lineId + 1] =
+        tubes.CellOffsets[lineId] + (npts ? tubes.GetNumberOfTubeCells() : 0);
+      tubes.ConnOffsets[lineId + 1] =
+        tubes.ConnOffsets[lineId] + (npts ? tubes.GetTubeConnectivitySize(npts) : 0);
     }
-    std::vector<vtkIdType> ptsCopy(ptsOrig, ptsOrig + npts);
-    vtkIdType* pts = ptsCopy.data();
+    const vtkIdType numNewPts = tubes.PointOffsets[numLines];
+    const vtkIdType numNewCells = tubes.CellOffsets[numLines];
 
-    // remove degenerate lines to avoid warnings
-    npts = static_cast<vtkIdType>(std::unique(pts, pts + npts, IdPointsEqual(inPts)) - pts);
-    if (npts < 2)
+    if (!allocated)
     {
-      continue; // skip tubing this polyline
-    }
+      newPts->SetNumberOfPoints(numNewPts);
+      newNormals->SetNumberOfTuples(numNewPts);
+      outPD->CopyAllocate(pd, numNewPts);
+      pointArrays.AddArrays(numNewPts, pd, outPD, 0.0, false);
+      if (newTCoords)
+      {
+        newTCoords->SetNumberOfTuples(numNewPts);
+      }
 
-    // If necessary calculate normals, each polyline calculates its
-    // normals independently, avoiding conflicts at shared vertices.
-    if (generateNormals)
+      // Copy selected parts of cell data; certainly don't want normals
+      //
+      outCD->CopyNormalsOff();
+      outCD->CopyAllocate(cd, numNewCells);
+      cellArrays.AddArrays(numNewCells, cd, outCD, 0.0, false);
+      stripOffsets->SetNumberOfTuples(numNewCells + 1);
+      stripConn->SetNumberOfTuples(tubes.ConnOffsets[numLines]);
+
+      tubes.NewPts = newPts;
+      tubes.NewNormals = newNormals->GetPointer(0);
+      tubes.NewTCoords = newTCoords ? newTCoords->GetPointer(0) : nullptr;
+      tubes.PointArrays = &pointArrays;
+      tubes.CellArrays = &cellArrays;
+      tubes.StripOffsets = stripOffsets->GetPointer(0);
+      tubes.StripConn = stripConn->GetPointer(0);
+    }
+    else
     {
-      singlePolyline->Reset(); // avoid instantiation
-      singlePolyline->InsertNextCell(npts, pts);
-      vtkPolyLine::GenerateSlidingNormals(inPts, singlePolyline, inNormals);
+      // Only shrink the output, which keeps the pointers to its arrays valid
+      // until the tubes are generated again.
+      newPts->SetNumberOfPoints(numNewPts);
+      newNormals->SetNumberOfTuples(numNewPts);
+      for (int i = 0; i < outPD->GetNumberOfArrays(); ++i)
+      {
+        outPD->GetAbstractArray(i)->SetNumberOfTuples(numNewPts);
+      }
+      if (newTCoords)
+      {
+        newTCoords->SetNumberOfTuples(numNewPts);
+      }
+      for (int i = 0; i < outCD->GetNumberOfArrays(); ++i)
+      {
+        outCD->GetAbstractArray(i)->SetNumberOfTuples(numNewCells);
+      }
+      stripOffsets->SetNumberOfTuples(numNewCells + 1);
+      stripConn->SetNumberOfTuples(tubes.ConnOffsets[numLines]);
     }
+    stripOffsets->SetValue(numNewCells, tubes.ConnOffsets[numLines]);
 
-    // Generate the points around the polyline. The tube is not stripped
-    // if the polyline is bad.
-    //
-    if (!this->GeneratePoints(offset, npts, pts, inPts, newPts, pd, outPD, newNormals, inScalars,
-          range, inVectors, maxSpeed, inNormals))
+    vtkSMPTools::For(0, numLines, tubes);
+    this->UpdateProgress(0.9);
+
+    bool failed = false;
+    for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
     {
+      switch (tubes.Status[lineId])
+      {
+        case LINE_TUBED:
+          continue;
+        case LINE_COINCIDENT_POINTS:
+          vtkWarningMacro(<< "Coincident points!");
+          break;
+        case LINE_BAD_NORMAL:
+          vtkWarningMacro(<< "Bad normal in line " << lineId);
+          break;
+        case LINE_NEGATIVE_SCALAR:
+          vtkWarningMacro(<< "Scalar value less than zero, skipping line");
+          break;
+      }
       vtkWarningMacro(<< "Could not generate points!");
-      continue; // skip tubing this polyline
+      tubes.NumberOfLinePoints[lineId] = 0;
+      tubes.Status[lineId] = LINE_TUBED;
+      failed = true;
     }
-
-    // Generate the strips for this polyline (including caps)
-    //
-    this->GenerateStrips(offset, npts, pts, inCellId, cd, outCD, newStrips);
-
-    // Generate the texture coordinates for this polyline
-    //
-    if (newTCoords)
+    if (!failed)
     {
-      this->GenerateTextureCoords(offset, npts, pts, inPts, inScalars, newTCoords);
+      break;
     }
-
-    // Compute the new offset for the next polyline
-    offset = this->ComputeOffset(offset, npts);
-
-  } // for all polylines
-
-  singlePolyline->Delete();
-
-  // reset the radius to ite original value if necessary
-  if (this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
-  {
-    this->Radius = oldRadius;
   }
 
   // Update ourselves
   //
-  if (deleteNormals)
-  {
-    inNormals->Delete();
-  }
-
   if (newTCoords)
   {
     outPD->SetTCoords(newTCoords);
@@ -318,461 +1003,143 @@ int vtkTubeFilter::RequestData(vtkInformation* vtkNotUsed(request),
   output->SetPoints(newPts);
   newPts->Delete();
 
+  vtkNew<vtkCellArray> newStrips;
+  newStrips->SetData(stripOffsets, stripConn);
   output->SetStrips(newStrips);
-  newStrips->Delete();
 
   outPD->SetNormals(newNormals);
   newNormals->Delete();
-  lineNormalGenerator->Delete();
 
   output->Squeeze();
 
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// The deprecated helper methods generate the tube of a single polyline with
+// the same code as RequestData(), then insert it in the given arrays.
 int vtkTubeFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
   vtkPoints* inPts, vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD,
   vtkFloatArray* newNormals, vtkDataArray* inScalars, double range[2], vtkDataArray* inVectors,
   double maxSpeed, vtkDataArray* inNormals)
 {
-  vtkIdType j;
-  int i, k;
-  double p[3];
-  double pNext[3];
-  double sNext[3] = { 0.0, 0.0, 0.0 };
-  double sPrev[3];
-  double startCapNorm[3], endCapNorm[3];
-  double n[3];
-  double s[3];
-  // double bevelAngle;
-  double w[3];
-  double nP[3];
-  double sFactor = 1.0;
-  double normal[3];
-  vtkIdType ptId = offset;
-
-  // Use "averaged" segment to create beveled effect.
-  // Watch out for first and last points.
-  //
-  for (j = 0; j < npts; j++)
+  GenerateTubes tubes;
+  SetTubeParameters(tubes, this);
+  tubes.InPts = inPts;
+  tubes.InNormals = inNormals;
+  tubes.GenerateNormals = false;
+  for (int i = 0; i < 3; i++)
   {
-    if (j == 0) // first point
-    {
-      inPts->GetPoint(pts[0], p);
-      inPts->GetPoint(pts[1], pNext);
-      for (i = 0; i < 3; i++)
-      {
-        sNext[i] = pNext[i] - p[i];
-        sPrev[i] = sNext[i];
-        startCapNorm[i] = -sPrev[i];
-      }
-      vtkMath::Normalize(startCapNorm);
-    }
-    else if (j == (npts - 1)) // last point
-    {
-      for (i = 0; i < 3; i++)
-      {
-        sPrev[i] = sNext[i];
-        p[i] = pNext[i];
-        endCapNorm[i] = sNext[i];
-      }
-      vtkMath::Normalize(endCapNorm);
-    }
-    else
-    {
-      for (i = 0; i < 3; i++)
-      {
-        p[i] = pNext[i];
-      }
-      inPts->GetPoint(pts[j + 1], pNext);
-      for (i = 0; i < 3; i++)
-      {
-        sPrev[i] = sNext[i];
-        sNext[i] = pNext[i] - p[i];
-      }
-    }
-
-    inNormals->GetTuple(pts[j], n);
-
-    if (vtkMath::Normalize(sNext) == 0.0)
-    {
+    tubes.DefaultNormal[i] = static_cast<float>(this->DefaultNormal[i]);
+  }
+  tubes.InScalars = inScalars;
+  tubes.Range[0] = range[0];
+  tubes.Range[1] = range[1];
+  tubes.InVectors = inVectors;
+  tubes.MaxSpeed = maxSpeed;
+
+  const vtkIdType numTubePts = tubes.GetNumberOfTubePoints(npts);
+  vtkNew<vtkPoints> tubePts;
+  tubePts->SetDataTypeToDouble();
+  tubePts->SetNumberOfPoints(numTubePts);
+  std::vector<float> tubeNormals(3 * numTubePts);
+  ArrayList noArrays;
+  tubes.NewPts = tubePts;
+  tubes.NewNormals = tubeNormals.data();
+  tubes.PointArrays = &noArrays;
+
+  GenerateTubes::LocalData local;
+  switch (tubes.GeneratePoints(local, 0, npts, pts))
+  {
+    case LINE_TUBED:
+      break;
+    case LINE_COINCIDENT_POINTS:
       vtkWarningMacro(<< "Coincident points!");
       return 0;
-    }
-
-    for (i = 0; i < 3; i++)
-    {
-      s[i] = (sPrev[i] + sNext[i]) / 2.0; // average vector
-    }
-    // if s is zero then just use sPrev cross n
-    if (vtkMath::Normalize(s) == 0.0)
-    {
-      vtkDebugMacro(<< "Using alternate bevel vector");
-      vtkMath::Cross(sPrev, n, s);
-      if (vtkMath::Normalize(s) == 0.0)
-      {
-        vtkDebugMacro(<< "Using alternate bevel vector");
-      }
-    }
-
-    /*    if ( (bevelAngle = vtkMath::Dot(sNext,sPrev)) > 1.0 )
-          {
-          bevelAngle = 1.0;
-          }
-        if ( bevelAngle < -1.0 )
-          {
-          bevelAngle = -1.0;
-          }
-        bevelAngle = acos((double)bevelAngle) / 2.0; //(0->90 degrees)
-        if ( (bevelAngle = cos(bevelAngle)) == 0.0 )
-          {
-          bevelAngle = 1.0;
-          }
-
-        bevelAngle = this->Radius / bevelAngle; //keep tube constant radius
-    */
-    vtkMath::Cross(s, n, w);
-    if (vtkMath::Normalize(w) == 0.0)
-    {
-      vtkWarningMacro(<< "Bad normal s = " << s[0] << " " << s[1] << " " << s[2] << " n = " << n[0]
-                      << " " << n[1] << " " << n[2]);
+    case LINE_BAD_NORMAL:
+      vtkWarningMacro(<< "Bad normal!");
       return 0;
-    }
-
-    vtkMath::Cross(w, s, nP); // create orthogonal coordinate system
-    vtkMath::Normalize(nP);
-
-    // Compute a scale factor based on scalars or vectors
-    if (inScalars && this->VaryRadius == VTK_VARY_RADIUS_BY_SCALAR)
-    {
-      sFactor = 1.0 +
-        ((this->RadiusFactor - 1.0) * (inScalars->GetComponent(pts[j], 0) - range[0]) /
-          (range[1] - range[0]));
-    }
-    else if (inVectors && this->VaryRadius == VTK_VARY_RADIUS_BY_VECTOR)
-    {
-      sFactor = sqrt((double)maxSpeed / vtkMath::Norm(inVectors->GetTuple(pts[j])));
-      if (sFactor > this->RadiusFactor)
-      {
-        sFactor = this->RadiusFactor;
-      }
-    }
-    else if (inVectors && this->VaryRadius == VTK_VARY_RADIUS_BY_VECTOR_NORM)
-    {
-      sFactor =
-        1.0 + (this->RadiusFactor - 1.0) * vtkMath::Norm(inVectors->GetTuple(pts[j])) / maxSpeed;
-    }
-    else if (inScalars && this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
-    {
-      sFactor = inScalars->GetComponent(pts[j], 0);
-      if (sFactor < 0.0)
-      {
-        vtkWarningMacro(<< "Scalar value less than zero, skipping line");
-        return 0;
-      }
-    }
+    default:
+      vtkWarningMacro(<< "Scalar value less than zero, skipping line");
+      return 0;
+  }
 
-    // create points around line
-    if (this->SidesShareVertices)
+  // The points around each polyline point come first, then the points of the
+  // start and end caps.
+  const vtkIdType numSidePts = this->NumberOfSides * (this->SidesShareVertices ? 1 : 2);
+  const vtkIdType numLinePts = npts * numSidePts;
+  for (vtkIdType ptId = 0; ptId < numTubePts; ++ptId)
+  {
+    vtkIdType inPtId;
+    if (ptId < numLinePts)
     {
-      for (k = 0; k < this->NumberOfSides; k++)
-      {
-        for (i = 0; i < 3; i++)
-        {
-          normal[i] = w[i] * cos((double)k * this->Theta) + nP[i] * sin((double)k * this->Theta);
-          s[i] = p[i] + this->Radius * sFactor * normal[i];
-        }
-        newPts->InsertPoint(ptId, s);
-        newNormals->InsertTuple(ptId, normal);
-        outPD->CopyData(pd, pts[j], ptId);
-        ptId++;
-      } // for each side
+      inPtId = pts[ptId / numSidePts];
     }
     else
     {
-      double n_left[3], n_right[3];
-      for (k = 0; k < this->NumberOfSides; k++)
-      {
-        for (i = 0; i < 3; i++)
-        {
-          // Create duplicate vertices at each point
-          // and adjust the associated normals so that they are
-          // oriented with the facets. This preserves the tube's
-          // polygonal appearance, as if by flat-shading around the tube,
-          // while still allowing smooth (gouraud) shading along the
-          // tube as it bends.
-          normal[i] = w[i] * cos((double)(k + 0.0) * this->Theta) +
-            nP[i] * sin((double)(k + 0.0) * this->Theta);
-          n_right[i] = w[i] * cos((double)(k - 0.5) * this->Theta) +
-            nP[i] * sin((double)(k - 0.5) * this->Theta);
-          n_left[i] = w[i] * cos((double)(k + 0.5) * this->Theta) +
-            nP[i] * sin((double)(k + 0.5) * this->Theta);
-          s[i] = p[i] + this->Radius * sFactor * normal[i];
-        }
-        newPts->InsertPoint(ptId, s);
-        newNormals->InsertTuple(ptId, n_right);
-        outPD->CopyData(pd, pts[j], ptId);
-        newPts->InsertPoint(ptId + 1, s);
-        newNormals->InsertTuple(ptId + 1, n_left);
-        outPD->CopyData(pd, pts[j], ptId + 1);
-        ptId += 2;
-      } // for each side
-    }   // else separate vertices
-  }     // for all points in polyline
-
-  // Produce end points for cap. They are placed at tail end of points.
-  if (this->Capping)
-  {
-    int numCapSides = this->NumberOfSides;
-    int capIncr = 1;
-    if (!this->SidesShareVertices)
-    {
-      numCapSides = 2 * this->NumberOfSides;
-      capIncr = 2;
-    }
-
-    // the start cap
-    for (k = 0; k < numCapSides; k += capIncr)
-    {
-      newPts->GetPoint(offset + k, s);
-      newPts->InsertPoint(ptId, s);
-      newNormals->InsertTuple(ptId, startCapNorm);
-      outPD->CopyData(pd, pts[0], ptId);
-      ptId++;
-    }
-    // the end cap
-    int endOffset = offset + (npts - 1) * this->NumberOfSides;
-    if (!this->SidesShareVertices)
-    {
-      endOffset = offset + 2 * (npts - 1) * this->NumberOfSides;
+      inPtId = (ptId < numLinePts + this->NumberOfSides ? pts[0] : pts[npts - 1]);
     }
-    for (k = 0; k < numCapSides; k += capIncr)
-    {
-      newPts->GetPoint(endOffset + k, s);
-      newPts->InsertPoint(ptId, s);
-      newNormals->InsertTuple(ptId, endCapNorm);
-      outPD->CopyData(pd, pts[npts - 1], ptId);
-      ptId++;
-    }
-  } // if capping
-
+    newPts->InsertPoint(offset + ptId, tubePts->GetPoint(ptId));
+    newNormals->InsertTuple3(offset + ptId, tubeNormals[3 * ptId], tubeNormals[3 * ptId + 1],
+      tubeNormals[3 * ptId + 2]);
+    outPD->CopyData(pd, inPtId, offset + ptId);
+  }
   return 1;
 }
 
+//------------------------------------------------------------------------------
 void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
   const vtkIdType* vtkNotUsed(pts), vtkIdType inCellId, vtkCellData* cd, vtkCellData* outCD,
   vtkCellArray* newStrips)
 {
-  vtkIdType i, outCellId;
-  int k;
-  int i1, i2, i3;
-
-  if (this->SidesShareVertices)
-  {
-    for (k = this->Offset; k < (this->NumberOfSides + this->Offset); k += this->OnRatio)
-    {
-      i1 = k % this->NumberOfSides;
-      i2 = (k + 1) % this->NumberOfSides;
-      outCellId = newStrips->InsertNextCell(npts * 2);
-      outCD->CopyData(cd, inCellId, outCellId);
-      for (i = 0; i < npts; i++)
-      {
-        i3 = i * this->NumberOfSides;
-        newStrips->InsertCellPoint(offset + i2 + i3);
-        newStrips->InsertCellPoint(offset + i1 + i3);
-      }
-    } // for each side of the tube
-  }
-  else
+  GenerateTubes tubes;
+  SetTubeParameters(tubes, this);
+
+  const vtkIdType numCells = tubes.GetNumberOfTubeCells();
+  std::vector<vtkIdType> stripOffsets(numCells + 1);
+  std::vector<vtkIdType> stripConn(tubes.GetTubeConnectivitySize(npts));
+  ArrayList noArrays;
+  tubes.CellArrays = &noArrays;
+  tubes.StripOffsets = stripOffsets.data();
+  tubes.StripConn = stripConn.data();
+  tubes.GenerateStrips(offset, npts, 0, 0, inCellId);
+  stripOffsets[numCells] = static_cast<vtkIdType>(stripConn.size());
+
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
   {
-    for (k = this->Offset; k < (this->NumberOfSides + this->Offset); k += this->OnRatio)
-    {
-      i1 = 2 * (k % this->NumberOfSides) + 1;
-      i2 = 2 * ((k + 1) % this->NumberOfSides);
-      outCellId = newStrips->InsertNextCell(npts * 2);
-      outCD->CopyData(cd, inCellId, outCellId);
-      for (i = 0; i < npts; i++)
-      {
-        i3 = i * 2 * this->NumberOfSides;
-        newStrips->InsertCellPoint(offset + i2 + i3);
-        newStrips->InsertCellPoint(offset + i1 + i3);
-      }
-    } // for each side of the tube
-  }
-
-  // Take care of capping. The caps are n-sided polygons that can be
-  // easily triangle stripped.
-  if (this->Capping)
-  {
-    vtkIdType startIdx = offset + npts * this->NumberOfSides;
-    vtkIdType idx;
-
-    if (!this->SidesShareVertices)
-    {
-      startIdx = offset + 2 * npts * this->NumberOfSides;
-    }
-
-    // The start cap
-    outCellId = newStrips->InsertNextCell(this->NumberOfSides);
-    outCD->CopyData(cd, inCellId, outCellId);
-    newStrips->InsertCellPoint(startIdx);
-    newStrips->InsertCellPoint(startIdx + 1);
-    for (i1 = this->NumberOfSides - 1, i2 = 2, k = 0; k < (this->NumberOfSides - 2); k++)
-    {
-      if ((k % 2))
-      {
-        idx = startIdx + i2;
-        newStrips->InsertCellPoint(idx);
-        i2++;
-      }
-      else
-      {
-        idx = startIdx + i1;
-        newStrips->InsertCellPoint(idx);
-        i1--;
-      }
-    }
-
-    // The end cap - reversed order to be consistent with normal
-    startIdx += this->NumberOfSides;
-    outCellId = newStrips->InsertNextCell(this->NumberOfSides);
+    const vtkIdType outCellId = newStrips->InsertNextCell(
+      stripOffsets[cellId + 1] - stripOffsets[cellId], stripConn.data() + stripOffsets[cellId]);
     outCD->CopyData(cd, inCellId, outCellId);
-    newStrips->InsertCellPoint(startIdx);
-    newStrips->InsertCellPoint(startIdx + this->NumberOfSides - 1);
-    for (i1 = this->NumberOfSides - 2, i2 = 1, k = 0; k < (this->NumberOfSides - 2); k++)
-    {
-      if ((k % 2))
-      {
-        idx = startIdx + i1;
-        newStrips->InsertCellPoint(idx);
-        i1--;
-      }
-      else
-      {
-        idx = startIdx + i2;
-        newStrips->InsertCellPoint(idx);
-        i2++;
-      }
-    }
   }
 }
 
+//------------------------------------------------------------------------------
 void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
   vtkPoints* inPts, vtkDataArray* inScalars, vtkFloatArray* newTCoords)
 {
-  vtkIdType i;
-  int k;
-  double tc = 0.0;
-
-  int numSides = this->NumberOfSides;
-  if (!this->SidesShareVertices)
-  {
-    numSides = 2 * this->NumberOfSides;
-  }
-
-  double s0, s;
-  if (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS)
-  {
-    s0 = inScalars->GetTuple1(pts[0]);
-    for (i = 0; i < npts; i++)
-    {
-      s = inScalars->GetTuple1(pts[i]);
-      tc = (s - s0) / this->TextureLength;
-      for (k = 0; k < numSides; k++)
-      {
-        double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
-      }
-    }
-  }
-  else if (this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH)
-  {
-    double xPrev[3], x[3], len = 0.0;
-    inPts->GetPoint(pts[0], xPrev);
-    for (i = 0; i < npts; i++)
-    {
-      inPts->GetPoint(pts[i], x);
-      len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
-      tc = len / this->TextureLength;
-      for (k = 0; k < numSides; k++)
-      {
-        double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
-      }
-
-      xPrev[0] = x[0];
-      xPrev[1] = x[1];
-      xPrev[2] = x[2];
-    }
-  }
-  else if (this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
-  {
-    double xPrev[3], x[3], length = 0.0, len = 0.0;
-    inPts->GetPoint(pts[0], xPrev);
-    for (i = 0; i < npts; i++)
-    {
-      inPts->GetPoint(pts[i], x);
-      length += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
-      xPrev[0] = x[0];
-      xPrev[1] = x[1];
-      xPrev[2] = x[2];
-    }
+  GenerateTubes tubes;
+  SetTubeParameters(tubes, this);
+  tubes.InPts = inPts;
+  tubes.InScalars = inScalars;
 
-    inPts->GetPoint(pts[0], xPrev);
-    for (i = 0; i < npts; i++)
-    {
-      inPts->GetPoint(pts[i], x);
-      len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
-      tc = len / length;
-      for (k = 0; k < numSides; k++)
-      {
-        double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
-      }
-      xPrev[0] = x[0];
-      xPrev[1] = x[1];
-      xPrev[2] = x[2];
-    }
-  }
+  const vtkIdType numTubePts = tubes.GetNumberOfTubePoints(npts);
+  std::vector<float> tubeTCoords(2 * numTubePts);
+  tubes.NewTCoords = tubeTCoords.data();
+  tubes.GenerateTextureCoords(0, npts, pts);
 
-  // Capping, set the endpoints as appropriate
-  if (this->Capping)
+  for (vtkIdType ptId = 0; ptId < numTubePts; ++ptId)
   {
-    int ik;
-    vtkIdType startIdx = offset + npts * numSides;
-
-    // start cap
-    for (ik = 0; ik < this->NumberOfSides; ik++)
-    {
-      newTCoords->InsertTuple2(startIdx + ik, 0.0, 0.0);
-    }
-
-    // end cap
-    for (ik = 0; ik < this->NumberOfSides; ik++)
-    {
-      newTCoords->InsertTuple2(startIdx + this->NumberOfSides + ik, tc, 0.0);
-    }
+    newTCoords->InsertTuple2(offset + ptId, tubeTCoords[2 * ptId], tubeTCoords[2 * ptId + 1]);
   }
 }
 
+//------------------------------------------------------------------------------
 // Compute the number of points in this tube
 vtkIdType vtkTubeFilter::ComputeOffset(vtkIdType offset, vtkIdType npts)
 {
-  if (this->SidesShareVertices)
-  {
-    offset += this->NumberOfSides * npts;
-  }
-  else
-  {
-    offset += 2 * this->NumberOfSides * npts; // points are duplicated
-  }
-
-  if (this->Capping)
-  {
-    offset += 2 * this->NumberOfSides; // cap points are duplicated
-  }
-
-  return offset;
+  GenerateTubes tubes;
+  SetTubeParameters(tubes, this);
+  return offset + tubes.GetNumberOfTubePoints(npts);
 }
 
 // Description:
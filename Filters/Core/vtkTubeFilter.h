@@ -55,6 +55,7 @@
 #ifndef vtkTubeFilter_h
 #define vtkTubeFilter_h
 
+#include "vtkDeprecation.h"       // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
@@ -253,14 +254,18 @@ protected:
   double TextureLength; // this length is mapped to [0,1) texture space
 
   // Helper methods
+  VTK_DEPRECATED_IN_9_3_0("The tubes are generated in parallel by RequestData()")
   int GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkPoints* inPts,
     vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD, vtkFloatArray* newNormals,
     vtkDataArray* inScalars, double range[2], vtkDataArray* inVectors, double maxSpeed,
     vtkDataArray* inNormals);
+  VTK_DEPRECATED_IN_9_3_0("The tubes are generated in parallel by RequestData()")
   void GenerateStrips(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkIdType inCellId,
     vtkCellData* cd, vtkCellData* outCD, vtkCellArray* newStrips);
+  VTK_DEPRECATED_IN_9_3_0("The tubes are generated in parallel by RequestData()")
   void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
     vtkPoints* inPts, vtkDataArray* inScalars, vtkFloatArray* newTCoords);
+  VTK_DEPRECATED_IN_9_3_0("The tubes are generated in parallel by RequestData()")
   vtkIdType ComputeOffset(vtkIdType offset, vtkIdType npts);
 
   // Helper data members
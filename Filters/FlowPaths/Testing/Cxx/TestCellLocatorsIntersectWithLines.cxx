@@ -0,0 +1,139 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLocatorsIntersectWithLines.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that IntersectWithLines returns the same intersections as
+// IntersectWithLine called for each line with vtkOBBTree and
+// vtkModifiedBSPTree.
+
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkNew.h"
+#include "vtkOBBTree.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSphereSource.h"
+
+namespace
+{
+bool TestLocator(
+  vtkAbstractCellLocator* locator, vtkPolyData* input, vtkPoints* p1s, vtkPoints* p2s)
+{
+  bool success = true;
+  const char* name = locator->GetClassName();
+  locator->SetDataSet(input);
+  locator->BuildLocator();
+
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> ts;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkIdType numHits = locator->IntersectWithLines(p1s, p2s, 0.0, cellIds, ts, points);
+  if (numHits == 0 || cellIds->GetNumberOfIds() != p1s->GetNumberOfPoints() ||
+    ts->GetNumberOfTuples() != p1s->GetNumberOfPoints() ||
+    points->GetNumberOfPoints() != p1s->GetNumberOfPoints())
+  {
+    std::cerr << name << " intersected " << numHits << " lines" << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkGenericCell> cell;
+  vtkIdType numLineHits = 0;
+  for (vtkIdType lineId = 0; lineId < p1s->GetNumberOfPoints(); ++lineId)
+  {
+    double p1[3], p2[3], x[3], y[3], pcoords[3], t;
+    int subId;
+    vtkIdType cellId = -1;
+    p1s->GetPoint(lineId, p1);
+    p2s->GetPoint(lineId, p2);
+    if (!locator->IntersectWithLine(p1, p2, 0.0, t, x, pcoords, subId, cellId, cell))
+    {
+      cellId = -1;
+      t = 1.0;
+      p2s->GetPoint(lineId, x);
+    }
+    else
+    {
+      ++numLineHits;
+    }
+    points->GetPoint(lineId, y);
+    if (cellIds->GetId(lineId) != cellId || ts->GetValue(lineId) != t || x[0] != y[0] ||
+      x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << name << " line " << lineId << " hit cell " << cellIds->GetId(lineId)
+                << " instead of " << cellId << std::endl;
+      success = false;
+      break;
+    }
+  }
+  if (numHits != numLineHits)
+  {
+    std::cerr << name << " intersected " << numHits << " lines instead of " << numLineHits
+              << std::endl;
+    success = false;
+  }
+  return success;
+}
+}
+
+int TestCellLocatorsIntersectWithLines(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(100);
+  sphere->Update();
+
+  // Lines from random points around the sphere to random points near its
+  // center, and a few that miss it.
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> p1s, p2s;
+  p1s->SetDataTypeToDouble();
+  p2s->SetDataTypeToDouble();
+  for (int i = 0; i < 2000; ++i)
+  {
+    double p1[3], p2[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      p1[k] = random->GetNextRangeValue(-1.0, 1.0);
+      p2[k] = random->GetNextRangeValue(-0.1, 0.1);
+    }
+    if (i % 10 == 0)
+    {
+      p2[0] = p1[0] + 0.01;
+    }
+    p1s->InsertNextPoint(p1);
+    p2s->InsertNextPoint(p2);
+  }
+
+  int status = EXIT_SUCCESS;
+  vtkNew<vtkOBBTree> obbTree;
+  if (!TestLocator(obbTree, sphere->GetOutput(), p1s, p2s))
+  {
+    status = EXIT_FAILURE;
+  }
+  for (int cacheCellBounds = 0; cacheCellBounds < 2; ++cacheCellBounds)
+  {
+    vtkNew<vtkModifiedBSPTree> bspTree;
+    bspTree->SetNumberOfCellsPerNode(8);
+    bspTree->SetCacheCellBounds(cacheCellBounds);
+    if (!TestLocator(bspTree, sphere->GetOutput(), p1s, p2s))
+    {
+      status = EXIT_FAILURE;
+    }
+  }
+  return status;
+}
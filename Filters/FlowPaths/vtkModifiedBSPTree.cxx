@@ -83,8 +83,6 @@ public:
 
 typedef cell_extents* cell_extents_List;
 
-static int global_list_count = 0;
-
 //------------------------------------------------------------------------------
 class Sorted_cell_extents_Lists
 {
@@ -99,7 +97,6 @@ public:
       Mins[i] = new cell_extents[nCells]; // max num <= nCells/2 ?
       Maxs[i] = new cell_extents[nCells];
     }
-    global_list_count += 1;
   };
   ~Sorted_cell_extents_Lists()
   {
@@ -108,7 +105,6 @@ public:
       delete[](this->Mins[i]);
       delete[](this->Maxs[i]);
     }
-    global_list_count -= 1;
   }
 };
 
@@ -153,9 +149,19 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
 
   // create the root node
   this->mRoot = std::make_shared<BSPNode>();
-  this->mRoot->mAxis = rand() % 3;
+  this->mRoot->mAxis = 0;
   this->mRoot->depth = 0;
 
+  // The cell bounds are read concurrently while building the tree. Without
+  // CacheCellBounds they would come from the dataset, whose GetCellBounds()
+  // is not thread safe for every dataset type, so they are cached for the
+  // build only.
+  const int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  const vtkTypeBool cacheCellBounds = this->CacheCellBounds;
+  if (numThreads > 1)
+  {
+    this->CacheCellBounds = 1;
+  }
   this->ComputeCellBounds();
 
   // sort the cells into 6 lists using structure for subdividing tests
@@ -188,10 +194,116 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
   // call the recursive subdivision routine
   vtkDebugMacro(<< "Beginning Subdivision");
 
-  Subdivide(this->mRoot.get(), lists, this->DataSet, numCells, 0, this->MaxLevel,
+  // Subdivide the nodes near the root first, then the nodes below them
+  // concurrently. There are a few subtrees per thread to balance the work.
+  int subtreeLevel = this->MaxLevel;
+  if (numThreads > 1)
+  {
+    subtreeLevel = 0;
+    while ((1 << subtreeLevel) < 4 * numThreads)
+    {
+      subtreeLevel++;
+    }
+    subtreeLevel = std::min(subtreeLevel, this->MaxLevel);
+  }
+  Subdivide(this->mRoot.get(), lists, this->DataSet, numCells, 0, subtreeLevel,
     this->NumberOfCellsPerNode, this->Level);
   delete lists;
 
+  // The nodes at subtreeLevel that are leaves only because of the level
+  // limit are subdivided again from their sorted cell lists, which gives
+  // the same tree as subdividing them in the first pass.
+  std::vector<BSPNode*> nodes(1, this->mRoot.get());
+  std::vector<BSPNode*> subtrees;
+  while (!nodes.empty())
+  {
+    BSPNode* node = nodes.back();
+    nodes.pop_back();
+    if (!node->mChild[0])
+    {
+      if (node->depth == subtreeLevel && subtreeLevel < this->MaxLevel &&
+        node->num_cells > this->NumberOfCellsPerNode)
+      {
+        subtrees.push_back(node);
+      }
+      continue;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+      if (node->mChild[i])
+      {
+        nodes.push_back(node->mChild[i]);
+      }
+    }
+  }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(subtrees.size()), 1,
+    [&](vtkIdType subtreeId, vtkIdType endSubtreeId) {
+      double cellBounds[6], *cellBoundsPtr;
+      for (; subtreeId < endSubtreeId; ++subtreeId)
+      {
+        BSPNode* node = subtrees[subtreeId];
+        vtkIdType nCells = node->num_cells;
+        Sorted_cell_extents_Lists* nodeLists = new Sorted_cell_extents_Lists(nCells);
+        for (int i = 0; i < 3; i++)
+        {
+          for (vtkIdType j = 0; j < nCells; j++)
+          {
+            cell_extents& minExt = nodeLists->Mins[i][j];
+            minExt.cell_ID = node->sorted_cell_lists[i * 2][j];
+            cellBoundsPtr = cellBounds;
+            this->GetCellBounds(minExt.cell_ID, cellBoundsPtr);
+            minExt.min = cellBoundsPtr[i * 2];
+            minExt.max = cellBoundsPtr[i * 2 + 1];
+
+            cell_extents& maxExt = nodeLists->Maxs[i][j];
+            maxExt.cell_ID = node->sorted_cell_lists[i * 2 + 1][j];
+            cellBoundsPtr = cellBounds;
+            this->GetCellBounds(maxExt.cell_ID, cellBoundsPtr);
+            maxExt.min = cellBoundsPtr[i * 2];
+            maxExt.max = cellBoundsPtr[i * 2 + 1];
+          }
+        }
+        for (int i = 0; i < 6; i++)
+        {
+          delete[] node->sorted_cell_lists[i];
+          node->sorted_cell_lists[i] = nullptr;
+        }
+        node->num_cells = 0;
+        int maxDepth = 0;
+        this->Subdivide(node, nodeLists, this->DataSet, nCells, node->depth, this->MaxLevel,
+          this->NumberOfCellsPerNode, maxDepth);
+        delete nodeLists;
+      }
+    });
+  if (!cacheCellBounds)
+  {
+    this->CacheCellBounds = cacheCellBounds;
+    this->FreeCellBounds();
+  }
+
+  // Gather the statistics of the tree
+  nodes.assign(1, this->mRoot.get());
+  while (!nodes.empty())
+  {
+    BSPNode* node = nodes.back();
+    nodes.pop_back();
+    this->Level = std::max(this->Level, node->depth);
+    if (!node->mChild[0])
+    {
+      this->nln += 1; // Leaf node
+      this->tot_depth += node->depth;
+      continue;
+    }
+    this->npn += 1; // Parent node
+    for (int i = 0; i < 3; i++)
+    {
+      if (node->mChild[i])
+      {
+        nodes.push_back(node->mChild[i]);
+      }
+    }
+  }
+
   // Child nodes are responsible for freeing the temporary sorted lists
   this->BuildTime.Modified();
   vtkDebugMacro(<< "BSP Tree Statistics \n"
@@ -266,7 +378,7 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
       {
         node->mChild[i] = new BSPNode();
         node->mChild[i]->depth = node->depth + 1;
-        node->mChild[i]->mAxis = rand() % 3;
+        node->mChild[i]->mAxis = (node->mAxis + i + 1) % 3;
       }
       Daxis = node->mAxis;
       Sorted_cell_extents_Lists* left = new Sorted_cell_extents_Lists(nCells);
@@ -340,6 +452,7 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
           //
           // process the MAX-List
           ext = lists->Maxs[Daxis][i];
+          this->GetCellBounds(ext.cell_ID, cellBoundsPtr);
           if (cellBoundsPtr[2 * node->mAxis + 1] < pDiv)
           {
             left->Maxs[Daxis][Cmax_l[Daxis]++] = ext;
@@ -439,8 +552,6 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
         }
         delete right;
         //
-        npn += 1; // Parent node
-        //
         // we've done all we were asked to do
         //
         return;
@@ -452,8 +563,6 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
   //
   // Copy the cell IDs into the actual node structure for proper use
   node->num_cells = nCells;
-  nln += 1; // Leaf node
-  tot_depth += node->depth;
   for (int i = 0; i < 6; i++)
   {
     node->sorted_cell_lists[i] = new vtkIdType[nCells];
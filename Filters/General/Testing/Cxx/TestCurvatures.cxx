@@ -0,0 +1,217 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCurvatures.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the curvatures and principal directions computed by vtkCurvatures on
+// a torus, made of triangles or of triangle strips, against their known values.
+
+#include "vtkCellArray.h"
+#include "vtkCurvatures.h"
+#include "vtkDataArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStripper.h"
+
+#include <cmath>
+
+namespace
+{
+const int Resolution = 96;
+const double MajorRadius = 1.0;
+const double MinorRadius = 0.3;
+const double Tolerance = 0.01;
+
+// A triangulated torus around the z axis, with outward normals. Point
+// u * Resolution / 2 + v is at angle u around the z axis and v around the
+// tube; the outer equator has v = 0.
+vtkSmartPointer<vtkPolyData> MakeTorus()
+{
+  const int uResolution = Resolution;
+  const int vResolution = Resolution / 2;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int u = 0; u < uResolution; ++u)
+  {
+    const double theta = 2.0 * vtkMath::Pi() * u / uResolution;
+    for (int v = 0; v < vResolution; ++v)
+    {
+      const double phi = 2.0 * vtkMath::Pi() * v / vResolution;
+      const double rho = MajorRadius + MinorRadius * std::cos(phi);
+      points->InsertNextPoint(
+        rho * std::cos(theta), rho * std::sin(theta), MinorRadius * std::sin(phi));
+    }
+  }
+  vtkNew<vtkCellArray> polys;
+  for (int u = 0; u < uResolution; ++u)
+  {
+    for (int v = 0; v < vResolution; ++v)
+    {
+      const vtkIdType p00 = u * vResolution + v;
+      const vtkIdType p10 = ((u + 1) % uResolution) * vResolution + v;
+      const vtkIdType p11 = ((u + 1) % uResolution) * vResolution + (v + 1) % vResolution;
+      const vtkIdType p01 = u * vResolution + (v + 1) % vResolution;
+      const vtkIdType triangle0[3] = { p00, p10, p11 };
+      const vtkIdType triangle1[3] = { p00, p11, p01 };
+      polys->InsertNextCell(3, triangle0);
+      polys->InsertNextCell(3, triangle1);
+    }
+  }
+  vtkNew<vtkPolyData> torus;
+  torus->SetPoints(points);
+  torus->SetPolys(polys);
+  return torus;
+}
+
+vtkSmartPointer<vtkPolyData> Curvatures(vtkPolyData* input, int type, bool principalDirections)
+{
+  vtkNew<vtkCurvatures> curvatures;
+  curvatures->SetInputData(input);
+  curvatures->SetCurvatureType(type);
+  curvatures->SetComputePrincipalDirections(principalDirections);
+  curvatures->Update();
+  return curvatures->GetOutput();
+}
+
+// The angles of a point around the z axis and around the tube.
+void GetAngles(vtkIdType ptId, double& theta, double& phi)
+{
+  theta = 2.0 * vtkMath::Pi() * (ptId / (Resolution / 2)) / Resolution;
+  phi = 2.0 * vtkMath::Pi() * (ptId % (Resolution / 2)) / (Resolution / 2);
+}
+
+// The curvature of a torus around the tube is 1 / MinorRadius, and around
+// the z axis it is cos(phi) / rho, rho being the distance to the z axis.
+double GetExpectedCurvature(int type, vtkIdType ptId)
+{
+  double theta, phi;
+  GetAngles(ptId, theta, phi);
+  const double maximum = 1.0 / MinorRadius;
+  const double minimum = std::cos(phi) / (MajorRadius + MinorRadius * std::cos(phi));
+  switch (type)
+  {
+    case VTK_CURVATURE_GAUSS:
+      return maximum * minimum;
+    case VTK_CURVATURE_MEAN:
+      return 0.5 * (maximum + minimum);
+    case VTK_CURVATURE_MAXIMUM:
+      return maximum;
+    default:
+      return minimum;
+  }
+}
+
+bool TestCurvature(vtkPolyData* output, int type, const char* name)
+{
+  vtkDataArray* curvature = output->GetPointData()->GetArray(name);
+  if (!curvature || curvature->GetNumberOfTuples() != output->GetNumberOfPoints())
+  {
+    std::cerr << "Missing " << name << " array" << std::endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    const double expected = GetExpectedCurvature(type, ptId);
+    if (std::abs(curvature->GetTuple1(ptId) - expected) > Tolerance)
+    {
+      std::cerr << name << " is " << curvature->GetTuple1(ptId) << " at point " << ptId
+                << " instead of " << expected << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// The maximum curvature is along the circles around the tube, and the
+// minimum curvature along the circles around the z axis.
+bool TestPrincipalDirections(vtkPolyData* output)
+{
+  vtkPointData* pointData = output->GetPointData();
+  vtkDataArray* maximumDirection = pointData->GetArray("Maximum_Curvature_Direction");
+  vtkDataArray* minimumDirection = pointData->GetArray("Minimum_Curvature_Direction");
+  if (!maximumDirection || !minimumDirection)
+  {
+    std::cerr << "Missing principal directions" << std::endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double theta, phi;
+    GetAngles(ptId, theta, phi);
+    const double tube[3] = { -std::sin(phi) * std::cos(theta), -std::sin(phi) * std::sin(theta),
+      std::cos(phi) };
+    const double ring[3] = { -std::sin(theta), std::cos(theta), 0.0 };
+    double maxDirection[3], minDirection[3];
+    maximumDirection->GetTuple(ptId, maxDirection);
+    minimumDirection->GetTuple(ptId, minDirection);
+    if (std::abs(vtkMath::Dot(maxDirection, tube)) < 1.0 - Tolerance ||
+      std::abs(vtkMath::Dot(minDirection, ring)) < 1.0 - Tolerance)
+    {
+      std::cerr << "Wrong principal directions at point " << ptId << ": (" << maxDirection[0]
+                << ", " << maxDirection[1] << ", " << maxDirection[2] << ") and ("
+                << minDirection[0] << ", " << minDirection[1] << ", " << minDirection[2] << ")"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestCurvatures(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> torus = MakeTorus();
+  int status = EXIT_SUCCESS;
+
+  // The same torus made of triangle strips, which are triangulated first.
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputData(torus);
+  stripper->Update();
+  vtkPolyData* strips = stripper->GetOutput();
+  if (strips->GetNumberOfStrips() == 0)
+  {
+    std::cerr << "The torus has no triangle strips" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Each curvature alone, then all of them at once with the principal directions.
+  const char* names[4] = { "Gauss_Curvature", "Mean_Curvature", "Maximum_Curvature",
+    "Minimum_Curvature" };
+  vtkPolyData* inputs[2] = { torus, strips };
+  for (vtkPolyData* input : inputs)
+  {
+    vtkSmartPointer<vtkPolyData> principal = Curvatures(input, VTK_CURVATURE_MEAN, true);
+    for (int type = VTK_CURVATURE_GAUSS; type <= VTK_CURVATURE_MINIMUM; ++type)
+    {
+      if (!TestCurvature(Curvatures(input, type, false), type, names[type]) ||
+        !TestCurvature(principal, type, names[type]))
+      {
+        status = EXIT_FAILURE;
+      }
+    }
+    if (principal->GetPointData()->GetScalars() !=
+      principal->GetPointData()->GetArray("Mean_Curvature"))
+    {
+      std::cerr << "The active scalars are not the mean curvature" << std::endl;
+      status = EXIT_FAILURE;
+    }
+    if (!TestPrincipalDirections(principal))
+    {
+      status = EXIT_FAILURE;
+    }
+  }
+  return status;
+}
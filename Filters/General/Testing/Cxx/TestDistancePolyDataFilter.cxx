@@ -14,7 +14,9 @@
 #include <vtkSmartPointer.h>
 
 #include <vtkActor.h>
+#include <vtkCellData.h>
 #include <vtkDistancePolyDataFilter.h>
+#include <vtkPlaneSource.h>
 #include <vtkPointData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkRenderWindow.h>
@@ -23,8 +25,88 @@
 #include <vtkScalarBarActor.h>
 #include <vtkSphereSource.h>
 
+#include <cmath>
+
+namespace
+{
+// The signed distance of a point to the plane z = 0 is its z coordinate, and
+// the distance of a point of the plane to a sphere of radius 0.5 centered at
+// the origin is about its distance to the origin minus 0.5.
+int TestSphereAndPlaneDistances()
+{
+  vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(30);
+
+  vtkSmartPointer<vtkPlaneSource> plane = vtkSmartPointer<vtkPlaneSource>::New();
+  plane->SetOrigin(-2.0, -2.0, 0.0);
+  plane->SetPoint1(2.0, -2.0, 0.0);
+  plane->SetPoint2(-2.0, 2.0, 0.0);
+  plane->SetResolution(40, 40);
+
+  vtkSmartPointer<vtkDistancePolyDataFilter> distanceFilter =
+    vtkSmartPointer<vtkDistancePolyDataFilter>::New();
+  distanceFilter->SetInputConnection(0, sphere->GetOutputPort());
+  distanceFilter->SetInputConnection(1, plane->GetOutputPort());
+  distanceFilter->Update();
+
+  vtkPolyData* output = distanceFilter->GetOutput();
+  vtkDataArray* pointDistances = output->GetPointData()->GetArray("Distance");
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    output->GetPoint(ptId, x);
+    if (std::abs(pointDistances->GetTuple1(ptId) - x[2]) > 1e-6)
+    {
+      std::cerr << "Point " << ptId << " of the sphere is at distance "
+                << pointDistances->GetTuple1(ptId) << " instead of " << x[2] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  vtkDataArray* cellDistances = output->GetCellData()->GetArray("Distance");
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    double z = 0.0;
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      z += output->GetPoint(ptIds->GetId(i))[2] / ptIds->GetNumberOfIds();
+    }
+    if (std::abs(cellDistances->GetTuple1(cellId) - z) > 1e-6)
+    {
+      std::cerr << "Cell " << cellId << " of the sphere is at distance "
+                << cellDistances->GetTuple1(cellId) << " instead of " << z << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  output = distanceFilter->GetSecondDistanceOutput();
+  pointDistances = output->GetPointData()->GetArray("Distance");
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    output->GetPoint(ptId, x);
+    const double expected = std::sqrt(x[0] * x[0] + x[1] * x[1]) - 0.5;
+    if (std::abs(pointDistances->GetTuple1(ptId) - expected) > 0.01)
+    {
+      std::cerr << "Point " << ptId << " of the plane is at distance "
+                << pointDistances->GetTuple1(ptId) << " instead of about " << expected
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+}
+
 int TestDistancePolyDataFilter(int, char*[])
 {
+  if (TestSphereAndPlaneDistances() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
   vtkSmartPointer<vtkSphereSource> model1 = vtkSmartPointer<vtkSphereSource>::New();
   model1->SetPhiResolution(11);
   model1->SetThetaResolution(11);
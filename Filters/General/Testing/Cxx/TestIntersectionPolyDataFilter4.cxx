@@ -14,10 +14,126 @@
 
 #include <vtkIntersectionPolyDataFilter.h>
 
+#include <vtkCellArray.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
+#include <vtkPolyData.h>
 #include <vtkSphereSource.h>
+#include <vtkTriangle.h>
 #include <vtkTriangleFilter.h>
 
+#include <cmath>
+#include <vector>
+
+namespace
+{
+double GetArea(vtkPolyData* polyData)
+{
+  double area = 0.0;
+  vtkIdType npts;
+  const vtkIdType* pts;
+  vtkCellArray* polys = polyData->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    double p0[3], p1[3], p2[3];
+    polyData->GetPoint(pts[0], p0);
+    polyData->GetPoint(pts[1], p1);
+    polyData->GetPoint(pts[2], p2);
+    area += vtkTriangle::TriangleArea(p0, p1, p2);
+  }
+  return area;
+}
+
+// Two spheres of radius 0.5 whose centers are sqrt(0.075) apart intersect
+// along a circle of radius sqrt(0.25 - 0.075 / 4).
+int TestSpheresIntersection()
+{
+  const double center1[3] = { 0.25, 0.1, 0.05 };
+  vtkNew<vtkSphereSource> sphere0;
+  sphere0->SetThetaResolution(60);
+  sphere0->SetPhiResolution(40);
+  sphere0->Update();
+  vtkNew<vtkSphereSource> sphere1;
+  sphere1->SetCenter(center1[0], center1[1], center1[2]);
+  sphere1->SetThetaResolution(50);
+  sphere1->SetPhiResolution(30);
+  sphere1->Update();
+
+  vtkNew<vtkIntersectionPolyDataFilter> interFilter;
+  interFilter->SetInputConnection(0, sphere0->GetOutputPort());
+  interFilter->SetInputConnection(1, sphere1->GetOutputPort());
+  interFilter->SplitFirstOutputOn();
+  interFilter->SplitSecondOutputOn();
+  interFilter->Update();
+  vtkPolyData* lines = interFilter->GetOutput(0);
+
+  // The points are on both tessellated spheres, and the lines form a loop.
+  const double origin[3] = { 0.0, 0.0, 0.0 };
+  std::vector<int> valences(lines->GetNumberOfPoints(), 0);
+  double length = 0.0;
+  vtkIdType npts;
+  const vtkIdType* pts;
+  vtkCellArray* cells = lines->GetLines();
+  for (cells->InitTraversal(); cells->GetNextCell(npts, pts);)
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      ++valences[pts[i]];
+    }
+    for (vtkIdType i = 1; i < npts; ++i)
+    {
+      double p0[3], p1[3];
+      lines->GetPoint(pts[i - 1], p0);
+      lines->GetPoint(pts[i], p1);
+      length += std::sqrt(vtkMath::Distance2BetweenPoints(p0, p1));
+    }
+  }
+  for (vtkIdType ptId = 0; ptId < lines->GetNumberOfPoints(); ++ptId)
+  {
+    double p[3];
+    lines->GetPoint(ptId, p);
+    const double r0 = std::sqrt(vtkMath::Distance2BetweenPoints(p, origin));
+    const double r1 = std::sqrt(vtkMath::Distance2BetweenPoints(p, center1));
+    if (r0 < 0.49 || r0 > 0.5 + 1e-6 || r1 < 0.49 || r1 > 0.5 + 1e-6)
+    {
+      std::cerr << "Intersection point " << ptId << " is at " << r0 << " and " << r1
+                << " from the centers of the spheres" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (valences[ptId] != 2)
+    {
+      std::cerr << "Intersection point " << ptId << " is used by " << valences[ptId]
+                << " lines instead of 2" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  const double expectedLength = 2.0 * vtkMath::Pi() * std::sqrt(0.25 - 0.075 / 4.0);
+  if (std::abs(length - expectedLength) > 0.01 * expectedLength)
+  {
+    std::cerr << "Intersection has length " << length << " instead of about " << expectedLength
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Splitting the surfaces along the intersection keeps their area.
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkPolyData* input = vtkPolyData::SafeDownCast(interFilter->GetInputDataObject(i, 0));
+    vtkPolyData* split = interFilter->GetOutput(i + 1);
+    const double area = GetArea(input);
+    if (split->GetNumberOfPolys() <= input->GetNumberOfPolys() ||
+      std::abs(GetArea(split) - area) > 1e-4 * area)
+    {
+      std::cerr << "Surface " << i << " was split into " << split->GetNumberOfPolys()
+                << " triangles of area " << GetArea(split) << " instead of " << area
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+}
+
 // This test exercises the conditions that previously led to an out-of-bounds
 // memory access when computing the intersection between two surfaces, at least
 // one of which was not entirely enclosed (the sphere ending at Theta=305 below).
@@ -41,5 +157,5 @@ int TestIntersectionPolyDataFilter4(int, char*[])
   interFilter->SplitSecondOutputOn();
   interFilter->Update();
 
-  return EXIT_SUCCESS;
+  return TestSpheresIntersection();
 }
@@ -0,0 +1,294 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestYoungsMaterialInterfaceLayers.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the interfaces reconstructed by vtkYoungsMaterialInterface between
+// layers of materials against the known number of mixed cells, and the areas
+// of the materials filling a 2D mesh against their volume fractions.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolygon.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkYoungsMaterialInterface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace
+{
+const int NumberOfMaterials = 3;
+const double MaterialFractionRange[2] = { 0.001, 0.999 };
+
+// A grid of hexahedra, or of quads in the z = 0 plane, with the volume
+// fractions and normals of three materials stacked in layers along an oblique
+// direction. Point data is added to exercise its interpolation.
+vtkSmartPointer<vtkUnstructuredGrid> MakeGrid(int dimension, bool threeD)
+{
+  const int nz = threeD ? dimension : 0;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkIntArray> pointIds;
+  pointIds->SetName("PointIds");
+  for (int k = 0; k <= nz; ++k)
+  {
+    for (int j = 0; j <= dimension; ++j)
+    {
+      for (int i = 0; i <= dimension; ++i)
+      {
+        pointIds->InsertNextValue(static_cast<int>(points->GetNumberOfPoints()));
+        points->InsertNextPoint(i + 0.1 * std::sin(j + k), j, k);
+      }
+    }
+  }
+  auto id = [dimension](int i, int j, int k) {
+    return static_cast<vtkIdType>((k * (dimension + 1) + j) * (dimension + 1) + i);
+  };
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(pointIds);
+  for (int k = 0; k < std::max(nz, 1); ++k)
+  {
+    for (int j = 0; j < dimension; ++j)
+    {
+      for (int i = 0; i < dimension; ++i)
+      {
+        if (threeD)
+        {
+          const vtkIdType hexahedron[8] = { id(i, j, k), id(i + 1, j, k), id(i + 1, j + 1, k),
+            id(i, j + 1, k), id(i, j, k + 1), id(i + 1, j, k + 1), id(i + 1, j + 1, k + 1),
+            id(i, j + 1, k + 1) };
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, hexahedron);
+        }
+        else
+        {
+          const vtkIdType quad[4] = { id(i, j, 0), id(i + 1, j, 0), id(i + 1, j + 1, 0),
+            id(i, j + 1, 0) };
+          grid->InsertNextCell(VTK_QUAD, 4, quad);
+        }
+      }
+    }
+  }
+
+  const vtkIdType numCells = grid->GetNumberOfCells();
+  double direction[3] = { 3.0, 2.0, threeD ? 1.0 : 0.0 };
+  vtkMath::Normalize(direction);
+  const double extent = vtkMath::Dot(direction, points->GetPoint(points->GetNumberOfPoints() - 1));
+  const double layers[2] = { 0.35 * extent, 0.65 * extent };
+  for (int m = 0; m < NumberOfMaterials; ++m)
+  {
+    vtkNew<vtkDoubleArray> fraction;
+    fraction->SetName(("Fraction" + std::to_string(m)).c_str());
+    fraction->SetNumberOfTuples(numCells);
+    vtkNew<vtkDoubleArray> normal;
+    normal->SetName(("Normal" + std::to_string(m)).c_str());
+    normal->SetNumberOfComponents(3);
+    normal->SetNumberOfTuples(numCells);
+    grid->GetCellData()->AddArray(fraction);
+    grid->GetCellData()->AddArray(normal);
+  }
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(numCells);
+  grid->GetCellData()->AddArray(cellIds);
+
+  vtkNew<vtkIdList> cellPointIds;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    double x[3] = { 0.0, 0.0, 0.0 };
+    grid->GetCellPoints(cellId, cellPointIds);
+    for (vtkIdType i = 0; i < cellPointIds->GetNumberOfIds(); ++i)
+    {
+      double p[3];
+      points->GetPoint(cellPointIds->GetId(i), p);
+      vtkMath::Add(x, p, x);
+    }
+    vtkMath::MultiplyScalar(x, 1.0 / cellPointIds->GetNumberOfIds());
+    // the fraction of the material below each layer varies linearly across
+    // about two cells around it
+    const double s = vtkMath::Dot(direction, x);
+    const double below0 = std::min(1.0, std::max(0.0, 0.5 - (s - layers[0]) / 2.0));
+    const double below1 = std::min(1.0, std::max(0.0, 0.5 - (s - layers[1]) / 2.0));
+    const double fractions[NumberOfMaterials] = { below0, below1 - below0, 1.0 - below1 };
+    for (int m = 0; m < NumberOfMaterials; ++m)
+    {
+      vtkCellData* cellData = grid->GetCellData();
+      cellData->GetArray(("Fraction" + std::to_string(m)).c_str())->SetTuple1(cellId, fractions[m]);
+      cellData->GetArray(("Normal" + std::to_string(m)).c_str())->SetTuple(cellId, direction);
+    }
+    cellIds->SetValue(cellId, static_cast<int>(cellId));
+  }
+  return grid;
+}
+
+vtkSmartPointer<vtkMultiBlockDataSet> Reconstruct(
+  vtkMultiBlockDataSet* input, bool fillMaterial, bool onionPeel)
+{
+  vtkNew<vtkYoungsMaterialInterface> youngs;
+  youngs->SetInputData(input);
+  youngs->SetNumberOfMaterials(NumberOfMaterials);
+  for (int m = 0; m < NumberOfMaterials; ++m)
+  {
+    youngs->SetMaterialVolumeFractionArray(m, ("Fraction" + std::to_string(m)).c_str());
+    youngs->SetMaterialNormalArray(m, ("Normal" + std::to_string(m)).c_str());
+  }
+  youngs->SetVolumeFractionRange(MaterialFractionRange[0], MaterialFractionRange[1]);
+  youngs->SetFillMaterial(fillMaterial);
+  youngs->SetOnionPeel(onionPeel);
+  youngs->UseAllBlocksOn();
+  youngs->Update();
+  vtkSmartPointer<vtkMultiBlockDataSet> output = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  output->DeepCopy(youngs->GetOutput());
+  return output;
+}
+
+// The number of cells whose total fraction of the materials firstMaterial to
+// lastMaterial is above the minimum of the range, and within the range.
+void CountCells(vtkUnstructuredGrid* grid, int firstMaterial, int lastMaterial,
+  vtkIdType& numFilled, vtkIdType& numMixed)
+{
+  numFilled = 0;
+  numMixed = 0;
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    double fraction = 0.0;
+    for (int m = firstMaterial; m <= lastMaterial; ++m)
+    {
+      fraction +=
+        grid->GetCellData()->GetArray(("Fraction" + std::to_string(m)).c_str())->GetTuple1(cellId);
+    }
+    if (fraction > MaterialFractionRange[0])
+    {
+      ++numFilled;
+      if (fraction < MaterialFractionRange[1])
+      {
+        ++numMixed;
+      }
+    }
+  }
+}
+
+vtkUnstructuredGrid* GetMaterialBlock(vtkMultiBlockDataSet* output, int m, int block)
+{
+  vtkMultiBlockDataSet* material = vtkMultiBlockDataSet::SafeDownCast(output->GetBlock(m));
+  return material && static_cast<int>(material->GetNumberOfBlocks()) > block
+    ? vtkUnstructuredGrid::SafeDownCast(material->GetBlock(block))
+    : nullptr;
+}
+
+// Area of the 2D cells of a material.
+double ComputeArea(vtkUnstructuredGrid* grid)
+{
+  double area = 0.0;
+  vtkNew<vtkIdList> cellPointIds;
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    grid->GetCellPoints(cellId, cellPointIds);
+    double normal[3];
+    area += vtkPolygon::ComputeArea(grid->GetPoints(), cellPointIds->GetNumberOfIds(),
+      cellPointIds->GetPointer(0), normal);
+  }
+  return area;
+}
+}
+
+int TestYoungsMaterialInterfaceLayers(int, char*[])
+{
+  const int dimension = 24;
+  vtkNew<vtkMultiBlockDataSet> input;
+  input->SetNumberOfBlocks(2);
+  vtkSmartPointer<vtkUnstructuredGrid> grids[2] = { MakeGrid(dimension, true),
+    MakeGrid(4 * dimension, false) };
+  input->SetBlock(0, grids[0]);
+  input->SetBlock(1, grids[1]);
+
+  int status = EXIT_SUCCESS;
+  for (int mode = 0; mode < 4; ++mode)
+  {
+    const bool fillMaterial = (mode & 1) != 0;
+    const bool onionPeel = (mode & 2) != 0;
+    vtkSmartPointer<vtkMultiBlockDataSet> output = Reconstruct(input, fillMaterial, onionPeel);
+
+    // With FillMaterial, each material has a cell in each cell it fills.
+    // Otherwise each material but the last one has the interface with the
+    // materials after it, in the cells that they share.
+    for (int m = 0; m < NumberOfMaterials; ++m)
+    {
+      for (int block = 0; block < 2; ++block)
+      {
+        vtkIdType numFilled, numMixed;
+        CountCells(grids[block], fillMaterial ? m : 0, m, numFilled, numMixed);
+        const vtkIdType expected =
+          fillMaterial ? numFilled : (m < NumberOfMaterials - 1 ? numMixed : 0);
+        vtkUnstructuredGrid* grid = GetMaterialBlock(output, m, block);
+        const vtkIdType numCells = grid ? grid->GetNumberOfCells() : 0;
+        if (numCells != expected)
+        {
+          std::cerr << "Material " << m << " of block " << block << " with FillMaterial "
+                    << fillMaterial << " and OnionPeel " << onionPeel << " has " << numCells
+                    << " cells instead of " << expected << std::endl;
+          status = EXIT_FAILURE;
+        }
+      }
+    }
+    if (!fillMaterial)
+    {
+      continue;
+    }
+
+    // The cells of the 2D grid have a unit area, so the filled materials
+    // partition the area of their volume fractions, up to the fractions out of
+    // the range. Each material is only cut along its normal, so its own area
+    // is checked against its volume fractions with a looser tolerance.
+    double totalArea = 0.0;
+    double expectedTotalArea = 0.0;
+    for (int m = 0; m < NumberOfMaterials; ++m)
+    {
+      vtkDataArray* fraction =
+        grids[1]->GetCellData()->GetArray(("Fraction" + std::to_string(m)).c_str());
+      double expectedArea = 0.0;
+      for (vtkIdType cellId = 0; cellId < fraction->GetNumberOfTuples(); ++cellId)
+      {
+        expectedArea += fraction->GetTuple1(cellId);
+      }
+      vtkUnstructuredGrid* grid = GetMaterialBlock(output, m, 1);
+      const double area = grid ? ComputeArea(grid) : 0.0;
+      if (std::abs(area - expectedArea) > 1.0e-2 * expectedArea)
+      {
+        std::cerr << "Material " << m << " has an area of " << area << " instead of "
+                  << expectedArea << " with OnionPeel " << onionPeel << std::endl;
+        status = EXIT_FAILURE;
+      }
+      totalArea += area;
+      expectedTotalArea += expectedArea;
+    }
+    if (std::abs(totalArea - expectedTotalArea) > 1.0e-6 * expectedTotalArea)
+    {
+      std::cerr << "The materials have an area of " << totalArea << " instead of "
+                << expectedTotalArea << " with OnionPeel " << onionPeel << std::endl;
+      status = EXIT_FAILURE;
+    }
+  }
+  return status;
+}
@@ -28,11 +28,18 @@
 #include "vtkPolyData.h"
 #include "vtkPolyDataNormals.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleFilter.h"
 #include "vtkTriangleStrip.h"
 
-#include <memory> // For unique_ptr
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkCurvatures);
 
@@ -41,30 +48,73 @@ vtkCurvatures::vtkCurvatures()
 {
   this->CurvatureType = VTK_CURVATURE_GAUSS;
   this->InvertMeanCurvature = 0;
+  this->ComputePrincipalDirections = false;
 }
-//-------------------------------------------------------//
-void vtkCurvatures::GetMeanCurvature(vtkPolyData* mesh)
+namespace
+{
+// Triangulate the triangle strips of the mesh, if any. The cells of the
+// returned mesh are built, so that they can be queried concurrently.
+vtkPolyData* TriangulateStrips(vtkPolyData* mesh, vtkTriangleFilter* triangulateFilter)
 {
-  vtkDebugMacro("Start vtkCurvatures::GetMeanCurvature");
-
-  bool hasTriangleStrip = false;
   for (vtkIdType cellId = 0; cellId < mesh->GetNumberOfCells(); ++cellId)
   {
     if (mesh->GetCellType(cellId) == VTK_TRIANGLE_STRIP)
     {
-      hasTriangleStrip = true;
-      break;
+      triangulateFilter->SetInputData(mesh);
+      triangulateFilter->Update();
+      vtkPolyData* triangles = triangulateFilter->GetOutput();
+      if (triangles->NeedToBuildCells())
+      {
+        triangles->BuildCells();
+      }
+      return triangles;
     }
   }
+  return mesh;
+}
 
-  vtkPolyData* polyData = mesh;
-  vtkNew<vtkTriangleFilter> triangulateFilter;
-  if (hasTriangleStrip)
+// Return the cells using a point in increasing order, each once, so that the
+// contributions of the cells are gathered in the order they were scattered
+// by the serial implementation.
+void GetSortedCells(
+  vtkStaticCellLinksTemplate<vtkIdType>& links, vtkIdType ptId, std::vector<vtkIdType>& cells)
+{
+  const vtkIdType* linkCells = links.GetCells(ptId);
+  cells.assign(linkCells, linkCells + links.GetNcells(ptId));
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+}
+
+// Return the only cell other than cellId using the edge (p1, p2), or -1 if
+// there is none or more than one.
+vtkIdType GetEdgeNeighbor(
+  vtkStaticCellLinksTemplate<vtkIdType>& links, vtkIdType cellId, vtkIdType p1, vtkIdType p2)
+{
+  const vtkIdType* cells1 = links.GetCells(p1);
+  const vtkIdType* cells1End = cells1 + links.GetNcells(p1);
+  const vtkIdType* cells2 = links.GetCells(p2);
+  const vtkIdType* cells2End = cells2 + links.GetNcells(p2);
+  vtkIdType numNeighbors = 0;
+  vtkIdType neighbor = -1;
+  for (; cells1 != cells1End; ++cells1)
   {
-    triangulateFilter->SetInputData(mesh);
-    triangulateFilter->Update();
-    polyData = triangulateFilter->GetOutput();
+    if (*cells1 != cellId && std::find(cells2, cells2End, *cells1) != cells2End)
+    {
+      neighbor = *cells1;
+      ++numNeighbors;
+    }
   }
+  return numNeighbors == 1 ? neighbor : -1;
+}
+}
+
+//-------------------------------------------------------//
+void vtkCurvatures::GetMeanCurvature(vtkPolyData* mesh)
+{
+  vtkDebugMacro("Start vtkCurvatures::GetMeanCurvature");
+
+  vtkNew<vtkTriangleFilter> triangulateFilter;
+  vtkPolyData* polyData = TriangulateStrips(mesh, triangulateFilter);
 
   // Empty array check
   if (polyData->GetNumberOfPolys() == 0 || polyData->GetNumberOfPoints() == 0)
@@ -73,12 +123,7 @@ void vtkCurvatures::GetMeanCurvature(vtkPolyData* mesh)
     return;
   }
 
-  int numPts = polyData->GetNumberOfPoints();
-
-  //     create-allocate
-  const vtkNew<vtkIdList> vertices;
-  const vtkNew<vtkIdList> vertices_n;
-  const vtkNew<vtkIdList> neighbours;
+  const vtkIdType numPts = polyData->GetNumberOfPoints();
   const vtkNew<vtkDoubleArray> meanCurvature;
   meanCurvature->SetName("Mean_Curvature");
   meanCurvature->SetNumberOfComponents(1);
@@ -86,126 +131,161 @@ void vtkCurvatures::GetMeanCurvature(vtkPolyData* mesh)
   // Get the array so we can write to it directly
   double* meanCurvatureData = meanCurvature->GetPointer(0);
 
-  //     create-allocate
-  double n_f[3]; // normal of facet (could be stored for later?)
-  double n_n[3]; // normal of edge
-  double t[3];   // to store the cross product of n_f n_n
-  double ore[3]; // origin of e
-  double end[3]; // end of e
-  double oth[3]; //     third vertex necessary for comp of n
-  double vn0[3];
-  double vn1[3]; // vertices for computation of neighbour's n
-  double vn2[3];
-  double e[3]; // edge (oriented)
-
-  polyData->BuildLinks();
   // data init
-  const int F = polyData->GetNumberOfCells();
-  // init, preallocate the mean curvature
-  const std::unique_ptr<int[]> num_neighb(new int[numPts]);
-  for (int v = 0; v < numPts; v++)
+  const vtkIdType F = polyData->GetNumberOfCells();
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.BuildLinks(polyData);
+
+  // Each edge of each facet gets a slot storing its weighted mean curvature,
+  // if it is computed for this facet.
+  std::vector<vtkIdType> edgeOffsets(F + 1);
+  edgeOffsets[0] = 0;
+  for (vtkIdType f = 0; f < F; ++f)
   {
-    meanCurvatureData[v] = 0.0;
-    num_neighb[v] = 0;
+    edgeOffsets[f + 1] = edgeOffsets[f] + polyData->GetCellSize(f);
   }
+  std::vector<double> edgeCurvature(edgeOffsets[F]);
+  std::vector<unsigned char> hasEdgeCurvature(edgeOffsets[F]);
 
   //     main loop
   vtkDebugMacro(<< "Main loop: loop over facets such that id > id of neighb");
   vtkDebugMacro(<< "so that every edge comes only once");
 
-  for (vtkIdType f = 0; f < F; ++f)
-  {
-    polyData->GetCellPoints(f, vertices);
-    const vtkIdType nv = vertices->GetNumberOfIds();
-
-    for (vtkIdType v = 0; v < nv; v++)
+  vtkSMPThreadLocalObject<vtkIdList> tlVertices;
+  vtkSMPThreadLocalObject<vtkIdList> tlVerticesN;
+  vtkSMPTools::For(0, F, [&](vtkIdType beginFacet, vtkIdType endFacet) {
+    vtkIdList* vertices = tlVertices.Local();
+    vtkIdList* vertices_n = tlVerticesN.Local();
+    double n_f[3]; // normal of facet (could be stored for later?)
+    double n_n[3]; // normal of edge
+    double t[3];   // to store the cross product of n_f n_n
+    double ore[3]; // origin of e
+    double end[3]; // end of e
+    double oth[3]; //     third vertex necessary for comp of n
+    double vn0[3];
+    double vn1[3]; // vertices for computation of neighbour's n
+    double vn2[3];
+    double e[3]; // edge (oriented)
+    vtkIdType nv, nv_n;
+    const vtkIdType* pts;
+    const vtkIdType* pts_n;
+
+    for (vtkIdType f = beginFacet; f < endFacet; ++f)
     {
-      // get neighbour
-      const vtkIdType v_l = vertices->GetId(v);
-      const vtkIdType v_r = vertices->GetId((v + 1) % nv);
-      const vtkIdType v_o = vertices->GetId((v + 2) % nv);
-      polyData->GetCellEdgeNeighbors(f, v_l, v_r, neighbours);
-
-      vtkIdType n; // n short for neighbor
-
-      // compute only if there is really ONE neighbour
-      // AND meanCurvature has not been computed yet!
-      // (ensured by n > f)
-      if (neighbours->GetNumberOfIds() == 1 && (n = neighbours->GetId(0)) > f)
+      polyData->GetCellPoints(f, nv, pts, vertices);
+      for (vtkIdType v = 0; v < nv; v++)
       {
-        double Hf; // temporary store
-
-        // find 3 corners of f: in order!
-        polyData->GetPoint(v_l, ore);
-        polyData->GetPoint(v_r, end);
-        polyData->GetPoint(v_o, oth);
-        // compute normal of f
-        vtkTriangle::ComputeNormal(ore, end, oth, n_f);
-        // compute common edge
-        e[0] = end[0];
-        e[1] = end[1];
-        e[2] = end[2];
-        e[0] -= ore[0];
-        e[1] -= ore[1];
-        e[2] -= ore[2];
-        const double length = vtkMath::Normalize(e);
-        double Af = vtkTriangle::TriangleArea(ore, end, oth);
-        // find 3 corners of n: in order!
-        polyData->GetCellPoints(n, vertices_n);
-        polyData->GetPoint(vertices_n->GetId(0), vn0);
-        polyData->GetPoint(vertices_n->GetId(1), vn1);
-        polyData->GetPoint(vertices_n->GetId(2), vn2);
-        Af += double(vtkTriangle::TriangleArea(vn0, vn1, vn2));
-        // compute normal of n
-        vtkTriangle::ComputeNormal(vn0, vn1, vn2, n_n);
-        // the cosine is n_f * n_n
-        const double cs = vtkMath::Dot(n_f, n_n);
-        // the sin is (n_f x n_n) * e
-        vtkMath::Cross(n_f, n_n, t);
-        const double sn = vtkMath::Dot(t, e);
-        // signed angle in [-pi,pi]
-        if (sn != 0.0 || cs != 0.0)
-        {
-          const double angle = atan2(sn, cs);
-          Hf = length * angle;
-        }
-        else
-        {
-          Hf = 0.0;
-        }
-        // add weighted Hf to scalar at v_l and v_r
-        if (Af != 0.0)
+        // get neighbour
+        const vtkIdType v_l = pts[v];
+        const vtkIdType v_r = pts[(v + 1) % nv];
+        const vtkIdType v_o = pts[(v + 2) % nv];
+        const vtkIdType n = GetEdgeNeighbor(links, f, v_l, v_r); // n short for neighbor
+
+        // compute only if there is really ONE neighbour
+        // AND meanCurvature has not been computed yet!
+        // (ensured by n > f)
+        if (n > f)
         {
-          (Hf /= Af) *= 3.0;
+          double Hf; // temporary store
+
+          // find 3 corners of f: in order!
+          polyData->GetPoint(v_l, ore);
+          polyData->GetPoint(v_r, end);
+          polyData->GetPoint(v_o, oth);
+          // compute normal of f
+          vtkTriangle::ComputeNormal(ore, end, oth, n_f);
+          // compute common edge
+          e[0] = end[0];
+          e[1] = end[1];
+          e[2] = end[2];
+          e[0] -= ore[0];
+          e[1] -= ore[1];
+          e[2] -= ore[2];
+          const double length = vtkMath::Normalize(e);
+          double Af = vtkTriangle::TriangleArea(ore, end, oth);
+          // find 3 corners of n: in order!
+          polyData->GetCellPoints(n, nv_n, pts_n, vertices_n);
+          polyData->GetPoint(pts_n[0], vn0);
+          polyData->GetPoint(pts_n[1], vn1);
+          polyData->GetPoint(pts_n[2], vn2);
+          Af += double(vtkTriangle::TriangleArea(vn0, vn1, vn2));
+          // compute normal of n
+          vtkTriangle::ComputeNormal(vn0, vn1, vn2, n_n);
+          // the cosine is n_f * n_n
+          const double cs = vtkMath::Dot(n_f, n_n);
+          // the sin is (n_f x n_n) * e
+          vtkMath::Cross(n_f, n_n, t);
+          const double sn = vtkMath::Dot(t, e);
+          // signed angle in [-pi,pi]
+          if (sn != 0.0 || cs != 0.0)
+          {
+            const double angle = atan2(sn, cs);
+            Hf = length * angle;
+          }
+          else
+          {
+            Hf = 0.0;
+          }
+          // weighted Hf is added to scalar at v_l and v_r
+          if (Af != 0.0)
+          {
+            (Hf /= Af) *= 3.0;
+          }
+          edgeCurvature[edgeOffsets[f] + v] = Hf;
+          hasEdgeCurvature[edgeOffsets[f] + v] = 1;
         }
-        meanCurvatureData[v_l] += Hf;
-        meanCurvatureData[v_r] += Hf;
-        num_neighb[v_l] += 1;
-        num_neighb[v_r] += 1;
       }
     }
-  }
-
-  // put curvature in vtkArray
-  for (int v = 0; v < numPts; v++)
-  {
-    if (num_neighb[v] > 0)
+  });
+
+  // Gather the weighted mean curvature of the edges at each point, and put
+  // curvature in vtkArray
+  vtkSMPThreadLocal<std::vector<vtkIdType>> tlCells;
+  const bool invert = this->InvertMeanCurvature != 0;
+  vtkSMPTools::For(0, numPts, [&](vtkIdType beginPt, vtkIdType endPt) {
+    vtkIdList* vertices = tlVertices.Local();
+    std::vector<vtkIdType>& cells = tlCells.Local();
+    vtkIdType nv;
+    const vtkIdType* pts;
+
+    for (vtkIdType ptId = beginPt; ptId < endPt; ++ptId)
     {
-      const double Hf = 0.5 * meanCurvatureData[v] / num_neighb[v];
-      if (this->InvertMeanCurvature)
+      double H = 0.0;
+      int num_neighb = 0;
+      GetSortedCells(links, ptId, cells);
+      for (vtkIdType f : cells)
+      {
+        polyData->GetCellPoints(f, nv, pts, vertices);
+        for (vtkIdType v = 0; v < nv; v++)
+        {
+          if (!hasEdgeCurvature[edgeOffsets[f] + v])
+          {
+            continue;
+          }
+          const double Hf = edgeCurvature[edgeOffsets[f] + v];
+          if (pts[v] == ptId)
+          {
+            H += Hf;
+            num_neighb += 1;
+          }
+          if (pts[(v + 1) % nv] == ptId)
+          {
+            H += Hf;
+            num_neighb += 1;
+          }
+        }
+      }
+      if (num_neighb > 0)
       {
-        meanCurvatureData[v] = -Hf;
+        const double Hf = 0.5 * H / num_neighb;
+        meanCurvatureData[ptId] = invert ? -Hf : Hf;
       }
       else
       {
-        meanCurvatureData[v] = Hf;
+        meanCurvatureData[ptId] = 0.0;
       }
     }
-    else
-    {
-      meanCurvatureData[v] = 0.0;
-    }
-  }
+  });
 
   mesh->GetPointData()->AddArray(meanCurvature);
   mesh->GetPointData()->SetActiveScalars("Mean_Curvature");
@@ -221,13 +301,14 @@ void vtkCurvatures::GetGaussCurvature(vtkPolyData* output)
   vtkCellArray* facets = output->GetPolys();
 
   vtkNew<vtkCellArray> triangleStrip;
+  vtkNew<vtkIdList> stripIds;
   for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
   {
     if (output->GetCellType(cellId) == VTK_TRIANGLE_STRIP)
     {
-      vtkCell* cell = output->GetCell(cellId);
+      output->GetCellPoints(cellId, stripIds);
       vtkTriangleStrip::DecomposeStrip(
-        cell->GetNumberOfPoints(), cell->GetPointIds()->GetPointer(0), triangleStrip);
+        stripIds->GetNumberOfIds(), stripIds->GetPointer(0), triangleStrip);
     }
   }
   // Empty array check
@@ -264,76 +345,93 @@ void vtkCurvatures::GetGaussCurvature(vtkPolyData* output)
 void vtkCurvatures::ComputeGaussCurvature(
   vtkCellArray* facets, vtkPolyData* output, double* gaussCurvatureData)
 {
-  double v0[3], v1[3], v2[3], e0[3], e1[3], e2[3];
-
-  double A, alpha0, alpha1, alpha2;
-
-  vtkIdType f;
-  const vtkIdType* vert = nullptr;
-
   // other data
   vtkIdType Nv = output->GetNumberOfPoints();
-
-  const std::unique_ptr<double[]> K(new double[Nv]);
-  const std::unique_ptr<double[]> dA(new double[Nv]);
-  double pi2 = 2.0 * vtkMath::Pi();
-  for (int k = 0; k < Nv; k++)
-  {
-    K[k] = pi2;
-    dA[k] = 0.0;
-  }
-
-  facets->InitTraversal();
-  while (facets->GetNextCell(f, vert))
-  {
-    output->GetPoint(vert[0], v0);
-    output->GetPoint(vert[1], v1);
-    output->GetPoint(vert[2], v2);
-    // edges
-    e0[0] = v1[0];
-    e0[1] = v1[1];
-    e0[2] = v1[2];
-    e0[0] -= v0[0];
-    e0[1] -= v0[1];
-    e0[2] -= v0[2];
-
-    e1[0] = v2[0];
-    e1[1] = v2[1];
-    e1[2] = v2[2];
-    e1[0] -= v1[0];
-    e1[1] -= v1[1];
-    e1[2] -= v1[2];
-
-    e2[0] = v0[0];
-    e2[1] = v0[1];
-    e2[2] = v0[2];
-    e2[0] -= v2[0];
-    e2[1] -= v2[1];
-    e2[2] -= v2[2];
-
-    alpha0 = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e1, e2);
-    alpha1 = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e2, e0);
-    alpha2 = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e0, e1);
-
-    // surf. area
-    A = double(vtkTriangle::TriangleArea(v0, v1, v2));
-    // UPDATE
-    dA[vert[0]] += A;
-    dA[vert[1]] += A;
-    dA[vert[2]] += A;
-    K[vert[0]] -= alpha1;
-    K[vert[1]] -= alpha2;
-    K[vert[2]] -= alpha0;
-  }
-
-  // put curvature in vtkArray
-  for (int v = 0; v < Nv; v++)
-  {
-    if (dA[v] > 0.0)
+  vtkIdType numFacets = facets->GetNumberOfCells();
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.SerialBuildLinks(Nv, numFacets, facets);
+
+  // The area and the three angles of each facet.
+  std::vector<double> facetData(4 * numFacets);
+  vtkSMPThreadLocalObject<vtkIdList> tlVert;
+  vtkSMPTools::For(0, numFacets, [&](vtkIdType beginFacet, vtkIdType endFacet) {
+    vtkIdList* vertIds = tlVert.Local();
+    double v0[3], v1[3], v2[3], e0[3], e1[3], e2[3];
+    vtkIdType f;
+    const vtkIdType* vert = nullptr;
+
+    for (vtkIdType facetId = beginFacet; facetId < endFacet; ++facetId)
     {
-      gaussCurvatureData[v] = 3.0 * K[v] / dA[v];
+      facets->GetCellAtId(facetId, f, vert, vertIds);
+      output->GetPoint(vert[0], v0);
+      output->GetPoint(vert[1], v1);
+      output->GetPoint(vert[2], v2);
+      // edges
+      e0[0] = v1[0];
+      e0[1] = v1[1];
+      e0[2] = v1[2];
+      e0[0] -= v0[0];
+      e0[1] -= v0[1];
+      e0[2] -= v0[2];
+
+      e1[0] = v2[0];
+      e1[1] = v2[1];
+      e1[2] = v2[2];
+      e1[0] -= v1[0];
+      e1[1] -= v1[1];
+      e1[2] -= v1[2];
+
+      e2[0] = v0[0];
+      e2[1] = v0[1];
+      e2[2] = v0[2];
+      e2[0] -= v2[0];
+      e2[1] -= v2[1];
+      e2[2] -= v2[2];
+
+      double* data = facetData.data() + 4 * facetId;
+      // surf. area
+      data[0] = double(vtkTriangle::TriangleArea(v0, v1, v2));
+      // alpha0, alpha1, alpha2
+      data[1] = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e1, e2);
+      data[2] = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e2, e0);
+      data[3] = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e0, e1);
     }
-  }
+  });
+
+  // Gather the areas and angles of the facets at each point, and put
+  // curvature in vtkArray. The angle of vertex i is alpha(i + 1) % 3.
+  vtkSMPThreadLocal<std::vector<vtkIdType>> tlFacets;
+  const double pi2 = 2.0 * vtkMath::Pi();
+  vtkSMPTools::For(0, Nv, [&](vtkIdType beginPt, vtkIdType endPt) {
+    vtkIdList* vertIds = tlVert.Local();
+    std::vector<vtkIdType>& pointFacets = tlFacets.Local();
+    vtkIdType npts;
+    const vtkIdType* vert = nullptr;
+
+    for (vtkIdType ptId = beginPt; ptId < endPt; ++ptId)
+    {
+      double K = pi2;
+      double dA = 0.0;
+      GetSortedCells(links, ptId, pointFacets);
+      for (vtkIdType facetId : pointFacets)
+      {
+        facets->GetCellAtId(facetId, npts, vert, vertIds);
+        const double* data = facetData.data() + 4 * facetId;
+        for (int i = 0; i < 3; ++i)
+        {
+          if (vert[i] == ptId)
+          {
+            dA += data[0];
+            K -= data[1 + (i + 1) % 3];
+          }
+        }
+      }
+      if (dA > 0.0)
+      {
+        gaussCurvatureData[ptId] = 3.0 * K / dA;
+      }
+    }
+  });
 }
 
 void vtkCurvatures::GetMaximumCurvature(vtkPolyData* input, vtkPolyData* output)
@@ -422,6 +520,227 @@ void vtkCurvatures::GetMinimumCurvature(vtkPolyData* input, vtkPolyData* output)
   }
 }
 
+//-------------------------------------------------------
+void vtkCurvatures::GetPrincipalCurvatures(vtkPolyData* output)
+{
+  vtkDebugMacro("Start vtkCurvatures::GetPrincipalCurvatures()");
+  this->GetGaussCurvature(output);
+  this->GetMeanCurvature(output);
+
+  vtkDoubleArray* gauss =
+    vtkDoubleArray::SafeDownCast(output->GetPointData()->GetArray("Gauss_Curvature"));
+  vtkDoubleArray* mean =
+    vtkDoubleArray::SafeDownCast(output->GetPointData()->GetArray("Mean_Curvature"));
+  if (!gauss || !mean)
+  {
+    return;
+  }
+
+  vtkNew<vtkTriangleFilter> triangulateFilter;
+  vtkPolyData* polyData = TriangulateStrips(output, triangulateFilter);
+  const vtkIdType numPts = polyData->GetNumberOfPoints();
+  const vtkIdType numCells = polyData->GetNumberOfCells();
+
+  const vtkNew<vtkDoubleArray> maximumCurvature;
+  maximumCurvature->SetName("Maximum_Curvature");
+  maximumCurvature->SetNumberOfTuples(numPts);
+  const vtkNew<vtkDoubleArray> minimumCurvature;
+  minimumCurvature->SetName("Minimum_Curvature");
+  minimumCurvature->SetNumberOfTuples(numPts);
+  const vtkNew<vtkDoubleArray> maximumDirection;
+  maximumDirection->SetName("Maximum_Curvature_Direction");
+  maximumDirection->SetNumberOfComponents(3);
+  maximumDirection->SetNumberOfTuples(numPts);
+  const vtkNew<vtkDoubleArray> minimumDirection;
+  minimumDirection->SetName("Minimum_Curvature_Direction");
+  minimumDirection->SetNumberOfComponents(3);
+  minimumDirection->SetNumberOfTuples(numPts);
+
+  // The principal curvatures follow from the Gauss and mean curvatures.
+  const double* gaussData = gauss->GetPointer(0);
+  const double* meanData = mean->GetPointer(0);
+  double* maximumData = maximumCurvature->GetPointer(0);
+  double* minimumData = minimumCurvature->GetPointer(0);
+  std::atomic<vtkIdType> numLargeErrors(0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType beginPt, vtkIdType endPt) {
+    for (vtkIdType ptId = beginPt; ptId < endPt; ++ptId)
+    {
+      const double h = meanData[ptId];
+      const double tmp = h * h - gaussData[ptId];
+      const double delta = tmp >= 0 ? sqrt(tmp) : 0.0;
+      maximumData[ptId] = h + delta;
+      minimumData[ptId] = h - delta;
+      if (tmp < -0.1)
+      {
+        ++numLargeErrors;
+      }
+    }
+  });
+  if (numLargeErrors > 0)
+  {
+    vtkWarningMacro(<< "The Gaussian or mean curvature at " << numLargeErrors
+                    << " points have a large computation error... The principal curvatures are "
+                       "likely off.");
+  }
+
+  // The area and the normal of each facet.
+  std::vector<double> facetData(4 * numCells);
+  vtkSMPThreadLocalObject<vtkIdList> tlCellPoints;
+  vtkSMPTools::For(0, numCells, [&](vtkIdType beginCell, vtkIdType endCell) {
+    vtkIdList* cellPoints = tlCellPoints.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double v0[3], v1[3], v2[3];
+    for (vtkIdType cellId = beginCell; cellId < endCell; ++cellId)
+    {
+      double* data = facetData.data() + 4 * cellId;
+      polyData->GetCellPoints(cellId, npts, pts, cellPoints);
+      if (npts < 3)
+      {
+        std::fill_n(data, 4, 0.0);
+        continue;
+      }
+      polyData->GetPoint(pts[0], v0);
+      polyData->GetPoint(pts[1], v1);
+      polyData->GetPoint(pts[2], v2);
+      data[0] = vtkTriangle::TriangleArea(v0, v1, v2);
+      vtkTriangle::ComputeNormal(v0, v1, v2, data + 1);
+    }
+  });
+
+  // The principal directions are the eigenvectors of the curvature tensor,
+  // fitted in the tangent plane of each point to the normal curvatures along
+  // its edges by weighted least squares. Each edge is weighted by the area of
+  // its facets.
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.BuildLinks(polyData);
+  vtkSMPThreadLocal<std::vector<vtkIdType>> tlCells;
+  vtkSMPThreadLocal<std::vector<std::pair<vtkIdType, double>>> tlEdges;
+  const double sign = this->InvertMeanCurvature ? -1.0 : 1.0;
+  double* maximumDirectionData = maximumDirection->GetPointer(0);
+  double* minimumDirectionData = minimumDirection->GetPointer(0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType beginPt, vtkIdType endPt) {
+    vtkIdList* cellPoints = tlCellPoints.Local();
+    std::vector<vtkIdType>& cells = tlCells.Local();
+    std::vector<std::pair<vtkIdType, double>>& edges = tlEdges.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double x[3], y[3], d[3], normal[3], e1[3], e2[3], a[3][3], rhs[3];
+    double* A[3] = { a[0], a[1], a[2] };
+    int index[3];
+
+    for (vtkIdType ptId = beginPt; ptId < endPt; ++ptId)
+    {
+      double* maxDirection = maximumDirectionData + 3 * ptId;
+      double* minDirection = minimumDirectionData + 3 * ptId;
+      std::fill_n(maxDirection, 3, 0.0);
+      std::fill_n(minDirection, 3, 0.0);
+
+      // the area weighted normal and the weighted edges of the point
+      GetSortedCells(links, ptId, cells);
+      edges.clear();
+      std::fill_n(normal, 3, 0.0);
+      for (vtkIdType cellId : cells)
+      {
+        const double* data = facetData.data() + 4 * cellId;
+        if (data[0] <= 0.0)
+        {
+          continue;
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+          normal[i] += data[0] * data[1 + i];
+        }
+        polyData->GetCellPoints(cellId, npts, pts, cellPoints);
+        for (vtkIdType v = 0; v < npts; ++v)
+        {
+          if (pts[v] != ptId)
+          {
+            continue;
+          }
+          for (vtkIdType neighbor : { pts[(v + 1) % npts], pts[(v + npts - 1) % npts] })
+          {
+            auto edge = std::find_if(edges.begin(), edges.end(),
+              [neighbor](const std::pair<vtkIdType, double>& e) { return e.first == neighbor; });
+            if (edge == edges.end())
+            {
+              edges.emplace_back(neighbor, data[0]);
+            }
+            else
+            {
+              edge->second += data[0];
+            }
+          }
+        }
+      }
+      if (edges.size() < 3 || vtkMath::Normalize(normal) == 0.0)
+      {
+        continue;
+      }
+
+      // Fit the tensor [[l, m], [m, n]] in the frame (e1, e2) of the tangent
+      // plane, such that the normal curvature along the unit tangent (u, v)
+      // is l u^2 + 2 m u v + n v^2.
+      vtkMath::Perpendiculars(normal, e1, e2, 0.0);
+      for (int i = 0; i < 3; ++i)
+      {
+        std::fill_n(a[i], 3, 0.0);
+      }
+      std::fill_n(rhs, 3, 0.0);
+      polyData->GetPoint(ptId, x);
+      for (const auto& edge : edges)
+      {
+        polyData->GetPoint(edge.first, y);
+        vtkMath::Subtract(x, y, d);
+        const double length2 = vtkMath::Dot(d, d);
+        const double u = vtkMath::Dot(d, e1);
+        const double v = vtkMath::Dot(d, e2);
+        const double tangentLength2 = u * u + v * v;
+        if (length2 == 0.0 || tangentLength2 == 0.0)
+        {
+          continue;
+        }
+        // the normal curvature along the edge, positive for a sphere with
+        // outward normals
+        const double kappa = sign * 2.0 * vtkMath::Dot(normal, d) / length2;
+        const double row[3] = { u * u / tangentLength2, 2.0 * u * v / tangentLength2,
+          v * v / tangentLength2 };
+        for (int i = 0; i < 3; ++i)
+        {
+          for (int j = 0; j < 3; ++j)
+          {
+            a[i][j] += edge.second * row[i] * row[j];
+          }
+          rhs[i] += edge.second * row[i] * kappa;
+        }
+      }
+      if (!vtkMath::LUFactorLinearSystem(A, index, 3))
+      {
+        continue;
+      }
+      vtkMath::LUSolveLinearSystem(A, index, rhs, 3);
+
+      // The eigenvector of the largest eigenvalue of the tensor is the
+      // direction of maximum curvature, the other one is orthogonal to it.
+      const double angle = 0.5 * atan2(2.0 * rhs[1], rhs[0] - rhs[2]);
+      const double c = cos(angle);
+      const double sn = sin(angle);
+      for (int i = 0; i < 3; ++i)
+      {
+        maxDirection[i] = c * e1[i] + sn * e2[i];
+        minDirection[i] = -sn * e1[i] + c * e2[i];
+      }
+    }
+  });
+
+  output->GetPointData()->AddArray(maximumCurvature);
+  output->GetPointData()->AddArray(minimumCurvature);
+  output->GetPointData()->AddArray(maximumDirection);
+  output->GetPointData()->AddArray(minimumDirection);
+
+  vtkDebugMacro("Set Values of Principal Curvatures: Done");
+}
+
 //-------------------------------------------------------
 int vtkCurvatures::RequestData(vtkInformation* vtkNotUsed(request),
   vtkInformationVector** inputVector, vtkInformationVector* outputVector)
@@ -449,7 +768,19 @@ int vtkCurvatures::RequestData(vtkInformation* vtkNotUsed(request),
   //    Set Curvatures as PointData Scalars                //
   //-------------------------------------------------------//
 
-  if (this->CurvatureType == VTK_CURVATURE_GAUSS)
+  if (this->ComputePrincipalDirections)
+  {
+    this->GetPrincipalCurvatures(output);
+    const char* names[4] = { "Gauss_Curvature", "Mean_Curvature", "Maximum_Curvature",
+      "Minimum_Curvature" };
+    if (this->CurvatureType < VTK_CURVATURE_GAUSS || this->CurvatureType > VTK_CURVATURE_MINIMUM)
+    {
+      vtkErrorMacro("Only Gauss, Mean, Max, and Min Curvature type available");
+      return 1;
+    }
+    output->GetPointData()->SetActiveScalars(names[this->CurvatureType]);
+  }
+  else if (this->CurvatureType == VTK_CURVATURE_GAUSS)
   {
     this->GetGaussCurvature(output);
   }
@@ -479,4 +810,5 @@ void vtkCurvatures::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CurvatureType: " << this->CurvatureType << "\n";
   os << indent << "InvertMeanCurvature: " << this->InvertMeanCurvature << "\n";
+  os << indent << "ComputePrincipalDirections: " << this->ComputePrincipalDirections << "\n";
 }
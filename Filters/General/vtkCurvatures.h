@@ -53,6 +53,18 @@
  *  can be set and the Curvature reported by the Mean calculation will
  * be inverted.
  *
+ * When ComputePrincipalDirections is on, the Gauss, mean, maximum and
+ * minimum curvatures are all computed in a single execution, together with
+ * the principal directions, stored as the vectors
+ * "Maximum_Curvature_Direction" and "Minimum_Curvature_Direction". The
+ * directions are the eigenvectors of the curvature tensor fitted at each
+ * point to the normal curvatures along its edges. The active scalars are
+ * the curvature selected by CurvatureType.
+ *
+ * The curvatures are computed concurrently with vtkSMPTools, using
+ * vtkStaticCellLinksTemplate to gather the contributions of the cells at
+ * each point.
+ *
  * For a little more information see
  * <a href="https://public.kitware.com/pipermail/vtkusers/2002-July/012198.html"
  * >Computing curvature of a surface</a>
@@ -113,6 +125,18 @@ public:
   vtkBooleanMacro(InvertMeanCurvature, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Set/Get the flag which computes all the curvatures at once, along with
+   * the principal directions stored as the 3-component arrays
+   * "Maximum_Curvature_Direction" and "Minimum_Curvature_Direction"
+   * (default false).
+   */
+  vtkSetMacro(ComputePrincipalDirections, bool);
+  vtkGetMacro(ComputePrincipalDirections, bool);
+  vtkBooleanMacro(ComputePrincipalDirections, bool);
+  ///@}
+
 protected:
   vtkCurvatures();
 
@@ -141,9 +165,15 @@ protected:
    */
   void GetMinimumCurvature(vtkPolyData* input, vtkPolyData* output);
 
+  /**
+   * Gauss, mean and principal curvatures, and principal directions
+   */
+  void GetPrincipalCurvatures(vtkPolyData* output);
+
   // Vars
   int CurvatureType;
   vtkTypeBool InvertMeanCurvature;
+  bool ComputePrincipalDirections;
 
 private:
   vtkCurvatures(const vtkCurvatures&) = delete;
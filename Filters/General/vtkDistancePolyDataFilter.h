@@ -27,6 +27,9 @@
  * computed by calling SignedDistanceOff(). The signed distance field
  * may be negated by calling NegateDistanceOn();
  *
+ * The distances at the points and at the cell centers are evaluated
+ * concurrently with vtkSMPTools.
+ *
  * This code was contributed in the VTK Journal paper:
  * "Boolean Operations on Surfaces in VTK Without External Libraries"
  * by Cory Quammen, Chris Weigle C., Russ Taylor
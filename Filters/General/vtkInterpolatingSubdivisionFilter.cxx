@@ -17,10 +17,17 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkEdgeTable.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+
+#include <vector>
 
 // Construct object with number of subdivisions set to 1.
 vtkInterpolatingSubdivisionFilter::vtkInterpolatingSubdivisionFilter() = default;
@@ -60,8 +67,7 @@ int vtkInterpolatingSubdivisionFilter::RequestData(
 
   for (level = 0; level < this->NumberOfSubdivisions; level++)
   {
-    // Generate topology for the input dataset
-    inputDS->BuildLinks();
+    this->UpdateProgress(static_cast<double>(level + 1) / this->NumberOfSubdivisions);
     numCells = inputDS->GetNumberOfCells();
 
     // Copy points from input. The new points will include the old points
@@ -186,53 +192,58 @@ void vtkInterpolatingSubdivisionFilter::GenerateSubdivisionCells(
   vtkPolyData* inputDS, vtkIntArray* edgeData, vtkCellArray* outputPolys, vtkCellData* outputCD)
 {
   vtkIdType numCells = inputDS->GetNumberOfCells();
-  vtkIdType cellId, newId;
-  int id;
-  vtkIdType npts;
-  const vtkIdType* pts;
-  double edgePts[3];
-  vtkIdType newCellPts[3];
   vtkCellData* inputCD = inputDS->GetCellData();
 
-  // Now create new cells from existing points and generated edge points
-  for (cellId = 0; cellId < numCells; cellId++)
+  // Each triangle is divided into four triangles.
+  std::vector<vtkIdType> triangles;
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
   {
-    if (inputDS->GetCellType(cellId) != VTK_TRIANGLE)
+    if (inputDS->GetCellType(cellId) == VTK_TRIANGLE)
     {
-      continue;
+      triangles.push_back(cellId);
     }
-    // get the original point ids and the ids stored as cell data
-    inputDS->GetCellPoints(cellId, npts, pts);
-    edgeData->GetTuple(cellId, edgePts);
-
-    id = 0;
-    newCellPts[id++] = pts[0];
-    newCellPts[id++] = (int)edgePts[1];
-    newCellPts[id] = (int)edgePts[0];
-    newId = outputPolys->InsertNextCell(3, newCellPts);
-    outputCD->CopyData(inputCD, cellId, newId);
-
-    id = 0;
-    newCellPts[id++] = (int)edgePts[1];
-    newCellPts[id++] = pts[1];
-    newCellPts[id] = (int)edgePts[2];
-    newId = outputPolys->InsertNextCell(3, newCellPts);
-    outputCD->CopyData(inputCD, cellId, newId);
-
-    id = 0;
-    newCellPts[id++] = (int)edgePts[2];
-    newCellPts[id++] = pts[2];
-    newCellPts[id] = (int)edgePts[0];
-    newId = outputPolys->InsertNextCell(3, newCellPts);
-    outputCD->CopyData(inputCD, cellId, newId);
-
-    id = 0;
-    newCellPts[id++] = (int)edgePts[1];
-    newCellPts[id++] = (int)edgePts[2];
-    newCellPts[id] = (int)edgePts[0];
-    newId = outputPolys->InsertNextCell(3, newCellPts);
-    outputCD->CopyData(inputCD, cellId, newId);
   }
+  const vtkIdType numNewCells = 4 * static_cast<vtkIdType>(triangles.size());
+
+  // Now create new cells from existing points and generated edge points
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numNewCells + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numNewCells);
+  vtkNew<vtkIdList> inCellIds, outCellIds;
+  inCellIds->SetNumberOfIds(numNewCells);
+  outCellIds->SetNumberOfIds(numNewCells);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(triangles.size()),
+    [&](vtkIdType triId, vtkIdType endTriId) {
+      vtkNew<vtkIdList> ptIds;
+      vtkIdType npts;
+      const vtkIdType* pts;
+      int edgePts[3];
+      for (; triId < endTriId; ++triId)
+      {
+        // get the original point ids and the ids stored as edge data
+        const vtkIdType cellId = triangles[triId];
+        inputDS->GetCellPoints(cellId, npts, pts, ptIds);
+        edgeData->GetTypedTuple(cellId, edgePts);
+
+        const vtkIdType newCellPts[12] = { pts[0], edgePts[1], edgePts[0], edgePts[1], pts[1],
+          edgePts[2], edgePts[2], pts[2], edgePts[0], edgePts[1], edgePts[2], edgePts[0] };
+        for (vtkIdType i = 0; i < 4; ++i)
+        {
+          const vtkIdType newId = 4 * triId + i;
+          offsets->SetValue(newId, 3 * newId);
+          for (vtkIdType j = 0; j < 3; ++j)
+          {
+            connectivity->SetValue(3 * newId + j, newCellPts[3 * i + j]);
+          }
+          inCellIds->SetId(newId, cellId);
+          outCellIds->SetId(newId, newId);
+        }
+      }
+    });
+  offsets->SetValue(numNewCells, 3 * numNewCells);
+  outputPolys->SetData(offsets, connectivity);
+  outputCD->CopyData(inputCD, inCellIds, outCellIds);
 }
 
 void vtkInterpolatingSubdivisionFilter::PrintSelf(ostream& os, vtkIndent indent)
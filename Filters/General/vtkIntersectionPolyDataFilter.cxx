@@ -32,6 +32,8 @@
 #include "vtkPoints.h"
 #include "vtkPolyDataNormals.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkSortDataArray.h"
 #include "vtkTransform.h"
@@ -40,8 +42,12 @@
 #include "vtkTriangleFilter.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <list>
 #include <map>
+#include <set>
+#include <utility>
+#include <vector>
 
 //------------------------------------------------------------------------------
 // Helper typedefs and data structures.
@@ -60,6 +66,182 @@ struct simPolygon
   int orientation;
 };
 
+// The intersection line of a triangle of each input.
+struct TriangleIntersection
+{
+  vtkIdType CellId0;
+  vtkIdType CellId1;
+  double Point0[3];
+  double Point1[3];
+  double SurfaceId[2];
+};
+
+typedef std::pair<vtkOBBNode*, vtkOBBNode*> NodePairType;
+
+// Pushes the pairs of children of two nodes, at least one of which is not a
+// leaf, on a stack in the same order as vtkOBBTree::IntersectWithOBBTree.
+void PushChildPairs(vtkOBBNode* node0, vtkOBBNode* node1, std::vector<NodePairType>& stack)
+{
+  if (node0->Kids == nullptr)
+  {
+    stack.emplace_back(node0, node1->Kids[0]);
+    stack.emplace_back(node0, node1->Kids[1]);
+  }
+  else if (node1->Kids == nullptr)
+  {
+    stack.emplace_back(node0->Kids[0], node1);
+    stack.emplace_back(node0->Kids[1], node1);
+  }
+  else
+  {
+    stack.emplace_back(node0->Kids[0], node1->Kids[0]);
+    stack.emplace_back(node0->Kids[1], node1->Kids[0]);
+    stack.emplace_back(node0->Kids[0], node1->Kids[1]);
+    stack.emplace_back(node0->Kids[1], node1->Kids[1]);
+  }
+}
+
+// Collects the pairs of intersecting leaf nodes below pairs of nodes of the
+// OBB trees of the inputs. The leaf pairs below a pair are stored in the
+// order vtkOBBTree::IntersectWithOBBTree visits them.
+struct NodePairWorker
+{
+  vtkOBBTree* OBBTree0;
+  const std::vector<NodePairType>& SubtreePairs;
+  std::vector<std::vector<NodePairType>>& LeafPairs;
+
+  NodePairWorker(vtkOBBTree* obbTree0, const std::vector<NodePairType>& subtreePairs,
+    std::vector<std::vector<NodePairType>>& leafPairs)
+    : OBBTree0(obbTree0)
+    , SubtreePairs(subtreePairs)
+    , LeafPairs(leafPairs)
+  {
+  }
+
+  void operator()(vtkIdType pairId, vtkIdType endPairId)
+  {
+    std::vector<NodePairType> stack;
+    for (; pairId < endPairId; ++pairId)
+    {
+      std::vector<NodePairType>& leafPairs = this->LeafPairs[pairId];
+      stack.push_back(this->SubtreePairs[pairId]);
+      while (!stack.empty())
+      {
+        NodePairType pair = stack.back();
+        stack.pop_back();
+        if (this->OBBTree0->DisjointOBBNodes(pair.first, pair.second, nullptr))
+        {
+          continue;
+        }
+        if (pair.first->Kids == nullptr && pair.second->Kids == nullptr)
+        {
+          leafPairs.push_back(pair);
+        }
+        else
+        {
+          PushChildPairs(pair.first, pair.second, stack);
+        }
+      }
+    }
+  }
+};
+
+// Intersects the triangles of pairs of intersecting leaf nodes of the OBB
+// trees of the inputs. The intersections of a pair are stored in the order
+// of the triangles in the nodes.
+struct TriangleIntersectionWorker
+{
+  vtkPolyData* Mesh0;
+  vtkPolyData* Mesh1;
+  vtkOBBTree* OBBTree1;
+  double Tolerance;
+  const std::vector<NodePairType>& NodePairs;
+  std::vector<std::vector<TriangleIntersection>>& Intersections;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds0;
+  vtkSMPThreadLocalObject<vtkIdList> PtIds1;
+
+  TriangleIntersectionWorker(vtkPolyData* mesh0, vtkPolyData* mesh1, vtkOBBTree* obbTree1,
+    double tolerance, const std::vector<NodePairType>& nodePairs,
+    std::vector<std::vector<TriangleIntersection>>& intersections)
+    : Mesh0(mesh0)
+    , Mesh1(mesh1)
+    , OBBTree1(obbTree1)
+    , Tolerance(tolerance)
+    , NodePairs(nodePairs)
+    , Intersections(intersections)
+  {
+  }
+
+  void operator()(vtkIdType pairId, vtkIdType endPairId)
+  {
+    vtkIdList* ptIds0 = this->PtIds0.Local();
+    vtkIdList* ptIds1 = this->PtIds1.Local();
+    vtkIdType npts0, npts1;
+    const vtkIdType *triPtIds0, *triPtIds1;
+    double triPts0[3][3], triPts1[3][3];
+
+    for (; pairId < endPairId; ++pairId)
+    {
+      vtkOBBNode* node0 = this->NodePairs[pairId].first;
+      vtkOBBNode* node1 = this->NodePairs[pairId].second;
+      std::vector<TriangleIntersection>& intersections = this->Intersections[pairId];
+
+      vtkIdType numCells0 = node0->Cells->GetNumberOfIds();
+      vtkIdType numCells1 = node1->Cells->GetNumberOfIds();
+      for (vtkIdType id0 = 0; id0 < numCells0; id0++)
+      {
+        vtkIdType cellId0 = node0->Cells->GetId(id0);
+
+        // Make sure the cell is a triangle
+        if (this->Mesh0->GetCellType(cellId0) != VTK_TRIANGLE)
+        {
+          continue;
+        }
+        this->Mesh0->GetCellPoints(cellId0, npts0, triPtIds0, ptIds0);
+        for (vtkIdType id = 0; id < npts0; id++)
+        {
+          this->Mesh0->GetPoint(triPtIds0[id], triPts0[id]);
+        }
+        if (!this->OBBTree1->TriangleIntersectsNode(
+              node1, triPts0[0], triPts0[1], triPts0[2], nullptr))
+        {
+          continue;
+        }
+
+        for (vtkIdType id1 = 0; id1 < numCells1; id1++)
+        {
+          vtkIdType cellId1 = node1->Cells->GetId(id1);
+          if (this->Mesh1->GetCellType(cellId1) != VTK_TRIANGLE)
+          {
+            continue;
+          }
+          this->Mesh1->GetCellPoints(cellId1, npts1, triPtIds1, ptIds1);
+          for (vtkIdType id = 0; id < npts1; id++)
+          {
+            this->Mesh1->GetPoint(triPtIds1[id], triPts1[id]);
+          }
+
+          // See if the two cells actually intersect.
+          TriangleIntersection intersection;
+          int coplanar = 0;
+          int intersects = vtkIntersectionPolyDataFilter::TriangleTriangleIntersection(triPts0[0],
+            triPts0[1], triPts0[2], triPts1[0], triPts1[1], triPts1[2], coplanar,
+            intersection.Point0, intersection.Point1, intersection.SurfaceId, this->Tolerance);
+
+          // Coplanar triangle intersection is not handled.
+          // This intersection will not be included in the output. TODO
+          if (intersects && !coplanar)
+          {
+            intersection.CellId0 = cellId0;
+            intersection.CellId1 = cellId1;
+            intersections.push_back(intersection);
+          }
+        }
+      }
+    }
+  }
+};
+
 }
 
 typedef std::multimap<vtkIdType, vtkIdType> IntersectionMapType;
@@ -84,14 +266,22 @@ public:
   Impl();
   virtual ~Impl();
 
-  // Finds all triangle triangle intersections between two input OOBTrees
-  static int FindTriangleIntersections(
-    vtkOBBNode* node0, vtkOBBNode* node1, vtkMatrix4x4* transform, void* arg);
+  // Collects the pairs of intersecting leaf nodes of the OBB trees of the
+  // inputs
+  void FindNodePairs(vtkOBBTree* obbTree0, vtkOBBTree* obbTree1);
 
-  // Runs the split mesh for the designated input surface
-  int SplitMesh(int inputIndex, vtkPolyData* output, vtkPolyData* intersectionLines);
+  // Finds all triangle triangle intersections between the collected leaf
+  // node pairs
+  void IntersectTriangles();
+
+  // Runs the split mesh for the designated input surface. The split lines
+  // are a copy of the intersection lines that is modified.
+  int SplitMesh(int inputIndex, vtkPolyData* output, vtkPolyData* splitLines);
 
 protected:
+  // Adds the line of a triangle triangle intersection
+  void AddIntersection(const TriangleIntersection& intersection);
+
   // Split cells into polygons created by intersection lines
   vtkCellArray* SplitCell(vtkPolyData* input, vtkIdType cellId, const vtkIdType* cellPts,
     IntersectionMapType* map, vtkPolyData* interLines, int inputIndex, int numCurrCells);
@@ -105,22 +295,23 @@ protected:
     int inputIndex, int interPtCount, int interPts[3], vtkPolyData* interLines, int numCurrCells);
 
   // Function inside SplitCell to get the smaller triangle loops
-  int GetLoops(vtkPolyData* pd, std::vector<simPolygon>* loops);
+  int GetLoops(int inputIndex, vtkPolyData* pd, std::vector<simPolygon>* loops);
 
   // Get individual polygon loop of splitting cell
-  int GetSingleLoop(vtkPolyData* pd, simPolygon* loop, vtkIdType nextCell,
+  int GetSingleLoop(int inputIndex, vtkPolyData* pd, simPolygon* loop, vtkIdType nextCell,
     std::vector<bool>& interPtBool, std::vector<bool>& lineBool);
 
   // Follow a loop orientation to iterate around a split polygon
-  int FollowLoopOrientation(vtkPolyData* pd, simPolygon* loop, vtkIdType* nextCell,
-    vtkIdType nextPt, vtkIdType prevPt, vtkIdList* pointCells);
+  int FollowLoopOrientation(int inputIndex, vtkPolyData* pd, simPolygon* loop,
+    vtkIdType* nextCell, vtkIdType nextPt, vtkIdType prevPt, vtkIdList* pointCells);
 
   // Set the loop orientation based on CW CCW geometric test
-  void SetLoopOrientation(vtkPolyData* pd, simPolygon* loop, vtkIdType* nextCell, vtkIdType nextPt,
-    vtkIdType prevPt, vtkIdList* pointCells);
+  void SetLoopOrientation(int inputIndex, vtkPolyData* pd, simPolygon* loop, vtkIdType* nextCell,
+    vtkIdType nextPt, vtkIdType prevPt, vtkIdList* pointCells);
 
   // Get the loop orientation is already given
-  int GetLoopOrientation(vtkPolyData* pd, vtkIdType cell, vtkIdType ptId1, vtkIdType ptId2);
+  int GetLoopOrientation(
+    int inputIndex, vtkPolyData* pd, vtkIdType cell, vtkIdType ptId1, vtkIdType ptId2);
 
   // Orient the triangle based on the transform for remeshing
   void Orient(
@@ -137,9 +328,15 @@ public:
   vtkPolyData* Mesh[2];
   vtkOBBTree* OBBTree1;
 
+  // Pairs of intersecting leaf nodes of the OBB trees.
+  std::vector<NodePairType> NodePairs;
+
   // Stores the intersection lines.
   vtkCellArray* IntersectionLines;
 
+  // The end points of the intersection lines, smallest id first.
+  std::set<std::pair<vtkIdType, vtkIdType>> LineSet;
+
   vtkIdTypeArray* SurfaceId;
   vtkIdTypeArray* NewCellIds[2];
 
@@ -170,9 +367,10 @@ public:
   PointEdgeMapType* PointEdgeMap[2];
 
   // vtkPolyData to hold current splitting cell. Used to double check area
-  // of small area cells
-  vtkPolyData* SplittingPD;
-  int TransformSign;
+  // of small area cells. One for each input, since they are split
+  // concurrently.
+  vtkPolyData* SplittingPD[2];
+  int TransformSign[2];
   double Tolerance;
   double RelativeSubtriangleArea;
 
@@ -198,10 +396,10 @@ vtkIntersectionPolyDataFilter::Impl::Impl()
     this->IntersectionMap[i] = new IntersectionMapType();
     this->IntersectionPtsMap[i] = new IntersectionMapType();
     this->PointEdgeMap[i] = new PointEdgeMapType();
+    this->SplittingPD[i] = vtkPolyData::New();
+    this->TransformSign[i] = 0;
   }
   this->PointMapper = new IntersectionMapType();
-  this->SplittingPD = vtkPolyData::New();
-  this->TransformSign = 0;
   this->Tolerance = 1e-6;
   this->RelativeSubtriangleArea = 1e-4;
 }
@@ -214,257 +412,261 @@ vtkIntersectionPolyDataFilter::Impl::~Impl()
     delete this->IntersectionMap[i];
     delete this->IntersectionPtsMap[i];
     delete this->PointEdgeMap[i];
+    this->SplittingPD[i]->Delete();
   }
   delete this->PointMapper;
-  this->SplittingPD->Delete();
 }
 
 //------------------------------------------------------------------------------
-int vtkIntersectionPolyDataFilter::Impl ::FindTriangleIntersections(
-  vtkOBBNode* node0, vtkOBBNode* node1, vtkMatrix4x4* transform, void* arg)
+void vtkIntersectionPolyDataFilter::Impl::FindNodePairs(vtkOBBTree* obbTree0, vtkOBBTree* obbTree1)
 {
-  vtkIntersectionPolyDataFilter::Impl* info =
-    reinterpret_cast<vtkIntersectionPolyDataFilter::Impl*>(arg);
-
-  // Set up local structures to hold Impl array information
-  vtkPolyData* mesh0 = info->Mesh[0];
-  vtkPolyData* mesh1 = info->Mesh[1];
-  vtkOBBTree* obbTree1 = info->OBBTree1;
-  vtkCellArray* intersectionLines = info->IntersectionLines;
-  vtkIdTypeArray* intersectionSurfaceId = info->SurfaceId;
-  vtkIdTypeArray* intersectionCellIds0 = info->CellIds[0];
-  vtkIdTypeArray* intersectionCellIds1 = info->CellIds[1];
-  vtkPointLocator* pointMerger = info->PointMerger;
-  double tolerance = info->Tolerance;
-
-  // The number of cells in OBBTree
-  int numCells0 = node0->Cells->GetNumberOfIds();
-
-  for (vtkIdType id0 = 0; id0 < numCells0; id0++)
-  {
-    vtkIdType cellId0 = node0->Cells->GetId(id0);
-    int type0 = mesh0->GetCellType(cellId0);
-
-    // Make sure the cell is a triangle
-    if (type0 == VTK_TRIANGLE)
-    {
-      vtkIdType npts0;
-      const vtkIdType* triPtIds0;
-      mesh0->GetCellPoints(cellId0, npts0, triPtIds0);
-      double triPts0[3][3];
-      for (vtkIdType id = 0; id < npts0; id++)
+  // Expand the top levels of both trees serially, keeping the pairs in the
+  // order of the traversal of vtkOBBTree::IntersectWithOBBTree, until there
+  // are enough pairs to traverse their subtrees concurrently. Leaf pairs
+  // found on the way stay in place and are collected by the worker.
+  const size_t minNumberOfSubtreePairs = 256;
+  std::vector<NodePairType> subtreePairs(
+    1, NodePairType(obbTree0->GetRoot(), obbTree1->GetRoot()));
+  std::vector<NodePairType> childPairs;
+  bool expanded = true;
+  while (expanded && subtreePairs.size() < minNumberOfSubtreePairs)
+  {
+    expanded = false;
+    std::vector<NodePairType> nextPairs;
+    for (const NodePairType& pair : subtreePairs)
+    {
+      if (obbTree0->DisjointOBBNodes(pair.first, pair.second, nullptr))
       {
-        mesh0->GetPoint(triPtIds0[id], triPts0[id]);
+        continue;
       }
-
-      if (obbTree1->TriangleIntersectsNode(node1, triPts0[0], triPts0[1], triPts0[2], transform))
+      if (pair.first->Kids == nullptr && pair.second->Kids == nullptr)
       {
-        int numCells1 = node1->Cells->GetNumberOfIds();
-        for (vtkIdType id1 = 0; id1 < numCells1; id1++)
-        {
-          vtkIdType cellId1 = node1->Cells->GetId(id1);
-          int type1 = mesh1->GetCellType(cellId1);
-          if (type1 == VTK_TRIANGLE)
-          {
-            // See if the two cells actually intersect. If they do,
-            // add an entry into the intersection maps and add an
-            // intersection line.
-            vtkIdType npts1;
-            const vtkIdType* triPtIds1;
-            mesh1->GetCellPoints(cellId1, npts1, triPtIds1);
-
-            double triPts1[3][3];
-            for (vtkIdType id = 0; id < npts1; id++)
-            {
-              mesh1->GetPoint(triPtIds1[id], triPts1[id]);
-            }
+        nextPairs.push_back(pair);
+        continue;
+      }
+      // Children are visited in the reverse order they are pushed.
+      childPairs.clear();
+      PushChildPairs(pair.first, pair.second, childPairs);
+      nextPairs.insert(nextPairs.end(), childPairs.rbegin(), childPairs.rend());
+      expanded = true;
+    }
+    subtreePairs.swap(nextPairs);
+  }
 
-            int coplanar = 0;
-            double outpt0[3], outpt1[3];
-            double surfaceid[2];
-            int intersects = vtkIntersectionPolyDataFilter::TriangleTriangleIntersection(triPts0[0],
-              triPts0[1], triPts0[2], triPts1[0], triPts1[1], triPts1[2], coplanar, outpt0, outpt1,
-              surfaceid, tolerance);
+  std::vector<std::vector<NodePairType>> leafPairs(subtreePairs.size());
+  NodePairWorker worker(obbTree0, subtreePairs, leafPairs);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(subtreePairs.size()), worker);
 
-            if (coplanar)
-            {
-              // Coplanar triangle intersection is not handled.
-              // This intersection will not be included in the output. TODO
-              // vtkDebugMacro(<<"Coplanar");
-              intersects = 0;
-              continue;
-            }
+  this->NodePairs.clear();
+  for (const auto& pairs : leafPairs)
+  {
+    this->NodePairs.insert(this->NodePairs.end(), pairs.begin(), pairs.end());
+  }
+}
 
-            // If actual intersection, add point and cell to edge, line,
-            // and surface maps!
-            if (intersects)
-            {
-              vtkIdType lineId = intersectionLines->GetNumberOfCells();
+//------------------------------------------------------------------------------
+void vtkIntersectionPolyDataFilter::Impl::IntersectTriangles()
+{
+  // Intersect the triangles of each pair of leaf nodes concurrently, then add
+  // the intersections in the order the pairs were visited so that the points
+  // and lines are numbered as if they were added during the traversal.
+  std::vector<std::vector<TriangleIntersection>> intersections(this->NodePairs.size());
+  TriangleIntersectionWorker worker(this->Mesh[0], this->Mesh[1], this->OBBTree1, this->Tolerance,
+    this->NodePairs, intersections);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(this->NodePairs.size()), worker);
 
-              vtkIdType ptId0, ptId1;
-              int unique[2];
-              unique[0] = pointMerger->InsertUniquePoint(outpt0, ptId0);
-              unique[1] = pointMerger->InsertUniquePoint(outpt1, ptId1);
+  for (const auto& pairIntersections : intersections)
+  {
+    for (const auto& intersection : pairIntersections)
+    {
+      this->AddIntersection(intersection);
+    }
+  }
+}
 
-              int addline = 1;
-              if (ptId0 == ptId1)
-              {
-                addline = 0;
-              }
+//------------------------------------------------------------------------------
+void vtkIntersectionPolyDataFilter::Impl::AddIntersection(const TriangleIntersection& intersection)
+{
+  // Set up local structures to hold Impl array information
+  vtkPolyData* mesh0 = this->Mesh[0];
+  vtkPolyData* mesh1 = this->Mesh[1];
+  vtkCellArray* intersectionLines = this->IntersectionLines;
+  vtkIdTypeArray* intersectionSurfaceId = this->SurfaceId;
+  vtkIdTypeArray* intersectionCellIds0 = this->CellIds[0];
+  vtkIdTypeArray* intersectionCellIds1 = this->CellIds[1];
+  vtkPointLocator* pointMerger = this->PointMerger;
+
+  vtkIdType cellId0 = intersection.CellId0;
+  vtkIdType cellId1 = intersection.CellId1;
+  double outpt0[3], outpt1[3];
+  for (int i = 0; i < 3; i++)
+  {
+    outpt0[i] = intersection.Point0[i];
+    outpt1[i] = intersection.Point1[i];
+  }
+  const double* surfaceid = intersection.SurfaceId;
 
-              if (ptId0 == ptId1 && surfaceid[0] != surfaceid[1])
-              {
-                intersectionSurfaceId->InsertValue(ptId0, 3);
-              }
-              else
-              {
-                if (unique[0])
-                {
-                  intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
-                }
-                else
-                {
-                  if (intersectionSurfaceId->GetValue(ptId0) != 3)
-                  {
-                    intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
-                  }
-                }
-                if (unique[1])
-                {
-                  intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
-                }
-                else
-                {
-                  if (intersectionSurfaceId->GetValue(ptId1) != 3)
-                  {
-                    intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
-                  }
-                }
-              }
+  vtkIdType npts0, npts1;
+  const vtkIdType *triPtIds0, *triPtIds1;
+  mesh0->GetCellPoints(cellId0, npts0, triPtIds0);
+  mesh1->GetCellPoints(cellId1, npts1, triPtIds1);
 
-              info->IntersectionPtsMap[0]->insert(std::make_pair(ptId0, cellId0));
-              info->IntersectionPtsMap[1]->insert(std::make_pair(ptId0, cellId1));
-              info->IntersectionPtsMap[0]->insert(std::make_pair(ptId1, cellId0));
-              info->IntersectionPtsMap[1]->insert(std::make_pair(ptId1, cellId1));
+  // Add point and cell to edge, line, and surface maps!
+  vtkIdType lineId = intersectionLines->GetNumberOfCells();
 
-              // Check to see if duplicate line. Line can only be a duplicate
-              // line if both points are not unique and they don't
-              // equal each other
-              if (!unique[0] && !unique[1] && ptId0 != ptId1)
-              {
-                vtkSmartPointer<vtkPolyData> lineTest = vtkSmartPointer<vtkPolyData>::New();
-                lineTest->SetPoints(pointMerger->GetPoints());
-                lineTest->SetLines(intersectionLines);
-                lineTest->BuildLinks();
-                int newLine = info->CheckLine(lineTest, ptId0, ptId1);
-                if (newLine == 0)
-                {
-                  addline = 0;
-                }
-              }
-              if (addline)
-              {
-                // If the line is new and does not consist of two identical
-                // points, add the line to the intersection and update
-                // mapping information
-                intersectionLines->InsertNextCell(2);
-                intersectionLines->InsertCellPoint(ptId0);
-                intersectionLines->InsertCellPoint(ptId1);
-
-                intersectionCellIds0->InsertNextValue(cellId0);
-                intersectionCellIds1->InsertNextValue(cellId1);
-
-                info->PointCellIds[0]->InsertValue(ptId0, cellId0);
-                info->PointCellIds[0]->InsertValue(ptId1, cellId0);
-                info->PointCellIds[1]->InsertValue(ptId0, cellId1);
-                info->PointCellIds[1]->InsertValue(ptId1, cellId1);
-
-                info->IntersectionMap[0]->insert(std::make_pair(cellId0, lineId));
-                info->IntersectionMap[1]->insert(std::make_pair(cellId1, lineId));
-
-                // Check which edges of cellId0 and cellId1 outpt0 and
-                // outpt1 are on, if any.
-                int isOnEdge = 0;
-                int m0p0 = 0, m0p1 = 0, m1p0 = 0, m1p1 = 0;
-                for (vtkIdType edgeId = 0; edgeId < 3; edgeId++)
-                {
-                  isOnEdge = info->AddToPointEdgeMap(
-                    0, ptId0, outpt0, mesh0, cellId0, edgeId, lineId, triPtIds0);
-                  if (isOnEdge != -1)
-                  {
-                    m0p0++;
-                  }
-                  isOnEdge = info->AddToPointEdgeMap(
-                    0, ptId1, outpt1, mesh0, cellId0, edgeId, lineId, triPtIds0);
-                  if (isOnEdge != -1)
-                  {
-                    m0p1++;
-                  }
-                  isOnEdge = info->AddToPointEdgeMap(
-                    1, ptId0, outpt0, mesh1, cellId1, edgeId, lineId, triPtIds1);
-                  if (isOnEdge != -1)
-                  {
-                    m1p0++;
-                  }
-                  isOnEdge = info->AddToPointEdgeMap(
-                    1, ptId1, outpt1, mesh1, cellId1, edgeId, lineId, triPtIds1);
-                  if (isOnEdge != -1)
-                  {
-                    m1p1++;
-                  }
-                }
-                // Special cases caught by tolerance and not from the Point
-                // Merger
-                if (m0p0 > 0 && m1p0 > 0)
-                {
-                  intersectionSurfaceId->InsertValue(ptId0, 3);
-                }
-                if (m0p1 > 0 && m1p1 > 0)
-                {
-                  intersectionSurfaceId->InsertValue(ptId1, 3);
-                }
-              }
-              // Add information about origin surface to std::maps for
-              // checks later
-              if (intersectionSurfaceId->GetValue(ptId0) == 1)
-              {
-                info->IntersectionPtsMap[0]->insert(std::make_pair(ptId0, cellId0));
-              }
-              else if (intersectionSurfaceId->GetValue(ptId0) == 2)
-              {
-                info->IntersectionPtsMap[1]->insert(std::make_pair(ptId0, cellId1));
-              }
-              else
-              {
-                info->IntersectionPtsMap[0]->insert(std::make_pair(ptId0, cellId0));
-                info->IntersectionPtsMap[1]->insert(std::make_pair(ptId0, cellId1));
-              }
-              if (intersectionSurfaceId->GetValue(ptId1) == 1)
-              {
-                info->IntersectionPtsMap[0]->insert(std::make_pair(ptId1, cellId0));
-              }
-              else if (intersectionSurfaceId->GetValue(ptId1) == 2)
-              {
-                info->IntersectionPtsMap[1]->insert(std::make_pair(ptId1, cellId1));
-              }
-              else
-              {
-                info->IntersectionPtsMap[0]->insert(std::make_pair(ptId1, cellId0));
-                info->IntersectionPtsMap[1]->insert(std::make_pair(ptId1, cellId1));
-              }
-            }
-          }
-        }
+  vtkIdType ptId0, ptId1;
+  int unique[2];
+  unique[0] = pointMerger->InsertUniquePoint(outpt0, ptId0);
+  unique[1] = pointMerger->InsertUniquePoint(outpt1, ptId1);
+
+  int addline = 1;
+  if (ptId0 == ptId1)
+  {
+    addline = 0;
+  }
+
+  if (ptId0 == ptId1 && surfaceid[0] != surfaceid[1])
+  {
+    intersectionSurfaceId->InsertValue(ptId0, 3);
+  }
+  else
+  {
+    if (unique[0])
+    {
+      intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
+    }
+    else
+    {
+      if (intersectionSurfaceId->GetValue(ptId0) != 3)
+      {
+        intersectionSurfaceId->InsertValue(ptId0, surfaceid[0]);
+      }
+    }
+    if (unique[1])
+    {
+      intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
+    }
+    else
+    {
+      if (intersectionSurfaceId->GetValue(ptId1) != 3)
+      {
+        intersectionSurfaceId->InsertValue(ptId1, surfaceid[1]);
       }
     }
   }
 
-  return 1;
+  this->IntersectionPtsMap[0]->insert(std::make_pair(ptId0, cellId0));
+  this->IntersectionPtsMap[1]->insert(std::make_pair(ptId0, cellId1));
+  this->IntersectionPtsMap[0]->insert(std::make_pair(ptId1, cellId0));
+  this->IntersectionPtsMap[1]->insert(std::make_pair(ptId1, cellId1));
+
+  // Check to see if duplicate line. Line can only be a duplicate
+  // line if both points are not unique and they don't
+  // equal each other
+  std::pair<vtkIdType, vtkIdType> line = std::minmax(ptId0, ptId1);
+  if (!unique[0] && !unique[1] && ptId0 != ptId1)
+  {
+    if (this->LineSet.find(line) != this->LineSet.end())
+    {
+      addline = 0;
+    }
+  }
+  if (addline)
+  {
+    // If the line is new and does not consist of two identical
+    // points, add the line to the intersection and update
+    // mapping information
+    intersectionLines->InsertNextCell(2);
+    intersectionLines->InsertCellPoint(ptId0);
+    intersectionLines->InsertCellPoint(ptId1);
+    this->LineSet.insert(line);
+
+    intersectionCellIds0->InsertNextValue(cellId0);
+    intersectionCellIds1->InsertNextValue(cellId1);
+
+    this->PointCellIds[0]->InsertValue(ptId0, cellId0);
+    this->PointCellIds[0]->InsertValue(ptId1, cellId0);
+    this->PointCellIds[1]->InsertValue(ptId0, cellId1);
+    this->PointCellIds[1]->InsertValue(ptId1, cellId1);
+
+    this->IntersectionMap[0]->insert(std::make_pair(cellId0, lineId));
+    this->IntersectionMap[1]->insert(std::make_pair(cellId1, lineId));
+
+    // Check which edges of cellId0 and cellId1 outpt0 and
+    // outpt1 are on, if any.
+    int isOnEdge = 0;
+    int m0p0 = 0, m0p1 = 0, m1p0 = 0, m1p1 = 0;
+    for (vtkIdType edgeId = 0; edgeId < 3; edgeId++)
+    {
+      isOnEdge =
+        this->AddToPointEdgeMap(0, ptId0, outpt0, mesh0, cellId0, edgeId, lineId, triPtIds0);
+      if (isOnEdge != -1)
+      {
+        m0p0++;
+      }
+      isOnEdge =
+        this->AddToPointEdgeMap(0, ptId1, outpt1, mesh0, cellId0, edgeId, lineId, triPtIds0);
+      if (isOnEdge != -1)
+      {
+        m0p1++;
+      }
+      isOnEdge =
+        this->AddToPointEdgeMap(1, ptId0, outpt0, mesh1, cellId1, edgeId, lineId, triPtIds1);
+      if (isOnEdge != -1)
+      {
+        m1p0++;
+      }
+      isOnEdge =
+        this->AddToPointEdgeMap(1, ptId1, outpt1, mesh1, cellId1, edgeId, lineId, triPtIds1);
+      if (isOnEdge != -1)
+      {
+        m1p1++;
+      }
+    }
+    // Special cases caught by tolerance and not from the Point
+    // Merger
+    if (m0p0 > 0 && m1p0 > 0)
+    {
+      intersectionSurfaceId->InsertValue(ptId0, 3);
+    }
+    if (m0p1 > 0 && m1p1 > 0)
+    {
+      intersectionSurfaceId->InsertValue(ptId1, 3);
+    }
+  }
+  // Add information about origin surface to std::maps for
+  // checks later
+  if (intersectionSurfaceId->GetValue(ptId0) == 1)
+  {
+    this->IntersectionPtsMap[0]->insert(std::make_pair(ptId0, cellId0));
+  }
+  else if (intersectionSurfaceId->GetValue(ptId0) == 2)
+  {
+    this->IntersectionPtsMap[1]->insert(std::make_pair(ptId0, cellId1));
+  }
+  else
+  {
+    this->IntersectionPtsMap[0]->insert(std::make_pair(ptId0, cellId0));
+    this->IntersectionPtsMap[1]->insert(std::make_pair(ptId0, cellId1));
+  }
+  if (intersectionSurfaceId->GetValue(ptId1) == 1)
+  {
+    this->IntersectionPtsMap[0]->insert(std::make_pair(ptId1, cellId0));
+  }
+  else if (intersectionSurfaceId->GetValue(ptId1) == 2)
+  {
+    this->IntersectionPtsMap[1]->insert(std::make_pair(ptId1, cellId1));
+  }
+  else
+  {
+    this->IntersectionPtsMap[0]->insert(std::make_pair(ptId1, cellId0));
+    this->IntersectionPtsMap[1]->insert(std::make_pair(ptId1, cellId1));
+  }
 }
 
 //------------------------------------------------------------------------------
 int vtkIntersectionPolyDataFilter::Impl ::SplitMesh(
-  int inputIndex, vtkPolyData* output, vtkPolyData* intersectionLines)
+  int inputIndex, vtkPolyData* output, vtkPolyData* splitLines)
 {
   vtkPolyData* input = this->Mesh[inputIndex];
   IntersectionMapType* intersectionMap = this->IntersectionMap[inputIndex];
@@ -486,10 +688,8 @@ int vtkIntersectionPolyDataFilter::Impl ::SplitMesh(
   // using a vtkPointLocator. However, some lines may have an endpoint
   // on a cell edge that has no neighbor. We need to duplicate a line
   // point in such a case and update the point ID in the line cell.
+  // splitLines is a copy of the intersection lines owned by this input.
   //
-  vtkSmartPointer<vtkPolyData> splitLines = vtkSmartPointer<vtkPolyData>::New();
-  splitLines->DeepCopy(intersectionLines);
-
   vtkPointData* inPD = input->GetPointData();
   vtkPointData* outPD = output->GetPointData();
   outPD->CopyAllocate(inPD, input->GetNumberOfPoints());
@@ -538,10 +738,35 @@ int vtkIntersectionPolyDataFilter::Impl ::SplitMesh(
     newPolys->AllocateEstimate(cells->GetNumberOfCells(), 3);
     output->SetPolys(newPolys);
 
+    // A cell is split if it is in the intersection map or if one of its
+    // edges may be split by an intersection line that splits a neighbor
+    // cell. Edge neighbors are symmetric, so mark the cells of the map and
+    // their edge neighbors instead of looking at the neighbors of every cell.
+    std::vector<bool> needsSplit(numCells, false);
+    vtkSmartPointer<vtkIdList> splitCellPts = vtkSmartPointer<vtkIdList>::New();
     vtkSmartPointer<vtkIdList> edgeNeighbors = vtkSmartPointer<vtkIdList>::New();
+    for (IntersectionMapIteratorType iter = intersectionMap->begin();
+         iter != intersectionMap->end(); iter = intersectionMap->upper_bound(iter->first))
+    {
+      vtkIdType splitCellId = iter->first;
+      needsSplit[splitCellId] = true;
+      input->GetCellPoints(splitCellId, splitCellPts);
+      vtkIdType nptsSplit = splitCellPts->GetNumberOfIds();
+      for (vtkIdType ptId = 0; ptId < nptsSplit; ptId++)
+      {
+        vtkIdType pt0Id = splitCellPts->GetId(ptId);
+        vtkIdType pt1Id = splitCellPts->GetId((ptId + 1) % nptsSplit);
+        edgeNeighbors->Reset();
+        input->GetCellEdgeNeighbors(splitCellId, pt0Id, pt1Id, edgeNeighbors);
+        for (vtkIdType nbr = 0; nbr < edgeNeighbors->GetNumberOfIds(); nbr++)
+        {
+          needsSplit[edgeNeighbors->GetId(nbr)] = true;
+        }
+      }
+    }
+
     vtkIdType nptsX = 0;
     const vtkIdType* pts = nullptr;
-    vtkSmartPointer<vtkIdList> cellsToCheck = vtkSmartPointer<vtkIdList>::New();
     for (cells->InitTraversal(); cells->GetNextCell(nptsX, pts); cellIdX++)
     {
       if (nptsX != 3)
@@ -551,36 +776,8 @@ int vtkIntersectionPolyDataFilter::Impl ::SplitMesh(
         continue;
       }
 
-      cellsToCheck->Reset();
-      cellsToCheck->Allocate(nptsX + 1);
-      cellsToCheck->InsertNextId(cellIdX);
-
-      // Collect the cells relevant for splitting this cell.  If the
-      // cell is in the intersection map, split. If not, one of its
-      // edges may be split by an intersection line that splits a
-      // neighbor cell. Mark the cell as needing a split if this is
-      // the case.
-      bool needsSplit = intersectionMap->find(cellIdX) != intersectionMap->end();
-      for (vtkIdType ptId = 0; ptId < nptsX; ptId++)
-      {
-        vtkIdType pt0Id = pts[ptId];
-        vtkIdType pt1Id = pts[(ptId + 1) % nptsX];
-        edgeNeighbors->Reset();
-        input->GetCellEdgeNeighbors(cellIdX, pt0Id, pt1Id, edgeNeighbors);
-        for (vtkIdType nbr = 0; nbr < edgeNeighbors->GetNumberOfIds(); nbr++)
-        {
-          vtkIdType nbrId = edgeNeighbors->GetId(nbr);
-          cellsToCheck->InsertNextId(nbrId);
-
-          if (intersectionMap->find(nbrId) != intersectionMap->end())
-          {
-            needsSplit = true;
-          }
-        } // for (vtkIdType nbr = 0; ...
-      }   // for (vtkIdType pt = 0; ...
-
       // Splitting occurs here
-      if (!needsSplit)
+      if (!needsSplit[cellIdX])
       {
         // Just insert the cell and copy the cell data
         newId = newPolys->InsertNextCell(3, pts);
@@ -974,7 +1171,7 @@ vtkCellArray* vtkIntersectionPolyDataFilter::Impl ::SplitCell(vtkPolyData* input
   // Set up a transform that will rotate the points to the
   // XY-plane (normal aligned with z-axis).
   vtkSmartPointer<vtkTransform> transform = vtkSmartPointer<vtkTransform>::New();
-  this->TransformSign = this->GetTransform(transform, points);
+  this->TransformSign[inputIndex] = this->GetTransform(transform, points);
 
   vtkCellArray* splitCells = vtkCellArray::New();
   vtkSmartPointer<vtkPolyData> interpd = vtkSmartPointer<vtkPolyData>::New();
@@ -985,7 +1182,7 @@ vtkCellArray* vtkIntersectionPolyDataFilter::Impl ::SplitCell(vtkPolyData* input
   vtkSmartPointer<vtkPolyData> fullpd = vtkSmartPointer<vtkPolyData>::New();
   fullpd->SetPoints(points);
   fullpd->SetLines(lines);
-  SplittingPD->DeepCopy(fullpd);
+  this->SplittingPD[inputIndex]->DeepCopy(fullpd);
 
   vtkSmartPointer<vtkTransformPolyDataFilter> transformer =
     vtkSmartPointer<vtkTransformPolyDataFilter>::New();
@@ -1001,7 +1198,7 @@ vtkCellArray* vtkIntersectionPolyDataFilter::Impl ::SplitCell(vtkPolyData* input
   {
     // Get polygon loops of intersected triangle
     std::vector<simPolygon> loops;
-    if (this->GetLoops(transformedpd, &loops) != 1)
+    if (this->GetLoops(inputIndex, transformedpd, &loops) != 1)
     {
       splitCells->Delete();
       splitCells = nullptr;
@@ -1328,7 +1525,8 @@ void vtkIntersectionPolyDataFilter::Impl::AddToNewCellMap(
   delete[] cellIds;
 }
 
-int vtkIntersectionPolyDataFilter::Impl ::GetLoops(vtkPolyData* pd, std::vector<simPolygon>* loops)
+int vtkIntersectionPolyDataFilter::Impl ::GetLoops(
+  int inputIndex, vtkPolyData* pd, std::vector<simPolygon>* loops)
 {
   vtkSmartPointer<vtkIdList> pointCells = vtkSmartPointer<vtkIdList>::New();
   vtkSmartPointer<vtkIdList> cellPoints = vtkSmartPointer<vtkIdList>::New();
@@ -1359,7 +1557,7 @@ int vtkIntersectionPolyDataFilter::Impl ::GetLoops(vtkPolyData* pd, std::vector<
       lineBool[nextCell] = true;
 
       // Get one loop for untouched point
-      if (this->GetSingleLoop(pd, &interloop, nextCell, ptBool, lineBool) != 1)
+      if (this->GetSingleLoop(inputIndex, pd, &interloop, nextCell, ptBool, lineBool) != 1)
       {
         return 0;
       }
@@ -1383,7 +1581,7 @@ int vtkIntersectionPolyDataFilter::Impl ::GetLoops(vtkPolyData* pd, std::vector<
       nextCell = lineId;
 
       // Get single loop if the line is still untouched
-      if (this->GetSingleLoop(pd, &interloop, nextCell, ptBool, lineBool) != 1)
+      if (this->GetSingleLoop(inputIndex, pd, &interloop, nextCell, ptBool, lineBool) != 1)
       {
         return 0;
       }
@@ -1397,8 +1595,8 @@ int vtkIntersectionPolyDataFilter::Impl ::GetLoops(vtkPolyData* pd, std::vector<
 
 //------------------------------------------------------------------------------
 
-int vtkIntersectionPolyDataFilter::Impl ::GetSingleLoop(vtkPolyData* pd, simPolygon* loop,
-  vtkIdType nextCell, std::vector<bool>& interPtBool, std::vector<bool>& lineBool)
+int vtkIntersectionPolyDataFilter::Impl ::GetSingleLoop(int inputIndex, vtkPolyData* pd,
+  simPolygon* loop, vtkIdType nextCell, std::vector<bool>& interPtBool, std::vector<bool>& lineBool)
 {
   int intertype = 0;
   vtkSmartPointer<vtkIdList> pointCells = vtkSmartPointer<vtkIdList>::New();
@@ -1440,14 +1638,15 @@ int vtkIntersectionPolyDataFilter::Impl ::GetSingleLoop(vtkPolyData* pd, simPoly
       // set the orientation of the loop (i.e. CW or CCW)
       if (intertype == 0)
       {
-        this->SetLoopOrientation(pd, loop, &nextCell, nextPt, prevPt, pointCells);
+        this->SetLoopOrientation(inputIndex, pd, loop, &nextCell, nextPt, prevPt, pointCells);
         intertype = 1;
       }
       // This is not the first intersection. Follow line that continues along
       // the set loop orientation
       else
       {
-        if (this->FollowLoopOrientation(pd, loop, &nextCell, nextPt, prevPt, pointCells) != 1)
+        if (this->FollowLoopOrientation(
+              inputIndex, pd, loop, &nextCell, nextPt, prevPt, pointCells) != 1)
         {
           return 0;
         }
@@ -1518,15 +1717,15 @@ int vtkIntersectionPolyDataFilter::Impl ::GetSingleLoop(vtkPolyData* pd, simPoly
       prevPt = cellPoints->GetId(0);
     }
 
-    loop->orientation = this->GetLoopOrientation(pd, nextCell, prevPt, nextPt);
+    loop->orientation = this->GetLoopOrientation(inputIndex, pd, nextCell, prevPt, nextPt);
   }
   return 1;
 }
 
 //------------------------------------------------------------------------------
 
-int vtkIntersectionPolyDataFilter::Impl ::FollowLoopOrientation(vtkPolyData* pd, simPolygon* loop,
-  vtkIdType* nextCell, vtkIdType nextPt, vtkIdType prevPt, vtkIdList* pointCells)
+int vtkIntersectionPolyDataFilter::Impl ::FollowLoopOrientation(int inputIndex, vtkPolyData* pd,
+  simPolygon* loop, vtkIdType* nextCell, vtkIdType nextPt, vtkIdType prevPt, vtkIdList* pointCells)
 {
   // Follow the orientation of this loop
   int foundcell = 0;
@@ -1538,7 +1737,7 @@ int vtkIntersectionPolyDataFilter::Impl ::FollowLoopOrientation(vtkPolyData* pd,
     if (*nextCell != cellId)
     {
       // Get orientation for newly selected line
-      int neworient = this->GetLoopOrientation(pd, cellId, prevPt, nextPt);
+      int neworient = this->GetLoopOrientation(inputIndex, pd, cellId, prevPt, nextPt);
 
       // If the orientation of the newly selected line is correct, check
       // the angle of this it will make with the previous line
@@ -1604,8 +1803,8 @@ int vtkIntersectionPolyDataFilter::Impl ::FollowLoopOrientation(vtkPolyData* pd,
 
 //------------------------------------------------------------------------------
 
-void vtkIntersectionPolyDataFilter::Impl ::SetLoopOrientation(vtkPolyData* pd, simPolygon* loop,
-  vtkIdType* nextCell, vtkIdType nextPt, vtkIdType prevPt, vtkIdList* pointCells)
+void vtkIntersectionPolyDataFilter::Impl ::SetLoopOrientation(int inputIndex, vtkPolyData* pd,
+  simPolygon* loop, vtkIdType* nextCell, vtkIdType nextPt, vtkIdType prevPt, vtkIdList* pointCells)
 {
   // Set the orientation of this loop!
   double mincell = 0;
@@ -1663,13 +1862,13 @@ void vtkIntersectionPolyDataFilter::Impl ::SetLoopOrientation(vtkPolyData* pd, s
   // Set the next line as the line that makes the minimum angle with the
   // previous cell and set the orientation of the loop
   *nextCell = mincell;
-  loop->orientation = this->GetLoopOrientation(pd, *nextCell, prevPt, nextPt);
+  loop->orientation = this->GetLoopOrientation(inputIndex, pd, *nextCell, prevPt, nextPt);
 }
 
 //------------------------------------------------------------------------------
 
 int vtkIntersectionPolyDataFilter::Impl::GetLoopOrientation(
-  vtkPolyData* pd, vtkIdType cell, vtkIdType ptId1, vtkIdType ptId2)
+  int inputIndex, vtkPolyData* pd, vtkIdType cell, vtkIdType ptId1, vtkIdType ptId2)
 {
   // Calculate the actual orientation of this loop, by calculating the signed
   // area of the triangle made by the three points
@@ -1709,9 +1908,9 @@ int vtkIntersectionPolyDataFilter::Impl::GetLoopOrientation(
     vtkSmartPointer<vtkPoints> testPoints = vtkSmartPointer<vtkPoints>::New();
     vtkSmartPointer<vtkPolyData> testPD = vtkSmartPointer<vtkPolyData>::New();
     vtkSmartPointer<vtkCellArray> testCells = vtkSmartPointer<vtkCellArray>::New();
-    testPoints->InsertNextPoint(this->SplittingPD->GetPoint(ptId1));
-    testPoints->InsertNextPoint(this->SplittingPD->GetPoint(ptId2));
-    testPoints->InsertNextPoint(this->SplittingPD->GetPoint(ptId3));
+    testPoints->InsertNextPoint(this->SplittingPD[inputIndex]->GetPoint(ptId1));
+    testPoints->InsertNextPoint(this->SplittingPD[inputIndex]->GetPoint(ptId2));
+    testPoints->InsertNextPoint(this->SplittingPD[inputIndex]->GetPoint(ptId3));
     for (int i = 0; i < 3; i++)
     {
       testCells->InsertNextCell(2);
@@ -1724,13 +1923,13 @@ int vtkIntersectionPolyDataFilter::Impl::GetLoopOrientation(
 
     vtkSmartPointer<vtkTransform> newTransform = vtkSmartPointer<vtkTransform>::New();
     int sign = this->GetTransform(newTransform, testPoints);
-    if (sign != this->TransformSign)
+    if (sign != this->TransformSign[inputIndex])
     {
-      testPoints->SetPoint(0, this->SplittingPD->GetPoint(ptId2));
-      testPoints->SetPoint(1, this->SplittingPD->GetPoint(ptId1));
+      testPoints->SetPoint(0, this->SplittingPD[inputIndex]->GetPoint(ptId2));
+      testPoints->SetPoint(1, this->SplittingPD[inputIndex]->GetPoint(ptId1));
       this->GetTransform(newTransform, testPoints);
-      testPoints->SetPoint(0, this->SplittingPD->GetPoint(ptId1));
-      testPoints->SetPoint(1, this->SplittingPD->GetPoint(ptId2));
+      testPoints->SetPoint(0, this->SplittingPD[inputIndex]->GetPoint(ptId1));
+      testPoints->SetPoint(1, this->SplittingPD[inputIndex]->GetPoint(ptId2));
     }
 
     vtkSmartPointer<vtkTransformPolyDataFilter> newTransformer =
@@ -2364,8 +2563,15 @@ int vtkIntersectionPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(reques
   impl->PointMerger = pointMerger;
 
   // This performs the triangle intersection search
-  obbTree0->IntersectWithOBBTree(
-    obbTree1, nullptr, vtkIntersectionPolyDataFilter::Impl::FindTriangleIntersections, impl);
+  for (vtkPolyData* mesh : { mesh0.GetPointer(), mesh1.GetPointer() })
+  {
+    if (mesh->NeedToBuildCells())
+    {
+      mesh->BuildCells();
+    }
+  }
+  impl->FindNodePairs(obbTree0, obbTree1);
+  impl->IntersectTriangles();
 
   int rawLines = outputIntersection->GetNumberOfLines();
 
@@ -2420,84 +2626,73 @@ int vtkIntersectionPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(reques
 
   impl->BoundaryPoints[0] = vtkIntArray::New();
   impl->BoundaryPoints[1] = vtkIntArray::New();
-  // Split the first output if so desired, needed if performing boolean op
-  if (this->SplitFirstOutput)
-  {
-    mesh0->BuildLinks();
-    if (impl->SplitMesh(0, outputPolyData0, outputIntersection) != 1)
-    {
-      this->Status = 0;
-      this->NumberOfIntersectionPoints = 0;
-      this->NumberOfIntersectionLines = 0;
-      impl->NewCellIds[0]->Delete();
-      impl->NewCellIds[1]->Delete();
-      impl->BoundaryPoints[0]->Delete();
-      impl->BoundaryPoints[1]->Delete();
-      impl->PointCellIds[0]->Delete();
-      impl->PointCellIds[1]->Delete();
-      impl->SurfaceId->Delete();
-
-      delete impl;
-      return 0;
-    }
 
-    if (this->ComputeIntersectionPointArray)
+  // Split the outputs if so desired, needed if performing boolean op. The
+  // two inputs are split concurrently, each from its own copy of the
+  // intersection lines.
+  vtkPolyData* meshes[2] = { mesh0, mesh1 };
+  vtkPolyData* outputs[2] = { outputPolyData0, outputPolyData1 };
+  const bool split[2] = { this->SplitFirstOutput != 0, this->SplitSecondOutput != 0 };
+  vtkSmartPointer<vtkPolyData> splitLines[2];
+  int splitStatus[2] = { 1, 1 };
+  for (int i = 0; i < 2; i++)
+  {
+    if (split[i])
     {
-      impl->BoundaryPoints[0]->SetName("BoundaryPoints");
-      outputPolyData0->GetPointData()->AddArray(impl->BoundaryPoints[0]);
-      outputPolyData0->GetPointData()->SetActiveScalars("BoundaryPoints");
+      splitLines[i] = vtkSmartPointer<vtkPolyData>::New();
+      splitLines[i]->DeepCopy(outputIntersection);
     }
-    if (this->CheckMesh)
+  }
+  vtkSMPTools::For(0, 2, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; i++)
     {
-      double dummy[2];
-      CleanAndCheckSurface(outputPolyData0, dummy, this->Tolerance);
+      if (split[i])
+      {
+        meshes[i]->BuildLinks();
+        splitStatus[i] = impl->SplitMesh(static_cast<int>(i), outputs[i], splitLines[i]);
+        if (splitStatus[i] != 1)
+        {
+          continue;
+        }
+        if (this->ComputeIntersectionPointArray)
+        {
+          impl->BoundaryPoints[i]->SetName("BoundaryPoints");
+          outputs[i]->GetPointData()->AddArray(impl->BoundaryPoints[i]);
+          outputs[i]->GetPointData()->SetActiveScalars("BoundaryPoints");
+        }
+        if (this->CheckMesh)
+        {
+          double dummy[2];
+          CleanAndCheckSurface(outputs[i], dummy, this->Tolerance);
+        }
+        outputs[i]->BuildLinks();
+      }
     }
+  });
 
-    outputPolyData0->BuildLinks();
-  }
-  else
+  if (splitStatus[0] != 1 || splitStatus[1] != 1)
   {
-    outputPolyData0->ShallowCopy(mesh0);
+    this->Status = 0;
+    this->NumberOfIntersectionPoints = 0;
+    this->NumberOfIntersectionLines = 0;
+    impl->NewCellIds[0]->Delete();
+    impl->NewCellIds[1]->Delete();
+    impl->BoundaryPoints[0]->Delete();
+    impl->BoundaryPoints[1]->Delete();
+    impl->PointCellIds[0]->Delete();
+    impl->PointCellIds[1]->Delete();
+    impl->SurfaceId->Delete();
+
+    delete impl;
+    return 0;
   }
 
-  // Split the second output if desired
-  if (this->SplitSecondOutput)
+  for (int i = 0; i < 2; i++)
   {
-    mesh1->BuildLinks();
-    if (impl->SplitMesh(1, outputPolyData1, outputIntersection) != 1)
+    if (!split[i])
     {
-      this->Status = 0;
-      this->NumberOfIntersectionPoints = 0;
-      this->NumberOfIntersectionLines = 0;
-      impl->NewCellIds[0]->Delete();
-      impl->NewCellIds[1]->Delete();
-      impl->BoundaryPoints[0]->Delete();
-      impl->BoundaryPoints[1]->Delete();
-      impl->PointCellIds[0]->Delete();
-      impl->PointCellIds[1]->Delete();
-      impl->SurfaceId->Delete();
-
-      delete impl;
-      return 0;
+      outputs[i]->ShallowCopy(meshes[i]);
     }
-
-    if (this->ComputeIntersectionPointArray)
-    {
-      impl->BoundaryPoints[1]->SetName("BoundaryPoints");
-      outputPolyData1->GetPointData()->AddArray(impl->BoundaryPoints[1]);
-      outputPolyData1->GetPointData()->SetActiveScalars("BoundaryPoints");
-    }
-    if (this->CheckMesh)
-    {
-      double dummy[2];
-      CleanAndCheckSurface(outputPolyData1, dummy, this->Tolerance);
-    }
-
-    outputPolyData1->BuildLinks();
-  }
-  else
-  {
-    outputPolyData1->ShallowCopy(mesh1);
   }
 
   impl->NewCellIds[0]->SetName("NewCell0ID");
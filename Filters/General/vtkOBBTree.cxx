@@ -16,15 +16,21 @@
 
 #include "vtkCellArray.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkLine.h"
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
-#include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <vector>
 
 //------------------------------------------------------------------------------
@@ -53,6 +59,106 @@ vtkStandardNewMacro(vtkOBBTree);
     }                                                                                              \
   } while (false)
 
+//------------------------------------------------------------------------------
+// Builds the nodes of a vtkOBBTree. The points of the cells of a node are
+// gathered once each by marking them with the node count, so a builder is
+// used by one thread at a time. The nodes at SubtreeLevel are not built but
+// collected in Subtrees, so that they can be built concurrently.
+struct vtkOBBTreeBuilder
+{
+  struct Subtree
+  {
+    vtkIdList* Cells;
+    vtkOBBNode* Node;
+    int Level;
+  };
+
+  vtkOBBTree* Tree;
+  int* InsertedPoints;
+  vtkPoints* PointsList;
+  int OBBCount;
+  int Level;
+  int SubtreeLevel;
+  std::vector<Subtree> Subtrees;
+  vtkNew<vtkIdList> CellPts;
+
+  vtkOBBTreeBuilder(vtkOBBTree* tree, int* insertedPoints, vtkPoints* pointsList)
+    : Tree(tree)
+    , InsertedPoints(insertedPoints)
+    , PointsList(pointsList)
+    , OBBCount(0)
+    , Level(0)
+    , SubtreeLevel(VTK_INT_MAX)
+  {
+  }
+
+  void ComputeOBB(vtkIdList* cells, double corner[3], double max[3], double mid[3], double min[3],
+    double size[3]);
+  void BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level);
+};
+
+namespace
+{
+// Builds subtrees of a vtkOBBTree concurrently, each thread with its own
+// point marks and point list.
+struct vtkOBBTreeSubtreeBuilder
+{
+  vtkOBBTree* Tree;
+  std::vector<vtkOBBTreeBuilder::Subtree>& Subtrees;
+  vtkIdType NumberOfPoints;
+  vtkSMPThreadLocal<std::vector<int>> InsertedPoints;
+  vtkSMPThreadLocalObject<vtkPoints> PointsList;
+  vtkSMPThreadLocal<int> OBBCount;
+  vtkSMPThreadLocal<int> Level;
+  int TotalOBBCount;
+  int MaxLevel;
+
+  vtkOBBTreeSubtreeBuilder(
+    vtkOBBTree* tree, std::vector<vtkOBBTreeBuilder::Subtree>& subtrees, vtkIdType numPts)
+    : Tree(tree)
+    , Subtrees(subtrees)
+    , NumberOfPoints(numPts)
+    , TotalOBBCount(0)
+    , MaxLevel(0)
+  {
+  }
+
+  void Initialize()
+  {
+    this->InsertedPoints.Local().assign(this->NumberOfPoints, 0);
+    this->OBBCount.Local() = 0;
+    this->Level.Local() = 0;
+  }
+
+  void operator()(vtkIdType subtreeId, vtkIdType endSubtreeId)
+  {
+    vtkOBBTreeBuilder builder(
+      this->Tree, this->InsertedPoints.Local().data(), this->PointsList.Local());
+    builder.OBBCount = this->OBBCount.Local();
+    builder.Level = this->Level.Local();
+    for (; subtreeId < endSubtreeId; ++subtreeId)
+    {
+      const vtkOBBTreeBuilder::Subtree& subtree = this->Subtrees[subtreeId];
+      builder.BuildTree(subtree.Cells, subtree.Node, subtree.Level);
+    }
+    this->OBBCount.Local() = builder.OBBCount;
+    this->Level.Local() = builder.Level;
+  }
+
+  void Reduce()
+  {
+    for (int count : this->OBBCount)
+    {
+      this->TotalOBBCount += count;
+    }
+    for (int level : this->Level)
+    {
+      this->MaxLevel = std::max(this->MaxLevel, level);
+    }
+  }
+};
+}
+
 //------------------------------------------------------------------------------
 vtkOBBNode::vtkOBBNode()
 {
@@ -289,9 +395,10 @@ void vtkOBBTree::ComputeOBB(
 // Compute an OBB from the list of cells given. Return the corner point
 // and the three axes defining the orientation of the OBB. Also return
 // a sorted list of relative "sizes" of axes for comparison purposes.
-void vtkOBBTree::ComputeOBB(
+void vtkOBBTreeBuilder::ComputeOBB(
   vtkIdList* cells, double corner[3], double max[3], double mid[3], double min[3], double size[3])
 {
+  vtkDataSet* dataSet = this->Tree->DataSet;
   vtkIdType numCells, i, j, cellId, ptId, pId, qId, rId;
   int k, type;
   vtkIdType numPts = 0;
@@ -321,19 +428,8 @@ void vtkOBBTree::ComputeOBB(
   for (i = 0; i < numCells; i++)
   {
     cellId = cells->GetId(i);
-    type = this->DataSet->GetCellType(cellId);
-    switch (this->DataSet->GetDataObjectType())
-    {
-      case VTK_POLY_DATA:
-        ((vtkPolyData*)this->DataSet)->GetCellPoints(cellId, numPts, ptIds);
-        break;
-      case VTK_UNSTRUCTURED_GRID:
-        ((vtkUnstructuredGrid*)this->DataSet)->GetCellPoints(cellId, numPts, ptIds);
-        break;
-      default:
-        vtkErrorMacro(<< "DataSet " << this->DataSet->GetClassName() << " not supported.");
-        break;
-    }
+    type = dataSet->GetCellType(cellId);
+    dataSet->GetCellPoints(cellId, numPts, ptIds, this->CellPts);
     for (j = 0; j < numPts - 2; j++)
     {
       vtkCELLTRIANGLES(ptIds, type, j, pId, qId, rId);
@@ -341,9 +437,9 @@ void vtkOBBTree::ComputeOBB(
       {
         continue;
       }
-      this->DataSet->GetPoint(pId, p);
-      this->DataSet->GetPoint(qId, q);
-      this->DataSet->GetPoint(rId, r);
+      dataSet->GetPoint(pId, p);
+      dataSet->GetPoint(qId, q);
+      dataSet->GetPoint(rId, r);
       // p, q, and r are the oriented triangle points.
       // Compute the components of the moment of inertia tensor.
       for (k = 0; k < 3; k++)
@@ -381,7 +477,8 @@ void vtkOBBTree::ComputeOBB(
       if (this->InsertedPoints[ptIds[j]] != this->OBBCount)
       {
         this->InsertedPoints[ptIds[j]] = this->OBBCount;
-        this->PointsList->InsertNextPoint(this->DataSet->GetPoint(ptIds[j]));
+        dataSet->GetPoint(ptIds[j], p);
+        this->PointsList->InsertNextPoint(p);
       }
     } // for all points of this cell
   }   // end foreach cell
@@ -464,6 +561,19 @@ void vtkOBBTree::ComputeOBB(
   }
 }
 
+//------------------------------------------------------------------------------
+// Compute an OBB from the list of cells given. Return the corner point
+// and the three axes defining the orientation of the OBB. Also return
+// a sorted list of relative "sizes" of axes for comparison purposes.
+void vtkOBBTree::ComputeOBB(
+  vtkIdList* cells, double corner[3], double max[3], double mid[3], double min[3], double size[3])
+{
+  vtkOBBTreeBuilder builder(this, this->InsertedPoints, this->PointsList);
+  builder.OBBCount = this->OBBCount;
+  builder.ComputeOBB(cells, corner, max, mid, min, size);
+  this->OBBCount = builder.OBBCount;
+}
+
 //------------------------------------------------------------------------------
 // Efficient check for whether a line p1,p2 intersects with triangle
 // pt1,pt2,pt3 to within specified tolerance.  This is included here
@@ -1111,9 +1221,29 @@ void vtkOBBTree::BuildLocatorInternal()
 
   this->FreeSearchStructure();
 
+  // Build the top levels of the tree, then the subtrees below them
+  // concurrently. There are a few subtrees per thread to balance the work.
   this->Tree = new vtkOBBNode;
-  this->Level = 0;
-  this->BuildTree(cellList, this->Tree, 0);
+  vtkOBBTreeBuilder builder(this, this->InsertedPoints, this->PointsList);
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  if (numThreads > 1)
+  {
+    builder.SubtreeLevel = 0;
+    while ((1 << builder.SubtreeLevel) < 4 * numThreads)
+    {
+      builder.SubtreeLevel++;
+    }
+  }
+  builder.BuildTree(cellList, this->Tree, 0);
+  this->Level = builder.Level;
+  this->OBBCount = builder.OBBCount;
+  if (!builder.Subtrees.empty())
+  {
+    vtkOBBTreeSubtreeBuilder subtreeBuilder(this, builder.Subtrees, numPts);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(builder.Subtrees.size()), 1, subtreeBuilder);
+    this->Level = std::max(this->Level, subtreeBuilder.MaxLevel);
+    this->OBBCount += subtreeBuilder.TotalOBBCount;
+  }
 
   vtkDebugMacro(<< "# Cells: " << numCells << ", Deepest tree level: " << this->Level
                 << ", Created: " << this->OBBCount << " OBB nodes");
@@ -1139,12 +1269,13 @@ void vtkOBBTree::BuildLocatorInternal()
 //------------------------------------------------------------------------------
 // NOTE: for better memory usage this recursive method
 // frees its first argument
-void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
+void vtkOBBTreeBuilder::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
 {
   vtkIdType i, j, numCells = cells->GetNumberOfIds();
   vtkIdType cellId;
   vtkIdType ptId;
-  vtkIdList* cellPts = vtkIdList::New();
+  vtkDataSet* dataSet = this->Tree->DataSet;
+  vtkIdList* cellPts = this->CellPts;
   double size[3];
 
   if (level > this->Level)
@@ -1160,7 +1291,7 @@ void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
   // Check whether to continue recursing; if so, create two children and
   // assign cells to appropriate child.
   //
-  if (level < this->MaxLevel && numCells > this->NumberOfCellsPerNode)
+  if (level < this->Tree->MaxLevel && numCells > this->Tree->NumberOfCellsPerNode)
   {
     vtkIdList* LHlist = vtkIdList::New();
     LHlist->Allocate(cells->GetNumberOfIds() / 2);
@@ -1193,13 +1324,13 @@ void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
       for (i = 0; i < numCells; i++)
       {
         cellId = cells->GetId(i);
-        this->DataSet->GetCellPoints(cellId, cellPts);
+        dataSet->GetCellPoints(cellId, cellPts);
         c[0] = c[1] = c[2] = 0.0;
         numPts = cellPts->GetNumberOfIds();
         for (negative = positive = j = 0; j < numPts; j++)
         {
           ptId = cellPts->GetId(j);
-          this->DataSet->GetPoint(ptId, x);
+          dataSet->GetPoint(ptId, x);
           val = n[0] * (x[0] - p[0]) + n[1] * (x[1] - p[1]) + n[2] * (x[2] - p[2]);
           c[0] += x[0];
           c[1] += x[1];
@@ -1281,8 +1412,16 @@ void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
 
       cells->Delete();
       cells = nullptr; // don't need to keep anymore
-      this->BuildTree(LHlist, LHnode, level + 1);
-      this->BuildTree(RHlist, RHnode, level + 1);
+      if (level + 1 < this->SubtreeLevel)
+      {
+        this->BuildTree(LHlist, LHnode, level + 1);
+        this->BuildTree(RHlist, RHnode, level + 1);
+      }
+      else
+      {
+        this->Subtrees.push_back({ LHlist, LHnode, level + 1 });
+        this->Subtrees.push_back({ RHlist, RHnode, level + 1 });
+      }
     }
     else
     {
@@ -1292,7 +1431,7 @@ void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
     }
   } // if should build tree
 
-  if (cells && this->RetainCellLists)
+  if (cells && this->Tree->RetainCellLists)
   {
     cells->Squeeze();
     OBBptr->Cells = cells;
@@ -1301,7 +1440,17 @@ void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
   {
     cells->Delete();
   }
-  cellPts->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
+{
+  vtkOBBTreeBuilder builder(this, this->InsertedPoints, this->PointsList);
+  builder.OBBCount = this->OBBCount;
+  builder.Level = this->Level;
+  builder.BuildTree(cells, OBBptr, level);
+  this->OBBCount = builder.OBBCount;
+  this->Level = builder.Level;
 }
 
 //------------------------------------------------------------------------------
@@ -70,6 +70,7 @@
 #include "vtkFiltersGeneralModule.h" // For export macro
 
 class vtkMatrix4x4;
+struct vtkOBBTreeBuilder;
 
 // Special class defines node for the OBB tree
 class VTKFILTERSGENERAL_EXPORT vtkOBBNode
@@ -182,6 +183,13 @@ public:
     int (*function)(vtkOBBNode* nodeA, vtkOBBNode* nodeB, vtkMatrix4x4* Xform, void* arg),
     void* data_arg);
 
+  /**
+   * Return the root node of the tree, or nullptr if the tree has not been
+   * built or is empty. Useful to traverse the tree outside of
+   * IntersectWithOBBTree().
+   */
+  vtkOBBNode* GetRoot() { return this->Tree; }
+
   ///@{
   /**
    * Satisfy locator's abstract interface, see vtkLocator.
@@ -225,6 +233,8 @@ protected:
     vtkOBBNode* OBBptr, int level, int repLevel, vtkPoints* pts, vtkCellArray* polys);
 
 private:
+  friend struct vtkOBBTreeBuilder;
+
   vtkOBBTree(const vtkOBBTree&) = delete;
   void operator=(const vtkOBBTree&) = delete;
 };
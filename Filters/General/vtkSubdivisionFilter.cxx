@@ -16,19 +16,26 @@
 
 #include "vtkCell.h"
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
 #include "vtkEdgeTable.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticEdgeLocatorTemplate.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
 
 #include <map>
 #include <sstream>
+#include <vector>
 
 // Construct object with number of subdivisions set to 1, check for
 // triangles set to 1
@@ -94,6 +101,145 @@ int vtkSubdivisionFilter::RequestData(vtkInformation* vtkNotUsed(request),
   }
   return 1;
 }
+
+//------------------------------------------------------------------------------
+// Each use of an edge by a triangle is an edge tuple whose data is the use,
+// so that sorting the tuples with vtkStaticEdgeLocatorTemplate gathers the
+// uses of each edge. The groups of uses are then processed in parallel, and
+// only the numbering of the inserted points, which follows the order of the
+// uses, is serial.
+namespace
+{
+// Number the edge points. TId is int when the number of points and of edge
+// uses allow it, which speeds up the sort. Returns the number of uses of the
+// first non-manifold edge, negated, if any.
+template <typename TId>
+vtkIdType NumberEdgePoints(
+  vtkCellArray* polys, vtkIdType firstId, int* edgePointIds, vtkIdTypeArray* edgeUses)
+{
+  using EdgeTupleType = EdgeTuple<TId, TId>;
+
+  const vtkIdType numCells = polys->GetNumberOfCells();
+  const vtkIdType numUses = 3 * numCells;
+  std::vector<EdgeTupleType> edges(numUses);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    auto iter = vtk::TakeSmartPointer(polys->NewIterator());
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (; cellId < endCellId; ++cellId)
+    {
+      iter->GetCellAtId(cellId, npts, pts);
+      for (int i = 0; i < 3; ++i)
+      {
+        EdgeTupleType& edge = edges[3 * cellId + i];
+        edge.Define(static_cast<TId>(pts[(i + 2) % 3]), static_cast<TId>(pts[i]));
+        edge.Data = static_cast<TId>(3 * cellId + i);
+      }
+    }
+  });
+
+  vtkStaticEdgeLocatorTemplate<TId, TId> edgeLocator;
+  vtkIdType numEdges = 0;
+  const TId* edgeOffsets = edgeLocator.MergeEdges(numUses, edges.data(), numEdges);
+
+  // The edge of each use, and the first two uses of each edge. A triangle
+  // using an edge twice is degenerate, and the edge is a boundary edge.
+  std::vector<TId> useEdges(numUses);
+  std::vector<TId> firstUses(2 * numEdges);
+  vtkSMPTools::For(0, numEdges, [&](vtkIdType edgeId, vtkIdType endEdgeId) {
+    for (; edgeId < endEdgeId; ++edgeId)
+    {
+      TId first = static_cast<TId>(numUses);
+      TId second = first;
+      for (TId i = edgeOffsets[edgeId]; i < edgeOffsets[edgeId + 1]; ++i)
+      {
+        const TId use = edges[i].Data;
+        useEdges[use] = static_cast<TId>(edgeId);
+        if (use < first)
+        {
+          second = first;
+          first = use;
+        }
+        else if (use < second)
+        {
+          second = use;
+        }
+      }
+      if (second == numUses || second / 3 == first / 3)
+      {
+        second = -1;
+      }
+      firstUses[2 * edgeId] = first;
+      firstUses[2 * edgeId + 1] = second;
+    }
+  });
+
+  // Number the points in the order of the uses, and report the first
+  // non-manifold edge met in this order.
+  std::vector<TId> edgePoints(numEdges);
+  edgeUses->SetNumberOfTuples(numEdges);
+  vtkIdType* uses = edgeUses->GetPointer(0);
+  vtkIdType numEdgePoints = 0;
+  for (vtkIdType use = 0; use < numUses; ++use)
+  {
+    const TId edgeId = useEdges[use];
+    if (firstUses[2 * edgeId] != use)
+    {
+      continue;
+    }
+    const vtkIdType numEdgeUses = edgeOffsets[edgeId + 1] - edgeOffsets[edgeId];
+    if (numEdgeUses > 2)
+    {
+      return -numEdgeUses;
+    }
+    uses[2 * numEdgePoints] = use;
+    uses[2 * numEdgePoints + 1] = firstUses[2 * edgeId + 1];
+    edgePoints[edgeId] = static_cast<TId>(numEdgePoints++);
+  }
+
+  vtkSMPTools::For(0, numUses, [&](vtkIdType use, vtkIdType endUse) {
+    for (; use < endUse; ++use)
+    {
+      edgePointIds[use] = static_cast<int>(firstId + edgePoints[useEdges[use]]);
+    }
+  });
+  return numEdgePoints;
+}
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+vtkIdType vtkSubdivisionFilter::NumberEdgePoints(
+  vtkPolyData* inputDS, vtkIdType firstId, vtkIntArray* edgeData, vtkIdTypeArray* edgeUses)
+{
+  vtkCellArray* polys = inputDS->GetPolys();
+  const vtkIdType numUses = 3 * polys->GetNumberOfCells();
+  edgeUses->SetNumberOfComponents(2);
+  edgeUses->SetNumberOfTuples(0);
+  if (numUses < 1)
+  {
+    return 0;
+  }
+
+  vtkIdType numEdgePoints;
+  if (inputDS->GetNumberOfPoints() < VTK_INT_MAX && numUses < VTK_INT_MAX)
+  {
+    numEdgePoints = ::NumberEdgePoints<int>(polys, firstId, edgeData->GetPointer(0), edgeUses);
+  }
+  else
+  {
+    numEdgePoints =
+      ::NumberEdgePoints<vtkIdType>(polys, firstId, edgeData->GetPointer(0), edgeUses);
+  }
+  if (numEdgePoints < 0)
+  {
+    vtkErrorMacro("Dataset is non-manifold and cannot be subdivided. Edge shared by "
+      << -numEdgePoints << " cells");
+    return -1;
+  }
+  return numEdgePoints;
+}
+
+//------------------------------------------------------------------------------
 void vtkSubdivisionFilter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
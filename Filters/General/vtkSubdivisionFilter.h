@@ -30,9 +30,11 @@
 class vtkCellArray;
 class vtkCellData;
 class vtkIdList;
+class vtkIdTypeArray;
 class vtkIntArray;
 class vtkPoints;
 class vtkPointData;
+class vtkPolyData;
 
 class VTKFILTERSGENERAL_EXPORT vtkSubdivisionFilter : public vtkPolyDataAlgorithm
 {
@@ -66,6 +68,20 @@ protected:
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  /**
+   * Number the points inserted on the edges of the triangles of inputDS,
+   * from firstId and in the order in which the triangles first use the
+   * edges. Edge i of a triangle joins its points (i + 2) % 3 and i, and a
+   * use of an edge is 3 * cellId + i. edgeData receives the point inserted
+   * on each edge of each triangle. edgeUses receives, for each inserted
+   * point, the first use of its edge and the use by the triangle across it,
+   * or -1 on the boundary. Returns the number of inserted points, or -1 if
+   * an edge is used by more than two triangles. The edges are gathered in
+   * parallel with vtkStaticEdgeLocatorTemplate.
+   */
+  vtkIdType NumberEdgePoints(
+    vtkPolyData* inputDS, vtkIdType firstId, vtkIntArray* edgeData, vtkIdTypeArray* edgeUses);
+
   int NumberOfSubdivisions;
   vtkTypeBool CheckForTriangles;
 
@@ -29,6 +29,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkEmptyCell.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
@@ -36,10 +37,12 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
@@ -51,6 +54,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include <algorithm>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -400,26 +404,84 @@ struct vtkYoungsMaterialInterface_Mat
   vtkDataArray* normalYArray;
   vtkDataArray* normalZArray;
   vtkDataArray* orderingArray;
+};
 
-  // temporary
-  vtkIdType numberOfCells;
-  vtkIdType numberOfPoints;
-  vtkIdType cellCount;
-  vtkIdType cellArrayCount;
-  vtkIdType pointCount;
-  vtkIdType* pointMap;
+// Output of a material for a range of cells. The points inserted on the cut
+// edges and the points taken from the interfaces of previous materials belong
+// to a single cell and are stored in outPointArrays. The input points are
+// shared between cells, so they are only referenced here and numbered when
+// the pieces are merged in order.
+struct vtkYoungsMaterialInterface_Piece
+{
+  // number of tuples of outPointArrays
+  vtkIdType pointCount = 0;
 
-  // output
+  // for each cell: its type, its input cell, and the numbers of interface
+  // points, input points and points from previous materials it adds
   std::vector<unsigned char> cellTypes;
+  std::vector<vtkIdType> cellIds;
+  std::vector<int> cellPointCounts;
+
+  // legacy connectivity where a point is either the index of a point added
+  // by the cell, or an input point id p encoded as -p - 1
   std::vector<vtkIdType> cells;
-  vtkDataArray** outCellArrays;
-  vtkDataArray** outPointArrays; // last point array is point coords
+  std::vector<vtkIdType> inputPoints;
+
+  std::vector<vtkSmartPointer<vtkDataArray>> outPointArrays; // last point array is point coords
+};
+
+// Messages and statistics of a range of cells, reported once all the ranges
+// are processed.
+struct vtkYoungsMaterialInterface_RangeInfo
+{
+  std::vector<std::pair<bool, std::string>> Messages; // true for warnings
+  vtkIdType PrimaryTriangulationFailed = 0;
+  vtkIdType TriangulationFailed = 0;
+  vtkIdType NullNormal = 0;
+  vtkIdType NoInterfaceFound = 0;
 };
 
+#define RANGE_WARNING(x)                                                                           \
+  do                                                                                               \
+  {                                                                                                \
+    std::ostringstream rangeMessage;                                                               \
+    rangeMessage x;                                                                                \
+    info.Messages.emplace_back(true, rangeMessage.str());                                          \
+  } while (false)
+
+#define RANGE_DEBUG(x)                                                                             \
+  do                                                                                               \
+  {                                                                                                \
+    if (this->Debug)                                                                               \
+    {                                                                                              \
+      std::ostringstream rangeMessage;                                                             \
+      rangeMessage x;                                                                              \
+      info.Messages.emplace_back(false, rangeMessage.str());                                       \
+    }                                                                                              \
+  } while (false)
+
+// Output point arrays of a material, like the input point arrays, followed by
+// the point coordinates.
+static void vtkYoungsMaterialInterface_NewPointArrays(int nPointData,
+  vtkDataArray** inPointArrays, std::vector<vtkSmartPointer<vtkDataArray>>& outPointArrays)
+{
+  outPointArrays.resize(nPointData);
+  for (int i = 0; i < (nPointData - 1); i++)
+  {
+    outPointArrays[i] =
+      vtk::TakeSmartPointer(vtkDataArray::CreateDataArray(inPointArrays[i]->GetDataType()));
+    outPointArrays[i]->SetName(inPointArrays[i]->GetName());
+    outPointArrays[i]->SetNumberOfComponents(inPointArrays[i]->GetNumberOfComponents());
+  }
+  outPointArrays[nPointData - 1] = vtkSmartPointer<vtkDoubleArray>::New();
+  outPointArrays[nPointData - 1]->SetName("Points");
+  outPointArrays[nPointData - 1]->SetNumberOfComponents(3);
+}
+
 static inline void vtkYoungsMaterialInterface_GetPointData(int nPointData,
   vtkDataArray** inPointArrays, vtkDataSet* input,
   std::vector<std::pair<int, vtkIdType>>& prevPointsMap, int vtkNotUsed(nmat),
-  vtkYoungsMaterialInterface_Mat* Mats, int a, vtkIdType i, double* t)
+  vtkYoungsMaterialInterface_Piece* Pieces, int a, vtkIdType i, double* t)
 {
   if ((i) >= 0)
   {
@@ -442,14 +504,14 @@ static inline void vtkYoungsMaterialInterface_GetPointData(int nPointData,
     int prev_m = prevPointsMap[j].first;
     DBG_ASSERT(prev_m >= 0);
     vtkIdType prev_i = (prevPointsMap[j].second);
-    DBG_ASSERT(prev_i >= 0 && prev_i < Mats[prev_m].outPointArrays[a]->GetNumberOfTuples());
-    Mats[prev_m].outPointArrays[a]->GetTuple(prev_i, t);
+    DBG_ASSERT(prev_i >= 0 && prev_i < Pieces[prev_m].outPointArrays[a]->GetNumberOfTuples());
+    Pieces[prev_m].outPointArrays[a]->GetTuple(prev_i, t);
   }
 }
 
 #define GET_POINT_DATA(a, i, t)                                                                    \
   vtkYoungsMaterialInterface_GetPointData(                                                         \
-    nPointData, inPointArrays, input, prevPointsMap, nmat, Mats, a, i, t)
+    nPointData, inPointArrays, input, prevPointsMap, nmat, Pieces, a, i, t)
 
 struct CellInfo
 {
@@ -701,825 +763,848 @@ int vtkYoungsMaterialInterface::RequestData(vtkInformation* vtkNotUsed(request),
           Mats[m].fractionArray =
             nullptr; // TODO: we certainly can do better to avoid material calculations
         }
-
-        Mats[m].numberOfCells = 0;
-        Mats[m].cellCount = 0;
-        Mats[m].cellArrayCount = 0;
-
-        Mats[m].outCellArrays = new vtkDataArray*[nCellData];
-        for (int i = 0; i < nCellData; ++i)
-        {
-          Mats[m].outCellArrays[i] = vtkDataArray::CreateDataArray(inCellArrays[i]->GetDataType());
-          Mats[m].outCellArrays[i]->SetName(inCellArrays[i]->GetName());
-          Mats[m].outCellArrays[i]->SetNumberOfComponents(inCellArrays[i]->GetNumberOfComponents());
-        }
-
-        Mats[m].numberOfPoints = 0;
-        Mats[m].pointCount = 0;
-        Mats[m].outPointArrays = new vtkDataArray*[nPointData];
-
-        for (int i = 0; i < (nPointData - 1); i++)
-        {
-          Mats[m].outPointArrays[i] =
-            vtkDataArray::CreateDataArray(inPointArrays[i]->GetDataType());
-          Mats[m].outPointArrays[i]->SetName(inPointArrays[i]->GetName());
-          Mats[m].outPointArrays[i]->SetNumberOfComponents(
-            inPointArrays[i]->GetNumberOfComponents());
-        }
-        Mats[m].outPointArrays[nPointData - 1] = vtkDoubleArray::New();
-        Mats[m].outPointArrays[nPointData - 1]->SetName("Points");
-        Mats[m].outPointArrays[nPointData - 1]->SetNumberOfComponents(3);
-      }
-    }
-
-    // --------------- per material number of interfaces estimation ------------
-    for (vtkIdType c = 0; c < nCells; c++)
-    {
-      vtkCell* vtkcell = input->GetCell(c);
-      int cellDim = vtkcell->GetCellDimension();
-      int np = vtkcell->GetNumberOfPoints();
-      int nf = vtkcell->GetNumberOfFaces();
-
-      for (int m = 0; m < nmat; m++)
-      {
-        double fraction =
-          (Mats[m].fractionArray != nullptr) ? Mats[m].fractionArray->GetTuple1(c) : 0;
-        if (this->CellProduceInterface(
-              cellDim, np, fraction, this->VolumeFractionRange[0], this->VolumeFractionRange[1]))
-        {
-          if (cellDim == 2)
-          {
-            Mats[m].numberOfPoints += 2;
-          }
-          else
-          {
-            Mats[m].numberOfPoints += nf;
-          }
-          if (this->FillMaterial)
-          {
-            Mats[m].numberOfPoints += np - 1;
-          }
-          Mats[m].numberOfCells++;
-        }
-      }
-    }
-
-    // allocation of output arrays
-    for (int m = 0; m < nmat; m++)
-    {
-      vtkDebugMacro(<< "Mat #" << m << " : cells=" << Mats[m].numberOfCells << ", points="
-                    << Mats[m].numberOfPoints << ", FillMaterial=" << this->FillMaterial << "\n");
-      for (int i = 0; i < nCellData; i++)
-      {
-        Mats[m].outCellArrays[i]->Allocate(
-          Mats[m].numberOfCells * Mats[m].outCellArrays[i]->GetNumberOfComponents());
-      }
-      for (int i = 0; i < nPointData; i++)
-      {
-        Mats[m].outPointArrays[i]->Allocate(
-          Mats[m].numberOfPoints * Mats[m].outPointArrays[i]->GetNumberOfComponents());
-      }
-      Mats[m].cellTypes.reserve(Mats[m].numberOfCells);
-      Mats[m].cells.reserve(Mats[m].numberOfCells + Mats[m].numberOfPoints);
-      Mats[m].pointMap = new vtkIdType[nPoints];
-      for (vtkIdType i = 0; i < nPoints; i++)
-      {
-        Mats[m].pointMap[i] = -1;
       }
     }
 
     // --------------------------- core computation --------------------------
-    vtkIdList* ptIds = vtkIdList::New();
-    vtkPoints* pts = vtkPoints::New();
-    vtkConvexPointSet* cpsCell = vtkConvexPointSet::New();
-
-    double* interpolatedValues = new double[MAX_CELL_POINTS * pointDataComponents];
-    vtkYoungsMaterialInterface_IndexedValue* matOrdering =
-      new vtkYoungsMaterialInterface_IndexedValue[nmat];
-
-    std::vector<std::pair<int, vtkIdType>> prevPointsMap;
-    prevPointsMap.reserve(MAX_CELL_POINTS * nmat);
-
-    for (vtkIdType ci = 0; ci < nCells; ci++)
+    // The cells are processed in ranges, concurrently. Each range produces a
+    // piece of the output of every material, and the pieces are merged in the
+    // order of the cells afterwards, so that the output does not depend on the
+    // number of threads. A first GetCell() from a single thread makes the
+    // following ones thread safe.
+    if (nCells > 0)
     {
-      int interfaceEdges[MAX_CELL_POINTS * 2];
-      double interfaceWeights[MAX_CELL_POINTS];
-      int nInterfaceEdges;
-
-      int insidePointIds[MAX_CELL_POINTS];
-      int nInsidePoints;
-
-      int outsidePointIds[MAX_CELL_POINTS];
-      int nOutsidePoints;
-
-      int outCellPointIds[MAX_CELL_POINTS];
-      int nOutCellPoints;
+      vtkNew<vtkGenericCell> firstCell;
+      input->GetCell(0, firstCell);
+    }
+    const vtkIdType cellsPerRange =
+      std::max<vtkIdType>(256, nCells / (16 * vtkSMPTools::GetEstimatedNumberOfThreads()) + 1);
+    const vtkIdType nRanges = (nCells + cellsPerRange - 1) / cellsPerRange;
+    std::vector<vtkYoungsMaterialInterface_Piece> pieces(nRanges * nmat);
+    std::vector<vtkYoungsMaterialInterface_RangeInfo> rangeInfos(nRanges);
 
-      double referenceVolume = 1.0;
-      double normal[3];
-      bool normaleNulle = false;
+    vtkSMPTools::For(0, nRanges, 1, [&](vtkIdType firstRange, vtkIdType endRange) {
+      vtkNew<vtkGenericCell> genericCell;
+      vtkNew<vtkIdList> ptIds;
+      vtkNew<vtkPoints> pts;
+      vtkNew<vtkConvexPointSet> cpsCell;
 
-      prevPointsMap.clear();
+      std::vector<double> interpolatedValues(MAX_CELL_POINTS * pointDataComponents);
+      std::vector<vtkYoungsMaterialInterface_IndexedValue> matOrdering(nmat);
 
-      // sort materials
-      int nEffectiveMat = 0;
-      for (int mi = 0; mi < nmat; mi++)
-      {
-        matOrdering[mi].index = mi;
-        matOrdering[mi].value =
-          (Mats[mi].orderingArray != nullptr) ? Mats[mi].orderingArray->GetTuple1(ci) : 0.0;
-
-        double fraction =
-          (Mats[mi].fractionArray != nullptr) ? Mats[mi].fractionArray->GetTuple1(ci) : 0;
-        if (this->UseFractionAsDistance || fraction > this->VolumeFractionRange[0])
-          nEffectiveMat++;
-      }
-      std::stable_sort(matOrdering, matOrdering + nmat);
-
-      // read cell information for the first iteration
-      // a temporary cell will then be generated after each iteration for the next one.
-      vtkCell* vtkcell = input->GetCell(ci);
-      CellInfo cell;
-      cell.dim = vtkcell->GetCellDimension();
-      cell.np = vtkcell->GetNumberOfPoints();
-      cell.nf = vtkcell->GetNumberOfFaces();
-      cell.type = vtkcell->GetCellType();
-
-      /* copy points and point ids to lacal arrays.
-         IMPORTANT NOTE : A negative point id refers to a point in the previous material.
-         the material number and real point id can be found through the prevPointsMap. */
-      for (int p = 0; p < cell.np; p++)
-      {
-        cell.pointIds[p] = vtkcell->GetPointId(p);
-        DBG_ASSERT(cell.pointIds[p] >= 0 && cell.pointIds[p] < nPoints);
-        vtkcell->GetPoints()->GetPoint(p, cell.points[p]);
-      }
+      std::vector<std::pair<int, vtkIdType>> prevPointsMap;
+      prevPointsMap.reserve(MAX_CELL_POINTS * nmat);
 
-      /* Triangulate cell.
-         IMPORTANT NOTE: triangulation is given with mesh point ids (not local cell ids)
-         and are translated to cell local point ids. */
-      cell.needTriangulation = false;
-      cell.triangulationOk = (vtkcell->Triangulate(ci, ptIds, pts) != 0);
-      cell.ntri = 0;
-      if (cell.triangulationOk)
-      {
-        cell.ntri = ptIds->GetNumberOfIds() / (cell.dim + 1);
-        for (int i = 0; i < (cell.ntri * (cell.dim + 1)); i++)
-        {
-          vtkIdType j =
-            std::find(cell.pointIds, cell.pointIds + cell.np, ptIds->GetId(i)) - cell.pointIds;
-          DBG_ASSERT(j >= 0 && j < cell.np);
-          cell.triangulation[i] = j;
-        }
-      }
-      else
+      for (vtkIdType r = firstRange; r < endRange; ++r)
       {
-        debugStats_PrimaryTriangulationfailed++;
-        vtkWarningMacro(<< "Triangulation failed on primary cell\n");
-      }
+        vtkYoungsMaterialInterface_Piece* Pieces = pieces.data() + r * nmat;
+        vtkYoungsMaterialInterface_RangeInfo& info = rangeInfos[r];
+        const vtkIdType endCell = std::min(nCells, (r + 1) * cellsPerRange);
 
-      // get 3D cell edges.
-      if (cell.dim == 3)
-      {
-        vtkCell3D* cell3D = vtkCell3D::SafeDownCast(vtkcell);
-        cell.nEdges = vtkcell->GetNumberOfEdges();
-        for (int i = 0; i < cell.nEdges; i++)
+        for (vtkIdType ci = r * cellsPerRange; ci < endCell; ci++)
         {
-          const vtkIdType* edgePoints;
-          cell3D->GetEdgePoints(i, edgePoints);
-          cell.edges[i][0] = edgePoints[0];
-          DBG_ASSERT(cell.edges[i][0] >= 0 && cell.edges[i][0] < cell.np);
-          cell.edges[i][1] = edgePoints[1];
-          DBG_ASSERT(cell.edges[i][1] >= 0 && cell.edges[i][1] < cell.np);
-        }
-      }
+          int interfaceEdges[MAX_CELL_POINTS * 2];
+          double interfaceWeights[MAX_CELL_POINTS];
+          int nInterfaceEdges;
 
-      // For debugging : ensure that we don't read anything from cell, but only from previously
-      // filled arrays
-      vtkcell = nullptr;
+          int insidePointIds[MAX_CELL_POINTS];
+          int nInsidePoints;
 
-      int processedEfectiveMat = 0;
+          int outsidePointIds[MAX_CELL_POINTS];
+          int nOutsidePoints;
 
-      // Loop for each material. Current cell is iteratively cut.
-      for (int mi = 0; mi < nmat; mi++)
-      {
-        int m =
-          this->ReverseMaterialOrder ? matOrdering[nmat - 1 - mi].index : matOrdering[mi].index;
-
-        // Get volume fraction and interface plane normal from input arrays
-        double fraction =
-          (Mats[m].fractionArray != nullptr) ? Mats[m].fractionArray->GetTuple1(ci) : 0;
+          int outCellPointIds[MAX_CELL_POINTS];
+          int nOutCellPoints;
 
-        // Normalize remaining volume fraction
-        fraction = (referenceVolume > 0) ? (fraction / referenceVolume) : 0.0;
+          double referenceVolume = 1.0;
+          double normal[3];
+          bool normaleNulle = false;
+          bool normalFound = false;
 
-        if (this->CellProduceInterface(cell.dim, cell.np, fraction, this->VolumeFractionRange[0],
-              this->VolumeFractionRange[1]))
-        {
-          CellInfo nextCell; // empty cell by default
-          int interfaceCellType = VTK_EMPTY_CELL;
+          prevPointsMap.clear();
 
-          if ((!mi) || (!this->OnionPeel))
+          // sort materials
+          int nEffectiveMat = 0;
+          for (int mi = 0; mi < nmat; mi++)
           {
-            normal[0] = 0;
-            normal[1] = 0;
-            normal[2] = 0;
-
-            if (Mats[m].normalArray != nullptr)
-              Mats[m].normalArray->GetTuple(ci, normal);
-            if (Mats[m].normalXArray != nullptr)
-              normal[0] = Mats[m].normalXArray->GetTuple1(ci);
-            if (Mats[m].normalYArray != nullptr)
-              normal[1] = Mats[m].normalYArray->GetTuple1(ci);
-            if (Mats[m].normalZArray != nullptr)
-              normal[2] = Mats[m].normalZArray->GetTuple1(ci);
-
-            // work-around for degenerated normals
-            if (vtkMath::Norm(normal) == 0.0) // should it be <EPSILON ?
-            {
-              debugStats_NullNormal++;
-              normaleNulle = true;
-              normal[0] = 1.0;
-              normal[1] = 0.0;
-              normal[2] = 0.0;
-            }
-            else
-            {
-              vtkMath::Normalize(normal);
-            }
-            if (this->InverseNormal)
-            {
-              normal[0] = -normal[0];
-              normal[1] = -normal[1];
-              normal[2] = -normal[2];
-            }
+            matOrdering[mi].index = mi;
+            matOrdering[mi].value = (Mats[mi].orderingArray != nullptr)
+              ? Mats[mi].orderingArray->GetComponent(ci, 0)
+              : 0.0;
+
+            double fraction =
+              (Mats[mi].fractionArray != nullptr) ? Mats[mi].fractionArray->GetComponent(ci, 0) : 0;
+            if (this->UseFractionAsDistance || fraction > this->VolumeFractionRange[0])
+              nEffectiveMat++;
           }
-
-          // count how many materials we've processed so far
-          if (fraction > this->VolumeFractionRange[0])
+          std::stable_sort(matOrdering.begin(), matOrdering.end());
+
+          // read cell information for the first iteration
+          // a temporary cell will then be generated after each iteration for the next one.
+          input->GetCell(ci, genericCell);
+          vtkCell* vtkcell = genericCell->GetRepresentativeCell();
+          CellInfo cell;
+          cell.dim = vtkcell->GetCellDimension();
+          cell.np = vtkcell->GetNumberOfPoints();
+          cell.nf = vtkcell->GetNumberOfFaces();
+          cell.type = vtkcell->GetCellType();
+
+          /* copy points and point ids to lacal arrays.
+             IMPORTANT NOTE : A negative point id refers to a point in the previous material.
+             the material number and real point id can be found through the prevPointsMap. */
+          for (int p = 0; p < cell.np; p++)
           {
-            processedEfectiveMat++;
+            cell.pointIds[p] = vtkcell->GetPointId(p);
+            DBG_ASSERT(cell.pointIds[p] >= 0 && cell.pointIds[p] < nPoints);
+            vtkcell->GetPoints()->GetPoint(p, cell.points[p]);
           }
 
-          // -= case where the entire input cell is passed through =-
-          if ((!this->UseFractionAsDistance && fraction > this->VolumeFractionRange[1] &&
-                this->FillMaterial) ||
-            (this->UseFractionAsDistance && normaleNulle))
+          /* Triangulate cell.
+             IMPORTANT NOTE: triangulation is given with mesh point ids (not local cell ids)
+             and are translated to cell local point ids. */
+          cell.needTriangulation = false;
+          cell.triangulationOk = (vtkcell->Triangulate(ci, ptIds, pts) != 0);
+          cell.ntri = 0;
+          if (cell.triangulationOk)
           {
-            interfaceCellType = cell.type;
-            // Mats[m].cellTypes.push_back( cell.type );
-            nOutCellPoints = nInsidePoints = cell.np;
-            nInterfaceEdges = 0;
-            nOutsidePoints = 0;
-            for (int p = 0; p < cell.np; p++)
+            cell.ntri = ptIds->GetNumberOfIds() / (cell.dim + 1);
+            for (int i = 0; i < (cell.ntri * (cell.dim + 1)); i++)
             {
-              outCellPointIds[p] = insidePointIds[p] = p;
+              vtkIdType j =
+                std::find(cell.pointIds, cell.pointIds + cell.np, ptIds->GetId(i)) - cell.pointIds;
+              DBG_ASSERT(j >= 0 && j < cell.np);
+              cell.triangulation[i] = j;
             }
-            // remaining volume is an empty cell (nextCell is left as is)
           }
-
-          // -= case where the entire cell is ignored =-
-
-          else if (!this->UseFractionAsDistance &&
-            (fraction < this->VolumeFractionRange[0] ||
-              (fraction > this->VolumeFractionRange[1] && !this->FillMaterial) ||
-              !cell.triangulationOk))
+          else
           {
-            interfaceCellType = VTK_EMPTY_CELL;
-            // Mats[m].cellTypes.push_back( VTK_EMPTY_CELL );
-
-            nOutCellPoints = 0;
-            nInterfaceEdges = 0;
-            nInsidePoints = 0;
-            nOutsidePoints = 0;
-
-            // remaining volume is the same cell
-            nextCell = cell;
+            info.PrimaryTriangulationFailed++;
+            RANGE_WARNING(<< "Triangulation failed on primary cell\n");
+          }
 
-            if (!cell.triangulationOk)
+          // get 3D cell edges.
+          if (cell.dim == 3)
+          {
+            vtkCell3D* cell3D = vtkCell3D::SafeDownCast(vtkcell);
+            cell.nEdges = vtkcell->GetNumberOfEdges();
+            for (int i = 0; i < cell.nEdges; i++)
             {
-              debugStats_Triangulationfailed++;
-              vtkWarningMacro(<< "Cell triangulation failed\n");
+              const vtkIdType* edgePoints;
+              cell3D->GetEdgePoints(i, edgePoints);
+              cell.edges[i][0] = edgePoints[0];
+              DBG_ASSERT(cell.edges[i][0] >= 0 && cell.edges[i][0] < cell.np);
+              cell.edges[i][1] = edgePoints[1];
+              DBG_ASSERT(cell.edges[i][1] >= 0 && cell.edges[i][1] < cell.np);
             }
           }
 
-          // -= 2D case =-
-          else if (cell.dim == 2)
+          // For debugging : ensure that we don't read anything from cell, but only from previously
+          // filled arrays
+          vtkcell = nullptr;
+
+          int processedEfectiveMat = 0;
+
+          // Loop for each material. Current cell is iteratively cut.
+          for (int mi = 0; mi < nmat; mi++)
           {
-            int nRemCellPoints;
-            int remCellPointIds[MAX_CELL_POINTS];
+            int m =
+              this->ReverseMaterialOrder ? matOrdering[nmat - 1 - mi].index : matOrdering[mi].index;
 
-            int triangles[MAX_CELL_POINTS][3];
-            for (int i = 0; i < cell.ntri; i++)
-              for (int j = 0; j < 3; j++)
-              {
-                triangles[i][j] = cell.triangulation[i * 3 + j];
-                DBG_ASSERT(triangles[i][j] >= 0 && triangles[i][j] < cell.np);
-              }
+            // Get volume fraction and interface plane normal from input arrays
+            double fraction =
+              (Mats[m].fractionArray != nullptr) ? Mats[m].fractionArray->GetComponent(ci, 0) : 0;
 
-            bool interfaceFound = vtkYoungsMaterialInterfaceCellCut::cellInterfaceD(cell.points,
-              cell.np, triangles, cell.ntri, fraction, normal, this->AxisSymetric != 0,
-              this->UseFractionAsDistance != 0, interfaceEdges, interfaceWeights, nOutCellPoints,
-              outCellPointIds, nRemCellPoints, remCellPointIds);
+            // Normalize remaining volume fraction
+            fraction = (referenceVolume > 0) ? (fraction / referenceVolume) : 0.0;
 
-            if (interfaceFound)
+            if (this->CellProduceInterface(cell.dim, cell.np, fraction,
+                  this->VolumeFractionRange[0], this->VolumeFractionRange[1]))
             {
-              nInterfaceEdges = 2;
-              interfaceCellType = this->FillMaterial ? VTK_POLYGON : VTK_LINE;
-              // Mats[m].cellTypes.push_back( this->FillMaterial ? VTK_POLYGON : VTK_LINE );
-
-              // remaining volume is a polygon
-              nextCell.dim = 2;
-              nextCell.np = nRemCellPoints;
-              nextCell.nf = nRemCellPoints;
-              nextCell.type = VTK_POLYGON;
-
-              // build polygon triangulation for next iteration
-              nextCell.ntri = nextCell.np - 2;
-              for (int i = 0; i < nextCell.ntri; i++)
-              {
-                nextCell.triangulation[i * 3 + 0] = 0;
-                nextCell.triangulation[i * 3 + 1] = i + 1;
-                nextCell.triangulation[i * 3 + 2] = i + 2;
-              }
-              nextCell.triangulationOk = true;
-              nextCell.needTriangulation = false;
+              CellInfo nextCell; // empty cell by default
+              int interfaceCellType = VTK_EMPTY_CELL;
 
-              // populate prevPointsMap and next iteration cell point ids
-              int ni = 0;
-              for (int i = 0; i < nRemCellPoints; i++)
+              // with OnionPeel, the normal of the first material cutting the cell is kept
+              if (!normalFound || !this->OnionPeel)
               {
-                vtkIdType id = remCellPointIds[i];
-                if (id < 0)
+                normalFound = true;
+                normal[0] = 0;
+                normal[1] = 0;
+                normal[2] = 0;
+
+                if (Mats[m].normalArray != nullptr)
+                  Mats[m].normalArray->GetTuple(ci, normal);
+                if (Mats[m].normalXArray != nullptr)
+                  normal[0] = Mats[m].normalXArray->GetComponent(ci, 0);
+                if (Mats[m].normalYArray != nullptr)
+                  normal[1] = Mats[m].normalYArray->GetComponent(ci, 0);
+                if (Mats[m].normalZArray != nullptr)
+                  normal[2] = Mats[m].normalZArray->GetComponent(ci, 0);
+
+                // work-around for degenerated normals
+                if (vtkMath::Norm(normal) == 0.0) // should it be <EPSILON ?
                 {
-                  id = -(int)(prevPointsMap.size() + 1);
-                  DBG_ASSERT((-id - 1) == prevPointsMap.size());
-                  prevPointsMap.emplace_back(
-                    m, Mats[m].pointCount + ni); // intersection points will be added first
-                  ni++;
+                  info.NullNormal++;
+                  normaleNulle = true;
+                  normal[0] = 1.0;
+                  normal[1] = 0.0;
+                  normal[2] = 0.0;
                 }
                 else
                 {
-                  DBG_ASSERT(id >= 0 && id < cell.np);
-                  id = cell.pointIds[id];
+                  vtkMath::Normalize(normal);
+                }
+                if (this->InverseNormal)
+                {
+                  normal[0] = -normal[0];
+                  normal[1] = -normal[1];
+                  normal[2] = -normal[2];
                 }
-                nextCell.pointIds[i] = id;
               }
-              DBG_ASSERT(ni == nInterfaceEdges);
 
-              // filter out points inside material volume
-              nInsidePoints = 0;
-              for (int i = 0; i < nOutCellPoints; i++)
+              // count how many materials we've processed so far
+              if (fraction > this->VolumeFractionRange[0])
               {
-                if (outCellPointIds[i] >= 0)
-                  insidePointIds[nInsidePoints++] = outCellPointIds[i];
+                processedEfectiveMat++;
               }
 
-              if (!this->FillMaterial) // keep only interface points
-
+              // -= case where the entire input cell is passed through =-
+              if ((!this->UseFractionAsDistance && fraction > this->VolumeFractionRange[1] &&
+                    this->FillMaterial) ||
+                (this->UseFractionAsDistance && normaleNulle))
               {
-                int n = 0;
-                for (int i = 0; i < nOutCellPoints; i++)
+                interfaceCellType = cell.type;
+                // Mats[m].cellTypes.push_back( cell.type );
+                nOutCellPoints = nInsidePoints = cell.np;
+                nInterfaceEdges = 0;
+                nOutsidePoints = 0;
+                for (int p = 0; p < cell.np; p++)
                 {
-                  if (outCellPointIds[i] < 0)
-                    outCellPointIds[n++] = outCellPointIds[i];
+                  outCellPointIds[p] = insidePointIds[p] = p;
                 }
-                nOutCellPoints = n;
+                // remaining volume is an empty cell (nextCell is left as is)
               }
-            }
-            else
-            {
-              vtkWarningMacro(<< "no interface found for cell " << ci << ", mi=" << mi
-                              << ", m=" << m << ", frac=" << fraction << "\n");
-              nInterfaceEdges = 0;
-              nOutCellPoints = 0;
-              nInsidePoints = 0;
-              nOutsidePoints = 0;
-              interfaceCellType = VTK_EMPTY_CELL;
-              // Mats[m].cellTypes.push_back( VTK_EMPTY_CELL );
-              // remaining volume is the original cell left unmodified
-              nextCell = cell;
-            }
-          }
 
-          // -= 3D case =-
+              // -= case where the entire cell is ignored =-
 
-          else
-          {
-            int tetras[MAX_CELL_POINTS][4];
-            for (int i = 0; i < cell.ntri; i++)
-              for (int j = 0; j < 4; j++)
+              else if (!this->UseFractionAsDistance &&
+                (fraction < this->VolumeFractionRange[0] ||
+                  (fraction > this->VolumeFractionRange[1] && !this->FillMaterial) ||
+                  !cell.triangulationOk))
               {
-                tetras[i][j] = cell.triangulation[i * 4 + j];
-              }
+                interfaceCellType = VTK_EMPTY_CELL;
+                // Mats[m].cellTypes.push_back( VTK_EMPTY_CELL );
 
-            // compute innterface polygon
-            vtkYoungsMaterialInterfaceCellCut::cellInterface3D(cell.np, cell.points, cell.nEdges,
-              cell.edges, cell.ntri, tetras, fraction, normal, this->UseFractionAsDistance != 0,
-              nInterfaceEdges, interfaceEdges, interfaceWeights, nInsidePoints, insidePointIds,
-              nOutsidePoints, outsidePointIds);
+                nOutCellPoints = 0;
+                nInterfaceEdges = 0;
+                nInsidePoints = 0;
+                nOutsidePoints = 0;
 
-            if (nInterfaceEdges > cell.nf ||
-              nInterfaceEdges < 3) // degenerated case, considered as null interface
-            {
-              debugStats_NoInterfaceFound++;
-              vtkDebugMacro(<< "no interface found for cell " << ci << ", mi=" << mi << ", m=" << m
-                            << ", frac=" << fraction << "\n");
-              nInterfaceEdges = 0;
-              nOutCellPoints = 0;
-              nInsidePoints = 0;
-              nOutsidePoints = 0;
-              interfaceCellType = VTK_EMPTY_CELL;
-              // Mats[m].cellTypes.push_back( VTK_EMPTY_CELL );
-
-              // in this case, next iteration cell is the same
-              nextCell = cell;
-            }
-            else
-            {
-              nOutCellPoints = 0;
+                // remaining volume is the same cell
+                nextCell = cell;
 
-              for (int e = 0; e < nInterfaceEdges; e++)
-              {
-                outCellPointIds[nOutCellPoints++] = -e - 1;
+                if (!cell.triangulationOk)
+                {
+                  info.TriangulationFailed++;
+                  RANGE_WARNING(<< "Cell triangulation failed\n");
+                }
               }
 
-              if (this->FillMaterial)
+              // -= 2D case =-
+              else if (cell.dim == 2)
               {
-                interfaceCellType = VTK_CONVEX_POINT_SET;
-                // Mats[m].cellTypes.push_back( VTK_CONVEX_POINT_SET );
-                for (int p = 0; p < nInsidePoints; p++)
+                int nRemCellPoints;
+                int remCellPointIds[MAX_CELL_POINTS];
+
+                int triangles[MAX_CELL_POINTS][3];
+                for (int i = 0; i < cell.ntri; i++)
+                  for (int j = 0; j < 3; j++)
+                  {
+                    triangles[i][j] = cell.triangulation[i * 3 + j];
+                    DBG_ASSERT(triangles[i][j] >= 0 && triangles[i][j] < cell.np);
+                  }
+
+                bool interfaceFound = vtkYoungsMaterialInterfaceCellCut::cellInterfaceD(
+                  cell.points, cell.np, triangles, cell.ntri, fraction, normal,
+                  this->AxisSymetric != 0, this->UseFractionAsDistance != 0, interfaceEdges,
+                  interfaceWeights, nOutCellPoints, outCellPointIds, nRemCellPoints,
+                  remCellPointIds);
+
+                if (interfaceFound)
                 {
-                  outCellPointIds[nOutCellPoints++] = insidePointIds[p];
+                  nInterfaceEdges = 2;
+                  interfaceCellType = this->FillMaterial ? VTK_POLYGON : VTK_LINE;
+                  // Mats[m].cellTypes.push_back( this->FillMaterial ? VTK_POLYGON : VTK_LINE );
+
+                  // remaining volume is a polygon
+                  nextCell.dim = 2;
+                  nextCell.np = nRemCellPoints;
+                  nextCell.nf = nRemCellPoints;
+                  nextCell.type = VTK_POLYGON;
+
+                  // build polygon triangulation for next iteration
+                  nextCell.ntri = nextCell.np - 2;
+                  for (int i = 0; i < nextCell.ntri; i++)
+                  {
+                    nextCell.triangulation[i * 3 + 0] = 0;
+                    nextCell.triangulation[i * 3 + 1] = i + 1;
+                    nextCell.triangulation[i * 3 + 2] = i + 2;
+                  }
+                  nextCell.triangulationOk = true;
+                  nextCell.needTriangulation = false;
+
+                  // populate prevPointsMap and next iteration cell point ids
+                  int ni = 0;
+                  for (int i = 0; i < nRemCellPoints; i++)
+                  {
+                    vtkIdType id = remCellPointIds[i];
+                    if (id < 0)
+                    {
+                      id = -(int)(prevPointsMap.size() + 1);
+                      DBG_ASSERT((-id - 1) == prevPointsMap.size());
+                      prevPointsMap.emplace_back(
+                        m, Pieces[m].pointCount + ni); // intersection points will be added first
+                      ni++;
+                    }
+                    else
+                    {
+                      DBG_ASSERT(id >= 0 && id < cell.np);
+                      id = cell.pointIds[id];
+                    }
+                    nextCell.pointIds[i] = id;
+                  }
+                  DBG_ASSERT(ni == nInterfaceEdges);
+
+                  // filter out points inside material volume
+                  nInsidePoints = 0;
+                  for (int i = 0; i < nOutCellPoints; i++)
+                  {
+                    if (outCellPointIds[i] >= 0)
+                      insidePointIds[nInsidePoints++] = outCellPointIds[i];
+                  }
+
+                  if (!this->FillMaterial) // keep only interface points
+
+                  {
+                    int n = 0;
+                    for (int i = 0; i < nOutCellPoints; i++)
+                    {
+                      if (outCellPointIds[i] < 0)
+                        outCellPointIds[n++] = outCellPointIds[i];
+                    }
+                    nOutCellPoints = n;
+                  }
+                }
+                else
+                {
+                  RANGE_WARNING(<< "no interface found for cell " << ci << ", mi=" << mi
+                                  << ", m=" << m << ", frac=" << fraction << "\n");
+                  nInterfaceEdges = 0;
+                  nOutCellPoints = 0;
+                  nInsidePoints = 0;
+                  nOutsidePoints = 0;
+                  interfaceCellType = VTK_EMPTY_CELL;
+                  // Mats[m].cellTypes.push_back( VTK_EMPTY_CELL );
+                  // remaining volume is the original cell left unmodified
+                  nextCell = cell;
                 }
               }
+
+              // -= 3D case =-
+
               else
               {
-                interfaceCellType = VTK_POLYGON;
-                // Mats[m].cellTypes.push_back( VTK_POLYGON );
-              }
+                int tetras[MAX_CELL_POINTS][4];
+                for (int i = 0; i < cell.ntri; i++)
+                  for (int j = 0; j < 4; j++)
+                  {
+                    tetras[i][j] = cell.triangulation[i * 4 + j];
+                  }
 
-              // NB: Remaining volume is a convex point set
-              // IMPORTANT NOTE: next iteration cell cannot be entirely built right now.
-              // in this particular case we'll finish it at the end of the material loop.
-              // If no other material remains to be processed, then skip this step.
-              if (mi < (nmat - 1) && processedEfectiveMat < nEffectiveMat)
-              {
-                nextCell.type = VTK_CONVEX_POINT_SET;
-                nextCell.np = nInterfaceEdges + nOutsidePoints;
-                vtkcell = cpsCell;
-                vtkcell->Points->Reset();
-                vtkcell->PointIds->Reset();
-                vtkcell->Points->SetNumberOfPoints(nextCell.np);
-                vtkcell->PointIds->SetNumberOfIds(nextCell.np);
-                for (int i = 0; i < nextCell.np; i++)
+                // compute innterface polygon
+                vtkYoungsMaterialInterfaceCellCut::cellInterface3D(cell.np, cell.points,
+                  cell.nEdges, cell.edges, cell.ntri, tetras, fraction, normal,
+                  this->UseFractionAsDistance != 0, nInterfaceEdges, interfaceEdges,
+                  interfaceWeights, nInsidePoints, insidePointIds, nOutsidePoints,
+                  outsidePointIds);
+
+                if (nInterfaceEdges > cell.nf ||
+                  nInterfaceEdges < 3) // degenerated case, considered as null interface
                 {
-                  vtkcell->PointIds->SetId(i, i);
+                  info.NoInterfaceFound++;
+                  RANGE_DEBUG(<< "no interface found for cell " << ci << ", mi=" << mi
+                               << ", m=" << m << ", frac=" << fraction << "\n");
+                  nInterfaceEdges = 0;
+                  nOutCellPoints = 0;
+                  nInsidePoints = 0;
+                  nOutsidePoints = 0;
+                  interfaceCellType = VTK_EMPTY_CELL;
+                  // Mats[m].cellTypes.push_back( VTK_EMPTY_CELL );
+
+                  // in this case, next iteration cell is the same
+                  nextCell = cell;
                 }
-                // nf, ntri and triangulation have to be computed later on, when point coords are
-                // computed
-                nextCell.needTriangulation = true;
-              }
+                else
+                {
+                  nOutCellPoints = 0;
 
-              for (int i = 0; i < nInterfaceEdges; i++)
-              {
-                vtkIdType id = -(int)(prevPointsMap.size() + 1);
-                DBG_ASSERT((-id - 1) == prevPointsMap.size());
-                // Interpolated points will be added consecutively
-                prevPointsMap.emplace_back(m, Mats[m].pointCount + i);
-                nextCell.pointIds[i] = id;
-              }
-              for (int i = 0; i < nOutsidePoints; i++)
-              {
-                nextCell.pointIds[nInterfaceEdges + i] = cell.pointIds[outsidePointIds[i]];
-              }
-            }
+                  for (int e = 0; e < nInterfaceEdges; e++)
+                  {
+                    outCellPointIds[nOutCellPoints++] = -e - 1;
+                  }
 
-            // check correctness of next cell's point ids
-            for (int i = 0; i < nextCell.np; i++)
-            {
-              DBG_ASSERT(
-                (nextCell.pointIds[i] < 0 && (-nextCell.pointIds[i] - 1) < prevPointsMap.size()) ||
-                (nextCell.pointIds[i] >= 0 && nextCell.pointIds[i] < nPoints));
-            }
-          } // End 3D case
+                  if (this->FillMaterial)
+                  {
+                    interfaceCellType = VTK_CONVEX_POINT_SET;
+                    // Mats[m].cellTypes.push_back( VTK_CONVEX_POINT_SET );
+                    for (int p = 0; p < nInsidePoints; p++)
+                    {
+                      outCellPointIds[nOutCellPoints++] = insidePointIds[p];
+                    }
+                  }
+                  else
+                  {
+                    interfaceCellType = VTK_POLYGON;
+                    // Mats[m].cellTypes.push_back( VTK_POLYGON );
+                  }
 
-          //  create output cell
-          if (interfaceCellType != VTK_EMPTY_CELL)
-          {
+                  // NB: Remaining volume is a convex point set
+                  // IMPORTANT NOTE: next iteration cell cannot be entirely built right now.
+                  // in this particular case we'll finish it at the end of the material loop.
+                  // If no other material remains to be processed, then skip this step.
+                  if (mi < (nmat - 1) && processedEfectiveMat < nEffectiveMat)
+                  {
+                    nextCell.type = VTK_CONVEX_POINT_SET;
+                    nextCell.np = nInterfaceEdges + nOutsidePoints;
+                    vtkcell = cpsCell;
+                    vtkcell->Points->Reset();
+                    vtkcell->PointIds->Reset();
+                    vtkcell->Points->SetNumberOfPoints(nextCell.np);
+                    vtkcell->PointIds->SetNumberOfIds(nextCell.np);
+                    for (int i = 0; i < nextCell.np; i++)
+                    {
+                      vtkcell->PointIds->SetId(i, i);
+                    }
+                    // nf, ntri and triangulation have to be computed later on, when point
+                    // coords are computed
+                    nextCell.needTriangulation = true;
+                  }
 
-            // set type of cell
-            Mats[m].cellTypes.push_back(interfaceCellType);
+                  for (int i = 0; i < nInterfaceEdges; i++)
+                  {
+                    vtkIdType id = -(int)(prevPointsMap.size() + 1);
+                    DBG_ASSERT((-id - 1) == prevPointsMap.size());
+                    // Interpolated points will be added consecutively
+                    prevPointsMap.emplace_back(m, Pieces[m].pointCount + i);
+                    nextCell.pointIds[i] = id;
+                  }
+                  for (int i = 0; i < nOutsidePoints; i++)
+                  {
+                    nextCell.pointIds[nInterfaceEdges + i] = cell.pointIds[outsidePointIds[i]];
+                  }
+                }
 
-            // interpolate point values for cut edges
-            for (int e = 0; e < nInterfaceEdges; e++)
-            {
-              double t = interfaceWeights[e];
-              for (int p = 0; p < nPointData; p++)
-              {
-                double v0[16];
-                double v1[16];
-                int nc = Mats[m].outPointArrays[p]->GetNumberOfComponents();
-                int ep0 = cell.pointIds[interfaceEdges[e * 2 + 0]];
-                int ep1 = cell.pointIds[interfaceEdges[e * 2 + 1]];
-                GET_POINT_DATA(p, ep0, v0);
-                GET_POINT_DATA(p, ep1, v1);
-                for (int c = 0; c < nc; c++)
+                // check correctness of next cell's point ids
+                for (int i = 0; i < nextCell.np; i++)
                 {
-                  interpolatedValues[e * pointDataComponents + pointArrayOffset[p] + c] =
-                    v0[c] + t * (v1[c] - v0[c]);
+                  DBG_ASSERT((nextCell.pointIds[i] < 0 &&
+                               (-nextCell.pointIds[i] - 1) < prevPointsMap.size()) ||
+                    (nextCell.pointIds[i] >= 0 && nextCell.pointIds[i] < nPoints));
                 }
-              }
-            }
+              } // End 3D case
 
-            // copy point values
-            for (int e = 0; e < nInterfaceEdges; e++)
-            {
-              for (int a = 0; a < nPointData; a++)
-              {
-                DBG_ASSERT(nptId == Mats[m].outPointArrays[a]->GetNumberOfTuples());
-                Mats[m].outPointArrays[a]->InsertNextTuple(
-                  interpolatedValues + e * pointDataComponents + pointArrayOffset[a]);
-              }
-            }
-            int pointsCopied = 0;
-            int prevMatInterfToBeAdded = 0;
-            if (this->FillMaterial)
-            {
-              for (int p = 0; p < nInsidePoints; p++)
+              //  create output cell
+              if (interfaceCellType != VTK_EMPTY_CELL)
               {
-                vtkIdType ptId = cell.pointIds[insidePointIds[p]];
-                if (ptId >= 0)
+                vtkYoungsMaterialInterface_Piece& piece = Pieces[m];
+                if (piece.outPointArrays.empty())
+                {
+                  vtkYoungsMaterialInterface_NewPointArrays(
+                    nPointData, inPointArrays, piece.outPointArrays);
+                }
+
+                // set type of cell
+                piece.cellTypes.push_back(interfaceCellType);
+                piece.cellIds.push_back(ci);
+
+                // interpolate point values for cut edges
+                for (int e = 0; e < nInterfaceEdges; e++)
                 {
-                  if (Mats[m].pointMap[ptId] == -1)
+                  double t = interfaceWeights[e];
+                  for (int p = 0; p < nPointData; p++)
                   {
-                    vtkIdType nptId = Mats[m].pointCount + nInterfaceEdges + pointsCopied;
-                    Mats[m].pointMap[ptId] = nptId;
-                    pointsCopied++;
-                    for (int a = 0; a < nPointData; a++)
+                    double v0[16];
+                    double v1[16];
+                    int nc = piece.outPointArrays[p]->GetNumberOfComponents();
+                    int ep0 = cell.pointIds[interfaceEdges[e * 2 + 0]];
+                    int ep1 = cell.pointIds[interfaceEdges[e * 2 + 1]];
+                    GET_POINT_DATA(p, ep0, v0);
+                    GET_POINT_DATA(p, ep1, v1);
+                    for (int c = 0; c < nc; c++)
                     {
-                      DBG_ASSERT(nptId == Mats[m].outPointArrays[a]->GetNumberOfTuples());
-                      double tuple[16];
-                      GET_POINT_DATA(a, ptId, tuple);
-                      Mats[m].outPointArrays[a]->InsertNextTuple(tuple);
+                      interpolatedValues[e * pointDataComponents + pointArrayOffset[p] + c] =
+                        v0[c] + t * (v1[c] - v0[c]);
                     }
                   }
                 }
-                else
+
+                // copy point values
+                for (int e = 0; e < nInterfaceEdges; e++)
                 {
-                  prevMatInterfToBeAdded++;
+                  for (int a = 0; a < nPointData; a++)
+                  {
+                    piece.outPointArrays[a]->InsertNextTuple(
+                      interpolatedValues.data() + e * pointDataComponents + pointArrayOffset[a]);
+                  }
                 }
-              }
-            }
 
-            // Populate connectivity array and add extra points from previous
-            // edge intersections that are used but not inserted yet
-            int prevMatInterfAdded = 0;
-            Mats[m].cells.push_back(nOutCellPoints);
-            Mats[m].cellArrayCount++;
-            for (int p = 0; p < nOutCellPoints; ++p)
-            {
-              int nptId;
-              int pointIndex = outCellPointIds[p];
-              if (pointIndex >= 0)
-              {
-                // An original point is encountered (not an edge intersection)
-                DBG_ASSERT(pointIndex >= 0 && pointIndex < cell.np);
-                vtkIdType ptId = cell.pointIds[pointIndex];
-                if (ptId >= 0)
+                // Input points inside the material are shared with other cells,
+                // they are numbered when the pieces are merged
+                int inputPointsUsed = 0;
+                if (this->FillMaterial)
+                {
+                  for (int p = 0; p < nInsidePoints; p++)
+                  {
+                    vtkIdType ptId = cell.pointIds[insidePointIds[p]];
+                    if (ptId >= 0)
+                    {
+                      piece.inputPoints.push_back(ptId);
+                      inputPointsUsed++;
+                    }
+                  }
+                }
+
+                // Populate connectivity array and add extra points from previous
+                // edge intersections that are used but not inserted yet
+                int prevMatInterfAdded = 0;
+                piece.cells.push_back(nOutCellPoints);
+                for (int p = 0; p < nOutCellPoints; ++p)
                 {
-                  // Interface from a previous iteration
-                  DBG_ASSERT(ptId >= 0 && ptId < nPoints);
-                  nptId = Mats[m].pointMap[ptId];
+                  vtkIdType nptId;
+                  int pointIndex = outCellPointIds[p];
+                  if (pointIndex >= 0)
+                  {
+                    // An original point is encountered (not an edge intersection)
+                    DBG_ASSERT(pointIndex >= 0 && pointIndex < cell.np);
+                    vtkIdType ptId = cell.pointIds[pointIndex];
+                    if (ptId >= 0)
+                    {
+                      DBG_ASSERT(ptId >= 0 && ptId < nPoints);
+                      nptId = -ptId - 1;
+                    }
+                    else
+                    {
+                      // Interface from a previous iteration
+                      nptId = nInterfaceEdges + prevMatInterfAdded;
+                      prevMatInterfAdded++;
+                      for (int a = 0; a < nPointData; a++)
+                      {
+                        double tuple[16];
+                        GET_POINT_DATA(a, ptId, tuple);
+                        piece.outPointArrays[a]->InsertNextTuple(tuple);
+                      }
+                    }
+                  }
+                  else
+                  {
+                    int interfaceIndex = -pointIndex - 1;
+                    DBG_ASSERT(interfaceIndex >= 0 && interfaceIndex < nInterfaceEdges);
+                    nptId = interfaceIndex;
+                  }
+                  piece.cells.push_back(nptId);
                 }
-                else
+
+                piece.cellPointCounts.push_back(nInterfaceEdges);
+                piece.cellPointCounts.push_back(inputPointsUsed);
+                piece.cellPointCounts.push_back(prevMatInterfAdded);
+                piece.pointCount += nInterfaceEdges + prevMatInterfAdded;
+
+                // Populate next iteration cell point coordinates
+                for (int i = 0; i < nextCell.np; i++)
                 {
-                  nptId = Mats[m].pointCount + nInterfaceEdges + pointsCopied + prevMatInterfAdded;
-                  prevMatInterfAdded++;
-                  for (int a = 0; a < nPointData; a++)
+                  DBG_ASSERT((nextCell.pointIds[i] < 0 &&
+                               (-nextCell.pointIds[i] - 1) < prevPointsMap.size()) ||
+                    (nextCell.pointIds[i] >= 0 && nextCell.pointIds[i] < nPoints));
+                  GET_POINT_DATA((nPointData - 1), nextCell.pointIds[i], nextCell.points[i]);
+                }
+
+                // for the convex point set, we need to first compute point coords before
+                // triangulation (no fixed topology)
+                if (nextCell.needTriangulation && mi < (nmat - 1) &&
+                  processedEfectiveMat < nEffectiveMat)
+                {
+                  // the convex point set is triangulated from its point coordinates
+                  for (int i = 0; i < nextCell.np; i++)
+                  {
+                    vtkcell->Points->SetPoint(i, nextCell.points[i]);
+                  }
+                  vtkcell->Initialize();
+                  nextCell.nf = vtkcell->GetNumberOfFaces();
+                  if (nextCell.dim == 3)
+                  {
+                    vtkCell3D* cell3D = vtkCell3D::SafeDownCast(vtkcell);
+                    nextCell.nEdges = vtkcell->GetNumberOfEdges();
+                    for (int i = 0; i < nextCell.nEdges; i++)
+                    {
+                      const vtkIdType* edgePoints;
+                      cell3D->GetEdgePoints(i, edgePoints);
+                      nextCell.edges[i][0] = edgePoints[0];
+                      DBG_ASSERT(nextCell.edges[i][0] >= 0 && nextCell.edges[i][0] < nextCell.np);
+                      nextCell.edges[i][1] = edgePoints[1];
+                      DBG_ASSERT(nextCell.edges[i][1] >= 0 && nextCell.edges[i][1] < nextCell.np);
+                    }
+                  }
+                  nextCell.triangulationOk = (vtkcell->Triangulate(ci, ptIds, pts) != 0);
+                  nextCell.ntri = 0;
+                  if (nextCell.triangulationOk)
                   {
-                    DBG_ASSERT(nptId == Mats[m].outPointArrays[a]->GetNumberOfTuples());
-                    double tuple[16];
-                    GET_POINT_DATA(a, ptId, tuple);
-                    Mats[m].outPointArrays[a]->InsertNextTuple(tuple);
+                    nextCell.ntri = ptIds->GetNumberOfIds() / (nextCell.dim + 1);
+                    for (int i = 0; i < (nextCell.ntri * (nextCell.dim + 1)); i++)
+                    {
+                      vtkIdType j = ptIds->GetId(i); // cell ids have been set with local ids
+                      DBG_ASSERT(j >= 0 && j < nextCell.np);
+                      nextCell.triangulation[i] = j;
+                    }
                   }
+                  else
+                  {
+                    info.TriangulationFailed++;
+                    RANGE_WARNING(<< "Triangulation failed. Info: cell " << ci << ", material "
+                                   << mi << ", np=" << nextCell.np << ", nf=" << nextCell.nf
+                                   << ", ne=" << nextCell.nEdges << "\n");
+                  }
+                  nextCell.needTriangulation = false;
+                  vtkcell = nullptr;
                 }
-              }
+
+                // switch to next cell
+                cell = nextCell;
+
+              } // end of 'interface was found'
+
               else
               {
-                int interfaceIndex = -pointIndex - 1;
-                DBG_ASSERT(interfaceIndex >= 0 && interfaceIndex < nInterfaceEdges);
-                nptId = Mats[m].pointCount + interfaceIndex;
+                vtkcell = nullptr;
               }
-              DBG_ASSERT(nptId >= 0 &&
-                nptId <
-                  (Mats[m].pointCount + nInterfaceEdges + pointsCopied + prevMatInterfToBeAdded));
-              Mats[m].cells.push_back(nptId);
-              Mats[m].cellArrayCount++;
-            }
 
-            Mats[m].pointCount += nInterfaceEdges + pointsCopied + prevMatInterfAdded;
+            } // end of 'cell is ok'
 
-            // Copy cell arrays
-            for (int a = 0; a < nCellData; a++)
-            {
-              Mats[m].outCellArrays[a]->InsertNextTuple(inCellArrays[a]->GetTuple(ci));
-            }
-            Mats[m].cellCount++;
+            //                      else // cell is ignored
+            //                      {
+            //                              //vtkWarningMacro(<<"ignoring cell #"<<ci<<", m="<<m<<",
+            //                              mi="<<mi<<", frac="<<fraction<<"\n");
+            //                      }
 
-            // Check for equivalence between counters and container sizes
-            DBG_ASSERT(Mats[m].cellCount == Mats[m].cellTypes.size());
-            DBG_ASSERT(Mats[m].cellArrayCount == Mats[m].cells.size());
+            // update reference volume
+            referenceVolume -= fraction;
 
-            // Populate next iteration cell point coordinates
-            for (int i = 0; i < nextCell.np; i++)
+          } // for materials
+
+        } // for cells
+      } // for ranges
+    });
+
+    // report the messages of the ranges in the order of the cells
+    for (const vtkYoungsMaterialInterface_RangeInfo& info : rangeInfos)
+    {
+      for (const std::pair<bool, std::string>& message : info.Messages)
+      {
+        if (message.first)
+        {
+          vtkWarningMacro(<< message.second);
+        }
+        else
+        {
+          vtkDebugMacro(<< message.second);
+        }
+      }
+      debugStats_PrimaryTriangulationfailed += info.PrimaryTriangulationFailed;
+      debugStats_Triangulationfailed += info.TriangulationFailed;
+      debugStats_NullNormal += info.NullNormal;
+      debugStats_NoInterfaceFound += info.NoInterfaceFound;
+    }
+
+    // finish output creation
+    // The materials are merged concurrently. The input points of a material
+    // are numbered by the first cell using them, in the order of the cells.
+    std::vector<vtkSmartPointer<vtkUnstructuredGrid>> ugOutputs(nmat);
+    vtkSMPTools::For(0, nmat, 1, [&](vtkIdType firstMat, vtkIdType endMat) {
+      for (vtkIdType m = firstMat; m < endMat; ++m)
+      {
+        vtkIdType cellCount = 0;
+        vtkIdType cellArrayCount = 0;
+        vtkIdType numberOfPoints = 0;
+        for (vtkIdType r = 0; r < nRanges; ++r)
+        {
+          const vtkYoungsMaterialInterface_Piece& piece = pieces[r * nmat + m];
+          cellCount += static_cast<vtkIdType>(piece.cellTypes.size());
+          cellArrayCount += static_cast<vtkIdType>(piece.cells.size());
+          numberOfPoints += piece.pointCount + static_cast<vtkIdType>(piece.inputPoints.size());
+        }
+        if (cellCount == 0)
+        {
+          continue;
+        }
+
+        std::vector<vtkSmartPointer<vtkDataArray>> outPointArrays;
+        vtkYoungsMaterialInterface_NewPointArrays(nPointData, inPointArrays, outPointArrays);
+        for (int i = 0; i < nPointData; i++)
+        {
+          outPointArrays[i]->Allocate(numberOfPoints * outPointArrays[i]->GetNumberOfComponents());
+        }
+        vtkNew<vtkIdTypeArray> cellArrayData;
+        vtkIdType* cellArrayDataPtr = cellArrayData->WritePointer(0, cellArrayCount);
+        vtkNew<vtkUnsignedCharArray> cellTypes;
+        unsigned char* cellTypesPtr = cellTypes->WritePointer(0, cellCount);
+        vtkNew<vtkIdList> cellIds;
+        cellIds->SetNumberOfIds(cellCount);
+        std::vector<vtkIdType> pointMap(nPoints, -1);
+
+        vtkIdType pointCount = 0;
+        vtkIdType cellIndex = 0;
+        for (vtkIdType r = 0; r < nRanges; ++r)
+        {
+          vtkYoungsMaterialInterface_Piece& piece = pieces[r * nmat + m];
+          vtkIdType piecePointId = 0;
+          const vtkIdType* inputPoint = piece.inputPoints.data();
+          const vtkIdType* cellPoint = piece.cells.data();
+          for (size_t c = 0; c < piece.cellTypes.size(); ++c, ++cellIndex)
+          {
+            const int nInterfacePoints = piece.cellPointCounts[3 * c];
+            const int nInputPoints = piece.cellPointCounts[3 * c + 1];
+            const int nPrevMatPoints = piece.cellPointCounts[3 * c + 2];
+
+            // points of the interface, then input points used for the first
+            // time, then points from the interfaces of previous materials
+            for (int a = 0; a < nPointData && nInterfacePoints > 0; a++)
             {
-              DBG_ASSERT(
-                (nextCell.pointIds[i] < 0 && (-nextCell.pointIds[i] - 1) < prevPointsMap.size()) ||
-                (nextCell.pointIds[i] >= 0 && nextCell.pointIds[i] < nPoints));
-              GET_POINT_DATA((nPointData - 1), nextCell.pointIds[i], nextCell.points[i]);
+              outPointArrays[a]->InsertTuples(
+                pointCount, nInterfacePoints, piecePointId, piece.outPointArrays[a]);
             }
-
-            // for the convex point set, we need to first compute point coords before triangulation
-            // (no fixed topology)
-            if (nextCell.needTriangulation && mi < (nmat - 1) &&
-              processedEfectiveMat < nEffectiveMat)
+            int pointsCopied = 0;
+            for (int p = 0; p < nInputPoints; p++)
             {
-              //                       for(int myi = 0;myi<nextCell.np;myi++)
-              //                       {
-              //                                cerr<<"p["<<myi<<"]=("<<nextCell.points[myi][0]<<','<<nextCell.points[myi][1]<<','<<nextCell.points[myi][2]<<")
-              //                                ";
-              //                       }
-              //                       cerr<<endl;
-
-              vtkcell->Initialize();
-              nextCell.nf = vtkcell->GetNumberOfFaces();
-              if (nextCell.dim == 3)
+              vtkIdType ptId = *inputPoint++;
+              if (pointMap[ptId] == -1)
               {
-                vtkCell3D* cell3D = vtkCell3D::SafeDownCast(vtkcell);
-                nextCell.nEdges = vtkcell->GetNumberOfEdges();
-                for (int i = 0; i < nextCell.nEdges; i++)
+                vtkIdType nptId = pointCount + nInterfacePoints + pointsCopied;
+                pointMap[ptId] = nptId;
+                pointsCopied++;
+                for (int a = 0; a < nPointData - 1; a++)
                 {
-                  const vtkIdType* edgePoints;
-                  cell3D->GetEdgePoints(i, edgePoints);
-                  nextCell.edges[i][0] = edgePoints[0];
-                  DBG_ASSERT(nextCell.edges[i][0] >= 0 && nextCell.edges[i][0] < nextCell.np);
-                  nextCell.edges[i][1] = edgePoints[1];
-                  DBG_ASSERT(nextCell.edges[i][1] >= 0 && nextCell.edges[i][1] < nextCell.np);
+                  outPointArrays[a]->InsertTuple(nptId, ptId, inPointArrays[a]);
                 }
+                double x[3];
+                input->GetPoint(ptId, x);
+                outPointArrays[nPointData - 1]->InsertTuple(nptId, x);
               }
-              nextCell.triangulationOk = (vtkcell->Triangulate(ci, ptIds, pts) != 0);
-              nextCell.ntri = 0;
-              if (nextCell.triangulationOk)
+            }
+            for (int a = 0; a < nPointData && nPrevMatPoints > 0; a++)
+            {
+              outPointArrays[a]->InsertTuples(pointCount + nInterfacePoints + pointsCopied,
+                nPrevMatPoints, piecePointId + nInterfacePoints, piece.outPointArrays[a]);
+            }
+
+            // connectivity
+            const vtkIdType nOutCellPoints = *cellPoint++;
+            *cellArrayDataPtr++ = nOutCellPoints;
+            for (vtkIdType p = 0; p < nOutCellPoints; p++)
+            {
+              vtkIdType nptId = *cellPoint++;
+              if (nptId < 0)
               {
-                nextCell.ntri = ptIds->GetNumberOfIds() / (nextCell.dim + 1);
-                for (int i = 0; i < (nextCell.ntri * (nextCell.dim + 1)); i++)
-                {
-                  vtkIdType j = ptIds->GetId(i); // cell ids have been set with local ids
-                  DBG_ASSERT(j >= 0 && j < nextCell.np);
-                  nextCell.triangulation[i] = j;
-                }
+                nptId = pointMap[-nptId - 1];
+              }
+              else if (nptId < nInterfacePoints)
+              {
+                nptId += pointCount;
               }
               else
               {
-                debugStats_Triangulationfailed++;
-                vtkWarningMacro(<< "Triangulation failed. Info: cell " << ci << ", material " << mi
-                                << ", np=" << nextCell.np << ", nf=" << nextCell.nf
-                                << ", ne=" << nextCell.nEdges << "\n");
+                nptId += pointCount + pointsCopied;
               }
-              nextCell.needTriangulation = false;
-              vtkcell = nullptr;
+              *cellArrayDataPtr++ = nptId;
             }
+            cellTypesPtr[cellIndex] = piece.cellTypes[c];
+            cellIds->SetId(cellIndex, piece.cellIds[c]);
 
-            // switch to next cell
-            cell = nextCell;
-
-          } // end of 'interface was found'
-
-          else
-          {
-            vtkcell = nullptr;
+            pointCount += nInterfacePoints + pointsCopied + nPrevMatPoints;
+            piecePointId += nInterfacePoints + nPrevMatPoints;
           }
+          piece = vtkYoungsMaterialInterface_Piece();
+        }
 
-        } // end of 'cell is ok'
-
-        //                      else // cell is ignored
-        //                      {
-        //                              //vtkWarningMacro(<<"ignoring cell #"<<ci<<", m="<<m<<",
-        //                              mi="<<mi<<", frac="<<fraction<<"\n");
-        //                      }
-
-        // update reference volume
-        referenceVolume -= fraction;
-
-      } // for materials
+        vtkSmartPointer<vtkUnstructuredGrid> ugOutput = vtkSmartPointer<vtkUnstructuredGrid>::New();
 
-    } // for cells
-    delete[] pointArrayOffset;
-    delete[] inPointArrays;
-    delete[] inCellArrays;
+        // set points
+        outPointArrays[nPointData - 1]->Squeeze();
+        vtkNew<vtkPoints> points;
+        points->SetDataTypeToDouble();
+        points->SetData(outPointArrays[nPointData - 1]);
+        ugOutput->SetPoints(points);
 
-    ptIds->Delete();
-    pts->Delete();
-    cpsCell->Delete();
-    delete[] interpolatedValues;
-    delete[] matOrdering;
+        // set cell connectivity and types
+        vtkNew<vtkCellArray> cellArray;
+        cellArray->AllocateExact(cellCount, cellArrayCount - cellCount);
+        cellArray->ImportLegacyFormat(cellArrayData);
+        ugOutput->SetCells(cellTypes, cellArray);
 
-    // finish output creation
-    //       output->SetNumberOfBlocks( nmat );
-    for (int m = 0; m < nmat; m++)
-    {
-      if (Mats[m].cellCount > 0 && Mats[m].pointCount > 0)
-      {
-        vtkDebugMacro(<< "Mat #" << m << " : cellCount=" << Mats[m].cellCount << ", numberOfCells="
-                      << Mats[m].numberOfCells << ", pointCount=" << Mats[m].pointCount
-                      << ", numberOfPoints=" << Mats[m].numberOfPoints << "\n");
-      }
-
-      delete[] Mats[m].pointMap;
-
-      vtkSmartPointer<vtkUnstructuredGrid> ugOutput = vtkSmartPointer<vtkUnstructuredGrid>::New();
-
-      // set points
-      Mats[m].outPointArrays[nPointData - 1]->Squeeze();
-      vtkPoints* points = vtkPoints::New();
-      points->SetDataTypeToDouble();
-      points->SetNumberOfPoints(Mats[m].pointCount);
-      points->SetData(Mats[m].outPointArrays[nPointData - 1]);
-      Mats[m].outPointArrays[nPointData - 1]->Delete();
-      ugOutput->SetPoints(points);
-      points->Delete();
-
-      // set cell connectivity
-      vtkIdTypeArray* cellArrayData = vtkIdTypeArray::New();
-      cellArrayData->SetNumberOfValues(Mats[m].cellArrayCount);
-      vtkIdType* cellArrayDataPtr = cellArrayData->WritePointer(0, Mats[m].cellArrayCount);
-      for (vtkIdType i = 0; i < Mats[m].cellArrayCount; i++)
-        cellArrayDataPtr[i] = Mats[m].cells[i];
-
-      vtkCellArray* cellArray = vtkCellArray::New();
-      cellArray->AllocateExact(Mats[m].cellCount, Mats[m].cellArrayCount - Mats[m].cellCount);
-      cellArray->ImportLegacyFormat(cellArrayData);
-      cellArrayData->Delete();
-
-      // set cell types
-      vtkUnsignedCharArray* cellTypes = vtkUnsignedCharArray::New();
-      cellTypes->SetNumberOfValues(Mats[m].cellCount);
-      unsigned char* cellTypesPtr = cellTypes->WritePointer(0, Mats[m].cellCount);
-      for (vtkIdType i = 0; i < Mats[m].cellCount; i++)
-        cellTypesPtr[i] = Mats[m].cellTypes[i];
-
-      // attach connectivity arrays to data set
-      ugOutput->SetCells(cellTypes, cellArray);
-      cellArray->Delete();
-      cellTypes->Delete();
-
-      // attach point arrays
-      for (int i = 0; i < nPointData - 1; i++)
-      {
-        Mats[m].outPointArrays[i]->Squeeze();
-        ugOutput->GetPointData()->AddArray(Mats[m].outPointArrays[i]);
-        Mats[m].outPointArrays[i]->Delete();
-      }
-
-      // attach cell arrays
-      for (int i = 0; i < nCellData; i++)
-      {
-        Mats[m].outCellArrays[i]->Squeeze();
-        ugOutput->GetCellData()->AddArray(Mats[m].outCellArrays[i]);
-        Mats[m].outCellArrays[i]->Delete();
-      }
+        // attach point arrays
+        for (int i = 0; i < nPointData - 1; i++)
+        {
+          outPointArrays[i]->Squeeze();
+          ugOutput->GetPointData()->AddArray(outPointArrays[i]);
+        }
 
-      delete[] Mats[m].outCellArrays;
-      delete[] Mats[m].outPointArrays;
+        // attach cell arrays
+        for (int i = 0; i < nCellData; i++)
+        {
+          vtkSmartPointer<vtkDataArray> outCellArray =
+            vtk::TakeSmartPointer(vtkDataArray::CreateDataArray(inCellArrays[i]->GetDataType()));
+          outCellArray->SetName(inCellArrays[i]->GetName());
+          outCellArray->SetNumberOfComponents(inCellArrays[i]->GetNumberOfComponents());
+          outCellArray->SetNumberOfTuples(cellCount);
+          inCellArrays[i]->GetTuples(cellIds, outCellArray);
+          ugOutput->GetCellData()->AddArray(outCellArray);
+        }
 
-      // activate attributes similarly to input
-      for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
-      {
-        vtkDataArray* attr = input->GetCellData()->GetAttribute(i);
-        if (attr != nullptr)
+        // activate attributes similarly to input
+        for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
         {
-          ugOutput->GetCellData()->SetActiveAttribute(attr->GetName(), i);
+          vtkDataArray* attr = input->GetCellData()->GetAttribute(i);
+          if (attr != nullptr)
+          {
+            ugOutput->GetCellData()->SetActiveAttribute(attr->GetName(), i);
+          }
         }
-      }
-      for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
-      {
-        vtkDataArray* attr = input->GetPointData()->GetAttribute(i);
-        if (attr != nullptr)
+        for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
         {
-          ugOutput->GetPointData()->SetActiveAttribute(attr->GetName(), i);
+          vtkDataArray* attr = input->GetPointData()->GetAttribute(i);
+          if (attr != nullptr)
+          {
+            ugOutput->GetPointData()->SetActiveAttribute(attr->GetName(), i);
+          }
         }
+        ugOutputs[m] = ugOutput;
       }
+    });
 
-      // add material data set to multiblock output
-      if (ugOutput && ugOutput->GetNumberOfCells() > 0)
+    delete[] pointArrayOffset;
+    delete[] inPointArrays;
+    delete[] inCellArrays;
+    delete[] Mats;
+
+    // add material data sets to multiblock output
+    for (int m = 0; m < nmat; m++)
+    {
+      if (ugOutputs[m])
       {
+        vtkDebugMacro(<< "Mat #" << m << " : cellCount=" << ugOutputs[m]->GetNumberOfCells()
+                      << ", pointCount=" << ugOutputs[m]->GetNumberOfPoints() << "\n");
         int domain = inputsPerMaterial[m];
-        outputBlocks[domain * nmat + m] = ugOutput;
+        outputBlocks[domain * nmat + m] = ugOutputs[m];
         ++inputsPerMaterial[m];
       }
     }
-    delete[] Mats;
   } // Iterate over input blocks
 
   delete[] inputsPerMaterial;
@@ -1573,6 +1658,8 @@ int vtkYoungsMaterialInterface::RequestData(vtkInformation* vtkNotUsed(request),
 }
 
 #undef GET_POINT_DATA
+#undef RANGE_WARNING
+#undef RANGE_DEBUG
 
 /* ------------------------------------------------------------------------------------------
    --- Low level computations including interface placement and intersection line/polygon ---
@@ -0,0 +1,57 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOriginalCellIdsCommon.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef TestOriginalCellIdsCommon_h
+#define TestOriginalCellIdsCommon_h
+
+#include "vtkCellData.h"
+#include "vtkDataSet.h"
+#include "vtkIdTypeArray.h"
+
+#include <iostream>
+
+namespace
+{
+// Check that each face of a surface lies on the boundary of the cell it was
+// extracted from, as given by its vtkOriginalCellIds.
+bool FacesLieOnOriginalCells(vtkDataSet* output, vtkDataSet* input)
+{
+  vtkIdTypeArray* originalIds =
+    vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray("vtkOriginalCellIds"));
+  if (!originalIds)
+  {
+    std::cerr << "The faces have no vtkOriginalCellIds" << std::endl;
+    return false;
+  }
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    double faceBounds[6], cellBounds[6];
+    output->GetCellBounds(cellId, faceBounds);
+    input->GetCellBounds(originalIds->GetValue(cellId), cellBounds);
+    for (int i = 0; i < 3; ++i)
+    {
+      if (faceBounds[2 * i] < cellBounds[2 * i] - 1.0e-6 ||
+        faceBounds[2 * i + 1] > cellBounds[2 * i + 1] + 1.0e-6)
+      {
+        std::cerr << "Face " << cellId << " does not lie on its original cell "
+                  << originalIds->GetValue(cellId) << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+#endif
@@ -43,6 +43,7 @@
 #include "vtkActor.h"
 #include "vtkCellData.h"
 #include "vtkCellType.h"
+#include "vtkCellTypeSource.h"
 #include "vtkCellTypes.h"
 #include "vtkLookupTable.h"
 #include "vtkPolyData.h"
@@ -51,6 +52,7 @@
 #include "vtkRenderWindowInteractor.h"
 #include "vtkRenderer.h"
 #include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridGeometryFilter.h"
 #include "vtkXMLUnstructuredGridReader.h"
 #include <cassert>
@@ -74,7 +76,6 @@
 #include "vtkFloatArray.h"
 #include "vtkHexagonalPrism.h"
 #include "vtkHexahedron.h"
-#include "vtkIdTypeArray.h"
 #include "vtkLine.h"
 #include "vtkPentagonalPrism.h"
 #include "vtkPixel.h"
@@ -99,7 +100,6 @@
 #include "vtkTriangle.h"
 #include "vtkTriangleStrip.h"
 #include "vtkUnsignedCharArray.h"
-#include "vtkUnstructuredGrid.h"
 #include "vtkVertex.h"
 #include "vtkVoxel.h"
 #include "vtkWedge.h"
@@ -113,8 +113,49 @@
 #include "vtkShrinkFilter.h"
 #endif
 
+#include "TestOriginalCellIdsCommon.h"
+
+namespace
+{
+// Extract the faces of 4x4x4 blocks of cells: they cover the 16 quads of each
+// side of the cube and the points on its boundary, and each face lies on the
+// cell it comes from.
+bool TestBlocksOfCells(int cellType, vtkIdType numberOfFaces, vtkIdType numberOfPoints)
+{
+  auto source = vtkSmartPointer<vtkCellTypeSource>::New();
+  source->SetCellType(cellType);
+  source->SetBlocksDimensions(4, 4, 4);
+  source->Update();
+  vtkUnstructuredGrid* input = source->GetOutput();
+
+  auto geom = vtkSmartPointer<vtkUnstructuredGridGeometryFilter>::New();
+  geom->SetInputData(input);
+  geom->PassThroughCellIdsOn();
+  geom->Update();
+  vtkUnstructuredGridBase* output = geom->GetOutput();
+  if (output->GetNumberOfCells() != numberOfFaces || output->GetNumberOfPoints() != numberOfPoints)
+  {
+    std::cerr << "Got " << output->GetNumberOfCells() << " faces and "
+              << output->GetNumberOfPoints() << " points from blocks of "
+              << vtkCellTypes::GetClassNameFromTypeId(cellType) << " instead of "
+              << numberOfFaces << " and " << numberOfPoints << std::endl;
+    return false;
+  }
+  return FacesLieOnOriginalCells(output, input);
+}
+}
+
 int TestUnstructuredGridGeometryFilter(int argc, char* argv[])
 {
+  if (!TestBlocksOfCells(VTK_HEXAHEDRON, 96, 98) || !TestBlocksOfCells(VTK_TETRA, 192, 98) ||
+    !TestBlocksOfCells(VTK_WEDGE, 128, 98) || !TestBlocksOfCells(VTK_PYRAMID, 96, 98) ||
+    !TestBlocksOfCells(VTK_QUADRATIC_TETRA, 192, 386) ||
+    !TestBlocksOfCells(VTK_QUADRATIC_HEXAHEDRON, 96, 290) ||
+    !TestBlocksOfCells(VTK_LAGRANGE_HEXAHEDRON, 96, 866))
+  {
+    return EXIT_FAILURE;
+  }
+
   // Standard rendering classes
   auto renderer = vtkSmartPointer<vtkRenderer>::New();
   auto renWin = vtkSmartPointer<vtkRenderWindow>::New();
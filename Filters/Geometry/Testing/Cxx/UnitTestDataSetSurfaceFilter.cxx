@@ -15,6 +15,8 @@
 
 #include "vtkAppendFilter.h"
 #include "vtkCellData.h"
+#include "vtkCellTypeSource.h"
+#include "vtkCellTypes.h"
 #include "vtkCommand.h"
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkDoubleArray.h"
@@ -38,6 +40,8 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include "TestOriginalCellIdsCommon.h"
+
 #include <map>
 #include <sstream>
 
@@ -148,6 +152,58 @@ int UnitTestDataSetSurfaceFilter(int, char*[])
       std::cout.flush();
     }
   }
+  {
+    // 4x4x4 blocks of cells: the external faces cover the 16 quads of each
+    // side of the cube, and the points on its boundary.
+    std::map<std::string, test::CellDescription> typesToProcess;
+    typesToProcess["Hexahedron"] = test::CellDescription(VTK_HEXAHEDRON, 96);
+    typesToProcess["Tetra"] = test::CellDescription(VTK_TETRA, 192);
+    typesToProcess["Wedge"] = test::CellDescription(VTK_WEDGE, 128);
+    typesToProcess["Pyramid"] = test::CellDescription(VTK_PYRAMID, 96);
+    typesToProcess["QuadraticTetra"] = test::CellDescription(VTK_QUADRATIC_TETRA, 768);
+    typesToProcess["QuadraticHexahedron"] = test::CellDescription(VTK_QUADRATIC_HEXAHEDRON, 576);
+    std::map<int, int> expectedPoints;
+    expectedPoints[VTK_QUADRATIC_TETRA] = 386;
+    expectedPoints[VTK_QUADRATIC_HEXAHEDRON] = 290;
+
+    std::map<std::string, test::CellDescription>::iterator it;
+    for (it = typesToProcess.begin(); it != typesToProcess.end(); ++it)
+    {
+      std::cout << "Testing (Blocks of " << it->first << ")...";
+      vtkSmartPointer<vtkCellTypeSource> source = vtkSmartPointer<vtkCellTypeSource>::New();
+      source->SetCellType(it->second.Type);
+      source->SetBlocksDimensions(4, 4, 4);
+      source->Update();
+      vtkSmartPointer<vtkDataSetSurfaceFilter> filter =
+        vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+      filter->SetInputConnection(source->GetOutputPort());
+      filter->PassThroughCellIdsOn();
+      filter->Update();
+      vtkPolyData* output = filter->GetOutput();
+      const int points =
+        expectedPoints.count(it->second.Type) ? expectedPoints[it->second.Type] : 98;
+      if (output->GetNumberOfCells() != it->second.Cells ||
+        output->GetNumberOfPoints() != points)
+      {
+        std::cout << " got " << output->GetNumberOfCells() << " cells and "
+                  << output->GetNumberOfPoints() << " points but expected " << it->second.Cells
+                  << " and " << points << " FAILED." << std::endl;
+        status++;
+      }
+      // Nonlinear cells are subdivided from intermediate faces, whose ids are
+      // passed instead of the ids of the input cells.
+      else if (vtkCellTypes::IsLinear(it->second.Type) &&
+        !FacesLieOnOriginalCells(output, source->GetOutput()))
+      {
+        std::cout << " faces are not on their original cells FAILED." << std::endl;
+        status++;
+      }
+      else
+      {
+        std::cout << " PASSED." << std::endl;
+      }
+    }
+  }
   {
     std::cout << "Testing default settings (PolyData)...";
     vtkSmartPointer<vtkDataSetSurfaceFilter> filter =
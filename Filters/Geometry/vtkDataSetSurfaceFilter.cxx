@@ -41,6 +41,7 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredData.h"
@@ -62,6 +63,7 @@
 #include <memory>
 #include <numeric>
 #include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -295,6 +297,445 @@ bool StructuredExecuteWithBlanking(
   return true;
 }
 
+/**
+ * Hash of the faces of the 3D cells of an unstructured grid, used to find the
+ * external faces. It works like the quad hash of vtkDataSetSurfaceFilter: a
+ * face goes in the bucket of its first point once reordered to start with its
+ * smallest point id, and a face matching a face of its bucket hides it instead
+ * of being inserted. The buckets are split in ranges of point ids filled
+ * concurrently with vtkSMPTools, each range visiting all the cells in order, so
+ * the visible faces and their order are the ones of the quad hash and do not
+ * depend on the number of threads.
+ */
+class vtkExternalFaceHash
+{
+public:
+  vtkExternalFaceHash(vtkIdType numPts)
+  {
+    const vtkIdType numPartitions = std::max<vtkIdType>(
+      1, std::min<vtkIdType>(vtkSMPTools::GetEstimatedNumberOfThreads(), numPts));
+    for (vtkIdType i = 0; i < numPartitions; ++i)
+    {
+      this->Partitions.emplace_back(numPts * i / numPartitions, numPts * (i + 1) / numPartitions);
+    }
+  }
+
+  // Whether the faces of cells of this type are inserted by InsertFaces().
+  static bool HasFixedFaces(int cellType)
+  {
+    switch (cellType)
+    {
+      case VTK_HEXAHEDRON:
+      case VTK_VOXEL:
+      case VTK_TETRA:
+      case VTK_PENTAGONAL_PRISM:
+      case VTK_HEXAGONAL_PRISM:
+      case VTK_PYRAMID:
+      case VTK_WEDGE:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Add the faces of the other 3D cells, in cell order, before InsertFaces().
+  void InsertQuad(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d, vtkIdType sourceId)
+  {
+    const vtkIdType ids[4] = { a, b, c, d };
+    this->AddFace(Quad, ids, 4, sourceId);
+  }
+  void InsertTri(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType sourceId)
+  {
+    const vtkIdType ids[3] = { a, b, c };
+    this->AddFace(Triangle, ids, 3, sourceId);
+  }
+  void InsertPolygon(const vtkIdType* ids, int numPts, vtkIdType sourceId)
+  {
+    this->AddFace(Polygon, ids, numPts, sourceId);
+  }
+
+  // Insert the faces of all the cells that are not hidden in the hash.
+  void InsertFaces(vtkUnstructuredGridBase* input, vtkUnsignedCharArray* ghostCells)
+  {
+    vtkSMPTools::For(0, static_cast<vtkIdType>(this->Partitions.size()), 1,
+      [&](vtkIdType begin, vtkIdType end) {
+        vtkNew<vtkIdList> ptIds;
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          this->InsertFaces(input, ghostCells, this->Partitions[i], ptIds);
+        }
+      });
+  }
+
+  void InitTraversal()
+  {
+    this->TraversalPartition = 0;
+    this->TraversalBucket = -1;
+    this->TraversalQuad = nullptr;
+  }
+
+  vtkFastGeomQuad* GetNextVisibleQuad()
+  {
+    while (this->TraversalPartition < this->Partitions.size())
+    {
+      Partition& partition = this->Partitions[this->TraversalPartition];
+      if (this->TraversalQuad)
+      {
+        this->TraversalQuad = this->TraversalQuad->Next;
+      }
+      while (!this->TraversalQuad &&
+        ++this->TraversalBucket < static_cast<vtkIdType>(partition.Heads.size()))
+      {
+        this->TraversalQuad = partition.Heads[this->TraversalBucket];
+      }
+      if (!this->TraversalQuad)
+      {
+        ++this->TraversalPartition;
+        this->TraversalBucket = -1;
+      }
+      else if (this->TraversalQuad->SourceId != -1)
+      {
+        return this->TraversalQuad;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  enum FaceKind
+  {
+    Triangle,
+    Quad,
+    Polygon
+  };
+
+  // The buckets of the point ids in [Begin, End).
+  struct Partition
+  {
+    Partition(vtkIdType begin, vtkIdType end)
+      : Begin(begin)
+      , End(end)
+      , Heads(end - begin, nullptr)
+      , BlockLength(std::max<vtkIdType>(50, (end - begin) / 2) * sizeofFastQuad(4))
+      , NextQuadIndex(0)
+    {
+    }
+
+    // Whether a point of the cell has its bucket in this partition.
+    bool HasBucket(vtkIdType npts, const vtkIdType* pts) const
+    {
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        if (pts[i] >= this->Begin && pts[i] < this->End)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void InsertQuad(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d, vtkIdType sourceId)
+    {
+      vtkIdType tmp;
+      // Reorder to get smallest id in a.
+      if (b < a && b < c && b < d)
+      {
+        tmp = a;
+        a = b;
+        b = c;
+        c = d;
+        d = tmp;
+      }
+      else if (c < a && c < b && c < d)
+      {
+        tmp = a;
+        a = c;
+        c = tmp;
+        tmp = b;
+        b = d;
+        d = tmp;
+      }
+      else if (d < a && d < b && d < c)
+      {
+        tmp = a;
+        a = d;
+        d = c;
+        c = b;
+        b = tmp;
+      }
+      const vtkIdType ids[4] = { a, b, c, d };
+      this->InsertFace(Quad, ids, 4, sourceId);
+    }
+
+    void InsertTri(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType sourceId)
+    {
+      vtkIdType tmp;
+      // Reorder to get smallest id in a.
+      if (b < a && b < c)
+      {
+        tmp = a;
+        a = b;
+        b = c;
+        c = tmp;
+      }
+      else if (c < a && c < b)
+      {
+        tmp = a;
+        a = c;
+        c = b;
+        b = tmp;
+      }
+      // We can't put the second smallest in b because it might change the order
+      // of the vertices in the final triangle.
+      const vtkIdType ids[3] = { a, b, c };
+      this->InsertFace(Triangle, ids, 3, sourceId);
+    }
+
+    void InsertPolygon(const vtkIdType* ids, int numPts, vtkIdType sourceId)
+    {
+      // sanity check
+      if (numPts == 0)
+      {
+        return;
+      }
+      // find the index to the smallest id
+      int offset = 0;
+      for (int i = 0; i < numPts; i++)
+      {
+        if (ids[i] < ids[offset])
+        {
+          offset = i;
+        }
+      }
+      // copy ids into ordered array with smallest id first
+      this->Tab.resize(numPts);
+      for (int i = 0; i < numPts; i++)
+      {
+        this->Tab[i] = ids[(offset + i) % numPts];
+      }
+      this->InsertFace(Polygon, this->Tab.data(), numPts, sourceId);
+    }
+
+    // Insert a face starting with its smallest point id, or hide the first
+    // face of its bucket it matches. The tests are the ones of the quad hash
+    // for faces of the given kind.
+    void InsertFace(FaceKind kind, const vtkIdType* ids, int numPts, vtkIdType sourceId)
+    {
+      if (ids[0] < this->Begin || ids[0] >= this->End)
+      {
+        return;
+      }
+      vtkFastGeomQuad** end = &this->Heads[ids[0] - this->Begin];
+      for (vtkFastGeomQuad* quad = *end; quad; quad = *end)
+      {
+        const vtkIdType* pts = quad->ptArray;
+        bool match;
+        switch (kind)
+        {
+          case Quad:
+            // c should be independent of point order, check both orders for b and d.
+            match = quad->numPts == 4 && ids[2] == pts[2] &&
+              ((ids[1] == pts[1] && ids[3] == pts[3]) || (ids[1] == pts[3] && ids[3] == pts[1]));
+            break;
+          case Triangle:
+            match = quad->numPts == 3 &&
+              ((ids[1] == pts[1] && ids[2] == pts[2]) || (ids[1] == pts[2] && ids[2] == pts[1]));
+            break;
+          default:
+            match = numPts == quad->numPts && ids[0] == pts[0];
+            if (match && numPts > 1 && ids[1] == pts[1])
+            {
+              // if the first two points match loop through forwards
+              // checking all points
+              match = std::equal(ids + 2, ids + numPts, pts + 2);
+            }
+            else
+            {
+              // check if the points go in the opposite direction
+              for (int i = 1; match && i < numPts; ++i)
+              {
+                match = ids[numPts - i] == pts[i];
+              }
+            }
+            break;
+        }
+        if (match)
+        {
+          // Hide any face shared by two or more cells.
+          quad->SourceId = -1;
+          return;
+        }
+        end = &quad->Next;
+      }
+
+      vtkFastGeomQuad* quad = this->NewFastGeomQuad(numPts);
+      quad->Next = nullptr;
+      quad->SourceId = sourceId;
+      std::copy(ids, ids + numPts, quad->ptArray);
+      *end = quad;
+    }
+
+    // Like vtkDataSetSurfaceFilter::NewFastGeomQuad(), with blocks owned by
+    // the partition.
+    vtkFastGeomQuad* NewFastGeomQuad(int numPts)
+    {
+      const vtkIdType polySize = sizeofFastQuad(numPts);
+      if (this->Blocks.empty() || this->NextQuadIndex + polySize > this->BlockLength)
+      {
+        this->Blocks.emplace_back(new unsigned char[std::max(this->BlockLength, polySize)]);
+        this->NextQuadIndex = 0;
+      }
+      vtkFastGeomQuad* q =
+        reinterpret_cast<vtkFastGeomQuad*>(this->Blocks.back().get() + this->NextQuadIndex);
+      q->numPts = numPts;
+      q->ptArray = reinterpret_cast<vtkIdType*>(q) + (polySize / sizeof(vtkIdType) - numPts);
+      this->NextQuadIndex += polySize;
+      return q;
+    }
+
+    vtkIdType Begin;
+    vtkIdType End;
+    std::vector<vtkFastGeomQuad*> Heads;
+    std::vector<std::unique_ptr<unsigned char[]>> Blocks;
+    vtkIdType BlockLength;
+    vtkIdType NextQuadIndex;
+    std::vector<vtkIdType> Tab;
+  };
+
+  struct AddedFace
+  {
+    vtkIdType SourceId;
+    vtkIdType Offset;
+    int NumberOfPoints;
+    FaceKind Kind;
+  };
+
+  void AddFace(FaceKind kind, const vtkIdType* ids, int numPts, vtkIdType sourceId)
+  {
+    AddedFace face;
+    face.SourceId = sourceId;
+    face.Offset = static_cast<vtkIdType>(this->AddedConnectivity.size());
+    face.NumberOfPoints = numPts;
+    face.Kind = kind;
+    this->AddedFaces.push_back(face);
+    this->AddedConnectivity.insert(this->AddedConnectivity.end(), ids, ids + numPts);
+  }
+
+  void InsertFaces(vtkUnstructuredGridBase* input, vtkUnsignedCharArray* ghostCells,
+    Partition& partition, vtkIdList* ptIds)
+  {
+    const vtkIdType numCells = input->GetNumberOfCells();
+    size_t added = 0;
+    vtkIdType npts;
+    const vtkIdType* ids;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      // The added faces come from the cells that are not hidden.
+      for (; added < this->AddedFaces.size() && this->AddedFaces[added].SourceId == cellId;
+           ++added)
+      {
+        const AddedFace& face = this->AddedFaces[added];
+        const vtkIdType* pts = this->AddedConnectivity.data() + face.Offset;
+        switch (face.Kind)
+        {
+          case Quad:
+            partition.InsertQuad(pts[0], pts[1], pts[2], pts[3], cellId);
+            break;
+          case Triangle:
+            partition.InsertTri(pts[0], pts[1], pts[2], cellId);
+            break;
+          default:
+            partition.InsertPolygon(pts, face.NumberOfPoints, cellId);
+            break;
+        }
+      }
+      const int cellType = input->GetCellType(cellId);
+      if (!HasFixedFaces(cellType) ||
+        (ghostCells &&
+          (ghostCells->GetValue(cellId) & vtkDataSetAttributes::CellGhostTypes::HIDDENCELL)))
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, npts, ids, ptIds);
+      if (!partition.HasBucket(npts, ids))
+      {
+        continue;
+      }
+      switch (cellType)
+      {
+        case VTK_HEXAHEDRON:
+          partition.InsertQuad(ids[0], ids[1], ids[5], ids[4], cellId);
+          partition.InsertQuad(ids[0], ids[3], ids[2], ids[1], cellId);
+          partition.InsertQuad(ids[0], ids[4], ids[7], ids[3], cellId);
+          partition.InsertQuad(ids[1], ids[2], ids[6], ids[5], cellId);
+          partition.InsertQuad(ids[2], ids[3], ids[7], ids[6], cellId);
+          partition.InsertQuad(ids[4], ids[5], ids[6], ids[7], cellId);
+          break;
+
+        case VTK_VOXEL:
+          partition.InsertQuad(ids[0], ids[1], ids[5], ids[4], cellId);
+          partition.InsertQuad(ids[0], ids[2], ids[3], ids[1], cellId);
+          partition.InsertQuad(ids[0], ids[4], ids[6], ids[2], cellId);
+          partition.InsertQuad(ids[1], ids[3], ids[7], ids[5], cellId);
+          partition.InsertQuad(ids[2], ids[6], ids[7], ids[3], cellId);
+          partition.InsertQuad(ids[4], ids[5], ids[7], ids[6], cellId);
+          break;
+
+        case VTK_TETRA:
+          partition.InsertTri(ids[0], ids[1], ids[3], cellId);
+          partition.InsertTri(ids[0], ids[2], ids[1], cellId);
+          partition.InsertTri(ids[0], ids[3], ids[2], cellId);
+          partition.InsertTri(ids[1], ids[2], ids[3], cellId);
+          break;
+
+        case VTK_PENTAGONAL_PRISM:
+          partition.InsertQuad(ids[0], ids[1], ids[6], ids[5], cellId);
+          partition.InsertQuad(ids[1], ids[2], ids[7], ids[6], cellId);
+          partition.InsertQuad(ids[2], ids[3], ids[8], ids[7], cellId);
+          partition.InsertQuad(ids[3], ids[4], ids[9], ids[8], cellId);
+          partition.InsertQuad(ids[4], ids[0], ids[5], ids[9], cellId);
+          partition.InsertPolygon(ids, 5, cellId);
+          partition.InsertPolygon(&ids[5], 5, cellId);
+          break;
+
+        case VTK_HEXAGONAL_PRISM:
+          partition.InsertQuad(ids[0], ids[1], ids[7], ids[6], cellId);
+          partition.InsertQuad(ids[1], ids[2], ids[8], ids[7], cellId);
+          partition.InsertQuad(ids[2], ids[3], ids[9], ids[8], cellId);
+          partition.InsertQuad(ids[3], ids[4], ids[10], ids[9], cellId);
+          partition.InsertQuad(ids[4], ids[5], ids[11], ids[10], cellId);
+          partition.InsertQuad(ids[5], ids[0], ids[6], ids[11], cellId);
+          partition.InsertPolygon(ids, 6, cellId);
+          partition.InsertPolygon(&ids[6], 6, cellId);
+          break;
+
+        case VTK_PYRAMID:
+          partition.InsertQuad(ids[3], ids[2], ids[1], ids[0], cellId);
+          partition.InsertTri(ids[0], ids[1], ids[4], cellId);
+          partition.InsertTri(ids[1], ids[2], ids[4], cellId);
+          partition.InsertTri(ids[2], ids[3], ids[4], cellId);
+          partition.InsertTri(ids[3], ids[0], ids[4], cellId);
+          break;
+
+        case VTK_WEDGE:
+          partition.InsertQuad(ids[0], ids[2], ids[5], ids[3], cellId);
+          partition.InsertQuad(ids[1], ids[0], ids[3], ids[4], cellId);
+          partition.InsertQuad(ids[2], ids[1], ids[4], ids[5], cellId);
+          partition.InsertTri(ids[0], ids[1], ids[2], cellId);
+          partition.InsertTri(ids[3], ids[5], ids[4], cellId);
+          break;
+      }
+    }
+  }
+
+  std::vector<Partition> Partitions;
+  std::vector<AddedFace> AddedFaces;
+  std::vector<vtkIdType> AddedConnectivity;
+  size_t TraversalPartition;
+  vtkIdType TraversalBucket;
+  vtkFastGeomQuad* TraversalQuad;
+};
+
 }
 
 class vtkDataSetSurfaceFilter::vtkEdgeInterpolationMap
@@ -1474,7 +1915,12 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
   std::vector<double> weights;
 
   this->NumberOfNewCells = 0;
-  this->InitializeQuadHash(numPts);
+  // The faces are hashed by vtkExternalFaceHash: only the point and edge maps
+  // are needed, and DeleteQuadHash() releases them at the end.
+  this->PointMap = new vtkIdType[numPts];
+  std::fill_n(this->PointMap, numPts, -1);
+  this->EdgeMap = new vtkEdgeInterpolationMap;
+  vtkExternalFaceHash faces(numPts);
 
   // Allocate
   //
@@ -1693,79 +2139,13 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
         break;
       }
       case VTK_HEXAHEDRON:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
-        this->InsertQuadInHash(ids[0], ids[3], ids[2], ids[1], cellId);
-        this->InsertQuadInHash(ids[0], ids[4], ids[7], ids[3], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[6], ids[5], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[6], ids[7], cellId);
-        break;
-
       case VTK_VOXEL:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
-        this->InsertQuadInHash(ids[0], ids[2], ids[3], ids[1], cellId);
-        this->InsertQuadInHash(ids[0], ids[4], ids[6], ids[2], cellId);
-        this->InsertQuadInHash(ids[1], ids[3], ids[7], ids[5], cellId);
-        this->InsertQuadInHash(ids[2], ids[6], ids[7], ids[3], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[7], ids[6], cellId);
-        break;
-
       case VTK_TETRA:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertTriInHash(ids[0], ids[1], ids[3], cellId, 2);
-        this->InsertTriInHash(ids[0], ids[2], ids[1], cellId, 3);
-        this->InsertTriInHash(ids[0], ids[3], ids[2], cellId, 1);
-        this->InsertTriInHash(ids[1], ids[2], ids[3], cellId, 0);
-        break;
-
       case VTK_PENTAGONAL_PRISM:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[6], ids[5], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[8], ids[7], cellId);
-        this->InsertQuadInHash(ids[3], ids[4], ids[9], ids[8], cellId);
-        this->InsertQuadInHash(ids[4], ids[0], ids[5], ids[9], cellId);
-        this->InsertPolygonInHash(ids, 5, cellId);
-        this->InsertPolygonInHash(&ids[5], 5, cellId);
-        break;
-
       case VTK_HEXAGONAL_PRISM:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[8], ids[7], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[9], ids[8], cellId);
-        this->InsertQuadInHash(ids[3], ids[4], ids[10], ids[9], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[11], ids[10], cellId);
-        this->InsertQuadInHash(ids[5], ids[0], ids[6], ids[11], cellId);
-        this->InsertPolygonInHash(ids, 6, cellId);
-        this->InsertPolygonInHash(&ids[6], 6, cellId);
-        break;
-
       case VTK_PYRAMID:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[3], ids[2], ids[1], ids[0], cellId);
-        this->InsertTriInHash(ids[0], ids[1], ids[4], cellId);
-        this->InsertTriInHash(ids[1], ids[2], ids[4], cellId);
-        this->InsertTriInHash(ids[2], ids[3], ids[4], cellId);
-        this->InsertTriInHash(ids[3], ids[0], ids[4], cellId);
-        break;
-
       case VTK_WEDGE:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[2], ids[5], ids[3], cellId);
-        this->InsertQuadInHash(ids[1], ids[0], ids[3], ids[4], cellId);
-        this->InsertQuadInHash(ids[2], ids[1], ids[4], ids[5], cellId);
-        this->InsertTriInHash(ids[0], ids[1], ids[2], cellId);
-        this->InsertTriInHash(ids[3], ids[5], ids[4], cellId);
+        // The faces of these cells are inserted in the hash after this loop.
         break;
 
       case VTK_PIXEL:
@@ -1803,17 +2183,17 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
               numFacePts = face->GetNumberOfPoints();
               if (numFacePts == 4)
               {
-                this->InsertQuadInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                faces.InsertQuad(face->PointIds->GetId(0), face->PointIds->GetId(1),
                   face->PointIds->GetId(2), face->PointIds->GetId(3), cellId);
               }
               else if (numFacePts == 3)
               {
-                this->InsertTriInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                faces.InsertTri(face->PointIds->GetId(0), face->PointIds->GetId(1),
                   face->PointIds->GetId(2), cellId);
               }
               else
               {
-                this->InsertPolygonInHash(
+                faces.InsertPolygon(
                   face->PointIds->GetPointer(0), face->PointIds->GetNumberOfIds(), cellId);
               }
             } // for all cell faces
@@ -1863,7 +2243,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
                   face->Triangulate(0, pts, coords);
                   for (i = 0; i < pts->GetNumberOfIds(); i += 3)
                   {
-                    this->InsertTriInHash(
+                    faces.InsertTri(
                       pts->GetId(i), pts->GetId(i + 1), pts->GetId(i + 2), cellId);
                   }
                 }
@@ -1874,7 +2254,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
                     case VTK_QUADRATIC_TRIANGLE:
                     case VTK_LAGRANGE_TRIANGLE:
                     case VTK_BEZIER_TRIANGLE:
-                      this->InsertTriInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                      faces.InsertTri(face->PointIds->GetId(0), face->PointIds->GetId(1),
                         face->PointIds->GetId(2), cellId);
                       break;
                     case VTK_QUADRATIC_QUAD:
@@ -1882,7 +2262,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
                     case VTK_QUADRATIC_LINEAR_QUAD:
                     case VTK_LAGRANGE_QUADRILATERAL:
                     case VTK_BEZIER_QUADRILATERAL:
-                      this->InsertQuadInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                      faces.InsertQuad(face->PointIds->GetId(0), face->PointIds->GetId(1),
                         face->PointIds->GetId(2), face->PointIds->GetId(3), cellId);
                       break;
                     default:
@@ -2158,9 +2538,13 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
     }
   } // for all cells.
 
-  // Now transfer geometry from hash to output (only triangles and quads).
-  this->InitQuadHashTraversal();
-  while ((q = this->GetNextVisibleQuadFromHash()))
+  // Now transfer geometry from hash to output.
+  if (!abort)
+  {
+    faces.InsertFaces(input, ghostCells);
+  }
+  faces.InitTraversal();
+  while ((q = faces.GetNextVisibleQuad()))
   {
     // If one of the points is hidden (meaning invalid), do not
     // extract surface cell.
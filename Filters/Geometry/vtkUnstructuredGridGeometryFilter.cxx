@@ -49,6 +49,7 @@
 #include "vtkQuadraticPyramid.h"
 #include "vtkQuadraticTetra.h"
 #include "vtkQuadraticWedge.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
@@ -60,7 +61,9 @@
 #include "vtkVoxel.h"
 #include "vtkWedge.h"
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <vector>
 
 vtkStandardNewMacro(vtkUnstructuredGridGeometryFilter);
@@ -378,37 +381,29 @@ public:
 };
 
 //------------------------------------------------------------------------------
-// Hashtable of surfels.
+// Range of keys of the hashtable of surfels, with its own pool of surfels.
 const int VTK_HASH_PRIME = 31;
-class vtkHashTableOfSurfels
+class vtkHashRangeOfSurfels
 {
 public:
-  // Constructor for the number of points in the dataset and an initialized
-  // pool.
-  // \pre positive_number: numberOfPoints>0
-  // \pre pool_exists: pool!=0
-  // \pre initialized_pool: pool->IsInitialized()
-  vtkHashTableOfSurfels(int numberOfPoints, vtkPoolManager<vtkSurfel>* pool)
-    : HashTable(numberOfPoints)
+  // Constructor for the keys in [begin, end) of a hashtable of numberOfKeys
+  // keys.
+  // \pre valid_range: begin>=0 && begin<=end && end<=numberOfKeys
+  vtkHashRangeOfSurfels(vtkIdType numberOfKeys, vtkIdType begin, vtkIdType end)
+    : HashTable(end - begin, nullptr)
   {
-    assert("pre: positive_number" && numberOfPoints > 0);
-    assert("pre: pool_exists" && pool != nullptr);
-    assert("pre: initialized_pool" && pool->IsInitialized());
+    assert("pre: valid_range" && begin >= 0 && begin <= end && end <= numberOfKeys);
 
-    this->Pool = pool;
-    int i = 0;
-    int c = numberOfPoints;
-    while (i < c)
-    {
-      this->HashTable[i] = nullptr;
-      ++i;
-    }
+    this->NumberOfKeys = numberOfKeys;
+    this->Begin = begin;
+    this->End = end;
+    this->Pool.Init();
   }
   std::vector<vtkSurfel*> HashTable;
 
   // Add faces of cell type FaceType
   template <typename CellType, int FirstFace, int LastFace, int NumPoints, int FaceType>
-  void InsertFaces(vtkIdType* pts, vtkIdType cellId)
+  void InsertFaces(const vtkIdType* pts, vtkIdType cellId)
   {
     vtkIdType points[NumPoints];
     for (int face = FirstFace; face < LastFace; ++face)
@@ -425,10 +420,11 @@ public:
 
   // Add a face defined by its cell type 'faceType', its number of points,
   // its list of points and the cellId of the 3D cell it belongs to.
+  // Faces whose key is not in the range are ignored.
   // \pre positive number of points
 
-  void InsertFace(
-    vtkIdType cellId, vtkIdType faceType, int numberOfPoints, vtkIdType* points, int degrees[2])
+  void InsertFace(vtkIdType cellId, vtkIdType faceType, int numberOfPoints,
+    const vtkIdType* points, const int degrees[2])
   {
     assert("pre: positive number of points" && numberOfPoints >= 0);
 
@@ -467,19 +463,23 @@ public:
     }
 
     // Compute the hashkey/code
-    size_t key = (faceType * VTK_HASH_PRIME + smallestId) % (this->HashTable.size());
+    vtkIdType key = (faceType * VTK_HASH_PRIME + smallestId) % this->NumberOfKeys;
+    if (key < this->Begin || key >= this->End)
+    {
+      return;
+    }
 
     // Get the list at this key (several not equal faces can share the
     // same hashcode). This is the first element in the list.
-    vtkSurfel* first = this->HashTable[key];
+    vtkSurfel* first = this->HashTable[key - this->Begin];
     vtkSurfel* surfel;
     if (first == nullptr)
     {
       // empty list.
-      surfel = this->Pool->Allocate();
+      surfel = this->Pool.Allocate();
 
       // Just add this new face.
-      this->HashTable[key] = surfel;
+      this->HashTable[key - this->Begin] = surfel;
     }
     else
     {
@@ -488,7 +488,9 @@ public:
       vtkSurfel* previous = current;
       while (!found && current != nullptr)
       {
-        found = current->Type == faceType;
+        // Faces with a different number of points, like polygons of
+        // polyhedra, cannot match.
+        found = current->Type == faceType && current->NumberOfPoints == numberOfPoints;
         if (found)
         {
           if (faceType == VTK_QUADRATIC_LINEAR_QUAD)
@@ -632,7 +634,7 @@ public:
       }
       else
       {
-        surfel = this->Pool->Allocate();
+        surfel = this->Pool.Allocate();
         previous->Next = surfel;
       }
     }
@@ -654,7 +656,208 @@ public:
   }
 
 protected:
-  vtkPoolManager<vtkSurfel>* Pool;
+  vtkIdType NumberOfKeys;
+  vtkIdType Begin;
+  vtkIdType End;
+  vtkPoolManager<vtkSurfel> Pool;
+};
+
+//------------------------------------------------------------------------------
+// Hashtable of surfels.
+// The keys are split in ranges, one per thread, filled concurrently by
+// InsertCellFaces(). Each range visits all the cells in order, so the surfels
+// of a key and their order do not depend on the number of threads.
+class vtkHashTableOfSurfels
+{
+public:
+  // Constructor for the number of points in the dataset.
+  // \pre positive_number: numberOfPoints>0
+  vtkHashTableOfSurfels(vtkIdType numberOfPoints)
+  {
+    assert("pre: positive_number" && numberOfPoints > 0);
+
+    vtkIdType numberOfRanges = std::max<vtkIdType>(1,
+      std::min<vtkIdType>(vtkSMPTools::GetEstimatedNumberOfThreads(), numberOfPoints));
+    for (vtkIdType i = 0; i < numberOfRanges; ++i)
+    {
+      this->Ranges.emplace_back(new vtkHashRangeOfSurfels(numberOfPoints,
+        numberOfPoints * i / numberOfRanges, numberOfPoints * (i + 1) / numberOfRanges));
+    }
+  }
+  std::vector<std::unique_ptr<vtkHashRangeOfSurfels>> Ranges;
+
+  // Is the cell type one of the types whose faces are given by their
+  // GetFaceArray()? Those faces are added by InsertCellFaces().
+  static bool HasFaceArray(int cellType)
+  {
+    switch (cellType)
+    {
+      case VTK_TETRA:
+      case VTK_VOXEL:
+      case VTK_HEXAHEDRON:
+      case VTK_WEDGE:
+      case VTK_PYRAMID:
+      case VTK_PENTAGONAL_PRISM:
+      case VTK_HEXAGONAL_PRISM:
+      case VTK_QUADRATIC_TETRA:
+      case VTK_QUADRATIC_HEXAHEDRON:
+      case VTK_QUADRATIC_WEDGE:
+      case VTK_QUADRATIC_PYRAMID:
+      case VTK_TRIQUADRATIC_PYRAMID:
+      case VTK_TRIQUADRATIC_HEXAHEDRON:
+      case VTK_QUADRATIC_LINEAR_WEDGE:
+      case VTK_BIQUADRATIC_QUADRATIC_WEDGE:
+      case VTK_BIQUADRATIC_QUADRATIC_HEXAHEDRON:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Add a face of a visible cell of another type, like a polyhedron. The
+  // faces must be added in cell order, before InsertCellFaces().
+  // \pre positive number of points
+  void AddFace(vtkIdType cellId, vtkIdType faceType, int numberOfPoints, const vtkIdType* points,
+    const int degrees[2])
+  {
+    assert("pre: positive number of points" && numberOfPoints >= 0);
+
+    vtkAddedFace face;
+    face.CellId = cellId;
+    face.Type = faceType;
+    face.NumberOfPoints = numberOfPoints;
+    face.Offset = static_cast<vtkIdType>(this->AddedPoints.size());
+    face.Degrees[0] = degrees[0];
+    face.Degrees[1] = degrees[1];
+    this->AddedFaces.push_back(face);
+    this->AddedPoints.insert(this->AddedPoints.end(), points, points + numberOfPoints);
+  }
+
+  // Insert the added faces and the faces of the visible cells with a face
+  // array in the ranges. cellVis is nullptr if all the cells are visible.
+  void InsertCellFaces(vtkUnstructuredGridBase* input, const char* cellVis)
+  {
+    vtkSMPTools::For(0, static_cast<vtkIdType>(this->Ranges.size()), 1,
+      [&](vtkIdType begin, vtkIdType end) {
+        vtkNew<vtkIdList> ptIds;
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          this->InsertCellFaces(input, cellVis, *this->Ranges[i], ptIds);
+        }
+      });
+  }
+
+protected:
+  struct vtkAddedFace
+  {
+    vtkIdType CellId;
+    vtkIdType Type;
+    int NumberOfPoints;
+    vtkIdType Offset;
+    int Degrees[2];
+  };
+
+  void InsertCellFaces(vtkUnstructuredGridBase* input, const char* cellVis,
+    vtkHashRangeOfSurfels& range, vtkIdList* ptIds)
+  {
+    vtkIdType numCells = input->GetNumberOfCells();
+    size_t added = 0;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      for (; added < this->AddedFaces.size() && this->AddedFaces[added].CellId == cellId; ++added)
+      {
+        const vtkAddedFace& face = this->AddedFaces[added];
+        range.InsertFace(cellId, face.Type, face.NumberOfPoints,
+          this->AddedPoints.data() + face.Offset, face.Degrees);
+      }
+      if (cellVis != nullptr && !cellVis[cellId])
+      {
+        continue;
+      }
+      int cellType = input->GetCellType(cellId);
+      if (!HasFaceArray(cellType))
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, npts, pts, ptIds);
+      switch (cellType)
+      {
+        case VTK_TETRA:
+          range.InsertFaces<vtkTetra, 0, 4, 3, VTK_TRIANGLE>(pts, cellId);
+          break;
+        case VTK_VOXEL:
+          // note, faces are PIXEL not QUAD. We don't need to convert
+          //  to QUAD because PIXEL exist in an UnstructuredGrid.
+          range.InsertFaces<vtkVoxel, 0, 6, 4, VTK_PIXEL>(pts, cellId);
+          break;
+        case VTK_HEXAHEDRON:
+          range.InsertFaces<vtkHexahedron, 0, 6, 4, VTK_QUAD>(pts, cellId);
+          break;
+        case VTK_WEDGE:
+          range.InsertFaces<vtkWedge, 0, 2, 3, VTK_TRIANGLE>(pts, cellId);
+          range.InsertFaces<vtkWedge, 2, 5, 4, VTK_QUAD>(pts, cellId);
+          break;
+        case VTK_PYRAMID:
+          range.InsertFaces<vtkPyramid, 0, 1, 4, VTK_QUAD>(pts, cellId);
+          range.InsertFaces<vtkPyramid, 1, 5, 3, VTK_TRIANGLE>(pts, cellId);
+          break;
+        case VTK_PENTAGONAL_PRISM:
+          range.InsertFaces<vtkPentagonalPrism, 0, 2, 5, VTK_POLYGON>(pts, cellId);
+          range.InsertFaces<vtkPentagonalPrism, 2, 7, 4, VTK_QUAD>(pts, cellId);
+          break;
+        case VTK_HEXAGONAL_PRISM:
+          range.InsertFaces<vtkHexagonalPrism, 0, 2, 6, VTK_POLYGON>(pts, cellId);
+          range.InsertFaces<vtkHexagonalPrism, 2, 8, 4, VTK_QUAD>(pts, cellId);
+          break;
+        case VTK_QUADRATIC_TETRA:
+          range.InsertFaces<vtkQuadraticTetra, 0, 4, 6, VTK_QUADRATIC_TRIANGLE>(pts, cellId);
+          break;
+        case VTK_QUADRATIC_HEXAHEDRON:
+          range.InsertFaces<vtkQuadraticHexahedron, 0, 6, 8, VTK_QUADRATIC_QUAD>(pts, cellId);
+          break;
+        case VTK_QUADRATIC_WEDGE:
+          range.InsertFaces<vtkQuadraticWedge, 0, 2, 6, VTK_QUADRATIC_TRIANGLE>(pts, cellId);
+          range.InsertFaces<vtkQuadraticWedge, 2, 5, 8, VTK_QUADRATIC_QUAD>(pts, cellId);
+          break;
+        case VTK_QUADRATIC_PYRAMID:
+          range.InsertFaces<vtkQuadraticPyramid, 0, 1, 8, VTK_QUADRATIC_QUAD>(pts, cellId);
+          range.InsertFaces<vtkQuadraticPyramid, 1, 5, 6, VTK_QUADRATIC_TRIANGLE>(pts, cellId);
+          break;
+        case VTK_TRIQUADRATIC_PYRAMID:
+          range.InsertFaces<vtkTriQuadraticPyramid, 0, 1, 9, VTK_BIQUADRATIC_QUAD>(pts, cellId);
+          range.InsertFaces<vtkTriQuadraticPyramid, 1, 5, 7, VTK_BIQUADRATIC_TRIANGLE>(
+            pts, cellId);
+          break;
+        case VTK_TRIQUADRATIC_HEXAHEDRON:
+          range.InsertFaces<vtkTriQuadraticHexahedron, 0, 6, 9, VTK_BIQUADRATIC_QUAD>(
+            pts, cellId);
+          break;
+        case VTK_QUADRATIC_LINEAR_WEDGE:
+          range.InsertFaces<vtkQuadraticLinearWedge, 0, 2, 6, VTK_QUADRATIC_TRIANGLE>(
+            pts, cellId);
+          range.InsertFaces<vtkQuadraticLinearWedge, 2, 5, 6, VTK_QUADRATIC_LINEAR_QUAD>(
+            pts, cellId);
+          break;
+        case VTK_BIQUADRATIC_QUADRATIC_WEDGE:
+          range.InsertFaces<vtkBiQuadraticQuadraticWedge, 0, 2, 6, VTK_QUADRATIC_TRIANGLE>(
+            pts, cellId);
+          range.InsertFaces<vtkBiQuadraticQuadraticWedge, 2, 5, 9, VTK_BIQUADRATIC_QUAD>(
+            pts, cellId);
+          break;
+        case VTK_BIQUADRATIC_QUADRATIC_HEXAHEDRON:
+          range.InsertFaces<vtkBiQuadraticQuadraticHexahedron, 0, 4, 9, VTK_BIQUADRATIC_QUAD>(
+            pts, cellId);
+          range.InsertFaces<vtkBiQuadraticQuadraticHexahedron, 4, 6, 8, VTK_QUADRATIC_QUAD>(
+            pts, cellId);
+          break;
+      }
+    }
+  }
+
+  std::vector<vtkAddedFace> AddedFaces;
+  std::vector<vtkIdType> AddedPoints;
 };
 
 //------------------------------------------------------------------------------
@@ -675,27 +878,9 @@ public:
   // If the table is empty, the cursor is at the end of the table.
   void Start()
   {
+    this->CurrentRange = 0;
     this->CurrentKey = 0;
-    this->CurrentSurfel = nullptr;
-
-    size_t c = Table->HashTable.size();
-    int done = this->CurrentKey >= c;
-    if (!done)
-    {
-      this->CurrentSurfel = this->Table->HashTable[this->CurrentKey];
-      done = this->CurrentSurfel != nullptr;
-    }
-    while (!done)
-    {
-      ++this->CurrentKey;
-      done = this->CurrentKey >= c;
-      if (!done)
-      {
-        this->CurrentSurfel = this->Table->HashTable[this->CurrentKey];
-        done = this->CurrentSurfel != nullptr;
-      }
-    }
-    this->AtEnd = this->CurrentSurfel == nullptr;
+    this->FindSurfel();
   }
 
   // Is the cursor at the end of the table? (ie. no more surfel?)
@@ -714,32 +899,41 @@ public:
   {
     assert("pre: not_at_end" && !IsAtEnd());
     CurrentSurfel = CurrentSurfel->Next;
-    size_t c = Table->HashTable.size();
     if (this->CurrentSurfel == nullptr)
     {
       ++this->CurrentKey;
-      int done = this->CurrentKey >= c;
-      if (!done)
-      {
-        this->CurrentSurfel = this->Table->HashTable[this->CurrentKey];
-        done = this->CurrentSurfel != nullptr;
-      }
-      while (!done)
+      this->FindSurfel();
+    }
+  }
+
+protected:
+  // Move the cursor to the first surfel from the current key of the current
+  // range on.
+  void FindSurfel()
+  {
+    size_t c = this->Table->Ranges.size();
+    while (this->CurrentRange < c)
+    {
+      const std::vector<vtkSurfel*>& hashTable = this->Table->Ranges[this->CurrentRange]->HashTable;
+      while (this->CurrentKey < hashTable.size())
       {
-        ++this->CurrentKey;
-        done = this->CurrentKey >= c;
-        if (!done)
+        this->CurrentSurfel = hashTable[this->CurrentKey];
+        if (this->CurrentSurfel != nullptr)
         {
-          this->CurrentSurfel = this->Table->HashTable[this->CurrentKey];
-          done = this->CurrentSurfel != nullptr;
+          this->AtEnd = 0;
+          return;
         }
+        ++this->CurrentKey;
       }
-      this->AtEnd = this->CurrentSurfel == nullptr;
+      ++this->CurrentRange;
+      this->CurrentKey = 0;
     }
+    this->CurrentSurfel = nullptr;
+    this->AtEnd = 1;
   }
 
-protected:
   vtkHashTableOfSurfels* Table;
+  size_t CurrentRange;
   size_t CurrentKey;
   vtkSurfel* CurrentSurfel;
   int AtEnd;
@@ -986,9 +1180,7 @@ int vtkUnstructuredGridGeometryFilter::RequestData(vtkInformation* vtkNotUsed(re
   int abort = 0;
   vtkIdType progressInterval = numCells / 20 + 1;
 
-  vtkPoolManager<vtkSurfel>* pool = new vtkPoolManager<vtkSurfel>;
-  pool->Init();
-  this->HashTable = new vtkHashTableOfSurfels(numPts, pool);
+  this->HashTable = new vtkHashTableOfSurfels(numPts);
 
   for (cellIter->InitTraversal(); !cellIter->IsDoneWithTraversal() && !abort;
        cellIter->GoToNextCell())
@@ -1072,84 +1264,22 @@ int vtkUnstructuredGridGeometryFilter::RequestData(vtkInformation* vtkNotUsed(re
         switch (cellType)
         {
           case VTK_TETRA:
-            this->HashTable->InsertFaces<vtkTetra, 0, 4, 3, VTK_TRIANGLE>(pts, cellId);
-            break;
           case VTK_VOXEL:
-            // note, faces are PIXEL not QUAD. We don't need to convert
-            //  to QUAD because PIXEL exist in an UnstructuredGrid.
-            this->HashTable->InsertFaces<vtkVoxel, 0, 6, 4, VTK_PIXEL>(pts, cellId);
-            break;
           case VTK_HEXAHEDRON:
-            this->HashTable->InsertFaces<vtkHexahedron, 0, 6, 4, VTK_QUAD>(pts, cellId);
-            break;
           case VTK_WEDGE:
-            this->HashTable->InsertFaces<vtkWedge, 0, 2, 3, VTK_TRIANGLE>(pts, cellId);
-            this->HashTable->InsertFaces<vtkWedge, 2, 5, 4, VTK_QUAD>(pts, cellId);
-            break;
           case VTK_PYRAMID:
-            this->HashTable->InsertFaces<vtkPyramid, 0, 1, 4, VTK_QUAD>(pts, cellId);
-            this->HashTable->InsertFaces<vtkPyramid, 1, 5, 3, VTK_TRIANGLE>(pts, cellId);
-            break;
           case VTK_PENTAGONAL_PRISM:
-            this->HashTable->InsertFaces<vtkPentagonalPrism, 0, 2, 5, VTK_POLYGON>(pts, cellId);
-            this->HashTable->InsertFaces<vtkPentagonalPrism, 2, 7, 4, VTK_QUAD>(pts, cellId);
-            break;
           case VTK_HEXAGONAL_PRISM:
-            this->HashTable->InsertFaces<vtkHexagonalPrism, 0, 2, 6, VTK_POLYGON>(pts, cellId);
-            this->HashTable->InsertFaces<vtkHexagonalPrism, 2, 8, 4, VTK_QUAD>(pts, cellId);
-            break;
           case VTK_QUADRATIC_TETRA:
-            this->HashTable->InsertFaces<vtkQuadraticTetra, 0, 4, 6, VTK_QUADRATIC_TRIANGLE>(
-              pts, cellId);
-            break;
           case VTK_QUADRATIC_HEXAHEDRON:
-            this->HashTable->InsertFaces<vtkQuadraticHexahedron, 0, 6, 8, VTK_QUADRATIC_QUAD>(
-              pts, cellId);
-            break;
           case VTK_QUADRATIC_WEDGE:
-            this->HashTable->InsertFaces<vtkQuadraticWedge, 0, 2, 6, VTK_QUADRATIC_TRIANGLE>(
-              pts, cellId);
-            this->HashTable->InsertFaces<vtkQuadraticWedge, 2, 5, 8, VTK_QUADRATIC_QUAD>(
-              pts, cellId);
-            break;
           case VTK_QUADRATIC_PYRAMID:
-            this->HashTable->InsertFaces<vtkQuadraticPyramid, 0, 1, 8, VTK_QUADRATIC_QUAD>(
-              pts, cellId);
-            this->HashTable->InsertFaces<vtkQuadraticPyramid, 1, 5, 6, VTK_QUADRATIC_TRIANGLE>(
-              pts, cellId);
-            break;
           case VTK_TRIQUADRATIC_PYRAMID:
-            this->HashTable->InsertFaces<vtkTriQuadraticPyramid, 0, 1, 9, VTK_BIQUADRATIC_QUAD>(
-              pts, cellId);
-            this->HashTable->InsertFaces<vtkTriQuadraticPyramid, 1, 5, 7, VTK_BIQUADRATIC_TRIANGLE>(
-              pts, cellId);
-            break;
           case VTK_TRIQUADRATIC_HEXAHEDRON:
-            this->HashTable->InsertFaces<vtkTriQuadraticHexahedron, 0, 6, 9, VTK_BIQUADRATIC_QUAD>(
-              pts, cellId);
-            break;
           case VTK_QUADRATIC_LINEAR_WEDGE:
-            this->HashTable->InsertFaces<vtkQuadraticLinearWedge, 0, 2, 6, VTK_QUADRATIC_TRIANGLE>(
-              pts, cellId);
-            this->HashTable
-              ->InsertFaces<vtkQuadraticLinearWedge, 2, 5, 6, VTK_QUADRATIC_LINEAR_QUAD>(
-                pts, cellId);
-            break;
           case VTK_BIQUADRATIC_QUADRATIC_WEDGE:
-            this->HashTable
-              ->InsertFaces<vtkBiQuadraticQuadraticWedge, 0, 2, 6, VTK_QUADRATIC_TRIANGLE>(
-                pts, cellId);
-            this->HashTable
-              ->InsertFaces<vtkBiQuadraticQuadraticWedge, 2, 5, 9, VTK_BIQUADRATIC_QUAD>(
-                pts, cellId);
-            break;
           case VTK_BIQUADRATIC_QUADRATIC_HEXAHEDRON:
-            this->HashTable
-              ->InsertFaces<vtkBiQuadraticQuadraticHexahedron, 0, 4, 9, VTK_BIQUADRATIC_QUAD>(
-                pts, cellId);
-            this->HashTable
-              ->InsertFaces<vtkBiQuadraticQuadraticHexahedron, 4, 6, 8, VTK_QUADRATIC_QUAD>(
-                pts, cellId);
+            // The faces of these cells are inserted after this loop.
             break;
           case VTK_POLYHEDRON:
           {
@@ -1159,8 +1289,7 @@ int vtkUnstructuredGridGeometryFilter::RequestData(vtkInformation* vtkNotUsed(re
             {
               int pt = static_cast<int>(faces->GetId(fptr++));
               int degrees[2]{ 0, 0 };
-              this->HashTable->InsertFace(
-                cellId, VTK_POLYGON, pt, faces->GetPointer(fptr), degrees);
+              this->HashTable->AddFace(cellId, VTK_POLYGON, pt, faces->GetPointer(fptr), degrees);
               fptr += pt;
             }
             break;
@@ -1196,8 +1325,7 @@ int vtkUnstructuredGridGeometryFilter::RequestData(vtkInformation* vtkNotUsed(re
                 degrees[0] = facecellBezier->GetOrder(0);
                 degrees[1] = facecellBezier->GetOrder(1);
               }
-              this->HashTable->InsertFace(
-                cellId, faceCell->GetCellType(), nPoints, points, degrees);
+              this->HashTable->AddFace(cellId, faceCell->GetCellType(), nPoints, points, degrees);
               delete[] points;
             }
             break;
@@ -1211,6 +1339,11 @@ int vtkUnstructuredGridGeometryFilter::RequestData(vtkInformation* vtkNotUsed(re
     } // if cell is visible
   }   // for all cells
 
+  if (!abort)
+  {
+    this->HashTable->InsertCellFaces(input, cellVis);
+  }
+
   // Loop over visible surfel (coming from a unique cell) in the hashtable:
   vtkHashTableOfSurfelsCursor cursor;
   cursor.Init(this->HashTable);
@@ -1292,7 +1425,7 @@ int vtkUnstructuredGridGeometryFilter::RequestData(vtkInformation* vtkNotUsed(re
 
   cellIds->Delete();
   delete this->HashTable;
-  delete pool;
+  this->HashTable = nullptr;
 
   // Set the output.
   output->SetPoints(newPts);
@@ -16,16 +16,170 @@
 #include "vtkCollisionDetectionFilter.h"
 #include "vtkSmartPointer.h"
 
+#include "vtkCellArray.h"
 #include "vtkCommand.h"
+#include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMatrix4x4.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkSphereSource.h"
 #include "vtkTestErrorObserver.h"
 #include "vtkTransform.h"
 
+#include <cmath>
 #include <sstream>
 
 #define ERROR_OBSERVER_ENHANCEMENTS 0
 
+namespace
+{
+// A triangulated 10x10 grid over [0, 1] x [0, 1] in the plane z = 0. Quad
+// (i, j) is split into the triangles 2 * (10 * j + i) and 2 * (10 * j + i) + 1.
+vtkSmartPointer<vtkPolyData> CreateGrid()
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int j = 0; j <= 10; ++j)
+  {
+    for (int i = 0; i <= 10; ++i)
+    {
+      points->InsertNextPoint(0.1 * i, 0.1 * j, 0.0);
+    }
+  }
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int j = 0; j < 10; ++j)
+  {
+    for (int i = 0; i < 10; ++i)
+    {
+      const vtkIdType p0 = 11 * j + i;
+      const vtkIdType triangle0[3] = { p0, p0 + 1, p0 + 12 };
+      const vtkIdType triangle1[3] = { p0, p0 + 12, p0 + 11 };
+      polys->InsertNextCell(3, triangle0);
+      polys->InsertNextCell(3, triangle1);
+    }
+  }
+  vtkSmartPointer<vtkPolyData> grid = vtkSmartPointer<vtkPolyData>::New();
+  grid->SetPoints(points);
+  grid->SetPolys(polys);
+  return grid;
+}
+
+// A rectangle in the plane x = 0.55, split into 2 triangles whose common
+// edge crosses the plane z = 0 at y = -0.5, outside the grid. The grid
+// therefore touches the first triangle along its column of quads
+// 0.5 < x < 0.6, in 20 pairs of triangles.
+vtkSmartPointer<vtkPolyData> CreateWall()
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->InsertNextPoint(0.55, -1.0, -0.1);
+  points->InsertNextPoint(0.55, 2.0, -0.1);
+  points->InsertNextPoint(0.55, 2.0, 0.5);
+  points->InsertNextPoint(0.55, -1.0, 0.5);
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  const vtkIdType triangle0[3] = { 0, 1, 2 };
+  const vtkIdType triangle1[3] = { 0, 2, 3 };
+  polys->InsertNextCell(3, triangle0);
+  polys->InsertNextCell(3, triangle1);
+  vtkSmartPointer<vtkPolyData> wall = vtkSmartPointer<vtkPolyData>::New();
+  wall->SetPoints(points);
+  wall->SetPolys(polys);
+  return wall;
+}
+
+int TestGridAndWallContacts()
+{
+  vtkSmartPointer<vtkCollisionDetectionFilter> collision =
+    vtkSmartPointer<vtkCollisionDetectionFilter>::New();
+  collision->SetInputData(0, CreateGrid());
+  collision->SetInputData(1, CreateWall());
+  vtkSmartPointer<vtkTransform> transform0 = vtkSmartPointer<vtkTransform>::New();
+  vtkSmartPointer<vtkTransform> transform1 = vtkSmartPointer<vtkTransform>::New();
+  collision->SetTransform(0, transform0);
+  collision->SetTransform(1, transform1);
+  collision->SetCollisionModeToAllContacts();
+  collision->Update();
+
+  vtkIdTypeArray* contactCells0 = collision->GetContactCells(0);
+  vtkIdTypeArray* contactCells1 = collision->GetContactCells(1);
+  if (collision->GetNumberOfContacts() != 20)
+  {
+    std::cout << "Found " << collision->GetNumberOfContacts() << " contacts instead of 20"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (vtkIdType k = 0; k < 20; ++k)
+  {
+    if ((contactCells0->GetValue(k) / 2) % 10 != 5 || contactCells1->GetValue(k) != 0)
+    {
+      std::cout << "Contact " << k << " between cells " << contactCells0->GetValue(k) << " and "
+                << contactCells1->GetValue(k) << " is not along x = 0.55" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  vtkPolyData* contacts = collision->GetContactsOutput();
+  for (vtkIdType ptId = 0; ptId < contacts->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    contacts->GetPoint(ptId, x);
+    if (std::abs(x[0] - 0.55) > 1e-6 || x[1] < -1e-6 || x[1] > 1.0 + 1e-6 ||
+      std::abs(x[2]) > 1e-6)
+    {
+      std::cout << "Contact point " << ptId << " is not on the line x = 0.55, z = 0"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Moving the grid along x keeps the contacts till the wall leaves the grid,
+  // and moving it along z removes them once above the wall.
+  const double translations[5][3] = { { 0.0, 0.0, 0.0 }, { 0.1, 0.0, 0.0 },
+    { -0.3, 0.0, 0.02 }, { 0.6, 0.0, 0.0 }, { 0.0, 0.0, 0.6 } };
+  const vtkIdType expected[5] = { 20, 20, 20, 0, 0 };
+  vtkSmartPointer<vtkDoubleArray> poses0 = vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkDoubleArray> poses1 = vtkSmartPointer<vtkDoubleArray>::New();
+  poses0->SetNumberOfComponents(16);
+  poses1->SetNumberOfComponents(16);
+  for (int pose = 0; pose < 5; ++pose)
+  {
+    transform0->Identity();
+    transform0->Translate(translations[pose]);
+    poses0->InsertNextTuple(transform0->GetMatrix()->GetData());
+    poses1->InsertNextTuple(transform1->GetMatrix()->GetData());
+  }
+  const int modes[2] = { vtkCollisionDetectionFilter::VTK_ALL_CONTACTS,
+    vtkCollisionDetectionFilter::VTK_FIRST_CONTACT };
+  for (int mode : modes)
+  {
+    collision->SetCollisionMode(mode);
+    vtkSmartPointer<vtkIdTypeArray> numberOfContacts = vtkSmartPointer<vtkIdTypeArray>::New();
+    const vtkIdType total = collision->ComputeNumberOfContacts(poses0, poses1, numberOfContacts);
+    vtkIdType expectedTotal = 0;
+    for (int pose = 0; pose < 5; ++pose)
+    {
+      const vtkIdType expectedContacts =
+        mode == vtkCollisionDetectionFilter::VTK_FIRST_CONTACT ? (expected[pose] ? 1 : 0)
+                                                               : expected[pose];
+      expectedTotal += expectedContacts;
+      if (numberOfContacts->GetValue(pose) != expectedContacts)
+      {
+        std::cout << collision->GetCollisionModeAsString() << " pose " << pose << " has "
+                  << numberOfContacts->GetValue(pose) << " contacts instead of "
+                  << expectedContacts << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (total != expectedTotal)
+    {
+      std::cout << collision->GetCollisionModeAsString() << " poses have " << total
+                << " contacts instead of " << expectedTotal << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+}
+
 int UnitTestCollisionDetectionFilter(int, char*[])
 {
   int status = EXIT_SUCCESS;
@@ -158,5 +312,15 @@ int UnitTestCollisionDetectionFilter(int, char*[])
   std::cout << "NewInstance: " << newCollision << std::endl;
   newCollision->Delete();
 
+  std::cout << "  Testing contacts of a grid and a wall...";
+  if (TestGridAndWallContacts() == EXIT_SUCCESS)
+  {
+    std::cout << "PASSED" << std::endl;
+  }
+  else
+  {
+    status = EXIT_FAILURE;
+  }
+
   return status;
 }
@@ -19,17 +19,171 @@
 #include "vtkLoopSubdivisionFilter.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkQuad.h"
+#include "vtkSphereSource.h"
 #include "vtkTriangle.h"
 
 #include "vtkCommand.h"
 #include "vtkExecutive.h"
 #include "vtkTestErrorObserver.h"
 
+#include <cmath>
 #include <sstream>
 
+namespace
+{
+const int GridDimension = 10;
+
+// A triangulated square grid in the plane z = 0, whose boundary edges are
+// used by one triangle.
+vtkSmartPointer<vtkPolyData> MakeGrid()
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int j = 0; j <= GridDimension; ++j)
+  {
+    for (int i = 0; i <= GridDimension; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.0);
+    }
+  }
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int j = 0; j < GridDimension; ++j)
+  {
+    for (int i = 0; i < GridDimension; ++i)
+    {
+      const vtkIdType p00 = j * (GridDimension + 1) + i;
+      const vtkIdType p01 = p00 + GridDimension + 1;
+      const vtkIdType triangle0[3] = { p00, p00 + 1, p01 + 1 };
+      const vtkIdType triangle1[3] = { p00, p01 + 1, p01 };
+      polys->InsertNextCell(3, triangle0);
+      polys->InsertNextCell(3, triangle1);
+    }
+  }
+  vtkSmartPointer<vtkPolyData> grid = vtkSmartPointer<vtkPolyData>::New();
+  grid->SetPoints(points);
+  grid->SetPolys(polys);
+  return grid;
+}
+
+// Each level splits each triangle in four and each edge in two, so the
+// number of points grows by the number of edges. Output triangle i comes
+// from input triangle i / 4 of the previous level.
+int TestSubdivisionCounts(vtkSubdivisionFilter* subdivision, vtkPolyData* input,
+  int eulerCharacteristic, bool interpolating)
+{
+  vtkSmartPointer<vtkIdTypeArray> cellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(input->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->SetValue(cellId, cellId);
+  }
+  input->GetCellData()->AddArray(cellIds);
+
+  subdivision->SetInputData(input);
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  vtkIdType numTriangles = input->GetNumberOfPolys();
+  vtkIdType numCellsPerInputCell = 1;
+  for (int level = 1; level <= 2; ++level)
+  {
+    subdivision->SetNumberOfSubdivisions(level);
+    subdivision->Update();
+    vtkPolyData* output = subdivision->GetOutput();
+
+    // The number of edges comes from the Euler characteristic.
+    numPoints += numPoints + numTriangles - eulerCharacteristic;
+    numTriangles *= 4;
+    numCellsPerInputCell *= 4;
+    if (output->GetNumberOfPoints() != numPoints || output->GetNumberOfPolys() != numTriangles)
+    {
+      std::cout << "Level " << level << " has " << output->GetNumberOfPoints() << " points and "
+                << output->GetNumberOfPolys() << " triangles instead of " << numPoints << " and "
+                << numTriangles << std::endl;
+      return EXIT_FAILURE;
+    }
+    vtkIdTypeArray* outputCellIds =
+      vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray("CellIds"));
+    if (!outputCellIds)
+    {
+      std::cout << "Level " << level << " has no cell data" << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (vtkIdType cellId = 0; cellId < numTriangles; ++cellId)
+    {
+      if (outputCellIds->GetValue(cellId) != cellId / numCellsPerInputCell)
+      {
+        std::cout << "Level " << level << " triangle " << cellId << " has the data of input cell "
+                  << outputCellIds->GetValue(cellId) << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Interpolating subdivisions keep the input points first.
+    for (vtkIdType ptId = 0; interpolating && ptId < input->GetNumberOfPoints(); ++ptId)
+    {
+      double x0[3], x[3];
+      input->GetPoint(ptId, x0);
+      output->GetPoint(ptId, x);
+      if (x[0] != x0[0] || x[1] != x0[1] || x[2] != x0[2])
+      {
+        std::cout << "Level " << level << " moved input point " << ptId << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// The linear subdivision of one level splits each triangle (p0, p1, p2) in
+// four, the last one joining the midpoints of (p0, p1), (p1, p2) and (p2, p0).
+int TestLinearMidpoints(vtkPolyData* input)
+{
+  vtkSmartPointer<vtkLinearSubdivisionFilter> subdivision =
+    vtkSmartPointer<vtkLinearSubdivisionFilter>::New();
+  subdivision->SetInputData(input);
+  subdivision->SetNumberOfSubdivisions(1);
+  subdivision->Update();
+  vtkPolyData* output = subdivision->GetOutput();
+
+  vtkSmartPointer<vtkIdList> inIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> outIds = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    input->GetCellPoints(cellId, inIds);
+    output->GetCellPoints(4 * cellId, outIds);
+    if (outIds->GetId(0) != inIds->GetId(0))
+    {
+      std::cout << "Triangle " << 4 * cellId << " does not start at point " << inIds->GetId(0)
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    output->GetCellPoints(4 * cellId + 3, outIds);
+    for (int i = 0; i < 3; ++i)
+    {
+      double x0[3], x1[3], x[3];
+      input->GetPoint(inIds->GetId(i), x0);
+      input->GetPoint(inIds->GetId((i + 1) % 3), x1);
+      output->GetPoint(outIds->GetId(i), x);
+      for (int k = 0; k < 3; ++k)
+      {
+        if (std::abs(x[k] - 0.5 * (x0[k] + x1[k])) > 1.0e-6)
+        {
+          std::cout << "Point " << outIds->GetId(i) << " is not the midpoint of an edge of cell "
+                    << cellId << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+}
+
 template <typename T>
 int TestSubdivision();
 
@@ -187,6 +341,42 @@ int TestSubdivision()
     std::cout << "FAILED" << std::endl;
   }
 
+  std::cout << "  Testing known counts...";
+  vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(16);
+  sphere->SetPhiResolution(8);
+  sphere->Update();
+  vtkSmartPointer<vtkPolyData> spherePolyData = vtkSmartPointer<vtkPolyData>::New();
+  spherePolyData->ShallowCopy(sphere->GetOutput());
+  const bool interpolating = subdivision0->IsA("vtkInterpolatingSubdivisionFilter") != 0;
+  vtkSmartPointer<T> subdivision1 = vtkSmartPointer<T>::New();
+  vtkSmartPointer<T> subdivision2 = vtkSmartPointer<T>::New();
+  if (TestSubdivisionCounts(subdivision1, MakeGrid(), 1, interpolating) == EXIT_SUCCESS &&
+    TestSubdivisionCounts(subdivision2, spherePolyData, 2, interpolating) == EXIT_SUCCESS)
+  {
+    std::cout << "PASSED" << std::endl;
+  }
+  else
+  {
+    status++;
+    std::cout << "FAILED" << std::endl;
+  }
+
+  if (vtkLinearSubdivisionFilter::SafeDownCast(subdivision0))
+  {
+    std::cout << "  Testing midpoints...";
+    if (TestLinearMidpoints(MakeGrid()) == EXIT_SUCCESS &&
+      TestLinearMidpoints(spherePolyData) == EXIT_SUCCESS)
+    {
+      std::cout << "PASSED" << std::endl;
+    }
+    else
+    {
+      status++;
+      std::cout << "FAILED" << std::endl;
+    }
+  }
+
   std::cout << "PASSED" << std::endl;
   // End of test
   if (status)
@@ -57,6 +57,9 @@ int vtkButterflySubdivisionFilter::GenerateSubdivisionPoints(
   double weights1[256];
   double weights2[256];
 
+  // Generate topology for the input dataset
+  inputDS->BuildLinks();
+
   // Create an edge table to keep track of which edges we've processed
   edgeTable->InitEdgeInsertion(inputDS->GetNumberOfPoints());
 
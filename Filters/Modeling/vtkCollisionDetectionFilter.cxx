@@ -48,6 +48,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCommand.h"
+#include "vtkDataArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
@@ -64,6 +65,9 @@
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -71,6 +75,11 @@
 #include "vtkTrivialProducer.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
 vtkStandardNewMacro(vtkCollisionDetectionFilter);
 
 // Constructs with initial 0 values.
@@ -281,168 +290,312 @@ vtkMatrix4x4* vtkCollisionDetectionFilter::GetMatrix(int i)
   return this->Matrix[i];
 }
 
-static int ComputeCollisions(
-  vtkOBBNode* nodeA, vtkOBBNode* nodeB, vtkMatrix4x4* Xform, void* clientdata)
+namespace
 {
-  // This is hard-coded for triangles but could be easily changed to allow for allow n-sided
-  // polygons
-  int numIdsA, numIdsB;
-  vtkIdList *IdsA, *IdsB, *pointIdsA, *pointIdsB;
-  vtkCellArray* cells;
-  vtkIdType cellPtIds[2];
-  vtkIdTypeArray *contactcells1, *contactcells2;
-  vtkPoints* contactpoints;
-  IdsA = nodeA->Cells;
-  IdsB = nodeB->Cells;
-  numIdsA = IdsA->GetNumberOfIds();
-  numIdsB = IdsB->GetNumberOfIds();
+// A contact between a cell of input 0 and a cell of input 1. The points of
+// contact are in the coordinates of input 0.
+struct Contact
+{
+  vtkIdType CellIdA;
+  vtkIdType CellIdB;
+  double X1[3];
+  double X2[3];
+};
 
-  // clientdata is a pointer to this object... need to cast it as such
-  vtkCollisionDetectionFilter* self = reinterpret_cast<vtkCollisionDetectionFilter*>(clientdata);
+using LeafPair = std::pair<vtkOBBNode*, vtkOBBNode*>;
 
-  // Turn off debugging here if its on... otherwise there's squawks every update/box test
-  int DebugWasOn = 0;
-  int FirstContact = 0;
-  if (self->GetDebug())
-  {
-    self->DebugOff();
-    DebugWasOn = 1;
-  }
-  vtkPolyData* inputA = vtkPolyData::SafeDownCast(self->GetInput(0));
-  vtkPolyData* inputB = vtkPolyData::SafeDownCast(self->GetInput(1));
-  contactcells1 = self->GetContactCells(0);
-  contactcells2 = self->GetContactCells(1);
-  contactpoints = self->GetOutput(2)->GetPoints();
-
-  if (self->GetCollisionMode() == vtkCollisionDetectionFilter::VTK_ALL_CONTACTS)
-  {
-    cells = self->GetOutput(2)->GetLines();
-  }
-  else
-  {
-    cells = self->GetOutput(2)->GetVerts();
-  }
+// Callback of vtkOBBTree::IntersectWithOBBTree() gathering the intersecting
+// leaf nodes, so that their cells can be tested concurrently.
+int CollectLeafPairs(vtkOBBNode* nodeA, vtkOBBNode* nodeB, vtkMatrix4x4*, void* arg)
+{
+  static_cast<std::vector<LeafPair>*>(arg)->emplace_back(nodeA, nodeB);
+  return 1;
+}
 
-  float Tolerance = self->GetCellTolerance();
-  if (self->GetCollisionMode() == vtkCollisionDetectionFilter::VTK_FIRST_CONTACT)
-  {
-    FirstContact = 1;
+// Test the cells of a pair of intersecting leaf nodes for collision and
+// append the contacts found. In VTK_FIRST_CONTACT mode the test stops at the
+// first contact. The point ids and the transformed points of cells B are
+// stored in the scratch arguments, so this is thread safe once the cells of
+// the inputs are built.
+void CollideLeafPair(vtkCollisionDetectionFilter* self, int collisionMode, float Tolerance,
+  vtkPolyData* inputA, vtkPolyData* inputB, const LeafPair& pair, vtkMatrix4x4* Xform,
+  vtkIdList* pointIds, std::vector<double>& pointsB, std::vector<Contact>& contacts)
+{
+  // This is hard-coded for triangles but could be easily changed to allow for allow n-sided
+  // polygons
+  vtkIdList* IdsA = pair.first->Cells;
+  vtkIdList* IdsB = pair.second->Cells;
+  vtkIdType numIdsA = IdsA->GetNumberOfIds();
+  vtkIdType numIdsB = IdsB->GetNumberOfIds();
+  vtkPoints* pointsA = inputA->GetPoints();
+  vtkIdType npts;
+  const vtkIdType* pts;
+  double x1[3], x2[3];
+  double ptsA[9], boundsA[6], point[3], in[4], out[4];
+
+  // Transform the vertices of cells B and compute their bounds once, rather
+  // than for each cell A. Each cell B uses 9 coordinates followed by 6 bounds.
+  pointsB.resize(15 * numIdsB);
+  for (vtkIdType m = 0; m < numIdsB; m++)
+  {
+    double* ptsB = pointsB.data() + 15 * m;
+    double* boundsB = ptsB + 9;
+    inputB->GetCellPoints(IdsB->GetId(m), npts, pts, pointIds);
+    for (int n = 0; n < 3; n++)
+    {
+      inputB->GetPoints()->GetPoint(pts[n], point);
+      // transform the vertex
+      in[0] = point[0];
+      in[1] = point[1];
+      in[2] = point[2];
+      in[3] = 1.0;
+      Xform->MultiplyPoint(in, out);
+      out[0] = out[0] / out[3];
+      out[1] = out[1] / out[3];
+      out[2] = out[2] / out[3];
+      for (int p = 0; p < 3; p++)
+      {
+        ptsB[n * 3 + p] = out[p];
+      }
+    }
+    // Calculate the bounds for the xformed cell
+    boundsB[0] = boundsB[2] = boundsB[4] = VTK_DOUBLE_MAX;
+    boundsB[1] = boundsB[3] = boundsB[5] = VTK_DOUBLE_MIN;
+    for (int v = 0; v < 9; v = v + 3)
+    {
+      boundsB[0] = std::min(ptsB[v], boundsB[0]);
+      boundsB[1] = std::max(ptsB[v], boundsB[1]);
+      boundsB[2] = std::min(ptsB[v + 1], boundsB[2]);
+      boundsB[3] = std::max(ptsB[v + 1], boundsB[3]);
+      boundsB[4] = std::min(ptsB[v + 2], boundsB[4]);
+      boundsB[5] = std::max(ptsB[v + 2], boundsB[5]);
+    }
   }
-  vtkIdType cellIdA, cellIdB;
-
-  double x1[4], x2[4], xnew[4];
-  double ptsA[9], ptsB[9];
-  double boundsA[6], boundsB[6];
-  vtkIdType i, j, k, m, n, p, v;
-  double *point, in[4], out[4];
 
   // Loop thru the cells/points in IdsA
-  for (i = 0; i < numIdsA; i++)
+  for (vtkIdType i = 0; i < numIdsA; i++)
   {
-    cellIdA = IdsA->GetId(i);
-    pointIdsA = inputA->GetCell(cellIdA)->GetPointIds();
+    vtkIdType cellIdA = IdsA->GetId(i);
+    inputA->GetCellPoints(cellIdA, npts, pts, pointIds);
     inputA->GetCellBounds(cellIdA, boundsA);
-
-    // Initialize ptsA
-    // It might speed things up if ptsA and ptsB only had to be an
-    // array of pointers to the cell vertices, rather than allocating here.
-    for (j = 0; j < 3; j++)
+    for (int j = 0; j < 3; j++)
     {
-      for (k = 0; k < 3; k++)
-      {
-        ptsA[j * 3 + k] = inputA->GetPoints()->GetPoint(pointIdsA->GetId(j))[k];
-      }
+      pointsA->GetPoint(pts[j], ptsA + 3 * j);
     }
 
     // Loop thru each cell IdsB and test for collision
-    for (m = 0; m < numIdsB; m++)
+    for (vtkIdType m = 0; m < numIdsB; m++)
     {
-      cellIdB = IdsB->GetId(m);
-      pointIdsB = inputB->GetCell(cellIdB)->GetPointIds();
-      inputB->GetCellBounds(cellIdB, boundsB);
-
-      // Initialize ptsB
-      for (n = 0; n < 3; n++)
+      double* ptsB = pointsB.data() + 15 * m;
+      if (self->IntersectPolygonWithPolygon(
+            3, ptsA, boundsA, 3, ptsB, ptsB + 9, Tolerance, x1, x2, collisionMode))
       {
-        point = inputB->GetPoints()->GetPoint(pointIdsB->GetId(n));
-        // transform the vertex
-        in[0] = point[0];
-        in[1] = point[1];
-        in[2] = point[2];
-        in[3] = 1.0;
-        Xform->MultiplyPoint(in, out);
-        out[0] = out[0] / out[3];
-        out[1] = out[1] / out[3];
-        out[2] = out[2] / out[3];
-        for (p = 0; p < 3; p++)
+        Contact contact;
+        contact.CellIdA = cellIdA;
+        contact.CellIdB = IdsB->GetId(m);
+        std::copy(x1, x1 + 3, contact.X1);
+        std::copy(x2, x2 + 3, contact.X2);
+        contacts.push_back(contact);
+        if (collisionMode == vtkCollisionDetectionFilter::VTK_FIRST_CONTACT)
         {
-          ptsB[n * 3 + p] = out[p];
+          return;
         }
       }
-      // Calculate the bounds for the xformed cell
-      boundsB[0] = boundsB[2] = boundsB[4] = VTK_DOUBLE_MAX;
-      boundsB[1] = boundsB[3] = boundsB[5] = VTK_DOUBLE_MIN;
-      for (v = 0; v < 9; v = v + 3)
+    }
+  }
+}
+
+// Test the cells of the intersecting leaf nodes concurrently. The contacts of
+// each pair of leaf nodes are kept apart, so that they are merged in the
+// order of the tree traversal. In VTK_FIRST_CONTACT mode, the pairs after
+// the first one found in contact are skipped.
+struct CollideLeafPairs
+{
+  vtkCollisionDetectionFilter* Self;
+  int CollisionMode;
+  float Tolerance;
+  vtkPolyData* InputA;
+  vtkPolyData* InputB;
+  vtkMatrix4x4* Xform;
+  const std::vector<LeafPair>& Pairs;
+  std::vector<std::vector<Contact>>& Contacts;
+  std::atomic<vtkIdType> FirstContactPair;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+  vtkSMPThreadLocal<std::vector<double>> PointsB;
+
+  CollideLeafPairs(vtkCollisionDetectionFilter* self, int collisionMode, float tolerance,
+    vtkPolyData* inputA, vtkPolyData* inputB, vtkMatrix4x4* xform,
+    const std::vector<LeafPair>& pairs, std::vector<std::vector<Contact>>& contacts)
+    : Self(self)
+    , CollisionMode(collisionMode)
+    , Tolerance(tolerance)
+    , InputA(inputA)
+    , InputB(inputB)
+    , Xform(xform)
+    , Pairs(pairs)
+    , Contacts(contacts)
+    , FirstContactPair(static_cast<vtkIdType>(pairs.size()))
+  {
+  }
+
+  void operator()(vtkIdType beginPair, vtkIdType endPair)
+  {
+    const bool firstContact =
+      this->CollisionMode == vtkCollisionDetectionFilter::VTK_FIRST_CONTACT;
+    vtkIdList* pointIds = this->PointIds.Local();
+    std::vector<double>& pointsB = this->PointsB.Local();
+    for (vtkIdType pairId = beginPair; pairId < endPair; ++pairId)
+    {
+      if (firstContact && pairId > this->FirstContactPair)
       {
-        if (ptsB[v] < boundsB[0])
-          boundsB[0] = ptsB[v];
-        if (ptsB[v] > boundsB[1])
-          boundsB[1] = ptsB[v];
-        if (ptsB[v + 1] < boundsB[2])
-          boundsB[2] = ptsB[v + 1];
-        if (ptsB[v + 1] > boundsB[3])
-          boundsB[3] = ptsB[v + 1];
-        if (ptsB[v + 2] < boundsB[4])
-          boundsB[4] = ptsB[v + 2];
-        if (ptsB[v + 2] > boundsB[5])
-          boundsB[5] = ptsB[v + 2];
+        return;
       }
-      // Test for intersection
-      if (contactcells1 && contactcells2 &&
-        self->IntersectPolygonWithPolygon(
-          3, ptsA, boundsA, 3, ptsB, boundsB, Tolerance, x1, x2, self->GetCollisionMode()))
+      std::vector<Contact>& contacts = this->Contacts[pairId];
+      CollideLeafPair(this->Self, this->CollisionMode, this->Tolerance, this->InputA, this->InputB,
+        this->Pairs[pairId], this->Xform, pointIds, pointsB, contacts);
+      if (firstContact && !contacts.empty())
       {
-        contactcells1->InsertNextValue(cellIdA);
-        contactcells2->InsertNextValue(cellIdB);
-        // transform x back to "world space"
-        // could speed this up by testing for identity matrix
-        // and skipping the next transform.
-        x1[3] = x2[3] = 1.0;
-        self->GetMatrix(0)->MultiplyPoint(x1, xnew);
-        xnew[0] = xnew[0] / xnew[3];
-        xnew[1] = xnew[1] / xnew[3];
-        xnew[2] = xnew[2] / xnew[3];
-        cellPtIds[0] = contactpoints->InsertNextPoint(xnew);
-        if (self->GetCollisionMode() == vtkCollisionDetectionFilter::VTK_ALL_CONTACTS)
-        {
-          self->GetMatrix(0)->MultiplyPoint(x2, xnew);
-          xnew[0] = xnew[0] / xnew[3];
-          xnew[1] = xnew[1] / xnew[3];
-          xnew[2] = xnew[2] / xnew[3];
-          cellPtIds[1] = contactpoints->InsertNextPoint(xnew);
-          // insert a new line
-          cells->InsertNextCell(2, cellPtIds);
-        }
-        else
+        vtkIdType first = this->FirstContactPair;
+        while (pairId < first && !this->FirstContactPair.compare_exchange_weak(first, pairId))
         {
-          // insert a new vert
-          cells->InsertNextCell(1, cellPtIds);
         }
+        return;
+      }
+    }
+  }
+};
 
-        if (FirstContact)
+// Count the contacts of many poses concurrently. Each pose is tested
+// serially, from the traversal of the OBB trees to the cell tests.
+struct CollidePoses
+{
+  vtkCollisionDetectionFilter* Self;
+  int CollisionMode;
+  float Tolerance;
+  vtkPolyData* InputA;
+  vtkPolyData* InputB;
+  vtkOBBTree* TreeA;
+  vtkOBBTree* TreeB;
+  vtkDataArray* Poses0;
+  vtkDataArray* Poses1;
+  vtkIdType* NumberOfContacts;
+  vtkSMPThreadLocalObject<vtkMatrix4x4> Xform;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+  vtkSMPThreadLocal<std::vector<double>> PointsB;
+  vtkSMPThreadLocal<std::vector<LeafPair>> Pairs;
+  vtkSMPThreadLocal<std::vector<Contact>> Contacts;
+
+  CollidePoses(vtkCollisionDetectionFilter* self, int collisionMode, float tolerance,
+    vtkPolyData* inputA, vtkPolyData* inputB, vtkOBBTree* treeA, vtkOBBTree* treeB,
+    vtkDataArray* poses0, vtkDataArray* poses1, vtkIdType* numberOfContacts)
+    : Self(self)
+    , CollisionMode(collisionMode)
+    , Tolerance(tolerance)
+    , InputA(inputA)
+    , InputB(inputB)
+    , TreeA(treeA)
+    , TreeB(treeB)
+    , Poses0(poses0)
+    , Poses1(poses1)
+    , NumberOfContacts(numberOfContacts)
+  {
+  }
+
+  void Initialize() {}
+
+  void operator()(vtkIdType beginPose, vtkIdType endPose)
+  {
+    const bool firstContact =
+      this->CollisionMode == vtkCollisionDetectionFilter::VTK_FIRST_CONTACT;
+    vtkMatrix4x4* xform = this->Xform.Local();
+    vtkIdList* pointIds = this->PointIds.Local();
+    std::vector<double>& pointsB = this->PointsB.Local();
+    std::vector<LeafPair>& pairs = this->Pairs.Local();
+    std::vector<Contact>& contacts = this->Contacts.Local();
+    double matrix0[16], matrix1[16], inverse0[16], matrix[16];
+    for (vtkIdType poseId = beginPose; poseId < endPose; ++poseId)
+    {
+      this->Poses0->GetTuple(poseId, matrix0);
+      this->Poses1->GetTuple(poseId, matrix1);
+      vtkMatrix4x4::Invert(matrix0, inverse0);
+      // the sequence of multiplication is significant
+      vtkMatrix4x4::Multiply4x4(inverse0, matrix1, matrix);
+      xform->DeepCopy(matrix);
+
+      pairs.clear();
+      contacts.clear();
+      this->TreeA->IntersectWithOBBTree(this->TreeB, xform, CollectLeafPairs, &pairs);
+      for (const LeafPair& pair : pairs)
+      {
+        CollideLeafPair(this->Self, this->CollisionMode, this->Tolerance, this->InputA,
+          this->InputB, pair, xform, pointIds, pointsB, contacts);
+        if (firstContact && !contacts.empty())
         {
-          // return the negative of the number of box tests to find first contact
-          // this will call a halt to the proceedings
-          if (DebugWasOn)
-            self->DebugOn();
-          return (-1 - self->GetNumberOfBoxTests());
+          break;
         }
       }
+      this->NumberOfContacts[poseId] = static_cast<vtkIdType>(contacts.size());
     }
   }
-  if (DebugWasOn)
-    self->DebugOn();
-  return 1;
+
+  void Reduce() {}
+};
+} // anonymous namespace
+
+// The OBB trees are built in the coordinates of each input and the relative
+// transform is applied while they are traversed, so they are only rebuilt when
+// the inputs or the tree parameters change, never when a transform changes.
+void vtkCollisionDetectionFilter::BuildOBBTrees(vtkPolyData* input0, vtkPolyData* input1)
+{
+  // The box tolerance is not used to build the trees, but setting it modifies
+  // them. Set it first so that the next execution does not rebuild them.
+  this->Tree0->SetTolerance(this->BoxTolerance);
+  this->Tree1->SetTolerance(this->BoxTolerance);
+
+  // rebuild the obb trees... they do their own mtime checking with input data
+  this->Tree0->SetDataSet(input0);
+  this->Tree0->AutomaticOn();
+  this->Tree0->SetNumberOfCellsPerNode(this->NumberOfCellsPerNode);
+  this->Tree0->BuildLocator();
+
+  this->Tree1->SetDataSet(input1);
+  this->Tree1->AutomaticOn();
+  this->Tree1->SetNumberOfCellsPerNode(this->NumberOfCellsPerNode);
+  this->Tree1->BuildLocator();
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkCollisionDetectionFilter::ComputeNumberOfContacts(
+  vtkDataArray* poses0, vtkDataArray* poses1, vtkIdTypeArray* numberOfContacts)
+{
+  vtkPolyData* input0 = this->GetInputData(0);
+  vtkPolyData* input1 = this->GetInputData(1);
+  if (!input0 || !input1 || !poses0 || !poses1 || !numberOfContacts)
+  {
+    vtkErrorMacro(<< "Two inputs, two arrays of poses and an output array are required");
+    return -1;
+  }
+  if (poses0->GetNumberOfComponents() != 16 || poses1->GetNumberOfComponents() != 16 ||
+    poses0->GetNumberOfTuples() != poses1->GetNumberOfTuples())
+  {
+    vtkErrorMacro(<< "The poses must be arrays of 4x4 matrices with the same number of tuples");
+    return -1;
+  }
+
+  this->BuildOBBTrees(input0, input1);
+  vtkIdType numPoses = poses0->GetNumberOfTuples();
+  numberOfContacts->SetNumberOfComponents(1);
+  numberOfContacts->SetNumberOfTuples(numPoses);
+  CollidePoses collide(this, this->CollisionMode, this->CellTolerance, input0, input1,
+    this->Tree0, this->Tree1, poses0, poses1, numberOfContacts->GetPointer(0));
+  vtkSMPTools::For(0, numPoses, collide);
+
+  vtkIdType totalContacts = 0;
+  for (vtkIdType poseId = 0; poseId < numPoses; ++poseId)
+  {
+    totalContacts += numberOfContacts->GetValue(poseId);
+  }
+  return totalContacts;
 }
 
 // Description:
@@ -525,29 +678,68 @@ int vtkCollisionDetectionFilter::RequestData(vtkInformation* vtkNotUsed(request)
   }
   this->InvokeEvent(vtkCommand::StartEvent, nullptr);
 
-  // rebuild the obb trees... they do their own mtime checking with input data
-  Tree0->SetDataSet(input[0]);
-  Tree0->AutomaticOn();
-  Tree0->SetNumberOfCellsPerNode(this->NumberOfCellsPerNode);
-  Tree0->BuildLocator();
-
-  Tree1->SetDataSet(input[1]);
-  Tree1->AutomaticOn();
-  Tree1->SetNumberOfCellsPerNode(this->NumberOfCellsPerNode);
-  Tree1->BuildLocator();
+  this->BuildOBBTrees(input[0], input[1]);
 
-  // Set the Box Tolerance
-  Tree0->SetTolerance(this->BoxTolerance);
-  Tree1->SetTolerance(this->BoxTolerance);
+  // Gather the intersecting leaf nodes, then test their cells concurrently.
+  std::vector<LeafPair> pairs;
+  Tree0->IntersectWithOBBTree(Tree1, matrix, CollectLeafPairs, &pairs);
+  std::vector<std::vector<Contact>> contacts(pairs.size());
+  CollideLeafPairs collide(
+    this, this->CollisionMode, this->CellTolerance, input[0], input[1], matrix, pairs, contacts);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(pairs.size()), collide);
 
-  // Do the collision detection...
-  int boxTests = Tree0->IntersectWithOBBTree(Tree1, matrix, ComputeCollisions, this);
+  // Merge the contacts in the order of the tree traversal. The contact
+  // points are transformed back to "world space".
+  vtkIdType numPairs = static_cast<vtkIdType>(pairs.size());
+  if (this->CollisionMode == VTK_FIRST_CONTACT && collide.FirstContactPair < numPairs)
+  {
+    // only the box tests up to the first contact are needed
+    numPairs = collide.FirstContactPair + 1;
+  }
+  vtkMatrix4x4* matrix0 = this->GetMatrix(0);
+  vtkCellArray* cells = this->CollisionMode == VTK_ALL_CONTACTS ? output[2]->GetLines()
+                                                                 : output[2]->GetVerts();
+  vtkIdType cellPtIds[2];
+  double x[4], xnew[4];
+  for (vtkIdType pairId = 0; pairId < numPairs; ++pairId)
+  {
+    for (const Contact& contact : contacts[pairId])
+    {
+      contactcells0->InsertNextValue(contact.CellIdA);
+      contactcells1->InsertNextValue(contact.CellIdB);
+      // could speed this up by testing for identity matrix
+      // and skipping the next transform.
+      std::copy(contact.X1, contact.X1 + 3, x);
+      x[3] = 1.0;
+      matrix0->MultiplyPoint(x, xnew);
+      xnew[0] = xnew[0] / xnew[3];
+      xnew[1] = xnew[1] / xnew[3];
+      xnew[2] = xnew[2] / xnew[3];
+      cellPtIds[0] = contactsPoints->InsertNextPoint(xnew);
+      if (this->CollisionMode == VTK_ALL_CONTACTS)
+      {
+        std::copy(contact.X2, contact.X2 + 3, x);
+        matrix0->MultiplyPoint(x, xnew);
+        xnew[0] = xnew[0] / xnew[3];
+        xnew[1] = xnew[1] / xnew[3];
+        xnew[2] = xnew[2] / xnew[3];
+        cellPtIds[1] = contactsPoints->InsertNextPoint(xnew);
+        // insert a new line
+        cells->InsertNextCell(2, cellPtIds);
+      }
+      else
+      {
+        // insert a new vert
+        cells->InsertNextCell(1, cellPtIds);
+      }
+    }
+  }
 
   matrix->Delete();
   tmpMatrix->Delete();
 
   vtkDebugMacro(<< "Collision detection finished");
-  this->NumberOfBoxTests = std::abs(boxTests);
+  this->NumberOfBoxTests = static_cast<int>(numPairs);
 
   // Generate the scalars if needed
   if (GenerateScalars)
@@ -57,6 +57,11 @@
  *  This class can be used to clip one polydata surface with another,
  *  using the Contacts output as a loop set in vtkSelectPolyData
  *
+ *  The OBB trees are built in the coordinates of each input, so they are
+ *  kept when only the transforms or matrices change. The cells of the
+ *  intersecting tree leaves are tested concurrently with vtkSMPTools, and
+ *  ComputeNumberOfContacts() tests many poses at once.
+ *
  * @authors Goodwin Lawlor, Bill Lorensen
  */
 
@@ -95,6 +100,7 @@
 #include "vtkFiltersModelingModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
+class vtkDataArray;
 class vtkOBBTree;
 class vtkPolyData;
 class vtkPoints;
@@ -238,6 +244,19 @@ public:
   int GetNumberOfContacts();
   ///@}
 
+  /**
+   * Count the contacting cell pairs of the two inputs for many poses at once.
+   * Each tuple of poses0 and poses1 holds the 16 elements of a 4x4 matrix,
+   * in the row-major order of vtkMatrix4x4::GetData(), placing input 0 and
+   * input 1 respectively. The number of contacts of each pose is stored in
+   * numberOfContacts; it is either 0 or 1 in FirstContact mode. The poses are
+   * tested concurrently and the OBB trees are reused, but no output is
+   * generated. The inputs must be up to date, for instance by calling
+   * Update() first. Returns the total number of contacts, or -1 on error.
+   */
+  vtkIdType ComputeNumberOfContacts(
+    vtkDataArray* poses0, vtkDataArray* poses1, vtkIdTypeArray* numberOfContacts);
+
   ///@{Description:
   /*
    * Get the number of box tests
@@ -275,6 +294,10 @@ protected:
 
   // Usual data generation method
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  // Build the OBB trees of the inputs, unless they are up to date.
+  void BuildOBBTrees(vtkPolyData* input0, vtkPolyData* input1);
+
   vtkOBBTree* Tree0;
   vtkOBBTree* Tree1;
 
@@ -46,14 +46,65 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 
-#include "vtkCellLocator.h"
 #include "vtkGenericCell.h"
-#include "vtkKdTreePointLocator.h"
 #include "vtkPointSet.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStaticPointLocator.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkHausdorffDistancePointSetFilter);
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Compute concurrently the distance from each point of the source to the
+// target, using either the point locator or the cell locator of the target.
+// Return the largest distance.
+double ComputeDistances(vtkPointSet* source, vtkPointSet* target,
+  vtkStaticPointLocator* pointLocator, vtkStaticCellLocator* cellLocator,
+  vtkDoubleArray* distances)
+{
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPTools::For(0, source->GetNumberOfPoints(), [&](vtkIdType ptId, vtkIdType endPtId) {
+    vtkGenericCell* cell = tlCell.Local();
+    double dist;
+    double currentPoint[3];
+    double closestPoint[3];
+    vtkIdType cellId;
+    int subId;
+    for (; ptId < endPtId; ptId++)
+    {
+      source->GetPoint(ptId, currentPoint);
+      if (pointLocator)
+      {
+        vtkIdType closestPointId = pointLocator->FindClosestPoint(currentPoint);
+        target->GetPoint(closestPointId, closestPoint);
+      }
+      else
+      {
+        cellLocator->FindClosestPoint(currentPoint, closestPoint, cell, cellId, subId, dist);
+      }
+
+      dist = std::sqrt(std::pow(currentPoint[0] - closestPoint[0], 2) +
+        std::pow(currentPoint[1] - closestPoint[1], 2) +
+        std::pow(currentPoint[2] - closestPoint[2], 2));
+      distances->SetValue(ptId, dist);
+    }
+  });
+
+  double maxDist = 0.0;
+  for (vtkIdType ptId = 0; ptId < source->GetNumberOfPoints(); ptId++)
+  {
+    maxDist = std::max(maxDist, distances->GetValue(ptId));
+  }
+  return maxDist;
+}
+}
+
 //------------------------------------------------------------------------------
 vtkHausdorffDistancePointSetFilter::vtkHausdorffDistancePointSetFilter()
 {
@@ -104,38 +155,30 @@ int vtkHausdorffDistancePointSetFilter::RequestData(vtkInformation* vtkNotUsed(r
   this->RelativeDistance[1] = 0.0;
   this->HausdorffDistance = 0.0;
 
-  // TODO: using vtkStaticCellLocator, vtkStaticPointLocator is going to be much faster.
-  // Need to investigate and replace if appropriate.
-  vtkSmartPointer<vtkKdTreePointLocator> pointLocatorA =
-    vtkSmartPointer<vtkKdTreePointLocator>::New();
-  vtkSmartPointer<vtkKdTreePointLocator> pointLocatorB =
-    vtkSmartPointer<vtkKdTreePointLocator>::New();
-
-  vtkSmartPointer<vtkCellLocator> cellLocatorA = vtkSmartPointer<vtkCellLocator>::New();
-  vtkSmartPointer<vtkCellLocator> cellLocatorB = vtkSmartPointer<vtkCellLocator>::New();
+  vtkSmartPointer<vtkStaticPointLocator> pointLocatorA;
+  vtkSmartPointer<vtkStaticPointLocator> pointLocatorB;
+  vtkSmartPointer<vtkStaticCellLocator> cellLocatorA;
+  vtkSmartPointer<vtkStaticCellLocator> cellLocatorB;
 
   if (this->TargetDistanceMethod == POINT_TO_POINT)
   {
+    pointLocatorA = vtkSmartPointer<vtkStaticPointLocator>::New();
     pointLocatorA->SetDataSet(inputA);
     pointLocatorA->BuildLocator();
+    pointLocatorB = vtkSmartPointer<vtkStaticPointLocator>::New();
     pointLocatorB->SetDataSet(inputB);
     pointLocatorB->BuildLocator();
   }
   else
   {
+    cellLocatorA = vtkSmartPointer<vtkStaticCellLocator>::New();
     cellLocatorA->SetDataSet(inputA);
     cellLocatorA->BuildLocator();
+    cellLocatorB = vtkSmartPointer<vtkStaticCellLocator>::New();
     cellLocatorB->SetDataSet(inputB);
     cellLocatorB->BuildLocator();
   }
 
-  double dist;
-  double currentPoint[3];
-  double closestPoint[3];
-  vtkIdType cellId;
-  vtkSmartPointer<vtkGenericCell> cell = vtkSmartPointer<vtkGenericCell>::New();
-  int subId;
-
   vtkSmartPointer<vtkDoubleArray> distanceAToB = vtkSmartPointer<vtkDoubleArray>::New();
   distanceAToB->SetNumberOfComponents(1);
   distanceAToB->SetNumberOfTuples(inputA->GetNumberOfPoints());
@@ -146,55 +189,12 @@ int vtkHausdorffDistancePointSetFilter::RequestData(vtkInformation* vtkNotUsed(r
   distanceBToA->SetNumberOfTuples(inputB->GetNumberOfPoints());
   distanceBToA->SetName("Distance");
 
-  // Find the nearest neighbors to each point and add edges between them,
-  // if they do not already exist and they are not self loops
-  for (int i = 0; i < inputA->GetNumberOfPoints(); i++)
-  {
-    inputA->GetPoint(i, currentPoint);
-    if (this->TargetDistanceMethod == POINT_TO_POINT)
-    {
-      vtkIdType closestPointId = pointLocatorB->FindClosestPoint(currentPoint);
-      inputB->GetPoint(closestPointId, closestPoint);
-    }
-    else
-    {
-      cellLocatorB->FindClosestPoint(currentPoint, closestPoint, cell, cellId, subId, dist);
-    }
-
-    dist = std::sqrt(std::pow(currentPoint[0] - closestPoint[0], 2) +
-      std::pow(currentPoint[1] - closestPoint[1], 2) +
-      std::pow(currentPoint[2] - closestPoint[2], 2));
-    distanceAToB->SetValue(i, dist);
-
-    if (dist > this->RelativeDistance[0])
-    {
-      this->RelativeDistance[0] = dist;
-    }
-  }
-
-  for (int i = 0; i < inputB->GetNumberOfPoints(); i++)
-  {
-    inputB->GetPoint(i, currentPoint);
-    if (this->TargetDistanceMethod == POINT_TO_POINT)
-    {
-      vtkIdType closestPointId = pointLocatorA->FindClosestPoint(currentPoint);
-      inputA->GetPoint(closestPointId, closestPoint);
-    }
-    else
-    {
-      cellLocatorA->FindClosestPoint(currentPoint, closestPoint, cell, cellId, subId, dist);
-    }
-
-    dist = std::sqrt(std::pow(currentPoint[0] - closestPoint[0], 2) +
-      std::pow(currentPoint[1] - closestPoint[1], 2) +
-      std::pow(currentPoint[2] - closestPoint[2], 2));
-    distanceBToA->SetValue(i, dist);
-
-    if (dist > this->RelativeDistance[1])
-    {
-      this->RelativeDistance[1] = dist;
-    }
-  }
+  // Find the distance from each point to the nearest point (or cell) of the
+  // other input
+  this->RelativeDistance[0] =
+    ComputeDistances(inputA, inputB, pointLocatorB, cellLocatorB, distanceAToB);
+  this->RelativeDistance[1] =
+    ComputeDistances(inputB, inputA, pointLocatorA, cellLocatorA, distanceBToA);
 
   if (this->RelativeDistance[0] >= RelativeDistance[1])
   {
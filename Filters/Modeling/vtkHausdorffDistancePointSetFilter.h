@@ -54,6 +54,10 @@
  * latter may differ. A PointData containing the specific point minimal
  * distance is also added to both outputs.
  *
+ * The nearest points and cells are found with vtkStaticPointLocator and
+ * vtkStaticCellLocator, and the distances are computed concurrently with
+ * vtkSMPTools.
+ *
  * @author Frederic Commandeur
  * @author Jerome Velut
  * @author LTSI
@@ -15,11 +15,15 @@
 #include "vtkLinearSubdivisionFilter.h"
 
 #include "vtkCellArray.h"
-#include "vtkEdgeTable.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 vtkStandardNewMacro(vtkLinearSubdivisionFilter);
 
@@ -28,71 +32,57 @@ void vtkLinearSubdivisionFilter::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 }
 
+//------------------------------------------------------------------------------
+// The points inserted on the edges are numbered by NumberEdgePoints(), then
+// computed in parallel.
 int vtkLinearSubdivisionFilter::GenerateSubdivisionPoints(
   vtkPolyData* inputDS, vtkIntArray* edgeData, vtkPoints* outputPts, vtkPointData* outputPD)
 {
-  const vtkIdType* pts = nullptr;
-  int edgeId;
-  vtkIdType npts, cellId, newId;
-  vtkIdType p1, p2;
   vtkCellArray* inputPolys = inputDS->GetPolys();
-  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkIdList> pointIds = vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkEdgeTable> edgeTable = vtkSmartPointer<vtkEdgeTable>::New();
   vtkPoints* inputPts = inputDS->GetPoints();
   vtkPointData* inputPD = inputDS->GetPointData();
+  const vtkIdType numPts = inputDS->GetNumberOfPoints();
   static double weights[2] = { .5, .5 };
 
-  // Create an edge table to keep track of which edges we've processed
-  edgeTable->InitEdgeInsertion(inputDS->GetNumberOfPoints());
-
-  pointIds->SetNumberOfIds(2);
-
-  double total = inputPolys->GetNumberOfCells();
-  double curr = 0;
-
-  // Generate new points for subdivisions surface
-  for (cellId = 0, inputPolys->InitTraversal(); inputPolys->GetNextCell(npts, pts); cellId++)
+  vtkNew<vtkIdTypeArray> edgeUses;
+  const vtkIdType numEdgePts = this->NumberEdgePoints(inputDS, numPts, edgeData, edgeUses);
+  if (numEdgePts < 0)
   {
-    p1 = pts[2];
-    p2 = pts[0];
-
-    for (edgeId = 0; edgeId < 3; edgeId++)
+    return 0;
+  }
+  // The output points start with a copy of the input points, which is kept
+  outputPts->GetData()->SetNumberOfValues(3 * (numPts + numEdgePts));
+  outputPD->SetNumberOfTuples(numPts + numEdgePts);
+  outputPD->CopyData(inputPD, 0, numPts, 0);
+
+  // Compute the midpoints of the edges, and their point data
+  const vtkIdType* uses = edgeUses->GetPointer(0);
+  vtkSMPThreadLocalObject<vtkIdList> localPointIds;
+  vtkSMPTools::For(0, numEdgePts, [&](vtkIdType edgePtId, vtkIdType endEdgePtId) {
+    vtkIdList* pointIds = localPointIds.Local();
+    pointIds->SetNumberOfIds(2);
+    auto iter = vtk::TakeSmartPointer(inputPolys->NewIterator());
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double x[3], x1[3], x2[3];
+    for (; edgePtId < endEdgePtId; ++edgePtId)
     {
-      outputPD->CopyData(inputPD, p1, p1);
-      outputPD->CopyData(inputPD, p2, p2);
-
-      // Do we need to create a point on this edge?
-      if (edgeTable->IsEdge(p1, p2) == -1)
-      {
-        edgeTable->InsertEdge(p1, p2);
-
-        inputDS->GetCellEdgeNeighbors(-1, p1, p2, cellIds);
-        if (cellIds->GetNumberOfIds() > 2)
-        {
-          vtkErrorMacro("Dataset is non-manifold and cannot be subdivided.");
-          return 0;
-        }
-        // Compute Position andnew PointData using the same subdivision scheme
-        pointIds->SetId(0, p1);
-        pointIds->SetId(1, p2);
-        newId = this->InterpolatePosition(inputPts, outputPts, pointIds, weights);
-        outputPD->InterpolatePoint(inputPD, newId, pointIds, weights);
-      }
-      else // we have already created a point on this edge. find it
-      {
-        newId = this->FindEdge(inputDS, cellId, p1, p2, edgeData, cellIds);
-      }
-      edgeData->InsertComponent(cellId, edgeId, newId);
-      p1 = p2;
-      if (edgeId < 2)
+      const vtkIdType use = uses[2 * edgePtId];
+      const int edgeId = static_cast<int>(use % 3);
+      iter->GetCellAtId(use / 3, npts, pts);
+      pointIds->SetId(0, pts[(edgeId + 2) % 3]);
+      pointIds->SetId(1, pts[edgeId]);
+      inputPts->GetPoint(pointIds->GetId(0), x1);
+      inputPts->GetPoint(pointIds->GetId(1), x2);
+      for (int j = 0; j < 3; j++)
       {
-        p2 = pts[edgeId + 1];
+        x[j] = x1[j] * weights[0] + x2[j] * weights[1];
       }
-    } // each edge
-    this->UpdateProgress(curr / total);
-    curr += 1;
-  } // each cell
+      const vtkIdType newId = numPts + edgePtId;
+      outputPts->SetPoint(newId, x);
+      outputPD->InterpolatePoint(inputPD, newId, pointIds, weights);
+    }
+  });
 
   return 1;
 }
@@ -20,6 +20,9 @@
  * subdividing its input polydata. Each subdivision iteration create 4
  * new triangles for each triangle in the polydata.
  *
+ * The points inserted on the edges and their point data are computed in
+ * parallel with vtkSMPTools.
+ *
  * @par Thanks:
  * This work was supported by PHS Research Grant No. 1 P41 RR13218-01
  * from the National Center for Research Resources.
@@ -12,22 +12,31 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkLoopSubdivisionFilter.h"
 
-#include "vtkCell.h"
 #include "vtkCellArray.h"
-#include "vtkCellIterator.h"
-#include "vtkEdgeTable.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkLoopSubdivisionFilter);
 
 void vtkLoopSubdivisionFilter::PrintSelf(ostream& os, vtkIndent indent)
@@ -35,92 +44,271 @@ void vtkLoopSubdivisionFilter::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 }
 
-static const double LoopWeights[4] = { .375, .375, .125, .125 };
+//------------------------------------------------------------------------------
+// The stencils of the Loop scheme are computed from the triangles and the
+// uses of their edges numbered by NumberEdgePoints(), instead of the cell
+// links, so that the points are computed in parallel.
+namespace
+{
+const double LoopWeights[4] = { .375, .375, .125, .125 };
+
+struct LoopStencils
+{
+  vtkCellArray* Polys;
+  const int* EdgePoints;
+  const vtkIdType* EdgeUses;
+  vtkIdType NumberOfPoints;
+  const std::vector<vtkIdType>& PointCells;
+  const std::vector<vtkIdType>& NumberOfPointCells;
+
+  LoopStencils(vtkCellArray* polys, vtkIntArray* edgeData, vtkIdTypeArray* edgeUses,
+    vtkIdType numPts, const std::vector<vtkIdType>& pointCells,
+    const std::vector<vtkIdType>& numPointCells)
+    : Polys(polys)
+    , EdgePoints(edgeData->GetPointer(0))
+    , EdgeUses(edgeUses->GetPointer(0))
+    , NumberOfPoints(numPts)
+    , PointCells(pointCells)
+    , NumberOfPointCells(numPointCells)
+  {
+  }
+
+  // The point of a triangle that is not on the edge (p1,p2).
+  static vtkIdType GetOppositePoint(const vtkIdType* pts, vtkIdType p1, vtkIdType p2)
+  {
+    vtkIdType p = -1;
+    for (int i = 0; i < 3; i++)
+    {
+      if ((p = pts[i]) != p1 && p != p2)
+      {
+        break;
+      }
+    }
+    return p;
+  }
+
+  // The triangle across the edge (p1,p2) of a triangle, or -1 on the boundary.
+  vtkIdType GetEdgeNeighbor(
+    vtkIdType cellId, const vtkIdType* pts, vtkIdType p1, vtkIdType p2) const
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      const vtkIdType q1 = pts[(i + 2) % 3];
+      const vtkIdType q2 = pts[i];
+      if ((q1 == p1 && q2 == p2) || (q1 == p2 && q2 == p1))
+      {
+        const vtkIdType* uses =
+          this->EdgeUses + 2 * (this->EdgePoints[3 * cellId + i] - this->NumberOfPoints);
+        const vtkIdType use = (uses[0] / 3 == cellId ? uses[1] : uses[0]);
+        return (use < 0 ? -1 : use / 3);
+      }
+    }
+    return -1;
+  }
+
+  void GenerateEvenStencil(vtkIdType p1, vtkCellArrayIterator* iter, vtkIdList* stencilIds,
+    std::vector<double>& weights) const
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    const vtkIdType numCellsInLoop = this->NumberOfPointCells[p1];
+
+    // Find an edge to start with that contains p1
+    vtkIdType nextCell = this->PointCells[p1];
+    iter->GetCellAtId(nextCell, npts, pts);
+    vtkIdType p2 = pts[0];
+    int i = 1;
+    while (p1 == p2)
+    {
+      p2 = pts[i++];
+    }
+    const vtkIdType startCell = this->GetEdgeNeighbor(nextCell, pts, p1, p2);
+    vtkIdType bp2 = -1;
+    vtkIdType bp1 = p2;
+
+    stencilIds->Reset();
+    stencilIds->InsertNextId(p2);
+
+    // walk around the loop counter-clockwise and get cells
+    vtkIdType j;
+    for (j = 0; j < numCellsInLoop; j++)
+    {
+      iter->GetCellAtId(nextCell, npts, pts);
+      p2 = LoopStencils::GetOppositePoint(pts, p1, p2);
+      stencilIds->InsertNextId(p2);
+      nextCell = this->GetEdgeNeighbor(nextCell, pts, p1, p2);
+      if (nextCell < 0)
+      {
+        bp2 = p2;
+        j++;
+        break;
+      }
+    }
+
+    // now walk around the other way. this will only happen if there
+    // is a boundary cell left that we have not visited
+    nextCell = startCell;
+    p2 = bp1;
+    for (; j < numCellsInLoop && startCell != -1; j++)
+    {
+      iter->GetCellAtId(nextCell, npts, pts);
+      p2 = LoopStencils::GetOppositePoint(pts, p1, p2);
+      stencilIds->InsertNextId(p2);
+      nextCell = this->GetEdgeNeighbor(nextCell, pts, p1, p2);
+      if (nextCell < 0)
+      {
+        bp1 = p2;
+        break;
+      }
+    }
+
+    if (bp2 != -1) // boundary edge
+    {
+      stencilIds->SetNumberOfIds(3);
+      stencilIds->SetId(0, bp2);
+      stencilIds->SetId(1, bp1);
+      stencilIds->SetId(2, p1);
+      weights.resize(3);
+      weights[0] = .125;
+      weights[1] = .125;
+      weights[2] = .75;
+    }
+    else
+    {
+      // Remove last id. It's a duplicate of the first
+      const vtkIdType K = stencilIds->GetNumberOfIds() - 1;
+      double beta;
+      if (K > 3)
+      {
+        // Generate weights
+        double cosSQ = .375 + .25 * cos(2.0 * vtkMath::Pi() / (double)K);
+        cosSQ = cosSQ * cosSQ;
+        beta = (.625 - cosSQ) / (double)K;
+      }
+      else
+      {
+        beta = 3.0 / 16.0;
+      }
+      weights.resize(K + 1);
+      for (j = 0; j < K; j++)
+      {
+        weights[j] = beta;
+      }
+      weights[K] = 1.0 - K * beta;
+      stencilIds->SetId(K, p1);
+    }
+  }
+
+  void GenerateOddStencil(vtkIdType edgePtId, vtkCellArrayIterator* iter, vtkIdList* stencilIds,
+    std::vector<double>& weights) const
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    const vtkIdType* uses = this->EdgeUses + 2 * edgePtId;
+    const int edgeId = static_cast<int>(uses[0] % 3);
+    iter->GetCellAtId(uses[0] / 3, npts, pts);
+    const vtkIdType p1 = pts[(edgeId + 2) % 3];
+    const vtkIdType p2 = pts[edgeId];
+    if (uses[1] < 0) // boundary edge
+    {
+      stencilIds->SetNumberOfIds(2);
+      stencilIds->SetId(0, p1);
+      stencilIds->SetId(1, p2);
+      weights.assign(2, .5);
+      return;
+    }
+
+    const vtkIdType p3 = LoopStencils::GetOppositePoint(pts, p1, p2);
+    iter->GetCellAtId(uses[1] / 3, npts, pts);
+    const vtkIdType p4 = LoopStencils::GetOppositePoint(pts, p1, p2);
+    stencilIds->SetNumberOfIds(4);
+    stencilIds->SetId(0, p1);
+    stencilIds->SetId(1, p2);
+    stencilIds->SetId(2, p3);
+    stencilIds->SetId(3, p4);
+    weights.assign(LoopWeights, LoopWeights + 4);
+  }
+};
+} // anonymous namespace
 
 //------------------------------------------------------------------------------
 int vtkLoopSubdivisionFilter::GenerateSubdivisionPoints(
   vtkPolyData* inputDS, vtkIntArray* edgeData, vtkPoints* outputPts, vtkPointData* outputPD)
 {
-  const vtkIdType* pts = nullptr;
-  vtkIdType numPts, cellId, newId;
-  int edgeId;
-  vtkIdType npts;
-  vtkIdType p1, p2;
   vtkCellArray* inputPolys = inputDS->GetPolys();
-  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkIdList> stencil = vtkSmartPointer<vtkIdList>::New();
-  vtkSmartPointer<vtkEdgeTable> edgeTable = vtkSmartPointer<vtkEdgeTable>::New();
   vtkPoints* inputPts = inputDS->GetPoints();
   vtkPointData* inputPD = inputDS->GetPointData();
+  const vtkIdType numPts = inputDS->GetNumberOfPoints();
 
-  double weights[256];
-
-  // Create an edge table to keep track of which edges we've processed
-  edgeTable->InitEdgeInsertion(inputDS->GetNumberOfPoints());
+  // Odd points are inserted on the edges, after the even points
+  vtkNew<vtkIdTypeArray> edgeUses;
+  const vtkIdType numEdgePts = this->NumberEdgePoints(inputDS, numPts, edgeData, edgeUses);
+  if (numEdgePts < 0)
+  {
+    return 0;
+  }
 
-  // Generate even points. these are derived from the old points
-  numPts = inputDS->GetNumberOfPoints();
-  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+  // Even points are derived from the old points and the loop of cells
+  // around them, which starts at the first cell using them
+  std::vector<vtkIdType> pointCells(numPts, -1);
+  std::vector<vtkIdType> numPointCells(numPts, 0);
+  auto iter = vtk::TakeSmartPointer(inputPolys->NewIterator());
+  for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
   {
-    if (this->GenerateEvenStencil(ptId, inputDS, stencil, weights))
+    vtkIdType npts;
+    const vtkIdType* pts;
+    iter->GetCurrentCell(npts, pts);
+    for (vtkIdType i = 0; i < npts; i++)
     {
-      this->InterpolatePosition(inputPts, outputPts, stencil, weights);
-      outputPD->InterpolatePoint(inputPD, ptId, stencil, weights);
+      if (numPointCells[pts[i]]++ == 0)
+      {
+        pointCells[pts[i]] = iter->GetCurrentCellId();
+      }
     }
-    else
+  }
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+  {
+    if (numPointCells[ptId] < 1)
     {
+      vtkWarningMacro("numCellsInLoop < 1: " << numPointCells[ptId]);
       return 0;
     }
   }
 
-  // Generate odd points. These will be inserted into the new dataset
-  for (cellId = 0, inputPolys->InitTraversal(); inputPolys->GetNextCell(npts, pts); cellId++)
-  {
-    // start with one edge
-    p1 = pts[2];
-    p2 = pts[0];
-
-    for (edgeId = 0; edgeId < 3; edgeId++)
+  // Compute the even and odd points, and their point data
+  outputPts->SetNumberOfPoints(numPts + numEdgePts);
+  outputPD->SetNumberOfTuples(numPts + numEdgePts);
+  LoopStencils stencils(inputPolys, edgeData, edgeUses, numPts, pointCells, numPointCells);
+  vtkSMPThreadLocalObject<vtkIdList> localStencils;
+  vtkSMPThreadLocal<std::vector<double>> localWeights;
+  vtkSMPTools::For(0, numPts + numEdgePts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    vtkIdList* stencil = localStencils.Local();
+    std::vector<double>& weights = localWeights.Local();
+    auto cellIter = vtk::TakeSmartPointer(inputPolys->NewIterator());
+    double x[3], xx[3];
+    for (; ptId < endPtId; ++ptId)
     {
-      // Do we need to create a point on this edge?
-      if (edgeTable->IsEdge(p1, p2) == -1)
+      if (ptId < numPts)
       {
-        edgeTable->InsertEdge(p1, p2);
-        inputDS->GetCellEdgeNeighbors(-1, p1, p2, cellIds);
-        if (cellIds->GetNumberOfIds() == 1)
-        {
-          // Compute new Position and PointData using the same subdivision scheme
-          stencil->SetNumberOfIds(2);
-          stencil->SetId(0, p1);
-          stencil->SetId(1, p2);
-          weights[0] = .5;
-          weights[1] = .5;
-        } // boundary edge
-        else if (cellIds->GetNumberOfIds() == 2)
-        {
-          this->GenerateOddStencil(p1, p2, inputDS, stencil, weights);
-        }
-        else
-        {
-          vtkErrorMacro("Dataset is non-manifold and cannot be subdivided. Edge shared by "
-            << cellIds->GetNumberOfIds() << " cells");
-          return 0;
-        }
-        newId = this->InterpolatePosition(inputPts, outputPts, stencil, weights);
-        outputPD->InterpolatePoint(inputPD, newId, stencil, weights);
+        stencils.GenerateEvenStencil(ptId, cellIter, stencil, weights);
       }
-      else // we have already created a point on this edge. find it
+      else
       {
-        newId = this->FindEdge(inputDS, cellId, p1, p2, edgeData, cellIds);
+        stencils.GenerateOddStencil(ptId - numPts, cellIter, stencil, weights);
       }
-      edgeData->InsertComponent(cellId, edgeId, newId);
-      p1 = p2;
-      if (edgeId < 2)
+      x[0] = x[1] = x[2] = 0.0;
+      for (vtkIdType i = 0; i < stencil->GetNumberOfIds(); i++)
       {
-        p2 = pts[edgeId + 1];
+        inputPts->GetPoint(stencil->GetId(i), xx);
+        for (int j = 0; j < 3; j++)
+        {
+          x[j] += xx[j] * weights[i];
+        }
       }
-    } // each interior edge
-  }   // each cell
+      outputPts->SetPoint(ptId, x);
+      outputPD->InterpolatePoint(inputPD, ptId, stencil, weights.data());
+    }
+  });
 
   return 1;
 }
@@ -141,6 +329,11 @@ int vtkLoopSubdivisionFilter::GenerateEvenStencil(
   vtkIdType K;
   double beta, cosSQ;
 
+  if (!polys->GetLinks())
+  {
+    polys->BuildLinks();
+  }
+
   // Get the cells that use this point
   polys->GetPointCells(p1, cellIds);
   vtkIdType numCellsInLoop = cellIds->GetNumberOfIds();
@@ -271,6 +464,10 @@ void vtkLoopSubdivisionFilter::GenerateOddStencil(
   vtkIdType cell0, cell1;
   vtkIdType p3 = 0, p4 = 0;
 
+  if (!polys->GetLinks())
+  {
+    polys->BuildLinks();
+  }
   polys->GetCellEdgeNeighbors(-1, p1, p2, cellIds);
   cell0 = cellIds->GetId(0);
   cell1 = cellIds->GetId(1);
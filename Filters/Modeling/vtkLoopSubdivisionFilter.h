@@ -34,6 +34,10 @@
  * The filter approximates point data using the same scheme. New
  * triangles create at a subdivision step will have the cell data of
  * their parent cell.
+ * <P>
+ * The stencils of the even and odd points are computed from the edges of
+ * the triangles, gathered with vtkStaticEdgeLocatorTemplate, and the points
+ * and their point data are computed in parallel with vtkSMPTools.
  *
  * @par Thanks:
  * This work was supported by PHS Research Grant No. 1 P41 RR13218-01
@@ -47,6 +51,7 @@
 #define vtkLoopSubdivisionFilter_h
 
 #include "vtkApproximatingSubdivisionFilter.h"
+#include "vtkDeprecation.h"           // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersModelingModule.h" // For export macro
 
 class vtkPolyData;
@@ -72,9 +77,19 @@ protected:
 
   int GenerateSubdivisionPoints(vtkPolyData* inputDS, vtkIntArray* edgeData, vtkPoints* outputPts,
     vtkPointData* outputPD) override;
+
+  ///@{
+  /**
+   * Compute the stencils of an even point and of an odd point from the cell
+   * links of polys, which are built if needed. GenerateSubdivisionPoints()
+   * no longer uses them.
+   */
+  VTK_DEPRECATED_IN_9_3_0("The stencils are computed in parallel by GenerateSubdivisionPoints()")
   int GenerateEvenStencil(vtkIdType p1, vtkPolyData* polys, vtkIdList* stencilIds, double* weights);
+  VTK_DEPRECATED_IN_9_3_0("The stencils are computed in parallel by GenerateSubdivisionPoints()")
   void GenerateOddStencil(
     vtkIdType p1, vtkIdType p2, vtkPolyData* polys, vtkIdList* stencilIds, double* weights);
+  ///@}
 
   int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
@@ -12,11 +12,17 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+// Hide VTK_DEPRECATED_IN_9_3_0() warnings for this class.
+#define VTK_DEPRECATION_LEVEL 0
+
 #include "vtkRibbonFilter.h"
 
+#include "vtkArrayListTemplate.h" // For processing attribute data
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -25,6 +31,13 @@
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLine.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkRibbonFilter);
 
@@ -56,6 +69,381 @@ vtkRibbonFilter::vtkRibbonFilter()
 
 vtkRibbonFilter::~vtkRibbonFilter() = default;
 
+namespace
+{
+
+// Reasons for which a polyline is not ribboned. They are reported once all the
+// polylines are processed.
+enum LineStatus : unsigned char
+{
+  LINE_RIBBONED = 0,
+  LINE_RIBBONED_WITH_ALTERNATE_BEVEL,
+  LINE_COINCIDENT_POINTS,
+  LINE_BAD_NORMAL
+};
+
+// Generate the ribbons along a range of polylines. The points, strip and
+// texture coordinates of each polyline are written at offsets computed
+// beforehand from the number of points of the polylines, so that the
+// polylines are ribboned concurrently, in the same order as one at a time.
+struct GenerateRibbons
+{
+  // Ribbon parameters
+  double Width;
+  bool VaryWidth;
+  double WidthFactor;
+  int GenerateTCoords;
+  double TextureLength;
+  double Theta;
+
+  // Input
+  vtkPoints* InPts;
+  vtkCellArray* InLines;
+  vtkDataArray* InNormals; // nullptr when normals are generated or the default one
+  bool GenerateNormals;
+  float DefaultNormal[3];
+  vtkDataArray* InScalars;
+  double Range[2];
+
+  // Layout of the output: whether each polyline is ribboned, and offsets of
+  // the points and strip of the ribbon of each polyline. The strip of a
+  // ribbon uses its points in order.
+  std::vector<unsigned char> Ribboned;
+  std::vector<vtkIdType> PointOffsets;
+  std::vector<vtkIdType> CellOffsets;
+  std::vector<unsigned char> Status;
+
+  // Output
+  vtkPoints* NewPts;
+  float* NewNormals;
+  float* NewTCoords;
+  ArrayList* PointArrays;
+  ArrayList* CellArrays;
+  vtkIdType* StripOffsets;
+  vtkIdType* StripConn;
+
+  struct LocalData
+  {
+    vtkSmartPointer<vtkCellArrayIterator> Iter;
+    // Sliding normals of the polyline: the polyline is copied with local
+    // ids, a point used several times sharing the same id.
+    std::vector<std::pair<vtkIdType, vtkIdType>> SortedIds;
+    std::vector<vtkIdType> LocalIds;
+    vtkSmartPointer<vtkPoints> LinePts;
+    vtkSmartPointer<vtkCellArray> Line;
+    vtkSmartPointer<vtkFloatArray> LineNormals;
+  };
+  vtkSMPThreadLocal<LocalData> Local;
+
+  void Initialize()
+  {
+    LocalData& local = this->Local.Local();
+    local.Iter.TakeReference(this->InLines->NewIterator());
+    if (this->GenerateNormals)
+    {
+      local.LinePts = vtkSmartPointer<vtkPoints>::New();
+      local.LinePts->SetDataTypeToDouble();
+      local.Line = vtkSmartPointer<vtkCellArray>::New();
+      local.LineNormals = vtkSmartPointer<vtkFloatArray>::New();
+      local.LineNormals->SetNumberOfComponents(3);
+    }
+  }
+
+  // Compute the sliding normals of a polyline independently of the other
+  // polylines.
+  void GenerateLineNormals(LocalData& local, vtkIdType npts, const vtkIdType* pts) const
+  {
+    local.SortedIds.resize(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      local.SortedIds[j] = std::make_pair(pts[j], j);
+    }
+    std::sort(local.SortedIds.begin(), local.SortedIds.end());
+    local.LocalIds.resize(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      local.LocalIds[local.SortedIds[j].second] =
+        (j > 0 && local.SortedIds[j].first == local.SortedIds[j - 1].first)
+        ? local.LocalIds[local.SortedIds[j - 1].second]
+        : local.SortedIds[j].second;
+    }
+
+    double x[3];
+    local.LinePts->SetNumberOfPoints(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      this->InPts->GetPoint(pts[j], x);
+      local.LinePts->SetPoint(j, x);
+    }
+    local.Line->Reset();
+    local.Line->InsertNextCell(npts, local.LocalIds.data());
+    local.LineNormals->Reset();
+    vtkPolyLine::GenerateSlidingNormals(local.LinePts, local.Line, local.LineNormals);
+  }
+
+  unsigned char GeneratePoints(
+    LocalData& local, vtkIdType offset, vtkIdType npts, const vtkIdType* pts) const
+  {
+    vtkIdType j;
+    int i;
+    double p[3];
+    double pNext[3];
+    double sNext[3] = { 0, 0, 0 };
+    double sPrev[3];
+    double n[3];
+    double s[3], sp[3], sm[3], v[3];
+    double w[3];
+    double nP[3];
+    double sFactor = 1.0;
+    vtkIdType ptId = offset;
+    unsigned char status = LINE_RIBBONED;
+
+    // Use "averaged" segment to create beveled effect.
+    // Watch out for first and last points.
+    //
+    for (j = 0; j < npts; j++)
+    {
+      if (j == 0) // first point
+      {
+        this->InPts->GetPoint(pts[0], p);
+        this->InPts->GetPoint(pts[1], pNext);
+        for (i = 0; i < 3; i++)
+        {
+          sNext[i] = pNext[i] - p[i];
+          sPrev[i] = sNext[i];
+        }
+      }
+      else if (j == (npts - 1)) // last point
+      {
+        for (i = 0; i < 3; i++)
+        {
+          sPrev[i] = sNext[i];
+          p[i] = pNext[i];
+        }
+      }
+      else
+      {
+        for (i = 0; i < 3; i++)
+        {
+          p[i] = pNext[i];
+        }
+        this->InPts->GetPoint(pts[j + 1], pNext);
+        for (i = 0; i < 3; i++)
+        {
+          sPrev[i] = sNext[i];
+          sNext[i] = pNext[i] - p[i];
+        }
+      }
+
+      if (this->GenerateNormals)
+      {
+        local.LineNormals->GetTuple(local.LocalIds[j], n);
+      }
+      else if (this->InNormals)
+      {
+        this->InNormals->GetTuple(pts[j], n);
+      }
+      else
+      {
+        for (i = 0; i < 3; i++)
+        {
+          n[i] = this->DefaultNormal[i];
+        }
+      }
+
+      if (vtkMath::Normalize(sNext) == 0.0)
+      {
+        return LINE_COINCIDENT_POINTS;
+      }
+
+      for (i = 0; i < 3; i++)
+      {
+        s[i] = (sPrev[i] + sNext[i]) / 2.0; // average vector
+      }
+      // if s is zero then just use sPrev cross n
+      if (vtkMath::Normalize(s) == 0.0)
+      {
+        status = LINE_RIBBONED_WITH_ALTERNATE_BEVEL;
+        vtkMath::Cross(sPrev, n, s);
+        vtkMath::Normalize(s);
+      }
+
+      vtkMath::Cross(s, n, w);
+      if (vtkMath::Normalize(w) == 0.0)
+      {
+        return LINE_BAD_NORMAL;
+      }
+
+      vtkMath::Cross(w, s, nP); // create orthogonal coordinate system
+      vtkMath::Normalize(nP);
+
+      // Compute a scale factor based on scalars or vectors
+      if (this->InScalars && this->VaryWidth) // varying by scalar values
+      {
+        sFactor = 1.0 +
+          ((this->WidthFactor - 1.0) * (this->InScalars->GetComponent(pts[j], 0) - this->Range[0]) /
+            (this->Range[1] - this->Range[0]));
+      }
+
+      for (i = 0; i < 3; i++)
+      {
+        v[i] = (w[i] * cos(this->Theta) + nP[i] * sin(this->Theta));
+        sp[i] = p[i] + this->Width * sFactor * v[i];
+        sm[i] = p[i] - this->Width * sFactor * v[i];
+      }
+      this->SetPoint(ptId++, sm, nP, pts[j]);
+      this->SetPoint(ptId++, sp, nP, pts[j]);
+    } // for all points in polyline
+
+    return status;
+  }
+
+  void SetPoint(vtkIdType ptId, const double x[3], const double normal[3], vtkIdType inPtId) const
+  {
+    this->NewPts->SetPoint(ptId, x);
+    for (int i = 0; i < 3; ++i)
+    {
+      this->NewNormals[3 * ptId + i] = static_cast<float>(normal[i]);
+    }
+    this->PointArrays->Copy(inPtId, ptId);
+  }
+
+  void GenerateStrip(vtkIdType offset, vtkIdType npts, vtkIdType cellId, vtkIdType inCellId) const
+  {
+    this->StripOffsets[cellId] = offset;
+    this->CellArrays->Copy(inCellId, cellId);
+    for (vtkIdType i = 0; i < 2 * npts; i++)
+    {
+      this->StripConn[offset + i] = offset + i;
+    }
+  }
+
+  void SetTCoords(vtkIdType ptId, double tc) const
+  {
+    for (int k = 0; k < 2; k++)
+    {
+      this->NewTCoords[2 * (ptId + k)] = static_cast<float>(tc);
+      this->NewTCoords[2 * (ptId + k) + 1] = 0.0f;
+    }
+  }
+
+  void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts) const
+  {
+    vtkIdType i;
+    double tc;
+
+    double s0, s;
+    // The first texture coordinate is always 0.
+    this->SetTCoords(offset, 0.0);
+    if (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS)
+    {
+      s0 = this->InScalars->GetTuple1(pts[0]);
+      for (i = 1; i < npts; i++)
+      {
+        s = this->InScalars->GetTuple1(pts[i]);
+        tc = (s - s0) / this->TextureLength;
+        this->SetTCoords(offset + i * 2, tc);
+      }
+    }
+    else if (this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH)
+    {
+      double xPrev[3], x[3], len = 0.0;
+      this->InPts->GetPoint(pts[0], xPrev);
+      for (i = 1; i < npts; i++)
+      {
+        this->InPts->GetPoint(pts[i], x);
+        len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
+        tc = len / this->TextureLength;
+        this->SetTCoords(offset + i * 2, tc);
+        xPrev[0] = x[0];
+        xPrev[1] = x[1];
+        xPrev[2] = x[2];
+      }
+    }
+    else if (this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
+    {
+      double xPrev[3], x[3], length = 0.0, len = 0.0;
+      this->InPts->GetPoint(pts[0], xPrev);
+      for (i = 1; i < npts; i++)
+      {
+        this->InPts->GetPoint(pts[i], x);
+        length += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
+        xPrev[0] = x[0];
+        xPrev[1] = x[1];
+        xPrev[2] = x[2];
+      }
+
+      this->InPts->GetPoint(pts[0], xPrev);
+      for (i = 1; i < npts; i++)
+      {
+        this->InPts->GetPoint(pts[i], x);
+        len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
+        tc = len / length;
+        this->SetTCoords(offset + i * 2, tc);
+        xPrev[0] = x[0];
+        xPrev[1] = x[1];
+        xPrev[2] = x[2];
+      }
+    }
+  }
+
+  void operator()(vtkIdType lineId, vtkIdType endLineId)
+  {
+    LocalData& local = this->Local.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (; lineId < endLineId; ++lineId)
+    {
+      if (!this->Ribboned[lineId])
+      {
+        continue; // skip ribboning this polyline
+      }
+      local.Iter->GetCellAtId(lineId, npts, pts);
+
+      // If necessary calculate normals, each polyline calculates its
+      // normals independently, avoiding conflicts at shared vertices.
+      if (this->GenerateNormals)
+      {
+        this->GenerateLineNormals(local, npts, pts);
+      }
+
+      // Generate the points around the polyline. The strip is not created
+      // if the polyline is bad.
+      const vtkIdType offset = this->PointOffsets[lineId];
+      this->Status[lineId] = this->GeneratePoints(local, offset, npts, pts);
+      if (this->Status[lineId] != LINE_RIBBONED &&
+        this->Status[lineId] != LINE_RIBBONED_WITH_ALTERNATE_BEVEL)
+      {
+        continue; // skip ribboning this polyline
+      }
+
+      // Generate the strip for this polyline
+      this->GenerateStrip(offset, npts, this->CellOffsets[lineId], lineId);
+
+      // Generate the texture coordinates for this polyline
+      if (this->NewTCoords)
+      {
+        this->GenerateTextureCoords(offset, npts, pts);
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+// Set the ribbon parameters from the filter.
+void SetRibbonParameters(GenerateRibbons& ribbons, vtkRibbonFilter* self)
+{
+  ribbons.Width = self->GetWidth();
+  ribbons.VaryWidth = self->GetVaryWidth() != 0;
+  ribbons.WidthFactor = self->GetWidthFactor();
+  ribbons.GenerateTCoords = self->GetGenerateTCoords();
+  ribbons.TextureLength = self->GetTextureLength();
+  ribbons.Theta = vtkMath::RadiansFromDegrees(self->GetAngle());
+}
+
+}
+
 int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkInformationVector** inputVector, vtkInformationVector* outputVector)
 {
@@ -72,25 +460,15 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkCellData* cd = input->GetCellData();
   vtkCellData* outCD = output->GetCellData();
   vtkCellArray* inLines;
-  vtkDataArray* inNormals;
   vtkDataArray* inScalars = this->GetInputArrayToProcess(0, inputVector);
 
   vtkPoints* inPts;
   vtkIdType numPts;
   vtkIdType numLines;
-  vtkIdType numNewPts, numNewCells;
   vtkPoints* newPts;
-  int deleteNormals = 0;
   vtkFloatArray* newNormals;
-  vtkIdType i;
-  double range[2];
-  vtkCellArray* newStrips;
-  vtkIdType npts = 0;
-  const vtkIdType* pts = nullptr;
-  vtkIdType offset = 0;
+  double range[2] = { 0.0, 1.0 };
   vtkFloatArray* newTCoords = nullptr;
-  int abort = 0;
-  vtkIdType inCellId;
 
   // Check input and initialize
   //
@@ -103,15 +481,9 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
   }
 
   // Create the geometry and topology
-  numNewPts = 2 * numPts;
   newPts = vtkPoints::New();
-  newPts->Allocate(numNewPts);
   newNormals = vtkFloatArray::New();
   newNormals->SetNumberOfComponents(3);
-  newNormals->Allocate(3 * numNewPts);
-  newStrips = vtkCellArray::New();
-  newStrips->AllocateEstimate(1, numNewPts);
-  vtkCellArray* singlePolyline = vtkCellArray::New();
 
   // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
   outPD->CopyNormalsOff();
@@ -121,33 +493,28 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
   {
     newTCoords = vtkFloatArray::New();
     newTCoords->SetNumberOfComponents(2);
-    newTCoords->Allocate(numNewPts);
     outPD->CopyTCoordsOff();
   }
-  outPD->CopyAllocate(pd, numNewPts);
 
-  int generateNormals = 0;
-  inNormals = this->GetInputArrayToProcess(1, inputVector);
-  if (!inNormals || this->UseDefaultNormal)
+  GenerateRibbons ribbons;
+  ribbons.InNormals = this->GetInputArrayToProcess(1, inputVector);
+  ribbons.GenerateNormals = false;
+  if (!ribbons.InNormals || this->UseDefaultNormal)
   {
-    deleteNormals = 1;
-    inNormals = vtkFloatArray::New();
-    inNormals->SetNumberOfComponents(3);
-    inNormals->SetNumberOfTuples(numPts);
-
+    ribbons.InNormals = nullptr;
     if (this->UseDefaultNormal)
     {
-      for (i = 0; i < numPts; i++)
+      for (int i = 0; i < 3; i++)
       {
-        inNormals->SetTuple(i, this->DefaultNormal);
+        ribbons.DefaultNormal[i] = static_cast<float>(this->DefaultNormal[i]);
       }
     }
     else
     {
-      // Normal generation has been moved to lower in the function.
-      // This allows each different polylines to share vertices, but have
-      // their normals (and hence their ribbons) calculated independently
-      generateNormals = 1;
+      // Normal generation is done per polyline. This allows each different
+      // polylines to share vertices, but have their normals (and hence their
+      // ribbons) calculated independently
+      ribbons.GenerateNormals = true;
     }
   }
 
@@ -163,77 +530,138 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
-  // Copy selected parts of cell data; certainly don't want normals
-  //
-  numNewCells = inLines->GetNumberOfCells();
-  outCD->CopyNormalsOff();
-  outCD->CopyAllocate(cd, numNewCells);
-
-  //  Create points along each polyline that are connected into NumberOfSides
-  //  triangle strips. Texture coordinates are optionally generated.
+  //  Create points along each polyline that are connected into a triangle
+  //  strip. Texture coordinates are optionally generated.
   //
   this->Theta = vtkMath::RadiansFromDegrees(this->Angle);
-  vtkPolyLine* lineNormalGenerator = vtkPolyLine::New();
-  for (inCellId = 0, inLines->InitTraversal(); inLines->GetNextCell(npts, pts) && !abort;
-       inCellId++)
+  SetRibbonParameters(ribbons, this);
+  ribbons.InPts = inPts;
+  ribbons.InLines = inLines;
+  ribbons.InScalars = inScalars;
+  ribbons.Range[0] = range[0];
+  ribbons.Range[1] = range[1];
+
+  ribbons.Ribboned.resize(numLines);
+  ribbons.Status.assign(numLines, LINE_RIBBONED);
+  for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
   {
-    this->UpdateProgress((double)inCellId / numLines);
-    abort = this->GetAbortExecute();
-
-    if (npts < 2)
+    ribbons.Ribboned[lineId] = inLines->GetCellSize(lineId) >= 2;
+    if (!ribbons.Ribboned[lineId])
     {
       vtkWarningMacro(<< "Less than two points in line!");
-      continue; // skip tubing this polyline
     }
+  }
 
-    // If necessary calculate normals, each polyline calculates its
-    // normals independently, avoiding conflicts at shared vertices.
-    if (generateNormals)
+  // The output is first allocated assuming that all the polylines can be
+  // ribboned. The polylines that cannot be ribboned are discarded, and the
+  // ribbons generated again where they belong.
+  ArrayList pointArrays;
+  ArrayList cellArrays;
+  vtkNew<vtkIdTypeArray> stripOffsets;
+  vtkNew<vtkIdTypeArray> stripConn;
+  ribbons.PointOffsets.resize(numLines + 1);
+  ribbons.CellOffsets.resize(numLines + 1);
+  for (bool allocated = false;; allocated = true)
+  {
+    ribbons.PointOffsets[0] = ribbons.CellOffsets[0] = 0;
+    for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
     {
-      singlePolyline->Reset(); // avoid instantiation
-      singlePolyline->InsertNextCell(npts, pts);
-      if (!vtkPolyLine::GenerateSlidingNormals(inPts, singlePolyline, inNormals))
+      const bool ribboned = ribbons.Ribboned[lineId] != 0;
+      ribbons.PointOffsets[lineId + 1] =
+        ribbons.PointOffsets[lineId] + (ribboned ? 2 * inLines->GetCellSize(lineId) : 0);
+      ribbons.CellOffsets[lineId + 1] = ribbons.CellOffsets[lineId] + (ribboned ? 1 : 0);
+    }
+    const vtkIdType numNewPts = ribbons.PointOffsets[numLines];
+    const vtkIdType numNewCells = ribbons.CellOffsets[numLines];
+
+    if (!allocated)
+    {
+      newPts->SetNumberOfPoints(numNewPts);
+      newNormals->SetNumberOfTuples(numNewPts);
+      outPD->CopyAllocate(pd, numNewPts);
+      pointArrays.AddArrays(numNewPts, pd, outPD, 0.0, false);
+      if (newTCoords)
       {
-        vtkWarningMacro(<< "No normals for line!");
-        continue; // skip tubing this polyline
+        newTCoords->SetNumberOfTuples(numNewPts);
       }
-    }
 
-    // Generate the points around the polyline. The strip is not created
-    // if the polyline is bad.
-    //
-    if (!this->GeneratePoints(
-          offset, npts, pts, inPts, newPts, pd, outPD, newNormals, inScalars, range, inNormals))
+      // Copy selected parts of cell data; certainly don't want normals
+      //
+      outCD->CopyNormalsOff();
+      outCD->CopyAllocate(cd, numNewCells);
+      cellArrays.AddArrays(numNewCells, cd, outCD, 0.0, false);
+      stripOffsets->SetNumberOfTuples(numNewCells + 1);
+      stripConn->SetNumberOfTuples(numNewPts);
+
+      ribbons.NewPts = newPts;
+      ribbons.NewNormals = newNormals->GetPointer(0);
+      ribbons.NewTCoords = newTCoords ? newTCoords->GetPointer(0) : nullptr;
+      ribbons.PointArrays = &pointArrays;
+      ribbons.CellArrays = &cellArrays;
+      ribbons.StripOffsets = stripOffsets->GetPointer(0);
+      ribbons.StripConn = stripConn->GetPointer(0);
+    }
+    else
     {
-      vtkWarningMacro(<< "Could not generate points!");
-      continue; // skip ribboning this polyline
+      // Only shrink the output, which keeps the pointers to its arrays valid
+      // until the ribbons are generated again.
+      newPts->SetNumberOfPoints(numNewPts);
+      newNormals->SetNumberOfTuples(numNewPts);
+      for (int i = 0; i < outPD->GetNumberOfArrays(); ++i)
+      {
+        outPD->GetAbstractArray(i)->SetNumberOfTuples(numNewPts);
+      }
+      if (newTCoords)
+      {
+        newTCoords->SetNumberOfTuples(numNewPts);
+      }
+      for (int i = 0; i < outCD->GetNumberOfArrays(); ++i)
+      {
+        outCD->GetAbstractArray(i)->SetNumberOfTuples(numNewCells);
+      }
+      stripOffsets->SetNumberOfTuples(numNewCells + 1);
+      stripConn->SetNumberOfTuples(numNewPts);
     }
+    stripOffsets->SetValue(numNewCells, numNewPts);
 
-    // Generate the strip for this polyline
-    //
-    this->GenerateStrip(offset, npts, pts, inCellId, cd, outCD, newStrips);
+    vtkSMPTools::For(0, numLines, ribbons);
+    this->UpdateProgress(0.9);
 
-    // Generate the texture coordinates for this polyline
-    //
-    if (newTCoords)
+    bool failed = false;
+    for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
+    {
+      switch (ribbons.Status[lineId])
+      {
+        case LINE_RIBBONED:
+        case LINE_RIBBONED_WITH_ALTERNATE_BEVEL:
+          continue;
+        case LINE_COINCIDENT_POINTS:
+          vtkWarningMacro(<< "Coincident points!");
+          break;
+        case LINE_BAD_NORMAL:
+          vtkWarningMacro(<< "Bad normal in line " << lineId);
+          break;
+      }
+      vtkWarningMacro(<< "Could not generate points!");
+      ribbons.Ribboned[lineId] = 0;
+      ribbons.Status[lineId] = LINE_RIBBONED;
+      failed = true;
+    }
+    if (!failed)
     {
-      this->GenerateTextureCoords(offset, npts, pts, inPts, inScalars, newTCoords);
+      break;
     }
-
-    // Compute the new offset for the next polyline
-    offset = this->ComputeOffset(offset, npts);
-
-  } // for all polylines
-
-  singlePolyline->Delete();
-
-  // Update ourselves
-  //
-  if (deleteNormals)
+  }
+  for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
   {
-    inNormals->Delete();
+    if (ribbons.Status[lineId] == LINE_RIBBONED_WITH_ALTERNATE_BEVEL)
+    {
+      vtkWarningMacro(<< "Using alternate bevel vector");
+    }
   }
 
+  // Update ourselves
+  //
   if (newTCoords)
   {
     outPD->SetTCoords(newTCoords);
@@ -243,245 +671,124 @@ int vtkRibbonFilter::RequestData(vtkInformation* vtkNotUsed(request),
   output->SetPoints(newPts);
   newPts->Delete();
 
+  vtkNew<vtkCellArray> newStrips;
+  newStrips->SetData(stripOffsets, stripConn);
   output->SetStrips(newStrips);
-  newStrips->Delete();
 
   outPD->SetNormals(newNormals);
   newNormals->Delete();
-  lineNormalGenerator->Delete();
 
   output->Squeeze();
 
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// The deprecated helper methods generate the ribbon of a single polyline with
+// the same code as RequestData(), then insert it in the given arrays.
 int vtkRibbonFilter::GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
   vtkPoints* inPts, vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD,
   vtkFloatArray* newNormals, vtkDataArray* inScalars, double range[2], vtkDataArray* inNormals)
 {
-  vtkIdType j;
-  int i;
-  double p[3];
-  double pNext[3];
-  double sNext[3] = { 0, 0, 0 };
-  double sPrev[3];
-  double n[3];
-  double s[3], sp[3], sm[3], v[3];
-  // double bevelAngle;
-  double w[3];
-  double nP[3];
-  double sFactor = 1.0;
-  vtkIdType ptId = offset;
-
-  // Use "averaged" segment to create beveled effect.
-  // Watch out for first and last points.
-  //
-  for (j = 0; j < npts; j++)
+  GenerateRibbons ribbons;
+  SetRibbonParameters(ribbons, this);
+  ribbons.InPts = inPts;
+  ribbons.InNormals = inNormals;
+  ribbons.GenerateNormals = false;
+  for (int i = 0; i < 3; i++)
   {
-    if (j == 0) // first point
-    {
-      inPts->GetPoint(pts[0], p);
-      inPts->GetPoint(pts[1], pNext);
-      for (i = 0; i < 3; i++)
-      {
-        sNext[i] = pNext[i] - p[i];
-        sPrev[i] = sNext[i];
-      }
-    }
-    else if (j == (npts - 1)) // last point
-    {
-      for (i = 0; i < 3; i++)
-      {
-        sPrev[i] = sNext[i];
-        p[i] = pNext[i];
-      }
-    }
-    else
-    {
-      for (i = 0; i < 3; i++)
-      {
-        p[i] = pNext[i];
-      }
-      inPts->GetPoint(pts[j + 1], pNext);
-      for (i = 0; i < 3; i++)
-      {
-        sPrev[i] = sNext[i];
-        sNext[i] = pNext[i] - p[i];
-      }
-    }
-
-    inNormals->GetTuple(pts[j], n);
-
-    if (vtkMath::Normalize(sNext) == 0.0)
-    {
+    ribbons.DefaultNormal[i] = static_cast<float>(this->DefaultNormal[i]);
+  }
+  ribbons.InScalars = inScalars;
+  ribbons.Range[0] = range[0];
+  ribbons.Range[1] = range[1];
+
+  const vtkIdType numRibbonPts = 2 * npts;
+  vtkNew<vtkPoints> ribbonPts;
+  ribbonPts->SetDataTypeToDouble();
+  ribbonPts->SetNumberOfPoints(numRibbonPts);
+  std::vector<float> ribbonNormals(3 * numRibbonPts);
+  ArrayList noArrays;
+  ribbons.NewPts = ribbonPts;
+  ribbons.NewNormals = ribbonNormals.data();
+  ribbons.PointArrays = &noArrays;
+
+  GenerateRibbons::LocalData local;
+  switch (ribbons.GeneratePoints(local, 0, npts, pts))
+  {
+    case LINE_RIBBONED:
+      break;
+    case LINE_RIBBONED_WITH_ALTERNATE_BEVEL:
+      vtkWarningMacro(<< "Using alternate bevel vector");
+      break;
+    case LINE_COINCIDENT_POINTS:
       vtkWarningMacro(<< "Coincident points!");
       return 0;
-    }
-
-    for (i = 0; i < 3; i++)
-    {
-      s[i] = (sPrev[i] + sNext[i]) / 2.0; // average vector
-    }
-    // if s is zero then just use sPrev cross n
-    if (vtkMath::Normalize(s) == 0.0)
-    {
-      vtkWarningMacro(<< "Using alternate bevel vector");
-      vtkMath::Cross(sPrev, n, s);
-      if (vtkMath::Normalize(s) == 0.0)
-      {
-        vtkWarningMacro(<< "Using alternate bevel vector");
-      }
-    }
-    /*
-        if ( (bevelAngle = vtkMath::Dot(sNext,sPrev)) > 1.0 )
-          {
-          bevelAngle = 1.0;
-          }
-        if ( bevelAngle < -1.0 )
-          {
-          bevelAngle = -1.0;
-          }
-        bevelAngle = acos((double)bevelAngle) / 2.0; //(0->90 degrees)
-        if ( (bevelAngle = cos(bevelAngle)) == 0.0 )
-          {
-          bevelAngle = 1.0;
-          }
-
-        bevelAngle = this->Width / bevelAngle; //keep ribbon constant width
-    */
-    vtkMath::Cross(s, n, w);
-    if (vtkMath::Normalize(w) == 0.0)
-    {
-      vtkWarningMacro(<< "Bad normal s = " << s[0] << " " << s[1] << " " << s[2] << " n = " << n[0]
-                      << " " << n[1] << " " << n[2]);
+    default:
+      vtkWarningMacro(<< "Bad normal!");
       return 0;
-    }
-
-    vtkMath::Cross(w, s, nP); // create orthogonal coordinate system
-    vtkMath::Normalize(nP);
-
-    // Compute a scale factor based on scalars or vectors
-    if (inScalars && this->VaryWidth) // varying by scalar values
-    {
-      sFactor = 1.0 +
-        ((this->WidthFactor - 1.0) * (inScalars->GetComponent(pts[j], 0) - range[0]) /
-          (range[1] - range[0]));
-    }
-
-    for (i = 0; i < 3; i++)
-    {
-      v[i] = (w[i] * cos(this->Theta) + nP[i] * sin(this->Theta));
-      sp[i] = p[i] + this->Width * sFactor * v[i];
-      sm[i] = p[i] - this->Width * sFactor * v[i];
-    }
-    newPts->InsertPoint(ptId, sm);
-    newNormals->InsertTuple(ptId, nP);
-    outPD->CopyData(pd, pts[j], ptId);
-    ptId++;
-    newPts->InsertPoint(ptId, sp);
-    newNormals->InsertTuple(ptId, nP);
-    outPD->CopyData(pd, pts[j], ptId);
-    ptId++;
-  } // for all points in polyline
+  }
 
+  // Two points are generated for each polyline point.
+  for (vtkIdType ptId = 0; ptId < numRibbonPts; ++ptId)
+  {
+    newPts->InsertPoint(offset + ptId, ribbonPts->GetPoint(ptId));
+    newNormals->InsertTuple3(offset + ptId, ribbonNormals[3 * ptId], ribbonNormals[3 * ptId + 1],
+      ribbonNormals[3 * ptId + 2]);
+    outPD->CopyData(pd, pts[ptId / 2], offset + ptId);
+  }
   return 1;
 }
 
+//------------------------------------------------------------------------------
 void vtkRibbonFilter::GenerateStrip(vtkIdType offset, vtkIdType npts,
   const vtkIdType* vtkNotUsed(pts), vtkIdType inCellId, vtkCellData* cd, vtkCellData* outCD,
   vtkCellArray* newStrips)
 {
-  vtkIdType i, idx, outCellId;
-
-  outCellId = newStrips->InsertNextCell(npts * 2);
+  GenerateRibbons ribbons;
+  SetRibbonParameters(ribbons, this);
+
+  vtkIdType stripOffset;
+  std::vector<vtkIdType> stripConn(2 * npts);
+  ArrayList noArrays;
+  ribbons.CellArrays = &noArrays;
+  ribbons.StripOffsets = &stripOffset;
+  ribbons.StripConn = stripConn.data();
+  ribbons.GenerateStrip(0, npts, 0, inCellId);
+
+  const vtkIdType outCellId = newStrips->InsertNextCell(2 * npts);
   outCD->CopyData(cd, inCellId, outCellId);
-  for (i = 0; i < npts; i++)
+  for (vtkIdType i = 0; i < 2 * npts; i++)
   {
-    idx = 2 * i;
-    newStrips->InsertCellPoint(offset + idx);
-    newStrips->InsertCellPoint(offset + idx + 1);
+    newStrips->InsertCellPoint(offset + stripConn[i]);
   }
 }
 
+//------------------------------------------------------------------------------
 void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
   vtkPoints* inPts, vtkDataArray* inScalars, vtkFloatArray* newTCoords)
 {
-  vtkIdType i;
-  int k;
-  double tc;
+  GenerateRibbons ribbons;
+  SetRibbonParameters(ribbons, this);
+  ribbons.InPts = inPts;
+  ribbons.InScalars = inScalars;
 
-  double s0, s;
-  // The first texture coordinate is always 0.
-  for (k = 0; k < 2; k++)
-  {
-    newTCoords->InsertTuple2(offset + k, 0.0, 0.0);
-  }
-  if (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars)
-  {
-    s0 = inScalars->GetTuple1(pts[0]);
-    for (i = 1; i < npts; i++)
-    {
-      s = inScalars->GetTuple1(pts[i]);
-      tc = (s - s0) / this->TextureLength;
-      for (k = 0; k < 2; k++)
-      {
-        newTCoords->InsertTuple2(offset + i * 2 + k, tc, 0.0);
-      }
-    }
-  }
-  else if (this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH)
-  {
-    double xPrev[3], x[3], len = 0.0;
-    inPts->GetPoint(pts[0], xPrev);
-    for (i = 1; i < npts; i++)
-    {
-      inPts->GetPoint(pts[i], x);
-      len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
-      tc = len / this->TextureLength;
-      for (k = 0; k < 2; k++)
-      {
-        newTCoords->InsertTuple2(offset + i * 2 + k, tc, 0.0);
-      }
-      xPrev[0] = x[0];
-      xPrev[1] = x[1];
-      xPrev[2] = x[2];
-    }
-  }
-  else if (this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH)
-  {
-    double xPrev[3], x[3], length = 0.0, len = 0.0;
-    inPts->GetPoint(pts[0], xPrev);
-    for (i = 1; i < npts; i++)
-    {
-      inPts->GetPoint(pts[i], x);
-      length += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
-      xPrev[0] = x[0];
-      xPrev[1] = x[1];
-      xPrev[2] = x[2];
-    }
+  const vtkIdType numRibbonPts = 2 * npts;
+  std::vector<float> ribbonTCoords(2 * numRibbonPts);
+  ribbons.NewTCoords = ribbonTCoords.data();
+  ribbons.GenerateTextureCoords(0, npts, pts);
 
-    inPts->GetPoint(pts[0], xPrev);
-    for (i = 1; i < npts; i++)
-    {
-      inPts->GetPoint(pts[i], x);
-      len += sqrt(vtkMath::Distance2BetweenPoints(x, xPrev));
-      tc = len / length;
-      for (k = 0; k < 2; k++)
-      {
-        newTCoords->InsertTuple2(offset + i * 2 + k, tc, 0.0);
-      }
-      xPrev[0] = x[0];
-      xPrev[1] = x[1];
-      xPrev[2] = x[2];
-    }
+  for (vtkIdType ptId = 0; ptId < numRibbonPts; ++ptId)
+  {
+    newTCoords->InsertTuple2(offset + ptId, ribbonTCoords[2 * ptId], ribbonTCoords[2 * ptId + 1]);
   }
 }
 
+//------------------------------------------------------------------------------
 // Compute the number of points in this ribbon
 vtkIdType vtkRibbonFilter::ComputeOffset(vtkIdType offset, vtkIdType npts)
 {
-  offset += 2 * npts;
-  return offset;
+  return offset + 2 * npts;
 }
 
 // Description:
@@ -36,6 +36,7 @@
 #ifndef vtkRibbonFilter_h
 #define vtkRibbonFilter_h
 
+#include "vtkDeprecation.h"           // For VTK_DEPRECATED_IN_9_3_0
 #include "vtkFiltersModelingModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
@@ -162,13 +163,17 @@ protected:
   double TextureLength; // this length is mapped to [0,1) texture space
 
   // Helper methods
+  VTK_DEPRECATED_IN_9_3_0("The ribbons are generated in parallel by RequestData()")
   int GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkPoints* inPts,
     vtkPoints* newPts, vtkPointData* pd, vtkPointData* outPD, vtkFloatArray* newNormals,
     vtkDataArray* inScalars, double range[2], vtkDataArray* inNormals);
+  VTK_DEPRECATED_IN_9_3_0("The ribbons are generated in parallel by RequestData()")
   void GenerateStrip(vtkIdType offset, vtkIdType npts, const vtkIdType* pts, vtkIdType inCellId,
     vtkCellData* cd, vtkCellData* outCD, vtkCellArray* newStrips);
+  VTK_DEPRECATED_IN_9_3_0("The ribbons are generated in parallel by RequestData()")
   void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, const vtkIdType* pts,
     vtkPoints* inPts, vtkDataArray* inScalars, vtkFloatArray* newTCoords);
+  VTK_DEPRECATED_IN_9_3_0("The ribbons are generated in parallel by RequestData()")
   vtkIdType ComputeOffset(vtkIdType offset, vtkIdType npts);
 
   // Helper data members
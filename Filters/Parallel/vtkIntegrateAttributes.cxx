@@ -453,15 +453,7 @@ int vtkIntegrateAttributes::RequestData(
   int globalMin = this->PieceNodeMinToNode0(output);
   int processId = this->Controller ? this->Controller->GetLocalProcessId() : 0;
   int numProcs = this->Controller ? this->Controller->GetNumberOfProcesses() : 1;
-  if (globalMin == numProcs)
-  {
-    // there is no data in any of the processors
-    if (this->Sum != 0.0 && this->DivideAllCellDataByVolume)
-    {
-      DivideDataArraysByConstant(output->GetCellData(), true, this->Sum);
-    }
-    return 1;
-  }
+  // Every process has the vertex cell above, so globalMin is never numProcs.
   if (processId > 0)
   {
     if (processId != globalMin)
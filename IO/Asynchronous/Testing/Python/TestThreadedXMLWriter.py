@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+import sys
+
+import vtk
+from vtk.util.misc import vtkGetTempDir
+
+VTK_TEMP_DIR = vtkGetTempDir()
+
+# Generate Data
+sphere = vtk.vtkSphereSource()
+sphere.SetThetaResolution(64)
+sphere.SetPhiResolution(64)
+sphere.Update()
+polyData = sphere.GetOutput()
+normals = polyData.GetPointData().GetNormals()
+
+wavelet = vtk.vtkRTAnalyticSource()
+wavelet.Update()
+image = wavelet.GetOutput()
+
+# Initialize writer
+writer = vtk.vtkThreadedXMLWriter()
+writer.SetMaxThreads(2)
+writer.GetWriter().SetDataModeToAppended()
+writer.GetWriter().SetCompressorTypeToLZ4()
+# Keep at most one snapshot in flight
+writer.SetMaximumQueuedMemory(1)
+writer.Initialize()
+
+# Write all files, modifying the input structure right after each write
+fileNames = []
+for i in range(5):
+    fileNames.append('%s/threaded-xml-writer-%d.vtp' % (VTK_TEMP_DIR, i))
+    writer.EncodeAndWrite(polyData, fileNames[-1])
+    polyData.GetPointData().RemoveArray('Normals')
+    polyData.GetPointData().SetNormals(normals)
+
+    fileNames.append('%s/threaded-xml-writer-%d.vti' % (VTK_TEMP_DIR, i))
+    writer.EncodeAndWrite(image, fileNames[-1])
+
+# Wait for the work to be done
+writer.Finalize()
+if writer.GetQueuedMemory() != 0:
+    print('ERROR: queued memory not released')
+    sys.exit(1)
+
+# Validate the files
+for fileName in fileNames:
+    reader = vtk.vtkXMLGenericDataObjectReader()
+    reader.SetFileName(fileName)
+    reader.Update()
+    output = reader.GetOutput()
+    expected = polyData if fileName.endswith('.vtp') else image
+    if output.GetNumberOfPoints() != expected.GetNumberOfPoints() or \
+       output.GetNumberOfCells() != expected.GetNumberOfCells() or \
+       output.GetPointData().GetNumberOfArrays() != expected.GetPointData().GetNumberOfArrays():
+        print('ERROR: wrong content in %s' % fileName)
+        sys.exit(1)
+
+print("All good...")
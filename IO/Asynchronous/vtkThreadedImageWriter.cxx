@@ -26,6 +26,7 @@
 #include "vtkPNMWriter.h"
 #include "vtkPointData.h"
 #include "vtkTIFFWriter.h"
+#include "vtkThreadedTaskPool.h"
 #include "vtkThreadedTaskQueue.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkXMLImageDataWriter.h"
@@ -154,6 +155,13 @@ public:
       /*max_concurrent_tasks=*/static_cast<int>(numberOfThreads)));
   }
 
+  void UseGlobalPool()
+  {
+    this->Queue.reset(new TaskQueueType(::EncodeAndWrite, vtkThreadedTaskPool::GetGlobalPool(),
+      /*strict_ordering=*/true,
+      /*buffer_size=*/-1));
+  }
+
   void PushImageToQueue(vtkSmartPointer<vtkImageData>&& data, std::string&& filename)
   {
     this->Queue->Push(std::move(data), std::move(filename));
@@ -166,6 +174,7 @@ vtkThreadedImageWriter::vtkThreadedImageWriter()
   : Internals(new vtkInternals())
 {
   this->MaxThreads = MAX_NUMBER_OF_THREADS_IN_POOL;
+  this->UseGlobalTaskPool = false;
 }
 
 //------------------------------------------------------------------------------
@@ -193,7 +202,14 @@ void vtkThreadedImageWriter::Initialize()
   // Make sure we don't keep adding new threads
   // this->Internals->TerminateAllWorkers();
   // Register new worker threads
-  this->Internals->SpawnWorkers(this->MaxThreads);
+  if (this->UseGlobalTaskPool)
+  {
+    this->Internals->UseGlobalPool();
+  }
+  else
+  {
+    this->Internals->SpawnWorkers(this->MaxThreads);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -219,6 +235,8 @@ void vtkThreadedImageWriter::EncodeAndWrite(vtkImageData* image, const char* fil
 void vtkThreadedImageWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaxThreads: " << this->MaxThreads << endl;
+  os << indent << "UseGlobalTaskPool: " << this->UseGlobalTaskPool << endl;
 }
 
 //------------------------------------------------------------------------------
@@ -63,6 +63,18 @@ public:
   void SetMaxThreads(vtkTypeUInt32);
   vtkGetMacro(MaxThreads, vtkTypeUInt32);
 
+  ///@{
+  /**
+   * When on, the images are encoded by the threads of the process-wide
+   * vtkThreadedTaskPool, shared with other asynchronous readers and writers,
+   * instead of MaxThreads threads owned by this writer. Default is off.
+   * Initialize() need to be called after any change.
+   */
+  vtkSetMacro(UseGlobalTaskPool, bool);
+  vtkGetMacro(UseGlobalTaskPool, bool);
+  vtkBooleanMacro(UseGlobalTaskPool, bool);
+  ///@}
+
   /**
    * This method will wait for any running thread to terminate.
    */
@@ -79,6 +91,7 @@ private:
   class vtkInternals;
   vtkInternals* Internals;
   vtkTypeUInt32 MaxThreads;
+  bool UseGlobalTaskPool;
 };
 
 #endif
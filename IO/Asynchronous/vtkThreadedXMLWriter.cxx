@@ -0,0 +1,397 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedXMLWriter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadedXMLWriter.h"
+
+#include "vtkCellArray.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
+#include "vtkDataCompressor.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkIdTypeArray.h"
+#include "vtkLogger.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadedTaskPool.h"
+#include "vtkThreadedTaskQueue.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLDataObjectWriter.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#define MAX_NUMBER_OF_THREADS_IN_POOL 32
+//****************************************************************************
+namespace
+{
+// Returns a new array object sharing the values of `array`. Data arrays keep
+// their own range cache and information, which the XML writers update.
+// Other arrays are small and have no shallow copy, they are deep copied.
+template <typename ArrayT>
+vtkSmartPointer<ArrayT> SnapshotArray(ArrayT* array)
+{
+  if (!array)
+  {
+    return nullptr;
+  }
+  auto copy = vtk::TakeSmartPointer(array->NewInstance());
+  if (auto dataArray = vtkDataArray::SafeDownCast(array))
+  {
+    vtkDataArray::SafeDownCast(copy)->ShallowCopy(dataArray);
+  }
+  else
+  {
+    copy->DeepCopy(array);
+  }
+  return copy;
+}
+
+void SnapshotFieldData(vtkFieldData* fd)
+{
+  vtkSmartPointer<vtkFieldData> copy = vtk::TakeSmartPointer(fd->NewInstance());
+  for (int cc = 0; cc < fd->GetNumberOfArrays(); ++cc)
+  {
+    copy->AddArray(SnapshotArray(fd->GetAbstractArray(cc)));
+  }
+  if (auto dsa = vtkDataSetAttributes::SafeDownCast(fd))
+  {
+    int indices[vtkDataSetAttributes::NUM_ATTRIBUTES];
+    dsa->GetAttributeIndices(indices);
+    for (int attributeType = 0; attributeType < vtkDataSetAttributes::NUM_ATTRIBUTES;
+         ++attributeType)
+    {
+      if (indices[attributeType] >= 0)
+      {
+        static_cast<vtkDataSetAttributes*>(copy.Get())
+          ->SetActiveAttribute(indices[attributeType], attributeType);
+      }
+    }
+  }
+  fd->ShallowCopy(copy);
+}
+
+vtkSmartPointer<vtkCellArray> SnapshotCellArray(vtkCellArray* cells)
+{
+  if (!cells)
+  {
+    return nullptr;
+  }
+  vtkNew<vtkCellArray> copy;
+  copy->SetData(
+    SnapshotArray(cells->GetOffsetsArray()), SnapshotArray(cells->GetConnectivityArray()));
+  return copy;
+}
+
+// Shallow copy of `data` where every array is a distinct object.
+vtkSmartPointer<vtkDataObject> ShallowSnapshot(vtkDataObject* data)
+{
+  auto snapshot = vtk::TakeSmartPointer(data->NewInstance());
+  snapshot->ShallowCopy(data);
+
+  for (int type = 0; type < vtkDataObject::NUMBER_OF_ATTRIBUTE_TYPES; ++type)
+  {
+    if (auto fd = snapshot->GetAttributesAsFieldData(type))
+    {
+      SnapshotFieldData(fd);
+    }
+  }
+
+  if (auto ps = vtkPointSet::SafeDownCast(snapshot))
+  {
+    if (ps->GetPoints())
+    {
+      vtkNew<vtkPoints> points;
+      points->SetData(SnapshotArray(ps->GetPoints()->GetData()));
+      ps->SetPoints(points);
+    }
+  }
+
+  if (auto pd = vtkPolyData::SafeDownCast(snapshot))
+  {
+    // Only replace non-empty cell arrays: the getters never return null.
+    if (pd->GetNumberOfVerts() > 0)
+    {
+      pd->SetVerts(SnapshotCellArray(pd->GetVerts()));
+    }
+    if (pd->GetNumberOfLines() > 0)
+    {
+      pd->SetLines(SnapshotCellArray(pd->GetLines()));
+    }
+    if (pd->GetNumberOfPolys() > 0)
+    {
+      pd->SetPolys(SnapshotCellArray(pd->GetPolys()));
+    }
+    if (pd->GetNumberOfStrips() > 0)
+    {
+      pd->SetStrips(SnapshotCellArray(pd->GetStrips()));
+    }
+  }
+  else if (auto ug = vtkUnstructuredGrid::SafeDownCast(snapshot))
+  {
+    if (ug->GetCells())
+    {
+      ug->SetCells(SnapshotArray(ug->GetCellTypesArray()), SnapshotCellArray(ug->GetCells()),
+        SnapshotArray(ug->GetFaceLocations()), SnapshotArray(ug->GetFaces()));
+    }
+  }
+  else if (auto rg = vtkRectilinearGrid::SafeDownCast(snapshot))
+  {
+    rg->SetXCoordinates(SnapshotArray(rg->GetXCoordinates()));
+    rg->SetYCoordinates(SnapshotArray(rg->GetYCoordinates()));
+    rg->SetZCoordinates(SnapshotArray(rg->GetZCoordinates()));
+  }
+
+  return snapshot;
+}
+
+// Creates a writer configured like `prototype`, with its own compressor.
+vtkSmartPointer<vtkXMLWriter> NewWriter(vtkXMLWriter* prototype)
+{
+  auto writer = vtk::TakeSmartPointer(prototype->NewInstance());
+  writer->SetByteOrder(prototype->GetByteOrder());
+  writer->SetHeaderType(prototype->GetHeaderType());
+  writer->SetIdType(prototype->GetIdType());
+  writer->SetBlockSize(prototype->GetBlockSize());
+  writer->SetDataMode(prototype->GetDataMode());
+  writer->SetEncodeAppendedData(prototype->GetEncodeAppendedData());
+  if (auto compressor = prototype->GetCompressor())
+  {
+    writer->SetCompressor(vtk::TakeSmartPointer(compressor->NewInstance()));
+  }
+  else
+  {
+    writer->SetCompressor(nullptr);
+  }
+  writer->SetCompressionLevel(prototype->GetCompressionLevel());
+  return writer;
+}
+}
+
+//****************************************************************************
+class vtkThreadedXMLWriter::vtkInternals
+{
+private:
+  using TaskQueueType = vtkThreadedTaskQueue<void, vtkSmartPointer<vtkXMLWriter>, unsigned long>;
+  std::unique_ptr<TaskQueueType> Queue;
+
+  std::mutex MemoryMutex;
+  std::condition_variable MemoryCV;
+  unsigned long QueuedMemory = 0;
+
+  void Write(const vtkSmartPointer<vtkXMLWriter>& writer, unsigned long size)
+  {
+    vtkLogF(TRACE, "writing: %s", writer->GetFileName());
+    if (!writer->Write())
+    {
+      vtkLogF(ERROR, "Failed to write '%s'.", writer->GetFileName());
+    }
+    // Release the snapshot before accounting for it.
+    writer->RemoveAllInputs();
+    {
+      std::lock_guard<std::mutex> lk(this->MemoryMutex);
+      this->QueuedMemory -= size;
+    }
+    this->MemoryCV.notify_all();
+  }
+
+  std::function<void(vtkSmartPointer<vtkXMLWriter>, unsigned long)> GetWorker()
+  {
+    return [this](vtkSmartPointer<vtkXMLWriter> writer, unsigned long size) {
+      this->Write(writer, size);
+    };
+  }
+
+public:
+  ~vtkInternals() { this->TerminateAllWorkers(); }
+
+  bool IsRunning() const { return this->Queue != nullptr; }
+
+  void TerminateAllWorkers()
+  {
+    if (this->Queue)
+    {
+      this->Queue->Flush();
+    }
+    this->Queue.reset(nullptr);
+  }
+
+  void SpawnWorkers(vtkTypeUInt32 numberOfThreads)
+  {
+    this->Queue.reset(new TaskQueueType(this->GetWorker(),
+      /*strict_ordering=*/true,
+      /*buffer_size=*/-1,
+      /*max_concurrent_tasks=*/static_cast<int>(numberOfThreads)));
+  }
+
+  void UseGlobalPool()
+  {
+    this->Queue.reset(new TaskQueueType(this->GetWorker(), vtkThreadedTaskPool::GetGlobalPool(),
+      /*strict_ordering=*/true,
+      /*buffer_size=*/-1));
+  }
+
+  // Blocks until `size` fits within `maximum`, or nothing else is queued.
+  void ReserveMemory(unsigned long size, unsigned long maximum)
+  {
+    std::unique_lock<std::mutex> lk(this->MemoryMutex);
+    this->MemoryCV.wait(lk, [&] {
+      return this->QueuedMemory == 0 || this->QueuedMemory + size <= maximum;
+    });
+    this->QueuedMemory += size;
+  }
+
+  unsigned long GetQueuedMemory()
+  {
+    std::lock_guard<std::mutex> lk(this->MemoryMutex);
+    return this->QueuedMemory;
+  }
+
+  void PushWriterToQueue(vtkSmartPointer<vtkXMLWriter>&& writer, unsigned long size)
+  {
+    this->Queue->Push(std::move(writer), std::move(size));
+  }
+};
+
+vtkStandardNewMacro(vtkThreadedXMLWriter);
+vtkCxxSetObjectMacro(vtkThreadedXMLWriter, Writer, vtkXMLWriter);
+//------------------------------------------------------------------------------
+vtkThreadedXMLWriter::vtkThreadedXMLWriter()
+  : Internals(new vtkInternals())
+{
+  this->Writer = vtkXMLDataObjectWriter::New();
+  this->MaxThreads = MAX_NUMBER_OF_THREADS_IN_POOL;
+  this->UseGlobalTaskPool = false;
+  this->MaximumQueuedMemory = 1 << 20;
+  this->DeepCopyInput = false;
+}
+
+//------------------------------------------------------------------------------
+vtkThreadedXMLWriter::~vtkThreadedXMLWriter()
+{
+  delete this->Internals;
+  this->Internals = nullptr;
+  this->SetWriter(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedXMLWriter::SetMaxThreads(vtkTypeUInt32 maxThreads)
+{
+  if (maxThreads < MAX_NUMBER_OF_THREADS_IN_POOL && maxThreads > 0 &&
+    this->MaxThreads != maxThreads)
+  {
+    this->MaxThreads = maxThreads;
+    this->Modified();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedXMLWriter::Initialize()
+{
+  // Stop any started thread first
+  this->Internals->TerminateAllWorkers();
+
+  if (this->UseGlobalTaskPool)
+  {
+    this->Internals->UseGlobalPool();
+  }
+  else
+  {
+    this->Internals->SpawnWorkers(this->MaxThreads);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedXMLWriter::EncodeAndWrite(vtkDataObject* data, const char* fileName)
+{
+  if (!data || !fileName)
+  {
+    vtkErrorMacro("A data object and a file name are required.");
+    return;
+  }
+  if (vtkCompositeDataSet::SafeDownCast(data))
+  {
+    vtkErrorMacro("Composite datasets are not supported: " << data->GetClassName());
+    return;
+  }
+  if (!this->Writer)
+  {
+    vtkErrorMacro("No writer set.");
+    return;
+  }
+
+  vtkSmartPointer<vtkDataObject> snapshot;
+  if (this->DeepCopyInput)
+  {
+    snapshot = vtk::TakeSmartPointer(data->NewInstance());
+    snapshot->DeepCopy(data);
+  }
+  else
+  {
+    snapshot = ::ShallowSnapshot(data);
+  }
+
+  auto writer = ::NewWriter(this->Writer);
+  writer->SetFileName(fileName);
+  writer->SetInputData(snapshot);
+
+  // Shallow snapshots are accounted for the memory they keep alive.
+  unsigned long size = snapshot->GetActualMemorySize();
+  snapshot = nullptr;
+  this->Internals->ReserveMemory(size, this->MaximumQueuedMemory);
+
+  if (!this->Internals->IsRunning())
+  {
+    this->Initialize();
+  }
+  this->Internals->PushWriterToQueue(std::move(writer), size);
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedXMLWriter::Finalize()
+{
+  this->Internals->TerminateAllWorkers();
+}
+
+//------------------------------------------------------------------------------
+unsigned long vtkThreadedXMLWriter::GetQueuedMemory()
+{
+  return this->Internals->GetQueuedMemory();
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedXMLWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Writer: ";
+  if (this->Writer)
+  {
+    os << endl;
+    this->Writer->PrintSelf(os, indent.GetNextIndent());
+  }
+  else
+  {
+    os << "(none)" << endl;
+  }
+  os << indent << "MaxThreads: " << this->MaxThreads << endl;
+  os << indent << "UseGlobalTaskPool: " << this->UseGlobalTaskPool << endl;
+  os << indent << "MaximumQueuedMemory: " << this->MaximumQueuedMemory << endl;
+  os << indent << "DeepCopyInput: " << this->DeepCopyInput << endl;
+}
@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedXMLWriter.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class    vtkThreadedXMLWriter
+ * @brief    compress and write datasets in VTK XML format using threads
+ *
+ * vtkThreadedXMLWriter takes a snapshot of a data object and hands it to a
+ * background thread that compresses and writes it with a vtkXMLWriter, so
+ * that `EncodeAndWrite()` returns as soon as the snapshot is taken.
+ *
+ * The snapshot is shallow: the arrays of the snapshot share their memory
+ * with the arrays of the input but are distinct array objects, so that the
+ * caller may keep using, modifying the structure of, or releasing the input
+ * right away. Overwriting the values of the input arrays in place while they
+ * are written is not safe, unless `DeepCopyInput` is on.
+ *
+ * The writers are created from a prototype, `Writer`, whose settings (data
+ * mode, compressor, compression level, byte order, ...) are copied for each
+ * write. The default prototype is a vtkXMLDataObjectWriter, that picks the
+ * vtkXMLWriter subclass matching the data type. Composite datasets are not
+ * supported.
+ *
+ * The memory held by queued snapshots is bounded by `MaximumQueuedMemory`:
+ * `EncodeAndWrite()` blocks until enough pending writes complete.
+ *
+ * @sa
+ * vtkThreadedImageWriter vtkXMLDataObjectWriter
+ */
+
+#ifndef vtkThreadedXMLWriter_h
+#define vtkThreadedXMLWriter_h
+
+#include "vtkIOAsynchronousModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkDataObject;
+class vtkXMLWriter;
+
+class VTKIOASYNCHRONOUS_EXPORT vtkThreadedXMLWriter : public vtkObject
+{
+public:
+  static vtkThreadedXMLWriter* New();
+  vtkTypeMacro(vtkThreadedXMLWriter, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Start the worker threads. It should be called again after any change on
+   * the thread count. `EncodeAndWrite()` calls it if needed.
+   *
+   * This method will wait for any pending write to complete first.
+   */
+  void Initialize();
+
+  /**
+   * Snapshot the data object and queue it to be written to the given file.
+   * Blocks while the queued snapshots use more than MaximumQueuedMemory.
+   */
+  void EncodeAndWrite(vtkDataObject* data, VTK_FILEPATH const char* fileName);
+
+  /**
+   * Wait for all pending writes to complete and stop the worker threads.
+   */
+  void Finalize();
+
+  ///@{
+  /**
+   * Writer used as a prototype for each write. Its settings are copied, it is
+   * never executed itself. Changes apply to subsequent calls to
+   * `EncodeAndWrite()`. Defaults to a vtkXMLDataObjectWriter.
+   */
+  void SetWriter(vtkXMLWriter* writer);
+  vtkGetObjectMacro(Writer, vtkXMLWriter);
+  ///@}
+
+  ///@{
+  /**
+   * Define the number of worker thread to use.
+   * Initialize() need to be called after any thread count change.
+   */
+  void SetMaxThreads(vtkTypeUInt32);
+  vtkGetMacro(MaxThreads, vtkTypeUInt32);
+  ///@}
+
+  ///@{
+  /**
+   * When on, the datasets are written by the threads of the process-wide
+   * vtkThreadedTaskPool instead of MaxThreads threads owned by this writer.
+   * Default is off. Initialize() need to be called after any change.
+   */
+  vtkSetMacro(UseGlobalTaskPool, bool);
+  vtkGetMacro(UseGlobalTaskPool, bool);
+  vtkBooleanMacro(UseGlobalTaskPool, bool);
+  ///@}
+
+  ///@{
+  /**
+   * Upper bound, in kibibytes, of the memory held by the snapshots waiting to
+   * be written. A snapshot larger than the bound is still written, once the
+   * queue is empty. Default is 1048576 (1 GiB).
+   */
+  vtkSetClampMacro(MaximumQueuedMemory, unsigned long, 1, VTK_UNSIGNED_LONG_MAX);
+  vtkGetMacro(MaximumQueuedMemory, unsigned long);
+  ///@}
+
+  /**
+   * Memory, in kibibytes, held by the snapshots waiting to be written.
+   */
+  unsigned long GetQueuedMemory();
+
+  ///@{
+  /**
+   * When on, the snapshot is a deep copy of the input, so that the caller may
+   * overwrite the input arrays in place right away. Default is off.
+   */
+  vtkSetMacro(DeepCopyInput, bool);
+  vtkGetMacro(DeepCopyInput, bool);
+  vtkBooleanMacro(DeepCopyInput, bool);
+  ///@}
+
+protected:
+  vtkThreadedXMLWriter();
+  ~vtkThreadedXMLWriter() override;
+
+private:
+  vtkThreadedXMLWriter(const vtkThreadedXMLWriter&) = delete;
+  void operator=(const vtkThreadedXMLWriter&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+  vtkXMLWriter* Writer;
+  vtkTypeUInt32 MaxThreads;
+  bool UseGlobalTaskPool;
+  unsigned long MaximumQueuedMemory;
+  bool DeepCopyInput;
+};
+
+#endif
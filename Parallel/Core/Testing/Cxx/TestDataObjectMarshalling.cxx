@@ -0,0 +1,250 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataObjectMarshalling.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Round-trips data objects through vtkCommunicator::MarshalDataObject and
+// vtkCommunicator::UnMarshalDataObject and checks that structure, arrays and
+// attributes survive.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCharArray.h"
+#include "vtkCommunicator.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMatrix3x3.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstring>
+
+namespace
+{
+//------------------------------------------------------------------------------
+bool ArraysEqual(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b || a->GetDataType() != b->GetDataType() ||
+    a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  if ((a->GetName() == nullptr) != (b->GetName() == nullptr) ||
+    (a->GetName() && strcmp(a->GetName(), b->GetName()) != 0))
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < a->GetNumberOfValues(); ++cc)
+  {
+    if (a->GetVariantValue(cc) != b->GetVariantValue(cc))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> RoundTrip(vtkDataObject* input, bool expectBinary)
+{
+  vtkNew<vtkCharArray> buffer;
+  if (!vtkCommunicator::MarshalDataObject(input, buffer))
+  {
+    cerr << "ERROR: Failed to marshal " << input->GetClassName() << endl;
+    return nullptr;
+  }
+  const bool isBinary =
+    buffer->GetNumberOfTuples() >= 8 && strncmp(buffer->GetPointer(0), "VTKBINMD", 8) == 0;
+  if (isBinary != expectBinary)
+  {
+    cerr << "ERROR: Unexpected marshalling format for " << input->GetClassName() << endl;
+    return nullptr;
+  }
+  auto output = vtkCommunicator::UnMarshalDataObject(buffer);
+  if (!output || output->GetDataObjectType() != input->GetDataObjectType())
+  {
+    cerr << "ERROR: Failed to unmarshal " << input->GetClassName() << endl;
+    return nullptr;
+  }
+  return output;
+}
+
+//------------------------------------------------------------------------------
+bool TestPolyData()
+{
+  vtkNew<vtkPolyData> pd;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int cc = 0; cc < 5; ++cc)
+  {
+    points->InsertNextPoint(cc, cc * cc, -cc);
+  }
+  pd->SetPoints(points);
+  vtkNew<vtkCellArray> polys;
+  vtkIdType tri[3] = { 0, 1, 2 };
+  vtkIdType quad[4] = { 1, 2, 3, 4 };
+  polys->InsertNextCell(3, tri);
+  polys->InsertNextCell(4, quad);
+  pd->SetPolys(polys);
+  vtkNew<vtkCellArray> verts;
+  verts->InsertNextCell(1, tri);
+  pd->SetVerts(verts);
+
+  vtkNew<vtkFloatArray> normals;
+  normals->SetName("Normals");
+  normals->SetNumberOfComponents(3);
+  normals->SetComponentName(0, "nx");
+  for (int cc = 0; cc < 5; ++cc)
+  {
+    normals->InsertNextTuple3(0, 0, cc);
+  }
+  pd->GetPointData()->SetNormals(normals);
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    cellIds->InsertNextValue(10 * cc);
+  }
+  pd->GetCellData()->SetScalars(cellIds);
+
+  auto output = vtkPolyData::SafeDownCast(RoundTrip(pd, true));
+  if (!output)
+  {
+    return false;
+  }
+  if (!ArraysEqual(output->GetPoints()->GetData(), points->GetData()) ||
+    !ArraysEqual(output->GetPolys()->GetConnectivityArray(), polys->GetConnectivityArray()) ||
+    !ArraysEqual(output->GetPolys()->GetOffsetsArray(), polys->GetOffsetsArray()) ||
+    output->GetNumberOfVerts() != 1 || output->GetNumberOfCells() != 3)
+  {
+    cerr << "ERROR: vtkPolyData structure mismatch." << endl;
+    return false;
+  }
+  if (!ArraysEqual(output->GetPointData()->GetNormals(), normals) ||
+    !ArraysEqual(output->GetCellData()->GetScalars(), cellIds) ||
+    strcmp(output->GetPointData()->GetNormals()->GetComponentName(0), "nx") != 0)
+  {
+    cerr << "ERROR: vtkPolyData attribute mismatch." << endl;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool TestUnstructuredGrid()
+{
+  vtkNew<vtkUnstructuredGrid> ug;
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 0, 0);
+  points->InsertNextPoint(0, 1, 0);
+  points->InsertNextPoint(0, 0, 1);
+  points->InsertNextPoint(1, 1, 1);
+  ug->SetPoints(points);
+  vtkIdType tet[4] = { 0, 1, 2, 3 };
+  vtkIdType line[2] = { 3, 4 };
+  ug->InsertNextCell(VTK_TETRA, 4, tet);
+  ug->InsertNextCell(VTK_LINE, 2, line);
+
+  vtkNew<vtkDoubleArray> fieldArray;
+  fieldArray->SetName("Time");
+  fieldArray->InsertNextValue(1.5);
+  ug->GetFieldData()->AddArray(fieldArray);
+
+  auto output = vtkUnstructuredGrid::SafeDownCast(RoundTrip(ug, true));
+  if (!output)
+  {
+    return false;
+  }
+  if (!ArraysEqual(output->GetPoints()->GetData(), points->GetData()) ||
+    !ArraysEqual(output->GetCellTypesArray(), ug->GetCellTypesArray()) ||
+    output->GetCellType(0) != VTK_TETRA || output->GetCell(1)->GetPointId(1) != 4 ||
+    !ArraysEqual(output->GetFieldData()->GetArray("Time"), fieldArray))
+  {
+    cerr << "ERROR: vtkUnstructuredGrid mismatch." << endl;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool TestImageData()
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(2, 5, -1, 1, 0, 0);
+  image->SetOrigin(0.5, 1, 2);
+  image->SetSpacing(0.1, 0.2, 0.3);
+  image->SetDirectionMatrix(0, 1, 0, 1, 0, 0, 0, 0, 1);
+  image->AllocateScalars(VTK_UNSIGNED_SHORT, 2);
+  for (vtkIdType cc = 0; cc < image->GetPointData()->GetScalars()->GetNumberOfValues(); ++cc)
+  {
+    image->GetPointData()->GetScalars()->SetVariantValue(cc, static_cast<int>(cc));
+  }
+
+  auto output = vtkImageData::SafeDownCast(RoundTrip(image, true));
+  if (!output)
+  {
+    return false;
+  }
+  int extent[6];
+  output->GetExtent(extent);
+  double origin[3], spacing[3];
+  output->GetOrigin(origin);
+  output->GetSpacing(spacing);
+  if (extent[0] != 2 || extent[1] != 5 || extent[2] != -1 || extent[3] != 1 ||
+    origin[0] != 0.5 || spacing[2] != 0.3 || output->GetDirectionMatrix()->GetElement(0, 1) != 1 ||
+    !ArraysEqual(output->GetPointData()->GetScalars(), image->GetPointData()->GetScalars()))
+  {
+    cerr << "ERROR: vtkImageData mismatch." << endl;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool TestLegacyFallback()
+{
+  // String arrays are not described by the binary schema.
+  vtkNew<vtkPolyData> pd;
+  vtkNew<vtkStringArray> names;
+  names->SetName("Names");
+  names->InsertNextValue("a");
+  pd->GetFieldData()->AddArray(names);
+
+  auto output = vtkPolyData::SafeDownCast(RoundTrip(pd, false));
+  if (!output || !output->GetFieldData()->GetAbstractArray("Names"))
+  {
+    cerr << "ERROR: Legacy fallback failed." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestDataObjectMarshalling(int, char*[])
+{
+  bool success = TestPolyData();
+  success &= TestUnstructuredGrid();
+  success &= TestImageData();
+  success &= TestLegacyFallback();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
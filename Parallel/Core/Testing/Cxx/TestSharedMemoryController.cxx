@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSharedMemoryController.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Exercises point-to-point, collective and non-blocking collective
+// communication between processes forked by vtkSharedMemoryController.
+
+#include "vtkCellArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSharedMemoryController.h"
+#include "vtkSmartPointer.h"
+
+#include <numeric>
+#include <vector>
+
+namespace
+{
+const int NUMBER_OF_PROCESSES = 4;
+
+//------------------------------------------------------------------------------
+bool TestPointToPoint(vtkMultiProcessController* controller)
+{
+  const int rank = controller->GetLocalProcessId();
+  const int numProcs = controller->GetNumberOfProcesses();
+  const int next = (rank + 1) % numProcs;
+  const int prev = (rank + numProcs - 1) % numProcs;
+  bool success = true;
+
+  // Messages much larger than the channel buffer, exchanged in a ring where
+  // every process sends before it receives.
+  const vtkIdType length = 100000;
+  std::vector<int> sendBuffer(length);
+  std::iota(sendBuffer.begin(), sendBuffer.end(), rank);
+  std::vector<int> recvBuffer(length, -1);
+  controller->Send(sendBuffer.data(), length, next, 100);
+  controller->Receive(recvBuffer.data(), length, prev, 100);
+  if (recvBuffer[0] != prev || recvBuffer[length - 1] != prev + length - 1 ||
+    controller->GetCount() != length)
+  {
+    cerr << "ERROR: rank " << rank << " received a corrupted large message." << endl;
+    success = false;
+  }
+
+  // Messages received out of order, by tag.
+  int first = rank * 10 + 1, second = rank * 10 + 2;
+  controller->Send(&first, 1, next, 201);
+  controller->Send(&second, 1, next, 202);
+  int value = -1;
+  controller->Receive(&value, 1, prev, 202);
+  success &= (value == prev * 10 + 2);
+  controller->Receive(&value, 1, prev, 201);
+  success &= (value == prev * 10 + 1);
+
+  // ANY_SOURCE.
+  if (rank == 0)
+  {
+    int sum = 0;
+    for (int cc = 1; cc < numProcs; ++cc)
+    {
+      controller->Receive(&value, 1, vtkMultiProcessController::ANY_SOURCE, 300);
+      sum += value;
+    }
+    success &= (sum == numProcs * (numProcs - 1) / 2);
+  }
+  else
+  {
+    controller->Send(&rank, 1, 0, 300);
+  }
+
+  if (!success)
+  {
+    cerr << "ERROR: rank " << rank << " point-to-point test failed." << endl;
+  }
+  return success;
+}
+
+//------------------------------------------------------------------------------
+bool TestCollectives(vtkMultiProcessController* controller)
+{
+  const int rank = controller->GetLocalProcessId();
+  const int numProcs = controller->GetNumberOfProcesses();
+  bool success = true;
+
+  int root = rank == 1 ? 42 : 0;
+  controller->Broadcast(&root, 1, 1);
+  success &= (root == 42);
+
+  int sum = 0;
+  controller->AllReduce(&rank, &sum, 1, vtkCommunicator::SUM_OP);
+  success &= (sum == numProcs * (numProcs - 1) / 2);
+
+  std::vector<int> gathered(numProcs, -1);
+  controller->Gather(&rank, gathered.data(), 1, 0);
+  for (int cc = 0; rank == 0 && cc < numProcs; ++cc)
+  {
+    success &= (gathered[cc] == cc);
+  }
+
+  vtkNew<vtkFloatArray> sendArray;
+  sendArray->SetNumberOfTuples(rank + 1);
+  sendArray->FillValue(static_cast<float>(rank));
+  vtkNew<vtkFloatArray> recvArray;
+  controller->AllGatherV(sendArray, recvArray);
+  success &= (recvArray->GetNumberOfTuples() == numProcs * (numProcs + 1) / 2);
+  success &= (recvArray->GetValue(recvArray->GetNumberOfTuples() - 1) == numProcs - 1);
+
+  controller->Barrier();
+
+  // Non-blocking variants.
+  vtkMultiProcessController::CollectiveRequest requests[3];
+  int max = -1;
+  controller->NoBlockAllReduce(&rank, &max, 1, vtkCommunicator::MAX_OP, requests[0]);
+  std::vector<double> allGathered(numProcs, -1.0);
+  const double value = rank * 0.5;
+  controller->NoBlockAllGather(&value, allGathered.data(), 1, requests[1]);
+  controller->NoBlockBarrier(requests[2]);
+  requests[0].Wait();
+  requests[1].Wait();
+  while (!requests[2].Test())
+  {
+  }
+  success &= (max == numProcs - 1);
+  for (int cc = 0; cc < numProcs; ++cc)
+  {
+    success &= (allGathered[cc] == cc * 0.5);
+  }
+
+  if (!success)
+  {
+    cerr << "ERROR: rank " << rank << " collective test failed." << endl;
+  }
+  return success;
+}
+
+//------------------------------------------------------------------------------
+bool TestDataObject(vtkMultiProcessController* controller)
+{
+  const int rank = controller->GetLocalProcessId();
+  if (rank == 0)
+  {
+    vtkNew<vtkPolyData> pd;
+    vtkNew<vtkPoints> points;
+    for (int cc = 0; cc < 1000; ++cc)
+    {
+      points->InsertNextPoint(cc, 0, 0);
+    }
+    pd->SetPoints(points);
+    vtkNew<vtkCellArray> lines;
+    lines->InsertNextCell(1000);
+    for (int cc = 0; cc < 1000; ++cc)
+    {
+      lines->InsertCellPoint(cc);
+    }
+    pd->SetLines(lines);
+    for (int cc = 1; cc < controller->GetNumberOfProcesses(); ++cc)
+    {
+      controller->Send(pd, cc, 400);
+    }
+    return true;
+  }
+
+  vtkNew<vtkPolyData> pd;
+  controller->Receive(pd, 0, 400);
+  if (pd->GetNumberOfPoints() != 1000 || pd->GetNumberOfLines() != 1 ||
+    pd->GetPoint(999)[0] != 999)
+  {
+    cerr << "ERROR: rank " << rank << " received a wrong vtkPolyData." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestSharedMemoryController(int argc, char* argv[])
+{
+  vtkNew<vtkSharedMemoryController> controller;
+  controller->SetNumberOfProcesses(NUMBER_OF_PROCESSES);
+  controller->SetChannelBufferSize(4096);
+  controller->Initialize(&argc, &argv);
+  if (controller->GetNumberOfProcesses() != NUMBER_OF_PROCESSES)
+  {
+    cerr << "ERROR: wrong number of processes." << endl;
+    controller->Finalize();
+    return EXIT_FAILURE;
+  }
+
+  int success = TestPointToPoint(controller) ? 1 : 0;
+  success &= TestCollectives(controller) ? 1 : 0;
+  success &= TestDataObject(controller) ? 1 : 0;
+
+  int allSuccess = 0;
+  controller->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
+  controller->Finalize();
+  return allSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
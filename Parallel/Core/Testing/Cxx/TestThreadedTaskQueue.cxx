@@ -15,8 +15,189 @@
 #include "vtkThreadedTaskQueue.h"
 
 #include "vtkLogger.h"
+#include "vtkNew.h"
+#include "vtkThreadedTaskPool.h"
+
+#include <atomic>
 #include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
+
+namespace
+{
+// Single worker queue whose first task (0) blocks till Release() so that the
+// following tasks are queued.
+class GatedQueue
+{
+public:
+  GatedQueue()
+    : Started(false)
+    , Gate(this->Promise.get_future().share())
+    , Queue(
+        [this](int i) {
+          if (i == 0)
+          {
+            this->Started = true;
+            this->Gate.wait();
+          }
+          std::lock_guard<std::mutex> lk(this->OrderMutex);
+          this->Order.push_back(i);
+          return i;
+        },
+        true, -1, 1)
+  {
+    this->Queue.Push(0);
+    while (!this->Started)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  void Release() { this->Promise.set_value(); }
+
+  std::vector<int> PopAll()
+  {
+    std::vector<int> results;
+    int r;
+    while (this->Queue.Pop(r))
+    {
+      results.push_back(r);
+    }
+    return results;
+  }
+
+  std::atomic<bool> Started;
+  std::promise<void> Promise;
+  std::shared_future<void> Gate;
+  std::mutex OrderMutex;
+  std::vector<int> Order;
+  vtkThreadedTaskQueue<int, int> Queue;
+};
+
+bool TestPriorities()
+{
+  GatedQueue gq;
+  gq.Queue.PushWithPriority(1, 1);
+  gq.Queue.PushWithPriority(5, 2);
+  gq.Queue.PushWithPriority(1, 3);
+  gq.Queue.PushWithPriority(5, 4);
+  gq.Release();
+  auto results = gq.PopAll();
+  if (gq.Order != std::vector<int>{ 0, 2, 4, 1, 3 } ||
+    results != std::vector<int>{ 0, 1, 2, 3, 4 })
+  {
+    vtkLogF(ERROR, "tasks not executed by priority or results not in order.");
+    return false;
+  }
+  return true;
+}
+
+bool TestCancel()
+{
+  GatedQueue gq;
+  for (int i = 1; i < 5; ++i)
+  {
+    gq.Queue.Push(std::move(i));
+  }
+  auto handle = gq.Queue.Submit(0, 5);
+  auto handle2 = gq.Queue.Submit(0, 6);
+  const std::size_t count =
+    gq.Queue.Cancel([](const int& i) { return i % 2 == 0 && i < 5; });
+  const bool cancelled = handle2.Cancel();
+  gq.Release();
+  auto results = gq.PopAll();
+  if (count != 2 || !cancelled || handle.Get() != 5 || !handle2.IsCancelled() ||
+    handle2.Wait() || results != std::vector<int>{ 0, 1, 3 } || !gq.Queue.IsEmpty())
+  {
+    vtkLogF(ERROR, "cancellation failed.");
+    return false;
+  }
+  return true;
+}
+
+bool TestBoundedQueue()
+{
+  vtkThreadedTaskQueue<int, int> queue([](int i) { return 2 * i; }, true, -1, 2);
+  queue.SetMaximumNumberOfQueuedTasks(1);
+  for (int i = 0; i < 50; ++i)
+  {
+    queue.Push(std::move(i));
+  }
+  int expected = 0, r;
+  while (queue.Pop(r))
+  {
+    if (r != 2 * expected++)
+    {
+      vtkLogF(ERROR, "wrong result from bounded queue.");
+      return false;
+    }
+  }
+  return expected == 50;
+}
+
+bool TestMoveOnlyArguments()
+{
+  vtkThreadedTaskQueue<int, std::unique_ptr<int>> queue(
+    [](std::unique_ptr<int> i) { return *i; }, true, -1, 1);
+  for (int i = 0; i < 4; ++i)
+  {
+    queue.Push(std::unique_ptr<int>(new int(i)));
+  }
+  auto handle = queue.Submit(0, std::unique_ptr<int>(new int(5)));
+  queue.Cancel([](const std::unique_ptr<int>& i) { return *i == 5; });
+  int sum = 0, r;
+  while (queue.Pop(r))
+  {
+    sum += r;
+  }
+
+  vtkThreadedTaskQueue<void, std::unique_ptr<int>> queue2(
+    [&sum](std::unique_ptr<int> i) { sum += *i; }, true, -1, 1);
+  queue2.Submit(0, std::unique_ptr<int>(new int(10))).Wait();
+  if (sum != 16 || (!handle.IsCancelled() && handle.Get() != 5))
+  {
+    vtkLogF(ERROR, "wrong results with move-only arguments.");
+    return false;
+  }
+  return true;
+}
+
+bool TestSharedPool()
+{
+  vtkNew<vtkThreadedTaskPool> pool;
+  pool->SetNumberOfThreads(2);
+  std::atomic<int> sum(0);
+  {
+    vtkThreadedTaskQueue<double, int> queue([](int i) { return i * 0.5; }, pool);
+    vtkThreadedTaskQueue<void, int> queue2([&sum](int i) { sum += i; }, pool);
+    for (int i = 0; i < 100; ++i)
+    {
+      queue.Push(std::move(i));
+      queue2.Push(std::move(i));
+    }
+    auto handle = queue2.Submit(10, 1000);
+    double total = 0.0, r;
+    while (queue.Pop(r))
+    {
+      total += r;
+    }
+    queue2.Flush();
+    if (total != 2475.0 || sum != 5950 || !handle.IsReady())
+    {
+      vtkLogF(ERROR, "wrong results from queues sharing a pool.");
+      return false;
+    }
+  }
+
+  vtkThreadedTaskQueue<int, int> queue3(
+    [](int i) { return i; }, vtkThreadedTaskPool::GetGlobalPool());
+  return queue3.Submit(0, 42).Get() == 42;
+}
+}
+
 int TestThreadedTaskQueue(int, char*[])
 {
   vtkThreadedTaskQueue<double, int, double> queue(
@@ -47,5 +228,11 @@ int TestThreadedTaskQueue(int, char*[])
   queue2.Push(1);
   queue2.Push(2);
   queue2.Flush();
+
+  if (!TestPriorities() || !TestCancel() || !TestBoundedQueue() || !TestMoveOnlyArguments() ||
+    !TestSharedPool())
+  {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
@@ -15,6 +15,9 @@
 #include "vtkCommunicator.h"
 
 #include "vtkBoundingBox.h"
+#include "vtkByteSwap.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
 #include "vtkCharArray.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataObjectTypes.h"
@@ -22,15 +25,20 @@
 #include "vtkDataSetReader.h"
 #include "vtkDataSetWriter.h"
 #include "vtkDoubleArray.h"
+#include "vtkEndian.h"
 #include "vtkFloatArray.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkGenericDataObjectWriter.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkIntArray.h"
+#include "vtkMatrix3x3.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessStream.h"
 #include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSmartPointer.h"
 #include "vtkStructuredGrid.h"
@@ -39,10 +47,12 @@
 #include "vtkTypeTraits.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedLongArray.h"
+#include "vtkUnstructuredGrid.h"
 
 #define VTK_CREATE(type, name) vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 #define EXTENT_HEADER_SIZE 128
@@ -97,6 +107,534 @@ STANDARD_OPERATION_DEFINITION(LogicalXor, (!A[i] && B[i]) || (A[i] && !B[i]));
 STANDARD_OPERATION_FLOAT_OVERRIDE(BitwiseXor);
 STANDARD_OPERATION_DEFINITION(BitwiseXor, A[i] ^ B[i]);
 
+//=============================================================================
+// Binary marshalling of elemental data objects.
+//
+// Data objects whose arrays are all plain vtkDataArray instances are described
+// by a small schema (structure, array types, shapes, names and attributes)
+// serialized into a vtkMultiProcessStream. The raw array buffers are not
+// part of the schema: Send/Receive transfer them as individual messages
+// straight from/into the array storage, and MarshalDataObject appends them,
+// aligned, after the schema in a single buffer. Anything the schema cannot
+// describe falls back to the legacy vtkGenericDataObjectWriter format.
+namespace
+{
+const char BINARY_MARSHAL_MAGIC[8] = { 'V', 'T', 'K', 'B', 'I', 'N', 'M', 'D' };
+// magic followed by the schema length stored as 8 little-endian bytes.
+const vtkIdType BINARY_MARSHAL_PREAMBLE_SIZE = 16;
+const vtkIdType BINARY_MARSHAL_ALIGNMENT = 16;
+const int BINARY_SCHEMA_VERSION = 1;
+
+enum ElementalDataObjectFormat
+{
+  LEGACY_FORMAT = 0,
+  BINARY_FORMAT = 1
+};
+
+vtkIdType vtkCommunicatorAlign(vtkIdType offset)
+{
+  return (offset + BINARY_MARSHAL_ALIGNMENT - 1) / BINARY_MARSHAL_ALIGNMENT *
+    BINARY_MARSHAL_ALIGNMENT;
+}
+
+class vtkBinaryDataObjectSchema
+{
+public:
+  vtkBinaryDataObjectSchema()
+  {
+    std::fill(this->Extent, this->Extent + 6, 0);
+    std::fill(this->Origin, this->Origin + 3, 0.0);
+    std::fill(this->Spacing, this->Spacing + 3, 1.0);
+    vtkMatrix3x3::Identity(this->Direction);
+    std::fill(this->Coordinates, this->Coordinates + 3, -1);
+    std::fill(this->CellOffsets, this->CellOffsets + 4, -1);
+    std::fill(this->CellConnectivity, this->CellConnectivity + 4, -1);
+  }
+
+  /**
+   * Arrays referenced by the schema, in the order their raw buffers are
+   * transferred. All of them have the standard (AOS) memory layout.
+   */
+  std::vector<vtkSmartPointer<vtkDataArray>> Arrays;
+
+  /**
+   * Describe `object`. Returns false if the object cannot be marshalled with
+   * this format.
+   */
+  bool Initialize(vtkDataObject* object);
+
+  void Serialize(vtkMultiProcessStream& stream) const;
+
+  /**
+   * Read back a schema and allocate (but not fill) the arrays it references.
+   */
+  bool Deserialize(vtkMultiProcessStream& stream);
+
+  /**
+   * Build `object` from the deserialized schema once the arrays hold their
+   * values. The arrays are shared, not copied.
+   */
+  bool Assemble(vtkDataObject* object);
+
+  int GetDataObjectType() const { return this->DataObjectType; }
+
+  bool NeedsByteSwap() const
+  {
+#ifdef VTK_WORDS_BIGENDIAN
+    return !this->BigEndian;
+#else
+    return this->BigEndian;
+#endif
+  }
+
+private:
+  struct FieldLayout
+  {
+    FieldLayout()
+    {
+      std::fill(this->AttributeIndices,
+        this->AttributeIndices + vtkDataSetAttributes::NUM_ATTRIBUTES, -1);
+    }
+    std::vector<int> ArrayIds;
+    int AttributeIndices[vtkDataSetAttributes::NUM_ATTRIBUTES];
+  };
+
+  bool AddArray(vtkDataArray* array, int& id);
+  bool AddField(vtkFieldData* fd, FieldLayout& layout);
+  bool AssembleField(const FieldLayout& layout, vtkFieldData* fd) const;
+  vtkDataArray* GetArray(int id) const
+  {
+    return (id >= 0 && id < static_cast<int>(this->Arrays.size())) ? this->Arrays[id].Get()
+                                                                      : nullptr;
+  }
+
+  int DataObjectType = -1;
+  bool BigEndian = false;
+  int Extent[6];
+  double Origin[3];
+  double Spacing[3];
+  double Direction[9];
+  int Points = -1;
+  int Coordinates[3];
+  // verts, lines, polys and strips for vtkPolyData; only the first entry is
+  // used for vtkUnstructuredGrid.
+  int CellOffsets[4];
+  int CellConnectivity[4];
+  int CellTypes = -1;
+  int FaceLocations = -1;
+  int Faces = -1;
+  // point (or row) data, cell data and field data.
+  FieldLayout Fields[3];
+};
+
+//------------------------------------------------------------------------------
+bool vtkBinaryDataObjectSchema::AddArray(vtkDataArray* array, int& id)
+{
+  id = -1;
+  if (!array)
+  {
+    return true;
+  }
+  if (array->GetDataType() == VTK_BIT)
+  {
+    return false;
+  }
+  vtkSmartPointer<vtkDataArray> contiguous = array;
+  if (!array->HasStandardMemoryLayout())
+  {
+    contiguous.TakeReference(vtkDataArray::CreateDataArray(array->GetDataType()));
+    if (!contiguous)
+    {
+      return false;
+    }
+    contiguous->DeepCopy(array);
+  }
+  id = static_cast<int>(this->Arrays.size());
+  this->Arrays.emplace_back(contiguous);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkBinaryDataObjectSchema::AddField(vtkFieldData* fd, FieldLayout& layout)
+{
+  layout = FieldLayout();
+  if (!fd)
+  {
+    return true;
+  }
+  for (int cc = 0; cc < fd->GetNumberOfArrays(); ++cc)
+  {
+    int id;
+    vtkDataArray* array = vtkArrayDownCast<vtkDataArray>(fd->GetAbstractArray(cc));
+    if (!array || !this->AddArray(array, id))
+    {
+      return false;
+    }
+    layout.ArrayIds.push_back(id);
+  }
+  if (vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd))
+  {
+    dsa->GetAttributeIndices(layout.AttributeIndices);
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkBinaryDataObjectSchema::Initialize(vtkDataObject* object)
+{
+  if (!object)
+  {
+    return false;
+  }
+  this->DataObjectType = object->GetDataObjectType();
+#ifdef VTK_WORDS_BIGENDIAN
+  this->BigEndian = true;
+#else
+  this->BigEndian = false;
+#endif
+
+  bool valid = true;
+  switch (this->DataObjectType)
+  {
+    case VTK_POLY_DATA:
+    {
+      vtkPolyData* pd = vtkPolyData::SafeDownCast(object);
+      valid = this->AddArray(pd->GetPoints() ? pd->GetPoints()->GetData() : nullptr, this->Points);
+      vtkCellArray* cells[4] = { pd->GetVerts(), pd->GetLines(), pd->GetPolys(), pd->GetStrips() };
+      for (int cc = 0; cc < 4 && valid; ++cc)
+      {
+        if (cells[cc])
+        {
+          valid = this->AddArray(cells[cc]->GetOffsetsArray(), this->CellOffsets[cc]) &&
+            this->AddArray(cells[cc]->GetConnectivityArray(), this->CellConnectivity[cc]);
+        }
+      }
+      break;
+    }
+
+    case VTK_UNSTRUCTURED_GRID:
+    {
+      vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(object);
+      valid = this->AddArray(ug->GetPoints() ? ug->GetPoints()->GetData() : nullptr, this->Points);
+      if (vtkCellArray* cells = ug->GetCells())
+      {
+        valid = valid && this->AddArray(cells->GetOffsetsArray(), this->CellOffsets[0]) &&
+          this->AddArray(cells->GetConnectivityArray(), this->CellConnectivity[0]);
+      }
+      valid = valid && this->AddArray(ug->GetCellTypesArray(), this->CellTypes) &&
+        this->AddArray(ug->GetFaceLocations(), this->FaceLocations) &&
+        this->AddArray(ug->GetFaces(), this->Faces);
+      break;
+    }
+
+    case VTK_IMAGE_DATA:
+    case VTK_STRUCTURED_POINTS:
+    {
+      vtkImageData* id = vtkImageData::SafeDownCast(object);
+      id->GetExtent(this->Extent);
+      id->GetOrigin(this->Origin);
+      id->GetSpacing(this->Spacing);
+      std::copy_n(id->GetDirectionMatrix()->GetData(), 9, this->Direction);
+      break;
+    }
+
+    case VTK_RECTILINEAR_GRID:
+    {
+      vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(object);
+      rg->GetExtent(this->Extent);
+      valid = this->AddArray(rg->GetXCoordinates(), this->Coordinates[0]) &&
+        this->AddArray(rg->GetYCoordinates(), this->Coordinates[1]) &&
+        this->AddArray(rg->GetZCoordinates(), this->Coordinates[2]);
+      break;
+    }
+
+    case VTK_STRUCTURED_GRID:
+    {
+      vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(object);
+      sg->GetExtent(this->Extent);
+      valid = this->AddArray(sg->GetPoints() ? sg->GetPoints()->GetData() : nullptr, this->Points);
+      break;
+    }
+
+    case VTK_TABLE:
+      valid = this->AddField(vtkTable::SafeDownCast(object)->GetRowData(), this->Fields[0]);
+      break;
+
+    default:
+      return false;
+  }
+
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(object))
+  {
+    valid = valid && this->AddField(ds->GetPointData(), this->Fields[0]) &&
+      this->AddField(ds->GetCellData(), this->Fields[1]);
+  }
+  return valid && this->AddField(object->GetFieldData(), this->Fields[2]);
+}
+
+//------------------------------------------------------------------------------
+void vtkBinaryDataObjectSchema::Serialize(vtkMultiProcessStream& stream) const
+{
+  stream << BINARY_SCHEMA_VERSION << this->DataObjectType << this->BigEndian;
+
+  stream << static_cast<int>(this->Arrays.size());
+  for (const auto& array : this->Arrays)
+  {
+    const int numComps = array->GetNumberOfComponents();
+    stream << array->GetDataType() << static_cast<vtkTypeInt64>(array->GetNumberOfTuples())
+           << numComps;
+    const char* name = array->GetName();
+    stream << (name != nullptr) << std::string(name ? name : "");
+    const bool hasComponentNames = array->HasAComponentName();
+    stream << hasComponentNames;
+    for (int comp = 0; hasComponentNames && comp < numComps; ++comp)
+    {
+      const char* compName = array->GetComponentName(comp);
+      stream << std::string(compName ? compName : "");
+    }
+  }
+
+  for (int cc = 0; cc < 6; ++cc)
+  {
+    stream << this->Extent[cc];
+  }
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    stream << this->Origin[cc] << this->Spacing[cc] << this->Coordinates[cc];
+  }
+  for (int cc = 0; cc < 9; ++cc)
+  {
+    stream << this->Direction[cc];
+  }
+  for (int cc = 0; cc < 4; ++cc)
+  {
+    stream << this->CellOffsets[cc] << this->CellConnectivity[cc];
+  }
+  stream << this->Points << this->CellTypes << this->FaceLocations << this->Faces;
+
+  for (const auto& field : this->Fields)
+  {
+    stream << static_cast<int>(field.ArrayIds.size());
+    for (int id : field.ArrayIds)
+    {
+      stream << id;
+    }
+    for (int attribute : field.AttributeIndices)
+    {
+      stream << attribute;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkBinaryDataObjectSchema::Deserialize(vtkMultiProcessStream& stream)
+{
+  int version = 0;
+  stream >> version;
+  if (version != BINARY_SCHEMA_VERSION)
+  {
+    return false;
+  }
+  stream >> this->DataObjectType >> this->BigEndian;
+
+  int numArrays = 0;
+  stream >> numArrays;
+  this->Arrays.clear();
+  this->Arrays.reserve(numArrays);
+  for (int cc = 0; cc < numArrays; ++cc)
+  {
+    int dataType, numComps;
+    vtkTypeInt64 numTuples;
+    bool hasName, hasComponentNames;
+    std::string name;
+    stream >> dataType >> numTuples >> numComps >> hasName >> name >> hasComponentNames;
+
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(vtkDataArray::CreateDataArray(dataType));
+    if (!array || numComps < 1 || numTuples < 0)
+    {
+      return false;
+    }
+    array->SetNumberOfComponents(numComps);
+    array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+    array->SetName(hasName ? name.c_str() : nullptr);
+    for (int comp = 0; hasComponentNames && comp < numComps; ++comp)
+    {
+      std::string compName;
+      stream >> compName;
+      array->SetComponentName(comp, compName.c_str());
+    }
+    this->Arrays.emplace_back(array);
+  }
+
+  for (int cc = 0; cc < 6; ++cc)
+  {
+    stream >> this->Extent[cc];
+  }
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    stream >> this->Origin[cc] >> this->Spacing[cc] >> this->Coordinates[cc];
+  }
+  for (int cc = 0; cc < 9; ++cc)
+  {
+    stream >> this->Direction[cc];
+  }
+  for (int cc = 0; cc < 4; ++cc)
+  {
+    stream >> this->CellOffsets[cc] >> this->CellConnectivity[cc];
+  }
+  stream >> this->Points >> this->CellTypes >> this->FaceLocations >> this->Faces;
+
+  for (auto& field : this->Fields)
+  {
+    int numIds = 0;
+    stream >> numIds;
+    field.ArrayIds.resize(std::max(numIds, 0));
+    for (int& id : field.ArrayIds)
+    {
+      stream >> id;
+    }
+    for (int& attribute : field.AttributeIndices)
+    {
+      stream >> attribute;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkBinaryDataObjectSchema::AssembleField(const FieldLayout& layout, vtkFieldData* fd) const
+{
+  for (int id : layout.ArrayIds)
+  {
+    vtkDataArray* array = this->GetArray(id);
+    if (!array)
+    {
+      return false;
+    }
+    fd->AddArray(array);
+  }
+  if (vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd))
+  {
+    for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+    {
+      if (layout.AttributeIndices[attribute] >= 0)
+      {
+        dsa->SetActiveAttribute(layout.AttributeIndices[attribute], attribute);
+      }
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkBinaryDataObjectSchema::Assemble(vtkDataObject* object)
+{
+  if (!object)
+  {
+    return false;
+  }
+  object->Initialize();
+
+  vtkSmartPointer<vtkPoints> points;
+  if (vtkDataArray* pointsArray = this->GetArray(this->Points))
+  {
+    points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(pointsArray);
+  }
+  auto makeCells = [this](int index) -> vtkSmartPointer<vtkCellArray> {
+    vtkDataArray* offsets = this->GetArray(this->CellOffsets[index]);
+    vtkDataArray* connectivity = this->GetArray(this->CellConnectivity[index]);
+    auto cells = vtkSmartPointer<vtkCellArray>::New();
+    if (offsets && connectivity && !cells->SetData(offsets, connectivity))
+    {
+      return nullptr;
+    }
+    return cells;
+  };
+
+  if (vtkPolyData* pd = vtkPolyData::SafeDownCast(object))
+  {
+    vtkSmartPointer<vtkCellArray> cells[4];
+    for (int cc = 0; cc < 4; ++cc)
+    {
+      if (!(cells[cc] = makeCells(cc)))
+      {
+        return false;
+      }
+    }
+    pd->SetPoints(points);
+    pd->SetVerts(cells[0]);
+    pd->SetLines(cells[1]);
+    pd->SetPolys(cells[2]);
+    pd->SetStrips(cells[3]);
+  }
+  else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(object))
+  {
+    ug->SetPoints(points);
+    vtkUnsignedCharArray* types =
+      vtkArrayDownCast<vtkUnsignedCharArray>(this->GetArray(this->CellTypes));
+    vtkSmartPointer<vtkCellArray> cells = makeCells(0);
+    if (!cells)
+    {
+      return false;
+    }
+    if (types)
+    {
+      vtkIdTypeArray* faceLocations =
+        vtkArrayDownCast<vtkIdTypeArray>(this->GetArray(this->FaceLocations));
+      vtkIdTypeArray* faces = vtkArrayDownCast<vtkIdTypeArray>(this->GetArray(this->Faces));
+      if (faceLocations && faces)
+      {
+        ug->SetCells(types, cells, faceLocations, faces);
+      }
+      else
+      {
+        ug->SetCells(types, cells);
+      }
+    }
+  }
+  else if (vtkImageData* id = vtkImageData::SafeDownCast(object))
+  {
+    id->SetExtent(this->Extent);
+    id->SetOrigin(this->Origin);
+    id->SetSpacing(this->Spacing);
+    id->SetDirectionMatrix(this->Direction);
+  }
+  else if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(object))
+  {
+    rg->SetExtent(this->Extent);
+    rg->SetXCoordinates(this->GetArray(this->Coordinates[0]));
+    rg->SetYCoordinates(this->GetArray(this->Coordinates[1]));
+    rg->SetZCoordinates(this->GetArray(this->Coordinates[2]));
+  }
+  else if (vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(object))
+  {
+    sg->SetExtent(this->Extent);
+    sg->SetPoints(points);
+  }
+  else if (vtkTable* table = vtkTable::SafeDownCast(object))
+  {
+    return this->AssembleField(this->Fields[0], table->GetRowData()) &&
+      this->AssembleField(this->Fields[2], table->GetFieldData());
+  }
+  else
+  {
+    return false;
+  }
+
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(object))
+  {
+    if (!this->AssembleField(this->Fields[0], ds->GetPointData()) ||
+      !this->AssembleField(this->Fields[1], ds->GetCellData()))
+    {
+      return false;
+    }
+  }
+  return this->AssembleField(this->Fields[2], object->GetFieldData());
+}
+}
+
 //=============================================================================
 vtkCommunicator::vtkCommunicator()
 {
@@ -212,6 +750,35 @@ int vtkCommunicator::Send(vtkDataObject* data, int remoteHandle, int tag)
 //------------------------------------------------------------------------------
 int vtkCommunicator::SendElementalDataObject(vtkDataObject* data, int remoteHandle, int tag)
 {
+  vtkBinaryDataObjectSchema schema;
+  int format = schema.Initialize(data) ? BINARY_FORMAT : LEGACY_FORMAT;
+  if (!this->Send(&format, 1, remoteHandle, tag))
+  {
+    return 0;
+  }
+
+  if (format == BINARY_FORMAT)
+  {
+    // Send the schema, then every array buffer directly from its storage.
+    vtkMultiProcessStream stream;
+    schema.Serialize(stream);
+    if (!this->Send(stream, remoteHandle, tag))
+    {
+      return 0;
+    }
+    for (const auto& array : schema.Arrays)
+    {
+      const vtkIdType size = array->GetNumberOfValues();
+      if (size > 0 &&
+        !this->SendVoidArray(
+          array->GetVoidPointer(0), size, array->GetDataType(), remoteHandle, tag))
+      {
+        return 0;
+      }
+    }
+    return 1;
+  }
+
   VTK_CREATE(vtkCharArray, buffer);
   if (vtkCommunicator::MarshalDataObject(data, buffer))
   {
@@ -407,6 +974,41 @@ int vtkCommunicator::ReceiveDataObject(vtkDataObject* data, int remoteHandle, in
 //------------------------------------------------------------------------------
 int vtkCommunicator::ReceiveElementalDataObject(vtkDataObject* data, int remoteHandle, int tag)
 {
+  int format = LEGACY_FORMAT;
+  if (!this->Receive(&format, 1, remoteHandle, tag))
+  {
+    return 0;
+  }
+
+  if (format == BINARY_FORMAT)
+  {
+    // Receive the schema, then every array buffer directly into the arrays
+    // the received data object will reference.
+    vtkMultiProcessStream stream;
+    vtkBinaryDataObjectSchema schema;
+    if (!this->Receive(stream, remoteHandle, tag) || !schema.Deserialize(stream))
+    {
+      vtkErrorMacro("Could not receive data object schema.");
+      return 0;
+    }
+    for (const auto& array : schema.Arrays)
+    {
+      const vtkIdType size = array->GetNumberOfValues();
+      if (size > 0 &&
+        !this->ReceiveVoidArray(
+          array->GetVoidPointer(0), size, array->GetDataType(), remoteHandle, tag))
+      {
+        return 0;
+      }
+    }
+    if (!schema.Assemble(data))
+    {
+      vtkErrorMacro("Could not assemble received " << data->GetClassName() << ".");
+      return 0;
+    }
+    return 1;
+  }
+
   VTK_CREATE(vtkCharArray, buffer);
   if (!this->Receive(buffer, remoteHandle, tag))
   {
@@ -516,6 +1118,49 @@ int vtkCommunicator::MarshalDataObject(vtkDataObject* object, vtkCharArray* buff
     return 1;
   }
 
+  vtkBinaryDataObjectSchema schema;
+  if (schema.Initialize(object))
+  {
+    vtkMultiProcessStream stream;
+    schema.Serialize(stream);
+    std::vector<unsigned char> header;
+    stream.GetRawData(header);
+
+    // Layout: magic, schema length, schema, then each array buffer starting on
+    // an aligned offset.
+    vtkIdType size = vtkCommunicatorAlign(
+      BINARY_MARSHAL_PREAMBLE_SIZE + static_cast<vtkIdType>(header.size()));
+    for (const auto& array : schema.Arrays)
+    {
+      size = vtkCommunicatorAlign(size + array->GetNumberOfValues() * array->GetDataTypeSize());
+    }
+    buffer->SetNumberOfTuples(size);
+    char* ptr = buffer->GetPointer(0);
+
+    memcpy(ptr, BINARY_MARSHAL_MAGIC, sizeof(BINARY_MARSHAL_MAGIC));
+    vtkTypeUInt64 headerSize = static_cast<vtkTypeUInt64>(header.size());
+    for (int cc = 0; cc < 8; ++cc)
+    {
+      ptr[sizeof(BINARY_MARSHAL_MAGIC) + cc] = static_cast<char>((headerSize >> (8 * cc)) & 0xff);
+    }
+    memcpy(ptr + BINARY_MARSHAL_PREAMBLE_SIZE, header.data(), header.size());
+
+    vtkIdType offset = BINARY_MARSHAL_PREAMBLE_SIZE + static_cast<vtkIdType>(header.size());
+    for (const auto& array : schema.Arrays)
+    {
+      const vtkIdType aligned = vtkCommunicatorAlign(offset);
+      memset(ptr + offset, 0, aligned - offset);
+      const vtkIdType numBytes = array->GetNumberOfValues() * array->GetDataTypeSize();
+      if (numBytes > 0)
+      {
+        memcpy(ptr + aligned, array->GetVoidPointer(0), numBytes);
+      }
+      offset = aligned + numBytes;
+    }
+    memset(ptr + offset, 0, size - offset);
+    return 1;
+  }
+
   VTK_CREATE(vtkGenericDataObjectWriter, writer);
 
   vtkSmartPointer<vtkDataObject> copy;
@@ -611,6 +1256,63 @@ vtkSmartPointer<vtkDataObject> vtkCommunicator::UnMarshalDataObject(vtkCharArray
     return nullptr;
   }
 
+  if (bufferSize >= BINARY_MARSHAL_PREAMBLE_SIZE &&
+    memcmp(buffer->GetPointer(0), BINARY_MARSHAL_MAGIC, sizeof(BINARY_MARSHAL_MAGIC)) == 0)
+  {
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(buffer->GetPointer(0));
+    vtkTypeUInt64 headerSize = 0;
+    for (int cc = 0; cc < 8; ++cc)
+    {
+      headerSize |= static_cast<vtkTypeUInt64>(ptr[sizeof(BINARY_MARSHAL_MAGIC) + cc]) << (8 * cc);
+    }
+    if (headerSize > static_cast<vtkTypeUInt64>(bufferSize - BINARY_MARSHAL_PREAMBLE_SIZE))
+    {
+      vtkGenericWarningMacro("Corrupt marshalled data object.");
+      return nullptr;
+    }
+
+    vtkMultiProcessStream stream;
+    stream.SetRawData(
+      ptr + BINARY_MARSHAL_PREAMBLE_SIZE, static_cast<unsigned int>(headerSize));
+    vtkBinaryDataObjectSchema schema;
+    if (!schema.Deserialize(stream))
+    {
+      vtkGenericWarningMacro("Unsupported marshalled data object schema.");
+      return nullptr;
+    }
+
+    vtkIdType offset = BINARY_MARSHAL_PREAMBLE_SIZE + static_cast<vtkIdType>(headerSize);
+    for (const auto& array : schema.Arrays)
+    {
+      offset = vtkCommunicatorAlign(offset);
+      const vtkIdType numValues = array->GetNumberOfValues();
+      const vtkIdType numBytes = numValues * array->GetDataTypeSize();
+      if (offset + numBytes > bufferSize)
+      {
+        vtkGenericWarningMacro("Corrupt marshalled data object.");
+        return nullptr;
+      }
+      if (numBytes > 0)
+      {
+        memcpy(array->GetVoidPointer(0), ptr + offset, numBytes);
+        if (schema.NeedsByteSwap() && array->GetDataTypeSize() > 1)
+        {
+          vtkByteSwap::SwapVoidRange(array->GetVoidPointer(0), numValues, array->GetDataTypeSize());
+        }
+      }
+      offset += numBytes;
+    }
+
+    vtkSmartPointer<vtkDataObject> dobj;
+    dobj.TakeReference(vtkDataObjectTypes::NewDataObject(schema.GetDataObjectType()));
+    if (!dobj || !schema.Assemble(dobj))
+    {
+      vtkGenericWarningMacro("Could not unmarshal data object.");
+      return nullptr;
+    }
+    return dobj;
+  }
+
   // You would think that the extent information would be properly saved, but
   // no, it is not.
   int extent[6] = { 0, 0, 0, 0, 0, 0 };
@@ -1659,6 +2361,95 @@ int vtkCommunicator::AllReduceVoidArray(
   return 0;
 }
 
+//------------------------------------------------------------------------------
+bool vtkCommunicator::CollectiveRequest::Test()
+{
+  if (this->Impl && this->Impl->Test())
+  {
+    this->Impl = nullptr;
+  }
+  return this->Impl == nullptr;
+}
+
+//------------------------------------------------------------------------------
+void vtkCommunicator::CollectiveRequest::Wait()
+{
+  if (this->Impl)
+  {
+    this->Impl->Wait();
+    this->Impl = nullptr;
+  }
+}
+
+//------------------------------------------------------------------------------
+// The default non-blocking collectives complete the operation before
+// returning.
+int vtkCommunicator::NoBlockBarrier(CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  this->Barrier();
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkCommunicator::NoBlockBroadcastVoidArray(
+  void* data, vtkIdType length, int type, int srcProcessId, CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  return this->BroadcastVoidArray(data, length, type, srcProcessId);
+}
+
+//------------------------------------------------------------------------------
+int vtkCommunicator::NoBlockGatherVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType length, int type, int destProcessId, CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  return this->GatherVoidArray(sendBuffer, recvBuffer, length, type, destProcessId);
+}
+
+//------------------------------------------------------------------------------
+int vtkCommunicator::NoBlockGatherVVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType sendLength, vtkIdType* recvLengths, vtkIdType* offsets, int type, int destProcessId,
+  CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  return this->GatherVVoidArray(
+    sendBuffer, recvBuffer, sendLength, recvLengths, offsets, type, destProcessId);
+}
+
+//------------------------------------------------------------------------------
+int vtkCommunicator::NoBlockAllGatherVoidArray(
+  const void* sendBuffer, void* recvBuffer, vtkIdType length, int type, CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  return this->AllGatherVoidArray(sendBuffer, recvBuffer, length, type);
+}
+
+//------------------------------------------------------------------------------
+int vtkCommunicator::NoBlockAllGatherVVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType sendLength, vtkIdType* recvLengths, vtkIdType* offsets, int type,
+  CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  return this->AllGatherVVoidArray(sendBuffer, recvBuffer, sendLength, recvLengths, offsets, type);
+}
+
+//------------------------------------------------------------------------------
+int vtkCommunicator::NoBlockReduceVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType length, int type, int operation, int destProcessId, CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  return this->ReduceVoidArray(sendBuffer, recvBuffer, length, type, operation, destProcessId);
+}
+
+//------------------------------------------------------------------------------
+int vtkCommunicator::NoBlockAllReduceVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType length, int type, int operation, CollectiveRequest& req)
+{
+  req.SetImplementation(nullptr);
+  return this->AllReduceVoidArray(sendBuffer, recvBuffer, length, type, operation);
+}
+
 //------------------------------------------------------------------------------
 int vtkCommunicator::AllReduce(vtkDataArray* sendBuffer, vtkDataArray* recvBuffer, int operation)
 {
@@ -35,6 +35,8 @@
 #include "vtkObject.h"
 #include "vtkParallelCoreModule.h" // For export macro
 #include "vtkSmartPointer.h"       // needed for vtkSmartPointer.
+#include "vtkTypeTraits.h"         // needed for vtkTypeTraits
+#include <memory>                  // needed for std::shared_ptr
 #include <vector>                  // needed for std::vector
 
 class vtkBoundingBox;
@@ -128,6 +130,9 @@ public:
    * This method sends a data object to a destination.
    * Tag eliminates ambiguity
    * and is used to match sends to receives.
+   * Data objects supported by the binary format (see MarshalDataObject) are
+   * sent as a schema followed by one message per array, straight from the
+   * array memory; the receiver fills its arrays in place.
    */
   int Send(vtkDataObject* data, int remoteHandle, int tag);
 
@@ -1220,6 +1225,111 @@ public:
   int AllReduce(vtkDataArray* sendBuffer, vtkDataArray* recvBuffer, Operation* operation);
   ///@}
 
+  //---------------------- Non-Blocking Collective Operations ----------------------
+
+  /**
+   * Handle on a collective operation started with one of the NoBlock methods.
+   * The buffers passed to the operation must not be accessed until Test()
+   * returned true or Wait() returned. Copies of a request share the same
+   * operation. A request that was never started is complete.
+   */
+  class VTKPARALLELCORE_EXPORT CollectiveRequest
+  {
+  public:
+    /**
+     * Communicator specific state of a pending operation.
+     */
+    class Implementation
+    {
+    public:
+      virtual ~Implementation() = default;
+      virtual bool Test() = 0;
+      virtual void Wait() = 0;
+    };
+
+    /**
+     * Returns true if the operation has completed. Does not block.
+     */
+    bool Test();
+
+    /**
+     * Blocks until the operation has completed.
+     */
+    void Wait();
+
+    /**
+     * Used by communicators to attach the state of the pending operation.
+     * Passing nullptr marks the request as complete.
+     */
+    void SetImplementation(std::shared_ptr<Implementation> impl) { this->Impl = std::move(impl); }
+
+  private:
+    std::shared_ptr<Implementation> Impl;
+  };
+
+  ///@{
+  /**
+   * Non-blocking variants of the collective operations above. They take the
+   * same arguments plus a request that is used to test for or wait on the
+   * completion of the operation, which makes it possible to overlap the
+   * communication with local computation. All processes must start the same
+   * collective operations in the same order.
+   *
+   * vtkMPICommunicator maps them on the MPI-3 non-blocking collectives. The
+   * default implementation performs the blocking operation and returns a
+   * completed request.
+   */
+  template <typename T>
+  int NoBlockBroadcast(T* data, vtkIdType length, int srcProcessId, CollectiveRequest& req)
+  {
+    return this->NoBlockBroadcastVoidArray(
+      data, length, vtkTypeTraits<T>::VTKTypeID(), srcProcessId, req);
+  }
+  template <typename T>
+  int NoBlockGather(const T* sendBuffer, T* recvBuffer, vtkIdType length, int destProcessId,
+    CollectiveRequest& req)
+  {
+    return this->NoBlockGatherVoidArray(
+      sendBuffer, recvBuffer, length, vtkTypeTraits<T>::VTKTypeID(), destProcessId, req);
+  }
+  template <typename T>
+  int NoBlockGatherV(const T* sendBuffer, T* recvBuffer, vtkIdType sendLength,
+    vtkIdType* recvLengths, vtkIdType* offsets, int destProcessId, CollectiveRequest& req)
+  {
+    return this->NoBlockGatherVVoidArray(sendBuffer, recvBuffer, sendLength, recvLengths, offsets,
+      vtkTypeTraits<T>::VTKTypeID(), destProcessId, req);
+  }
+  template <typename T>
+  int NoBlockAllGather(
+    const T* sendBuffer, T* recvBuffer, vtkIdType length, CollectiveRequest& req)
+  {
+    return this->NoBlockAllGatherVoidArray(
+      sendBuffer, recvBuffer, length, vtkTypeTraits<T>::VTKTypeID(), req);
+  }
+  template <typename T>
+  int NoBlockAllGatherV(const T* sendBuffer, T* recvBuffer, vtkIdType sendLength,
+    vtkIdType* recvLengths, vtkIdType* offsets, CollectiveRequest& req)
+  {
+    return this->NoBlockAllGatherVVoidArray(sendBuffer, recvBuffer, sendLength, recvLengths,
+      offsets, vtkTypeTraits<T>::VTKTypeID(), req);
+  }
+  template <typename T>
+  int NoBlockReduce(const T* sendBuffer, T* recvBuffer, vtkIdType length, int operation,
+    int destProcessId, CollectiveRequest& req)
+  {
+    return this->NoBlockReduceVoidArray(sendBuffer, recvBuffer, length,
+      vtkTypeTraits<T>::VTKTypeID(), operation, destProcessId, req);
+  }
+  template <typename T>
+  int NoBlockAllReduce(
+    const T* sendBuffer, T* recvBuffer, vtkIdType length, int operation, CollectiveRequest& req)
+  {
+    return this->NoBlockAllReduceVoidArray(
+      sendBuffer, recvBuffer, length, vtkTypeTraits<T>::VTKTypeID(), operation, req);
+  }
+  virtual int NoBlockBarrier(CollectiveRequest& req);
+  ///@}
+
   ///@{
   /**
    * Subclasses should reimplement these if they have a more efficient
@@ -1248,6 +1358,29 @@ public:
     const void* sendBuffer, void* recvBuffer, vtkIdType length, int type, Operation* operation);
   ///@}
 
+  ///@{
+  /**
+   * Non-blocking counterparts of the methods above. Subclasses with native
+   * support for non-blocking collectives should reimplement these.
+   */
+  virtual int NoBlockBroadcastVoidArray(
+    void* data, vtkIdType length, int type, int srcProcessId, CollectiveRequest& req);
+  virtual int NoBlockGatherVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType length,
+    int type, int destProcessId, CollectiveRequest& req);
+  virtual int NoBlockGatherVVoidArray(const void* sendBuffer, void* recvBuffer,
+    vtkIdType sendLength, vtkIdType* recvLengths, vtkIdType* offsets, int type, int destProcessId,
+    CollectiveRequest& req);
+  virtual int NoBlockAllGatherVoidArray(const void* sendBuffer, void* recvBuffer,
+    vtkIdType length, int type, CollectiveRequest& req);
+  virtual int NoBlockAllGatherVVoidArray(const void* sendBuffer, void* recvBuffer,
+    vtkIdType sendLength, vtkIdType* recvLengths, vtkIdType* offsets, int type,
+    CollectiveRequest& req);
+  virtual int NoBlockReduceVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType length,
+    int type, int operation, int destProcessId, CollectiveRequest& req);
+  virtual int NoBlockAllReduceVoidArray(const void* sendBuffer, void* recvBuffer,
+    vtkIdType length, int type, int operation, CollectiveRequest& req);
+  ///@}
+
   static void SetUseCopy(int useCopy);
 
   /**
@@ -1279,6 +1412,13 @@ public:
   /**
    * Convert a data object into a string that can be transmitted and vice versa.
    * Returns 1 for success and 0 for failure.
+   *
+   * vtkPolyData, vtkUnstructuredGrid, vtkImageData, vtkRectilinearGrid,
+   * vtkStructuredGrid and vtkTable instances whose arrays are all
+   * vtkDataArray subclasses are marshalled in a binary format: a small
+   * schema describing the structure and the arrays followed by the raw,
+   * aligned array buffers. Other data objects fall back to the legacy VTK
+   * file format.
    * WARNING: This will only work for types that have a vtkDataWriter class.
    */
   static int MarshalDataObject(vtkDataObject* object, vtkCharArray* buffer);
@@ -1409,6 +1409,63 @@ public:
   int AllReduce(vtkDataArraySelection* sendBuffer, vtkDataArraySelection* recvBuffer);
   ///@}
 
+  //----------------- Non-Blocking Collective Operations -----------------
+
+  using CollectiveRequest = vtkCommunicator::CollectiveRequest;
+
+  ///@{
+  /**
+   * Non-blocking collective operations. The request can be used to test for
+   * or wait on the completion of the operation; the buffers must not be
+   * accessed before that. See vtkCommunicator for details.
+   */
+  template <typename T>
+  int NoBlockBroadcast(T* data, vtkIdType length, int srcProcessId, CollectiveRequest& req)
+  {
+    return this->Communicator->NoBlockBroadcast(data, length, srcProcessId, req);
+  }
+  template <typename T>
+  int NoBlockGather(const T* sendBuffer, T* recvBuffer, vtkIdType length, int destProcessId,
+    CollectiveRequest& req)
+  {
+    return this->Communicator->NoBlockGather(sendBuffer, recvBuffer, length, destProcessId, req);
+  }
+  template <typename T>
+  int NoBlockGatherV(const T* sendBuffer, T* recvBuffer, vtkIdType sendLength,
+    vtkIdType* recvLengths, vtkIdType* offsets, int destProcessId, CollectiveRequest& req)
+  {
+    return this->Communicator->NoBlockGatherV(
+      sendBuffer, recvBuffer, sendLength, recvLengths, offsets, destProcessId, req);
+  }
+  template <typename T>
+  int NoBlockAllGather(
+    const T* sendBuffer, T* recvBuffer, vtkIdType length, CollectiveRequest& req)
+  {
+    return this->Communicator->NoBlockAllGather(sendBuffer, recvBuffer, length, req);
+  }
+  template <typename T>
+  int NoBlockAllGatherV(const T* sendBuffer, T* recvBuffer, vtkIdType sendLength,
+    vtkIdType* recvLengths, vtkIdType* offsets, CollectiveRequest& req)
+  {
+    return this->Communicator->NoBlockAllGatherV(
+      sendBuffer, recvBuffer, sendLength, recvLengths, offsets, req);
+  }
+  template <typename T>
+  int NoBlockReduce(const T* sendBuffer, T* recvBuffer, vtkIdType length, int operation,
+    int destProcessId, CollectiveRequest& req)
+  {
+    return this->Communicator->NoBlockReduce(
+      sendBuffer, recvBuffer, length, operation, destProcessId, req);
+  }
+  template <typename T>
+  int NoBlockAllReduce(
+    const T* sendBuffer, T* recvBuffer, vtkIdType length, int operation, CollectiveRequest& req)
+  {
+    return this->Communicator->NoBlockAllReduce(sendBuffer, recvBuffer, length, operation, req);
+  }
+  int NoBlockBarrier(CollectiveRequest& req) { return this->Communicator->NoBlockBarrier(req); }
+  ///@}
+
   // Internally implemented RMI to break the process loop.
 
 protected:
@@ -0,0 +1,616 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSharedMemoryCommunicator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSharedMemoryCommunicator.h"
+
+#include "vtkAbstractArray.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+
+namespace
+{
+const vtkTypeUInt64 SHM_ALIGNMENT = 64;
+
+vtkTypeUInt64 vtkSharedMemoryAlign(vtkTypeUInt64 size)
+{
+  return (size + SHM_ALIGNMENT - 1) / SHM_ALIGNMENT * SHM_ALIGNMENT;
+}
+
+// Layout of the shared region:
+//   RegionHeader | Mailbox[N] | Channel[N * N] | ring data[N * N]
+// Mailbox `i` guards every channel whose destination is `i`.
+struct RegionHeader
+{
+  int NumberOfProcesses;
+  vtkTypeUInt64 ChannelBufferSize;
+};
+
+struct Mailbox
+{
+  pthread_mutex_t Mutex;
+  pthread_cond_t DataAvailable;
+  pthread_cond_t SpaceAvailable;
+};
+
+struct Channel
+{
+  // Total number of bytes written to / read from the ring since allocation.
+  vtkTypeUInt64 Written;
+  vtkTypeUInt64 Read;
+};
+
+// Every message starts with this header in the ring.
+struct MessageHeader
+{
+  int Tag;
+  int Type;
+  vtkTypeUInt64 NumberOfBytes;
+};
+
+// A message received (or being received) into private memory because no
+// matching receive was posted.
+struct QueuedMessage
+{
+  int Source;
+  int Tag;
+  std::vector<unsigned char> Data;
+};
+
+// The receive currently posted by this process, if any.
+struct PostedReceive
+{
+  int Source;
+  int Tag;
+  unsigned char* Buffer;
+  vtkTypeUInt64 Capacity;
+  vtkTypeUInt64 Received;
+  // The posted receive is bound to the message arriving from `Source`.
+  bool Assigned;
+  // A matching message too large for `Buffer` is being queued; it will be
+  // taken, truncated, from the queue so that message order is preserved.
+  bool Oversized;
+  bool Done;
+};
+
+// State of the message currently arriving on one incoming channel.
+struct IncomingMessage
+{
+  bool Active = false;
+  MessageHeader Header;
+  vtkTypeUInt64 Received = 0;
+  // Either the posted receive buffer or `Queued`.
+  unsigned char* Target = nullptr;
+  bool Direct = false;
+  QueuedMessage Queued;
+};
+}
+
+//------------------------------------------------------------------------------
+class vtkSharedMemoryCommunicator::vtkInternals
+{
+public:
+  void* Region = nullptr;
+  size_t RegionSize = 0;
+  RegionHeader* Header = nullptr;
+  Mailbox* Mailboxes = nullptr;
+  Channel* Channels = nullptr;
+  unsigned char* RingData = nullptr;
+  int Rank = 0;
+  int NumberOfProcesses = 1;
+  vtkTypeUInt64 ChannelBufferSize = 0;
+
+  std::vector<IncomingMessage> Incoming;
+  std::deque<QueuedMessage> Unexpected;
+
+  Channel& GetChannel(int source, int destination)
+  {
+    return this->Channels[source * this->NumberOfProcesses + destination];
+  }
+
+  unsigned char* GetRing(int source, int destination)
+  {
+    return this->RingData +
+      (source * this->NumberOfProcesses + destination) * this->ChannelBufferSize;
+  }
+
+  bool Map(int numberOfProcesses, vtkTypeUInt64 channelBufferSize);
+  void Unmap();
+
+  // Copy up to `size` bytes into the ring of `channel`. Returns the number
+  // of bytes written. The destination mailbox must be locked.
+  vtkTypeUInt64 WriteRing(int destination, const unsigned char* data, vtkTypeUInt64 size);
+
+  // Copy up to `size` bytes out of the ring coming from `source`. The local
+  // mailbox must be locked.
+  vtkTypeUInt64 ReadRing(int source, unsigned char* data, vtkTypeUInt64 size);
+
+  // Consume whatever is available on the ring coming from `source`, matching
+  // the header of a new message against `posted`. The local mailbox must be
+  // locked. Returns true if any byte was consumed.
+  bool Drain(int source, PostedReceive* posted);
+
+  // Drain every incoming ring. Locks the local mailbox.
+  void Progress();
+
+  // Look for a complete queued message matching `posted` and copy it out.
+  bool TakeQueued(PostedReceive& posted);
+};
+
+//------------------------------------------------------------------------------
+bool vtkSharedMemoryCommunicator::vtkInternals::Map(
+  int numberOfProcesses, vtkTypeUInt64 channelBufferSize)
+{
+  const vtkTypeUInt64 n = static_cast<vtkTypeUInt64>(numberOfProcesses);
+  const vtkTypeUInt64 bufferSize = vtkSharedMemoryAlign(std::max<vtkTypeUInt64>(
+    channelBufferSize, vtkSharedMemoryAlign(sizeof(MessageHeader))));
+  const vtkTypeUInt64 mailboxOffset = vtkSharedMemoryAlign(sizeof(RegionHeader));
+  const vtkTypeUInt64 channelOffset = mailboxOffset + vtkSharedMemoryAlign(n * sizeof(Mailbox));
+  const vtkTypeUInt64 dataOffset = channelOffset + vtkSharedMemoryAlign(n * n * sizeof(Channel));
+  const vtkTypeUInt64 regionSize = dataOffset + n * n * bufferSize;
+
+  int flags = MAP_SHARED | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+  flags |= MAP_NORESERVE;
+#endif
+  void* region = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (region == MAP_FAILED)
+  {
+    return false;
+  }
+
+  this->Region = region;
+  this->RegionSize = static_cast<size_t>(regionSize);
+  unsigned char* base = static_cast<unsigned char*>(region);
+  this->Header = reinterpret_cast<RegionHeader*>(base);
+  this->Mailboxes = reinterpret_cast<Mailbox*>(base + mailboxOffset);
+  this->Channels = reinterpret_cast<Channel*>(base + channelOffset);
+  this->RingData = base + dataOffset;
+  this->NumberOfProcesses = numberOfProcesses;
+  this->ChannelBufferSize = bufferSize;
+  this->Header->NumberOfProcesses = numberOfProcesses;
+  this->Header->ChannelBufferSize = bufferSize;
+
+  pthread_mutexattr_t mutexAttr;
+  pthread_mutexattr_init(&mutexAttr);
+  pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+  pthread_condattr_t condAttr;
+  pthread_condattr_init(&condAttr);
+  pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+  for (int cc = 0; cc < numberOfProcesses; ++cc)
+  {
+    pthread_mutex_init(&this->Mailboxes[cc].Mutex, &mutexAttr);
+    pthread_cond_init(&this->Mailboxes[cc].DataAvailable, &condAttr);
+    pthread_cond_init(&this->Mailboxes[cc].SpaceAvailable, &condAttr);
+  }
+  pthread_condattr_destroy(&condAttr);
+  pthread_mutexattr_destroy(&mutexAttr);
+
+  for (vtkTypeUInt64 cc = 0; cc < n * n; ++cc)
+  {
+    this->Channels[cc].Written = 0;
+    this->Channels[cc].Read = 0;
+  }
+  this->Incoming.assign(numberOfProcesses, IncomingMessage());
+  this->Unexpected.clear();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryCommunicator::vtkInternals::Unmap()
+{
+  if (this->Region)
+  {
+    munmap(this->Region, this->RegionSize);
+  }
+  this->Region = nullptr;
+  this->RegionSize = 0;
+  this->Header = nullptr;
+  this->Mailboxes = nullptr;
+  this->Channels = nullptr;
+  this->RingData = nullptr;
+  this->Incoming.clear();
+  this->Unexpected.clear();
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkSharedMemoryCommunicator::vtkInternals::WriteRing(
+  int destination, const unsigned char* data, vtkTypeUInt64 size)
+{
+  Channel& channel = this->GetChannel(this->Rank, destination);
+  unsigned char* ring = this->GetRing(this->Rank, destination);
+  const vtkTypeUInt64 capacity = this->ChannelBufferSize;
+  const vtkTypeUInt64 count = std::min(size, capacity - (channel.Written - channel.Read));
+  if (count == 0)
+  {
+    return 0;
+  }
+  const vtkTypeUInt64 start = channel.Written % capacity;
+  const vtkTypeUInt64 first = std::min(count, capacity - start);
+  memcpy(ring + start, data, first);
+  memcpy(ring, data + first, count - first);
+  channel.Written += count;
+  return count;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkSharedMemoryCommunicator::vtkInternals::ReadRing(
+  int source, unsigned char* data, vtkTypeUInt64 size)
+{
+  Channel& channel = this->GetChannel(source, this->Rank);
+  const unsigned char* ring = this->GetRing(source, this->Rank);
+  const vtkTypeUInt64 capacity = this->ChannelBufferSize;
+  const vtkTypeUInt64 count = std::min(size, channel.Written - channel.Read);
+  if (count == 0)
+  {
+    return 0;
+  }
+  const vtkTypeUInt64 start = channel.Read % capacity;
+  const vtkTypeUInt64 first = std::min(count, capacity - start);
+  memcpy(data, ring + start, first);
+  memcpy(data + first, ring, count - first);
+  channel.Read += count;
+  return count;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSharedMemoryCommunicator::vtkInternals::Drain(int source, PostedReceive* posted)
+{
+  Channel& channel = this->GetChannel(source, this->Rank);
+  IncomingMessage& incoming = this->Incoming[source];
+  bool progress = false;
+  while (channel.Written > channel.Read)
+  {
+    if (!incoming.Active)
+    {
+      // The sender writes the header as a unit; wait until it is complete.
+      if (channel.Written - channel.Read < sizeof(MessageHeader))
+      {
+        break;
+      }
+      this->ReadRing(source, reinterpret_cast<unsigned char*>(&incoming.Header),
+        sizeof(MessageHeader));
+      incoming.Active = true;
+      incoming.Received = 0;
+      const bool matches = posted && !posted->Assigned && !posted->Oversized && !posted->Done &&
+        (posted->Source == vtkMultiProcessController::ANY_SOURCE || posted->Source == source) &&
+        posted->Tag == incoming.Header.Tag;
+      if (matches && incoming.Header.NumberOfBytes > posted->Capacity)
+      {
+        posted->Oversized = true;
+      }
+      if (matches && !posted->Oversized)
+      {
+        posted->Assigned = true;
+        posted->Source = source;
+        incoming.Direct = true;
+        incoming.Target = posted->Buffer;
+      }
+      else
+      {
+        incoming.Direct = false;
+        incoming.Queued.Source = source;
+        incoming.Queued.Tag = incoming.Header.Tag;
+        incoming.Queued.Data.resize(static_cast<size_t>(incoming.Header.NumberOfBytes));
+        incoming.Target = incoming.Queued.Data.data();
+      }
+      progress = true;
+    }
+
+    const vtkTypeUInt64 remaining = incoming.Header.NumberOfBytes - incoming.Received;
+    const vtkTypeUInt64 count = this->ReadRing(source, incoming.Target + incoming.Received, remaining);
+    incoming.Received += count;
+    progress = progress || count > 0;
+    if (incoming.Received < incoming.Header.NumberOfBytes)
+    {
+      break;
+    }
+
+    // Message complete.
+    incoming.Active = false;
+    if (incoming.Direct)
+    {
+      posted->Received = incoming.Received;
+      posted->Done = true;
+    }
+    else
+    {
+      this->Unexpected.push_back(std::move(incoming.Queued));
+      incoming.Queued = QueuedMessage();
+    }
+    incoming.Target = nullptr;
+  }
+  return progress;
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryCommunicator::vtkInternals::Progress()
+{
+  Mailbox& mailbox = this->Mailboxes[this->Rank];
+  pthread_mutex_lock(&mailbox.Mutex);
+  bool progress = false;
+  for (int source = 0; source < this->NumberOfProcesses; ++source)
+  {
+    if (source != this->Rank)
+    {
+      progress = this->Drain(source, nullptr) || progress;
+    }
+  }
+  if (progress)
+  {
+    pthread_cond_broadcast(&mailbox.SpaceAvailable);
+  }
+  pthread_mutex_unlock(&mailbox.Mutex);
+}
+
+//------------------------------------------------------------------------------
+bool vtkSharedMemoryCommunicator::vtkInternals::TakeQueued(PostedReceive& posted)
+{
+  for (auto iter = this->Unexpected.begin(); iter != this->Unexpected.end(); ++iter)
+  {
+    if ((posted.Source == vtkMultiProcessController::ANY_SOURCE ||
+          posted.Source == iter->Source) &&
+      posted.Tag == iter->Tag)
+    {
+      const vtkTypeUInt64 size = static_cast<vtkTypeUInt64>(iter->Data.size());
+      if (size > posted.Capacity)
+      {
+        vtkGenericWarningMacro("Message of " << size << " bytes truncated to " << posted.Capacity
+                                             << " bytes.");
+      }
+      posted.Received = std::min(size, posted.Capacity);
+      memcpy(posted.Buffer, iter->Data.data(), static_cast<size_t>(posted.Received));
+      posted.Source = iter->Source;
+      posted.Done = true;
+      this->Unexpected.erase(iter);
+      return true;
+    }
+  }
+  return false;
+}
+
+//==============================================================================
+vtkStandardNewMacro(vtkSharedMemoryCommunicator);
+
+//------------------------------------------------------------------------------
+vtkSharedMemoryCommunicator::vtkSharedMemoryCommunicator()
+  : Internals(new vtkInternals())
+{
+}
+
+//------------------------------------------------------------------------------
+vtkSharedMemoryCommunicator::~vtkSharedMemoryCommunicator()
+{
+  this->Release();
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryCommunicator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Allocated: " << this->IsAllocated() << endl;
+  os << indent << "ChannelBufferSize: " << this->GetChannelBufferSize() << endl;
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryCommunicator::SetNumberOfProcesses(int num)
+{
+  if (this->IsAllocated() && num != this->NumberOfProcesses)
+  {
+    vtkErrorMacro("Cannot change the number of processes once the shared region is allocated.");
+    return;
+  }
+  this->Superclass::SetNumberOfProcesses(num);
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkSharedMemoryCommunicator::GetChannelBufferSize() const
+{
+  return this->Internals->ChannelBufferSize;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSharedMemoryCommunicator::IsAllocated() const
+{
+  return this->Internals->Region != nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSharedMemoryCommunicator::Allocate(vtkTypeUInt64 channelBufferSize)
+{
+  this->Release();
+  if (!this->Internals->Map(this->NumberOfProcesses, channelBufferSize))
+  {
+    vtkErrorMacro("Could not map shared memory region: " << strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryCommunicator::SetLocalProcessId(int id)
+{
+  this->LocalProcessId = id;
+  this->Internals->Rank = id;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryCommunicator::Release()
+{
+  this->Internals->Unmap();
+}
+
+//------------------------------------------------------------------------------
+int vtkSharedMemoryCommunicator::SendVoidArray(
+  const void* data, vtkIdType length, int type, int remoteProcessId, int tag)
+{
+  vtkInternals& internals = *this->Internals;
+  if (!this->IsAllocated())
+  {
+    vtkErrorMacro("Shared region is not allocated.");
+    return 0;
+  }
+  if (remoteProcessId < 0 || remoteProcessId >= internals.NumberOfProcesses)
+  {
+    vtkErrorMacro("Invalid destination " << remoteProcessId << ".");
+    return 0;
+  }
+
+  MessageHeader header;
+  header.Tag = tag;
+  header.Type = type;
+  header.NumberOfBytes =
+    static_cast<vtkTypeUInt64>(length) * vtkAbstractArray::GetDataTypeSize(type);
+  const unsigned char* payload = static_cast<const unsigned char*>(data);
+
+  if (remoteProcessId == internals.Rank)
+  {
+    QueuedMessage message;
+    message.Source = internals.Rank;
+    message.Tag = tag;
+    message.Data.assign(payload, payload + header.NumberOfBytes);
+    internals.Unexpected.push_back(std::move(message));
+    return 1;
+  }
+
+  Mailbox& mailbox = internals.Mailboxes[remoteProcessId];
+  bool headerWritten = false;
+  vtkTypeUInt64 sent = 0;
+  pthread_mutex_lock(&mailbox.Mutex);
+  while (true)
+  {
+    const Channel& channel = internals.GetChannel(internals.Rank, remoteProcessId);
+    const vtkTypeUInt64 available =
+      internals.ChannelBufferSize - (channel.Written - channel.Read);
+    bool wrote = false;
+    if (!headerWritten && available >= sizeof(MessageHeader))
+    {
+      internals.WriteRing(
+        remoteProcessId, reinterpret_cast<const unsigned char*>(&header), sizeof(MessageHeader));
+      headerWritten = wrote = true;
+    }
+    if (headerWritten && sent < header.NumberOfBytes)
+    {
+      const vtkTypeUInt64 count =
+        internals.WriteRing(remoteProcessId, payload + sent, header.NumberOfBytes - sent);
+      sent += count;
+      wrote = wrote || count > 0;
+    }
+    if (wrote)
+    {
+      pthread_cond_broadcast(&mailbox.DataAvailable);
+    }
+    if (headerWritten && sent == header.NumberOfBytes)
+    {
+      break;
+    }
+    if (!wrote)
+    {
+      // The ring is full. Let go of the destination to drain our own
+      // incoming rings: the destination may itself be blocked sending to us.
+      pthread_mutex_unlock(&mailbox.Mutex);
+      internals.Progress();
+      pthread_mutex_lock(&mailbox.Mutex);
+      if (channel.Written - channel.Read == internals.ChannelBufferSize)
+      {
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        struct timespec timeout;
+        timeout.tv_sec = now.tv_sec;
+        timeout.tv_nsec = (now.tv_usec + 1000) * 1000;
+        if (timeout.tv_nsec >= 1000000000)
+        {
+          timeout.tv_sec += 1;
+          timeout.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&mailbox.SpaceAvailable, &mailbox.Mutex, &timeout);
+      }
+    }
+  }
+  pthread_mutex_unlock(&mailbox.Mutex);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkSharedMemoryCommunicator::ReceiveVoidArray(
+  void* data, vtkIdType maxlength, int type, int remoteProcessId, int tag)
+{
+  vtkInternals& internals = *this->Internals;
+  if (!this->IsAllocated())
+  {
+    vtkErrorMacro("Shared region is not allocated.");
+    return 0;
+  }
+  if (remoteProcessId != vtkMultiProcessController::ANY_SOURCE &&
+    (remoteProcessId < 0 || remoteProcessId >= internals.NumberOfProcesses))
+  {
+    vtkErrorMacro("Invalid source " << remoteProcessId << ".");
+    return 0;
+  }
+
+  const int typeSize = vtkAbstractArray::GetDataTypeSize(type);
+  PostedReceive posted;
+  posted.Source = remoteProcessId;
+  posted.Tag = tag;
+  posted.Buffer = static_cast<unsigned char*>(data);
+  posted.Capacity = static_cast<vtkTypeUInt64>(maxlength) * typeSize;
+  posted.Received = 0;
+  posted.Assigned = false;
+  posted.Oversized = false;
+  posted.Done = false;
+
+  if (!internals.TakeQueued(posted))
+  {
+    Mailbox& mailbox = internals.Mailboxes[internals.Rank];
+    pthread_mutex_lock(&mailbox.Mutex);
+    while (!posted.Done)
+    {
+      bool progress = false;
+      for (int source = 0; source < internals.NumberOfProcesses; ++source)
+      {
+        if (source != internals.Rank)
+        {
+          progress = internals.Drain(source, &posted) || progress;
+        }
+      }
+      if (progress)
+      {
+        pthread_cond_broadcast(&mailbox.SpaceAvailable);
+      }
+      if (!posted.Done && !posted.Assigned && internals.TakeQueued(posted))
+      {
+        break;
+      }
+      if (!posted.Done && !progress)
+      {
+        pthread_cond_wait(&mailbox.DataAvailable, &mailbox.Mutex);
+      }
+    }
+    pthread_mutex_unlock(&mailbox.Mutex);
+  }
+
+  this->Count = typeSize > 0 ? static_cast<vtkIdType>(posted.Received / typeSize) : 0;
+  return 1;
+}
@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSharedMemoryCommunicator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSharedMemoryCommunicator
+ * @brief   Communicator for processes on a single node sharing memory.
+ *
+ * vtkSharedMemoryCommunicator moves messages between processes forked by
+ * vtkSharedMemoryController through a POSIX shared memory region. Every
+ * ordered pair of processes owns a ring buffer in that region; a message is
+ * copied once into the ring by the sender and once out of it by the
+ * receiver, directly into the receive buffer when the receive is already
+ * posted. Messages larger than the ring are streamed through it.
+ *
+ * Messages that arrive before the matching receive is posted (different tag
+ * or source) are kept in a private queue, so tag matching and ANY_SOURCE
+ * receives behave like with vtkMPICommunicator. A sender blocked on a full
+ * ring keeps draining its own incoming rings, which prevents deadlocks
+ * when processes send to each other before receiving.
+ *
+ * The collective operations use the point-to-point implementations of
+ * vtkCommunicator.
+ *
+ * This class is only available on POSIX platforms.
+ *
+ * @sa
+ * vtkSharedMemoryController vtkCommunicator
+ */
+
+#ifndef vtkSharedMemoryCommunicator_h
+#define vtkSharedMemoryCommunicator_h
+
+#include "vtkCommunicator.h"
+#include "vtkParallelCoreModule.h" // For export macro
+
+class vtkSharedMemoryController;
+
+class VTKPARALLELCORE_EXPORT vtkSharedMemoryCommunicator : public vtkCommunicator
+{
+public:
+  vtkTypeMacro(vtkSharedMemoryCommunicator, vtkCommunicator);
+  static vtkSharedMemoryCommunicator* New();
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * The number of processes can only be changed before the shared region is
+   * allocated, i.e. before vtkSharedMemoryController::Initialize().
+   */
+  void SetNumberOfProcesses(int num) override;
+
+  ///@{
+  /**
+   * Implementation of the point-to-point primitives.
+   */
+  int SendVoidArray(
+    const void* data, vtkIdType length, int type, int remoteProcessId, int tag) override;
+  int ReceiveVoidArray(
+    void* data, vtkIdType maxlength, int type, int remoteProcessId, int tag) override;
+  ///@}
+
+  /**
+   * Size, in bytes, of the ring buffer of each ordered pair of processes.
+   */
+  vtkTypeUInt64 GetChannelBufferSize() const;
+
+  /**
+   * Returns true once the shared region has been allocated.
+   */
+  bool IsAllocated() const;
+
+protected:
+  vtkSharedMemoryCommunicator();
+  ~vtkSharedMemoryCommunicator() override;
+
+  friend class vtkSharedMemoryController;
+
+  /**
+   * Allocate and initialize the shared region for the current number of
+   * processes. Must be called before the processes are forked.
+   */
+  bool Allocate(vtkTypeUInt64 channelBufferSize);
+
+  /**
+   * Bind this communicator to a rank, after the fork.
+   */
+  void SetLocalProcessId(int id);
+
+  /**
+   * Unmap the shared region.
+   */
+  void Release();
+
+private:
+  vtkSharedMemoryCommunicator(const vtkSharedMemoryCommunicator&) = delete;
+  void operator=(const vtkSharedMemoryCommunicator&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif // vtkSharedMemoryCommunicator_h
@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSharedMemoryController.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSharedMemoryController.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkSharedMemoryCommunicator.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+vtkStandardNewMacro(vtkSharedMemoryController);
+
+//------------------------------------------------------------------------------
+vtkSharedMemoryController::vtkSharedMemoryController()
+{
+  this->ChannelBufferSize = 1 << 20;
+  this->Initialized = false;
+  this->Communicator = vtkSharedMemoryCommunicator::New();
+  this->RMICommunicator = vtkSharedMemoryCommunicator::New();
+}
+
+//------------------------------------------------------------------------------
+vtkSharedMemoryController::~vtkSharedMemoryController()
+{
+  if (this->Initialized)
+  {
+    this->Finalize();
+  }
+  this->Communicator->Delete();
+  this->RMICommunicator->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryController::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ChannelBufferSize: " << this->ChannelBufferSize << endl;
+  os << indent << "Initialized: " << this->Initialized << endl;
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryController::Initialize(int*, char***, int)
+{
+  if (this->Initialized)
+  {
+    vtkWarningMacro("Already initialized.");
+    return;
+  }
+
+  auto comm = static_cast<vtkSharedMemoryCommunicator*>(this->Communicator);
+  auto rmiComm = static_cast<vtkSharedMemoryCommunicator*>(this->RMICommunicator);
+  const int numProcs = comm->GetNumberOfProcesses();
+  rmiComm->SetNumberOfProcesses(numProcs);
+  if (!comm->Allocate(this->ChannelBufferSize) || !rmiComm->Allocate(this->ChannelBufferSize))
+  {
+    comm->Release();
+    rmiComm->Release();
+    return;
+  }
+
+  // Make sure buffered output is not duplicated by the children.
+  cout.flush();
+  cerr.flush();
+  fflush(nullptr);
+
+  int rank = 0;
+  this->Children.clear();
+  for (int cc = 1; cc < numProcs; ++cc)
+  {
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+      rank = cc;
+      this->Children.clear();
+      break;
+    }
+    if (pid < 0)
+    {
+      // Processes already forked would wait forever for the missing ranks.
+      vtkErrorMacro("Could not fork process " << cc << ": " << strerror(errno));
+      abort();
+    }
+    this->Children.push_back(static_cast<int>(pid));
+  }
+
+  comm->SetLocalProcessId(rank);
+  rmiComm->SetLocalProcessId(rank);
+  this->Initialized = true;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryController::Finalize(int)
+{
+  if (!this->Initialized)
+  {
+    return;
+  }
+
+  this->Communicator->Barrier();
+  for (int child : this->Children)
+  {
+    int status = 0;
+    while (waitpid(static_cast<pid_t>(child), &status, 0) < 0 && errno == EINTR)
+    {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      vtkWarningMacro("Process " << child << " did not exit cleanly.");
+    }
+  }
+  this->Children.clear();
+
+  static_cast<vtkSharedMemoryCommunicator*>(this->Communicator)->Release();
+  static_cast<vtkSharedMemoryCommunicator*>(this->RMICommunicator)->Release();
+  this->Initialized = false;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryController::SingleMethodExecute()
+{
+  if (!this->Initialized)
+  {
+    vtkWarningMacro("Controller has to be initialized first.");
+    return;
+  }
+
+  if (this->SingleMethod)
+  {
+    vtkMultiProcessController::SetGlobalController(this);
+    (this->SingleMethod)(this, this->SingleData);
+  }
+  else
+  {
+    vtkWarningMacro("SingleMethod not set.");
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSharedMemoryController::MultipleMethodExecute()
+{
+  if (!this->Initialized)
+  {
+    vtkWarningMacro("Controller has to be initialized first.");
+    return;
+  }
+
+  int i = this->GetLocalProcessId();
+  vtkProcessFunctionType multipleMethod;
+  void* multipleData;
+  this->GetMultipleMethod(i, multipleMethod, multipleData);
+  if (multipleMethod)
+  {
+    vtkMultiProcessController::SetGlobalController(this);
+    (multipleMethod)(this, multipleData);
+  }
+  else
+  {
+    vtkWarningMacro("MultipleMethod " << i << " not set.");
+  }
+}
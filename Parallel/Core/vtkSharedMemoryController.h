@@ -0,0 +1,126 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSharedMemoryController.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSharedMemoryController
+ * @brief   Multi-process controller for ranks on a single node.
+ *
+ * vtkSharedMemoryController provides vtkMultiProcessController semantics
+ * without MPI for jobs that run on a single node. Initialize() forks
+ * NumberOfProcesses - 1 child processes; afterwards every process runs the
+ * rest of the program with its own rank, as with vtkMPIController. Ranks
+ * communicate through vtkSharedMemoryCommunicator.
+ *
+ * Like MPI_Init, Initialize() must be called early, before the program
+ * starts any thread (including the vtkSMPTools thread pool), since only the
+ * calling thread survives a fork. Finalize() synchronizes all ranks and makes
+ * process 0 wait for the children to exit.
+ *
+ * @code
+ * vtkNew<vtkSharedMemoryController> controller;
+ * controller->SetNumberOfProcesses(8);
+ * controller->Initialize(&argc, &argv);
+ * vtkMultiProcessController::SetGlobalController(controller);
+ * ...
+ * controller->Finalize();
+ * @endcode
+ *
+ * Filters that rely on the vtkCommunicator API work unchanged. Filters that
+ * talk to MPI directly (e.g. through DIY) still need vtkMPIController.
+ *
+ * This class is only available on POSIX platforms.
+ *
+ * @sa
+ * vtkSharedMemoryCommunicator vtkMPIController vtkDummyController
+ */
+
+#ifndef vtkSharedMemoryController_h
+#define vtkSharedMemoryController_h
+
+#include "vtkMultiProcessController.h"
+#include "vtkParallelCoreModule.h" // For export macro
+
+#include <vector> // For std::vector
+
+class VTKPARALLELCORE_EXPORT vtkSharedMemoryController : public vtkMultiProcessController
+{
+public:
+  static vtkSharedMemoryController* New();
+  vtkTypeMacro(vtkSharedMemoryController, vtkMultiProcessController);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///@{
+  /**
+   * Allocate the shared region and fork the processes. The number of
+   * processes must be set with SetNumberOfProcesses() beforehand.
+   * `initializedExternally` is ignored.
+   */
+  void Initialize(int* argc, char*** argv, int initializedExternally) override;
+  void Initialize(int* argc, char*** argv) override { this->Initialize(argc, argv, 0); }
+  void Initialize() { this->Initialize(nullptr, nullptr, 0); }
+  ///@}
+
+  ///@{
+  /**
+   * Synchronize all processes, wait for the children on process 0 and
+   * release the shared region.
+   */
+  void Finalize() override { this->Finalize(0); }
+  void Finalize(int finalizedExternally) override;
+  ///@}
+
+  /**
+   * Execute the SingleMethod on every process.
+   */
+  void SingleMethodExecute() override;
+
+  /**
+   * Execute the MultipleMethod registered for the local process.
+   */
+  void MultipleMethodExecute() override;
+
+  /**
+   * Does nothing.
+   */
+  void CreateOutputWindow() override {}
+
+  ///@{
+  /**
+   * Size, in bytes, of the ring buffer used for each ordered pair of
+   * processes. Larger messages are streamed through it. Must be set before
+   * Initialize(). Default is 1 MiB.
+   */
+  vtkSetClampMacro(ChannelBufferSize, vtkTypeUInt64, 1024, VTK_TYPE_UINT64_MAX);
+  vtkGetMacro(ChannelBufferSize, vtkTypeUInt64);
+  ///@}
+
+  /**
+   * Returns true between Initialize() and Finalize().
+   */
+  vtkGetMacro(Initialized, bool);
+
+protected:
+  vtkSharedMemoryController();
+  ~vtkSharedMemoryController() override;
+
+  vtkTypeUInt64 ChannelBufferSize;
+  bool Initialized;
+  std::vector<int> Children;
+
+private:
+  vtkSharedMemoryController(const vtkSharedMemoryController&) = delete;
+  void operator=(const vtkSharedMemoryController&) = delete;
+};
+
+#endif
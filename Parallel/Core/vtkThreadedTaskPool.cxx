@@ -0,0 +1,150 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedTaskPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkThreadedTaskPool.h"
+
+#include "vtkLogger.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+class vtkThreadedTaskPool::vtkInternals
+{
+public:
+  int NumberOfThreads = 0;
+  bool Done = false;
+  std::deque<std::function<void()>> Jobs;
+  std::vector<std::thread> Threads;
+  std::mutex JobsMutex;
+  std::condition_variable JobsCV;
+
+  // Must be called with JobsMutex held.
+  void StartThreads()
+  {
+    const int count = this->NumberOfThreads > 0
+      ? this->NumberOfThreads
+      : vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    for (int cc = 0; cc < count; ++cc)
+    {
+      this->Threads.emplace_back(&vtkInternals::Run, this, cc);
+    }
+  }
+
+  void Run(int thread_id)
+  {
+    vtkLogger::SetThreadName("ttp::worker" + std::to_string(thread_id));
+    while (true)
+    {
+      std::unique_lock<std::mutex> lk(this->JobsMutex);
+      this->JobsCV.wait(lk, [this] { return this->Done || !this->Jobs.empty(); });
+      if (this->Jobs.empty())
+      {
+        // Done and drained.
+        break;
+      }
+      auto job = std::move(this->Jobs.front());
+      this->Jobs.pop_front();
+      lk.unlock();
+      job();
+    }
+  }
+};
+
+vtkStandardNewMacro(vtkThreadedTaskPool);
+
+//------------------------------------------------------------------------------
+vtkThreadedTaskPool::vtkThreadedTaskPool()
+  : Internals(new vtkInternals())
+{
+}
+
+//------------------------------------------------------------------------------
+vtkThreadedTaskPool::~vtkThreadedTaskPool()
+{
+  {
+    std::lock_guard<std::mutex> lk(this->Internals->JobsMutex);
+    this->Internals->Done = true;
+  }
+  this->Internals->JobsCV.notify_all();
+  for (auto& thread : this->Internals->Threads)
+  {
+    thread.join();
+  }
+  delete this->Internals;
+}
+
+//------------------------------------------------------------------------------
+vtkThreadedTaskPool* vtkThreadedTaskPool::GetGlobalPool()
+{
+  static vtkSmartPointer<vtkThreadedTaskPool> GlobalPool =
+    vtkSmartPointer<vtkThreadedTaskPool>::New();
+  return GlobalPool;
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedTaskPool::SetNumberOfThreads(int numberOfThreads)
+{
+  std::lock_guard<std::mutex> lk(this->Internals->JobsMutex);
+  if (!this->Internals->Threads.empty())
+  {
+    vtkWarningMacro("Threads already started, the number of threads cannot be changed.");
+    return;
+  }
+  if (this->Internals->NumberOfThreads != numberOfThreads)
+  {
+    this->Internals->NumberOfThreads = numberOfThreads;
+    this->Modified();
+  }
+}
+
+//------------------------------------------------------------------------------
+int vtkThreadedTaskPool::GetNumberOfThreads()
+{
+  std::lock_guard<std::mutex> lk(this->Internals->JobsMutex);
+  if (!this->Internals->Threads.empty())
+  {
+    return static_cast<int>(this->Internals->Threads.size());
+  }
+  return this->Internals->NumberOfThreads > 0 ? this->Internals->NumberOfThreads
+                                              : vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedTaskPool::Submit(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lk(this->Internals->JobsMutex);
+    if (this->Internals->Threads.empty())
+    {
+      this->Internals->StartThreads();
+    }
+    this->Internals->Jobs.push_back(std::move(job));
+  }
+  this->Internals->JobsCV.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedTaskPool::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfThreads: " << this->GetNumberOfThreads() << endl;
+}
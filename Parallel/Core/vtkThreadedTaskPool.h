@@ -0,0 +1,80 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkThreadedTaskPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class vtkThreadedTaskPool
+ * @brief pool of worker threads shared by task queues
+ *
+ * vtkThreadedTaskPool runs jobs submitted by one or more vtkThreadedTaskQueue
+ * instances on a fixed set of threads, in submission order. Sharing a pool
+ * bounds the number of threads used by background work (I/O, encoding,
+ * prefetching) across all the queues of an application.
+ *
+ * `GetGlobalPool()` returns a process-wide pool. Its number of threads
+ * defaults to `vtkMultiThreader::GetGlobalDefaultNumberOfThreads()` and can
+ * be changed until the first job is submitted.
+ *
+ * @sa
+ * vtkThreadedTaskQueue
+ */
+
+#ifndef vtkThreadedTaskPool_h
+#define vtkThreadedTaskPool_h
+
+#include "vtkObject.h"
+#include "vtkParallelCoreModule.h" // For export macro
+#include "vtkWrappingHints.h"      // For VTK_WRAPEXCLUDE
+
+#include <functional> // For std::function
+
+class VTKPARALLELCORE_EXPORT vtkThreadedTaskPool : public vtkObject
+{
+public:
+  static vtkThreadedTaskPool* New();
+  vtkTypeMacro(vtkThreadedTaskPool, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Returns the process-wide pool.
+   */
+  static vtkThreadedTaskPool* GetGlobalPool();
+
+  ///@{
+  /**
+   * Number of worker threads. The threads are started when the first job is
+   * submitted; changing the number afterwards has no effect. A value <= 0
+   * selects `vtkMultiThreader::GetGlobalDefaultNumberOfThreads()`.
+   */
+  void SetNumberOfThreads(int numberOfThreads);
+  int GetNumberOfThreads();
+  ///@}
+
+  /**
+   * Enqueue a job. Jobs are started in submission order. Thread safe.
+   */
+  VTK_WRAPEXCLUDE void Submit(std::function<void()> job);
+
+protected:
+  vtkThreadedTaskPool();
+  ~vtkThreadedTaskPool() override;
+
+private:
+  vtkThreadedTaskPool(const vtkThreadedTaskPool&) = delete;
+  void operator=(const vtkThreadedTaskPool&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
@@ -46,6 +46,31 @@
  * progress. Also, if `strict_ordering` is true, this is ignored; the
  * buffer_size will be set to unlimited.
  *
+ * Tasks may be given a priority with `PushWithPriority`. Queued tasks with a
+ * higher priority are started first; tasks with the same priority are started
+ * in the order they were pushed. When `buffer_size` is exceeded, the oldest
+ * task with the lowest priority is discarded. Priorities only affect the order
+ * in which tasks are started: with `strict_ordering`, results are still popped
+ * in the order tasks were pushed.
+ *
+ * `Cancel` discards the queued tasks whose arguments match a predicate, e.g.
+ * to drop stale prefetch requests. Tasks already in progress are not
+ * affected.
+ *
+ * `Submit` enqueues a task whose result is not delivered through `Pop` but
+ * through the returned vtkThreadedTaskHandle, which can be used to wait for
+ * that particular task, get its result or cancel it.
+ *
+ * `SetMaximumNumberOfQueuedTasks` bounds the number of tasks waiting to be
+ * started. Unlike `buffer_size`, which discards tasks, this makes `Push` block
+ * until a worker picks up a task, and it applies with `strict_ordering` too.
+ *
+ * Instead of starting its own threads, a queue may run its tasks on a
+ * vtkThreadedTaskPool shared with other queues, such as the process-wide
+ * `vtkThreadedTaskPool::GetGlobalPool()`.
+ *
+ * @sa
+ * vtkThreadedTaskPool
  */
 
 #ifndef vtkThreadedTaskQueue_h
@@ -61,13 +86,76 @@
 #include <thread>
 
 #if !defined(__WRAP__)
+class vtkThreadedTaskPool;
+
 namespace vtkThreadedTaskQueueInternals
 {
+class TaskControl;
+
 template <typename R>
+class TaskState;
+
+template <typename... Args>
+class TaskArguments;
+
+template <typename... Args>
 class TaskQueue;
 
 template <typename R>
 class ResultQueue;
+
+template <typename... Args>
+class Workers;
+};
+
+/**
+ * Handle on a task enqueued with vtkThreadedTaskQueue::Submit, similar to a
+ * `std::shared_future`. A default constructed handle is invalid.
+ */
+template <typename R>
+class vtkThreadedTaskHandle
+{
+public:
+  vtkThreadedTaskHandle() = default;
+  explicit vtkThreadedTaskHandle(std::shared_ptr<vtkThreadedTaskQueueInternals::TaskState<R>> state)
+    : State(std::move(state))
+  {
+  }
+
+  /**
+   * Returns true if the handle refers to a task.
+   */
+  bool IsValid() const { return this->State != nullptr; }
+
+  /**
+   * Returns true if the task has completed or was cancelled.
+   */
+  bool IsReady() const;
+
+  /**
+   * Returns true if the task was cancelled before it started.
+   */
+  bool IsCancelled() const;
+
+  /**
+   * Blocks till the task has completed or was cancelled. Returns true if the
+   * task completed.
+   */
+  bool Wait() const;
+
+  /**
+   * Cancel the task if it has not started yet. Returns true on success.
+   */
+  bool Cancel();
+
+  /**
+   * Blocks till the task has completed and returns its result, or a default
+   * constructed value if the task was cancelled.
+   */
+  R Get() const;
+
+private:
+  std::shared_ptr<vtkThreadedTaskQueueInternals::TaskState<R>> State;
 };
 
 template <typename R, typename... Args>
@@ -76,13 +164,48 @@ class vtkThreadedTaskQueue
 public:
   vtkThreadedTaskQueue(std::function<R(Args...)> worker, bool strict_ordering = true,
     int buffer_size = -1, int max_concurrent_tasks = -1);
+
+  /**
+   * Create a queue whose tasks are executed by the threads of `pool` instead
+   * of threads owned by the queue.
+   */
+  vtkThreadedTaskQueue(std::function<R(Args...)> worker, vtkThreadedTaskPool* pool,
+    bool strict_ordering = true, int buffer_size = -1);
+
   ~vtkThreadedTaskQueue();
 
   /**
-   * Push arguments for the work
+   * Push arguments for the work. The arguments are moved into the queue and
+   * then into the worker, so move-only arguments are supported.
    */
   void Push(Args&&... args);
 
+  /**
+   * Push arguments for the work with the given priority. Push uses priority 0.
+   */
+  void PushWithPriority(int priority, Args&&... args);
+
+  /**
+   * Push arguments for the work and return a handle on the task. The result
+   * of the task is only available through the handle, not through Pop.
+   */
+  vtkThreadedTaskHandle<R> Submit(int priority, Args&&... args);
+
+  /**
+   * Discard the queued tasks whose arguments satisfy `predicate`. Returns the
+   * number of discarded tasks.
+   */
+  std::size_t Cancel(std::function<bool(const Args&...)> predicate);
+
+  ///@{
+  /**
+   * Maximum number of tasks waiting to be started. When reached, Push blocks
+   * till a task is started. Default is -1, i.e. unlimited.
+   */
+  void SetMaximumNumberOfQueuedTasks(int count);
+  int GetMaximumNumberOfQueuedTasks() const;
+  ///@}
+
   /**
    * Pop the last result. Returns true on success. May fail if called on an
    * empty queue. This will wait for result to be available.
@@ -110,13 +233,15 @@ private:
   vtkThreadedTaskQueue(const vtkThreadedTaskQueue&) = delete;
   void operator=(const vtkThreadedTaskQueue&) = delete;
 
+  void Enqueue(int priority, std::shared_ptr<vtkThreadedTaskQueueInternals::TaskControl> control,
+    std::function<void(std::uint64_t)>&& run,
+    std::shared_ptr<vtkThreadedTaskQueueInternals::TaskArguments<Args...>> arguments);
+
   std::function<R(Args...)> Worker;
 
-  std::unique_ptr<vtkThreadedTaskQueueInternals::TaskQueue<R>> Tasks;
+  std::unique_ptr<vtkThreadedTaskQueueInternals::TaskQueue<Args...>> Tasks;
   std::unique_ptr<vtkThreadedTaskQueueInternals::ResultQueue<R>> Results;
-
-  int NumberOfThreads;
-  std::unique_ptr<std::thread[]> Threads;
+  std::unique_ptr<vtkThreadedTaskQueueInternals::Workers<Args...>> Executor;
 };
 
 template <typename... Args>
@@ -125,13 +250,47 @@ class vtkThreadedTaskQueue<void, Args...>
 public:
   vtkThreadedTaskQueue(std::function<void(Args...)> worker, bool strict_ordering = true,
     int buffer_size = -1, int max_concurrent_tasks = -1);
+
+  /**
+   * Create a queue whose tasks are executed by the threads of `pool` instead
+   * of threads owned by the queue.
+   */
+  vtkThreadedTaskQueue(std::function<void(Args...)> worker, vtkThreadedTaskPool* pool,
+    bool strict_ordering = true, int buffer_size = -1);
+
   ~vtkThreadedTaskQueue();
 
   /**
-   * Push arguments for the work
+   * Push arguments for the work. The arguments are moved into the queue and
+   * then into the worker, so move-only arguments are supported.
    */
   void Push(Args&&... args);
 
+  /**
+   * Push arguments for the work with the given priority. Push uses priority 0.
+   */
+  void PushWithPriority(int priority, Args&&... args);
+
+  /**
+   * Push arguments for the work and return a handle on the task.
+   */
+  vtkThreadedTaskHandle<void> Submit(int priority, Args&&... args);
+
+  /**
+   * Discard the queued tasks whose arguments satisfy `predicate`. Returns the
+   * number of discarded tasks.
+   */
+  std::size_t Cancel(std::function<bool(const Args&...)> predicate);
+
+  ///@{
+  /**
+   * Maximum number of tasks waiting to be started. When reached, Push blocks
+   * till a task is started. Default is -1, i.e. unlimited.
+   */
+  void SetMaximumNumberOfQueuedTasks(int count);
+  int GetMaximumNumberOfQueuedTasks() const;
+  ///@}
+
   /**
    * Returns false if there's some result that may be popped right now or in the
    * future.
@@ -147,16 +306,20 @@ private:
   vtkThreadedTaskQueue(const vtkThreadedTaskQueue&) = delete;
   void operator=(const vtkThreadedTaskQueue&) = delete;
 
+  void Enqueue(int priority, std::shared_ptr<vtkThreadedTaskQueueInternals::TaskControl> control,
+    std::function<void(std::uint64_t)>&& run,
+    std::shared_ptr<vtkThreadedTaskQueueInternals::TaskArguments<Args...>> arguments);
+  void TaskDone();
+
   std::function<void(Args...)> Worker;
 
-  std::unique_ptr<vtkThreadedTaskQueueInternals::TaskQueue<void>> Tasks;
+  std::unique_ptr<vtkThreadedTaskQueueInternals::TaskQueue<Args...>> Tasks;
 
   std::condition_variable ResultsCV;
-  std::mutex NextResultIdMutex;
-  std::atomic<std::uint64_t> NextResultId;
+  std::mutex PendingTasksMutex;
+  std::atomic<std::uint64_t> NumberOfPendingTasks;
 
-  int NumberOfThreads;
-  std::unique_ptr<std::thread[]> Threads;
+  std::unique_ptr<vtkThreadedTaskQueueInternals::Workers<Args...>> Executor;
 };
 
 #include "vtkThreadedTaskQueue.txx"
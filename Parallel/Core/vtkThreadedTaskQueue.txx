@@ -15,23 +15,181 @@
 #include "vtkLogger.h"
 
 #include "vtkMultiThreader.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadedTaskPool.h"
 
+#include <algorithm>
 #include <cassert>
+#include <map>
 #include <queue>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 //=============================================================================
 namespace vtkThreadedTaskQueueInternals
 {
 
+//=============================================================================
+// Life cycle of a task, shared between the queue and vtkThreadedTaskHandle.
+class TaskControl
+{
+public:
+  enum StatusType
+  {
+    QUEUED,
+    RUNNING,
+    COMPLETED,
+    CANCELLED
+  };
+
+  bool Start() { return this->Transition(QUEUED, RUNNING); }
+  bool Cancel() { return this->Transition(QUEUED, CANCELLED); }
+  void Finish() { this->Transition(RUNNING, COMPLETED); }
+
+  int GetStatus() const
+  {
+    std::lock_guard<std::mutex> lk(this->StatusMutex);
+    return this->Status;
+  }
+
+  bool IsReady() const
+  {
+    const int status = this->GetStatus();
+    return status == COMPLETED || status == CANCELLED;
+  }
+
+  void Wait() const
+  {
+    std::unique_lock<std::mutex> lk(this->StatusMutex);
+    this->StatusCV.wait(
+      lk, [this] { return this->Status == COMPLETED || this->Status == CANCELLED; });
+  }
+
+private:
+  bool Transition(int from, int to)
+  {
+    {
+      std::lock_guard<std::mutex> lk(this->StatusMutex);
+      if (this->Status != from)
+      {
+        return false;
+      }
+      this->Status = to;
+    }
+    this->StatusCV.notify_all();
+    return true;
+  }
+
+  int Status = QUEUED;
+  mutable std::mutex StatusMutex;
+  mutable std::condition_variable StatusCV;
+};
+
+//=============================================================================
 template <typename R>
+class TaskState : public TaskControl
+{
+public:
+  // The value is set before Finish() and read after Wait(), which orders the
+  // accesses.
+  void SetValue(R&& value) { this->Value = std::move(value); }
+  R GetValue() const { return this->Value; }
+
+private:
+  R Value;
+};
+
+template <>
+class TaskState<void> : public TaskControl
+{
+public:
+  void GetValue() const {}
+};
+
+//=============================================================================
+template <std::size_t... I>
+struct IndexSequence
+{
+};
+
+template <std::size_t N, std::size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...>
+{
+};
+
+template <std::size_t... I>
+struct MakeIndexSequence<0, I...>
+{
+  using type = IndexSequence<I...>;
+};
+
+//=============================================================================
+// The arguments of a task, stored once and shared by the work and the
+// cancellation predicates.
+template <typename... Args>
+class TaskArguments
+{
+public:
+  explicit TaskArguments(Args&&... args)
+    : Values(std::forward<Args>(args)...)
+  {
+  }
+
+  // Hands the arguments over to the worker. The task has left the queue by
+  // then, so no predicate looks at them anymore.
+  template <typename R>
+  R Invoke(const std::function<R(Args...)>& worker)
+  {
+    return this->Invoke(worker, typename MakeIndexSequence<sizeof...(Args)>::type());
+  }
+
+  bool Match(const std::function<bool(const Args&...)>& predicate) const
+  {
+    return this->Match(predicate, typename MakeIndexSequence<sizeof...(Args)>::type());
+  }
+
+private:
+  template <typename R, std::size_t... I>
+  R Invoke(const std::function<R(Args...)>& worker, IndexSequence<I...>)
+  {
+    return worker(std::forward<Args>(std::get<I>(this->Values))...);
+  }
+
+  template <std::size_t... I>
+  bool Match(const std::function<bool(const Args&...)>& predicate, IndexSequence<I...>) const
+  {
+    return predicate(std::get<I>(this->Values)...);
+  }
+
+  std::tuple<typename std::decay<Args>::type...> Values;
+};
+
+//=============================================================================
+template <typename... Args>
 class TaskQueue
 {
 public:
-  TaskQueue(int buffer_size)
+  using Predicate = std::function<bool(const Args&...)>;
+
+  struct Task
+  {
+    std::shared_ptr<TaskControl> Control;
+    // Executes the work and delivers its result.
+    std::function<void(std::uint64_t)> Run;
+    std::shared_ptr<TaskArguments<Args...>> Arguments;
+  };
+
+  // `skip` is called for every task that is discarded or cancelled instead
+  // of being run.
+  TaskQueue(int buffer_size, std::function<void(std::uint64_t)> skip)
     : Done(false)
     , BufferSize(buffer_size)
+    , MaximumNumberOfQueuedTasks(-1)
     , NextTaskId(0)
+    , Skip(std::move(skip))
   {
   }
 
@@ -39,57 +197,159 @@ public:
 
   void MarkDone()
   {
-    this->Done = true;
+    {
+      std::lock_guard<std::mutex> lk(this->TasksMutex);
+      this->Done = true;
+    }
     this->TasksCV.notify_all();
+    this->SpaceCV.notify_all();
   }
 
   std::uint64_t GetNextTaskId() const { return this->NextTaskId; }
 
-  void Push(std::function<R()>&& task)
+  void SetMaximumNumberOfQueuedTasks(int count)
   {
-    if (this->Done)
     {
-      return;
+      std::lock_guard<std::mutex> lk(this->TasksMutex);
+      this->MaximumNumberOfQueuedTasks = count;
     }
-    else
+    this->SpaceCV.notify_all();
+  }
+
+  int GetMaximumNumberOfQueuedTasks() const { return this->MaximumNumberOfQueuedTasks; }
+
+  bool Push(int priority, Task&& task)
+  {
+    std::vector<std::pair<std::uint64_t, Task>> discarded;
     {
-      std::lock_guard<std::mutex> lk(this->TasksMutex);
+      std::unique_lock<std::mutex> lk(this->TasksMutex);
+      this->SpaceCV.wait(lk, [this] {
+        const int maxQueued = this->MaximumNumberOfQueuedTasks;
+        return this->Done || maxQueued <= 0 || static_cast<int>(this->Tasks.size()) < maxQueued;
+      });
+      if (this->Done)
+      {
+        return false;
+      }
+
       // vtkLogF(INFO, "pushing-task %d", (int)this->NextTaskId);
-      this->Tasks.push(std::make_pair(this->NextTaskId++, std::move(task)));
+      this->Tasks.emplace(Key(priority, this->NextTaskId++), std::move(task));
       while (this->BufferSize > 0 && static_cast<int>(this->Tasks.size()) > this->BufferSize)
       {
-        this->Tasks.pop();
+        // discard the oldest task among the ones with the lowest priority.
+        auto iter = this->Tasks.lower_bound(Key(this->Tasks.rbegin()->first.first, 0));
+        discarded.emplace_back(iter->first.second, std::move(iter->second));
+        this->Tasks.erase(iter);
       }
     }
     this->TasksCV.notify_one();
+
+    for (auto& item : discarded)
+    {
+      item.second.Control->Cancel();
+      this->Skip(item.first);
+    }
+    return true;
   }
 
-  bool Pop(std::uint64_t& task_id, std::function<R()>& task)
+  bool Pop(std::uint64_t& task_id, Task& task)
   {
     std::unique_lock<std::mutex> lk(this->TasksMutex);
     this->TasksCV.wait(lk, [this] { return this->Done || !this->Tasks.empty(); });
     if (!this->Tasks.empty())
     {
-      auto task_pair = this->Tasks.front();
-      // vtkLogF(TRACE, "popping-task %d", (int)task_pair.first);
-      this->Tasks.pop();
+      this->PopLocked(task_id, task);
       lk.unlock();
-
-      task_id = task_pair.first;
-      task = std::move(task_pair.second);
+      this->SpaceCV.notify_one();
       return true;
     }
     assert(this->Done);
     return false;
   }
 
+  bool TryPop(std::uint64_t& task_id, Task& task)
+  {
+    std::unique_lock<std::mutex> lk(this->TasksMutex);
+    if (this->Tasks.empty())
+    {
+      return false;
+    }
+    this->PopLocked(task_id, task);
+    lk.unlock();
+    this->SpaceCV.notify_one();
+    return true;
+  }
+
+  void Execute(std::uint64_t task_id, Task& task)
+  {
+    if (task.Control->Start())
+    {
+      task.Run(task_id);
+    }
+    else
+    {
+      // cancelled through its handle while queued.
+      this->Skip(task_id);
+    }
+  }
+
+  std::size_t Cancel(const Predicate& predicate)
+  {
+    std::vector<std::pair<std::uint64_t, Task>> cancelled;
+    {
+      std::lock_guard<std::mutex> lk(this->TasksMutex);
+      for (auto iter = this->Tasks.begin(); iter != this->Tasks.end();)
+      {
+        if (iter->second.Arguments->Match(predicate))
+        {
+          cancelled.emplace_back(iter->first.second, std::move(iter->second));
+          iter = this->Tasks.erase(iter);
+        }
+        else
+        {
+          ++iter;
+        }
+      }
+    }
+    this->SpaceCV.notify_all();
+
+    for (auto& item : cancelled)
+    {
+      item.second.Control->Cancel();
+      this->Skip(item.first);
+    }
+    return cancelled.size();
+  }
+
 private:
-  std::atomic_bool Done;
+  // (priority, task id): higher priorities first, then FIFO.
+  using Key = std::pair<int, std::uint64_t>;
+  struct KeyComparator
+  {
+    bool operator()(const Key& left, const Key& right) const
+    {
+      return left.first > right.first || (left.first == right.first && left.second < right.second);
+    }
+  };
+
+  void PopLocked(std::uint64_t& task_id, Task& task)
+  {
+    auto iter = this->Tasks.begin();
+    // vtkLogF(TRACE, "popping-task %d", (int)iter->first.second);
+    task_id = iter->first.second;
+    task = std::move(iter->second);
+    this->Tasks.erase(iter);
+  }
+
+  bool Done;
   int BufferSize;
+  std::atomic<int> MaximumNumberOfQueuedTasks;
   std::atomic<std::uint64_t> NextTaskId;
-  std::queue<std::pair<std::uint64_t, std::function<R()>>> Tasks;
+  std::function<void(std::uint64_t)> Skip;
+  std::map<Key, Task, KeyComparator> Tasks;
   std::mutex TasksMutex;
   std::condition_variable TasksCV;
+  std::condition_variable SpaceCV;
 };
 
 //=============================================================================
@@ -107,102 +367,259 @@ public:
 
   std::uint64_t GetNextResultId() const { return this->NextResultId; }
 
-  void Push(std::uint64_t task_id, const R&& result)
+  void Push(std::uint64_t task_id, R&& result) { this->Insert(task_id, true, std::move(result)); }
+
+  // Marks a task that produces no result for this queue, so that the results
+  // of the following tasks may be popped.
+  void Skip(std::uint64_t task_id) { this->Insert(task_id, false, R()); }
+
+  bool TryPop(R& result)
+  {
+    std::lock_guard<std::mutex> lk(this->ResultsMutex);
+    return this->PopLocked(result);
+  }
+
+  // Waits for a result unless all tasks pushed so far, up to
+  // `next_task_id`, have been accounted for.
+  bool Pop(R& result, std::uint64_t next_task_id)
   {
     std::unique_lock<std::mutex> lk(this->ResultsMutex);
-    // don't save this result if it's obsolete.
-    if (task_id >= this->NextResultId)
+    while (!this->PopLocked(result))
     {
-      this->Results.push(std::make_pair(task_id, std::move(result)));
+      if (this->NextResultId == next_task_id)
+      {
+        return false;
+      }
+      this->ResultsCV.wait(lk);
     }
-    lk.unlock();
-    this->ResultsCV.notify_one();
+    return true;
   }
 
-  bool TryPop(R& result)
+private:
+  struct Result
+  {
+    std::uint64_t TaskId;
+    bool Valid;
+    R Value;
+  };
+
+  void Insert(std::uint64_t task_id, bool valid, R&& value)
   {
     std::unique_lock<std::mutex> lk(this->ResultsMutex);
-    if (this->Results.empty() ||
-      (this->StrictOrdering && this->Results.top().first != this->NextResultId))
+    // don't save this result if it's obsolete.
+    if (task_id >= this->NextResultId)
     {
-      // results are not available or of strict-ordering is requested, the
-      // result available is not the next one in sequence, hence don't pop
-      // anything.
-      return false;
+      this->Results.push(Result{ task_id, valid, std::move(value) });
     }
-
-    auto result_pair = this->Results.top();
-    this->NextResultId = (result_pair.first + 1);
-    this->Results.pop();
     lk.unlock();
-
-    result = std::move(result_pair.second);
-    return true;
+    this->ResultsCV.notify_one();
   }
 
-  bool Pop(R& result)
+  bool PopLocked(R& result)
   {
-    std::unique_lock<std::mutex> lk(this->ResultsMutex);
-    this->ResultsCV.wait(lk, [this] {
-      return !this->Results.empty() &&
-        (!this->StrictOrdering || this->Results.top().first == this->NextResultId);
-    });
-    lk.unlock();
-    return this->TryPop(result);
+    while (!this->Results.empty())
+    {
+      const Result& top = this->Results.top();
+      if (this->StrictOrdering && top.TaskId != this->NextResultId)
+      {
+        // if strict-ordering is requested, the result available is not the
+        // next one in sequence, hence don't pop anything.
+        return false;
+      }
+
+      const bool valid = top.Valid;
+      if (valid)
+      {
+        result = top.Value;
+      }
+      this->NextResultId = (top.TaskId + 1);
+      this->Results.pop();
+      if (valid)
+      {
+        return true;
+      }
+    }
+    return false;
   }
 
-private:
-  template <typename T>
   struct Comparator
   {
-    bool operator()(const T& left, const T& right) const { return left.first > right.first; }
+    bool operator()(const Result& left, const Result& right) const
+    {
+      return left.TaskId > right.TaskId;
+    }
   };
-  std::priority_queue<std::pair<std::uint64_t, R>, std::vector<std::pair<std::uint64_t, R>>,
-    Comparator<std::pair<std::uint64_t, R>>>
-    Results;
+  std::priority_queue<Result, std::vector<Result>, Comparator> Results;
   std::mutex ResultsMutex;
   std::condition_variable ResultsCV;
   std::atomic<std::uint64_t> NextResultId;
   bool StrictOrdering;
 };
 
-}
-
-//-----------------------------------------------------------------------------
-template <typename R, typename... Args>
-vtkThreadedTaskQueue<R, Args...>::vtkThreadedTaskQueue(
-  std::function<R(Args...)> worker, bool strict_ordering, int buffer_size, int max_concurrent_tasks)
-  : Worker(worker)
-  , Tasks(new vtkThreadedTaskQueueInternals::TaskQueue<R>(
-      std::max(0, strict_ordering ? 0 : buffer_size)))
-  , Results(new vtkThreadedTaskQueueInternals::ResultQueue<R>(strict_ordering))
-  , NumberOfThreads(max_concurrent_tasks <= 0 ? vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
-                                              : max_concurrent_tasks)
-  , Threads{ new std::thread[this->NumberOfThreads] }
+//=============================================================================
+// Runs the tasks either on threads owned by the queue or on a shared pool.
+template <typename... Args>
+class Workers
 {
-  auto f = [this](int thread_id) {
-    vtkLogger::SetThreadName("ttq::worker" + std::to_string(thread_id));
-    while (true)
+public:
+  using TaskQueueType = TaskQueue<Args...>;
+
+  Workers(TaskQueueType* tasks, int number_of_threads)
+    : Tasks(tasks)
+    , PendingJobs(0)
+  {
+    for (int cc = 0; cc < number_of_threads; ++cc)
     {
-      std::function<R()> task;
+      this->Threads.emplace_back(&Workers::Run, this, cc);
+    }
+  }
+
+  Workers(TaskQueueType* tasks, vtkThreadedTaskPool* pool)
+    : Tasks(tasks)
+    , Pool(pool)
+    , PendingJobs(0)
+  {
+  }
+
+  // TaskQueue::MarkDone() must be called first.
+  ~Workers()
+  {
+    for (auto& thread : this->Threads)
+    {
+      thread.join();
+    }
+    std::unique_lock<std::mutex> lk(this->JobsMutex);
+    this->JobsCV.wait(lk, [this] { return this->PendingJobs == 0; });
+  }
+
+  // Called for every task pushed to the queue. Each pool job runs the task
+  // that is first in the queue when the job starts, if any.
+  void TaskPushed()
+  {
+    if (!this->Pool)
+    {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lk(this->JobsMutex);
+      ++this->PendingJobs;
+    }
+    this->Pool->Submit([this]() {
       std::uint64_t task_id;
-      if (this->Tasks->Pop(task_id, task))
+      typename TaskQueueType::Task task;
+      if (this->Tasks->TryPop(task_id, task))
       {
-        this->Results->Push(task_id, task());
-        continue;
+        this->Tasks->Execute(task_id, task);
       }
-      else
+      std::lock_guard<std::mutex> lk(this->JobsMutex);
+      --this->PendingJobs;
+      this->JobsCV.notify_all();
+    });
+  }
+
+private:
+  void Run(int thread_id)
+  {
+    vtkLogger::SetThreadName("ttq::worker" + std::to_string(thread_id));
+    while (true)
+    {
+      std::uint64_t task_id;
+      typename TaskQueueType::Task task;
+      if (!this->Tasks->Pop(task_id, task))
       {
         break;
       }
+      this->Tasks->Execute(task_id, task);
     }
     // vtkLogF(INFO, "done");
-  };
+  }
 
-  for (int cc = 0; cc < this->NumberOfThreads; ++cc)
+  TaskQueueType* Tasks;
+  vtkSmartPointer<vtkThreadedTaskPool> Pool;
+  std::vector<std::thread> Threads;
+  std::mutex JobsMutex;
+  std::condition_variable JobsCV;
+  int PendingJobs;
+};
+
+}
+
+//=============================================================================
+// ** vtkThreadedTaskHandle
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+template <typename R>
+bool vtkThreadedTaskHandle<R>::IsReady() const
+{
+  return this->State && this->State->IsReady();
+}
+
+//-----------------------------------------------------------------------------
+template <typename R>
+bool vtkThreadedTaskHandle<R>::IsCancelled() const
+{
+  return this->State &&
+    this->State->GetStatus() == vtkThreadedTaskQueueInternals::TaskControl::CANCELLED;
+}
+
+//-----------------------------------------------------------------------------
+template <typename R>
+bool vtkThreadedTaskHandle<R>::Wait() const
+{
+  if (!this->State)
   {
-    this->Threads[cc] = std::thread(f, cc);
+    return false;
   }
+  this->State->Wait();
+  return this->State->GetStatus() == vtkThreadedTaskQueueInternals::TaskControl::COMPLETED;
+}
+
+//-----------------------------------------------------------------------------
+template <typename R>
+bool vtkThreadedTaskHandle<R>::Cancel()
+{
+  return this->State && this->State->Cancel();
+}
+
+//-----------------------------------------------------------------------------
+template <typename R>
+R vtkThreadedTaskHandle<R>::Get() const
+{
+  return this->Wait() ? this->State->GetValue() : R();
+}
+
+//=============================================================================
+// ** vtkThreadedTaskQueue
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+vtkThreadedTaskQueue<R, Args...>::vtkThreadedTaskQueue(
+  std::function<R(Args...)> worker, bool strict_ordering, int buffer_size, int max_concurrent_tasks)
+  : Worker(worker)
+  , Tasks(new vtkThreadedTaskQueueInternals::TaskQueue<Args...>(
+      std::max(0, strict_ordering ? 0 : buffer_size),
+      [this](std::uint64_t task_id) { this->Results->Skip(task_id); }))
+  , Results(new vtkThreadedTaskQueueInternals::ResultQueue<R>(strict_ordering))
+  , Executor(new vtkThreadedTaskQueueInternals::Workers<Args...>(this->Tasks.get(),
+      max_concurrent_tasks <= 0 ? vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
+                                : max_concurrent_tasks))
+{
+}
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+vtkThreadedTaskQueue<R, Args...>::vtkThreadedTaskQueue(std::function<R(Args...)> worker,
+  vtkThreadedTaskPool* pool, bool strict_ordering, int buffer_size)
+  : Worker(worker)
+  , Tasks(new vtkThreadedTaskQueueInternals::TaskQueue<Args...>(
+      std::max(0, strict_ordering ? 0 : buffer_size),
+      [this](std::uint64_t task_id) { this->Results->Skip(task_id); }))
+  , Results(new vtkThreadedTaskQueueInternals::ResultQueue<R>(strict_ordering))
+  , Executor(new vtkThreadedTaskQueueInternals::Workers<Args...>(this->Tasks.get(), pool))
+{
+  assert(pool != nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -210,9 +627,27 @@ template <typename R, typename... Args>
 vtkThreadedTaskQueue<R, Args...>::~vtkThreadedTaskQueue()
 {
   this->Tasks->MarkDone();
-  for (int cc = 0; cc < this->NumberOfThreads; ++cc)
+  this->Executor.reset();
+}
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+void vtkThreadedTaskQueue<R, Args...>::Enqueue(int priority,
+  std::shared_ptr<vtkThreadedTaskQueueInternals::TaskControl> control,
+  std::function<void(std::uint64_t)>&& run,
+  std::shared_ptr<vtkThreadedTaskQueueInternals::TaskArguments<Args...>> arguments)
+{
+  typename vtkThreadedTaskQueueInternals::TaskQueue<Args...>::Task task;
+  task.Control = control;
+  task.Run = std::move(run);
+  task.Arguments = std::move(arguments);
+  if (this->Tasks->Push(priority, std::move(task)))
   {
-    this->Threads[cc].join();
+    this->Executor->TaskPushed();
+  }
+  else
+  {
+    control->Cancel();
   }
 }
 
@@ -220,7 +655,64 @@ vtkThreadedTaskQueue<R, Args...>::~vtkThreadedTaskQueue()
 template <typename R, typename... Args>
 void vtkThreadedTaskQueue<R, Args...>::Push(Args&&... args)
 {
-  this->Tasks->Push(std::bind(this->Worker, args...));
+  this->PushWithPriority(0, std::forward<Args>(args)...);
+}
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+void vtkThreadedTaskQueue<R, Args...>::PushWithPriority(int priority, Args&&... args)
+{
+  auto arguments = std::make_shared<vtkThreadedTaskQueueInternals::TaskArguments<Args...>>(
+    std::forward<Args>(args)...);
+  auto worker = &this->Worker;
+  auto results = this->Results.get();
+  this->Enqueue(priority, std::make_shared<vtkThreadedTaskQueueInternals::TaskControl>(),
+    [worker, arguments, results](
+      std::uint64_t task_id) { results->Push(task_id, arguments->Invoke(*worker)); },
+    arguments);
+}
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+vtkThreadedTaskHandle<R> vtkThreadedTaskQueue<R, Args...>::Submit(int priority, Args&&... args)
+{
+  auto state = std::make_shared<vtkThreadedTaskQueueInternals::TaskState<R>>();
+  auto arguments = std::make_shared<vtkThreadedTaskQueueInternals::TaskArguments<Args...>>(
+    std::forward<Args>(args)...);
+  auto worker = &this->Worker;
+  auto results = this->Results.get();
+  // the queue entry owns the state till the task is run.
+  auto rawState = state.get();
+  this->Enqueue(priority, state,
+    [worker, arguments, results, rawState](std::uint64_t task_id) {
+      rawState->SetValue(arguments->Invoke(*worker));
+      rawState->Finish();
+      results->Skip(task_id);
+    },
+    arguments);
+  return vtkThreadedTaskHandle<R>(state);
+}
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+std::size_t vtkThreadedTaskQueue<R, Args...>::Cancel(
+  std::function<bool(const Args&...)> predicate)
+{
+  return this->Tasks->Cancel(predicate);
+}
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+void vtkThreadedTaskQueue<R, Args...>::SetMaximumNumberOfQueuedTasks(int count)
+{
+  this->Tasks->SetMaximumNumberOfQueuedTasks(count);
+}
+
+//-----------------------------------------------------------------------------
+template <typename R, typename... Args>
+int vtkThreadedTaskQueue<R, Args...>::GetMaximumNumberOfQueuedTasks() const
+{
+  return this->Tasks->GetMaximumNumberOfQueuedTasks();
 }
 
 //-----------------------------------------------------------------------------
@@ -239,7 +731,7 @@ bool vtkThreadedTaskQueue<R, Args...>::Pop(R& result)
     return false;
   }
 
-  return this->Results->Pop(result);
+  return this->Results->Pop(result, this->Tasks->GetNextTaskId());
 }
 
 //-----------------------------------------------------------------------------
@@ -269,42 +761,26 @@ template <typename... Args>
 vtkThreadedTaskQueue<void, Args...>::vtkThreadedTaskQueue(std::function<void(Args...)> worker,
   bool strict_ordering, int buffer_size, int max_concurrent_tasks)
   : Worker(worker)
-  , Tasks(new vtkThreadedTaskQueueInternals::TaskQueue<void>(
-      std::max(0, strict_ordering ? 0 : buffer_size)))
-  , NextResultId(0)
-  , NumberOfThreads(max_concurrent_tasks <= 0 ? vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
-                                              : max_concurrent_tasks)
-  , Threads{ new std::thread[this->NumberOfThreads] }
-{
-  auto f = [this](int thread_id) {
-    vtkLogger::SetThreadName("ttq::worker" + std::to_string(thread_id));
-    while (true)
-    {
-      std::function<void()> task;
-      std::uint64_t task_id;
-      if (this->Tasks->Pop(task_id, task))
-      {
-        task();
-
-        std::unique_lock<std::mutex> lk(this->NextResultIdMutex);
-        this->NextResultId = std::max(static_cast<std::uint64_t>(this->NextResultId), task_id + 1);
-        lk.unlock();
-        this->ResultsCV.notify_all();
-        continue;
-      }
-      else
-      {
-        break;
-      }
-    }
-    this->ResultsCV.notify_all();
-    // vtkLogF(INFO, "done");
-  };
+  , Tasks(new vtkThreadedTaskQueueInternals::TaskQueue<Args...>(
+      std::max(0, strict_ordering ? 0 : buffer_size), [this](std::uint64_t) { this->TaskDone(); }))
+  , NumberOfPendingTasks(0)
+  , Executor(new vtkThreadedTaskQueueInternals::Workers<Args...>(this->Tasks.get(),
+      max_concurrent_tasks <= 0 ? vtkMultiThreader::GetGlobalDefaultNumberOfThreads()
+                                : max_concurrent_tasks))
+{
+}
 
-  for (int cc = 0; cc < this->NumberOfThreads; ++cc)
-  {
-    this->Threads[cc] = std::thread(f, cc);
-  }
+//-----------------------------------------------------------------------------
+template <typename... Args>
+vtkThreadedTaskQueue<void, Args...>::vtkThreadedTaskQueue(std::function<void(Args...)> worker,
+  vtkThreadedTaskPool* pool, bool strict_ordering, int buffer_size)
+  : Worker(worker)
+  , Tasks(new vtkThreadedTaskQueueInternals::TaskQueue<Args...>(
+      std::max(0, strict_ordering ? 0 : buffer_size), [this](std::uint64_t) { this->TaskDone(); }))
+  , NumberOfPendingTasks(0)
+  , Executor(new vtkThreadedTaskQueueInternals::Workers<Args...>(this->Tasks.get(), pool))
+{
+  assert(pool != nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -312,9 +788,39 @@ template <typename... Args>
 vtkThreadedTaskQueue<void, Args...>::~vtkThreadedTaskQueue()
 {
   this->Tasks->MarkDone();
-  for (int cc = 0; cc < this->NumberOfThreads; ++cc)
+  this->Executor.reset();
+}
+
+//-----------------------------------------------------------------------------
+template <typename... Args>
+void vtkThreadedTaskQueue<void, Args...>::TaskDone()
+{
+  std::unique_lock<std::mutex> lk(this->PendingTasksMutex);
+  --this->NumberOfPendingTasks;
+  lk.unlock();
+  this->ResultsCV.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+template <typename... Args>
+void vtkThreadedTaskQueue<void, Args...>::Enqueue(int priority,
+  std::shared_ptr<vtkThreadedTaskQueueInternals::TaskControl> control,
+  std::function<void(std::uint64_t)>&& run,
+  std::shared_ptr<vtkThreadedTaskQueueInternals::TaskArguments<Args...>> arguments)
+{
+  typename vtkThreadedTaskQueueInternals::TaskQueue<Args...>::Task task;
+  task.Control = control;
+  task.Run = std::move(run);
+  task.Arguments = std::move(arguments);
+  ++this->NumberOfPendingTasks;
+  if (this->Tasks->Push(priority, std::move(task)))
   {
-    this->Threads[cc].join();
+    this->Executor->TaskPushed();
+  }
+  else
+  {
+    control->Cancel();
+    this->TaskDone();
   }
 }
 
@@ -322,14 +828,70 @@ vtkThreadedTaskQueue<void, Args...>::~vtkThreadedTaskQueue()
 template <typename... Args>
 void vtkThreadedTaskQueue<void, Args...>::Push(Args&&... args)
 {
-  this->Tasks->Push(std::bind(this->Worker, args...));
+  this->PushWithPriority(0, std::forward<Args>(args)...);
+}
+
+//-----------------------------------------------------------------------------
+template <typename... Args>
+void vtkThreadedTaskQueue<void, Args...>::PushWithPriority(int priority, Args&&... args)
+{
+  auto arguments = std::make_shared<vtkThreadedTaskQueueInternals::TaskArguments<Args...>>(
+    std::forward<Args>(args)...);
+  this->Enqueue(priority, std::make_shared<vtkThreadedTaskQueueInternals::TaskControl>(),
+    [arguments, this](std::uint64_t) {
+      arguments->Invoke(this->Worker);
+      this->TaskDone();
+    },
+    arguments);
+}
+
+//-----------------------------------------------------------------------------
+template <typename... Args>
+vtkThreadedTaskHandle<void> vtkThreadedTaskQueue<void, Args...>::Submit(
+  int priority, Args&&... args)
+{
+  auto state = std::make_shared<vtkThreadedTaskQueueInternals::TaskState<void>>();
+  auto arguments = std::make_shared<vtkThreadedTaskQueueInternals::TaskArguments<Args...>>(
+    std::forward<Args>(args)...);
+  // the queue entry owns the state till the task is run.
+  auto rawState = state.get();
+  this->Enqueue(priority, state,
+    [arguments, rawState, this](std::uint64_t) {
+      arguments->Invoke(this->Worker);
+      rawState->Finish();
+      this->TaskDone();
+    },
+    arguments);
+  return vtkThreadedTaskHandle<void>(state);
+}
+
+//-----------------------------------------------------------------------------
+template <typename... Args>
+std::size_t vtkThreadedTaskQueue<void, Args...>::Cancel(
+  std::function<bool(const Args&...)> predicate)
+{
+  return this->Tasks->Cancel(predicate);
+}
+
+//-----------------------------------------------------------------------------
+template <typename... Args>
+void vtkThreadedTaskQueue<void, Args...>::SetMaximumNumberOfQueuedTasks(int count)
+{
+  this->Tasks->SetMaximumNumberOfQueuedTasks(count);
+}
+
+//-----------------------------------------------------------------------------
+template <typename... Args>
+int vtkThreadedTaskQueue<void, Args...>::GetMaximumNumberOfQueuedTasks() const
+{
+  return this->Tasks->GetMaximumNumberOfQueuedTasks();
 }
 
 //-----------------------------------------------------------------------------
 template <typename... Args>
 bool vtkThreadedTaskQueue<void, Args...>::IsEmpty() const
 {
-  return this->NextResultId == this->Tasks->GetNextTaskId();
+  return this->NumberOfPendingTasks == 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -340,6 +902,6 @@ void vtkThreadedTaskQueue<void, Args...>::Flush()
   {
     return;
   }
-  std::unique_lock<std::mutex> lk(this->NextResultIdMutex);
+  std::unique_lock<std::mutex> lk(this->PendingTasksMutex);
   this->ResultsCV.wait(lk, [this] { return this->IsEmpty(); });
 }
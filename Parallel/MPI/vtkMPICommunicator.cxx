@@ -26,6 +26,7 @@
 #define VTK_CREATE(type, name) vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include <cassert>
+#include <memory>
 #include <vector>
 
 static inline void vtkMPICommunicatorDebugBarrier(MPI_Comm* handle)
@@ -318,6 +319,127 @@ int vtkMPICommunicatorAllReduceData(const void* sendBuffer, void* recvBuffer, vt
     const_cast<void*>(sendBuffer), recvBuffer, length, mpiType, operation, *comm);
 }
 
+#if MPI_VERSION >= 3
+//------------------------------------------------------------------------------
+// Maps a vtkCommunicator::StandardOperations value on the MPI operation.
+static bool vtkMPICommunicatorGetMPIOp(int operation, MPI_Op& mpiOp)
+{
+  switch (operation)
+  {
+    case vtkCommunicator::MAX_OP:
+      mpiOp = MPI_MAX;
+      return true;
+    case vtkCommunicator::MIN_OP:
+      mpiOp = MPI_MIN;
+      return true;
+    case vtkCommunicator::SUM_OP:
+      mpiOp = MPI_SUM;
+      return true;
+    case vtkCommunicator::PRODUCT_OP:
+      mpiOp = MPI_PROD;
+      return true;
+    case vtkCommunicator::LOGICAL_AND_OP:
+      mpiOp = MPI_LAND;
+      return true;
+    case vtkCommunicator::BITWISE_AND_OP:
+      mpiOp = MPI_BAND;
+      return true;
+    case vtkCommunicator::LOGICAL_OR_OP:
+      mpiOp = MPI_LOR;
+      return true;
+    case vtkCommunicator::BITWISE_OR_OP:
+      mpiOp = MPI_BOR;
+      return true;
+    case vtkCommunicator::LOGICAL_XOR_OP:
+      mpiOp = MPI_LXOR;
+      return true;
+    case vtkCommunicator::BITWISE_XOR_OP:
+      mpiOp = MPI_BXOR;
+      return true;
+    default:
+      return false;
+  }
+}
+
+//------------------------------------------------------------------------------
+// State of a pending MPI-3 non-blocking collective. The int counts and
+// displacements of the V variants have to stay alive until completion.
+class vtkMPICommunicatorCollectiveRequest
+  : public vtkCommunicator::CollectiveRequest::Implementation
+{
+public:
+  vtkMPICommunicatorCollectiveRequest()
+    : Handle(MPI_REQUEST_NULL)
+  {
+  }
+
+  ~vtkMPICommunicatorCollectiveRequest() override
+  {
+    // The buffers are owned by the caller; never leave MPI writing to them.
+    this->Wait();
+  }
+
+  bool Test() override
+  {
+    if (this->Handle == MPI_REQUEST_NULL)
+    {
+      return true;
+    }
+    int flag = 0;
+    int err = MPI_Test(&this->Handle, &flag, MPI_STATUS_IGNORE);
+    if (err != MPI_SUCCESS)
+    {
+      this->ReportError(err);
+      return true;
+    }
+    return flag != 0;
+  }
+
+  void Wait() override
+  {
+    if (this->Handle != MPI_REQUEST_NULL)
+    {
+      int err = MPI_Wait(&this->Handle, MPI_STATUS_IGNORE);
+      if (err != MPI_SUCCESS)
+      {
+        this->ReportError(err);
+      }
+    }
+  }
+
+  void ReportError(int err)
+  {
+    char* msg = vtkMPIController::ErrorString(err);
+    vtkGenericWarningMacro("MPI error occurred: " << msg);
+    delete[] msg;
+    this->Handle = MPI_REQUEST_NULL;
+  }
+
+  MPI_Request Handle;
+  std::vector<int> Lengths;
+  std::vector<int> Offsets;
+};
+
+//------------------------------------------------------------------------------
+// Converts vtkIdType lengths and offsets to int, returns false on overflow.
+static bool vtkMPICommunicatorConvertLengths(int numProc, const vtkIdType* lengths,
+  const vtkIdType* offsets, std::vector<int>& mpiLengths, std::vector<int>& mpiOffsets)
+{
+  mpiLengths.resize(numProc);
+  mpiOffsets.resize(numProc);
+  for (int i = 0; i < numProc; i++)
+  {
+    if (!vtkMPICommunicatorCheckSize(lengths[i] + offsets[i]))
+    {
+      return false;
+    }
+    mpiLengths[i] = static_cast<int>(lengths[i]);
+    mpiOffsets[i] = static_cast<int>(offsets[i]);
+  }
+  return true;
+}
+#endif
+
 //------------------------------------------------------------------------------
 int vtkMPICommunicatorIprobe(int source, int tag, int* flag, int* actualSource,
   MPI_Datatype datatype, int* size, MPI_Comm* handle)
@@ -1412,6 +1534,196 @@ int vtkMPICommunicator::AllReduceVoidArray(
   return res;
 }
 
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockBarrier(CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  int retVal = CheckForMPIError(MPI_Ibarrier(*this->MPIComm->Handle, &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockBarrier(req);
+#endif
+}
+
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockBroadcastVoidArray(
+  void* data, vtkIdType length, int type, int srcProcessId, CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  req.SetImplementation(nullptr);
+  if (!vtkMPICommunicatorCheckSize(length))
+    return 0;
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  int retVal = CheckForMPIError(MPI_Ibcast(data, length, vtkMPICommunicatorGetMPIType(type),
+    srcProcessId, *this->MPIComm->Handle, &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockBroadcastVoidArray(data, length, type, srcProcessId, req);
+#endif
+}
+
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockGatherVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType length, int type, int destProcessId, CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  req.SetImplementation(nullptr);
+  int numProc;
+  MPI_Comm_size(*this->MPIComm->Handle, &numProc);
+  if (!vtkMPICommunicatorCheckSize(length * numProc))
+    return 0;
+  MPI_Datatype mpiType = vtkMPICommunicatorGetMPIType(type);
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  int retVal = CheckForMPIError(MPI_Igather(const_cast<void*>(sendBuffer), length, mpiType,
+    recvBuffer, length, mpiType, destProcessId, *this->MPIComm->Handle, &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockGatherVoidArray(
+    sendBuffer, recvBuffer, length, type, destProcessId, req);
+#endif
+}
+
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockGatherVVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType sendLength, vtkIdType* recvLengths, vtkIdType* offsets, int type, int destProcessId,
+  CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  req.SetImplementation(nullptr);
+  if (!vtkMPICommunicatorCheckSize(sendLength))
+    return 0;
+  MPI_Datatype mpiType = vtkMPICommunicatorGetMPIType(type);
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  int rank;
+  MPI_Comm_rank(*this->MPIComm->Handle, &rank);
+  if (rank == destProcessId)
+  {
+    int numProc;
+    MPI_Comm_size(*this->MPIComm->Handle, &numProc);
+    if (!vtkMPICommunicatorConvertLengths(
+          numProc, recvLengths, offsets, impl->Lengths, impl->Offsets))
+    {
+      return 0;
+    }
+  }
+  int retVal = CheckForMPIError(MPI_Igatherv(const_cast<void*>(sendBuffer), sendLength, mpiType,
+    rank == destProcessId ? recvBuffer : nullptr,
+    rank == destProcessId ? impl->Lengths.data() : nullptr,
+    rank == destProcessId ? impl->Offsets.data() : nullptr, mpiType, destProcessId,
+    *this->MPIComm->Handle, &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockGatherVVoidArray(
+    sendBuffer, recvBuffer, sendLength, recvLengths, offsets, type, destProcessId, req);
+#endif
+}
+
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockAllGatherVoidArray(
+  const void* sendBuffer, void* recvBuffer, vtkIdType length, int type, CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  req.SetImplementation(nullptr);
+  int numProc;
+  MPI_Comm_size(*this->MPIComm->Handle, &numProc);
+  if (!vtkMPICommunicatorCheckSize(length * numProc))
+    return 0;
+  MPI_Datatype mpiType = vtkMPICommunicatorGetMPIType(type);
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  int retVal = CheckForMPIError(MPI_Iallgather(const_cast<void*>(sendBuffer), length, mpiType,
+    recvBuffer, length, mpiType, *this->MPIComm->Handle, &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockAllGatherVoidArray(sendBuffer, recvBuffer, length, type, req);
+#endif
+}
+
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockAllGatherVVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType sendLength, vtkIdType* recvLengths, vtkIdType* offsets, int type,
+  CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  req.SetImplementation(nullptr);
+  if (!vtkMPICommunicatorCheckSize(sendLength))
+    return 0;
+  MPI_Datatype mpiType = vtkMPICommunicatorGetMPIType(type);
+  int numProc;
+  MPI_Comm_size(*this->MPIComm->Handle, &numProc);
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  if (!vtkMPICommunicatorConvertLengths(
+        numProc, recvLengths, offsets, impl->Lengths, impl->Offsets))
+  {
+    return 0;
+  }
+  int retVal = CheckForMPIError(MPI_Iallgatherv(const_cast<void*>(sendBuffer), sendLength, mpiType,
+    recvBuffer, impl->Lengths.data(), impl->Offsets.data(), mpiType, *this->MPIComm->Handle,
+    &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockAllGatherVVoidArray(
+    sendBuffer, recvBuffer, sendLength, recvLengths, offsets, type, req);
+#endif
+}
+
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockReduceVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType length, int type, int operation, int destProcessId, CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  req.SetImplementation(nullptr);
+  MPI_Op mpiOp;
+  if (!vtkMPICommunicatorGetMPIOp(operation, mpiOp))
+  {
+    vtkWarningMacro(<< "Operation number " << operation << " not supported.");
+    return 0;
+  }
+  if (!vtkMPICommunicatorCheckSize(length))
+    return 0;
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  int retVal = CheckForMPIError(MPI_Ireduce(const_cast<void*>(sendBuffer), recvBuffer, length,
+    vtkMPICommunicatorGetMPIType(type), mpiOp, destProcessId, *this->MPIComm->Handle,
+    &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockReduceVoidArray(
+    sendBuffer, recvBuffer, length, type, operation, destProcessId, req);
+#endif
+}
+
+//------------------------------------------------------------------------------
+int vtkMPICommunicator::NoBlockAllReduceVoidArray(const void* sendBuffer, void* recvBuffer,
+  vtkIdType length, int type, int operation, CollectiveRequest& req)
+{
+#if MPI_VERSION >= 3
+  req.SetImplementation(nullptr);
+  MPI_Op mpiOp;
+  if (!vtkMPICommunicatorGetMPIOp(operation, mpiOp))
+  {
+    vtkWarningMacro(<< "Operation number " << operation << " not supported.");
+    return 0;
+  }
+  if (!vtkMPICommunicatorCheckSize(length))
+    return 0;
+  auto impl = std::make_shared<vtkMPICommunicatorCollectiveRequest>();
+  int retVal = CheckForMPIError(MPI_Iallreduce(const_cast<void*>(sendBuffer), recvBuffer, length,
+    vtkMPICommunicatorGetMPIType(type), mpiOp, *this->MPIComm->Handle, &impl->Handle));
+  req.SetImplementation(retVal ? impl : nullptr);
+  return retVal;
+#else
+  return this->Superclass::NoBlockAllReduceVoidArray(
+    sendBuffer, recvBuffer, length, type, operation, req);
+#endif
+}
+
 //------------------------------------------------------------------------------
 int vtkMPICommunicator::WaitAll(const int count, Request requests[])
 {
@@ -172,6 +172,31 @@ public:
     Operation* operation) override;
   ///@}
 
+  ///@{
+  /**
+   * Non-blocking collective operations implemented with the MPI-3
+   * non-blocking collectives (MPI_Ibcast, MPI_Iallreduce, ...). With an
+   * older MPI they complete before returning. Return values are 1 for
+   * success and 0 otherwise.
+   */
+  int NoBlockBarrier(CollectiveRequest& req) override;
+  int NoBlockBroadcastVoidArray(
+    void* data, vtkIdType length, int type, int srcProcessId, CollectiveRequest& req) override;
+  int NoBlockGatherVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType length, int type,
+    int destProcessId, CollectiveRequest& req) override;
+  int NoBlockGatherVVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType sendLength,
+    vtkIdType* recvLengths, vtkIdType* offsets, int type, int destProcessId,
+    CollectiveRequest& req) override;
+  int NoBlockAllGatherVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType length,
+    int type, CollectiveRequest& req) override;
+  int NoBlockAllGatherVVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType sendLength,
+    vtkIdType* recvLengths, vtkIdType* offsets, int type, CollectiveRequest& req) override;
+  int NoBlockReduceVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType length, int type,
+    int operation, int destProcessId, CollectiveRequest& req) override;
+  int NoBlockAllReduceVoidArray(const void* sendBuffer, void* recvBuffer, vtkIdType length,
+    int type, int operation, CollectiveRequest& req) override;
+  ///@}
+
   ///@{
   /**
    * Nonblocking test for a message.  Inputs are: source -- the source rank